@@ -35,6 +35,7 @@
 #include "function/old_engine_string_functions.h"
 #include "function/timestamp_functions.h"
 #include "index/index_factory.h"
+#include "optimizer/stats/stats_storage.h"
 #include "settings/settings_manager.h"
 #include "storage/storage_manager.h"
 #include "storage/table_factory.h"
@@ -1330,6 +1331,7 @@ ResultType Catalog::DropTable(concurrency::TransactionContext *txn,
       catalog_map_[database_object->GetDatabaseOid()]->GetTableCatalog();
   pg_table->DeleteTable(txn, table_oid);
   database->GetTableWithOid(table_oid);
+  optimizer::StatsStorage::GetInstance()->DropTableStatsCollector(table_oid);
   txn->RecordDrop(database_oid, table_oid, INVALID_OID);
 
   return ResultType::SUCCESS;
@@ -37,7 +37,8 @@ QueryMetricsCatalog::QueryMetricsCatalog(concurrency::TransactionContext *txn,
     "inserts  INT NOT NULL, "
     "latency  INT NOT NULL, "
     "cpu_time INT NOT NULL, "
-    "time_stamp INT NOT NULL);") {
+    "time_stamp INT NOT NULL, "
+    "peak_memory_kb INT NOT NULL);") {
   // Add secondary index here if necessary
 }
 
@@ -57,6 +58,7 @@ bool QueryMetricsCatalog::InsertQueryMetrics(concurrency::TransactionContext *tx
                                              int64_t latency,
                                              int64_t cpu_time,
                                              int64_t time_stamp,
+                                             int64_t peak_memory_kb,
                                              type::AbstractPool *pool) {
   std::unique_ptr<storage::Tuple> tuple(
       new storage::Tuple(catalog_table_->GetSchema(), true));
@@ -85,6 +87,7 @@ bool QueryMetricsCatalog::InsertQueryMetrics(concurrency::TransactionContext *tx
   auto val10 = type::ValueFactory::GetIntegerValue(latency);
   auto val11 = type::ValueFactory::GetIntegerValue(cpu_time);
   auto val12 = type::ValueFactory::GetIntegerValue(time_stamp);
+  auto val13 = type::ValueFactory::GetIntegerValue(peak_memory_kb);
 
   tuple->SetValue(ColumnId::NAME, val0, pool);
   tuple->SetValue(ColumnId::DATABASE_OID, val1, pool);
@@ -99,6 +102,7 @@ bool QueryMetricsCatalog::InsertQueryMetrics(concurrency::TransactionContext *tx
   tuple->SetValue(ColumnId::LATENCY, val10, pool);
   tuple->SetValue(ColumnId::CPU_TIME, val11, pool);
   tuple->SetValue(ColumnId::TIME_STAMP, val12, pool);
+  tuple->SetValue(ColumnId::PEAK_MEMORY_KB, val13, pool);
 
   // Insert the tuple
   return InsertTuple(txn, std::move(tuple));
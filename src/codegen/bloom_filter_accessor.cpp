@@ -11,8 +11,6 @@
 //===----------------------------------------------------------------------===//
 
 #include "codegen/bloom_filter_accessor.h"
-#include "codegen/lang/if.h"
-#include "codegen/lang/loop.h"
 #include "codegen/proxy/bloom_filter_proxy.h"
 #include "codegen/util/bloom_filter.h"
 
@@ -22,6 +20,9 @@
 namespace peloton {
 namespace codegen {
 
+// The 64-bit golden ratio, as used in Fibonacci hashing
+static constexpr uint64_t kHashSpreadConst = 0x9E3779B97F4A7C15ull;
+
 void BloomFilterAccessor::Init(CodeGen &codegen, llvm::Value *bloom_filter,
                                uint64_t estimated_num_tuples) const {
   codegen.Call(BloomFilterProxy::Init,
@@ -32,131 +33,96 @@ void BloomFilterAccessor::Destroy(CodeGen &codegen,
                                   llvm::Value *bloom_filter) const {
   codegen.Call(BloomFilterProxy::Destroy, {bloom_filter});
 }
+
 void BloomFilterAccessor::Add(CodeGen &codegen, llvm::Value *bloom_filter,
-                              const std::vector<codegen::Value> &key) const {
-  // Index of current hash being calculated
-  llvm::Value *index = codegen.Const64(0);
-  llvm::Value *num_hashes = LoadBloomFilterField(codegen, bloom_filter, 0);
-  llvm::Value *seed_hash1 =
-      Hash::HashValues(codegen, key, util::BloomFilter::kSeedHashFuncs[0]);
-  llvm::Value *seed_hash2 =
-      Hash::HashValues(codegen, key, util::BloomFilter::kSeedHashFuncs[1]);
-
-  llvm::Value *end_cond = codegen->CreateICmpULT(index, num_hashes);
-  lang::Loop add_loop{codegen, end_cond, {{"i", index}}};
-  {
-    index = add_loop.GetLoopVar(0);
-
-    // Calculate the ith hash
-    llvm::Value *hash = CalculateHash(codegen, index, seed_hash1, seed_hash2);
-
-    // Locate the byte that contains the corresponding bit.
-    llvm::Value *bit_offset_in_byte;
-    llvm::Value *byte_ptr;
-    LocateBit(codegen, bloom_filter, hash, bit_offset_in_byte, byte_ptr);
-
-    // Mark the corresponding bit
-    llvm::Value *existing_byte = codegen->CreateLoad(byte_ptr);
-    llvm::Value *new_byte = codegen->CreateOr(
-        existing_byte,
-        codegen->CreateShl(codegen.Const8(1), bit_offset_in_byte));
-    codegen->CreateStore(new_byte, byte_ptr);
-
-    index = codegen->CreateAdd(index, codegen.Const64(1));
-    add_loop.LoopEnd(codegen->CreateICmpULT(index, num_hashes), {index});
+                              const std::vector<codegen::Value> &key,
+                              bool atomic) const {
+  // Locate the block of the key and the bits to set in it
+  llvm::Value *block_ptr, *mask;
+  LocateBlock(codegen, bloom_filter, HashKey(codegen, key), block_ptr, mask);
+
+  // Mark the bits
+  if (atomic) {
+    codegen->CreateAtomicRMW(llvm::AtomicRMWInst::BinOp::Or, block_ptr, mask,
+                             llvm::AtomicOrdering::Monotonic);
+  } else {
+    llvm::Value *block = codegen->CreateLoad(block_ptr);
+    codegen->CreateStore(codegen->CreateOr(block, mask), block_ptr);
   }
 }
 
 llvm::Value *BloomFilterAccessor::Contains(
     CodeGen &codegen, llvm::Value *bloom_filter,
     const std::vector<codegen::Value> &key) const {
-  // Index of current hash being calculated
-  llvm::Value *index = codegen.Const64(0);
-  llvm::Value *num_hashes = LoadBloomFilterField(codegen, bloom_filter, 0);
-  llvm::Value *end_cond = codegen->CreateICmpULT(index, num_hashes);
-  llvm::Value *seed_hash1 =
-      Hash::HashValues(codegen, key, util::BloomFilter::kSeedHashFuncs[0]);
-  llvm::Value *seed_hash2 =
-      Hash::HashValues(codegen, key, util::BloomFilter::kSeedHashFuncs[1]);
-  // Update statistic. Increase number of probing
-  llvm::Value *num_probe = LoadBloomFilterField(codegen, bloom_filter, 4);
-  StoreBloomFilterField(codegen, bloom_filter, 4,
-                        codegen->CreateAdd(num_probe, codegen.Const64(1)));
-
-  lang::Loop add_loop{codegen, end_cond, {{"i", index}}};
-  {
-    index = add_loop.GetLoopVar(0);
-
-    // Calculate the ith hash
-    llvm::Value *hash = CalculateHash(codegen, index, seed_hash1, seed_hash2);
-
-    // Locate the byte that contains the corresponding bit.
-    llvm::Value *bit_offset_in_byte;
-    llvm::Value *byte_ptr;
-    LocateBit(codegen, bloom_filter, hash, bit_offset_in_byte, byte_ptr);
-
-    // Check if the corresopnding bit is set
-    llvm::Value *existing_byte = codegen->CreateLoad(byte_ptr);
-    llvm::Value *and_val = codegen->CreateAnd(
-        existing_byte,
-        codegen->CreateShl(codegen.Const8(1), bit_offset_in_byte));
-    llvm::Value *equal_zero = codegen->CreateICmpEQ(and_val, codegen.Const8(0));
-    lang::If bit_not_set{codegen, equal_zero, "BitNotSet"};
-    {
-      // Bit is not set. It means object not in bloom filter. break
-      llvm::Value *num_misses = LoadBloomFilterField(codegen, bloom_filter, 3);
-      StoreBloomFilterField(codegen, bloom_filter, 3,
-                            codegen->CreateAdd(num_misses, codegen.Const64(1)));
-      add_loop.Break();
-    }
-    bit_not_set.EndIf();
-
-    index = codegen->CreateAdd(index, codegen.Const64(1));
-    add_loop.LoopEnd(codegen->CreateICmpULT(index, num_hashes), {index});
-  }
-  std::vector<llvm::Value *> vals;
-  add_loop.CollectFinalLoopVariables(vals);
-
-  // contains = (i == num_hashes ? true : false);
-  llvm::Value *loop_to_end = codegen->CreateICmpEQ(vals[0], num_hashes);
-  llvm::Value *contains = codegen->CreateSelect(
-      loop_to_end, codegen.ConstBool(true), codegen.ConstBool(false));
+  // Locate the block of the key and the bits that must be set in it
+  llvm::Value *block_ptr, *mask;
+  LocateBlock(codegen, bloom_filter, HashKey(codegen, key), block_ptr, mask);
+
+  // contains = (block & mask) == mask
+  llvm::Value *block = codegen->CreateLoad(block_ptr);
+  llvm::Value *contains =
+      codegen->CreateICmpEQ(codegen->CreateAnd(block, mask), mask);
+
+  // Update statistic. Increase number of probing, and of misses if the key
+  // is not in the filter
+  llvm::Value *num_probes = LoadBloomFilterField(codegen, bloom_filter, 3);
+  StoreBloomFilterField(codegen, bloom_filter, 3,
+                        codegen->CreateAdd(num_probes, codegen.Const64(1)));
+  llvm::Value *num_misses = LoadBloomFilterField(codegen, bloom_filter, 2);
+  llvm::Value *miss = codegen->CreateZExt(codegen->CreateNot(contains),
+                                          codegen.Int64Type());
+  StoreBloomFilterField(codegen, bloom_filter, 2,
+                        codegen->CreateAdd(num_misses, miss));
 
   return contains;
 }
 
-llvm::Value *BloomFilterAccessor::CalculateHash(CodeGen &codegen,
-                                                llvm::Value *index,
-                                                llvm::Value *seed_hash1,
-                                                llvm::Value *seed_hash2) const {
-  // Calculate hashes[index]
-  llvm::Value *combined_hash =
-      codegen->CreateAdd(seed_hash1, codegen->CreateMul(index, seed_hash2));
-
-  // return i == 0 ? seed_hash1 : (i == 1 ? seed_hash2 : combined_hash);
-  llvm::Value *is_first = codegen->CreateICmpEQ(index, codegen.Const64(0));
-  llvm::Value *is_second = codegen->CreateICmpEQ(index, codegen.Const64(1));
-  llvm::Value *hash = codegen->CreateSelect(
-      is_first, seed_hash1,
-      codegen->CreateSelect(is_second, seed_hash2, combined_hash));
-  return hash;
+llvm::Value *BloomFilterAccessor::HashKey(
+    CodeGen &codegen, const std::vector<codegen::Value> &key) const {
+  // The hash of strings only has 32 bits, so multiply it by a large odd
+  // constant to spread it over the high half that selects the bits
+  llvm::Value *hash =
+      Hash::HashValues(codegen, key, util::BloomFilter::kHashFunc);
+  return codegen->CreateMul(hash, codegen.Const64(kHashSpreadConst));
 }
 
-// Given the hash, find the corresponding byte that contains the bit
-void BloomFilterAccessor::LocateBit(CodeGen &codegen, llvm::Value *bloom_filter,
-                                    llvm::Value *hash,
-                                    llvm::Value *&bit_offset_in_byte,
-                                    llvm::Value *&byte_ptr) const {
-  llvm::Value *byte_array = LoadBloomFilterField(codegen, bloom_filter, 1);
-  llvm::Value *num_bits = LoadBloomFilterField(codegen, bloom_filter, 2);
-
-  llvm::Value *bits_per_byte = codegen.Const64(8);
-  llvm::Value *bit_offset = codegen->CreateURem(hash, num_bits);
-  llvm::Value *byte_offset = codegen->CreateUDiv(bit_offset, bits_per_byte);
-  bit_offset_in_byte = codegen->CreateTrunc(
-      codegen->CreateURem(bit_offset, bits_per_byte), codegen.Int8Type());
-  byte_ptr =
-      codegen->CreateInBoundsGEP(codegen.ByteType(), byte_array, byte_offset);
+llvm::Value *BloomFilterAccessor::Filter(CodeGen &codegen,
+                                         llvm::Value *bloom_filter,
+                                         llvm::Value *hashes,
+                                         llvm::Value *selection_vector,
+                                         llvm::Value *num_elems) const {
+  return codegen.Call(BloomFilterProxy::Filter,
+                      {bloom_filter, hashes, selection_vector, num_elems});
+}
+
+// Given the hash, find the block of the key and the bits it sets there. This
+// mirrors util::BloomFilter::BlockIndex() and util::BloomFilter::BlockMask().
+void BloomFilterAccessor::LocateBlock(CodeGen &codegen,
+                                      llvm::Value *bloom_filter,
+                                      llvm::Value *hash,
+                                      llvm::Value *&block_ptr,
+                                      llvm::Value *&mask) const {
+  llvm::Value *blocks = LoadBloomFilterField(codegen, bloom_filter, 0);
+  llvm::Value *num_blocks = LoadBloomFilterField(codegen, bloom_filter, 1);
+
+  // block_idx = ((hash & 0xFFFFFFFF) * num_blocks) >> 32
+  llvm::Value *block_idx = codegen->CreateLShr(
+      codegen->CreateMul(
+          codegen->CreateAnd(hash, codegen.Const64(0xFFFFFFFFull)),
+          num_blocks),
+      32);
+  block_ptr =
+      codegen->CreateInBoundsGEP(codegen.Int64Type(), blocks, block_idx);
+
+  // Set one bit per 6-bit field of the high half of the hash
+  mask = codegen.Const64(0);
+  for (uint32_t i = 0; i < util::BloomFilter::kNumHashFuncs; i++) {
+    llvm::Value *bit_idx = codegen->CreateAnd(
+        codegen->CreateLShr(hash, 32 + 6 * i),
+        codegen.Const64(util::BloomFilter::kBitsPerBlock - 1));
+    mask = codegen->CreateOr(mask,
+                             codegen->CreateShl(codegen.Const64(1), bit_idx));
+  }
 }
 
 void BloomFilterAccessor::StoreBloomFilterField(
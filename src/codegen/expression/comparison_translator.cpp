@@ -11,8 +11,12 @@
 //===----------------------------------------------------------------------===//
 
 #include "codegen/expression/comparison_translator.h"
-#include "codegen/type/type_system.h"
 
+#include "codegen/execution_consumer.h"
+#include "codegen/lang/if.h"
+#include "codegen/proxy/like_matcher_proxy.h"
+#include "codegen/type/boolean_type.h"
+#include "codegen/type/type_system.h"
 #include "expression/comparison_expression.h"
 
 namespace peloton {
@@ -22,8 +26,87 @@ namespace codegen {
 ComparisonTranslator::ComparisonTranslator(
     const expression::ComparisonExpression &comparison,
     CompilationContext &context)
-    : ExpressionTranslator(comparison, context) {
+    : ExpressionTranslator(comparison, context), has_like_matcher_(false) {
   PELOTON_ASSERT(comparison.GetChildrenSize() == 2);
+
+  // The values of constants and parameters are known before the query runs,
+  // so a LIKE pattern that is one doesn't need to be interpreted per row
+  const auto *pattern = comparison.GetChild(1);
+  auto pattern_type = pattern->GetExpressionType();
+  if (comparison.GetExpressionType() == ExpressionType::COMPARE_LIKE &&
+      (pattern_type == ExpressionType::VALUE_CONSTANT ||
+       pattern_type == ExpressionType::VALUE_PARAMETER) &&
+      pattern->GetValueType() == peloton::type::TypeId::VARCHAR &&
+      comparison.GetChild(0)->GetValueType() ==
+          peloton::type::TypeId::VARCHAR) {
+    has_like_matcher_ = true;
+    like_matcher_id_ = context.GetQueryState().RegisterState(
+        "likeMatcher", LikeMatcherProxy::GetType(context.GetCodeGen()));
+  }
+}
+
+void ComparisonTranslator::InitializeQueryState() {
+  if (!has_like_matcher_) {
+    return;
+  }
+  CodeGen &codegen = context_.GetCodeGen();
+  const auto &comparison = GetExpressionAs<expression::ComparisonExpression>();
+
+  // Load the pattern, which is NULL if the parameter is
+  auto *query_parameters_ptr =
+      context_.GetExecutionConsumer().GetQueryParametersPtr(context_);
+  codegen::Value pattern = context_.GetParameterCache().DeriveValue(
+      codegen, query_parameters_ptr, comparison.GetChild(1));
+  llvm::Value *pattern_ptr = pattern.GetValue();
+  if (pattern.IsNullable()) {
+    pattern_ptr =
+        codegen->CreateSelect(pattern.IsNull(codegen),
+                              codegen.NullPtr(codegen.CharPtrType()),
+                              pattern_ptr);
+  }
+
+  auto *matcher_ptr =
+      context_.GetQueryState().LoadStatePtr(codegen, like_matcher_id_);
+  codegen.Call(LikeMatcherProxy::Init,
+               {matcher_ptr, pattern_ptr, pattern.GetLength()});
+}
+
+void ComparisonTranslator::TearDownQueryState() {
+  if (!has_like_matcher_) {
+    return;
+  }
+  CodeGen &codegen = context_.GetCodeGen();
+  auto *matcher_ptr =
+      context_.GetQueryState().LoadStatePtr(codegen, like_matcher_id_);
+  codegen.Call(LikeMatcherProxy::Destroy, {matcher_ptr});
+}
+
+codegen::Value ComparisonTranslator::MatchLike(
+    CodeGen &codegen, const codegen::Value &str) const {
+  auto *matcher_ptr =
+      context_.GetQueryState().LoadStatePtr(codegen, like_matcher_id_);
+  auto match = [&]() -> codegen::Value {
+    llvm::Value *matches =
+        codegen.Call(LikeMatcherProxy::Matches,
+                     {matcher_ptr, GetExecutorContextPtr(), str.GetValue(),
+                      str.GetLength()});
+    return codegen::Value{type::Boolean::Instance(), matches};
+  };
+
+  if (!str.IsNullable()) {
+    return match();
+  }
+
+  // A NULL string matches nothing
+  codegen::Value null_ret, not_null_ret;
+  lang::If input_null{codegen, str.IsNull(codegen)};
+  {
+    null_ret =
+        codegen::Value{type::Boolean::Instance(), codegen.ConstBool(false)};
+  }
+  input_null.ElseBlock();
+  { not_null_ret = match(); }
+  return input_null.BuildPHI(null_ret, not_null_ret);
 }
 
 // Produce the result of performing the comparison of left and right values
@@ -32,6 +115,9 @@ codegen::Value ComparisonTranslator::DeriveValue(CodeGen &codegen,
   const auto &comparison = GetExpressionAs<expression::ComparisonExpression>();
 
   codegen::Value left = row.DeriveValue(codegen, *comparison.GetChild(0));
+  if (has_like_matcher_) {
+    return MatchLike(codegen, left);
+  }
   codegen::Value right = row.DeriveValue(codegen, *comparison.GetChild(1));
 
   switch (comparison.GetExpressionType()) {
@@ -178,6 +178,67 @@ void HashTable::MergeLazyUnfinished(CodeGen &codegen, llvm::Value *global_ht,
   codegen.Call(HashTableProxy::MergeLazyUnfinished, {global_ht, local_ht});
 }
 
+void HashTable::EnableSpilling(CodeGen &codegen, llvm::Value *ht_ptr,
+                               llvm::Value *exec_ctx) const {
+  codegen.Call(HashTableProxy::EnableSpilling, {ht_ptr, exec_ctx});
+}
+
+void HashTable::PartitionLazy(CodeGen &codegen, llvm::Value *ht_ptr,
+                              llvm::Value *num_partition_bits) const {
+  codegen.Call(HashTableProxy::PartitionLazy, {ht_ptr, num_partition_bits});
+}
+
+void HashTable::PartitionLazyParallel(CodeGen &codegen, llvm::Value *ht_ptr,
+                                      llvm::Value *thread_states,
+                                      uint32_t ht_state_offset,
+                                      llvm::Value *num_partition_bits) const {
+  codegen.Call(HashTableProxy::PartitionLazyParallel,
+               {ht_ptr, thread_states, codegen.Const32(ht_state_offset),
+                num_partition_bits});
+}
+
+llvm::Value *HashTable::NumPartitionBits(CodeGen &codegen,
+                                         llvm::Value *ht_ptr) const {
+  return codegen.Load(HashTableProxy::num_partition_bits, ht_ptr);
+}
+
+void HashTable::BuildPartition(CodeGen &codegen, llvm::Value *ht_ptr,
+                               llvm::Value *partition) const {
+  codegen.Call(HashTableProxy::BuildPartition, {ht_ptr, partition});
+}
+
+void HashTable::IteratePartition(CodeGen &codegen, llvm::Value *ht_ptr,
+                                 llvm::Value *partition,
+                                 IterateCallback &callback) const {
+  codegen.Call(HashTableProxy::LoadPartition, {ht_ptr, partition});
+
+  // The entries of the partition are contiguous, so we walk them with a
+  // pointer instead of following the bucket chains
+  llvm::Value *pos =
+      codegen.Call(HashTableProxy::PartitionBegin, {ht_ptr, partition});
+  llvm::Value *end =
+      codegen.Call(HashTableProxy::PartitionEnd, {ht_ptr, partition});
+  const uint32_t entry_size = util::HashTable::Entry::Size(
+      key_storage_.MaxStorageSize(), value_size_);
+
+  lang::Loop entry_loop(codegen, codegen->CreateICmpNE(pos, end),
+                        {{"pos", pos}});
+  {
+    pos = entry_loop.GetLoopVar(0);
+    llvm::Value *entry_data = codegen->CreateConstInBoundsGEP1_32(
+        codegen.ByteType(), pos, sizeof(util::HashTable::Entry));
+
+    // Pull out keys and invoke callback
+    std::vector<codegen::Value> keys;
+    auto *data_area_ptr = key_storage_.LoadValues(codegen, entry_data, keys);
+    callback.ProcessEntry(codegen, keys, data_area_ptr);
+
+    pos = codegen->CreateConstInBoundsGEP1_32(codegen.ByteType(), pos,
+                                              entry_size);
+    entry_loop.LoopEnd(codegen->CreateICmpNE(pos, end), {pos});
+  }
+}
+
 void HashTable::Iterate(CodeGen &codegen, llvm::Value *ht_ptr,
                         IterateCallback &callback) const {
   llvm::Value *buckets_ptr = codegen.Load(HashTableProxy::directory, ht_ptr);
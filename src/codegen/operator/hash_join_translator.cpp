@@ -15,6 +15,7 @@
 #include "codegen/expression/tuple_value_translator.h"
 #include "codegen/lang/if.h"
 #include "codegen/lang/vectorized_loop.h"
+#include "codegen/operator/table_scan_translator.h"
 #include "codegen/proxy/bloom_filter_proxy.h"
 #include "codegen/proxy/hash_table_proxy.h"
 #include "expression/tuple_value_expression.h"
@@ -111,6 +112,47 @@ class HashJoinTranslator::InsertLeft : public HashTable::InsertCallback {
   const std::vector<codegen::Value> &values_;
 };
 
+/**
+ * The callback used when both sides of the join are partitioned. It is invoked
+ * for every probe-side entry of a partition, once the build side of the same
+ * partition has been built, and probes the build side with the entry.
+ */
+class HashJoinTranslator::ProbePartition : public HashTable::IterateCallback {
+ public:
+  /**
+   * Constructor.
+   *
+   * @param join_translator The translator reference
+   * @param context The context of the pipeline the join produces rows into
+   * @param selection_vector A one-element vector for the batch of each row
+   */
+  ProbePartition(const HashJoinTranslator &join_translator,
+                 ConsumerContext &context, Vector &selection_vector)
+      : join_translator_(join_translator),
+        context_(context),
+        selection_vector_(selection_vector) {}
+
+  /**
+   * Rebuild the probe-side row from the entry, and probe the build side.
+   *
+   * @param codegen The codegen instance
+   * @param key The probe-side key
+   * @param data_area Memory space where the probe-side attributes are stored
+   */
+  void ProcessEntry(CodeGen &codegen, const std::vector<codegen::Value> &key,
+                    llvm::Value *data_area) const override;
+
+ private:
+  // The translator (we need lots of its state)
+  const HashJoinTranslator &join_translator_;
+
+  // The context we produce rows into
+  ConsumerContext &context_;
+
+  // The selection vector of the single-row batch
+  Vector &selection_vector_;
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// Hash Join Translator
@@ -121,7 +163,8 @@ HashJoinTranslator::HashJoinTranslator(const planner::HashJoinPlan &join,
                                        CompilationContext &context,
                                        Pipeline &pipeline)
     : OperatorTranslator(join, context, pipeline),
-      left_pipeline_(this, Pipeline::Parallelism::Flexible) {
+      left_pipeline_(this, Pipeline::Parallelism::Flexible),
+      right_pipeline_(this, Pipeline::Parallelism::Flexible) {
   CodeGen &codegen = GetCodeGen();
   QueryState &query_state = context.GetQueryState();
 
@@ -130,7 +173,11 @@ HashJoinTranslator::HashJoinTranslator(const planner::HashJoinPlan &join,
   // ensure it receives a vector of input tuples
   if (UsePrefetching()) {
     left_pipeline_.InstallStageBoundary(this);
-    pipeline.InstallStageBoundary(this);
+    if (join.IsRadixPartitioned()) {
+      right_pipeline_.InstallStageBoundary(this);
+    } else {
+      pipeline.InstallStageBoundary(this);
+    }
   }
 
   // Allocate state for our hash table and bloom filter
@@ -142,9 +189,19 @@ HashJoinTranslator::HashJoinTranslator(const planner::HashJoinPlan &join,
         "bloomfilter", BloomFilterProxy::GetType(codegen));
   }
 
-  // Prepare translators for the left and right input operators
+  // Prepare translators for the left and right input operators. When both
+  // sides are partitioned, the probe side is materialized in its own pipeline,
+  // and the join is the source of its pipeline.
   context.Prepare(*join.GetChild(0), left_pipeline_);
-  context.Prepare(*join.GetChild(1)->GetChild(0), pipeline);
+  if (join.IsRadixPartitioned()) {
+    LOG_DEBUG("Building HashJoin over radix partitions ...");
+    pipeline.MarkSource(this, Pipeline::Parallelism::Serial);
+    probe_table_id_ =
+        query_state.RegisterState("probe", HashTableProxy::GetType(codegen));
+    context.Prepare(*join.GetChild(1)->GetChild(0), right_pipeline_);
+  } else {
+    context.Prepare(*join.GetChild(1)->GetChild(0), pipeline);
+  }
 
   // Prepare the expressions that produce the build-size keys
   join.GetLeftHashKeys(left_key_exprs_);
@@ -170,6 +227,23 @@ HashJoinTranslator::HashJoinTranslator(const planner::HashJoinPlan &join,
     right_key_type.push_back(right_key->ResultType());
   }
 
+  // Push the bloom filter down into a scan on the probe side, so that it
+  // filters its rows before evaluating its predicate. Only inner joins can
+  // drop the probe rows that have no join partner.
+  bloom_filter_pushed_down_ = false;
+  const auto &probe_plan = *join.GetChild(1)->GetChild(0);
+  if (GetJoinPlan().IsBloomFilterEnabled() &&
+      join.GetJoinType() == JoinType::INNER &&
+      probe_plan.GetPlanNodeType() == PlanNodeType::SEQSCAN) {
+    auto *scan_translator =
+        static_cast<TableScanTranslator *>(context.GetTranslator(probe_plan));
+    if (scan_translator->CanPushDownBloomFilter(right_key_exprs_)) {
+      scan_translator->PushDownBloomFilter(bloom_filter_, bloom_filter_id_,
+                                           right_key_exprs_);
+      bloom_filter_pushed_down_ = true;
+    }
+  }
+
   // Prepare the predicate
   auto *predicate = join.GetPredicate();
   if (predicate != nullptr) {
@@ -203,6 +277,39 @@ HashJoinTranslator::HashJoinTranslator(const planner::HashJoinPlan &join,
   }
   left_value_storage_.Setup(codegen, left_value_types);
 
+  if (join.IsRadixPartitioned()) {
+    // The probe side has to carry the attributes the parents use, and those
+    // the predicate uses from the probe side. The keys are stored separately.
+    std::unordered_set<const planner::AttributeInfo *> skip_ais{
+        left_key_ais.begin(), left_key_ais.end()};
+    skip_ais.insert(left_val_ais_.begin(), left_val_ais_.end());
+    for (auto *right_key_exp : right_key_exprs_) {
+      if (right_key_exp->GetExpressionType() == ExpressionType::VALUE_TUPLE) {
+        auto *tve = static_cast<const expression::TupleValueExpression *>(
+            right_key_exp);
+        skip_ais.insert(tve->GetAttributeRef());
+      }
+    }
+    std::vector<const planner::AttributeInfo *> right_ais{
+        join.GetRightAttributes()};
+    std::unordered_set<const planner::AttributeInfo *> predicate_ais;
+    if (predicate != nullptr) {
+      predicate->GetUsedAttributes(predicate_ais);
+      right_ais.insert(right_ais.end(), predicate_ais.begin(),
+                       predicate_ais.end());
+    }
+    std::vector<type::Type> right_value_types;
+    for (const auto *right_ai : right_ais) {
+      if (skip_ais.insert(right_ai).second) {
+        right_val_ais_.push_back(right_ai);
+        right_value_types.push_back(right_ai->type);
+      }
+    }
+    right_value_storage_.Setup(codegen, right_value_types);
+    probe_table_ = HashTable{codegen, right_key_type,
+                             right_value_storage_.MaxStorageSize()};
+  }
+
   // Check if the join needs an output vector to store saved probes
   if (pipeline.GetTranslatorStage(this) != 0) {
     // The join isn't the last operator in the pipeline, let's use a vector
@@ -221,6 +328,15 @@ HashJoinTranslator::HashJoinTranslator(const planner::HashJoinPlan &join,
 void HashJoinTranslator::InitializeQueryState() {
   hash_table_.Init(GetCodeGen(), GetExecutorContextPtr(),
                    LoadStatePtr(hash_table_id_));
+  if (GetJoinPlan().IsRadixPartitioned()) {
+    // Partitioned tables spill to disk once they exceed the memory budget
+    hash_table_.EnableSpilling(GetCodeGen(), LoadStatePtr(hash_table_id_),
+                               GetExecutorContextPtr());
+    probe_table_.Init(GetCodeGen(), GetExecutorContextPtr(),
+                      LoadStatePtr(probe_table_id_));
+    probe_table_.EnableSpilling(GetCodeGen(), LoadStatePtr(probe_table_id_),
+                                GetExecutorContextPtr());
+  }
   if (GetJoinPlan().IsBloomFilterEnabled()) {
     bloom_filter_.Init(GetCodeGen(), LoadStatePtr(bloom_filter_id_),
                        EstimateCardinalityLeft());
@@ -235,7 +351,46 @@ void HashJoinTranslator::Produce() const {
   // Let the right child produce tuples, which we use to probe the hash table
   GetCompilationContext().Produce(*GetJoinPlan().GetChild(1)->GetChild(0));
 
-  // That's it, we've produced all the tuples
+  if (!GetJoinPlan().IsRadixPartitioned()) {
+    // That's it, we've produced all the tuples
+    return;
+  }
+
+  // Both sides are partitioned. Join them partition by partition, so that the
+  // part of the build side we probe stays in the cache.
+  auto producer = [this](ConsumerContext &ctx) {
+    CodeGen &codegen = GetCodeGen();
+    llvm::Value *build_ptr = LoadStatePtr(hash_table_id_);
+    llvm::Value *probe_ptr = LoadStatePtr(probe_table_id_);
+
+    auto *i32_type = codegen.Int32Type();
+    auto *raw_vec = codegen.AllocateBuffer(i32_type, 1, "hjProbeRow");
+    Vector selection_vec{raw_vec, 1, i32_type};
+
+    llvm::Value *num_partitions = codegen->CreateShl(
+        codegen.Const32(1), hash_table_.NumPartitionBits(codegen, build_ptr));
+    llvm::Value *partition = codegen.Const32(0);
+    lang::Loop partition_loop{codegen,
+                              codegen->CreateICmpULT(partition, num_partitions),
+                              {{"partition", partition}}};
+    {
+      partition = partition_loop.GetLoopVar(0);
+      hash_table_.BuildPartition(codegen, build_ptr, partition);
+
+      ProbePartition probe_partition{*this, ctx, selection_vec};
+      probe_table_.IteratePartition(codegen, probe_ptr, partition,
+                                    probe_partition);
+
+      partition = codegen->CreateAdd(partition, codegen.Const32(1));
+      partition_loop.LoopEnd(codegen->CreateICmpULT(partition, num_partitions),
+                             {partition});
+    }
+  };
+
+  // We set the pipeline to be serial in the constructor. Sanity check here.
+  auto &pipeline = GetPipeline();
+  PELOTON_ASSERT(!pipeline.IsParallel());
+  pipeline.RunSerial(producer);
 }
 
 void HashJoinTranslator::Consume(ConsumerContext &context,
@@ -376,7 +531,8 @@ void HashJoinTranslator::ConsumeFromLeft(ConsumerContext &ctx,
 
   // Update bloom filter, if enabled
   if (GetJoinPlan().IsBloomFilterEnabled()) {
-    bloom_filter_.Add(codegen, LoadStatePtr(bloom_filter_id_), key);
+    bloom_filter_.Add(codegen, LoadStatePtr(bloom_filter_id_), key,
+                      ctx.GetPipeline().IsParallel());
   }
 }
 
@@ -385,22 +541,51 @@ void HashJoinTranslator::RegisterPipelineState(PipelineContext &pipeline_ctx) {
     hash_table_tl_id_ = pipeline_ctx.RegisterState(
         "localHT", HashTableProxy::GetType(GetCodeGen()));
   }
+  if (pipeline_ctx.IsParallel() &&
+      IsRightPipeline(pipeline_ctx.GetPipeline())) {
+    probe_table_tl_id_ = pipeline_ctx.RegisterState(
+        "localProbeHT", HashTableProxy::GetType(GetCodeGen()));
+  }
 }
 
 void HashJoinTranslator::InitializePipelineState(
     PipelineContext &pipeline_ctx) {
+  CodeGen &codegen = GetCodeGen();
   if (pipeline_ctx.IsParallel() && IsLeftPipeline(pipeline_ctx.GetPipeline())) {
-    CodeGen &codegen = GetCodeGen();
-    hash_table_.Init(codegen, GetExecutorContextPtr(),
-                     pipeline_ctx.LoadStatePtr(codegen, hash_table_tl_id_));
+    auto *ht_ptr = pipeline_ctx.LoadStatePtr(codegen, hash_table_tl_id_);
+    hash_table_.Init(codegen, GetExecutorContextPtr(), ht_ptr);
+    if (GetJoinPlan().IsRadixPartitioned()) {
+      hash_table_.EnableSpilling(codegen, ht_ptr, GetExecutorContextPtr());
+    }
+  }
+  if (pipeline_ctx.IsParallel() &&
+      IsRightPipeline(pipeline_ctx.GetPipeline())) {
+    auto *ht_ptr = pipeline_ctx.LoadStatePtr(codegen, probe_table_tl_id_);
+    probe_table_.Init(codegen, GetExecutorContextPtr(), ht_ptr);
+    probe_table_.EnableSpilling(codegen, ht_ptr, GetExecutorContextPtr());
   }
 }
 
 void HashJoinTranslator::FinishPipeline(PipelineContext &pipeline_ctx) {
+  CodeGen &codegen = GetCodeGen();
+  if (IsRightPipeline(pipeline_ctx.GetPipeline())) {
+    // Partition the probe side on the bits the build side was partitioned on
+    llvm::Value *num_partition_bits =
+        hash_table_.NumPartitionBits(codegen, LoadStatePtr(hash_table_id_));
+    PartitionTable(pipeline_ctx, probe_table_, probe_table_id_,
+                   probe_table_tl_id_, num_partition_bits);
+    return;
+  }
+
   if (IsLeftPipeline(pipeline_ctx.GetPipeline())) {
-    CodeGen &codegen = GetCodeGen();
     llvm::Value *global_ht_ptr = LoadStatePtr(hash_table_id_);
-    if (!pipeline_ctx.IsParallel()) {
+    if (GetJoinPlan().IsRadixPartitioned()) {
+      // Let the table choose how many partitions it needs
+      auto *num_partition_bits =
+          codegen.Const32(util::HashTable::kAutoPartitionBits);
+      PartitionTable(pipeline_ctx, hash_table_, hash_table_id_,
+                     hash_table_tl_id_, num_partition_bits);
+    } else if (!pipeline_ctx.IsParallel()) {
       // Build the hash table over the lazily inserted tuples
       hash_table_.BuildLazy(codegen, global_ht_ptr);
     } else {
@@ -422,12 +607,34 @@ void HashJoinTranslator::FinishPipeline(PipelineContext &pipeline_ctx) {
   }
 }
 
+void HashJoinTranslator::PartitionTable(PipelineContext &pipeline_ctx,
+                                        const HashTable &table,
+                                        QueryState::Id table_id,
+                                        PipelineContext::Id table_tl_id,
+                                        llvm::Value *num_partition_bits) const {
+  CodeGen &codegen = GetCodeGen();
+  llvm::Value *table_ptr = LoadStatePtr(table_id);
+  if (!pipeline_ctx.IsParallel()) {
+    table.PartitionLazy(codegen, table_ptr, num_partition_bits);
+  } else {
+    // Partition the thread-local tables in parallel
+    table.PartitionLazyParallel(
+        codegen, table_ptr, GetThreadStatesPtr(),
+        pipeline_ctx.GetEntryOffset(codegen, table_tl_id), num_partition_bits);
+  }
+}
+
 void HashJoinTranslator::TearDownPipelineState(PipelineContext &pipeline_ctx) {
+  CodeGen &codegen = GetCodeGen();
   if (pipeline_ctx.IsParallel() && IsLeftPipeline(pipeline_ctx.GetPipeline())) {
-    CodeGen &codegen = GetCodeGen();
     auto *local_ht_ptr = pipeline_ctx.LoadStatePtr(codegen, hash_table_tl_id_);
     hash_table_.Destroy(codegen, local_ht_ptr);
   }
+  if (pipeline_ctx.IsParallel() &&
+      IsRightPipeline(pipeline_ctx.GetPipeline())) {
+    auto *local_ht_ptr = pipeline_ctx.LoadStatePtr(codegen, probe_table_tl_id_);
+    probe_table_.Destroy(codegen, local_ht_ptr);
+  }
 }
 
 // The given row is from the right child. Probe hash-table.
@@ -437,7 +644,7 @@ void HashJoinTranslator::ConsumeFromRight(ConsumerContext &context,
   std::vector<codegen::Value> key;
   CollectKeys(row, right_key_exprs_, key);
 
-  if (GetJoinPlan().IsBloomFilterEnabled()) {
+  if (GetJoinPlan().IsBloomFilterEnabled() && !bloom_filter_pushed_down_) {
     // Prefilter the tuple using Bloom Filter
     llvm::Value *contains = bloom_filter_.Contains(
         GetCodeGen(), LoadStatePtr(bloom_filter_id_), key);
@@ -446,15 +653,43 @@ void HashJoinTranslator::ConsumeFromRight(ConsumerContext &context,
     {
       // For each tuple that passes the bloom filter, probe the hash table
       // to eliminate the false positives.
-      CodegenHashProbe(context, row, key);
+      if (GetJoinPlan().IsRadixPartitioned()) {
+        MaterializeRight(context, row, key);
+      } else {
+        CodegenHashProbe(context, row, key);
+      }
     }
     is_valid_row.EndIf();
+  } else if (GetJoinPlan().IsRadixPartitioned()) {
+    // Keep the row until both sides are partitioned
+    MaterializeRight(context, row, key);
   } else {
-    // Bloom filter is not enabled. Directly probe the hash table
+    // Bloom filter is not enabled, or the probe side has already applied it.
+    // Directly probe the hash table
     CodegenHashProbe(context, row, key);
   }
 }
 
+void HashJoinTranslator::MaterializeRight(
+    ConsumerContext &context, RowBatch::Row &row,
+    const std::vector<codegen::Value> &key) const {
+  CodeGen &codegen = GetCodeGen();
+
+  std::vector<codegen::Value> vals;
+  CollectValues(row, right_val_ais_, vals);
+
+  llvm::Value *ht_ptr = nullptr;
+  if (context.GetPipeline().IsParallel()) {
+    ht_ptr =
+        context.GetPipelineContext()->LoadStatePtr(codegen, probe_table_tl_id_);
+  } else {
+    ht_ptr = LoadStatePtr(probe_table_id_);
+  }
+
+  InsertLeft insert_right{right_value_storage_, vals};
+  probe_table_.InsertLazy(codegen, ht_ptr, nullptr, key, insert_right);
+}
+
 void HashJoinTranslator::CodegenHashProbe(
     ConsumerContext &context, RowBatch::Row &row,
     std::vector<codegen::Value> &key) const {
@@ -470,6 +705,9 @@ void HashJoinTranslator::CodegenHashProbe(
 void HashJoinTranslator::TearDownQueryState() {
   CodeGen &codegen = GetCodeGen();
   hash_table_.Destroy(codegen, LoadStatePtr(hash_table_id_));
+  if (GetJoinPlan().IsRadixPartitioned()) {
+    probe_table_.Destroy(codegen, LoadStatePtr(probe_table_id_));
+  }
   if (GetJoinPlan().IsBloomFilterEnabled()) {
     bloom_filter_.Destroy(GetCodeGen(), LoadStatePtr(bloom_filter_id_));
   }
@@ -483,10 +721,14 @@ uint64_t HashJoinTranslator::EstimateHashTableSize() const {
 
 // Return the estimated number of tuples produced by the left child
 uint64_t HashJoinTranslator::EstimateCardinalityLeft() const {
-  // TODO:Implement this once optimizer provide cardinality to executor.
-  // Right now, it's hard coded to a relatively large number to make sure
-  // bloom filter works correctly.
-  return (uint64_t)GetJoinPlan().GetChild(0)->GetCardinality();
+  // Use the optimizer's estimate if it made one. Otherwise, fall back to the
+  // cardinality of the plan, which is a relatively large number by default to
+  // make sure bloom filter works correctly.
+  const auto *left_plan = GetJoinPlan().GetChild(0);
+  if (left_plan->GetEstimatedRows() > 0) {
+    return (uint64_t)left_plan->GetEstimatedRows();
+  }
+  return (uint64_t)left_plan->GetCardinality();
 }
 
 // Should this aggregation use prefetching
@@ -579,5 +821,41 @@ void HashJoinTranslator::ProbeRight::ProcessEntry(
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+///
+/// ProbePartition
+///
+////////////////////////////////////////////////////////////////////////////////
+
+void HashJoinTranslator::ProbePartition::ProcessEntry(
+    CodeGen &codegen, const std::vector<codegen::Value> &key,
+    llvm::Value *data_area) const {
+  std::vector<codegen::Value> right_vals;
+  join_translator_.right_value_storage_.LoadValues(codegen, data_area,
+                                                   right_vals);
+
+  // The row has no attribute accessors, all its attributes are registered
+  RowBatch batch{context_.GetCompilationContext(), codegen.Const32(0),
+                 codegen.Const32(1), selection_vector_, false};
+  batch.Iterate(codegen, [&](RowBatch::Row &row) {
+    const auto &right_val_ais = join_translator_.right_val_ais_;
+    for (uint32_t i = 0; i < right_val_ais.size(); i++) {
+      row.RegisterAttributeValue(right_val_ais[i], right_vals[i]);
+    }
+
+    const auto &right_key_exprs = join_translator_.right_key_exprs_;
+    for (uint32_t i = 0; i < right_key_exprs.size(); i++) {
+      const auto *exp = right_key_exprs[i];
+      if (exp->GetExpressionType() == ExpressionType::VALUE_TUPLE) {
+        auto *tve = static_cast<const expression::TupleValueExpression *>(exp);
+        row.RegisterAttributeValue(tve->GetAttributeRef(), key[i]);
+      }
+    }
+
+    std::vector<codegen::Value> probe_key{key};
+    join_translator_.CodegenHashProbe(context_, row, probe_key);
+  });
+}
+
 }  // namespace codegen
 }  // namespace peloton
\ No newline at end of file
@@ -20,6 +20,7 @@
 #include "codegen/proxy/zone_map_proxy.h"
 #include "codegen/type/boolean_type.h"
 #include "codegen/vector.h"
+#include "expression/tuple_value_expression.h"
 #include "planner/seq_scan_plan.h"
 #include "storage/data_table.h"
 
@@ -74,10 +75,17 @@ class TableScanTranslator::ScanConsumer : public codegen::ScanCallback {
  public:
   // Constructor
   ScanConsumer(ConsumerContext &ctx, const planner::SeqScanPlan &plan,
-               Vector &selection_vector)
+               Vector &selection_vector,
+               const std::vector<PushedBloomFilter> &bloom_filters,
+               llvm::Value *key_hashes, uint32_t num_compressed_predicates,
+               llvm::Value *compressed_predicates)
       : ctx_(ctx),
         plan_(plan),
         selection_vector_(selection_vector),
+        bloom_filters_(bloom_filters),
+        key_hashes_(key_hashes),
+        num_compressed_predicates_(num_compressed_predicates),
+        compressed_predicates_(compressed_predicates),
         tile_group_id_(nullptr),
         tile_group_ptr_(nullptr) {}
 
@@ -107,6 +115,13 @@ class TableScanTranslator::ScanConsumer : public codegen::ScanCallback {
 
   void PerformReads(CodeGen &codegen, Vector &selection_vector) const;
 
+  // Filter the rows in the selection vector by the bloom filters pushed down
+  // into the scan
+  void FilterRowsByBloomFilters(CodeGen &codegen,
+                                const TileGroup::TileGroupAccess &access,
+                                llvm::Value *tid_start, llvm::Value *tid_end,
+                                Vector &selection_vector) const;
+
   // Filter all the rows whose TIDs are in the range [tid_start, tid_end] and
   // store their TIDs in the output TID selection vector
   void FilterRowsByPredicate(CodeGen &codegen,
@@ -114,6 +129,12 @@ class TableScanTranslator::ScanConsumer : public codegen::ScanCallback {
                              llvm::Value *tid_start, llvm::Value *tid_end,
                              Vector &selection_vector) const;
 
+  // Filter the TIDs in the selection vector using the compressed form of the
+  // tile group. Returns the number of qualifying TIDs, or a negative value if
+  // the tile group isn't compressed (the selection vector is then untouched).
+  llvm::Value *FilterRowsByCompressedPredicate(CodeGen &codegen,
+                                               Vector &selection_vector) const;
+
  private:
   // The consumer context
   ConsumerContext &ctx_;
@@ -121,6 +142,14 @@ class TableScanTranslator::ScanConsumer : public codegen::ScanCallback {
   const planner::SeqScanPlan &plan_;
   // The selection vector used for vectorized scans
   Vector &selection_vector_;
+  // The bloom filters pushed down into the scan
+  const std::vector<PushedBloomFilter> &bloom_filters_;
+  // The hashes of the bloom filter keys of the rows in the selection vector
+  llvm::Value *key_hashes_;
+  // The predicates that compressed tile groups evaluate, if the scan predicate
+  // consists of them
+  uint32_t num_compressed_predicates_;
+  llvm::Value *compressed_predicates_;
   // The current tile group id we're scanning over
   llvm::Value *tile_group_id_;
   // The current tile group we're scanning over
@@ -147,6 +176,96 @@ TableScanTranslator::TableScanTranslator(const planner::SeqScanPlan &scan,
   if (predicate != nullptr) {
     context.Prepare(*predicate);
   }
+
+  // Frozen tile groups can evaluate a conjunction of comparisons between
+  // columns and constants on their compressed columns. The compiled query is
+  // shared by queries that differ only in their constants, so the predicates
+  // are built from the constants' values per execution.
+  if (GetCompressedPredicates(predicate, compressed_predicates_)) {
+    auto &codegen = context.GetCodeGen();
+    auto *predicates_type =
+        llvm::ArrayType::get(PredicateInfoProxy::GetType(codegen),
+                             compressed_predicates_.size());
+    compressed_predicates_id_ = context.GetQueryState().RegisterState(
+        "compressedPredicates", predicates_type);
+  } else {
+    compressed_predicates_.clear();
+  }
+}
+
+void TableScanTranslator::InitializeQueryState() {
+  if (compressed_predicates_.empty()) {
+    return;
+  }
+  CodeGen &codegen = GetCodeGen();
+  CompilationContext &context = GetCompilationContext();
+  llvm::Value *query_parameters_ptr =
+      context.GetExecutionConsumer().GetQueryParametersPtr(context);
+  llvm::Value *predicates_ptr = LoadCompressedPredicatesPtr(codegen);
+  for (uint32_t i = 0; i < compressed_predicates_.size(); i++) {
+    const auto &predicate = compressed_predicates_[i];
+    uint32_t param_idx = context.GetParameterCache().GetIndex(predicate.value);
+    llvm::Value *predicate_ptr = codegen->CreateConstInBoundsGEP1_32(
+        PredicateInfoProxy::GetType(codegen), predicates_ptr, i);
+    codegen.Call(
+        RuntimeFunctionsProxy::InitCompressedPredicate,
+        {predicate_ptr, codegen.Const32(predicate.col_id),
+         codegen.Const32(static_cast<int32_t>(predicate.comparison_operator)),
+         query_parameters_ptr, codegen.Const32(param_idx)});
+  }
+}
+
+void TableScanTranslator::TearDownQueryState() {
+  if (compressed_predicates_.empty()) {
+    return;
+  }
+  CodeGen &codegen = GetCodeGen();
+  codegen.Call(RuntimeFunctionsProxy::DestroyCompressedPredicates,
+               {LoadCompressedPredicatesPtr(codegen),
+                codegen.Const32(compressed_predicates_.size())});
+}
+
+bool TableScanTranslator::GetCompressedPredicates(
+    const expression::AbstractExpression *predicate,
+    std::vector<CompressedPredicate> &compressed_predicates) {
+  if (predicate == nullptr) {
+    return false;
+  }
+  switch (predicate->GetExpressionType()) {
+    case ExpressionType::CONJUNCTION_AND:
+      return GetCompressedPredicates(predicate->GetChild(0),
+                                     compressed_predicates) &&
+             GetCompressedPredicates(predicate->GetChild(1),
+                                     compressed_predicates);
+    case ExpressionType::COMPARE_EQUAL:
+    case ExpressionType::COMPARE_LESSTHAN:
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+    case ExpressionType::COMPARE_GREATERTHAN:
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO: {
+      const auto *column = predicate->GetChild(0);
+      const auto *value = predicate->GetChild(1);
+      auto value_type = value->GetExpressionType();
+      if (column->GetExpressionType() != ExpressionType::VALUE_TUPLE ||
+          (value_type != ExpressionType::VALUE_CONSTANT &&
+           value_type != ExpressionType::VALUE_PARAMETER)) {
+        return false;
+      }
+      auto col_id = static_cast<const expression::TupleValueExpression *>(
+                        column)->GetColumnId();
+      compressed_predicates.push_back(CompressedPredicate{
+          col_id, predicate->GetExpressionType(), value});
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+llvm::Value *TableScanTranslator::LoadCompressedPredicatesPtr(
+    CodeGen &codegen) const {
+  llvm::Value *predicates_ptr = LoadStatePtr(compressed_predicates_id_);
+  return codegen->CreateBitCast(
+      predicates_ptr, PredicateInfoProxy::GetType(codegen)->getPointerTo());
 }
 
 // TODO merge serial and parallel since there is a lot of duplication
@@ -191,7 +310,27 @@ void TableScanTranslator::ProduceSerial() const {
       }
     }
 
-    ScanConsumer scan_consumer{ctx, GetScanPlan(), position_list};
+    // The hashes of the keys that probe the pushed down bloom filters
+    llvm::Value *key_hashes = nullptr;
+    if (!bloom_filters_.empty()) {
+      key_hashes = codegen.AllocateBuffer(codegen.Int64Type(), vec_size,
+                                          "scanKeyHashes");
+    }
+
+    // The predicates to evaluate on compressed tile groups
+    llvm::Value *compressed_predicates = nullptr;
+    if (!compressed_predicates_.empty()) {
+      compressed_predicates = LoadCompressedPredicatesPtr(codegen);
+    }
+
+    ScanConsumer scan_consumer{ctx,
+                               GetScanPlan(),
+                               position_list,
+                               bloom_filters_,
+                               key_hashes,
+                               static_cast<uint32_t>(
+                                   compressed_predicates_.size()),
+                               compressed_predicates};
     table_.GenerateScan(codegen, table_ptr, nullptr, nullptr, vec_size,
                         predicate_ptr, num_preds, scan_consumer);
   };
@@ -248,8 +387,28 @@ void TableScanTranslator::ProduceParallel() const {
       }
     }
 
+    // The hashes of the keys that probe the pushed down bloom filters
+    llvm::Value *key_hashes = nullptr;
+    if (!bloom_filters_.empty()) {
+      key_hashes = codegen.AllocateBuffer(codegen.Int64Type(), vec_size,
+                                          "scanKeyHashes");
+    }
+
+    // The predicates to evaluate on compressed tile groups
+    llvm::Value *compressed_predicates = nullptr;
+    if (!compressed_predicates_.empty()) {
+      compressed_predicates = LoadCompressedPredicatesPtr(codegen);
+    }
+
     // Scan the given range of the table
-    ScanConsumer scan_consumer{ctx, GetScanPlan(), position_list};
+    ScanConsumer scan_consumer{ctx,
+                               GetScanPlan(),
+                               position_list,
+                               bloom_filters_,
+                               key_hashes,
+                               static_cast<uint32_t>(
+                                   compressed_predicates_.size()),
+                               compressed_predicates};
     table_.GenerateScan(codegen, table_ptr, tilegroup_start, tilegroup_end,
                         vec_size, predicate_ptr, num_preds, scan_consumer);
   };
@@ -267,6 +426,34 @@ void TableScanTranslator::Produce() const {
   }
 }
 
+bool TableScanTranslator::CanPushDownBloomFilter(
+    const std::vector<const expression::AbstractExpression *> &key_exprs)
+    const {
+  std::vector<const planner::AttributeInfo *> ais;
+  GetScanPlan().GetAttributes(ais);
+  std::unordered_set<const planner::AttributeInfo *> scan_ais(ais.begin(),
+                                                              ais.end());
+
+  std::unordered_set<const planner::AttributeInfo *> used_attributes;
+  for (const auto *key_expr : key_exprs) {
+    key_expr->GetUsedAttributes(used_attributes);
+  }
+  for (const auto *ai : used_attributes) {
+    if (scan_ais.count(ai) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void TableScanTranslator::PushDownBloomFilter(
+    const BloomFilterAccessor &bloom_filter, QueryState::Id bloom_filter_id,
+    const std::vector<const expression::AbstractExpression *> &key_exprs) {
+  PELOTON_ASSERT(CanPushDownBloomFilter(key_exprs));
+  bloom_filters_.push_back(
+      PushedBloomFilter{&bloom_filter, bloom_filter_id, key_exprs});
+}
+
 const planner::SeqScanPlan &TableScanTranslator::GetScanPlan() const {
   return GetPlanAs<planner::SeqScanPlan>();
 }
@@ -284,25 +471,50 @@ void TableScanTranslator::ScanConsumer::ProcessTuples(
   // 1. Filter the rows in the range [tid_start, tid_end) by txn visibility
   FilterRowsByVisibility(codegen, tid_start, tid_end, selection_vector_);
 
-  // 2. Filter rows by the given predicate (if one exists)
+  // 2. Filter rows by the bloom filters of joins (if any were pushed down), so
+  //    that the predicate and the reads skip the rows without join partners
+  if (!bloom_filters_.empty()) {
+    FilterRowsByBloomFilters(codegen, tile_group_access, tid_start, tid_end,
+                             selection_vector_);
+  }
+
+  // 3. Filter rows by the given predicate (if one exists)
   auto *predicate = plan_.GetPredicate();
   if (predicate != nullptr) {
-    // First perform a vectorized filter, putting TIDs into the selection vector
-    FilterRowsByPredicate(codegen, tile_group_access, tid_start, tid_end,
-                          selection_vector_);
+    if (num_compressed_predicates_ != 0) {
+      // The predicate only compares columns with constants. If the tile group
+      // is frozen, evaluate it directly on the compressed data and fall back
+      // to the regular filter otherwise.
+      llvm::Value *num_compressed =
+          FilterRowsByCompressedPredicate(codegen, selection_vector_);
+      llvm::Value *not_compressed =
+          codegen->CreateICmpSLT(num_compressed, codegen.Const32(0));
+      lang::If uncompressed{codegen, not_compressed, "uncompressedFilter"};
+      {
+        FilterRowsByPredicate(codegen, tile_group_access, tid_start, tid_end,
+                              selection_vector_);
+      }
+      uncompressed.EndIf();
+      selection_vector_.SetNumElements(uncompressed.BuildPHI(
+          selection_vector_.GetNumElements(), num_compressed));
+    } else {
+      // Perform a vectorized filter, putting TIDs into the selection vector
+      FilterRowsByPredicate(codegen, tile_group_access, tid_start, tid_end,
+                            selection_vector_);
+    }
   }
 
-  // 3. Record reads for all of the tuple that are visible and pass predicate
+  // 4. Record reads for all of the tuple that are visible and pass predicate
   PerformReads(codegen, selection_vector_);
 
-  // 4. Setup the (filtered) row batch and setup attribute accessors
+  // 5. Setup the (filtered) row batch and setup attribute accessors
   RowBatch batch{ctx_.GetCompilationContext(), tile_group_id_, tid_start,
                  tid_end, selection_vector_, true};
 
   std::vector<TableScanTranslator::AttributeAccess> attribute_accesses;
   SetupRowBatch(batch, tile_group_access, attribute_accesses);
 
-  // 5. Push the batch into the pipeline
+  // 6. Push the batch into the pipeline
   ctx_.Consume(batch);
 }
 
@@ -345,6 +557,53 @@ void TableScanTranslator::ScanConsumer::FilterRowsByVisibility(
   selection_vector.SetNumElements(out_idx);
 }
 
+void TableScanTranslator::ScanConsumer::FilterRowsByBloomFilters(
+    CodeGen &codegen, const TileGroup::TileGroupAccess &access,
+    llvm::Value *tid_start, llvm::Value *tid_end,
+    Vector &selection_vector) const {
+  QueryState &query_state = ctx_.GetCompilationContext().GetQueryState();
+  for (const auto &bloom_filter : bloom_filters_) {
+    // The batch we're filtering
+    RowBatch batch{ctx_.GetCompilationContext(), tile_group_id_, tid_start,
+                   tid_end, selection_vector, true};
+
+    // Setup the row batch with attribute accessors for the keys
+    std::unordered_set<const planner::AttributeInfo *> used_attributes;
+    for (const auto *key_expr : bloom_filter.key_exprs) {
+      key_expr->GetUsedAttributes(used_attributes);
+    }
+    std::vector<AttributeAccess> attribute_accessors;
+    for (const auto *ai : used_attributes) {
+      attribute_accessors.emplace_back(access, ai);
+    }
+    for (auto &accessor : attribute_accessors) {
+      batch.AddAttribute(accessor.GetAttributeRef(), &accessor);
+    }
+
+    // First hash the keys of all the rows, keeping every row ...
+    batch.Iterate(codegen, [&](RowBatch::Row &row) {
+      std::vector<codegen::Value> key;
+      for (const auto *key_expr : bloom_filter.key_exprs) {
+        key.push_back(row.DeriveValue(codegen, *key_expr));
+      }
+      llvm::Value *hash = bloom_filter.accessor->HashKey(codegen, key);
+      codegen->CreateStore(
+          hash, codegen->CreateInBoundsGEP(codegen.Int64Type(), key_hashes_,
+                                           row.GetBatchPosition()));
+      row.SetValidity(codegen, codegen.ConstBool(true));
+    });
+
+    // ... then probe the bloom filter with all of them at once, which lets
+    // the probes overlap their cache misses
+    llvm::Value *bloom_filter_ptr =
+        query_state.LoadStatePtr(codegen, bloom_filter.id);
+    llvm::Value *num_found = bloom_filter.accessor->Filter(
+        codegen, bloom_filter_ptr, key_hashes_, selection_vector.GetVectorPtr(),
+        selection_vector.GetNumElements());
+    selection_vector.SetNumElements(num_found);
+  }
+}
+
 void TableScanTranslator::ScanConsumer::FilterRowsByPredicate(
     CodeGen &codegen, const TileGroup::TileGroupAccess &access,
     llvm::Value *tid_start, llvm::Value *tid_end,
@@ -384,6 +643,18 @@ void TableScanTranslator::ScanConsumer::FilterRowsByPredicate(
   });
 }
 
+llvm::Value *TableScanTranslator::ScanConsumer::FilterRowsByCompressedPredicate(
+    CodeGen &codegen, Vector &selection_vector) const {
+  llvm::Value *raw_sel_vec = selection_vector.GetVectorPtr();
+
+  // Invoke RuntimeFunctions::FilterCompressedTileGroup(...)
+  return codegen.Call(
+      RuntimeFunctionsProxy::FilterCompressedTileGroup,
+      {tile_group_ptr_, compressed_predicates_,
+       codegen.Const32(num_compressed_predicates_), raw_sel_vec,
+       selection_vector.GetNumElements()});
+}
+
 void TableScanTranslator::ScanConsumer::PerformReads(
     CodeGen &codegen, Vector &selection_vector) const {
   ExecutionConsumer &ec = ctx_.GetCompilationContext().GetExecutionConsumer();
@@ -43,6 +43,16 @@ codegen::Value ParameterCache::GetValue(
   return GetValue(parameters_map_.GetIndex(expr));
 }
 
+codegen::Value ParameterCache::DeriveValue(
+    CodeGen &codegen, llvm::Value *query_parameters_ptr,
+    const expression::AbstractExpression *expr) const {
+  uint32_t index = parameters_map_.GetIndex(expr);
+  auto &parameter = parameters_map_.GetParameters()[index];
+  return DeriveParameterValue(codegen, query_parameters_ptr, index,
+                              parameter.GetValueType(),
+                              parameter.IsNullable());
+}
+
 void ParameterCache::Reset() { values_.clear(); }
 
 codegen::Value ParameterCache::DeriveParameterValue(
@@ -15,11 +15,12 @@
 namespace peloton {
 namespace codegen {
 
-DEFINE_TYPE(BloomFilter, "peloton::BloomFilter", num_hash_funcs, bytes,
-            num_bits, num_misses, num_probes);
+DEFINE_TYPE(BloomFilter, "peloton::BloomFilter", blocks, num_blocks,
+            num_misses, num_probes);
 
 DEFINE_METHOD(peloton::codegen::util, BloomFilter, Init);
 DEFINE_METHOD(peloton::codegen::util, BloomFilter, Destroy);
+DEFINE_METHOD(peloton::codegen::util, BloomFilter, Filter);
 
 }  // namespace codegen
 }  // namespace peloton
\ No newline at end of file
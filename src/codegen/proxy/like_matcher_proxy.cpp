@@ -0,0 +1,27 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// like_matcher_proxy.cpp
+//
+// Identification: src/codegen/proxy/like_matcher_proxy.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/proxy/like_matcher_proxy.h"
+
+#include "codegen/proxy/executor_context_proxy.h"
+
+namespace peloton {
+namespace codegen {
+
+DEFINE_TYPE(LikeMatcher, "peloton::LikeMatcher", opaque);
+
+DEFINE_METHOD(peloton::codegen::util, LikeMatcher, Init);
+DEFINE_METHOD(peloton::codegen::util, LikeMatcher, Destroy);
+DEFINE_METHOD(peloton::codegen::util, LikeMatcher, Matches);
+
+}  // namespace codegen
+}  // namespace peloton
@@ -32,6 +32,9 @@ DEFINE_METHOD(peloton::codegen, RuntimeFunctions, HashMurmur3);
 DEFINE_METHOD(peloton::codegen, RuntimeFunctions, HashCrc64);
 DEFINE_METHOD(peloton::codegen, RuntimeFunctions, GetTileGroup);
 DEFINE_METHOD(peloton::codegen, RuntimeFunctions, GetTileGroupLayout);
+DEFINE_METHOD(peloton::codegen, RuntimeFunctions, InitCompressedPredicate);
+DEFINE_METHOD(peloton::codegen, RuntimeFunctions, DestroyCompressedPredicates);
+DEFINE_METHOD(peloton::codegen, RuntimeFunctions, FilterCompressedTileGroup);
 DEFINE_METHOD(peloton::codegen, RuntimeFunctions, FillPredicateArray);
 DEFINE_METHOD(peloton::codegen, RuntimeFunctions, ExecuteTableScan);
 DEFINE_METHOD(peloton::codegen, RuntimeFunctions, ExecutePerState);
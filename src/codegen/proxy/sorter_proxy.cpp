@@ -27,6 +27,7 @@ DEFINE_METHOD(peloton::codegen::util, Sorter, StoreTupleForTopKFinish);
 DEFINE_METHOD(peloton::codegen::util, Sorter, Sort);
 DEFINE_METHOD(peloton::codegen::util, Sorter, SortParallel);
 DEFINE_METHOD(peloton::codegen::util, Sorter, SortTopKParallel);
+DEFINE_METHOD(peloton::codegen::util, Sorter, NextChunk);
 DEFINE_METHOD(peloton::codegen::util, Sorter, Destroy);
 
 }  // namespace codegen
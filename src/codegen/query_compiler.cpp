@@ -17,6 +17,7 @@
 #include "planner/hash_join_plan.h"
 #include "planner/projection_plan.h"
 #include "planner/seq_scan_plan.h"
+#include "storage/data_table.h"
 
 namespace peloton {
 namespace codegen {
@@ -91,6 +92,11 @@ bool QueryCompiler::IsSupported(const planner::AbstractPlan &plan) {
   switch (plan.GetPlanNodeType()) {
     case PlanNodeType::SEQSCAN: {
       auto &scan_plan = static_cast<const planner::SeqScanPlan &>(plan);
+      // Compiled scans do not rebuild versions from undo records
+      if (scan_plan.GetTable() != nullptr &&
+          scan_plan.GetTable()->UsesDeltaStorage()) {
+        return false;
+      }
       pred = scan_plan.GetPredicate();
       break;
     }
@@ -16,11 +16,13 @@
 
 #include "murmur3/MurmurHash3.h"
 
+#include "codegen/query_parameters.h"
 #include "common/exception.h"
 #include "common/logger.h"
 #include "common/timer.h"
 #include "common/synchronization/count_down_latch.h"
 #include "expression/abstract_expression.h"
+#include "storage/compressed_tile_group.h"
 #include "storage/data_table.h"
 #include "storage/layout.h"
 #include "storage/storage_manager.h"
@@ -104,6 +106,47 @@ void RuntimeFunctions::FillPredicateArray(
   temp_expr->ClearParsedPredicates();
 }
 
+//===----------------------------------------------------------------------===//
+// Build a predicate on a compressed column from the value of a query parameter
+//===----------------------------------------------------------------------===//
+void RuntimeFunctions::InitCompressedPredicate(
+    storage::PredicateInfo *predicate, int32_t col_id,
+    int32_t comparison_operator, const QueryParameters *parameters,
+    uint32_t param_idx) {
+  new (predicate) storage::PredicateInfo();
+  predicate->col_id = col_id;
+  predicate->comparison_operator = comparison_operator;
+  predicate->predicate_value = parameters->GetParameterValues()[param_idx];
+}
+
+void RuntimeFunctions::DestroyCompressedPredicates(
+    storage::PredicateInfo *predicates, uint32_t num_predicates) {
+  for (uint32_t i = 0; i < num_predicates; i++) {
+    predicates[i].~PredicateInfo();
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// Evaluate the simple (conjunctive) predicate on the compressed columns of the
+// tile group, if it has been frozen
+//===----------------------------------------------------------------------===//
+int32_t RuntimeFunctions::FilterCompressedTileGroup(
+    const storage::TileGroup *tile_group,
+    const storage::PredicateInfo *predicates, uint32_t num_predicates,
+    uint32_t *sel_vec, uint32_t num_sel) {
+  auto compressed_tile_group = tile_group->GetCompressedTileGroup();
+  if (compressed_tile_group == nullptr) {
+    return -1;
+  }
+
+  uint32_t num_out = 0;
+  if (!compressed_tile_group->Filter(predicates, num_predicates, sel_vec,
+                                     num_sel, num_out)) {
+    return -1;
+  }
+  return static_cast<int32_t>(num_out);
+}
+
 //===----------------------------------------------------------------------===//
 // For every column in the tile group, fill out the layout information for the
 // column in the provided 'infos' array.  Specifically, we need a pointer to
@@ -136,34 +136,46 @@ void Sorter::Iterate(CodeGen &codegen, llvm::Value *sorter_ptr,
                     taat_cb);
 }
 
-// Iterate over the tuples in the sorter in batches/vectors of the given size
+// Iterate over the tuples in the sorter in batches/vectors of the given size.
+// A sorter that spilled to disk produces its sorted tuples in chunks, so we
+// iterate over each chunk in turn. The offset only applies to the first one.
 void Sorter::VectorizedIterate(
     CodeGen &codegen, llvm::Value *sorter_ptr, uint32_t vector_size,
     uint64_t offset, Sorter::VectorizedIterateCallback &callback) const {
-  llvm::Value *start_pos = codegen.Load(SorterProxy::tuples_start, sorter_ptr);
-  llvm::Value *num_tuples = NumTuples(codegen, sorter_ptr);
-  num_tuples = codegen->CreateTrunc(num_tuples, codegen.Int32Type());
-
-  if (offset != 0) {
-    start_pos = codegen->CreateConstInBoundsGEP1_32(codegen.CharPtrType(),
-                                                    start_pos, offset);
-    num_tuples = codegen->CreateSub(num_tuples, codegen.Const32(offset));
-  }
-
-  lang::VectorizedLoop loop(codegen, num_tuples, vector_size, {});
+  lang::Loop chunk_loop(codegen, codegen.ConstBool(true),
+                        {{"offset", codegen.Const32(offset)}});
   {
-    // Current loop range
-    auto curr_range = loop.GetCurrentRange();
+    llvm::Value *start_pos =
+        codegen.Load(SorterProxy::tuples_start, sorter_ptr);
+    llvm::Value *num_tuples = NumTuples(codegen, sorter_ptr);
+    num_tuples = codegen->CreateTrunc(num_tuples, codegen.Int32Type());
+
+    if (offset != 0) {
+      llvm::Value *chunk_offset = chunk_loop.GetLoopVar(0);
+      start_pos = codegen->CreateInBoundsGEP(codegen.CharPtrType(), start_pos,
+                                             chunk_offset);
+      num_tuples = codegen->CreateSub(num_tuples, chunk_offset);
+    }
 
-    // Provide an accessor into the sorted space
-    SorterAccess sorter_access(*this, start_pos);
+    lang::VectorizedLoop loop(codegen, num_tuples, vector_size, {});
+    {
+      // Current loop range
+      auto curr_range = loop.GetCurrentRange();
 
-    // Issue the callback
-    callback.ProcessEntries(codegen, curr_range.start, curr_range.end,
-                            sorter_access);
+      // Provide an accessor into the sorted space
+      SorterAccess sorter_access(*this, start_pos);
+
+      // Issue the callback
+      callback.ProcessEntries(codegen, curr_range.start, curr_range.end,
+                              sorter_access);
+
+      // That's it
+      loop.LoopEnd(codegen, {});
+    }
 
-    // That's it
-    loop.LoopEnd(codegen, {});
+    // Move to the next chunk, if there is one
+    llvm::Value *more = codegen.Call(SorterProxy::NextChunk, {sorter_ptr});
+    chunk_loop.LoopEnd(more, {codegen.Const32(0)});
   }
 }
 
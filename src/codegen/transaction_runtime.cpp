@@ -12,16 +12,26 @@
 
 #include "codegen/transaction_runtime.h"
 
+#include <algorithm>
+
 #include "catalog/manager.h"
 #include "common/container_tuple.h"
 #include "concurrency/transaction_context.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "executor/executor_context.h"
 #include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
 
 namespace peloton {
 namespace codegen {
 
+namespace {
+
+// The number of versions whose visibility is checked together
+constexpr uint32_t kVisibilityBatchSize = 64;
+
+}  // namespace
+
 uint32_t TransactionRuntime::PerformVisibilityCheck(
     concurrency::TransactionContext &txn, storage::TileGroup &tile_group,
     uint32_t tid_start, uint32_t tid_end, uint32_t *selection_vector) {
@@ -31,16 +41,60 @@ uint32_t TransactionRuntime::PerformVisibilityCheck(
   // Get the tile group header
   auto tile_group_header = tile_group.GetHeader();
 
+  // If all versions in the tile group are visible to us, skip the checks
+  cid_t read_id = txn.GetReadId();
+  if (read_id >= tile_group_header->GetAllVisibleCommitId()) {
+    for (uint32_t i = tid_start; i < tid_end; i++) {
+      selection_vector[i - tid_start] = i;
+    }
+    return tid_end - tid_start;
+  }
+
   // Check visibility of tuples in the range [tid_start, tid_end), storing all
-  // visible tuple IDs in the provided selection vector
+  // visible tuple IDs in the provided selection vector. We gather the headers
+  // of a batch of versions and check the ones we don't own without branching.
+  // A version owned by another transaction is only visible while it is the
+  // committed old version of an update, which the commit id range covers.
+  txn_id_t txn_id = txn.GetTransactionId();
+  txn_id_t txn_ids[kVisibilityBatchSize];
+  cid_t begin_cids[kVisibilityBatchSize];
+  cid_t end_cids[kVisibilityBatchSize];
+  uint8_t visible[kVisibilityBatchSize];
+
   uint32_t out_idx = 0;
-  for (uint32_t i = tid_start; i < tid_end; i++) {
-    // Perform the visibility check
-    auto visibility = txn_manager.IsVisible(&txn, tile_group_header, i);
+  for (uint32_t batch_start = tid_start; batch_start < tid_end;
+       batch_start += kVisibilityBatchSize) {
+    uint32_t batch_size =
+        std::min(kVisibilityBatchSize, tid_end - batch_start);
+    for (uint32_t j = 0; j < batch_size; j++) {
+      txn_ids[j] = tile_group_header->GetTransactionId(batch_start + j);
+      begin_cids[j] = tile_group_header->GetBeginCommitId(batch_start + j);
+      end_cids[j] = tile_group_header->GetEndCommitId(batch_start + j);
+    }
+
+    uint32_t num_owned = 0;
+    for (uint32_t j = 0; j < batch_size; j++) {
+      visible[j] = (txn_ids[j] != INVALID_TXN_ID) &
+                   (begin_cids[j] <= read_id) & (read_id < end_cids[j]);
+      num_owned += (txn_ids[j] == txn_id);
+    }
+
+    // Versions we own are either our own writes or being replaced by them
+    if (num_owned > 0) {
+      for (uint32_t j = 0; j < batch_size; j++) {
+        if (txn_ids[j] == txn_id) {
+          auto visibility =
+              txn_manager.IsVisible(&txn, tile_group_header, batch_start + j);
+          visible[j] = (visibility == VisibilityType::OK);
+        }
+      }
+    }
 
     // Update the output position
-    selection_vector[out_idx] = i;
-    out_idx += (visibility == VisibilityType::OK);
+    for (uint32_t j = 0; j < batch_size; j++) {
+      selection_vector[out_idx] = batch_start + j;
+      out_idx += visible[j];
+    }
   }
   return out_idx;
 }
@@ -11,13 +11,15 @@
 //===----------------------------------------------------------------------===//
 
 #include "codegen/util/bloom_filter.h"
-#include "codegen/lang/if.h"
-#include "codegen/lang/loop.h"
 
+#include <algorithm>
 #include <cmath>
-#include <vector>
 
-#define OPTIMAL_NUM_HASH_FUNC 0
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "common/logger.h"
 
 namespace peloton {
 namespace codegen {
@@ -26,42 +28,43 @@ namespace util {
 //===----------------------------------------------------------------------===//
 // Static Members
 //===----------------------------------------------------------------------===//
-const Hash::HashMethod BloomFilter::kSeedHashFuncs[2] = {
-    Hash::HashMethod::Murmur3, Hash::HashMethod::Crc32};
+const Hash::HashMethod BloomFilter::kHashFunc = Hash::HashMethod::Murmur3;
 
 const double BloomFilter::kFalsePositiveRate = 0.1;
 
-// Set it to OPTIMAL_NUM_HASH_FUNC to minimize bloom filter memory footprint
-const uint64_t BloomFilter::kNumHashFuncs = 1;
+const uint32_t BloomFilter::kNumHashFuncs;
+
+const uint32_t BloomFilter::kBitsPerBlock;
+
+// The number of keys whose blocks are prefetched ahead of the one probed
+static const uint32_t kPrefetchDistance = 16;
 
 //===----------------------------------------------------------------------===//
 // Member Functions
 //===----------------------------------------------------------------------===//
 
 void BloomFilter::Init(uint64_t estimated_num_tuples) {
-  if (kNumHashFuncs == OPTIMAL_NUM_HASH_FUNC) {
-    // Calculate the optimal number of hash functions and num of bits that
-    // will minimize the bloom filter's memory footprint. Formula is from
-    // http://blog.michaelschmatz.com/2016/04/11/how-to-write-a-bloom-filter-cpp/
-    num_bits_ = -(double)estimated_num_tuples * log(kFalsePositiveRate) /
-                (log(2) * log(2));
-    num_hash_funcs_ = (double)num_bits_ * log(2) / (double)estimated_num_tuples;
-  } else {
-    // Manually set the number of hash functions to use. The memory footprint
-    // may not be mininal but the performance could better since the cost of
-    // probing bloom filter is O(num_hash_funcs_). Formula is from wikipedia.
-    num_hash_funcs_ = kNumHashFuncs;
-    num_bits_ = -(double)estimated_num_tuples * num_hash_funcs_ /
-                log(1 - pow(kFalsePositiveRate, 1.0 / (double)num_hash_funcs_));
+  // Find the fewest bits per key that reach the false positive rate
+  double low = 1.0, high = kBitsPerBlock;
+  for (uint32_t i = 0; i < 32; i++) {
+    double mid = (low + high) / 2;
+    if (EstimateFalsePositiveRate(mid) > kFalsePositiveRate) {
+      low = mid;
+    } else {
+      high = mid;
+    }
   }
-  LOG_INFO("BloomFilter num_bits: %lu bits_per_element: %f num_hash_funcs: %lu",
-           (unsigned long)num_bits_, (double)num_bits_ / estimated_num_tuples,
-           (unsigned long)num_hash_funcs_);
+  double num_bits = std::max<double>(estimated_num_tuples, 1) * high;
 
-  // Allocate memory for the underlying bytes array
-  uint64_t num_bytes = (num_bits_ + 7) / 8;
-  bytes_ = new char[num_bytes];
-  PELOTON_MEMSET(bytes_, 0, num_bytes);
+  // The block index is computed from 32 bits of the hash
+  num_blocks_ = static_cast<uint64_t>(std::ceil(num_bits / kBitsPerBlock));
+  num_blocks_ = std::min<uint64_t>(num_blocks_, 0xFFFFFFFFull);
+  LOG_INFO("BloomFilter num_blocks: %lu bits_per_element: %f",
+           (unsigned long)num_blocks_, high);
+
+  // Allocate memory for the blocks. A block never straddles cache lines.
+  blocks_ = new uint64_t[num_blocks_];
+  PELOTON_MEMSET(blocks_, 0, num_blocks_ * sizeof(uint64_t));
 
   // Initialize Statistics
   num_misses_ = 0;
@@ -69,11 +72,89 @@ void BloomFilter::Init(uint64_t estimated_num_tuples) {
 }
 
 void BloomFilter::Destroy() {
-  // Free memory of underlying bytes array
+  // Free memory of underlying blocks
   LOG_DEBUG("Bloom Filter, num_probes: %lu, misses: %lu, Selectivity: %f",
             (unsigned long)num_probes_, (unsigned long)num_misses_,
             (double)(num_probes_ - num_misses_) / num_probes_);
-  delete[] bytes_;
+  delete[] blocks_;
+}
+
+uint32_t BloomFilter::Filter(const uint64_t *hashes, uint32_t *selection_vector,
+                             uint32_t num_elems) {
+  // Prefetch the blocks of the keys kPrefetchDistance ahead of the ones being
+  // probed, so that their cache misses overlap
+  for (uint32_t i = 0; i < std::min(kPrefetchDistance, num_elems); i++) {
+    __builtin_prefetch(&blocks_[BlockIndex(hashes[i])]);
+  }
+
+  uint32_t i = 0, num_found = 0;
+
+#if defined(__AVX2__)
+  // Probe four keys at a time, computing their blocks and masks in vector
+  // registers and gathering their blocks
+  const __m256i low_bits = _mm256_set1_epi64x(0xFFFFFFFFll);
+  const __m256i num_blocks = _mm256_set1_epi64x(num_blocks_);
+  const __m256i bit_idx_mask = _mm256_set1_epi64x(kBitsPerBlock - 1);
+  const __m256i one = _mm256_set1_epi64x(1);
+  for (; i + 4 <= num_elems; i += 4) {
+    for (uint32_t j = i + kPrefetchDistance;
+         j < std::min(i + kPrefetchDistance + 4, num_elems); j++) {
+      __builtin_prefetch(&blocks_[BlockIndex(hashes[j])]);
+    }
+
+    __m256i hash =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(hashes + i));
+    // _mm256_mul_epu32() multiplies the low 32 bits of every lane
+    __m256i block_idx = _mm256_srli_epi64(
+        _mm256_mul_epu32(_mm256_and_si256(hash, low_bits), num_blocks), 32);
+    __m256i mask = _mm256_setzero_si256();
+    for (uint32_t k = 0; k < kNumHashFuncs; k++) {
+      __m256i bit_idx = _mm256_and_si256(_mm256_srli_epi64(hash, 32 + 6 * k),
+                                         bit_idx_mask);
+      mask = _mm256_or_si256(mask, _mm256_sllv_epi64(one, bit_idx));
+    }
+    __m256i block = _mm256_i64gather_epi64(
+        reinterpret_cast<const long long *>(blocks_), block_idx, 8);
+    __m256i found = _mm256_cmpeq_epi64(_mm256_and_si256(block, mask), mask);
+    uint32_t found_bits = static_cast<uint32_t>(
+        _mm256_movemask_pd(_mm256_castsi256_pd(found)));
+
+    // Compact the selection vector without branching
+    for (uint32_t k = 0; k < 4; k++) {
+      selection_vector[num_found] = selection_vector[i + k];
+      num_found += (found_bits >> k) & 1;
+    }
+  }
+#endif
+
+  for (; i < num_elems; i++) {
+    if (i + kPrefetchDistance < num_elems) {
+      __builtin_prefetch(&blocks_[BlockIndex(hashes[i + kPrefetchDistance])]);
+    }
+    selection_vector[num_found] = selection_vector[i];
+    num_found += Contains(hashes[i]);
+  }
+
+  num_probes_ += num_elems;
+  num_misses_ += num_elems - num_found;
+  return num_found;
+}
+
+double BloomFilter::EstimateFalsePositiveRate(double bits_per_key) {
+  // The number of keys in a block follows a Poisson distribution. A probe
+  // hits a block with i keys with the probability of the i-th Poisson term,
+  // and is then a false positive if all its bits are among the set ones.
+  double keys_per_block = kBitsPerBlock / bits_per_key;
+  double max_keys = keys_per_block + 10 * std::sqrt(keys_per_block) + 10;
+  double prob_keys = std::exp(-keys_per_block);
+  double rate = 0.0;
+  for (uint32_t i = 0; i <= max_keys; i++) {
+    double bit_unset = std::pow(1.0 - 1.0 / kBitsPerBlock,
+                                static_cast<double>(kNumHashFuncs * i));
+    rate += prob_keys * std::pow(1.0 - bit_unset, kNumHashFuncs);
+    prob_keys *= keys_per_block / (i + 1);
+  }
+  return rate;
 }
 
 }  // namespace util
@@ -12,7 +12,15 @@
 
 #include "codegen/util/hash_table.h"
 
+#include <algorithm>
+#include <limits>
+#include <memory>
+
+#include "codegen/util/spill_file.h"
+#include "common/logger.h"
 #include "common/platform.h"
+#include "common/synchronization/count_down_latch.h"
+#include "threadpool/mono_queue_pool.h"
 #include "type/abstract_pool.h"
 
 namespace peloton {
@@ -25,6 +33,86 @@ static const uint32_t kNumBlockElems = 1024;
 static_assert((kDefaultNumElements & (kDefaultNumElements - 1)) == 0,
               "Default number of elements must be a power of two");
 
+// The size that a partition and its directory should fit in (the L2 cache)
+static const uint64_t kPartitionSize = 256 * 1024;
+
+// The size of the software write-combining buffer of every partition. Entries
+// are copied into a partition once its buffer fills up, so that the writes to
+// each partition go to full cache lines.
+static const uint32_t kWriteCombineSize = 128;
+
+const uint32_t HashTable::kAutoPartitionBits;
+
+const uint32_t HashTable::kMaxPartitionBits;
+
+const uint32_t HashTable::kMaxSpillPartitionBits;
+
+// Spilled runs are partitioned on the most bits a table is partitioned on
+static const uint32_t kSpillPartitionBits = HashTable::kMaxPartitionBits;
+
+// Marks that no spilled partition is loaded
+static const uint32_t kNoPartition = std::numeric_limits<uint32_t>::max();
+
+// Lazily inserted entries reserve memory from the budget in chunks of this
+// size, so that the tables sharing it don't all contend on every insert
+static const uint64_t kMemoryReservationSize = 32 * 1024;
+
+// A run is spilled through a write-combining buffer per partition. Together,
+// the buffers take up about this fraction of the memory of the entries, but
+// each at least kWriteCombineSize and at most kMaxSpillBufferSize bytes.
+static const uint64_t kSpillBufferFraction = 8;
+static const uint64_t kMaxSpillBufferSize = 64 * 1024;
+
+namespace {
+
+// A run of entries in a spill file, partitioned on kSpillPartitionBits bits,
+// or more once the runs were repartitioned
+struct SpilledRun {
+  SpillFile *file;
+  uint64_t offset;
+  // The position of the first entry of each partition in the run, followed by
+  // the number of entries in the run
+  std::vector<uint64_t> partition_offsets;
+};
+
+// Run the given function for each of the tables, in parallel if requested
+void ForEachTable(uint32_t num_tables, bool parallel,
+                  const std::function<void(uint32_t)> &func) {
+  if (!parallel) {
+    for (uint32_t i = 0; i < num_tables; i++) {
+      func(i);
+    }
+    return;
+  }
+  auto &work_pool = threadpool::MonoQueuePool::GetExecutionInstance();
+  common::synchronization::CountDownLatch latch(num_tables);
+  for (uint32_t i = 0; i < num_tables; i++) {
+    work_pool.SubmitTask([&func, &latch, i]() {
+      func(i);
+      latch.CountDown();
+    });
+  }
+  latch.Await(0);
+}
+
+}  // namespace
+
+struct HashTable::SpillState {
+  // The spill files, the first of which is the one this table writes to. The
+  // others were taken over from the thread-local tables of a parallel build.
+  std::vector<std::unique_ptr<SpillFile>> files;
+
+  // All runs spilled to the files, and the number of entries in them
+  std::vector<SpilledRun> runs;
+  uint64_t num_elems = 0;
+
+  // The number of hash bits the runs are partitioned on
+  uint32_t partition_bits = kSpillPartitionBits;
+
+  // The partition whose entries are in memory
+  uint32_t loaded_partition = kNoPartition;
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// EntryBuffer
@@ -33,16 +121,8 @@ static_assert((kDefaultNumElements & (kDefaultNumElements - 1)) == 0,
 
 HashTable::EntryBuffer::EntryBuffer(::peloton::type::AbstractPool &memory,
                                     uint32_t entry_size)
-    : memory_(memory), entry_size_(entry_size) {
-  // We also need to allocate some space to store tuples. Tuples are stored
-  // externally from the main hash table in a separate values memory space.
-  uint64_t block_size = sizeof(MemoryBlock) + (entry_size_ * kNumBlockElems);
-  block_ = reinterpret_cast<MemoryBlock *>(memory_.Allocate(block_size));
-  block_->next = nullptr;
-
-  // Set the next tuple write position and the available bytes
-  next_entry_ = block_->data;
-  available_bytes_ = block_size - sizeof(MemoryBlock);
+    : memory_(memory), entry_size_(entry_size), block_(nullptr) {
+  Reset();
 }
 
 HashTable::EntryBuffer::~EntryBuffer() {
@@ -56,6 +136,26 @@ HashTable::EntryBuffer::~EntryBuffer() {
   block_ = nullptr;
 }
 
+void HashTable::EntryBuffer::Reset() {
+  // Free all the blocks we've allocated
+  MemoryBlock *block = block_;
+  while (block != nullptr) {
+    MemoryBlock *next = block->next;
+    memory_.Free(block);
+    block = next;
+  }
+
+  // We also need to allocate some space to store tuples. Tuples are stored
+  // externally from the main hash table in a separate values memory space.
+  uint64_t block_size = sizeof(MemoryBlock) + (entry_size_ * kNumBlockElems);
+  block_ = reinterpret_cast<MemoryBlock *>(memory_.Allocate(block_size));
+  block_->next = nullptr;
+
+  // Set the next tuple write position and the available bytes
+  next_entry_ = block_->data;
+  available_bytes_ = block_size - sizeof(MemoryBlock);
+}
+
 HashTable::Entry *HashTable::EntryBuffer::NextFree() {
   if (entry_size_ > available_bytes_) {
     uint64_t block_size = sizeof(MemoryBlock) + (entry_size_ * kNumBlockElems);
@@ -114,7 +214,13 @@ HashTable::HashTable(::peloton::type::AbstractPool &memory, uint32_t key_size,
       directory_mask_(0),
       entry_buffer_(memory, Entry::Size(key_size, value_size)),
       num_elems_(0),
-      capacity_(kDefaultNumElements) {
+      capacity_(kDefaultNumElements),
+      partitioned_entries_(nullptr),
+      partition_offsets_(nullptr),
+      num_partition_bits_(0),
+      memory_budget_(nullptr),
+      memory_reserved_(0),
+      partition_base_(0) {
   // Upon creation, we allocate room for kDefaultNumElements in the hash table.
   // We assume 50% load factor on the directory, thus the directory size is
   // twice the number of elements.
@@ -133,6 +239,18 @@ HashTable::~HashTable() {
     memory_.Free(directory_);
     directory_ = nullptr;
   }
+
+  // Free the partitions
+  if (partitioned_entries_ != nullptr) {
+    memory_.Free(partitioned_entries_);
+    partitioned_entries_ = nullptr;
+  }
+  if (partition_offsets_ != nullptr) {
+    memory_.Free(partition_offsets_);
+    partition_offsets_ = nullptr;
+  }
+
+  ReleaseMemory();
 }
 
 void HashTable::Init(HashTable &table, executor::ExecutorContext &exec_ctx,
@@ -143,6 +261,12 @@ void HashTable::Init(HashTable &table, executor::ExecutorContext &exec_ctx,
 void HashTable::Destroy(HashTable &table) { table.~HashTable(); }
 
 char *HashTable::InsertLazy(uint64_t hash) {
+  // Make room for the entry in the budget, writing the entries out to disk
+  // rather than exceed it
+  if (NeedsReservation()) {
+    ReserveMemory();
+  }
+
   // Since this is a lazy insertion, we just need to acquire/allocate an entry
   // from storage. It is assumed that actual construction of the hash table is
   // done by a subsequent call to BuildLazy() only after ALL lazy insertions
@@ -279,6 +403,568 @@ void HashTable::MergeLazyUnfinished(HashTable &other) {
   other.entry_buffer_.TransferMemoryBlocks(entry_buffer_);
 }
 
+void HashTable::PartitionLazy(uint32_t num_partition_bits) {
+  PartitionTables({this}, num_partition_bits, false);
+}
+
+void HashTable::PartitionLazyParallel(
+    const executor::ExecutorContext::ThreadStates &thread_states,
+    uint32_t hash_table_offset, uint32_t num_partition_bits) {
+  std::vector<HashTable *> tables;
+  thread_states.ForEach<HashTable>(hash_table_offset,
+                                   [&tables](HashTable *table) {
+                                     tables.push_back(table);
+                                   });
+  PartitionTables(tables, num_partition_bits, true);
+}
+
+void HashTable::BuildPartition(uint32_t partition) {
+  PELOTON_ASSERT(partition < NumPartitions());
+  LoadPartition(partition);
+
+  // The directory was allocated for the largest partition. Use the part of it
+  // that gives this partition a 50% load factor.
+  uint64_t num_entries =
+      partition_offsets_[partition + 1] - partition_offsets_[partition];
+  uint64_t dir_size =
+      NextPowerOf2(std::max<uint64_t>(num_entries, kDefaultNumElements)) * 2;
+  PELOTON_ASSERT(dir_size <= directory_size_);
+  directory_mask_ = dir_size - 1;
+  PELOTON_MEMSET(directory_, 0, sizeof(Entry *) * dir_size);
+
+  uint32_t entry_size = EntrySize();
+  for (char *pos = PartitionBegin(partition), *end = PartitionEnd(partition);
+       pos != end; pos += entry_size) {
+    auto *entry = reinterpret_cast<Entry *>(pos);
+    uint64_t index = entry->hash & directory_mask_;
+    entry->next = directory_[index];
+    directory_[index] = entry;
+  }
+}
+
+void HashTable::LoadPartition(uint32_t partition) {
+  PELOTON_ASSERT(partition < NumPartitions());
+  if (spill_ == nullptr || spill_->loaded_partition == partition) {
+    return;
+  }
+
+  // The partition is made up of a range of the partitions of the runs. Read
+  // them one after the other.
+  uint32_t shift = spill_->partition_bits - num_partition_bits_;
+  uint64_t first = static_cast<uint64_t>(partition) << shift;
+  uint64_t last = static_cast<uint64_t>(partition + 1) << shift;
+  uint32_t entry_size = EntrySize();
+  char *pos = partitioned_entries_;
+  for (const auto &run : spill_->runs) {
+    uint64_t begin = run.partition_offsets[first];
+    uint64_t len = (run.partition_offsets[last] - begin) * entry_size;
+    run.file->Read(run.offset + begin * entry_size, pos, len);
+    pos += len;
+  }
+  PELOTON_ASSERT(pos == partitioned_entries_ +
+                            (partition_offsets_[partition + 1] -
+                             partition_offsets_[partition]) *
+                                entry_size);
+  partition_base_ = partition_offsets_[partition];
+  spill_->loaded_partition = partition;
+
+  // Have the kernel read the next partition while we process this one
+  if (partition + 1 < NumPartitions()) {
+    uint64_t next_last = static_cast<uint64_t>(partition + 2) << shift;
+    for (const auto &run : spill_->runs) {
+      uint64_t begin = run.partition_offsets[last];
+      run.file->Prefetch(
+          run.offset + begin * entry_size,
+          (run.partition_offsets[next_last] - begin) * entry_size);
+    }
+  }
+}
+
+char *HashTable::PartitionBegin(uint32_t partition) const {
+  return partitioned_entries_ +
+         (partition_offsets_[partition] - partition_base_) * EntrySize();
+}
+
+char *HashTable::PartitionEnd(uint32_t partition) const {
+  return partitioned_entries_ +
+         (partition_offsets_[partition + 1] - partition_base_) * EntrySize();
+}
+
+uint32_t HashTable::ChoosePartitionBits(uint64_t num_elems,
+                                        uint32_t entry_size) {
+  // Every entry also takes two slots in the directory
+  uint64_t total_size = num_elems * (entry_size + 2 * sizeof(Entry *));
+  uint32_t num_partition_bits = 0;
+  while ((total_size >> num_partition_bits) > kPartitionSize &&
+         num_partition_bits < kMaxPartitionBits) {
+    num_partition_bits++;
+  }
+  return num_partition_bits;
+}
+
+void HashTable::EnableSpilling(executor::ExecutorContext &exec_ctx) {
+  SetMemoryBudget(&exec_ctx.GetMemoryBudget());
+}
+
+uint64_t HashTable::NumSpilledRuns() const {
+  return spill_ != nullptr ? spill_->runs.size() : 0;
+}
+
+void HashTable::PartitionTables(const std::vector<HashTable *> &tables,
+                                uint32_t num_partition_bits, bool parallel) {
+  PELOTON_ASSERT(partitioned_entries_ == nullptr);
+  uint32_t entry_size = EntrySize();
+
+  // Leave the partitions on disk if any of the tables spilled
+  bool spilled = std::any_of(tables.begin(), tables.end(),
+                             [](const HashTable *table) {
+                               return table->spill_ != nullptr;
+                             });
+  if (spilled) {
+    PartitionSpilledTables(tables, num_partition_bits, parallel);
+    return;
+  }
+
+  uint64_t total_size = 0;
+  for (const auto *table : tables) {
+    PELOTON_ASSERT(table->EntrySize() == entry_size);
+    total_size += table->NumElements();
+  }
+  if (num_partition_bits == kAutoPartitionBits) {
+    num_partition_bits = ChoosePartitionBits(total_size, entry_size);
+  }
+  uint64_t num_partitions = 1ull << num_partition_bits;
+
+  ////////////////////////////////////////////////////////////////////
+  /// Step 1 - Build the histogram of each table
+  ////////////////////////////////////////////////////////////////////
+  std::vector<std::vector<uint64_t>> counts(tables.size());
+  ForEachTable(tables.size(), parallel, [&tables, &counts, num_partitions,
+                                         num_partition_bits](uint32_t i) {
+    counts[i].resize(num_partitions, 0);
+    tables[i]->CountPartitions(num_partition_bits, counts[i].data());
+  });
+
+  ////////////////////////////////////////////////////////////////////
+  /// Step 2 - Compute where each table writes into each partition
+  ////////////////////////////////////////////////////////////////////
+  uint64_t alloc_size = sizeof(uint64_t) * (num_partitions + 1);
+  partition_offsets_ = static_cast<uint64_t *>(memory_.Allocate(alloc_size));
+
+  std::vector<std::vector<uint64_t>> write_pos(
+      tables.size(), std::vector<uint64_t>(num_partitions));
+  uint64_t pos = 0, max_partition_size = 0;
+  for (uint64_t part = 0; part < num_partitions; part++) {
+    partition_offsets_[part] = pos;
+    for (uint32_t i = 0; i < tables.size(); i++) {
+      write_pos[i][part] = pos;
+      pos += counts[i][part];
+    }
+    max_partition_size =
+        std::max(max_partition_size, pos - partition_offsets_[part]);
+  }
+  partition_offsets_[num_partitions] = pos;
+  PELOTON_ASSERT(pos == total_size);
+
+  ////////////////////////////////////////////////////////////////////
+  /// Step 3 - Copy the entries of each table into their partitions
+  ////////////////////////////////////////////////////////////////////
+  partitioned_entries_ = static_cast<char *>(
+      memory_.Allocate(std::max<uint64_t>(total_size, 1) * entry_size));
+  ForEachTable(tables.size(), parallel, [this, &tables, &write_pos,
+                                         num_partition_bits](uint32_t i) {
+    tables[i]->ScatterPartitions(num_partition_bits, partitioned_entries_,
+                                 write_pos[i].data());
+  });
+
+  FinishPartitioning(total_size, max_partition_size, num_partition_bits);
+}
+
+void HashTable::PartitionSpilledTables(const std::vector<HashTable *> &tables,
+                                       uint32_t num_partition_bits,
+                                       bool parallel) {
+  // Every table writes the entries it still has in memory out as its last run
+  ForEachTable(tables.size(), parallel, [&tables](uint32_t i) {
+    if (tables[i]->NumElementsInMemory() > 0) {
+      tables[i]->SpillLazy();
+    }
+  });
+
+  // Take over the runs of the other tables, and the files they are in
+  if (spill_ == nullptr) {
+    spill_.reset(new SpillState());
+  }
+  for (auto *table : tables) {
+    if (table == this || table->spill_ == nullptr) {
+      continue;
+    }
+    auto &other = *table->spill_;
+    for (auto &run : other.runs) {
+      spill_->runs.push_back(std::move(run));
+    }
+    for (auto &file : other.files) {
+      spill_->files.push_back(std::move(file));
+    }
+    spill_->num_elems += other.num_elems;
+    table->spill_.reset();
+    table->num_elems_ = 0;
+  }
+
+  uint64_t total_size = spill_->num_elems;
+  bool choose_bits = num_partition_bits == kAutoPartitionBits;
+  if (choose_bits) {
+    num_partition_bits = ChoosePartitionBits(total_size, EntrySize());
+  }
+  PELOTON_ASSERT(num_partition_bits <= kMaxSpillPartitionBits);
+  if (num_partition_bits > spill_->partition_bits) {
+    RepartitionSpilledRuns(num_partition_bits);
+  }
+
+  // A partition is loaded whole, along with its directory. Partition on more
+  // bits until the largest one fits in the budget, repartitioning the runs
+  // once on all the bits we may need.
+  uint32_t entry_size = EntrySize();
+  auto partition_memory = [entry_size](uint64_t num_entries) {
+    uint64_t dir_size =
+        NextPowerOf2(std::max<uint64_t>(num_entries, kDefaultNumElements)) * 2;
+    return num_entries * entry_size + dir_size * sizeof(Entry *);
+  };
+  uint64_t budget =
+      memory_budget_ != nullptr ? memory_budget_->GetLimit() : 0;
+  uint64_t max_partition_size = MaxSpilledPartitionSize(num_partition_bits);
+  while (choose_bits && budget != 0 &&
+         partition_memory(max_partition_size) > budget &&
+         num_partition_bits < kMaxSpillPartitionBits) {
+    num_partition_bits++;
+    if (num_partition_bits > spill_->partition_bits) {
+      RepartitionSpilledRuns(kMaxSpillPartitionBits);
+    }
+    max_partition_size = MaxSpilledPartitionSize(num_partition_bits);
+  }
+  if (budget != 0 && partition_memory(max_partition_size) > budget) {
+    LOG_WARN(
+        "The largest partition of a spilled hash table takes %.2lf KB, more "
+        "than the memory budget of %.2lf KB",
+        partition_memory(max_partition_size) / 1024.0, budget / 1024.0);
+  }
+  uint64_t num_partitions = 1ull << num_partition_bits;
+  uint32_t shift = spill_->partition_bits - num_partition_bits;
+
+  // Each partition is a range of the partitions of the runs
+  uint64_t alloc_size = sizeof(uint64_t) * (num_partitions + 1);
+  partition_offsets_ = static_cast<uint64_t *>(memory_.Allocate(alloc_size));
+  uint64_t pos = 0;
+  for (uint64_t part = 0; part < num_partitions; part++) {
+    partition_offsets_[part] = pos;
+    for (const auto &run : spill_->runs) {
+      pos += run.partition_offsets[(part + 1) << shift] -
+             run.partition_offsets[part << shift];
+    }
+  }
+  partition_offsets_[num_partitions] = pos;
+  PELOTON_ASSERT(pos == total_size);
+
+  // Only the largest partition has to fit in memory
+  partitioned_entries_ = static_cast<char *>(memory_.Allocate(
+      std::max<uint64_t>(max_partition_size, 1) * entry_size));
+  spill_->loaded_partition = kNoPartition;
+
+  LOG_DEBUG("Partitioned %lu spilled entries from %zu runs",
+            (unsigned long)total_size, spill_->runs.size());
+
+  FinishPartitioning(total_size, max_partition_size, num_partition_bits);
+}
+
+uint64_t HashTable::MaxSpilledPartitionSize(
+    uint32_t num_partition_bits) const {
+  PELOTON_ASSERT(num_partition_bits <= spill_->partition_bits);
+  uint32_t shift = spill_->partition_bits - num_partition_bits;
+  uint64_t max_partition_size = 0;
+  for (uint64_t part = 0; part < (1ull << num_partition_bits); part++) {
+    uint64_t partition_size = 0;
+    for (const auto &run : spill_->runs) {
+      partition_size += run.partition_offsets[(part + 1) << shift] -
+                        run.partition_offsets[part << shift];
+    }
+    max_partition_size = std::max(max_partition_size, partition_size);
+  }
+  return max_partition_size;
+}
+
+void HashTable::RepartitionSpilledRuns(uint32_t num_partition_bits) {
+  PELOTON_ASSERT(num_partition_bits > spill_->partition_bits &&
+                 !spill_->files.empty());
+  uint32_t extra_bits = num_partition_bits - spill_->partition_bits;
+  uint64_t num_old_partitions = 1ull << spill_->partition_bits;
+  uint64_t num_sub_partitions = 1ull << extra_bits;
+  uint32_t entry_size = EntrySize();
+
+  // Every partition of the runs is split into the partitions on more bits
+  // that it is made of, which are written one after the other into the new
+  // run. The entries are read in chunks, and written through a write-combining
+  // buffer per sub-partition.
+  SpilledRun new_run;
+  new_run.file = spill_->files.front().get();
+  new_run.offset = new_run.file->Allocate(spill_->num_elems * entry_size);
+  new_run.partition_offsets.resize((1ull << num_partition_bits) + 1);
+
+  auto chunk_entries =
+      std::max<uint64_t>(1, kMaxSpillBufferSize / entry_size);
+  uint64_t buffer_size =
+      std::max<uint64_t>(kMaxSpillBufferSize / num_sub_partitions,
+                         kWriteCombineSize);
+  auto buffer_entries =
+      static_cast<uint32_t>(std::max<uint64_t>(1, buffer_size / entry_size));
+  uint64_t scratch_size =
+      (chunk_entries + num_sub_partitions * buffer_entries) * entry_size;
+  if (memory_budget_ != nullptr) {
+    memory_budget_->Reserve(scratch_size);
+  }
+  std::unique_ptr<char[]> chunk{new char[chunk_entries * entry_size]};
+  std::unique_ptr<char[]> buffers{
+      new char[num_sub_partitions * buffer_entries * entry_size]};
+
+  // Call func on every entry of the given partition of all runs
+  auto for_each_entry = [this, &chunk, chunk_entries, entry_size](
+      uint64_t part, const std::function<void(const Entry *)> &func) {
+    for (const auto &run : spill_->runs) {
+      uint64_t begin = run.partition_offsets[part];
+      uint64_t end = run.partition_offsets[part + 1];
+      while (begin < end) {
+        uint64_t num_entries = std::min(end - begin, chunk_entries);
+        run.file->Read(run.offset + begin * entry_size, chunk.get(),
+                       num_entries * entry_size);
+        for (uint64_t i = 0; i < num_entries; i++) {
+          func(reinterpret_cast<const Entry *>(chunk.get() + i * entry_size));
+        }
+        begin += num_entries;
+      }
+    }
+  };
+
+  SpillFile &file = *new_run.file;
+  uint64_t run_offset = new_run.offset;
+  std::vector<uint64_t> counts(num_sub_partitions);
+  std::vector<uint64_t> write_pos(num_sub_partitions);
+  std::vector<uint32_t> num_buffered(num_sub_partitions);
+  auto flush = [&file, &write_pos, &buffers, run_offset, buffer_entries,
+                entry_size](uint64_t sub, uint32_t num_entries) {
+    file.WriteAt(run_offset + write_pos[sub] * entry_size,
+                 buffers.get() + sub * buffer_entries * entry_size,
+                 num_entries * entry_size);
+    write_pos[sub] += num_entries;
+  };
+  uint64_t pos = 0;
+  for (uint64_t part = 0; part < num_old_partitions; part++) {
+    // Size the sub-partitions first, to know where each one goes
+    std::fill(counts.begin(), counts.end(), 0);
+    for_each_entry(part, [&counts, num_partition_bits,
+                          num_sub_partitions](const Entry *entry) {
+      counts[PartitionOf(entry->hash, num_partition_bits) &
+             (num_sub_partitions - 1)]++;
+    });
+    for (uint64_t sub = 0; sub < num_sub_partitions; sub++) {
+      new_run.partition_offsets[(part << extra_bits) + sub] = write_pos[sub] =
+          pos;
+      pos += counts[sub];
+    }
+
+    std::fill(num_buffered.begin(), num_buffered.end(), 0);
+    for_each_entry(part, [&](const Entry *entry) {
+      uint64_t sub = PartitionOf(entry->hash, num_partition_bits) &
+                     (num_sub_partitions - 1);
+      PELOTON_MEMCPY(buffers.get() +
+                         (sub * buffer_entries + num_buffered[sub]) *
+                             entry_size,
+                     entry, entry_size);
+      if (++num_buffered[sub] == buffer_entries) {
+        flush(sub, buffer_entries);
+        num_buffered[sub] = 0;
+      }
+    });
+    for (uint64_t sub = 0; sub < num_sub_partitions; sub++) {
+      if (num_buffered[sub] > 0) {
+        flush(sub, num_buffered[sub]);
+      }
+    }
+  }
+  new_run.partition_offsets[1ull << num_partition_bits] = pos;
+  PELOTON_ASSERT(pos == spill_->num_elems);
+
+  if (memory_budget_ != nullptr) {
+    memory_budget_->Release(scratch_size);
+  }
+
+  LOG_DEBUG("Repartitioned %lu spilled entries from %zu runs on %u bits",
+            (unsigned long)pos, spill_->runs.size(), num_partition_bits);
+
+  // The old runs are left in the files, which are deleted with the table
+  spill_->runs.clear();
+  spill_->runs.push_back(std::move(new_run));
+  spill_->partition_bits = num_partition_bits;
+}
+
+void HashTable::FinishPartitioning(uint64_t num_elems,
+                                   uint64_t max_partition_size,
+                                   uint32_t num_partition_bits) {
+  // Allocate a directory that can hold the largest partition. The entries
+  // inserted into the old one are now all in the partitions.
+  memory_.Free(directory_);
+  uint64_t max_size =
+      std::max<uint64_t>(max_partition_size, kDefaultNumElements);
+  directory_size_ = NextPowerOf2(max_size) * 2;
+  directory_mask_ = directory_size_ - 1;
+  uint64_t alloc_size = sizeof(Entry *) * directory_size_;
+  directory_ = static_cast<Entry **>(memory_.Allocate(alloc_size));
+  PELOTON_MEMSET(directory_, 0, alloc_size);
+
+  num_elems_ = num_elems;
+  capacity_ = directory_size_ / 2;
+  num_partition_bits_ = num_partition_bits;
+  partition_base_ = 0;
+}
+
+uint64_t HashTable::NumElementsInMemory() const {
+  return num_elems_ - (spill_ != nullptr ? spill_->num_elems : 0);
+}
+
+template <typename FlushFunc>
+void HashTable::WriteCombinePartitions(uint32_t num_partition_bits,
+                                       uint32_t buffer_entries,
+                                       FlushFunc flush) const {
+  uint32_t entry_size = EntrySize();
+  uint64_t buffer_size = static_cast<uint64_t>(buffer_entries) * entry_size;
+  uint64_t num_partitions = 1ull << num_partition_bits;
+
+  std::unique_ptr<char[]> buffers{new char[num_partitions * buffer_size]};
+  std::vector<uint32_t> num_buffered(num_partitions, 0);
+
+  for (Entry *entry = directory_[0]; entry != nullptr; entry = entry->next) {
+    uint64_t part = PartitionOf(entry->hash, num_partition_bits);
+    char *buffer = buffers.get() + part * buffer_size;
+    PELOTON_MEMCPY(buffer + num_buffered[part] * entry_size, entry,
+                   entry_size);
+    if (++num_buffered[part] == buffer_entries) {
+      flush(part, buffer, buffer_entries);
+      num_buffered[part] = 0;
+    }
+  }
+
+  // Flush what is left in the buffers
+  for (uint64_t part = 0; part < num_partitions; part++) {
+    if (num_buffered[part] > 0) {
+      flush(part, buffers.get() + part * buffer_size, num_buffered[part]);
+    }
+  }
+}
+
+void HashTable::ReserveMemory() {
+  uint64_t bytes = std::max<uint64_t>(kMemoryReservationSize, EntrySize());
+  if (memory_budget_->TryReserve(bytes)) {
+    memory_reserved_ += bytes;
+    return;
+  }
+
+  // Spilling gives the memory of the entries back. The other tables of the
+  // query may still hold the rest of the budget, so take what we need anyway.
+  if (NumElementsInMemory() > 0) {
+    SpillLazy();
+  }
+  memory_budget_->Reserve(bytes);
+  memory_reserved_ += bytes;
+}
+
+void HashTable::ReleaseMemory() {
+  if (memory_reserved_ > 0) {
+    memory_budget_->Release(memory_reserved_);
+    memory_reserved_ = 0;
+  }
+}
+
+void HashTable::SpillLazy() {
+  if (spill_ == nullptr) {
+    spill_.reset(new SpillState());
+    spill_->files.emplace_back(new SpillFile());
+  }
+
+  // Partition the entries in memory, as when partitioning the table
+  uint64_t num_partitions = 1ull << kSpillPartitionBits;
+  std::vector<uint64_t> counts(num_partitions, 0);
+  CountPartitions(kSpillPartitionBits, counts.data());
+
+  SpilledRun run;
+  run.file = spill_->files.front().get();
+  run.partition_offsets.resize(num_partitions + 1);
+  std::vector<uint64_t> write_pos(num_partitions);
+  uint64_t pos = 0;
+  for (uint64_t part = 0; part < num_partitions; part++) {
+    run.partition_offsets[part] = write_pos[part] = pos;
+    pos += counts[part];
+  }
+  run.partition_offsets[num_partitions] = pos;
+  PELOTON_ASSERT(pos == NumElementsInMemory());
+
+  // Make room for the run at the end of the file, and stream each partition
+  // into its place in it through the write-combining buffers
+  uint32_t entry_size = EntrySize();
+  run.offset = run.file->Allocate(pos * entry_size);
+  uint64_t buffer_size = pos * entry_size / kSpillBufferFraction /
+                         num_partitions;
+  buffer_size = std::min(std::max<uint64_t>(buffer_size, kWriteCombineSize),
+                         kMaxSpillBufferSize);
+  auto buffer_entries =
+      static_cast<uint32_t>(std::max<uint64_t>(1, buffer_size / entry_size));
+  uint64_t buffers_size = num_partitions * buffer_entries * entry_size;
+  if (memory_budget_ != nullptr) {
+    memory_budget_->Reserve(buffers_size);
+  }
+  SpillFile &file = *run.file;
+  uint64_t run_offset = run.offset;
+  WriteCombinePartitions(
+      kSpillPartitionBits, buffer_entries,
+      [&file, &write_pos, run_offset, entry_size](
+          uint64_t part, const char *buffer, uint32_t num_entries) {
+        file.WriteAt(run_offset + write_pos[part] * entry_size, buffer,
+                     num_entries * entry_size);
+        write_pos[part] += num_entries;
+      });
+  if (memory_budget_ != nullptr) {
+    memory_budget_->Release(buffers_size);
+  }
+
+  LOG_DEBUG("Spilled run of %lu hash table entries (%.2lf KB)",
+            (unsigned long)pos, pos * entry_size / 1024.0);
+
+  spill_->runs.push_back(std::move(run));
+  spill_->num_elems += pos;
+
+  // Free the entries, starting over with an empty list
+  entry_buffer_.Reset();
+  directory_[0] = directory_[1] = nullptr;
+  ReleaseMemory();
+}
+
+void HashTable::CountPartitions(uint32_t num_partition_bits,
+                                uint64_t *counts) const {
+  for (Entry *entry = directory_[0]; entry != nullptr; entry = entry->next) {
+    counts[PartitionOf(entry->hash, num_partition_bits)]++;
+  }
+}
+
+void HashTable::ScatterPartitions(uint32_t num_partition_bits, char *entries,
+                                  uint64_t *write_pos) const {
+  uint32_t entry_size = EntrySize();
+  uint32_t buffer_entries = std::max(1u, kWriteCombineSize / entry_size);
+  WriteCombinePartitions(
+      num_partition_bits, buffer_entries,
+      [entries, write_pos, entry_size](uint64_t part, const char *buffer,
+                                       uint32_t num_entries) {
+        PELOTON_MEMCPY(entries + write_pos[part] * entry_size, buffer,
+                       num_entries * entry_size);
+        write_pos[part] += num_entries;
+      });
+}
+
 void HashTable::Resize() {
   // Sanity check
   PELOTON_ASSERT(NeedsResize());
@@ -0,0 +1,204 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// like_matcher.cpp
+//
+// Identification: src/codegen/util/like_matcher.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/util/like_matcher.h"
+
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "function/string_functions.h"
+
+namespace peloton {
+namespace codegen {
+namespace util {
+
+namespace {
+
+// tolower() in the C locale, which StringFunctions::Like() compares with
+inline char FoldCase(char c) {
+  return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+inline char UpperCase(char c) {
+  return (c >= 'a' && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c;
+}
+
+// Is the string equal to the lower case literal of the same length, ignoring
+// case?
+inline bool EqualsIgnoreCase(const char *str, const char *literal,
+                             uint32_t len) {
+  for (uint32_t i = 0; i < len; i++) {
+    if (FoldCase(str[i]) != literal[i]) return false;
+  }
+  return true;
+}
+
+// The lengths of VARCHARs in compiled code count the terminating NUL, which
+// isn't part of the string
+inline uint32_t StripTerminator(const char *str, uint32_t len) {
+  return (len > 0 && str[len - 1] == '\0') ? len - 1 : len;
+}
+
+}  // namespace
+
+void LikeMatcher::Init(const char *pattern, uint32_t pattern_len) {
+  literal_ = nullptr;
+  literal_len_ = 0;
+  pattern_ = nullptr;
+  pattern_len_ = 0;
+
+  if (pattern == nullptr) {
+    type_ = PatternType::None;
+    return;
+  }
+  pattern_len = StripTerminator(pattern, pattern_len);
+
+  std::string literal;
+  type_ = Analyze(pattern, pattern_len, literal);
+  if (type_ == PatternType::General) {
+    pattern_ = new char[pattern_len];
+    std::memcpy(pattern_, pattern, pattern_len);
+    pattern_len_ = pattern_len;
+  } else {
+    literal_len_ = static_cast<uint32_t>(literal.size());
+    literal_ = new char[literal_len_];
+    std::memcpy(literal_, literal.data(), literal_len_);
+  }
+}
+
+void LikeMatcher::Destroy() {
+  delete[] literal_;
+  delete[] pattern_;
+}
+
+bool LikeMatcher::Matches(executor::ExecutorContext &ctx, const char *str,
+                          uint32_t str_len) const {
+  str_len = StripTerminator(str, str_len);
+  switch (type_) {
+    case PatternType::None:
+      return false;
+    case PatternType::All:
+      return true;
+    case PatternType::Exact:
+      return str_len == literal_len_ &&
+             EqualsIgnoreCase(str, literal_, literal_len_);
+    case PatternType::Prefix:
+      return str_len >= literal_len_ &&
+             EqualsIgnoreCase(str, literal_, literal_len_);
+    case PatternType::Suffix:
+      return str_len >= literal_len_ &&
+             EqualsIgnoreCase(str + str_len - literal_len_, literal_,
+                              literal_len_);
+    case PatternType::Contains:
+      return ContainsIgnoreCase(str, str_len, literal_, literal_len_);
+    case PatternType::General:
+    default:
+      return function::StringFunctions::Like(ctx, str, str_len, pattern_,
+                                             pattern_len_);
+  }
+}
+
+LikeMatcher::PatternType LikeMatcher::Analyze(const char *pattern,
+                                              uint32_t pattern_len,
+                                              std::string &literal) {
+  literal.clear();
+  bool leading_any = false, trailing_any = false;
+  for (uint32_t i = 0; i < pattern_len;) {
+    char c = pattern[i];
+    if (c == '%') {
+      if (literal.empty()) {
+        leading_any = true;
+      } else {
+        trailing_any = true;
+      }
+      i++;
+      continue;
+    }
+    if (c == '_') {
+      return PatternType::General;
+    }
+    if (c == '\\') {
+      // A trailing escape character never matches
+      if (i + 1 == pattern_len) return PatternType::General;
+      c = pattern[i + 1];
+      i += 2;
+    } else {
+      i++;
+    }
+    // A literal after a '%' that follows another literal
+    if (trailing_any) return PatternType::General;
+    literal.push_back(FoldCase(c));
+  }
+
+  if (literal.empty()) {
+    // '' only matches the empty string
+    return leading_any ? PatternType::All : PatternType::Exact;
+  }
+  if (leading_any) {
+    return trailing_any ? PatternType::Contains : PatternType::Suffix;
+  }
+  return trailing_any ? PatternType::Prefix : PatternType::Exact;
+}
+
+bool LikeMatcher::ContainsIgnoreCase(const char *str, uint32_t str_len,
+                                     const char *literal,
+                                     uint32_t literal_len) {
+  if (literal_len > str_len) return false;
+  if (literal_len == 0) return true;
+
+  // The last position the literal can start at
+  uint32_t last_start = str_len - literal_len;
+  uint32_t start = 0;
+
+#if defined(__SSE2__)
+  // Find the positions in blocks of 16 where both the first and the last
+  // character of the literal match, in either case, and only compare the
+  // literal at those
+  char first = literal[0], last = literal[literal_len - 1];
+  const __m128i first_lower = _mm_set1_epi8(first);
+  const __m128i first_upper = _mm_set1_epi8(UpperCase(first));
+  const __m128i last_lower = _mm_set1_epi8(last);
+  const __m128i last_upper = _mm_set1_epi8(UpperCase(last));
+  for (; start + 16 <= last_start + 1; start += 16) {
+    __m128i block_first =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(str + start));
+    __m128i block_last = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(str + start + literal_len - 1));
+    __m128i eq_first = _mm_or_si128(_mm_cmpeq_epi8(block_first, first_lower),
+                                    _mm_cmpeq_epi8(block_first, first_upper));
+    __m128i eq_last = _mm_or_si128(_mm_cmpeq_epi8(block_last, last_lower),
+                                   _mm_cmpeq_epi8(block_last, last_upper));
+    uint32_t mask = static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_and_si128(eq_first, eq_last)));
+    while (mask != 0) {
+      uint32_t pos = start + __builtin_ctz(mask);
+      if (literal_len <= 2 ||
+          EqualsIgnoreCase(str + pos + 1, literal + 1, literal_len - 2)) {
+        return true;
+      }
+      mask &= mask - 1;
+    }
+  }
+#endif
+
+  for (; start <= last_start; start++) {
+    if (EqualsIgnoreCase(str + start, literal, literal_len)) return true;
+  }
+  return false;
+}
+
+}  // namespace util
+}  // namespace codegen
+}  // namespace peloton
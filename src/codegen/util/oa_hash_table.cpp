@@ -12,6 +12,8 @@
 
 #include "codegen/util/oa_hash_table.h"
 
+#include <cstring>
+
 #include "common/logger.h"
 #include "common/platform.h"
 
@@ -257,6 +259,38 @@ char *OAHashTable::StoreTuple(HashEntry *entry, uint64_t hash) {
   return StoreToKeyValueList(&entry->kv_list);
 }
 
+//===----------------------------------------------------------------------===//
+// Find the entry of the given key, or the free slot where it would be inserted
+// if it is not in the table. The probe follows the same linear sequence as
+// FindNextFreeEntry(), so it ends at a free slot at the latest.
+//===----------------------------------------------------------------------===//
+OAHashTable::HashEntry *OAHashTable::FindEntry(uint64_t hash,
+                                               const char *key) const {
+  uint64_t index = hash & bucket_mask_;
+
+  uint64_t current_entry_int =
+      reinterpret_cast<uint64_t>(buckets_) + index * entry_size_;
+
+  // Must end at a free entry since we maintain load factor <= 50
+  while (true) {
+    auto *entry = reinterpret_cast<HashEntry *>(current_entry_int);
+
+    if (entry->IsFree() ||
+        (entry->hash == hash && memcmp(entry->data, key, key_size_) == 0)) {
+      return entry;
+    }
+
+    current_entry_int += entry_size_;
+    index++;
+
+    // This implies we should wrap back
+    if (index == num_buckets_) {
+      index = 0;
+      current_entry_int = reinterpret_cast<uint64_t>(buckets_);
+    }
+  }
+}
+
 //===----------------------------------------------------------------------===//
 // Initialize all slots in the given entry to FREE state.
 //
@@ -15,6 +15,7 @@
 #include <algorithm>
 #include <queue>
 
+#include "codegen/util/spill_file.h"
 #include "common/synchronization/count_down_latch.h"
 #include "common/timer.h"
 #include "threadpool/mono_queue_pool.h"
@@ -23,6 +24,74 @@ namespace peloton {
 namespace codegen {
 namespace util {
 
+namespace {
+
+// The size of the writes of spilled runs, of the largest reads of a run during
+// the merge, and of the chunks of merged tuples
+const uint64_t kSpillIOSize = 1024 * 1024;
+
+// The smallest reads of a run, when many runs split the budget between them
+const uint64_t kMinSpillReadSize = 64 * 1024;
+
+// A sorted run of tuples in a spill file
+struct SpilledRun {
+  SpillFile *file;
+  uint64_t offset;
+  uint64_t size;
+};
+
+// The part of a run that was read back into memory during the merge
+struct RunReader {
+  const SpilledRun *run;
+  std::unique_ptr<char[]> buffer;
+  uint64_t buffer_size;
+  char *pos;
+  char *end;
+  uint64_t read_bytes;
+};
+
+// Read the next part of the run, returning false if all of it was read
+bool ReadNext(RunReader &reader) {
+  const auto &run = *reader.run;
+  uint64_t len = std::min(reader.buffer_size, run.size - reader.read_bytes);
+  if (len == 0) {
+    return false;
+  }
+  run.file->Read(run.offset + reader.read_bytes, reader.buffer.get(), len);
+  reader.pos = reader.buffer.get();
+  reader.end = reader.pos + len;
+  reader.read_bytes += len;
+
+  // Have the kernel read the part after this one while we merge this one
+  uint64_t left = run.size - reader.read_bytes;
+  run.file->Prefetch(run.offset + reader.read_bytes,
+                     std::min(reader.buffer_size, left));
+  return true;
+}
+
+}  // namespace
+
+struct Sorter::SpillState {
+  // The spill files, the first of which is the one this sorter writes to. The
+  // others were taken over from the thread-local sorters of a parallel sort.
+  std::vector<std::unique_ptr<SpillFile>> files;
+
+  // All runs spilled to the files
+  std::vector<SpilledRun> runs;
+
+  // The buffer that runs are written out through
+  std::unique_ptr<char[]> write_buffer;
+
+  // The readers of the runs being merged, and a min-heap of the ones that
+  // still have tuples, ordered on their next tuple
+  std::vector<RunReader> readers;
+  std::vector<RunReader *> heap;
+
+  // The merged tuples of the current chunk
+  std::unique_ptr<char[]> chunk;
+  uint64_t chunk_size;
+};
+
 Sorter::Sorter(::peloton::type::AbstractPool &memory, ComparisonFunction func,
                uint32_t tuple_size)
     : memory_(memory),
@@ -32,7 +101,9 @@ Sorter::Sorter(::peloton::type::AbstractPool &memory, ComparisonFunction func,
       buffer_end_(nullptr),
       next_alloc_size_(kInitialBufferSize),
       tuples_start_(nullptr),
-      tuples_end_(nullptr) {
+      tuples_end_(nullptr),
+      memory_budget_(nullptr),
+      memory_reserved_(0) {
   // No memory allocation
   LOG_DEBUG("Initialized Sorter for tuples of size %u bytes", tuple_size_);
 }
@@ -48,6 +119,7 @@ Sorter::~Sorter() {
   buffer_pos_ = buffer_end_ = nullptr;
   tuples_start_ = tuples_end_ = nullptr;
   next_alloc_size_ = 0;
+  ReleaseMemory();
 
   LOG_DEBUG("Cleaned up %zu tuples from %zu blocks of memory (%.2lf KB)",
             tuples_.size(), blocks_.size(), total_alloc / 1024.0);
@@ -56,11 +128,21 @@ Sorter::~Sorter() {
 void Sorter::Init(Sorter &sorter, executor::ExecutorContext &exec_ctx,
                   ComparisonFunction func, uint32_t tuple_size) {
   new (&sorter) Sorter(*exec_ctx.GetPool(), func, tuple_size);
+  sorter.SetMemoryBudget(&exec_ctx.GetMemoryBudget());
 }
 
 void Sorter::Destroy(Sorter &sorter) { sorter.~Sorter(); }
 
 char *Sorter::StoreTuple() {
+  // Make room for the tuple in the budget, writing the tuples out as a sorted
+  // run rather than exceed it
+  if (NeedsReservation()) {
+    ReserveMemory();
+  }
+  return AllocateTuple();
+}
+
+char *Sorter::AllocateTuple() {
   // Make room for a new tuple
   MakeRoomForNewTuple();
 
@@ -76,7 +158,7 @@ char *Sorter::StoreTuple() {
 }
 
 char *Sorter::StoreTupleForTopK(UNUSED_ATTRIBUTE uint64_t top_k) {
-  return StoreTuple();
+  return AllocateTuple();
 }
 
 void Sorter::StoreTupleForTopKFinish(uint64_t top_k) {
@@ -109,6 +191,15 @@ void Sorter::StoreTupleForTopKFinish(uint64_t top_k) {
 }
 
 void Sorter::Sort() {
+  // If we spilled, write what is left out as the last run, and merge the runs
+  if (spill_ != nullptr) {
+    if (!tuples_.empty()) {
+      SpillRun();
+    }
+    StartMerge();
+    return;
+  }
+
   // Short-circuit
   if (tuples_.empty()) {
     return;
@@ -175,6 +266,16 @@ void Sorter::SortParallel(
                                   num_tuples += sorter->NumTuples();
                                 });
 
+  // If any of the sorters spilled, merge the runs of all of them from disk
+  bool spilled = std::any_of(sorters.begin(), sorters.end(),
+                             [](const Sorter *sorter) {
+                               return sorter->spill_ != nullptr;
+                             });
+  if (spilled) {
+    SortSpilledParallel(sorters);
+    return;
+  }
+
   // The worker pool we use to execute parallel work
   auto &work_pool = threadpool::MonoQueuePool::GetExecutionInstance();
 
@@ -357,6 +458,184 @@ void Sorter::SortTopKParallel(
   tuples_end_ = tuples_start_ + tuples_.size();
 }
 
+bool Sorter::NextChunk() {
+  // Tuples sorted in memory are all in the one chunk
+  if (spill_ == nullptr) {
+    return false;
+  }
+
+  auto &heap = spill_->heap;
+  const auto heap_cmp = [this](const RunReader *left, const RunReader *right) {
+    return cmp_func_(left->pos, right->pos) > 0;
+  };
+
+  // Copy the smallest tuple of the runs into the chunk until it fills up. The
+  // tuples are copied since the buffers of the runs are reused.
+  tuples_.clear();
+  char *write_pos = spill_->chunk.get();
+  while (!heap.empty() && tuples_.size() < spill_->chunk_size) {
+    std::pop_heap(heap.begin(), heap.end(), heap_cmp);
+    RunReader *reader = heap.back();
+    PELOTON_MEMCPY(write_pos, reader->pos, tuple_size_);
+    tuples_.push_back(write_pos);
+    write_pos += tuple_size_;
+
+    reader->pos += tuple_size_;
+    if (reader->pos == reader->end && !ReadNext(*reader)) {
+      heap.pop_back();
+    } else {
+      std::push_heap(heap.begin(), heap.end(), heap_cmp);
+    }
+  }
+
+  tuples_start_ = tuples_.data();
+  tuples_end_ = tuples_start_ + tuples_.size();
+  return !tuples_.empty();
+}
+
+uint64_t Sorter::NumSpilledRuns() const {
+  return spill_ != nullptr ? spill_->runs.size() : 0;
+}
+
+bool Sorter::NeedsReservation() const {
+  // Only a new block for the tuple needs memory
+  bool has_room =
+      (buffer_pos_ != nullptr && buffer_pos_ + tuple_size_ < buffer_end_);
+  return memory_budget_ != nullptr && !has_room;
+}
+
+void Sorter::ReserveMemory() {
+  // The block, and the pointers to the tuples in it
+  uint64_t bytes =
+      next_alloc_size_ + next_alloc_size_ / tuple_size_ * sizeof(char *);
+  if (!memory_budget_->TryReserve(bytes)) {
+    // Spilling gives the memory of the tuples back. The other sorters of the
+    // query may still hold the rest of the budget, so take what we need
+    // anyway.
+    if (!tuples_.empty()) {
+      SpillRun();
+    }
+    memory_budget_->Reserve(bytes);
+  }
+  memory_reserved_ += bytes;
+}
+
+void Sorter::ReleaseMemory() {
+  if (memory_reserved_ > 0) {
+    memory_budget_->Release(memory_reserved_);
+    memory_reserved_ = 0;
+  }
+}
+
+void Sorter::SpillRun() {
+  if (spill_ == nullptr) {
+    spill_.reset(new SpillState());
+    spill_->files.emplace_back(new SpillFile());
+    spill_->write_buffer.reset(new char[kSpillIOSize + tuple_size_]);
+  }
+
+  // Sort the tuples, and write them out in order through the write buffer
+  auto cmp =
+      [this](char *left, char *right) { return cmp_func_(left, right) < 0; };
+  std::sort(tuples_.begin(), tuples_.end(), cmp);
+
+  SpillFile &file = *spill_->files.front();
+  char *buffer = spill_->write_buffer.get();
+  uint64_t buffered = 0, offset = file.Size();
+  for (const char *tuple : tuples_) {
+    PELOTON_MEMCPY(buffer + buffered, tuple, tuple_size_);
+    buffered += tuple_size_;
+    if (buffered >= kSpillIOSize) {
+      file.Write(buffer, buffered);
+      buffered = 0;
+    }
+  }
+  file.Write(buffer, buffered);
+  spill_->runs.push_back(
+      SpilledRun{&file, offset, tuples_.size() * tuple_size_});
+
+  LOG_DEBUG("Spilled run of %zu tuples (%.2lf KB)", tuples_.size(),
+            tuples_.size() * tuple_size_ / 1024.0);
+
+  // Free the memory of the tuples
+  for (const auto &iter : blocks_) {
+    memory_.Free(iter.first);
+  }
+  blocks_.clear();
+  tuples_.clear();
+  buffer_pos_ = buffer_end_ = nullptr;
+  ReleaseMemory();
+}
+
+void Sorter::SortSpilledParallel(const std::vector<Sorter *> &sorters) {
+  // Each sorter writes the tuples it has left out as its last run
+  auto &work_pool = threadpool::MonoQueuePool::GetExecutionInstance();
+  common::synchronization::CountDownLatch latch(sorters.size());
+  for (auto *sorter : sorters) {
+    work_pool.SubmitTask([sorter, &latch]() {
+      if (!sorter->tuples_.empty()) {
+        sorter->SpillRun();
+      }
+      latch.CountDown();
+    });
+  }
+  latch.Await(0);
+
+  // Take over the runs, and the files they are in
+  if (spill_ == nullptr) {
+    spill_.reset(new SpillState());
+  }
+  for (auto *sorter : sorters) {
+    if (sorter->spill_ == nullptr) {
+      continue;
+    }
+    auto &other = *sorter->spill_;
+    spill_->runs.insert(spill_->runs.end(), other.runs.begin(),
+                        other.runs.end());
+    for (auto &file : other.files) {
+      spill_->files.push_back(std::move(file));
+    }
+    sorter->spill_.reset();
+  }
+
+  StartMerge();
+}
+
+void Sorter::StartMerge() {
+  auto &runs = spill_->runs;
+
+  // Half of the budget is split between the buffers of the runs
+  uint64_t budget = memory_budget_ != nullptr ? memory_budget_->GetLimit() : 0;
+  uint64_t read_size = budget / 2 / std::max<uint64_t>(1, runs.size());
+  read_size = std::min(std::max(read_size, kMinSpillReadSize), kSpillIOSize);
+  read_size = std::max<uint64_t>(1, read_size / tuple_size_) * tuple_size_;
+
+  auto &readers = spill_->readers;
+  readers.resize(runs.size());
+  for (uint32_t i = 0; i < runs.size(); i++) {
+    readers[i].run = &runs[i];
+    readers[i].buffer.reset(new char[read_size]);
+    readers[i].buffer_size = read_size;
+    readers[i].read_bytes = 0;
+    if (ReadNext(readers[i])) {
+      spill_->heap.push_back(&readers[i]);
+    }
+  }
+  std::make_heap(spill_->heap.begin(), spill_->heap.end(),
+                 [this](const RunReader *left, const RunReader *right) {
+                   return cmp_func_(left->pos, right->pos) > 0;
+                 });
+
+  spill_->chunk_size = std::max<uint64_t>(1, kSpillIOSize / tuple_size_);
+  spill_->chunk.reset(new char[spill_->chunk_size * tuple_size_]);
+  tuples_.reserve(spill_->chunk_size);
+
+  LOG_DEBUG("Merging %zu spilled runs", runs.size());
+
+  // Produce the first chunk
+  NextChunk();
+}
+
 void Sorter::MakeRoomForNewTuple() {
   bool has_room =
       (buffer_pos_ != nullptr && buffer_pos_ + tuple_size_ < buffer_end_);
@@ -376,7 +655,13 @@ void Sorter::MakeRoomForNewTuple() {
   buffer_pos_ = reinterpret_cast<char *>(block);
   buffer_end_ = buffer_pos_ + next_alloc_size_;
 
+  // Don't let a single block take up too much of the budget
   next_alloc_size_ *= 2;
+  if (memory_budget_ != nullptr) {
+    next_alloc_size_ = std::max<uint64_t>(
+        std::min(next_alloc_size_, memory_budget_->GetLimit() / 4),
+        2 * tuple_size_);
+  }
 }
 
 void Sorter::TransferMemoryBlocks(Sorter &target) {
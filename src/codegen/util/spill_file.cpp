@@ -0,0 +1,114 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// spill_file.cpp
+//
+// Identification: src/codegen/util/spill_file.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/util/spill_file.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "settings/settings_manager.h"
+#include "util/string_util.h"
+
+namespace peloton {
+namespace codegen {
+namespace util {
+
+SpillFile::SpillFile() : fd_(-1), size_(0) {
+  auto dir = settings::SettingsManager::GetString(
+      settings::SettingId::spill_directory);
+  std::string path = dir + "/peloton_spill_XXXXXX";
+  std::vector<char> name(path.begin(), path.end());
+  name.push_back('\0');
+
+  fd_ = mkstemp(name.data());
+  if (fd_ == -1) {
+    throw ExecutorException(
+        StringUtil::Format("unable to create spill file in '%s': %s",
+                           dir.c_str(), strerror(errno)));
+  }
+
+  // Nobody else needs to find the file, so it is deleted as soon as we close
+  // it
+  unlink(name.data());
+  LOG_DEBUG("Created spill file %s", name.data());
+}
+
+SpillFile::~SpillFile() {
+  if (fd_ != -1) {
+    close(fd_);
+    fd_ = -1;
+  }
+}
+
+uint64_t SpillFile::Write(const char *data, uint64_t len) {
+  uint64_t offset = Allocate(len);
+  WriteAt(offset, data, len);
+  return offset;
+}
+
+uint64_t SpillFile::Allocate(uint64_t len) {
+  uint64_t offset = size_;
+  size_ += len;
+  return offset;
+}
+
+void SpillFile::WriteAt(uint64_t offset, const char *data, uint64_t len) {
+  PELOTON_ASSERT(offset + len <= size_);
+  while (len > 0) {
+    ssize_t bytes_written = pwrite(fd_, data, len, offset);
+    if (bytes_written == -1) {
+      if (errno == EINTR) continue;
+      throw ExecutorException(StringUtil::Format(
+          "error writing to spill file: %s", strerror(errno)));
+    }
+    data += bytes_written;
+    len -= bytes_written;
+    offset += bytes_written;
+  }
+}
+
+void SpillFile::Read(uint64_t offset, char *data, uint64_t len) const {
+  PELOTON_ASSERT(offset + len <= size_);
+  while (len > 0) {
+    ssize_t bytes_read = pread(fd_, data, len, offset);
+    if (bytes_read == -1 && errno == EINTR) {
+      continue;
+    }
+    if (bytes_read <= 0) {
+      throw ExecutorException(StringUtil::Format(
+          "error reading spill file: %s",
+          bytes_read == 0 ? "unexpected end of file" : strerror(errno)));
+    }
+    data += bytes_read;
+    len -= bytes_read;
+    offset += bytes_read;
+  }
+}
+
+void SpillFile::Prefetch(UNUSED_ATTRIBUTE uint64_t offset,
+                         UNUSED_ATTRIBUTE uint64_t len) const {
+#ifdef POSIX_FADV_WILLNEED
+  // This is only a hint, so errors are ignored
+  if (len > 0) {
+    posix_fadvise(fd_, offset, len, POSIX_FADV_WILLNEED);
+  }
+#endif
+}
+
+}  // namespace util
+}  // namespace codegen
+}  // namespace peloton
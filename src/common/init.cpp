@@ -21,10 +21,12 @@
 #include "concurrency/transaction_manager_factory.h"
 #include "gc/gc_manager_factory.h"
 #include "index/index.h"
+#include "optimizer/stats/cost_model.h"
 #include "settings/settings_manager.h"
 #include "threadpool/mono_queue_pool.h"
 #include "tuning/index_tuner.h"
 #include "tuning/layout_tuner.h"
+#include "tuning/tile_group_freezer.h"
 
 namespace peloton {
 
@@ -76,6 +78,19 @@ void PelotonInit::Initialize() {
     layout_tuner.Start();
   }
 
+  // start tile group freezer
+  if (settings::SettingsManager::GetBool(
+          settings::SettingId::tile_group_freezer)) {
+    auto &tile_group_freezer = tuning::TileGroupFreezer::GetInstance();
+    tile_group_freezer.Start();
+  }
+
+  // Fit the optimizer cost model to this machine
+  if (settings::SettingsManager::GetBool(
+          settings::SettingId::cost_model_calibration)) {
+    optimizer::CostModel::GetInstance()->Calibrate();
+  }
+
   // Initialize catalog
   auto pg_catalog = catalog::Catalog::GetInstance();
   pg_catalog->Bootstrap();  // Additional catalogs
@@ -108,6 +123,13 @@ void PelotonInit::Shutdown() {
     layout_tuner.Stop();
   }
 
+  // shut down tile group freezer
+  if (settings::SettingsManager::GetBool(
+          settings::SettingId::tile_group_freezer)) {
+    auto &tile_group_freezer = tuning::TileGroupFreezer::GetInstance();
+    tile_group_freezer.Stop();
+  }
+
   // shut down GC.
   gc::GCManagerFactory::GetInstance().StopGC();
 
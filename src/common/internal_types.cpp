@@ -2785,6 +2785,34 @@ std::ostream &operator<<(std::ostream &os, const LayoutType &type) {
   return os;
 }
 
+std::string CompressionTypeToString(CompressionType type) {
+  switch (type) {
+    case CompressionType::INVALID: {
+      return "INVALID";
+    }
+    case CompressionType::DICTIONARY: {
+      return "DICTIONARY";
+    }
+    case CompressionType::FRAME_OF_REFERENCE: {
+      return "FRAME_OF_REFERENCE";
+    }
+    case CompressionType::RUN_LENGTH: {
+      return "RUN_LENGTH";
+    }
+    default: {
+      throw ConversionException(StringUtil::Format(
+          "No string conversion for CompressionType value '%d'",
+          static_cast<int>(type)));
+    }
+  }
+  return "INVALID";
+}
+
+std::ostream &operator<<(std::ostream &os, const CompressionType &type) {
+  os << CompressionTypeToString(type);
+  return os;
+}
+
 type::TypeId PostgresValueTypeToPelotonValueType(PostgresValueType type) {
   switch (type) {
     case PostgresValueType::BOOLEAN:
@@ -3010,6 +3038,12 @@ std::string GCVersionTypeToString(GCVersionType type) {
     case GCVersionType::ABORT_INS_DEL: {
       return "ABORT_INS_DEL";
     }
+    case GCVersionType::COMMIT_DELTA: {
+      return "COMMIT_DELTA";
+    }
+    case GCVersionType::ABORT_DELTA: {
+      return "ABORT_DELTA";
+    }
     default: {
       throw ConversionException(StringUtil::Format(
           "No string conversion for GCVersionType value '%d'",
@@ -3037,6 +3071,10 @@ GCVersionType StringToGCVersionType(const std::string &str) {
     return GCVersionType::ABORT_INSERT;
   } else if (upper_str == "ABORT_INS_DEL") {
     return GCVersionType::ABORT_INS_DEL;
+  } else if (upper_str == "COMMIT_DELTA") {
+    return GCVersionType::COMMIT_DELTA;
+  } else if (upper_str == "ABORT_DELTA") {
+    return GCVersionType::ABORT_DELTA;
   } else {
     throw ConversionException(StringUtil::Format(
         "No GCVersionType conversion from string '%s'", upper_str.c_str()));
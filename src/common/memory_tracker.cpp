@@ -0,0 +1,56 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// memory_tracker.cpp
+//
+// Identification: src/common/memory_tracker.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/memory_tracker.h"
+
+namespace peloton {
+
+MemoryTracker::~MemoryTracker() {
+  uint64_t remaining = current_.load();
+  if (parent_ != nullptr && remaining > 0) {
+    parent_->Release(remaining);
+  }
+}
+
+void MemoryTracker::Reserve(uint64_t bytes) {
+  for (auto *tracker = this; tracker != nullptr; tracker = tracker->parent_) {
+    uint64_t current = tracker->current_.fetch_add(bytes) + bytes;
+    uint64_t peak = tracker->peak_.load();
+    while (current > peak &&
+           !tracker->peak_.compare_exchange_weak(peak, current)) {
+    }
+  }
+}
+
+void MemoryTracker::Release(uint64_t bytes) {
+  for (auto *tracker = this; tracker != nullptr; tracker = tracker->parent_) {
+    PELOTON_ASSERT(tracker->current_.load() >= bytes);
+    tracker->current_.fetch_sub(bytes);
+  }
+}
+
+bool MemoryBudget::TryReserve(uint64_t bytes) {
+  uint64_t reserved = reserved_.load();
+  do {
+    if (limit_ != 0 && reserved + bytes > limit_) {
+      return false;
+    }
+  } while (!reserved_.compare_exchange_weak(reserved, reserved + bytes));
+  return true;
+}
+
+void MemoryBudget::Release(uint64_t bytes) {
+  PELOTON_ASSERT(reserved_.load() >= bytes);
+  reserved_.fetch_sub(bytes);
+}
+
+}  // namespace peloton
@@ -0,0 +1,231 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// parameterized_plan_cache.cpp
+//
+// Identification: src/common/parameterized_plan_cache.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/parameterized_plan_cache.h"
+
+#include <algorithm>
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "common/statement_cache_manager.h"
+#include "expression/constant_value_expression.h"
+#include "expression/parameter_value_expression.h"
+#include "parser/delete_statement.h"
+#include "parser/insert_statement.h"
+#include "parser/postgresparser.h"
+#include "parser/select_statement.h"
+#include "parser/update_statement.h"
+
+namespace peloton {
+
+namespace {
+
+// The location of a literal in the parse tree: either the child of an
+// expression, or an expression owned directly by the statement
+struct LiteralRef {
+  std::unique_ptr<expression::AbstractExpression> *slot;
+  expression::AbstractExpression *parent;
+  int child_idx;
+};
+
+bool IsLiteral(const expression::AbstractExpression *expr) {
+  return expr != nullptr &&
+         expr->GetExpressionType() == ExpressionType::VALUE_CONSTANT;
+}
+
+void CollectLiteral(std::unique_ptr<expression::AbstractExpression> &slot,
+                    std::vector<LiteralRef> &literals) {
+  if (IsLiteral(slot.get())) {
+    literals.push_back({&slot, nullptr, 0});
+  }
+}
+
+// Collect the literals that are an operand of a comparison in a predicate.
+// We deliberately don't look into functions, operators, IN lists or
+// subqueries; a query with literals in there is not parameterized.
+void CollectPredicateLiterals(expression::AbstractExpression *expr,
+                              std::vector<LiteralRef> &literals) {
+  if (expr == nullptr) return;
+  switch (expr->GetExpressionType()) {
+    case ExpressionType::CONJUNCTION_AND:
+    case ExpressionType::CONJUNCTION_OR:
+    case ExpressionType::OPERATOR_NOT:
+      for (size_t i = 0; i < expr->GetChildrenSize(); i++) {
+        CollectPredicateLiterals(expr->GetModifiableChild(i), literals);
+      }
+      break;
+    case ExpressionType::COMPARE_EQUAL:
+    case ExpressionType::COMPARE_NOTEQUAL:
+    case ExpressionType::COMPARE_LESSTHAN:
+    case ExpressionType::COMPARE_GREATERTHAN:
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+    case ExpressionType::COMPARE_LIKE:
+    case ExpressionType::COMPARE_NOTLIKE:
+      for (size_t i = 0; i < expr->GetChildrenSize(); i++) {
+        if (IsLiteral(expr->GetModifiableChild(i))) {
+          literals.push_back({nullptr, expr, static_cast<int>(i)});
+        }
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+}  // namespace
+
+ParameterizedPlanCache::ParameterizedPlanCache(size_t capacity)
+    : capacity_(capacity) {
+  auto statement_cache_manager = StatementCacheManager::GetStmtCacheManager();
+  if (statement_cache_manager != nullptr) {
+    statement_cache_manager->RegisterStatementCache(&statement_cache_);
+  }
+}
+
+ParameterizedPlanCache::~ParameterizedPlanCache() {
+  auto statement_cache_manager = StatementCacheManager::GetStmtCacheManager();
+  if (statement_cache_manager != nullptr) {
+    statement_cache_manager->UnRegisterStatementCache(&statement_cache_);
+  }
+}
+
+std::string ParameterizedPlanCache::Parameterize(
+    const std::string &query_string, parser::SQLStatement *sql_stmt,
+    std::vector<std::unique_ptr<expression::AbstractExpression>> &parameters) {
+  // The normalizer marks literals with '?', which we can't tell apart from
+  // one that is already in the query
+  if (sql_stmt == nullptr || query_string.find('?') != std::string::npos) {
+    return "";
+  }
+
+  std::vector<LiteralRef> literals;
+  switch (sql_stmt->GetType()) {
+    case StatementType::SELECT: {
+      auto select_stmt = static_cast<parser::SelectStatement *>(sql_stmt);
+      CollectPredicateLiterals(select_stmt->where_clause.get(), literals);
+      break;
+    }
+    case StatementType::INSERT: {
+      auto insert_stmt = static_cast<parser::InsertStatement *>(sql_stmt);
+      for (auto &tuple : insert_stmt->insert_values) {
+        for (auto &value : tuple) {
+          CollectLiteral(value, literals);
+        }
+      }
+      break;
+    }
+    case StatementType::UPDATE: {
+      auto update_stmt = static_cast<parser::UpdateStatement *>(sql_stmt);
+      for (auto &update : update_stmt->updates) {
+        CollectLiteral(update->value, literals);
+      }
+      CollectPredicateLiterals(update_stmt->where.get(), literals);
+      break;
+    }
+    case StatementType::DELETE: {
+      auto delete_stmt = static_cast<parser::DeleteStatement *>(sql_stmt);
+      CollectPredicateLiterals(delete_stmt->expr.get(), literals);
+      break;
+    }
+    default:
+      return "";
+  }
+  if (literals.empty()) return "";
+
+  // The normalizer replaces every literal of the query with a placeholder. The
+  // query is only parameterized if we found all of them, i.e., none of them is
+  // hidden in a part of the query that we don't parameterize.
+  std::string normalized_query;
+  try {
+    normalized_query = parser::PostgresParser::NormalizeSQLString(query_string);
+  } catch (ParserException &e) {
+    LOG_TRACE("Failed to normalize query: %s", e.what());
+    return "";
+  }
+  auto num_placeholders = static_cast<size_t>(
+      std::count(normalized_query.begin(), normalized_query.end(), '?'));
+  if (num_placeholders != literals.size()) return "";
+
+  // NULLs have no type to bind the parameter with
+  for (auto &literal : literals) {
+    auto expr = literal.slot != nullptr
+                    ? literal.slot->get()
+                    : literal.parent->GetModifiableChild(literal.child_idx);
+    auto constant = static_cast<expression::ConstantValueExpression *>(expr);
+    if (constant->GetValue().IsNull()) return "";
+  }
+
+  // Replace the literals with parameters in the order we collected them, and
+  // append their types to the fingerprint as the plan depends on them
+  std::string fingerprint = normalized_query;
+  for (size_t param_idx = 0; param_idx < literals.size(); param_idx++) {
+    auto &literal = literals[param_idx];
+    auto param = new expression::ParameterValueExpression(param_idx);
+    if (literal.slot != nullptr) {
+      parameters.emplace_back(std::move(*literal.slot));
+      literal.slot->reset(param);
+    } else {
+      parameters.emplace_back(
+          literal.parent->GetModifiableChild(literal.child_idx)->Copy());
+      literal.parent->SetChild(literal.child_idx, param);
+    }
+    fingerprint += "#" + TypeIdToString(parameters.back()->GetValueType());
+  }
+  return fingerprint;
+}
+
+std::shared_ptr<Statement> ParameterizedPlanCache::GetStatement(
+    const std::string &fingerprint) {
+  auto itr = lru_map_.find(fingerprint);
+  if (itr == lru_map_.end()) {
+    return nullptr;
+  }
+  auto statement = statement_cache_.GetStatement(fingerprint);
+  // A table the plan refers to has changed since it was planned
+  if (statement->GetNeedsReplan()) {
+    DeleteStatement(fingerprint);
+    return nullptr;
+  }
+  lru_list_.splice(lru_list_.begin(), lru_list_, itr->second);
+  return statement;
+}
+
+void ParameterizedPlanCache::AddStatement(
+    const std::string &fingerprint, std::shared_ptr<Statement> statement) {
+  DeleteStatement(fingerprint);
+  while (!lru_list_.empty() && lru_list_.size() >= capacity_) {
+    std::string oldest = lru_list_.back();
+    DeleteStatement(oldest);
+  }
+  statement_cache_.AddStatement(fingerprint, statement);
+  lru_list_.push_front(fingerprint);
+  lru_map_[fingerprint] = lru_list_.begin();
+}
+
+void ParameterizedPlanCache::DeleteStatement(const std::string &fingerprint) {
+  auto itr = lru_map_.find(fingerprint);
+  if (itr == lru_map_.end()) {
+    return;
+  }
+  statement_cache_.DeleteStatement(fingerprint);
+  lru_list_.erase(itr->second);
+  lru_map_.erase(itr);
+}
+
+void ParameterizedPlanCache::Clear() {
+  statement_cache_.Clear();
+  lru_list_.clear();
+  lru_map_.clear();
+}
+
+}  // namespace peloton
@@ -17,8 +17,14 @@
 namespace peloton {
 // Add a statement to the cache
 void StatementCache::AddStatement(std::shared_ptr<Statement> stmt) {
+  AddStatement(stmt->GetStatementName(), stmt);
+}
+
+// Add a statement to the cache under the given name
+void StatementCache::AddStatement(const std::string &name,
+                                  std::shared_ptr<Statement> stmt) {
   UpdateFromInvalidTableQueue();
-  statement_map_[stmt->GetStatementName()] = stmt;
+  statement_map_[name] = stmt;
   for (auto table_id : stmt->GetReferencedTables()) {
     table_ref_[table_id].insert(stmt);
   }
@@ -27,7 +33,11 @@ void StatementCache::AddStatement(std::shared_ptr<Statement> stmt) {
 // Get the statement by its name;
 std::shared_ptr<Statement> StatementCache::GetStatement(std::string name) {
   UpdateFromInvalidTableQueue();
-  return statement_map_[name];
+  auto itr = statement_map_.find(name);
+  if (itr == statement_map_.end()) {
+    return nullptr;
+  }
+  return itr->second;
 }
 
   // Delete the statement
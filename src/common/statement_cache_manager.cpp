@@ -14,6 +14,8 @@
 
 namespace peloton {
 
+std::shared_ptr<StatementCacheManager> statement_cache_manager;
+
 void StatementCacheManager::RegisterStatementCache(StatementCache *stmt_cache) {
   statement_caches_.Insert(stmt_cache, stmt_cache);
 }
@@ -16,17 +16,52 @@
 namespace peloton {
 namespace concurrency {
 
+  void DecentralizedEpochManager::RegisterThread(const size_t thread_id) {
+    local_epoch_lock_.Lock();
+
+    size_t offset = thread_id % MAX_LOCAL_EPOCH_COUNT;
+    if (local_epochs_[offset].load() == nullptr) {
+      local_epochs_[offset].store(new LocalEpoch(thread_id));
+      if (offset >= local_epoch_count_.load()) {
+        local_epoch_count_.store(offset + 1);
+      }
+    }
+
+    local_epoch_lock_.Unlock();
+  }
+
+  void DecentralizedEpochManager::DeregisterThread(
+      UNUSED_ATTRIBUTE const size_t thread_id) {
+    // the local epoch stays in its slot. transactions of the thread may still
+    // be in their epochs until GC recycles them, and an empty slot would let
+    // GetExpiredEpochId() take them for expired, or even report that no epoch
+    // is in use at all. an idle local epoch never holds the expired epoch
+    // back, and the next thread that maps to the slot takes it over.
+  }
+
+  void DecentralizedEpochManager::ClearThreads() {
+    local_epoch_lock_.Lock();
+
+    for (auto &local_epoch : local_epochs_) {
+      delete local_epoch.exchange(nullptr);
+    }
+    local_epoch_count_ = 0;
+
+    local_epoch_lock_.Unlock();
+  }
 
   // enter epoch with thread id
   cid_t DecentralizedEpochManager::EnterEpoch(const size_t thread_id, const TimestampType ts_type) {
 
-    PELOTON_ASSERT(local_epochs_.find(thread_id) != local_epochs_.end());
+    LocalEpoch *local_epoch = GetLocalEpoch(thread_id);
 
     if (ts_type == TimestampType::SNAPSHOT_READ) {
 
-      local_epochs_.at(thread_id)->EnterEpoch(snapshot_global_epoch_id_, ts_type);
+      eid_t snapshot_epoch_id = snapshot_global_epoch_id_.load();
+
+      local_epoch->EnterEpoch(snapshot_epoch_id, ts_type);
 
-      return (snapshot_global_epoch_id_ << 32) | 0x0;
+      return (snapshot_epoch_id << 32) | 0x0;
 
     } else {
 
@@ -34,7 +69,7 @@ namespace concurrency {
         uint64_t epoch_id = GetCurrentEpochId();
 
         // enter the corresponding local epoch.
-        bool rt = local_epochs_.at(thread_id)->EnterEpoch(epoch_id, ts_type);
+        bool rt = local_epoch->EnterEpoch(epoch_id, ts_type);
 
         // if successfully entered local epoch
         if (rt == true) {
@@ -50,24 +85,35 @@ namespace concurrency {
 
   void DecentralizedEpochManager::ExitEpoch(const size_t thread_id, const eid_t epoch_id) {
 
-    PELOTON_ASSERT(local_epochs_.find(thread_id) != local_epochs_.end());
+    LocalEpoch *local_epoch =
+        local_epochs_[thread_id % MAX_LOCAL_EPOCH_COUNT].load();
+    PELOTON_ASSERT(local_epoch != nullptr);
 
     // exit from the corresponding local epoch.
-    local_epochs_.at(thread_id)->ExitEpoch(epoch_id);
+    local_epoch->ExitEpoch(epoch_id);
  
   }
 
 
   eid_t DecentralizedEpochManager::GetExpiredEpochId() {
     eid_t global_expired_eid = MAX_EID;
-    
+
+    // read the current epoch before looking for the local epochs: a thread
+    // that registers afterwards can only enter this epoch or a later one.
+    eid_t current_epoch_id = current_global_epoch_id_.load();
+    size_t local_epoch_count = local_epoch_count_.load();
+
     // for all the local epoch contexts, obtain the minimum max committed epoch id.
-    for (auto &local_epoch_itr : local_epochs_) {
-      
+    for (size_t offset = 0; offset < local_epoch_count; offset++) {
+      LocalEpoch *local_epoch = local_epochs_[offset].load();
+      if (local_epoch == nullptr) {
+        continue;
+      }
+
       // the centralized epoch manager must notify each local epoch
       // the current global epoch.
-      eid_t local_expired_eid = local_epoch_itr.second->GetExpiredEpochId(current_global_epoch_id_);
-      
+      eid_t local_expired_eid = local_epoch->GetExpiredEpochId(current_epoch_id);
+
       if (local_expired_eid < global_expired_eid) {
         global_expired_eid = local_expired_eid;
       }
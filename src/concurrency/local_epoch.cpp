@@ -12,103 +12,92 @@
 
 #include "concurrency/local_epoch.h"
 
-#include "concurrency/decentralized_epoch_manager.h"
+#include <algorithm>
+
+#include "common/macros.h"
 
 namespace peloton {
 namespace concurrency {
 
   bool LocalEpoch::EnterEpoch(const eid_t epoch_id, const TimestampType ts_type) {
 
-    epoch_lock_.Lock();
-
-    // if this thread is never used or has been GC'd
-    if (epoch_id_lower_bound_ == UINT64_MAX) {
-
-      epoch_id_lower_bound_ = epoch_id - 1;
-    
-    } else if (epoch_id_lower_bound_ >= epoch_id) {
-    
-      if (ts_type == TimestampType::SNAPSHOT_READ) {
-    
-        epoch_id_lower_bound_ = epoch_id - 1;
-    
-      } else {
-        // epoch_id_lower_bound_ has already been updated by the GC.
-        // have to grab a newer epoch_id.
-        epoch_lock_.Unlock();
-
-        return false;
-      }
+    if (ts_type == TimestampType::COMMIT) {
+      // a commit timestamp does not keep its epoch from expiring.
+      return epoch_id_lower_bound_.load() < epoch_id;
     }
 
-    if (ts_type != TimestampType::COMMIT) {
-
-      auto epoch_map_itr = epoch_map_.find(epoch_id);
-      // check whether the corresponding epoch exists.
-      if (epoch_map_itr == epoch_map_.end()) {
+    // count the transaction in first, and only then check the lower bound.
+    // GC publishes a new lower bound before it checks the counters again, so
+    // either GC sees this transaction or this transaction sees the new bound.
+    auto &txn_count = GetTxnCount(epoch_id);
+    txn_count.fetch_add(1);
 
-        std::shared_ptr<Epoch> epoch_ptr(new Epoch(epoch_id, 1));
+    eid_t lower_bound = epoch_id_lower_bound_.load();
+    while (lower_bound >= epoch_id) {
 
-        epoch_queue_.push(epoch_ptr);
-        epoch_map_[epoch_id] = epoch_ptr;
+      if (ts_type != TimestampType::SNAPSHOT_READ) {
+        // the epoch has already expired.
+        // have to grab a newer epoch_id.
+        txn_count.fetch_sub(1);
+        return false;
+      }
 
-      } else {
-        epoch_map_itr->second->txn_count_++;
+      // a snapshot read can always go back to its epoch.
+      if (epoch_id_lower_bound_.compare_exchange_weak(lower_bound,
+                                                      epoch_id - 1)) {
+        break;
       }
-      
     }
 
-    epoch_lock_.Unlock();
-
     return true;
   }
 
   void LocalEpoch::ExitEpoch(const eid_t epoch_id) {
-    epoch_lock_.Lock();
-
-    PELOTON_ASSERT(epoch_map_.find(epoch_id) != epoch_map_.end());
-    epoch_map_.at(epoch_id)->txn_count_--;
-
-    while (epoch_queue_.size() != 0) {
-      auto &epoch_ptr = epoch_queue_.top();
-      if (epoch_ptr->txn_count_ == 0) {
-        epoch_map_.erase(epoch_ptr->epoch_id_);
-        epoch_queue_.pop();
-      } else {
-        PELOTON_ASSERT(epoch_ptr->epoch_id_ > epoch_id_lower_bound_);
-        epoch_id_lower_bound_ = epoch_ptr->epoch_id_ - 1;
-        break;
+    PELOTON_ASSERT(GetTxnCount(epoch_id).load() > 0);
+    GetTxnCount(epoch_id).fetch_sub(1);
+  }
+
+  eid_t LocalEpoch::GetOldestActiveEpochId(const eid_t from, const eid_t to) {
+    // every counter has been checked after EPOCH_RING_SIZE epochs.
+    eid_t end = std::min(to, from + EPOCH_RING_SIZE);
+    for (eid_t epoch_id = from; epoch_id < end; epoch_id++) {
+      if (GetTxnCount(epoch_id).load() != 0) {
+        return epoch_id;
       }
     }
-
-    epoch_lock_.Unlock();
+    return to;
   }
 
-  uint64_t LocalEpoch::GetExpiredEpochId(const uint64_t epoch_id) {
-    epoch_lock_.Lock();
-    // there's no epoch in this thread.
-    // which indicates that this thread is never used or has been GC'd for some time.
-    if (epoch_queue_.size() == 0) {
-      epoch_id_lower_bound_ = epoch_id - 1;
-    } else {
-      while (epoch_queue_.size() != 0) {
-        // get the smallest epoch.
-        auto &epoch_ptr = epoch_queue_.top();
-        // if there's no transaction in the epoch
-        if (epoch_ptr->txn_count_ == 0) {
-          epoch_map_.erase(epoch_ptr->epoch_id_);
-          epoch_queue_.pop();
-        } else {
-          PELOTON_ASSERT(epoch_ptr->epoch_id_ > epoch_id_lower_bound_);
-          epoch_id_lower_bound_ = epoch_ptr->epoch_id_ - 1;
-          break;
-        }
+  uint64_t LocalEpoch::GetExpiredEpochId(const uint64_t current_epoch_id) {
+    eid_t lower_bound = epoch_id_lower_bound_.load();
+
+    while (true) {
+      // every epoch before the oldest one that has transactions has expired.
+      // if there's no such epoch, this thread is idle.
+      eid_t expired_epoch_id =
+          GetOldestActiveEpochId(lower_bound + 1, current_epoch_id) - 1;
+      if (expired_epoch_id <= lower_bound) {
+        return lower_bound;
+      }
+
+      if (!epoch_id_lower_bound_.compare_exchange_weak(lower_bound,
+                                                       expired_epoch_id)) {
+        continue;
+      }
+
+      // a transaction may have entered one of the epochs before it saw the new
+      // lower bound. if so, move the lower bound back before its epoch.
+      eid_t oldest_epoch_id =
+          GetOldestActiveEpochId(lower_bound + 1, expired_epoch_id + 1);
+      if (oldest_epoch_id > expired_epoch_id) {
+        return expired_epoch_id;
+      }
+      lower_bound = expired_epoch_id;
+      if (epoch_id_lower_bound_.compare_exchange_strong(lower_bound,
+                                                        oldest_epoch_id - 1)) {
+        return oldest_epoch_id - 1;
       }
     }
-    uint64_t ret = epoch_id_lower_bound_;
-    
-    epoch_lock_.Unlock();
-    return ret;
   }
 
 }
@@ -13,6 +13,7 @@
 #include "concurrency/timestamp_ordering_transaction_manager.h"
 #include <cinttypes>
 #include "storage/storage_manager.h"
+#include "storage/undo_record.h"
 
 #include "catalog/catalog_defaults.h"
 #include "catalog/manager.h"
@@ -579,6 +580,125 @@ void TimestampOrderingTransactionManager::PerformDelete(
   }
 }
 
+void TimestampOrderingTransactionManager::PerformUpdate(
+    TransactionContext *const current_txn, const ItemPointer &location,
+    const storage::Tuple *new_tuple, const std::vector<oid_t> &column_ids) {
+  PELOTON_ASSERT(!current_txn->IsReadOnly());
+
+  oid_t tuple_id = location.offset;
+
+  auto storage_manager = storage::StorageManager::GetInstance();
+  auto tile_group = storage_manager->GetTileGroup(location.block);
+  auto tile_group_header = tile_group->GetHeader();
+  auto transaction_id = current_txn->GetTransactionId();
+
+  PELOTON_ASSERT(tile_group_header->HasUndoChains());
+  PELOTON_ASSERT(tile_group_header->GetTransactionId(tuple_id) ==
+                 transaction_id);
+  PELOTON_ASSERT(tile_group_header->GetEndCommitId(tuple_id) == MAX_CID);
+
+  cid_t begin_cid = tile_group_header->GetBeginCommitId(tuple_id);
+  auto undo_head = tile_group_header->GetUndoRecord(tuple_id);
+
+  // save the old values that readers may still need: those of all updated
+  // columns if the version is committed, or those of the columns this
+  // transaction did not update yet if it already updated the tuple in place.
+  // a version this transaction installed itself has no older values to keep.
+  std::vector<oid_t> undo_column_ids;
+  if (begin_cid != MAX_CID) {
+    undo_column_ids = column_ids;
+  } else if (undo_head != nullptr &&
+             undo_head->GetTransactionId() == transaction_id) {
+    for (auto column_id : column_ids) {
+      bool covered = false;
+      for (auto undo_record = undo_head;
+           undo_record != nullptr &&
+           undo_record->GetTransactionId() == transaction_id;
+           undo_record = undo_record->GetNext()) {
+        if (undo_record->Covers(column_id)) {
+          covered = true;
+          break;
+        }
+      }
+      if (!covered) undo_column_ids.push_back(column_id);
+    }
+  }
+
+  if (begin_cid != MAX_CID || !undo_column_ids.empty()) {
+    auto undo_record =
+        storage::UndoRecord::Create(transaction_id, begin_cid, tile_group.get(),
+                                    tuple_id, undo_column_ids);
+
+    auto &latch = tile_group_header->GetSpinLatch(tuple_id);
+    latch.Lock();
+    undo_record->SetNext(tile_group_header->GetUndoRecord(tuple_id));
+    tile_group_header->SetUndoRecord(tuple_id, undo_record);
+    latch.Unlock();
+
+    tile_group_header->SetBeginCommitId(tuple_id, MAX_CID);
+
+    // readers must see the record before any of the new values, so that they
+    // retry rather than mix old and new values. see ReadVersion().
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+
+  if (begin_cid != MAX_CID) {
+    // the first update of a committed version
+    current_txn->RecordUpdate(location);
+  }
+
+  for (auto column_id : column_ids) {
+    type::Value value = new_tuple->GetValue(column_id);
+    tile_group->SetValue(value, tuple_id, column_id);
+  }
+}
+
+void TimestampOrderingTransactionManager::UndoInPlaceUpdates(
+    TransactionContext *const current_txn, const ItemPointer &location) {
+  oid_t tuple_slot = location.offset;
+
+  auto storage_manager = storage::StorageManager::GetInstance();
+  auto tile_group = storage_manager->GetTileGroup(location.block);
+  auto tile_group_header = tile_group->GetHeader();
+
+  // write the old values back, from the newest undo record of this
+  // transaction to its oldest one, which restores the committed version
+  std::vector<storage::UndoRecord *> undone_records;
+  cid_t begin_cid = tile_group_header->GetBeginCommitId(tuple_slot);
+  auto undo_record = tile_group_header->GetUndoRecord(tuple_slot);
+  while (undo_record != nullptr &&
+         undo_record->GetTransactionId() == current_txn->GetTransactionId()) {
+    undo_record->ApplyTo(tile_group.get(), tuple_slot);
+    begin_cid = undo_record->GetBeginCommitId();
+    undone_records.push_back(undo_record);
+    undo_record = undo_record->GetNext();
+  }
+  if (undone_records.empty()) {
+    return;
+  }
+
+  tile_group_header->SetBeginCommitId(tuple_slot, begin_cid);
+  tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
+
+  // readers that still see the records of this transaction rebuild the same
+  // version from them
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  auto &latch = tile_group_header->GetSpinLatch(tuple_slot);
+  latch.Lock();
+  tile_group_header->SetUndoRecord(tuple_slot, undo_record);
+  latch.Unlock();
+
+  // concurrent readers may still walk the unlinked records, so they are freed
+  // with the transaction context, once the gc is done with it. without gc,
+  // they are never freed, like old versions are not.
+  if (gc::GCManagerFactory::GetGCType() == GarbageCollectionType::ON) {
+    for (auto undone_record : undone_records) {
+      current_txn->AddUndoGarbage(undone_record);
+    }
+  }
+}
+
 ResultType TimestampOrderingTransactionManager::CommitTransaction(
     TransactionContext *const current_txn) {
   LOG_TRACE("Committing peloton txn : %" PRId64,
@@ -644,6 +764,41 @@ ResultType TimestampOrderingTransactionManager::CommitTransaction(
       // update/delete yet
       // Yield the ownership
       YieldOwnership(current_txn, tile_group_header, tuple_slot);
+    } else if (tuple_entry.second == RWType::UPDATE &&
+               IsUpdatedInPlace(tile_group_header, tuple_slot)) {
+      // the new values are already in place. the old ones stay in the undo
+      // records until no transaction can read them.
+      tile_group_header->SetBeginCommitId(tuple_slot, end_commit_id);
+
+      // we should set the version before releasing the lock.
+      COMPILER_MEMORY_FENCE;
+
+      tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
+
+      gc_set->operator[](tile_group_id)[tuple_slot] =
+          GCVersionType::COMMIT_DELTA;
+
+      log_manager.LogUpdate(item_ptr);
+
+    } else if (tuple_entry.second == RWType::DELETE &&
+               IsUpdatedInPlace(tile_group_header, tuple_slot)) {
+      // the tuple was updated in place before it was deleted. the slot
+      // becomes the empty version that marks the tuple deleted.
+      tile_group_header->SetBeginCommitId(tuple_slot, end_commit_id);
+      tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
+
+      // we should set the version before releasing the lock.
+      COMPILER_MEMORY_FENCE;
+
+      tile_group_header->SetTransactionId(tuple_slot, INVALID_TXN_ID);
+
+      // like a version that is inserted and deleted, the slot is only
+      // reachable from the indexes, which the gc deletes it from.
+      gc_set->operator[](tile_group_id)[tuple_slot] =
+          GCVersionType::COMMIT_INS_DEL;
+
+      log_manager.LogDelete(item_ptr);
+
     } else if (tuple_entry.second == RWType::UPDATE) {
       // we must guarantee that, at any time point, only one version is
       // visible.
@@ -802,6 +957,19 @@ ResultType TimestampOrderingTransactionManager::AbortTransaction(
       // update/delete yet
       // Yield the ownership
       YieldOwnership(current_txn, tile_group_header, tuple_slot);
+    } else if ((tuple_entry.second == RWType::UPDATE ||
+                tuple_entry.second == RWType::DELETE) &&
+               IsUpdatedInPlace(tile_group_header, tuple_slot)) {
+      UndoInPlaceUpdates(current_txn, item_ptr);
+
+      // we should set the version before releasing the lock.
+      COMPILER_MEMORY_FENCE;
+
+      tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
+
+      gc_set->operator[](tile_group_id)[tuple_slot] =
+          GCVersionType::ABORT_DELTA;
+
     } else if (tuple_entry.second == RWType::UPDATE) {
       ItemPointer new_version =
           tile_group_header->GetPrevItemPointer(tuple_slot);
@@ -852,6 +1020,11 @@ ResultType TimestampOrderingTransactionManager::AbortTransaction(
           GCVersionType::ABORT_UPDATE;
 
     } else if (tuple_entry.second == RWType::DELETE) {
+      // the tuple may have been updated in place before it was deleted
+      if (tile_group_header->HasUndoChains()) {
+        UndoInPlaceUpdates(current_txn, item_ptr);
+      }
+
       ItemPointer new_version =
           tile_group_header->GetPrevItemPointer(tuple_slot);
       auto new_tile_group_header =
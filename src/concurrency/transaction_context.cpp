@@ -17,6 +17,7 @@
 #include "common/logger.h"
 #include "common/macros.h"
 #include "common/platform.h"
+#include "storage/undo_record.h"
 #include "trigger/trigger.h"
 
 #include <chrono>
@@ -61,6 +62,14 @@ TransactionContext::TransactionContext(const size_t thread_id,
   Init(thread_id, isolation, read_id, commit_id);
 }
 
+TransactionContext::~TransactionContext() {
+  // The records were unlinked one by one, so their next pointers may still
+  // point to records that someone else frees
+  for (auto undo_record : undo_garbage_) {
+    storage::UndoRecord::Free(undo_record);
+  }
+}
+
 void TransactionContext::Init(const size_t thread_id,
                               const IsolationLevelType isolation,
                               const cid_t &read_id, const cid_t &commit_id) {
@@ -21,6 +21,8 @@
 #include "statistics/stats_aggregator.h"
 #include "storage/tile_group.h"
 #include "storage/storage_manager.h"
+#include "storage/tuple.h"
+#include "storage/undo_record.h"
 
 namespace peloton {
 namespace concurrency {
@@ -249,6 +251,50 @@ VisibilityType TransactionManager::IsVisible(
   }
 }
 
+VisibilityType TransactionManager::ReadVersion(
+    TransactionContext *const current_txn, storage::TileGroup *tile_group,
+    const oid_t &tuple_id, storage::Tuple *version, bool &is_newest) {
+  auto tile_group_header = tile_group->GetHeader();
+  cid_t read_id = current_txn->GetReadId();
+
+  storage::UndoRecord *undo_record;
+  VisibilityType visibility;
+  bool is_older;
+  do {
+    undo_record = tile_group_header->GetUndoRecord(tuple_id);
+    visibility = IsVisible(current_txn, tile_group_header, tuple_id);
+
+    // the version in the slot is either the visible one, or newer than it:
+    // uncommitted, or committed after the current transaction started
+    is_older =
+        tile_group_header->GetTransactionId(tuple_id) !=
+            current_txn->GetTransactionId() &&
+        tile_group_header->GetBeginCommitId(tuple_id) > read_id;
+
+    tile_group->ReadTuple(tuple_id, version);
+
+    // an owner pushes its undo record before it changes any value in place.
+    // so if the head of the chain did not move, the copy is not torn.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  } while (tile_group_header->GetUndoRecord(tuple_id) != undo_record);
+
+  is_newest = true;
+  if (!is_older || undo_record == nullptr) {
+    return visibility;
+  }
+
+  // walk back the chain until the restored version was committed before
+  // the current transaction started
+  for (; undo_record != nullptr; undo_record = undo_record->GetNext()) {
+    undo_record->ApplyTo(version);
+    is_newest = false;
+    if (undo_record->GetBeginCommitId() <= read_id) {
+      return VisibilityType::OK;
+    }
+  }
+  return VisibilityType::INVISIBLE;
+}
+
 void TransactionManager::RecordTransactionStats(
     const TransactionContext *const current_txn) const {
   PELOTON_ASSERT(static_cast<StatsType>(settings::SettingsManager::GetInt(
@@ -30,7 +30,10 @@ AbstractExecutor::AbstractExecutor(const planner::AbstractPlan *node,
 void AbstractExecutor::SetOutput(LogicalTile *table) { output.reset(table); }
 
 // Transfers ownership
-LogicalTile *AbstractExecutor::GetOutput() { return output.release(); }
+LogicalTile *AbstractExecutor::GetOutput() {
+  if (output != nullptr) num_output_tuples_ += output->GetTupleCount();
+  return output.release();
+}
 
 /**
  * @brief Add child executor to this executor node.
@@ -88,6 +91,7 @@ bool AbstractExecutor::Execute() {
   // GetNextTile. e.g. params for prepared plans.
 
   bool status = DExecute();
+  if (status == false) exhausted_ = true;
 
   return status;
 }
@@ -17,7 +17,10 @@
 #include "executor/logical_tile_factory.h"
 #include "expression/abstract_expression.h"
 #include "common/container_tuple.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/executor_context.h"
 #include "storage/data_table.h"
+#include "storage/tile.h"
 #include "storage/tile_group.h"
 
 #include "common/logger.h"
@@ -51,5 +54,75 @@ bool AbstractScanExecutor::DInit() {
   return true;
 }
 
+VisibilityType AbstractScanExecutor::ReadVersion(storage::TileGroup *tile_group,
+                                                 oid_t tuple_id,
+                                                 bool &is_newest) {
+  if (version_ == nullptr) {
+    version_.reset(new storage::Tuple(
+        tile_group->GetAbstractTable()->GetSchema(), true));
+  }
+
+  auto &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+  return transaction_manager.ReadVersion(executor_context_->GetTransaction(),
+                                         tile_group, tuple_id, version_.get(),
+                                         is_newest);
+}
+
+bool AbstractScanExecutor::SelectVersion(storage::TileGroup *tile_group,
+                                         oid_t tuple_id, bool is_newest,
+                                         bool acquire_owner, bool &selected) {
+  selected = predicate_ == nullptr ||
+             predicate_->Evaluate(version_.get(), nullptr, executor_context_)
+                 .IsTrue();
+  if (!selected) return true;
+
+  auto &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+  auto current_txn = executor_context_->GetTransaction();
+
+  // An old version cannot be written, as someone else already changed it
+  if ((for_write_ || acquire_owner) && !is_newest) {
+    transaction_manager.SetTransactionResult(current_txn, ResultType::FAILURE);
+    return false;
+  }
+
+  ItemPointer location(tile_group->GetTileGroupId(), tuple_id);
+  if (!transaction_manager.PerformRead(current_txn, location,
+                                       tile_group->GetHeader(),
+                                       acquire_owner)) {
+    transaction_manager.SetTransactionResult(current_txn, ResultType::FAILURE);
+    return false;
+  }
+  return true;
+}
+
+void AbstractScanExecutor::AddVersion(const std::vector<oid_t> &column_ids) {
+  for (auto column_id : column_ids) {
+    version_values_.push_back(version_->GetValue(column_id));
+  }
+}
+
+LogicalTile *AbstractScanExecutor::BuildVersionTile(
+    const storage::DataTable *table, const std::vector<oid_t> &column_ids,
+    const std::vector<size_t> &rows) {
+  std::unique_ptr<catalog::Schema> schema(
+      catalog::Schema::CopySchema(table->GetSchema(), column_ids));
+  std::shared_ptr<storage::Tile> tile(storage::TileFactory::GetTile(
+      BackendType::MM, INVALID_OID, INVALID_OID, INVALID_OID, INVALID_OID,
+      nullptr, *schema, nullptr, static_cast<int>(rows.size())));
+
+  for (oid_t tuple_id = 0; tuple_id < rows.size(); tuple_id++) {
+    size_t offset = rows[tuple_id] * column_ids.size();
+    for (oid_t column_itr = 0; column_itr < column_ids.size(); column_itr++) {
+      tile->SetValue(version_values_[offset + column_itr], tuple_id,
+                     column_itr);
+    }
+  }
+
+  std::vector<std::shared_ptr<storage::Tile>> singleton({tile});
+  return LogicalTileFactory::WrapTiles(singleton);
+}
+
 }  // namespace executor
 }  // namespace peloton
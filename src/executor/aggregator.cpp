@@ -161,55 +161,108 @@ HashAggregator::HashAggregator(const planner::AggregatePlan *node,
 
 HashAggregator::~HashAggregator() {
   for (auto entry : aggregates_map) {
-    // Clean up allocated storage
-    for (size_t aggno = 0; aggno < node->GetUniqueAggTerms().size(); aggno++) {
-      delete entry.second->aggregates[aggno];
+    DeleteAggregateList(entry.second);
+  }
+  if (flat_aggregates_map != nullptr) {
+    for (auto iter = flat_aggregates_map->begin();
+         iter != flat_aggregates_map->end(); ++iter) {
+      AggregateList *aggregate_list;
+      PELOTON_MEMCPY(&aggregate_list, iter.Value(), sizeof(aggregate_list));
+      DeleteAggregateList(aggregate_list);
     }
-    delete[] entry.second->aggregates;
-    delete entry.second;
   }
 }
 
-bool HashAggregator::Advance(AbstractTuple *cur_tuple) {
-  AggregateList *aggregate_list;
+void HashAggregator::InitHashTable(const AbstractTuple *first_tuple) {
+  std::vector<type::TypeId> key_types;
+  for (auto column_id : node->GetGroupbyColIds()) {
+    key_types.push_back(first_tuple->GetValue(column_id).GetTypeId());
+  }
 
-  // Configure a group-by-key and search for the required group.
-  group_by_key_values.clear();
-  for (oid_t column_itr = 0; column_itr < node->GetGroupbyColIds().size();
-       column_itr++) {
-    type::Value cur_tuple_val =
-        cur_tuple->GetValue(node->GetGroupbyColIds()[column_itr]);
-    group_by_key_values.push_back(cur_tuple_val);
+  if (FlatHashTable::IsSupported(key_types)) {
+    LOG_TRACE("Use flat hash table for group-by keys");
+    flat_aggregates_map.reset(
+        new FlatHashTable(key_types, sizeof(AggregateList *)));
+    group_by_key.resize(flat_aggregates_map->GetKeySize());
   }
+  hash_table_initialized = true;
+}
 
-  auto map_itr = aggregates_map.find(group_by_key_values);
+HashAggregator::AggregateList *HashAggregator::CreateAggregateList(
+    const AbstractTuple *first_tuple) {
+  // Allocate new aggregate list
+  auto aggregate_list = new AggregateList();
+  aggregate_list->aggregates =
+      new AbstractAttributeAggregator *[node->GetUniqueAggTerms().size()];
+  // Make a deep copy of the first tuple we meet
+  for (size_t col_id = 0; col_id < num_input_columns; col_id++) {
+    // first_tuple_values has the ownership
+    aggregate_list->first_tuple_values.push_back(first_tuple->GetValue(col_id));
+  };
 
-  // Group not found. Make a new entry in the hash for this new group.
-  if (map_itr == aggregates_map.end()) {
-    LOG_TRACE("Group-by key not found. Start a new group.");
-    // Allocate new aggregate list
-    aggregate_list = new AggregateList();
-    aggregate_list->aggregates = new AbstractAttributeAggregator *[node->GetUniqueAggTerms().size()];
-    // Make a deep copy of the first tuple we meet
-    for (size_t col_id = 0; col_id < num_input_columns; col_id++) {
-      // first_tuple_values has the ownership
-      aggregate_list->first_tuple_values.push_back(cur_tuple->GetValue(col_id));
-    };
+  for (oid_t aggno = 0; aggno < node->GetUniqueAggTerms().size(); aggno++) {
+    aggregate_list->aggregates[aggno] =
+        GetAttributeAggregatorInstance(node->GetUniqueAggTerms()[aggno].aggtype);
 
-    for (oid_t aggno = 0; aggno < node->GetUniqueAggTerms().size(); aggno++) {
-      aggregate_list->aggregates[aggno] =
-          GetAttributeAggregatorInstance(node->GetUniqueAggTerms()[aggno].aggtype);
+    bool distinct = node->GetUniqueAggTerms()[aggno].distinct;
+    aggregate_list->aggregates[aggno]->SetDistinct(distinct);
+  }
+  return aggregate_list;
+}
 
-      bool distinct = node->GetUniqueAggTerms()[aggno].distinct;
-      aggregate_list->aggregates[aggno]->SetDistinct(distinct);
-    }
+void HashAggregator::DeleteAggregateList(AggregateList *aggregate_list) {
+  // Clean up allocated storage
+  for (size_t aggno = 0; aggno < node->GetUniqueAggTerms().size(); aggno++) {
+    delete aggregate_list->aggregates[aggno];
+  }
+  delete[] aggregate_list->aggregates;
+  delete aggregate_list;
+}
+
+bool HashAggregator::Advance(AbstractTuple *cur_tuple) {
+  AggregateList *aggregate_list;
 
-    aggregates_map.insert(
-        HashAggregateMapType::value_type(group_by_key_values, aggregate_list));
+  if (!hash_table_initialized) {
+    InitHashTable(cur_tuple);
   }
-  // Otherwise, the list is the second item of the pair.
-  else {
-    aggregate_list = map_itr->second;
+
+  if (flat_aggregates_map != nullptr) {
+    // Serialize the group-by key and search for the required group.
+    auto hash = flat_aggregates_map->MakeKey(
+        *cur_tuple, node->GetGroupbyColIds(), group_by_key.data());
+    bool new_group;
+    char *entry = flat_aggregates_map->FindOrInsert(hash, group_by_key.data(),
+                                                    new_group);
+    if (new_group) {
+      LOG_TRACE("Group-by key not found. Start a new group.");
+      aggregate_list = CreateAggregateList(cur_tuple);
+      PELOTON_MEMCPY(entry, &aggregate_list, sizeof(aggregate_list));
+    } else {
+      PELOTON_MEMCPY(&aggregate_list, entry, sizeof(aggregate_list));
+    }
+  } else {
+    // Configure a group-by-key and search for the required group.
+    group_by_key_values.clear();
+    for (oid_t column_itr = 0; column_itr < node->GetGroupbyColIds().size();
+         column_itr++) {
+      type::Value cur_tuple_val =
+          cur_tuple->GetValue(node->GetGroupbyColIds()[column_itr]);
+      group_by_key_values.push_back(cur_tuple_val);
+    }
+
+    auto map_itr = aggregates_map.find(group_by_key_values);
+
+    // Group not found. Make a new entry in the hash for this new group.
+    if (map_itr == aggregates_map.end()) {
+      LOG_TRACE("Group-by key not found. Start a new group.");
+      aggregate_list = CreateAggregateList(cur_tuple);
+      aggregates_map.insert(HashAggregateMapType::value_type(
+          group_by_key_values, aggregate_list));
+    }
+    // Otherwise, the list is the second item of the pair.
+    else {
+      aggregate_list = map_itr->second;
+    }
   }
 
   // Update the aggregation calculation
@@ -228,6 +281,22 @@ bool HashAggregator::Advance(AbstractTuple *cur_tuple) {
 }
 
 bool HashAggregator::Finalize() {
+  if (flat_aggregates_map != nullptr) {
+    for (auto iter = flat_aggregates_map->begin();
+         iter != flat_aggregates_map->end(); ++iter) {
+      AggregateList *aggregate_list;
+      PELOTON_MEMCPY(&aggregate_list, iter.Value(), sizeof(aggregate_list));
+      // Construct a container for the first tuple
+      ContainerTuple<std::vector<type::Value>> first_tuple(
+          &aggregate_list->first_tuple_values);
+      if (Helper(node, aggregate_list->aggregates, output_table, &first_tuple,
+                 this->executor_context) == false) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   for (auto entry : aggregates_map) {
     // Construct a container for the first tuple
     ContainerTuple<std::vector<type::Value>> first_tuple(
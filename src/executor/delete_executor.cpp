@@ -13,6 +13,7 @@
 #include <cinttypes>
 #include "storage/storage_manager.h"
 #include "executor/delete_executor.h"
+#include "executor/abstract_scan_executor.h"
 #include "executor/executor_context.h"
 
 #include "type/value.h"
@@ -61,6 +62,13 @@ bool DeleteExecutor::DInit() {
   target_table_ = node.GetTable();
   PELOTON_ASSERT(target_table_);
 
+  // the tuples to delete are marked where the scan found them, so the scan
+  // must return their positions rather than copies of the visible versions
+  auto scan_executor = dynamic_cast<AbstractScanExecutor *>(children_[0]);
+  if (scan_executor != nullptr) {
+    scan_executor->SetForWrite(true);
+  }
+
   return true;
 }
 
@@ -213,6 +221,26 @@ bool DeleteExecutor::DExecute() {
                                                    ResultType::FAILURE);
           return false;
         }
+
+        // with delta storage, the slot may hold a version that was committed
+        // after the current transaction started, which it must not delete.
+        if (tile_group_header->HasUndoChains()) {
+          cid_t txn_cid =
+              current_txn->GetIsolationLevel() == IsolationLevelType::SNAPSHOT
+                  ? current_txn->GetCommitId()
+                  : current_txn->GetReadId();
+          if (tile_group_header->GetBeginCommitId(physical_tuple_id) >
+              txn_cid) {
+            if (is_owner == false) {
+              transaction_manager.YieldOwnership(current_txn, tile_group_header,
+                                                 physical_tuple_id);
+            }
+            transaction_manager.SetTransactionResult(current_txn,
+                                                     ResultType::FAILURE);
+            return false;
+          }
+        }
+
         // if it is the latest version and not locked by other threads, then
         // insert an empty version.
         ItemPointer new_location = target_table_->InsertEmptyVersion();
@@ -12,7 +12,9 @@
 
 #include "executor/executor_context.h"
 
+#include "settings/settings_manager.h"
 #include "storage/storage_manager.h"
+#include "threadpool/memory_governor.h"
 
 namespace peloton {
 namespace executor {
@@ -24,10 +26,19 @@ namespace executor {
 ////////////////////////////////////////////////////////////////////////////////
 
 ExecutorContext::ExecutorContext(concurrency::TransactionContext *transaction,
-                                 codegen::QueryParameters parameters)
+                                 codegen::QueryParameters parameters,
+                                 MemoryTracker *parent_tracker)
     : transaction_(transaction),
       parameters_(std::move(parameters)),
       storage_manager_(storage::StorageManager::GetInstance()),
+      memory_budget_(static_cast<uint64_t>(settings::SettingsManager::GetInt(
+                         settings::SettingId::query_memory_budget)) *
+                     1024 * 1024),
+      memory_tracker_(new MemoryTracker(
+          parent_tracker != nullptr
+              ? parent_tracker
+              : &threadpool::MemoryGovernor::GetInstance().GetTracker())),
+      pool_(memory_tracker_.get()),
       thread_states_(pool_) {}
 
 concurrency::TransactionContext *ExecutorContext::GetTransaction() const {
@@ -46,6 +57,13 @@ codegen::QueryParameters &ExecutorContext::GetParams() { return parameters_; }
 
 type::EphemeralPool *ExecutorContext::GetPool() { return &pool_; }
 
+MemoryBudget &ExecutorContext::GetMemoryBudget() { return memory_budget_; }
+
+const std::shared_ptr<MemoryTracker> &ExecutorContext::GetMemoryTracker()
+    const {
+  return memory_tracker_;
+}
+
 ExecutorContext::ThreadStates &ExecutorContext::GetThreadStates() {
   return thread_states_;
 }
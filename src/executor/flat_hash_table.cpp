@@ -0,0 +1,166 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// flat_hash_table.cpp
+//
+// Identification: src/executor/flat_hash_table.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "executor/flat_hash_table.h"
+
+#include <cstring>
+
+#include "common/abstract_tuple.h"
+#include "murmur3/MurmurHash3.h"
+#include "type/value.h"
+
+namespace peloton {
+namespace executor {
+
+namespace {
+
+// Keys of types in the same class are serialized the same way
+enum class KeyClass { INVALID, INTEGER, DECIMAL, BOOLEAN, TIMESTAMP, DATE };
+
+KeyClass GetKeyClass(type::TypeId type) {
+  switch (type) {
+    case type::TypeId::TINYINT:
+    case type::TypeId::SMALLINT:
+    case type::TypeId::INTEGER:
+    case type::TypeId::BIGINT:
+      return KeyClass::INTEGER;
+    case type::TypeId::DECIMAL:
+      return KeyClass::DECIMAL;
+    case type::TypeId::BOOLEAN:
+      return KeyClass::BOOLEAN;
+    case type::TypeId::TIMESTAMP:
+      return KeyClass::TIMESTAMP;
+    case type::TypeId::DATE:
+      return KeyClass::DATE;
+    default:
+      return KeyClass::INVALID;
+  }
+}
+
+// The 8 bytes a non-NULL value is serialized into
+uint64_t SerializeValue(const type::Value &value) {
+  int64_t integer = 0;
+  switch (value.GetTypeId()) {
+    case type::TypeId::BOOLEAN:
+    case type::TypeId::TINYINT:
+      integer = value.GetAs<int8_t>();
+      break;
+    case type::TypeId::SMALLINT:
+      integer = value.GetAs<int16_t>();
+      break;
+    case type::TypeId::INTEGER:
+      integer = value.GetAs<int32_t>();
+      break;
+    case type::TypeId::DATE:
+      integer = value.GetAs<uint32_t>();
+      break;
+    case type::TypeId::BIGINT:
+      integer = value.GetAs<int64_t>();
+      break;
+    case type::TypeId::TIMESTAMP:
+      return value.GetAs<uint64_t>();
+    case type::TypeId::DECIMAL: {
+      // -0.0 and 0.0 are equal but have different bytes
+      double decimal = value.GetAs<double>();
+      if (decimal == 0) decimal = 0;
+      uint64_t bits;
+      PELOTON_MEMCPY(&bits, &decimal, sizeof(bits));
+      return bits;
+    }
+    default:
+      PELOTON_ASSERT(false);
+      break;
+  }
+  return static_cast<uint64_t>(integer);
+}
+
+}  // namespace
+
+FlatHashTable::FlatHashTable(const std::vector<type::TypeId> &key_types,
+                             uint64_t value_size)
+    : num_key_columns_(key_types.size()),
+      key_size_(key_types.size() * sizeof(uint64_t) +
+                (key_types.size() + 7) / 8 * 8),
+      table_(key_size_, value_size) {
+  PELOTON_ASSERT(IsSupported(key_types));
+}
+
+bool FlatHashTable::IsSupported(const std::vector<type::TypeId> &key_types) {
+  if (key_types.empty()) return false;
+  for (auto key_type : key_types) {
+    if (GetKeyClass(key_type) == KeyClass::INVALID) return false;
+  }
+  return true;
+}
+
+bool FlatHashTable::IsCompatible(
+    const std::vector<type::TypeId> &key_types,
+    const std::vector<type::TypeId> &other_key_types) {
+  if (key_types.size() != other_key_types.size()) return false;
+  for (size_t i = 0; i < key_types.size(); i++) {
+    if (GetKeyClass(key_types[i]) != GetKeyClass(other_key_types[i])) {
+      return false;
+    }
+  }
+  return IsSupported(key_types);
+}
+
+uint64_t FlatHashTable::MakeKey(const AbstractTuple &tuple,
+                                const std::vector<oid_t> &column_ids,
+                                char *key) const {
+  PELOTON_ASSERT(column_ids.size() == num_key_columns_);
+  char *null_flags = key + num_key_columns_ * sizeof(uint64_t);
+  PELOTON_MEMSET(null_flags, 0, key + key_size_ - null_flags);
+  for (size_t i = 0; i < num_key_columns_; i++) {
+    type::Value value = tuple.GetValue(column_ids[i]);
+    uint64_t bits = 0;
+    null_flags[i] = value.IsNull();
+    if (!value.IsNull()) {
+      bits = SerializeValue(value);
+    }
+    PELOTON_MEMCPY(key + i * sizeof(uint64_t), &bits, sizeof(bits));
+  }
+
+  uint64_t hash[2];
+  MurmurHash3_x64_128(key, static_cast<int>(key_size_), 0, hash);
+  return hash[0];
+}
+
+FlatHashTable::HashEntry *FlatHashTable::Find(uint64_t hash,
+                                              const char *key) const {
+  auto *entry = table_.FindEntry(hash, key);
+  return entry->IsFree() ? nullptr : entry;
+}
+
+char *FlatHashTable::Insert(uint64_t hash, const char *key, bool &new_key) {
+  auto *entry = table_.FindEntry(hash, key);
+  new_key = entry->IsFree();
+  char *data = table_.StoreTuple(entry, hash);
+  if (!new_key) {
+    return data;
+  }
+  PELOTON_MEMCPY(data, key, key_size_);
+  return data + key_size_;
+}
+
+char *FlatHashTable::FindOrInsert(uint64_t hash, const char *key,
+                                  bool &new_key) {
+  auto *entry = table_.FindEntry(hash, key);
+  if (!entry->IsFree()) {
+    new_key = false;
+    return table_.GetValue(entry, 0);
+  }
+  return Insert(hash, key, new_key);
+}
+
+}  // namespace executor
+}  // namespace peloton
@@ -66,12 +66,24 @@ bool HashExecutor::DExecute() {
     auto &hashkeys = node.GetHashKeys();
 
     // Construct a logical tile
+    std::vector<type::TypeId> key_types;
     for (auto &hashkey : hashkeys) {
       PELOTON_ASSERT(hashkey->GetExpressionType() == ExpressionType::VALUE_TUPLE);
       auto tuple_value =
           reinterpret_cast<const expression::TupleValueExpression *>(
               hashkey.get());
       column_ids_.push_back(tuple_value->GetColumnId());
+      key_types.push_back(tuple_value->GetValueType());
+    }
+
+    // Serialize fixed-size keys into a flat hash table
+    std::vector<char> key;
+    if (FlatHashTable::IsSupported(key_types) &&
+        (probe_key_types_.empty() ||
+         FlatHashTable::IsCompatible(key_types, probe_key_types_))) {
+      flat_hash_table_.reset(
+          new FlatHashTable(key_types, sizeof(HashLocation)));
+      key.resize(flat_hash_table_->GetKeySize());
     }
 
     // Construct the hash table by going over each child logical tile and
@@ -84,6 +96,19 @@ bool HashExecutor::DExecute() {
       if (tile->GetTupleCount() > 0) {
         output_tile_itrs_.emplace_back(child_tile_itr);
         for (oid_t tuple_id : *tile) {
+          if (flat_hash_table_ != nullptr) {
+            ContainerTuple<LogicalTile> tuple(tile, tuple_id);
+            auto hash = flat_hash_table_->MakeKey(tuple, column_ids_,
+                                                  key.data());
+            bool new_key;
+            new (flat_hash_table_->Insert(hash, key.data(), new_key))
+                HashLocation(output_tile_itrs_.size() - 1, tuple_id);
+            if (!new_key) {
+              tile->RemoveVisibility(tuple_id);
+            }
+            continue;
+          }
+
           // Key : container tuple with a subset of tuple attributes
           // Value : < child_tile offset, tuple offset >
           auto key = HashMapType::key_type(tile, tuple_id, &column_ids_);
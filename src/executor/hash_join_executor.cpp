@@ -40,6 +40,15 @@ bool HashJoinExecutor::DInit() {
 
   hash_executor_ = reinterpret_cast<HashExecutor *>(children_[1]);
 
+  // The hash table is probed with the left hash keys
+  std::vector<const expression::AbstractExpression *> left_hashed_cols;
+  GetPlanNode<planner::HashJoinPlan>().GetLeftHashKeys(left_hashed_cols);
+  std::vector<type::TypeId> left_key_types;
+  for (auto &hashkey : left_hashed_cols) {
+    left_key_types.push_back(hashkey->GetValueType());
+  }
+  hash_executor_->SetProbeKeyTypes(left_key_types);
+
   return true;
 }
 
@@ -116,18 +125,47 @@ bool HashJoinExecutor::DExecute() {
     std::unique_ptr<LogicalTile> output_tile;
     LogicalTile::PositionListsBuilder pos_lists_builder;
 
+    // Matching right tuples of the current left tuple
+    std::vector<HashExecutor::HashLocation> right_locations;
+    auto flat_hash_table = hash_executor_->GetFlatHashTable();
+    std::vector<char> key(
+        flat_hash_table != nullptr ? flat_hash_table->GetKeySize() : 0);
+
     // Go over the left tile
     for (auto left_tile_itr : *left_tile) {
       const ContainerTuple<executor::LogicalTile> left_tuple(
           left_tile, left_tile_itr, &left_hashed_col_ids);
 
       // Find matching tuples in the hash table built on top of the right table
-      auto right_tuples = hash_table.find(left_tuple);
+      right_locations.clear();
+      if (flat_hash_table != nullptr) {
+        const ContainerTuple<executor::LogicalTile> left_full_tuple(
+            left_tile, left_tile_itr);
+        auto hash = flat_hash_table->MakeKey(left_full_tuple,
+                                             left_hashed_col_ids, key.data());
+        auto entry = flat_hash_table->Find(hash, key.data());
+        if (entry != nullptr) {
+          for (uint32_t i = 0; i < flat_hash_table->NumValues(entry); i++) {
+            right_locations.push_back(
+                *reinterpret_cast<const HashExecutor::HashLocation *>(
+                    flat_hash_table->GetValue(entry, i)));
+          }
+        }
+      } else {
+        auto right_tuples = hash_table.find(left_tuple);
+        if (right_tuples != hash_table.end()) {
+          right_locations.assign(right_tuples->second.begin(),
+                                 right_tuples->second.end());
+        }
+      }
 
-      if (right_tuples != hash_table.end()) {
+      if (!right_locations.empty()) {
     	// Not yet supported due to assertion in gettomg right_tuples->first
     	if (predicate_ != nullptr) {
-    		auto eval = predicate_->Evaluate(&left_tuple, &right_tuples->first,
+          const ContainerTuple<executor::LogicalTile> right_tuple(
+              right_result_tiles_[right_locations[0].first].get(),
+              right_locations[0].second, &hash_executor_->GetHashKeyIds());
+    		auto eval = predicate_->Evaluate(&left_tuple, &right_tuple,
 					executor_context_);
 			if (eval.IsFalse())
 				continue;
@@ -136,7 +174,7 @@ bool HashJoinExecutor::DExecute() {
         RecordMatchedLeftRow(left_result_tiles_.size() - 1, left_tile_itr);
 
         // Go over the matching right tuples
-        for (auto &location : right_tuples->second) {
+        for (auto &location : right_locations) {
           // Check if we got a new right tile itr
           if (prev_tile != location.first) {
             // Check if we have any join tuples
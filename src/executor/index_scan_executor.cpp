@@ -12,6 +12,8 @@
 
 #include "executor/index_scan_executor.h"
 
+#include <utility>
+
 #include "catalog/catalog.h"
 #include "catalog/manager.h"
 #include "common/container_tuple.h"
@@ -80,6 +82,11 @@ bool IndexScanExecutor::DInit() {
   limit_offset_ = node.GetLimitOffset();
   descend_ = node.GetDescend();
 
+  // A backward scan finds the tuples at the upper bound of the range first
+  if (descend_) {
+    std::swap(left_open_, right_open_);
+  }
+
   if (runtime_keys_.size() != 0) {
     PELOTON_ASSERT(runtime_keys_.size() == values_.size());
 
@@ -164,43 +171,9 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
 
   PELOTON_ASSERT(index_->GetIndexType() == IndexConstraintType::PRIMARY_KEY);
 
-  if (0 == key_column_ids_.size()) {
-    index_->ScanAllKeys(tuple_location_ptrs);
-  } else {
-    // Limit clause accelerate
-    if (limit_) {
-      // invoke index scan limit
-      if (!descend_) {
-        LOG_TRACE("ASCENDING SCAN LIMIT in Primary Index");
-        index_->ScanLimit(values_, key_column_ids_, expr_types_,
-                          ScanDirectionType::FORWARD, tuple_location_ptrs,
-                          &index_predicate_.GetConjunctionList()[0],
-                          limit_number_, limit_offset_);
-      } else {
-        LOG_TRACE("DESCENDING SCAN LIMIT in Primary Index");
-        index_->ScanLimit(values_, key_column_ids_, expr_types_,
-                          ScanDirectionType::BACKWARD, tuple_location_ptrs,
-                          &index_predicate_.GetConjunctionList()[0],
-                          limit_number_, limit_offset_);
-
-        LOG_TRACE("1-Result size is %lu", result_.size());
-      }
-    }
-    // Normal SQL (without limit)
-    else {
-      LOG_TRACE("Index Scan in Primary Index");
-      index_->Scan(values_, key_column_ids_, expr_types_,
-                   ScanDirectionType::FORWARD, tuple_location_ptrs,
-                   &index_predicate_.GetConjunctionList()[0]);
-    }
-
-    LOG_TRACE("tuple_location_ptrs:%lu", tuple_location_ptrs.size());
-  }
-
-  if (tuple_location_ptrs.size() == 0) {
-    LOG_TRACE("no tuple is retrieved from index.");
-    return false;
-  }
+  // The index entries are pulled in batches, until the scan is exhausted or
+  // enough tuples are found to fill the limit
+  auto index_itr = GetIndexIterator();
 
   auto &transaction_manager =
       concurrency::TransactionManagerFactory::GetInstance();
@@ -214,8 +187,10 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
 #endif
 
   // for every tuple that is found in the index.
-  for (auto tuple_location_ptr : tuple_location_ptrs) {
-    ItemPointer tuple_location = *tuple_location_ptr;
+  for (size_t entry = 0; NextIndexEntry(*index_itr, tuple_location_ptrs, entry,
+                                        visible_tuple_locations);
+       entry++) {
+    ItemPointer tuple_location = *tuple_location_ptrs[entry];
     auto tile_group = storage_manager->GetTileGroup(tuple_location.block);
     auto tile_group_header = tile_group.get()->GetHeader();
     size_t chain_length = 0;
@@ -229,8 +204,17 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
     while (true) {
       ++chain_length;
 
-      auto visibility = transaction_manager.IsVisible(
-          current_txn, tile_group_header, tuple_location.offset);
+      // Tuples updated in place may have to be rebuilt from their undo
+      // records to get the version the transaction sees
+      VisibilityType visibility;
+      bool is_newest = true;
+      if (tile_group_header->HasUndoChains()) {
+        visibility =
+            ReadVersion(tile_group.get(), tuple_location.offset, is_newest);
+      } else {
+        visibility = transaction_manager.IsVisible(
+            current_txn, tile_group_header, tuple_location.offset);
+      }
 
       // if the tuple is deleted
       if (visibility == VisibilityType::DELETED) {
@@ -243,6 +227,15 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
         LOG_TRACE("perform read: %u, %u", tuple_location.block,
                   tuple_location.offset);
 
+        if (tile_group_header->HasUndoChains()) {
+          if (!SelectVisibleVersion(tile_group.get(), tuple_location,
+                                    is_newest, acquire_owner,
+                                    visible_tuple_locations)) {
+            return false;
+          }
+          break;
+        }
+
         bool eval = true;
         // if having predicate, then perform evaluation.
         if (predicate_ != nullptr) {
@@ -326,6 +319,12 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
     }
     LOG_TRACE("Traverse length: %d\n", (int)chain_length);
   }
+
+  if (visible_tuple_locations.empty()) {
+    LOG_TRACE("no tuple is retrieved from index.");
+    return false;
+  }
+
   LOG_TRACE("Examined %d tuples from index %s", num_tuples_examined,
             index_->GetName().c_str());
 
@@ -338,6 +337,13 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
   LOG_TRACE("%ld tuples after pruning boundaries",
             visible_tuple_locations.size());
 
+  // Versions of delta storage tuples are returned as copies
+  if (table_->UsesDeltaStorage() && !for_write_) {
+    BuildVersionResult(visible_tuple_locations);
+    done_ = true;
+    return true;
+  }
+
   // Add the tuple locations to the result vector in the order returned by
   // the index scan. We might end up reading the same tile group multiple
   // times. However, this is necessary to adhere to the ORDER BY clause
@@ -401,43 +407,9 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
   // Grab info from plan node
   bool acquire_owner = GetPlanNode<planner::AbstractScan>().IsForUpdate();
 
-  if (0 == key_column_ids_.size()) {
-    index_->ScanAllKeys(tuple_location_ptrs);
-  } else {
-    // Limit clause accelerate
-    if (limit_) {
-      // invoke index scan limit
-      if (!descend_) {
-        LOG_TRACE("ASCENDING SCAN LIMIT in Secondary Index");
-        index_->ScanLimit(values_, key_column_ids_, expr_types_,
-                          ScanDirectionType::FORWARD, tuple_location_ptrs,
-                          &index_predicate_.GetConjunctionList()[0],
-                          limit_number_, limit_offset_);
-      } else {
-        LOG_TRACE("DESCENDING SCAN LIMIT in Secondary Index");
-        index_->ScanLimit(values_, key_column_ids_, expr_types_,
-                          ScanDirectionType::BACKWARD, tuple_location_ptrs,
-                          &index_predicate_.GetConjunctionList()[0],
-                          limit_number_, limit_offset_);
-
-        if (tuple_location_ptrs.size() == 0) {
-          LOG_TRACE("2-Result size is %lu", tuple_location_ptrs.size());
-        }
-      }
-    }
-    // Normal SQL (without limit)
-    else {
-      LOG_TRACE("Index Scan in Primary Index");
-      index_->Scan(values_, key_column_ids_, expr_types_,
-                   ScanDirectionType::FORWARD, tuple_location_ptrs,
-                   &index_predicate_.GetConjunctionList()[0]);
-    }
-  }
-
-  if (tuple_location_ptrs.size() == 0) {
-    LOG_TRACE("no tuple is retrieved from index.");
-    return false;
-  }
+  // The index entries are pulled in batches, until the scan is exhausted or
+  // enough tuples are found to fill the limit
+  auto index_itr = GetIndexIterator();
 
   auto &transaction_manager =
       concurrency::TransactionManagerFactory::GetInstance();
@@ -460,8 +432,10 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
   int num_blocks_reused = 0;
 #endif
   auto storage_manager = storage::StorageManager::GetInstance();
-  for (auto tuple_location_ptr : tuple_location_ptrs) {
-    ItemPointer tuple_location = *tuple_location_ptr;
+  for (size_t entry = 0; NextIndexEntry(*index_itr, tuple_location_ptrs, entry,
+                                        visible_tuple_locations);
+       entry++) {
+    ItemPointer tuple_location = *tuple_location_ptrs[entry];
     if (tuple_location.block != last_block) {
       tile_group = storage_manager->GetTileGroup(tuple_location.block);
       tile_group_header = tile_group.get()->GetHeader();
@@ -482,8 +456,17 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
     while (true) {
       ++chain_length;
 
-      auto visibility = transaction_manager.IsVisible(
-          current_txn, tile_group_header, tuple_location.offset);
+      // Tuples updated in place may have to be rebuilt from their undo
+      // records to get the version the transaction sees
+      VisibilityType visibility;
+      bool is_newest = true;
+      if (tile_group_header->HasUndoChains()) {
+        visibility =
+            ReadVersion(tile_group.get(), tuple_location.offset, is_newest);
+      } else {
+        visibility = transaction_manager.IsVisible(
+            current_txn, tile_group_header, tuple_location.offset);
+      }
 
       // if the tuple is deleted
       if (visibility == VisibilityType::DELETED) {
@@ -514,6 +497,17 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
           break;
         }
 
+        // Key columns are never updated in place, so the slot holds the
+        // key of the version
+        if (tile_group_header->HasUndoChains()) {
+          if (!SelectVisibleVersion(tile_group.get(), tuple_location,
+                                    is_newest, acquire_owner,
+                                    visible_tuple_locations)) {
+            return false;
+          }
+          break;
+        }
+
         bool eval = true;
         // if having predicate, then perform evaluation.
         if (predicate_ != nullptr) {
@@ -599,12 +593,25 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
     }
     LOG_TRACE("Traverse length: %d\n", (int)chain_length);
   }
+
+  if (visible_tuple_locations.empty()) {
+    LOG_TRACE("no tuple is retrieved from index.");
+    return false;
+  }
+
   LOG_TRACE("Examined %d tuples from index %s [num_blocks_reused=%d]",
             num_tuples_examined, index_->GetName().c_str(), num_blocks_reused);
 
   // Check whether the boundaries satisfy the required condition
   CheckOpenRangeWithReturnedTuples(visible_tuple_locations);
 
+  // Versions of delta storage tuples are returned as copies
+  if (table_->UsesDeltaStorage() && !for_write_) {
+    BuildVersionResult(visible_tuple_locations);
+    done_ = true;
+    return true;
+  }
+
   // Add the tuple locations to the result vector in the order returned by
   // the index scan. We might end up reading the same tile group multiple
   // times. However, this is necessary to adhere to the ORDER BY clause
@@ -657,6 +664,113 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
   return true;
 }
 
+bool IndexScanExecutor::SelectVisibleVersion(
+    storage::TileGroup *tile_group, const ItemPointer &tuple_location,
+    bool is_newest, bool acquire_owner,
+    std::vector<ItemPointer> &tuple_locations) {
+  bool selected;
+  if (!SelectVersion(tile_group, tuple_location.offset, is_newest,
+                     acquire_owner, selected)) {
+    return false;
+  }
+  if (selected) {
+    tuple_locations.push_back(tuple_location);
+    if (!for_write_) {
+      auto &column_ids = GetOutputColumnIds();
+      version_rows_[tuple_location] =
+          version_values_.size() / column_ids.size();
+      AddVersion(column_ids);
+    }
+  }
+  return true;
+}
+
+void IndexScanExecutor::BuildVersionResult(
+    const std::vector<ItemPointer> &tuple_locations) {
+  std::vector<size_t> rows;
+  for (auto &tuple_location : tuple_locations) {
+    rows.push_back(version_rows_[tuple_location]);
+  }
+  if (!rows.empty()) {
+    result_.push_back(BuildVersionTile(table_, GetOutputColumnIds(), rows));
+  }
+  version_rows_.clear();
+  version_values_.clear();
+}
+
+std::unique_ptr<index::IndexIterator> IndexScanExecutor::GetIndexIterator() {
+  auto scan_direction =
+      descend_ ? ScanDirectionType::BACKWARD : ScanDirectionType::FORWARD;
+
+  // Without key columns the whole index is scanned
+  if (key_column_ids_.size() == 0) {
+    LOG_TRACE("Full scan of index %s", index_->GetName().c_str());
+    return index_->GetIterator(scan_direction, nullptr);
+  }
+
+  LOG_TRACE("Range scan of index %s (descending: %d)",
+            index_->GetName().c_str(), descend_);
+  return index_->GetIterator(scan_direction,
+                             &index_predicate_.GetConjunctionList()[0]);
+}
+
+bool IndexScanExecutor::IsLimitReached(
+    const std::vector<ItemPointer> &tuple_locations) const {
+  // The offset is applied by the limit above the scan, so the tuples that it
+  // skips have to be produced as well
+  return limit_ && tuple_locations.size() >=
+                       static_cast<size_t>(limit_number_ + limit_offset_);
+}
+
+size_t IndexScanExecutor::GetIndexBatchSize(
+    const std::vector<ItemPointer> &tuple_locations) const {
+  if (!limit_) {
+    return INDEX_SCAN_BATCH_SIZE;
+  }
+  PELOTON_ASSERT(!IsLimitReached(tuple_locations));
+  return static_cast<size_t>(limit_number_ + limit_offset_) -
+         tuple_locations.size();
+}
+
+bool IndexScanExecutor::NextIndexEntry(
+    index::IndexIterator &index_itr,
+    std::vector<ItemPointer *> &tuple_location_ptrs, size_t &entry,
+    std::vector<ItemPointer> &tuple_locations) {
+  if (entry < tuple_location_ptrs.size()) {
+    return true;
+  }
+
+  // Tuples outside an open bound can only be the first ones of the scan
+  PruneLeadingOpenRange(tuple_locations);
+  tuple_location_ptrs.clear();
+  entry = 0;
+
+  if (IsLimitReached(tuple_locations)) {
+    return false;
+  }
+  auto entry_count =
+      index_itr.Next(tuple_location_ptrs, GetIndexBatchSize(tuple_locations));
+  LOG_TRACE("tuple_location_ptrs:%lu", entry_count);
+  return entry_count > 0;
+}
+
+void IndexScanExecutor::PruneLeadingOpenRange(
+    std::vector<ItemPointer> &tuple_locations) {
+  if (!left_open_) return;
+
+  auto tuple_location_itr = tuple_locations.begin();
+  while (tuple_location_itr != tuple_locations.end() &&
+         CheckKeyConditions(*tuple_location_itr) == false) {
+    tuple_location_itr++;
+  }
+  tuple_locations.erase(tuple_locations.begin(), tuple_location_itr);
+
+  // The tuples after the first one in the range are in the range as well
+  if (!tuple_locations.empty()) {
+    left_open_ = false;
+  }
+}
+
 void IndexScanExecutor::CheckOpenRangeWithReturnedTuples(
     std::vector<ItemPointer> &tuple_locations) {
   while (left_open_) {
@@ -864,6 +978,10 @@ void IndexScanExecutor::UpdatePredicate(
 void IndexScanExecutor::ResetState() {
   result_.clear();
 
+  version_rows_.clear();
+
+  version_values_.clear();
+
   result_itr_ = START_OID;
 
   done_ = false;
@@ -873,6 +991,10 @@ void IndexScanExecutor::ResetState() {
   left_open_ = node.GetLeftOpen();
 
   right_open_ = node.GetRightOpen();
+
+  if (descend_) {
+    std::swap(left_open_, right_open_);
+  }
 }
 
 }  // namespace executor
@@ -16,6 +16,7 @@
 #include "common/logger.h"
 #include "common/macros.h"
 #include "planner/materialization_plan.h"
+#include "executor/executor_context.h"
 #include "executor/logical_tile.h"
 #include "executor/logical_tile_factory.h"
 #include "storage/tuple.h"
@@ -327,9 +328,23 @@ LogicalTile *MaterializationExecutor::Physify(LogicalTile *source_tile) {
   std::unordered_map<storage::Tile *, std::vector<oid_t>> tile_to_cols;
   GenerateTileToColMap(old_to_new_cols, source_tile, tile_to_cols);
 
-  // Create new physical tile.
-  std::shared_ptr<storage::Tile> dest_tile(
-      storage::TileFactory::GetTempTile(*output_schema, num_tuples));
+  // Create new physical tile. Its memory counts towards the query until the
+  // last logical tile that refers to it is gone.
+  storage::Tile *tile =
+      storage::TileFactory::GetTempTile(*output_schema, num_tuples);
+  std::shared_ptr<storage::Tile> dest_tile;
+  if (executor_context_ != nullptr) {
+    std::shared_ptr<MemoryTracker> tracker =
+        executor_context_->GetMemoryTracker();
+    uint64_t tile_size = tile->GetInlinedSize();
+    tracker->Reserve(tile_size);
+    dest_tile.reset(tile, [tracker, tile_size](storage::Tile *materialized) {
+      delete materialized;
+      tracker->Release(tile_size);
+    });
+  } else {
+    dest_tile.reset(tile);
+  }
 
   // Proceed to materialize logical tile by physical tile at a time.
   MaterializeByTiles(source_tile, old_to_new_cols, tile_to_cols,
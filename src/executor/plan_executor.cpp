@@ -20,6 +20,8 @@
 #include "concurrency/transaction_manager_factory.h"
 #include "executor/executor_context.h"
 #include "executor/executors.h"
+#include "optimizer/stats/cardinality_feedback.h"
+#include "planner/abstract_scan_plan.h"
 #include "settings/settings_manager.h"
 #include "storage/tuple_iterator.h"
 
@@ -32,12 +34,56 @@ executor::AbstractExecutor *BuildExecutorTree(
 
 void CleanExecutorTree(executor::AbstractExecutor *root);
 
+/**
+ * @brief Feed the number of rows a scan with a cardinality feedback key
+ * produced back to the optimizer
+ */
+static void RecordScanCardinality(const planner::AbstractPlan *plan,
+                                  size_t actual_rows) {
+  if (plan->GetCardinalityFeedbackKey().empty()) return;
+  auto *table = static_cast<const planner::AbstractScan *>(plan)->GetTable();
+  if (table == nullptr) return;
+  optimizer::CardinalityFeedback::GetInstance()->RecordCardinality(
+      plan->GetCardinalityFeedbackKey(), actual_rows, table->GetTupleCount());
+}
+
+/**
+ * @brief Collect the number of rows each executor produced.
+ * @param executor The root of the executor tree
+ * @param rescanned Were the executors run more than once, like the inner side
+ * of a nested loop join? The counts of those do not reflect the selectivity
+ * of their predicates.
+ * @param feedback Record the rows produced by scans for the optimizer
+ * @param actual_rows If not null, filled with the rows produced per plan node
+ */
+static void CollectActualRows(const executor::AbstractExecutor *executor,
+                              bool rescanned, bool feedback,
+                              PlanActualRows *actual_rows) {
+  if (actual_rows != nullptr) {
+    (*actual_rows)[executor->GetRawNode()] = executor->GetNumOutputTuples();
+  }
+  // Scans that were stopped early, e.g. by a limit, did not see all the rows
+  // matching their predicates
+  if (feedback && !rescanned && executor->IsExhausted()) {
+    RecordScanCardinality(executor->GetRawNode(),
+                          executor->GetNumOutputTuples());
+  }
+  auto &children = executor->GetChildren();
+  for (size_t i = 0; i < children.size(); i++) {
+    bool child_rescanned =
+        rescanned || (i == 1 && executor->GetRawNode()->GetPlanNodeType() ==
+                                    PlanNodeType::NESTLOOP);
+    CollectActualRows(children[i], child_rescanned, feedback, actual_rows);
+  }
+}
+
 static void CompileAndExecutePlan(
     std::shared_ptr<planner::AbstractPlan> plan,
     concurrency::TransactionContext *txn,
     const std::vector<type::Value> &params,
     std::function<void(executor::ExecutionResult, std::vector<ResultValue> &&)>
-        on_complete) {
+        on_complete,
+    MemoryTracker *memory_tracker) {
   LOG_TRACE("Compiling and executing query ...");
 
   // Perform binding
@@ -51,7 +97,7 @@ static void CompileAndExecutePlan(
 
   // The executor context for this execution
   executor::ExecutorContext executor_context{
-      txn, codegen::QueryParameters(*plan, params)};
+      txn, codegen::QueryParameters(*plan, params), memory_tracker};
 
   // Check if we have a cached compiled plan already
   codegen::Query *query = codegen::QueryCache::Instance().Find(plan);
@@ -71,6 +117,13 @@ static void CompileAndExecutePlan(
   // Execute the query!
   query->Execute(executor_context, consumer);
 
+  // The operators of the plan are fused, so only the rows of a scan at the
+  // root of the plan can be counted
+  if (settings::SettingsManager::GetBool(
+          settings::SettingId::cardinality_feedback)) {
+    RecordScanCardinality(plan.get(), consumer.GetOutputTuples().size());
+  }
+
   // Execution complete, setup the results
   executor::ExecutionResult result;
   result.m_processed = executor_context.num_processed;
@@ -98,12 +151,13 @@ static void InterpretPlan(
     const std::vector<type::Value> &params,
     const std::vector<int> &result_format,
     std::function<void(executor::ExecutionResult, std::vector<ResultValue> &&)>
-        on_complete) {
+        on_complete,
+    PlanActualRows *actual_rows, MemoryTracker *memory_tracker) {
   executor::ExecutionResult result;
   std::vector<ResultValue> values;
 
   std::unique_ptr<executor::ExecutorContext> executor_context(
-      new executor::ExecutorContext(txn, params));
+      new executor::ExecutorContext(txn, params, memory_tracker));
 
   bool status;
   std::unique_ptr<executor::AbstractExecutor> executor_tree(
@@ -143,6 +197,11 @@ static void InterpretPlan(
 
   result.m_processed = executor_context->num_processed;
   result.m_result = ResultType::SUCCESS;
+  bool feedback = settings::SettingsManager::GetBool(
+      settings::SettingId::cardinality_feedback);
+  if (feedback || actual_rows != nullptr) {
+    CollectActualRows(executor_tree.get(), false, feedback, actual_rows);
+  }
   CleanExecutorTree(executor_tree.get());
   plan->ClearParameterValues();
   on_complete(result, std::move(values));
@@ -154,18 +213,23 @@ void PlanExecutor::ExecutePlan(
     const std::vector<type::Value> &params,
     const std::vector<int> &result_format,
     std::function<void(executor::ExecutionResult, std::vector<ResultValue> &&)>
-        on_complete) {
+        on_complete,
+    PlanActualRows *actual_rows, MemoryTracker *memory_tracker) {
   PELOTON_ASSERT(plan != nullptr && txn != nullptr);
   LOG_TRACE("PlanExecutor Start (Txn ID=%" PRId64 ")", txn->GetTransactionId());
 
+  // The operators of compiled plans are fused, so only interpreted plans can
+  // report the rows of each plan node
   bool codegen_enabled =
-      settings::SettingsManager::GetBool(settings::SettingId::codegen);
+      settings::SettingsManager::GetBool(settings::SettingId::codegen) &&
+      actual_rows == nullptr;
 
   try {
     if (codegen_enabled && codegen::QueryCompiler::IsSupported(*plan)) {
-      CompileAndExecutePlan(plan, txn, params, on_complete);
+      CompileAndExecutePlan(plan, txn, params, on_complete, memory_tracker);
     } else {
-      InterpretPlan(plan, txn, params, result_format, on_complete);
+      InterpretPlan(plan, txn, params, result_format, on_complete,
+                    actual_rows, memory_tracker);
     }
   } catch (Exception &e) {
     ExecutionResult result;
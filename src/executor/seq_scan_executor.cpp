@@ -22,6 +22,7 @@
 #include "expression/conjunction_expression.h"
 #include "expression/constant_value_expression.h"
 #include "expression/comparison_expression.h"
+#include "expression/batch_expression_evaluator.h"
 #include "common/container_tuple.h"
 #include "planner/create_plan.h"
 #include "storage/data_table.h"
@@ -59,6 +60,9 @@ bool SeqScanExecutor::DInit() {
 
   old_predicate_ = predicate_;
 
+  batch_predicate_ = expression::BatchExpressionEvaluator::Create(
+      predicate_, executor_context_);
+
   if (target_table_ != nullptr) {
     table_tile_group_count_ = target_table_->GetTileGroupCount();
 
@@ -95,7 +99,19 @@ bool SeqScanExecutor::DExecute() {
     while (children_[0]->Execute()) {
       std::unique_ptr<LogicalTile> tile(children_[0]->GetOutput());
 
-      if (predicate_ != nullptr) {
+      if (predicate_ != nullptr && batch_predicate_ != nullptr) {
+        // Evaluate the predicate on all tuples of the tile at once. Like
+        // below, only tuples the predicate is FALSE for are invalidated.
+        std::vector<oid_t> visible_tuples(tile->begin(), tile->end());
+        std::vector<oid_t> selected_tuples(visible_tuples);
+        if (batch_predicate_->Filter(tile.get(), selected_tuples, true)) {
+          RemoveUnselected(tile.get(), visible_tuples, selected_tuples);
+        } else {
+          batch_predicate_.reset();
+        }
+      }
+
+      if (predicate_ != nullptr && batch_predicate_ == nullptr) {
         // Invalidate tuples that don't satisfy the predicate.
         for (oid_t tuple_id : *tile) {
           ContainerTuple<LogicalTile> tuple(tile.get(), tuple_id);
@@ -158,10 +174,86 @@ bool SeqScanExecutor::DExecute() {
 
       oid_t active_tuple_count = tile_group->GetNextTupleSlot();
 
+      // Tuples updated in place keep their old versions in undo records, so
+      // the visible version has to be rebuilt before the predicate is
+      // evaluated on it
+      if (tile_group_header->HasUndoChains()) {
+        std::vector<oid_t> position_list;
+        for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
+          bool is_newest, selected;
+          if (ReadVersion(tile_group.get(), tuple_id, is_newest) !=
+              VisibilityType::OK) {
+            continue;
+          }
+          if (!SelectVersion(tile_group.get(), tuple_id, is_newest,
+                             acquire_owner, selected)) {
+            return false;
+          }
+          if (selected) {
+            position_list.push_back(tuple_id);
+            if (!for_write_) AddVersion(column_ids_);
+          }
+        }
+
+        if (position_list.size() == 0) {
+          continue;
+        }
+
+        // Updates and deletes work on the tuple slots, everyone else gets
+        // copies of the versions they see
+        if (for_write_) {
+          std::unique_ptr<LogicalTile> logical_tile(
+              LogicalTileFactory::GetTile());
+          logical_tile->AddColumns(tile_group, column_ids_);
+          logical_tile->AddPositionList(std::move(position_list));
+          SetOutput(logical_tile.release());
+        } else {
+          std::vector<size_t> rows(position_list.size());
+          for (size_t row = 0; row < rows.size(); row++) rows[row] = row;
+          SetOutput(BuildVersionTile(target_table_, column_ids_, rows));
+          version_values_.clear();
+        }
+        return true;
+      }
+
       // Construct position list by looping through tile group
       // and applying the predicate.
       std::vector<oid_t> position_list;
-      for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
+      bool batch_evaluated = false;
+
+      if (predicate_ != nullptr && batch_predicate_ != nullptr) {
+        // Collect the visible tuples and evaluate the predicate on all of
+        // them at once
+        for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
+          auto visibility = transaction_manager.IsVisible(
+              current_txn, tile_group_header, tuple_id);
+          if (visibility == VisibilityType::OK) {
+            position_list.push_back(tuple_id);
+          }
+        }
+
+        if (batch_predicate_->Filter(tile_group.get(), position_list,
+                                     false)) {
+          for (auto tuple_id : position_list) {
+            ItemPointer location(tile_group->GetTileGroupId(), tuple_id);
+            auto res = transaction_manager.PerformRead(
+                current_txn, location, tile_group_header, acquire_owner);
+            if (!res) {
+              transaction_manager.SetTransactionResult(current_txn,
+                                                       ResultType::FAILURE);
+              return res;
+            }
+          }
+          batch_evaluated = true;
+        } else {
+          // Fall back to evaluating the predicate one tuple at a time
+          batch_predicate_.reset();
+          position_list.clear();
+        }
+      }
+
+      for (oid_t tuple_id = 0;
+           !batch_evaluated && tuple_id < active_tuple_count; tuple_id++) {
         ItemPointer location(tile_group->GetTileGroupId(), tuple_id);
 
         auto visibility = transaction_manager.IsVisible(
@@ -258,6 +350,24 @@ void SeqScanExecutor::UpdatePredicate(const std::vector<oid_t> &column_ids,
   // we should eventually make prediate_ a unique_ptr
   new_predicate_.reset(new_predicate);
   predicate_ = new_predicate;
+  batch_predicate_ = expression::BatchExpressionEvaluator::Create(
+      predicate_, executor_context_);
+}
+
+// Invalidate the visible tuples of the tile that are not selected. Both lists
+// are in the order of the tile's iterator.
+void SeqScanExecutor::RemoveUnselected(
+    LogicalTile *tile, const std::vector<oid_t> &visible_tuples,
+    const std::vector<oid_t> &selected_tuples) {
+  size_t selected_idx = 0;
+  for (auto tuple_id : visible_tuples) {
+    if (selected_idx < selected_tuples.size() &&
+        selected_tuples[selected_idx] == tuple_id) {
+      selected_idx++;
+    } else {
+      tile->RemoveVisibility(tuple_id);
+    }
+  }
 }
 
 // Transfer a list of equality predicate
@@ -14,6 +14,7 @@
 #include "planner/update_plan.h"
 #include "common/logger.h"
 #include "catalog/manager.h"
+#include "executor/abstract_scan_executor.h"
 #include "executor/logical_tile.h"
 #include "executor/executor_context.h"
 #include "common/container_tuple.h"
@@ -54,6 +55,34 @@ bool UpdateExecutor::DInit() {
 
   statement_write_set_.clear();
 
+  // the columns that are computed, or copied from another column
+  update_columns_.clear();
+  for (auto &target : project_info_->GetTargetList()) {
+    update_columns_.push_back(target.first);
+  }
+  for (auto &direct_map : project_info_->GetDirectMapList()) {
+    if (direct_map.first != direct_map.second.second) {
+      update_columns_.push_back(direct_map.first);
+    }
+  }
+
+  // row triggers get the old and the new tuple, so they keep the new version
+  // separate from the old one
+  trigger::TriggerList *trigger_list = target_table_->GetTriggerList();
+  bool has_row_triggers =
+      trigger_list != nullptr &&
+      (trigger_list->HasTriggerType(TriggerType::AFTER_UPDATE_ROW) ||
+       trigger_list->HasTriggerType(TriggerType::ON_COMMIT_UPDATE_ROW));
+  update_in_place_ =
+      !has_row_triggers && target_table_->CanUpdateInPlace(update_columns_);
+
+  // the tuples to update are written where the scan found them, so the scan
+  // must return their positions rather than copies of the visible versions
+  auto scan_executor = dynamic_cast<AbstractScanExecutor *>(children_[0]);
+  if (scan_executor != nullptr) {
+    scan_executor->SetForWrite(true);
+  }
+
   return true;
 }
 
@@ -143,6 +172,52 @@ bool UpdateExecutor::PerformUpdatePrimaryKey(
   return true;
 }
 
+bool UpdateExecutor::PerformUpdateInPlace(
+    bool is_owner, storage::TileGroup *tile_group,
+    storage::TileGroupHeader *tile_group_header, oid_t physical_tuple_id,
+    ItemPointer &old_location) {
+  auto &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+
+  auto current_txn = executor_context_->GetTransaction();
+
+  // the slot holds the newest version of the tuple, which may have been
+  // committed after the current transaction started. it must not be
+  // overwritten then, just like an older version cannot be updated.
+  cid_t begin_cid = tile_group_header->GetBeginCommitId(physical_tuple_id);
+  cid_t txn_cid =
+      current_txn->GetIsolationLevel() == IsolationLevelType::SNAPSHOT
+          ? current_txn->GetCommitId()
+          : current_txn->GetReadId();
+
+  storage::Tuple new_tuple(target_table_->GetSchema(), true);
+  bool ret = begin_cid == MAX_CID || begin_cid <= txn_cid;
+  if (ret == true) {
+    ContainerTuple<storage::TileGroup> old_tuple(tile_group,
+                                                 physical_tuple_id);
+    project_info_->Evaluate(&new_tuple, &old_tuple, nullptr,
+                            executor_context_);
+    ret = target_table_->CheckInPlaceVersion(&new_tuple);
+  }
+
+  if (ret == false) {
+    LOG_TRACE("Fail to update tuple in place. Set txn failure.");
+    if (is_owner == false) {
+      // If the ownership is acquire inside this update executor, we
+      // release it here
+      transaction_manager.YieldOwnership(current_txn, tile_group_header,
+                                         physical_tuple_id);
+    }
+    transaction_manager.SetTransactionResult(current_txn, ResultType::FAILURE);
+    return false;
+  }
+
+  transaction_manager.PerformUpdate(current_txn, old_location, &new_tuple,
+                                    update_columns_);
+  statement_write_set_.insert(old_location);
+  return true;
+}
+
 /**
  * @brief updates a set of columns
  * @return true on success, false otherwise.
@@ -258,6 +333,13 @@ bool UpdateExecutor::DExecute() {
           return false;
         }
       }
+      // Normal update of a tuple that was updated in place before
+      else if (tile_group_header->HasUndoChains()) {
+        if (PerformUpdateInPlace(is_owner, tile_group, tile_group_header,
+                                 physical_tuple_id, old_location) == false) {
+          return false;
+        }
+      }
       // Normal update (no primary key)
       else {
         // We have already owned a version
@@ -312,6 +394,17 @@ bool UpdateExecutor::DExecute() {
           }
         }
 
+        // Normal update that changes the tuple in place
+        else if (update_in_place_ && tile_group_header->HasUndoChains()) {
+          ret = PerformUpdateInPlace(is_owner, tile_group, tile_group_header,
+                                     physical_tuple_id, old_location);
+          if (ret == true) {
+            executor_context_->num_processed += 1;  // updated one
+          } else {
+            return false;
+          }
+        }
+
         // Normal update (no primary key)
         else {
           // if it is the latest version and not locked by other threads, then
@@ -0,0 +1,709 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// batch_expression_evaluator.cpp
+//
+// Identification: src/expression/batch_expression_evaluator.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "expression/batch_expression_evaluator.h"
+
+#include <functional>
+#include <limits>
+
+#include "catalog/schema.h"
+#include "common/exception.h"
+#include "executor/executor_context.h"
+#include "executor/logical_tile.h"
+#include "expression/abstract_expression.h"
+#include "expression/constant_value_expression.h"
+#include "expression/parameter_value_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "storage/layout.h"
+#include "storage/tile.h"
+#include "storage/tile_group.h"
+#include "type/value.h"
+
+namespace peloton {
+namespace expression {
+
+//===----------------------------------------------------------------------===//
+// Batch vectors
+//===----------------------------------------------------------------------===//
+
+/**
+ * The values of an expression for the tuples of a batch. Integers of every
+ * width and booleans are kept as int64_t, decimals as double.
+ */
+struct BatchVector {
+  // One of the integer types, DECIMAL or BOOLEAN
+  type::TypeId type = type::TypeId::INVALID;
+  std::vector<int64_t> integers;
+  std::vector<double> decimals;
+  std::vector<uint8_t> nulls;
+
+  void Reset(type::TypeId value_type, size_t size) {
+    type = value_type;
+    nulls.assign(size, 0);
+    if (IsDecimal()) {
+      decimals.resize(size);
+    } else {
+      integers.resize(size);
+    }
+  }
+
+  bool IsDecimal() const { return type == type::TypeId::DECIMAL; }
+
+  size_t Size() const { return nulls.size(); }
+
+  // Widen integers to decimals to operate on them together with decimals
+  void CastToDecimal() {
+    if (IsDecimal()) return;
+    decimals.assign(integers.begin(), integers.end());
+    type = type::TypeId::DECIMAL;
+  }
+};
+
+namespace {
+
+bool IsInteger(type::TypeId type) {
+  return type == type::TypeId::TINYINT || type == type::TypeId::SMALLINT ||
+         type == type::TypeId::INTEGER || type == type::TypeId::BIGINT;
+}
+
+bool IsNumeric(type::TypeId type) {
+  return IsInteger(type) || type == type::TypeId::DECIMAL;
+}
+
+// The range of an integer type. Its minimum is the NULL of the type.
+void GetIntegerRange(type::TypeId type, int64_t &min, int64_t &max) {
+  switch (type) {
+    case type::TypeId::TINYINT:
+      min = std::numeric_limits<int8_t>::min();
+      max = std::numeric_limits<int8_t>::max();
+      break;
+    case type::TypeId::SMALLINT:
+      min = std::numeric_limits<int16_t>::min();
+      max = std::numeric_limits<int16_t>::max();
+      break;
+    case type::TypeId::INTEGER:
+      min = std::numeric_limits<int32_t>::min();
+      max = std::numeric_limits<int32_t>::max();
+      break;
+    default:
+      min = std::numeric_limits<int64_t>::min();
+      max = std::numeric_limits<int64_t>::max();
+      break;
+  }
+}
+
+void ThrowOutOfRange() {
+  throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
+}
+
+void ThrowDivideByZero() {
+  throw Exception(ExceptionType::DIVIDE_BY_ZERO,
+                  "Division by zero on right-hand side");
+}
+
+//===----------------------------------------------------------------------===//
+// Column readers
+//===----------------------------------------------------------------------===//
+
+inline void StoreValue(BatchVector &result, size_t idx, int64_t value) {
+  result.integers[idx] = value;
+}
+
+inline void StoreValue(BatchVector &result, size_t idx, double value) {
+  result.decimals[idx] = value;
+}
+
+// Read a fixed-size column straight out of the tile. A tuple offset of
+// NULL_OID is the NULL row of an outer join.
+template <typename NativeType, typename StorageType>
+void ReadValues(const storage::Tile *tile, size_t column_offset,
+                NativeType null_value, const std::vector<oid_t> *positions,
+                const std::vector<oid_t> &rows, BatchVector &result) {
+  for (size_t idx = 0; idx < rows.size(); idx++) {
+    oid_t tuple_offset =
+        positions == nullptr ? rows[idx] : (*positions)[rows[idx]];
+    if (tuple_offset == NULL_OID) {
+      result.nulls[idx] = 1;
+      continue;
+    }
+    NativeType value;
+    PELOTON_MEMCPY(&value, tile->GetTupleLocation(tuple_offset) + column_offset,
+                   sizeof(NativeType));
+    if (value == null_value) {
+      result.nulls[idx] = 1;
+    } else {
+      StoreValue(result, idx, static_cast<StorageType>(value));
+    }
+  }
+}
+
+bool ReadTileColumn(const storage::Tile *tile, oid_t tile_column_id,
+                    const std::vector<oid_t> *positions,
+                    const std::vector<oid_t> &rows, BatchVector &result) {
+  const catalog::Schema *schema = tile->GetSchema();
+  auto column_type = schema->GetType(tile_column_id);
+  if (!IsNumeric(column_type)) return false;
+
+  size_t column_offset = schema->GetOffset(tile_column_id);
+  result.Reset(column_type, rows.size());
+  switch (column_type) {
+    case type::TypeId::TINYINT:
+      ReadValues<int8_t, int64_t>(tile, column_offset, type::PELOTON_INT8_NULL,
+                                  positions, rows, result);
+      break;
+    case type::TypeId::SMALLINT:
+      ReadValues<int16_t, int64_t>(tile, column_offset,
+                                   type::PELOTON_INT16_NULL, positions, rows,
+                                   result);
+      break;
+    case type::TypeId::INTEGER:
+      ReadValues<int32_t, int64_t>(tile, column_offset,
+                                   type::PELOTON_INT32_NULL, positions, rows,
+                                   result);
+      break;
+    case type::TypeId::BIGINT:
+      ReadValues<int64_t, int64_t>(tile, column_offset,
+                                   type::PELOTON_INT64_NULL, positions, rows,
+                                   result);
+      break;
+    default:
+      ReadValues<double, double>(tile, column_offset,
+                                 type::PELOTON_DECIMAL_NULL, positions, rows,
+                                 result);
+      break;
+  }
+  return true;
+}
+
+}  // namespace
+
+/**
+ * Where the columns of the tuples of a batch come from
+ */
+class BatchColumnSource {
+ public:
+  virtual ~BatchColumnSource() {}
+
+  // Read the values of the column for the given tuples. Returns false if the
+  // column can't be read in batches.
+  virtual bool ReadColumn(oid_t column_id, const std::vector<oid_t> &rows,
+                          BatchVector &result) const = 0;
+};
+
+namespace {
+
+class LogicalTileSource : public BatchColumnSource {
+ public:
+  explicit LogicalTileSource(executor::LogicalTile *tile) : tile_(tile) {}
+
+  bool ReadColumn(oid_t column_id, const std::vector<oid_t> &rows,
+                  BatchVector &result) const override {
+    if (column_id >= tile_->GetColumnCount()) return false;
+    const auto &column_info = tile_->GetColumnInfo(column_id);
+    return ReadTileColumn(column_info.base_tile.get(),
+                          column_info.origin_column_id,
+                          &tile_->GetPositionList(column_info.position_list_idx),
+                          rows, result);
+  }
+
+ private:
+  executor::LogicalTile *tile_;
+};
+
+class TileGroupSource : public BatchColumnSource {
+ public:
+  explicit TileGroupSource(storage::TileGroup *tile_group)
+      : tile_group_(tile_group) {}
+
+  bool ReadColumn(oid_t column_id, const std::vector<oid_t> &rows,
+                  BatchVector &result) const override {
+    if (column_id >= tile_group_->GetLayout().GetColumnCount()) return false;
+    oid_t tile_offset, tile_column_id;
+    tile_group_->GetLayout().LocateTileAndColumn(column_id, tile_offset,
+                                                 tile_column_id);
+    return ReadTileColumn(tile_group_->GetTile(tile_offset), tile_column_id,
+                          nullptr, rows, result);
+  }
+
+ private:
+  storage::TileGroup *tile_group_;
+};
+
+}  // namespace
+
+//===----------------------------------------------------------------------===//
+// Nodes
+//===----------------------------------------------------------------------===//
+
+class BatchExpressionEvaluator::Node {
+ public:
+  explicit Node(type::TypeId value_type) : value_type_(value_type) {}
+
+  virtual ~Node() {}
+
+  /**
+   * Evaluate the expression for the given tuples of the source. Entry i of the
+   * result is the value for rows[i]. Returns false if a column can't be read
+   * in batches.
+   */
+  virtual bool Evaluate(const BatchColumnSource &source,
+                        const std::vector<oid_t> &rows,
+                        BatchVector &result) const = 0;
+
+  // The type of the values, DECIMAL or BOOLEAN, or an integer type if the
+  // values are integers of any width
+  type::TypeId GetValueType() const { return value_type_; }
+
+ private:
+  type::TypeId value_type_;
+};
+
+namespace {
+
+using Node = BatchExpressionEvaluator::Node;
+
+class ColumnNode : public Node {
+ public:
+  ColumnNode(type::TypeId value_type, oid_t column_id)
+      : Node(value_type), column_id_(column_id) {}
+
+  bool Evaluate(const BatchColumnSource &source, const std::vector<oid_t> &rows,
+                BatchVector &result) const override {
+    return source.ReadColumn(column_id_, rows, result);
+  }
+
+ private:
+  oid_t column_id_;
+};
+
+class ConstantNode : public Node {
+ public:
+  explicit ConstantNode(const type::Value &value)
+      : Node(value.GetTypeId()), is_null_(value.IsNull()) {
+    if (is_null_) return;
+    switch (value.GetTypeId()) {
+      case type::TypeId::BOOLEAN:
+        integer_ = value.IsTrue() ? 1 : 0;
+        break;
+      case type::TypeId::TINYINT:
+        integer_ = value.GetAs<int8_t>();
+        break;
+      case type::TypeId::SMALLINT:
+        integer_ = value.GetAs<int16_t>();
+        break;
+      case type::TypeId::INTEGER:
+        integer_ = value.GetAs<int32_t>();
+        break;
+      case type::TypeId::BIGINT:
+        integer_ = value.GetAs<int64_t>();
+        break;
+      default:
+        decimal_ = value.GetAs<double>();
+        break;
+    }
+  }
+
+  bool Evaluate(UNUSED_ATTRIBUTE const BatchColumnSource &source,
+                const std::vector<oid_t> &rows,
+                BatchVector &result) const override {
+    result.Reset(GetValueType(), rows.size());
+    if (is_null_) {
+      result.nulls.assign(rows.size(), 1);
+    } else if (result.IsDecimal()) {
+      result.decimals.assign(rows.size(), decimal_);
+    } else {
+      result.integers.assign(rows.size(), integer_);
+    }
+    return true;
+  }
+
+ private:
+  bool is_null_;
+  int64_t integer_ = 0;
+  double decimal_ = 0;
+};
+
+class ArithmeticNode : public Node {
+ public:
+  ArithmeticNode(ExpressionType op, std::unique_ptr<Node> left,
+                 std::unique_ptr<Node> right)
+      : Node(std::max(left->GetValueType(), right->GetValueType())),
+        op_(op),
+        left_(std::move(left)),
+        right_(std::move(right)) {}
+
+  bool Evaluate(const BatchColumnSource &source, const std::vector<oid_t> &rows,
+                BatchVector &result) const override {
+    BatchVector right;
+    if (!left_->Evaluate(source, rows, result) ||
+        !right_->Evaluate(source, rows, right)) {
+      return false;
+    }
+    for (size_t idx = 0; idx < rows.size(); idx++) {
+      result.nulls[idx] |= right.nulls[idx];
+    }
+
+    if (result.IsDecimal() || right.IsDecimal()) {
+      result.CastToDecimal();
+      right.CastToDecimal();
+      EvaluateDecimals(result, right);
+    } else {
+      // Like type::Value, the result has the wider of the two types
+      result.type = std::max(result.type, right.type);
+      EvaluateIntegers(result, right);
+    }
+    return true;
+  }
+
+ private:
+  void EvaluateIntegers(BatchVector &left, const BatchVector &right) const {
+    int64_t min, max;
+    GetIntegerRange(left.type, min, max);
+    size_t size = left.Size();
+    for (size_t idx = 0; idx < size; idx++) {
+      if (left.nulls[idx]) continue;
+      int64_t x = left.integers[idx], y = right.integers[idx], value = 0;
+      bool overflow = false;
+      switch (op_) {
+        case ExpressionType::OPERATOR_PLUS:
+          overflow = __builtin_add_overflow(x, y, &value);
+          break;
+        case ExpressionType::OPERATOR_MINUS:
+          overflow = __builtin_sub_overflow(x, y, &value);
+          break;
+        case ExpressionType::OPERATOR_MULTIPLY:
+          overflow = __builtin_mul_overflow(x, y, &value);
+          break;
+        default:
+          if (y == 0) ThrowDivideByZero();
+          overflow = (x == std::numeric_limits<int64_t>::min() && y == -1);
+          if (!overflow) value = x / y;
+          break;
+      }
+      if (overflow || value < min || value > max) ThrowOutOfRange();
+      // The minimum of the type is its NULL
+      if (value == min) left.nulls[idx] = 1;
+      left.integers[idx] = value;
+    }
+  }
+
+  void EvaluateDecimals(BatchVector &left, const BatchVector &right) const {
+    size_t size = left.Size();
+    switch (op_) {
+      case ExpressionType::OPERATOR_PLUS:
+        for (size_t idx = 0; idx < size; idx++) {
+          left.decimals[idx] += right.decimals[idx];
+        }
+        break;
+      case ExpressionType::OPERATOR_MINUS:
+        for (size_t idx = 0; idx < size; idx++) {
+          left.decimals[idx] -= right.decimals[idx];
+        }
+        break;
+      case ExpressionType::OPERATOR_MULTIPLY:
+        for (size_t idx = 0; idx < size; idx++) {
+          left.decimals[idx] *= right.decimals[idx];
+        }
+        break;
+      default:
+        for (size_t idx = 0; idx < size; idx++) {
+          if (left.nulls[idx]) continue;
+          if (right.decimals[idx] == 0) ThrowDivideByZero();
+          left.decimals[idx] /= right.decimals[idx];
+        }
+        break;
+    }
+  }
+
+  ExpressionType op_;
+  std::unique_ptr<Node> left_;
+  std::unique_ptr<Node> right_;
+};
+
+template <typename T, typename Compare>
+void CompareValues(const std::vector<T> &left, const std::vector<T> &right,
+                   Compare compare, BatchVector &result) {
+  size_t size = result.Size();
+  for (size_t idx = 0; idx < size; idx++) {
+    result.integers[idx] = compare(left[idx], right[idx]);
+  }
+}
+
+template <typename T>
+void CompareValues(ExpressionType op, const std::vector<T> &left,
+                   const std::vector<T> &right, BatchVector &result) {
+  switch (op) {
+    case ExpressionType::COMPARE_EQUAL:
+      CompareValues(left, right, std::equal_to<T>(), result);
+      break;
+    case ExpressionType::COMPARE_NOTEQUAL:
+      CompareValues(left, right, std::not_equal_to<T>(), result);
+      break;
+    case ExpressionType::COMPARE_LESSTHAN:
+      CompareValues(left, right, std::less<T>(), result);
+      break;
+    case ExpressionType::COMPARE_GREATERTHAN:
+      CompareValues(left, right, std::greater<T>(), result);
+      break;
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      CompareValues(left, right, std::less_equal<T>(), result);
+      break;
+    default:
+      CompareValues(left, right, std::greater_equal<T>(), result);
+      break;
+  }
+}
+
+class ComparisonNode : public Node {
+ public:
+  ComparisonNode(ExpressionType op, std::unique_ptr<Node> left,
+                 std::unique_ptr<Node> right)
+      : Node(type::TypeId::BOOLEAN),
+        op_(op),
+        left_(std::move(left)),
+        right_(std::move(right)) {}
+
+  bool Evaluate(const BatchColumnSource &source, const std::vector<oid_t> &rows,
+                BatchVector &result) const override {
+    BatchVector left, right;
+    if (!left_->Evaluate(source, rows, left) ||
+        !right_->Evaluate(source, rows, right)) {
+      return false;
+    }
+
+    result.Reset(type::TypeId::BOOLEAN, rows.size());
+    for (size_t idx = 0; idx < rows.size(); idx++) {
+      result.nulls[idx] = left.nulls[idx] | right.nulls[idx];
+    }
+    if (left.IsDecimal() || right.IsDecimal()) {
+      left.CastToDecimal();
+      right.CastToDecimal();
+      CompareValues(op_, left.decimals, right.decimals, result);
+    } else {
+      CompareValues(op_, left.integers, right.integers, result);
+    }
+    return true;
+  }
+
+ private:
+  ExpressionType op_;
+  std::unique_ptr<Node> left_;
+  std::unique_ptr<Node> right_;
+};
+
+class ConjunctionNode : public Node {
+ public:
+  ConjunctionNode(ExpressionType op, std::unique_ptr<Node> left,
+                  std::unique_ptr<Node> right)
+      : Node(type::TypeId::BOOLEAN),
+        op_(op),
+        left_(std::move(left)),
+        right_(std::move(right)) {}
+
+  bool Evaluate(const BatchColumnSource &source, const std::vector<oid_t> &rows,
+                BatchVector &result) const override {
+    if (!left_->Evaluate(source, rows, result)) return false;
+
+    // The left side decides the tuples it is FALSE (AND) or TRUE (OR) for.
+    // Only evaluate the right side on the others.
+    int64_t deciding_value = op_ == ExpressionType::CONJUNCTION_AND ? 0 : 1;
+    std::vector<size_t> undecided;
+    std::vector<oid_t> undecided_rows;
+    for (size_t idx = 0; idx < rows.size(); idx++) {
+      if (result.nulls[idx] || result.integers[idx] != deciding_value) {
+        undecided.push_back(idx);
+        undecided_rows.push_back(rows[idx]);
+      }
+    }
+    if (undecided.empty()) return true;
+
+    BatchVector right;
+    if (!right_->Evaluate(source, undecided_rows, right)) return false;
+    for (size_t right_idx = 0; right_idx < undecided.size(); right_idx++) {
+      size_t idx = undecided[right_idx];
+      if (!right.nulls[right_idx] &&
+          right.integers[right_idx] == deciding_value) {
+        result.nulls[idx] = 0;
+        result.integers[idx] = deciding_value;
+      } else {
+        // Both sides are the non-deciding value, unless one of them is NULL
+        result.nulls[idx] |= right.nulls[right_idx];
+      }
+    }
+    return true;
+  }
+
+ private:
+  ExpressionType op_;
+  std::unique_ptr<Node> left_;
+  std::unique_ptr<Node> right_;
+};
+
+class NotNode : public Node {
+ public:
+  explicit NotNode(std::unique_ptr<Node> child)
+      : Node(type::TypeId::BOOLEAN), child_(std::move(child)) {}
+
+  bool Evaluate(const BatchColumnSource &source, const std::vector<oid_t> &rows,
+                BatchVector &result) const override {
+    if (!child_->Evaluate(source, rows, result)) return false;
+    for (size_t idx = 0; idx < rows.size(); idx++) {
+      result.integers[idx] = !result.integers[idx];
+    }
+    return true;
+  }
+
+ private:
+  std::unique_ptr<Node> child_;
+};
+
+std::unique_ptr<Node> CreateNode(const AbstractExpression *expr,
+                                 executor::ExecutorContext *context);
+
+bool CreateChildren(const AbstractExpression *expr,
+                    executor::ExecutorContext *context, bool numeric,
+                    std::unique_ptr<Node> &left, std::unique_ptr<Node> &right) {
+  if (expr->GetChildrenSize() != 2) return false;
+  left = CreateNode(expr->GetChild(0), context);
+  right = CreateNode(expr->GetChild(1), context);
+  if (left == nullptr || right == nullptr) return false;
+  if (numeric) {
+    return IsNumeric(left->GetValueType()) && IsNumeric(right->GetValueType());
+  }
+  return left->GetValueType() == type::TypeId::BOOLEAN &&
+         right->GetValueType() == type::TypeId::BOOLEAN;
+}
+
+std::unique_ptr<Node> CreateNode(const AbstractExpression *expr,
+                                 executor::ExecutorContext *context) {
+  std::unique_ptr<Node> left, right;
+  auto expr_type = expr->GetExpressionType();
+  switch (expr_type) {
+    case ExpressionType::VALUE_TUPLE: {
+      auto tuple_value_expr = static_cast<const TupleValueExpression *>(expr);
+      if (tuple_value_expr->GetTupleId() != 0 ||
+          tuple_value_expr->GetColumnId() < 0 ||
+          !IsNumeric(tuple_value_expr->GetValueType())) {
+        return nullptr;
+      }
+      return std::unique_ptr<Node>(
+          new ColumnNode(tuple_value_expr->GetValueType(),
+                         static_cast<oid_t>(tuple_value_expr->GetColumnId())));
+    }
+    case ExpressionType::VALUE_CONSTANT:
+    case ExpressionType::VALUE_PARAMETER: {
+      type::Value value;
+      if (expr_type == ExpressionType::VALUE_CONSTANT) {
+        value = static_cast<const ConstantValueExpression *>(expr)->GetValue();
+      } else {
+        // Parameters are constant for the execution, bind them now
+        auto param_idx =
+            static_cast<const ParameterValueExpression *>(expr)->GetValueIdx();
+        if (context == nullptr || param_idx < 0 ||
+            static_cast<size_t>(param_idx) >= context->GetParamValues().size()) {
+          return nullptr;
+        }
+        value = context->GetParamValues()[param_idx];
+      }
+      if (!IsNumeric(value.GetTypeId()) &&
+          value.GetTypeId() != type::TypeId::BOOLEAN) {
+        return nullptr;
+      }
+      return std::unique_ptr<Node>(new ConstantNode(value));
+    }
+    case ExpressionType::OPERATOR_PLUS:
+    case ExpressionType::OPERATOR_MINUS:
+    case ExpressionType::OPERATOR_MULTIPLY:
+    case ExpressionType::OPERATOR_DIVIDE:
+      if (!CreateChildren(expr, context, true, left, right)) return nullptr;
+      return std::unique_ptr<Node>(
+          new ArithmeticNode(expr_type, std::move(left), std::move(right)));
+    case ExpressionType::COMPARE_EQUAL:
+    case ExpressionType::COMPARE_NOTEQUAL:
+    case ExpressionType::COMPARE_LESSTHAN:
+    case ExpressionType::COMPARE_GREATERTHAN:
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      if (!CreateChildren(expr, context, true, left, right)) return nullptr;
+      return std::unique_ptr<Node>(
+          new ComparisonNode(expr_type, std::move(left), std::move(right)));
+    case ExpressionType::CONJUNCTION_AND:
+    case ExpressionType::CONJUNCTION_OR:
+      if (!CreateChildren(expr, context, false, left, right)) return nullptr;
+      return std::unique_ptr<Node>(
+          new ConjunctionNode(expr_type, std::move(left), std::move(right)));
+    case ExpressionType::OPERATOR_NOT: {
+      if (expr->GetChildrenSize() != 1) return nullptr;
+      auto child = CreateNode(expr->GetChild(0), context);
+      if (child == nullptr || child->GetValueType() != type::TypeId::BOOLEAN) {
+        return nullptr;
+      }
+      return std::unique_ptr<Node>(new NotNode(std::move(child)));
+    }
+    default:
+      return nullptr;
+  }
+}
+
+bool FilterSelection(const Node &root, const BatchColumnSource &source,
+                     std::vector<oid_t> &selection, bool keep_null) {
+  BatchVector result;
+  if (!root.Evaluate(source, selection, result)) return false;
+
+  size_t num_selected = 0;
+  for (size_t idx = 0; idx < selection.size(); idx++) {
+    bool selected = result.nulls[idx] ? keep_null : result.integers[idx] != 0;
+    if (selected) {
+      selection[num_selected++] = selection[idx];
+    }
+  }
+  selection.resize(num_selected);
+  return true;
+}
+
+}  // namespace
+
+//===----------------------------------------------------------------------===//
+// Evaluator
+//===----------------------------------------------------------------------===//
+
+BatchExpressionEvaluator::BatchExpressionEvaluator(std::unique_ptr<Node> root)
+    : root_(std::move(root)) {}
+
+BatchExpressionEvaluator::~BatchExpressionEvaluator() {}
+
+std::unique_ptr<BatchExpressionEvaluator> BatchExpressionEvaluator::Create(
+    const AbstractExpression *predicate, executor::ExecutorContext *context) {
+  if (predicate == nullptr) return nullptr;
+  auto root = CreateNode(predicate, context);
+  if (root == nullptr || root->GetValueType() != type::TypeId::BOOLEAN) {
+    return nullptr;
+  }
+  return std::unique_ptr<BatchExpressionEvaluator>(
+      new BatchExpressionEvaluator(std::move(root)));
+}
+
+bool BatchExpressionEvaluator::Filter(executor::LogicalTile *tile,
+                                      std::vector<oid_t> &selection,
+                                      bool keep_null) const {
+  return FilterSelection(*root_, LogicalTileSource(tile), selection, keep_null);
+}
+
+bool BatchExpressionEvaluator::Filter(storage::TileGroup *tile_group,
+                                      std::vector<oid_t> &selection,
+                                      bool keep_null) const {
+  return FilterSelection(*root_, TileGroupSource(tile_group), selection,
+                         keep_null);
+}
+
+}  // namespace expression
+}  // namespace peloton
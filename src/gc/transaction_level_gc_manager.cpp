@@ -22,7 +22,9 @@
 #include "storage/database.h"
 #include "storage/storage_manager.h"
 #include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
 #include "storage/tuple.h"
+#include "storage/undo_record.h"
 #include "threadpool/mono_queue_pool.h"
 
 namespace peloton {
@@ -143,6 +145,11 @@ int TransactionLevelGCManager::Unlink(const int &thread_id,
       }
     }
 
+    // The versions the transaction wrote are committed by now
+    if (!txn_ctx->IsReadOnly()) {
+      MarkAllVisible(txn_ctx);
+    }
+
     // Deallocate the Transaction Context of transactions that don't involve
     // any garbage collection
     if (txn_ctx->IsReadOnly() || \
@@ -210,6 +217,49 @@ int TransactionLevelGCManager::Reclaim(const int &thread_id,
   return gc_counter;
 }
 
+void TransactionLevelGCManager::MarkAllVisible(
+    concurrency::TransactionContext *txn_ctx) {
+  if (txn_ctx->GetResult() != ResultType::SUCCESS) {
+    return;
+  }
+
+  auto storage_manager = storage::StorageManager::GetInstance();
+  std::unordered_set<oid_t> tile_group_ids;
+  for (auto &entry : txn_ctx->GetReadWriteSet()) {
+    ItemPointer location = entry.first;
+    if (entry.second == RWType::UPDATE) {
+      // the read/write set holds the old version of an update, which points
+      // to the new one unless the tuple was updated in place
+      auto tile_group = storage_manager->GetTileGroup(location.block);
+      if (tile_group == nullptr) {
+        continue;
+      }
+      ItemPointer next_location =
+          tile_group->GetHeader()->GetNextItemPointer(location.offset);
+      if (!next_location.IsNull()) {
+        location = next_location;
+      }
+    } else if (entry.second != RWType::INSERT &&
+               entry.second != RWType::READ_OWN) {
+      continue;
+    }
+    tile_group_ids.insert(location.block);
+  }
+
+  for (auto tile_group_id : tile_group_ids) {
+    // During the marking, a table may be deconstructed because of the DROP
+    // TABLE request
+    auto tile_group = storage_manager->GetTileGroup(tile_group_id);
+    if (tile_group == nullptr) {
+      continue;
+    }
+    auto tile_group_header = tile_group->GetHeader();
+    if (tile_group_header->GetAllVisibleCommitId() == MAX_CID) {
+      tile_group_header->MarkAllVisible();
+    }
+  }
+}
+
 // Multiple GC thread share the same recycle map
 void TransactionLevelGCManager::AddToRecycleMap(
     concurrency::TransactionContext *txn_ctx) {
@@ -233,9 +283,19 @@ void TransactionLevelGCManager::AddToRecycleMap(
     oid_t table_id = table->GetOid();
     auto tile_group_header = tile_group->GetHeader();
     PELOTON_ASSERT(tile_group_header != nullptr);
+
+    // The freezer checks that no slot was reset and marks the tile group
+    // immutable under the same latch
+    tile_group_header->GetHeaderLock().Lock();
     bool immutable = tile_group_header->GetImmutability();
 
     for (auto &element : entry.second) {
+      // tuples updated in place keep their slot.
+      if (element.second == GCVersionType::COMMIT_DELTA ||
+          element.second == GCVersionType::ABORT_DELTA) {
+        continue;
+      }
+
       // as this transaction has been committed, we should reclaim older
       // versions.
       ItemPointer location(entry.first, element.first);
@@ -250,6 +310,7 @@ void TransactionLevelGCManager::AddToRecycleMap(
         recycle_queue_map_[table_id]->Enqueue(location);
       }
     }
+    tile_group_header->GetHeaderLock().Unlock();
   }
 
   auto storage_manager = storage::StorageManager::GetInstance();
@@ -291,7 +352,16 @@ ItemPointer TransactionLevelGCManager::ReturnFreeSlot(const oid_t &table_id) {
   PELOTON_ASSERT(recycle_queue_map_.find(table_id) != recycle_queue_map_.end());
   auto recycle_queue = recycle_queue_map_[table_id];
 
-  if (recycle_queue->Dequeue(location) == true) {
+  auto storage_manager = storage::StorageManager::GetInstance();
+  while (recycle_queue->Dequeue(location) == true) {
+    // The slot may have been queued before its tile group was made immutable.
+    // Immutable tile groups must never be written to again, so drop such
+    // slots. The freezer never freezes a tile group with queued slots.
+    auto tile_group = storage_manager->GetTileGroup(location.block);
+    if (tile_group == nullptr ||
+        tile_group->GetHeader()->GetImmutability()) {
+      continue;
+    }
     LOG_TRACE("Reuse tuple(%u, %u) in table %u", location.block,
               location.offset, table_id);
     return location;
@@ -325,11 +395,73 @@ void TransactionLevelGCManager::UnlinkVersions(
     concurrency::TransactionContext *txn_ctx) {
   for (auto entry : *(txn_ctx->GetGCSetPtr().get())) {
     for (auto &element : entry.second) {
-      UnlinkVersion(ItemPointer(entry.first, element.first), element.second);
+      ItemPointer location(entry.first, element.first);
+      UnlinkUndoRecords(txn_ctx, location, element.second);
+
+      // the undo records of an aborted in-place update were unlinked during
+      // the abort, and tuples updated in place stay in the indexes.
+      if (element.second == GCVersionType::COMMIT_DELTA ||
+          element.second == GCVersionType::ABORT_DELTA) {
+        continue;
+      }
+      UnlinkVersion(location, element.second);
     }
   }
 }
 
+void TransactionLevelGCManager::UnlinkUndoRecords(
+    concurrency::TransactionContext *txn_ctx, const ItemPointer location,
+    const GCVersionType type) {
+  auto tile_group =
+      storage::StorageManager::GetInstance()->GetTileGroup(location.block);
+
+  // if the corresponding tile group is deconstructed, it freed the records.
+  if (tile_group == nullptr) {
+    return;
+  }
+
+  auto tile_group_header = tile_group->GetHeader();
+  if (!tile_group_header->HasUndoChains()) {
+    return;
+  }
+
+  auto &latch = tile_group_header->GetSpinLatch(location.offset);
+  latch.Lock();
+  storage::UndoRecord *garbage =
+      tile_group_header->GetUndoRecord(location.offset);
+  if (type == GCVersionType::COMMIT_DELTA) {
+    // the records of the transaction restore the versions it replaced, which
+    // no transaction can read anymore. neither can it read the older ones.
+    storage::UndoRecord *newer = nullptr;
+    while (garbage != nullptr &&
+           garbage->GetTransactionId() != txn_ctx->GetTransactionId()) {
+      newer = garbage;
+      garbage = garbage->GetNext();
+    }
+    if (garbage != nullptr) {
+      if (newer == nullptr) {
+        tile_group_header->SetUndoRecord(location.offset, nullptr);
+      } else {
+        newer->SetNext(nullptr);
+      }
+    }
+  } else if (type == GCVersionType::COMMIT_UPDATE ||
+             type == GCVersionType::COMMIT_DELETE ||
+             type == GCVersionType::COMMIT_INS_DEL) {
+    // all versions of the slot are garbage.
+    tile_group_header->SetUndoRecord(location.offset, nullptr);
+  } else {
+    garbage = nullptr;
+  }
+  latch.Unlock();
+
+  while (garbage != nullptr) {
+    auto next = garbage->GetNext();
+    txn_ctx->AddUndoGarbage(garbage);
+    garbage = next;
+  }
+}
+
 // delete a tuple from all its indexes it belongs to.
 void TransactionLevelGCManager::UnlinkVersion(const ItemPointer location,
                                               GCVersionType type) {
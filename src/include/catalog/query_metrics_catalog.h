@@ -27,6 +27,7 @@
 // 10: latency
 // 11: cpu_time
 // 12: time_stamp
+// 13: peak_memory_kb
 //
 //
 //===----------------------------------------------------------------------===//
@@ -64,6 +65,7 @@ class QueryMetricsCatalog : public AbstractCatalog {
                           int64_t latency,
                           int64_t cpu_time,
                           int64_t time_stamp,
+                          int64_t peak_memory_kb,
                           type::AbstractPool *pool);
 
   bool DeleteQueryMetrics(concurrency::TransactionContext *txn,
@@ -93,6 +95,7 @@ class QueryMetricsCatalog : public AbstractCatalog {
     LATENCY = 10,
     CPU_TIME = 11,
     TIME_STAMP = 12,
+    PEAK_MEMORY_KB = 13,
     // Add new columns here in creation order
   };
 
@@ -32,14 +32,27 @@ class BloomFilterAccessor {
   // Codegen the bloom filter destroy
   void Destroy(CodeGen &codegen, llvm::Value *bloom_filter) const;
 
-  // Codegen the bloom filter insert
+  // Codegen the bloom filter insert. Inserts that may run concurrently with
+  // others must be atomic.
   void Add(CodeGen &codegen, llvm::Value *bloom_filter,
-           const std::vector<codegen::Value> &key) const;
+           const std::vector<codegen::Value> &key, bool atomic = false) const;
 
   // Codegen the bloom filter probe
   llvm::Value *Contains(CodeGen &codegen, llvm::Value *bloom_filter,
                         const std::vector<codegen::Value> &key) const;
 
+  // Codegen the hash of the key that the bloom filter uses
+  llvm::Value *HashKey(CodeGen &codegen,
+                       const std::vector<codegen::Value> &key) const;
+
+  // Codegen the batched probe of the first num_elems keys of the selection
+  // vector, whose hashes are at the same positions of the hashes array. The
+  // selection vector is compacted to the keys that pass the filter, and their
+  // number is returned.
+  llvm::Value *Filter(CodeGen &codegen, llvm::Value *bloom_filter,
+                      llvm::Value *hashes, llvm::Value *selection_vector,
+                      llvm::Value *num_elems) const;
+
  private:
   void StoreBloomFilterField(CodeGen &codegen, llvm::Value *bloom_filter,
                              uint32_t field_id,
@@ -48,13 +61,10 @@ class BloomFilterAccessor {
   llvm::Value *LoadBloomFilterField(CodeGen &codegen, llvm::Value *bloom_filter,
                                     uint32_t field_id) const;
 
-  llvm::Value *CalculateHash(CodeGen &codegen, llvm::Value *index,
-                             llvm::Value *seed_hash1,
-                             llvm::Value *seed_hash2) const;
-
-  void LocateBit(CodeGen &codegen, llvm::Value *bloom_filter, llvm::Value *hash,
-                 llvm::Value *&bit_offset_in_byte,
-                 llvm::Value *&byte_ptr) const;
+  // Given the hash, find the block of the key and the bits it sets there
+  void LocateBlock(CodeGen &codegen, llvm::Value *bloom_filter,
+                   llvm::Value *hash, llvm::Value *&block_ptr,
+                   llvm::Value *&mask) const;
 };
 
 }  // namespace codegen
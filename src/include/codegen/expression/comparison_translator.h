@@ -35,6 +35,22 @@ class ComparisonTranslator : public ExpressionTranslator {
   // Produce the result of performing the comparison of left and right values
   codegen::Value DeriveValue(CodeGen &codegen,
                              RowBatch::Row &row) const override;
+
+  // Analyze the pattern of a LIKE once per query, if it is a constant or a
+  // parameter
+  void InitializeQueryState() override;
+  void TearDownQueryState() override;
+
+ private:
+  // Match the string against the pattern analyzed in InitializeQueryState()
+  codegen::Value MatchLike(CodeGen &codegen, const codegen::Value &str) const;
+
+ private:
+  // Whether the comparison is a LIKE with a constant or parameter pattern
+  bool has_like_matcher_;
+
+  // The LikeMatcher of the pattern
+  QueryState::Id like_matcher_id_;
 };
 
 }  // namespace codegen
@@ -45,6 +45,11 @@ class ExpressionTranslator {
   virtual codegen::Value DeriveValue(CodeGen &codegen,
                                      RowBatch::Row &row) const = 0;
 
+  // Set up and clean up any query state the expression registered. Most
+  // expressions have none.
+  virtual void InitializeQueryState() {}
+  virtual void TearDownQueryState() {}
+
   template <typename T>
   const T &GetExpressionAs() const {
     return static_cast<const T &>(expression_);
@@ -216,6 +216,34 @@ class HashTable {
   void MergeLazyUnfinished(CodeGen &codegen, llvm::Value *global_ht,
                            llvm::Value *local_ht) const;
 
+  // Let a table that will be partitioned spill to disk once it exceeds the
+  // memory budget of the query
+  void EnableSpilling(CodeGen &codegen, llvm::Value *ht_ptr,
+                      llvm::Value *exec_ctx) const;
+
+  // Radix-partition the lazily inserted entries of the table, or of the
+  // thread-local tables in the thread states, on num_partition_bits (an i32)
+  void PartitionLazy(CodeGen &codegen, llvm::Value *ht_ptr,
+                     llvm::Value *num_partition_bits) const;
+
+  void PartitionLazyParallel(CodeGen &codegen, llvm::Value *ht_ptr,
+                             llvm::Value *thread_states,
+                             uint32_t ht_state_offset,
+                             llvm::Value *num_partition_bits) const;
+
+  // The number of bits that a partitioned table was partitioned on
+  llvm::Value *NumPartitionBits(CodeGen &codegen, llvm::Value *ht_ptr) const;
+
+  // Build the directory over one partition, so it can be probed with FindAll()
+  void BuildPartition(CodeGen &codegen, llvm::Value *ht_ptr,
+                      llvm::Value *partition) const;
+
+  // Invoke the callback on every entry of a partition, reading the partition
+  // back into memory if the table was spilled
+  void IteratePartition(CodeGen &codegen, llvm::Value *ht_ptr,
+                        llvm::Value *partition,
+                        IterateCallback &callback) const;
+
   virtual void Iterate(CodeGen &codegen, llvm::Value *ht_ptr,
                        IterateCallback &callback) const;
 
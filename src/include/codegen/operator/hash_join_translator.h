@@ -64,6 +64,10 @@ class HashJoinTranslator : public OperatorTranslator {
     return pipeline == left_pipeline_;
   }
 
+  bool IsRightPipeline(const Pipeline &pipeline) const {
+    return pipeline == right_pipeline_;
+  }
+
   bool IsFromLeftChild(ConsumerContext &context) const {
     return IsLeftPipeline(context.GetPipeline());
   }
@@ -80,6 +84,16 @@ class HashJoinTranslator : public OperatorTranslator {
   void CodegenHashProbe(ConsumerContext &context, RowBatch::Row &row,
                         std::vector<codegen::Value> &key) const;
 
+  // Materialize a probe-side row into the probe-side table, when partitioned
+  void MaterializeRight(ConsumerContext &context, RowBatch::Row &row,
+                        const std::vector<codegen::Value> &key) const;
+
+  // Partition the build-side or probe-side table at the end of its pipeline
+  void PartitionTable(PipelineContext &pipeline_ctx, const HashTable &table,
+                      QueryState::Id table_id,
+                      PipelineContext::Id table_tl_id,
+                      llvm::Value *num_partition_bits) const;
+
   /// Estimate the size of the constructed hash table
   uint64_t EstimateHashTableSize() const;
 
@@ -100,10 +114,17 @@ class HashJoinTranslator : public OperatorTranslator {
   /// Callback used when inserting a tuple in the hash table during build
   class InsertLeft;
 
+  /// Callback used for probing a partition with the probe-side partition
+  class ProbePartition;
+
  private:
   // The build-side pipeline
   Pipeline left_pipeline_;
 
+  // The probe-side pipeline, only used when both sides are partitioned.
+  // Otherwise, the probe side is part of the pipeline of the join.
+  Pipeline right_pipeline_;
+
   // The ID of the hash-table in the runtime state
   QueryState::Id hash_table_id_;
   PipelineContext::Id hash_table_tl_id_;
@@ -117,6 +138,9 @@ class HashJoinTranslator : public OperatorTranslator {
   // Bloom Filter Accessor
   BloomFilterAccessor bloom_filter_;
 
+  // Does the scan on the probe side filter its rows by the bloom filter?
+  bool bloom_filter_pushed_down_;
+
   // The left and right hash key expressions
   std::vector<const expression::AbstractExpression *> left_key_exprs_;
   std::vector<const expression::AbstractExpression *> right_key_exprs_;
@@ -127,6 +151,15 @@ class HashJoinTranslator : public OperatorTranslator {
   // The storage format used to store build-attributes in hash-table
   CompactStorage left_value_storage_;
 
+  // When both sides are partitioned, the probe side is materialized into a
+  // second hash table along with the probe-side attributes that the join and
+  // its parents use
+  QueryState::Id probe_table_id_;
+  PipelineContext::Id probe_table_tl_id_;
+  HashTable probe_table_;
+  std::vector<const planner::AttributeInfo *> right_val_ais_;
+  CompactStorage right_value_storage_;
+
   // Does this join need an output vector
   bool needs_output_vector_;
 };
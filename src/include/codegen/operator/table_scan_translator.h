@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include "codegen/bloom_filter_accessor.h"
 #include "codegen/compilation_context.h"
 #include "codegen/consumer_context.h"
 #include "codegen/operator/operator_translator.h"
@@ -39,8 +40,9 @@ class TableScanTranslator : public OperatorTranslator {
   TableScanTranslator(const planner::SeqScanPlan &scan,
                       CompilationContext &context, Pipeline &pipeline);
 
-  // Nothing to do here
-  void InitializeQueryState() override {}
+  // Build the predicates evaluated on compressed tile groups (if any) from the
+  // current values of their constants
+  void InitializeQueryState() override;
 
   // Table scans don't rely on any auxiliary functions
   void DefineAuxiliaryFunctions() override {}
@@ -52,8 +54,21 @@ class TableScanTranslator : public OperatorTranslator {
   void Consume(ConsumerContext &, RowBatch &) const override {}
   void Consume(ConsumerContext &, RowBatch::Row &) const override {}
 
-  // Similar to InitializeQueryState(), table scans don't have any state
-  void TearDownQueryState() override {}
+  // Destroy the predicates evaluated on compressed tile groups (if any)
+  void TearDownQueryState() override;
+
+  // Can the scan filter its rows by a bloom filter on the given keys, i.e.,
+  // does it produce all of the attributes that the keys use?
+  bool CanPushDownBloomFilter(
+      const std::vector<const expression::AbstractExpression *> &key_exprs)
+      const;
+
+  // Filter the rows of the scan by the bloom filter, with the given ID in the
+  // query state, on the given keys. Rows are filtered after the visibility
+  // check and before the scan predicate, in batches.
+  void PushDownBloomFilter(
+      const BloomFilterAccessor &bloom_filter, QueryState::Id bloom_filter_id,
+      const std::vector<const expression::AbstractExpression *> &key_exprs);
 
  private:
   // Load the table pointer
@@ -66,14 +81,55 @@ class TableScanTranslator : public OperatorTranslator {
   // Plan accessor
   const planner::SeqScanPlan &GetScanPlan() const;
 
+  // Load a pointer to the first of the predicates evaluated on compressed tile
+  // groups
+  llvm::Value *LoadCompressedPredicatesPtr(CodeGen &codegen) const;
+
  private:
   // Helper class declarations (defined in implementation)
   class AttributeAccess;
   class ScanConsumer;
 
+  // A bloom filter that a hash join pushed down into the scan
+  struct PushedBloomFilter {
+    // The accessor to the bloom filter
+    const BloomFilterAccessor *accessor;
+    // The ID of the bloom filter in the query state
+    QueryState::Id id;
+    // The keys of the rows that probe the bloom filter
+    std::vector<const expression::AbstractExpression *> key_exprs;
+  };
+
+  // A comparison between a column and a constant or parameter, which a frozen
+  // tile group can evaluate on its compressed columns
+  struct CompressedPredicate {
+    // The column
+    int32_t col_id;
+    // The comparison
+    ExpressionType comparison_operator;
+    // The constant or parameter the column is compared to
+    const expression::AbstractExpression *value;
+  };
+
+  // Split the predicate into comparisons that compressed tile groups can
+  // evaluate. Returns false if some part of it isn't such a comparison.
+  static bool GetCompressedPredicates(
+      const expression::AbstractExpression *predicate,
+      std::vector<CompressedPredicate> &compressed_predicates);
+
  private:
   // The code-generating table instance
   codegen::Table table_;
+
+  // The bloom filters that the rows are filtered by
+  std::vector<PushedBloomFilter> bloom_filters_;
+
+  // The conjunction the scan predicate consists of, if compressed tile groups
+  // can evaluate it
+  std::vector<CompressedPredicate> compressed_predicates_;
+
+  // The ID of the predicates, built per execution, in the query state
+  QueryState::Id compressed_predicates_id_;
 };
 
 }  // namespace codegen
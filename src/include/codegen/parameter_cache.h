@@ -42,6 +42,17 @@ class ParameterCache {
   codegen::Value GetValue(uint32_t index) const;
   codegen::Value GetValue(const expression::AbstractExpression *expr) const;
 
+  // Load the value of the parameter for the given expression outside of a
+  // pipeline, where the cache isn't populated
+  codegen::Value DeriveValue(CodeGen &codegen,
+                             llvm::Value *query_parameters_ptr,
+                             const expression::AbstractExpression *expr) const;
+
+  // Get the index of the parameter for the given expression
+  uint32_t GetIndex(const expression::AbstractExpression *expr) const {
+    return parameters_map_.GetIndex(expr);
+  }
+
   // Clear all cache parameter values
   void Reset();
 
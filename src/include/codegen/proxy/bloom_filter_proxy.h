@@ -20,17 +20,17 @@ namespace codegen {
 
 PROXY(BloomFilter) {
   // Member Variables
-  DECLARE_MEMBER(0, uint64_t, num_hash_funcs);
-  DECLARE_MEMBER(1, char *, bytes);
-  DECLARE_MEMBER(2, uint64_t, num_bits);
-  DECLARE_MEMBER(3, uint64_t, num_misses);
-  DECLARE_MEMBER(4, uint64_t, num_probes);
+  DECLARE_MEMBER(0, uint64_t *, blocks);
+  DECLARE_MEMBER(1, uint64_t, num_blocks);
+  DECLARE_MEMBER(2, uint64_t, num_misses);
+  DECLARE_MEMBER(3, uint64_t, num_probes);
 
   DECLARE_TYPE;
 
   // Methods
   DECLARE_METHOD(Init);
   DECLARE_METHOD(Destroy);
+  DECLARE_METHOD(Filter);
 };
 
 TYPE_BUILDER(BloomFilter, util::BloomFilter);
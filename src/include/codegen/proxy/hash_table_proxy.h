@@ -34,7 +34,12 @@ PROXY(HashTable) {
   DECLARE_MEMBER(4, char[sizeof(util::HashTable::EntryBuffer)], entry_buffer);
   DECLARE_MEMBER(5, uint64_t, num_elems);
   DECLARE_MEMBER(6, uint64_t, capacity);
-  DECLARE_MEMBER(7, char[sizeof(std::unique_ptr<char>)], stats);
+  DECLARE_MEMBER(7, char *, partitioned_entries);
+  DECLARE_MEMBER(8, uint64_t *, partition_offsets);
+  DECLARE_MEMBER(9, uint32_t, num_partition_bits);
+  DECLARE_MEMBER(10, uint64_t, memory_budget);
+  DECLARE_MEMBER(11, uint64_t, partition_base);
+  DECLARE_MEMBER(12, char *, spill_state);
   DECLARE_TYPE;
 
   // Proxy all methods that will be called from codegen
@@ -44,6 +49,13 @@ PROXY(HashTable) {
   DECLARE_METHOD(BuildLazy);
   DECLARE_METHOD(ReserveLazy);
   DECLARE_METHOD(MergeLazyUnfinished);
+  DECLARE_METHOD(PartitionLazy);
+  DECLARE_METHOD(PartitionLazyParallel);
+  DECLARE_METHOD(BuildPartition);
+  DECLARE_METHOD(LoadPartition);
+  DECLARE_METHOD(EnableSpilling);
+  DECLARE_METHOD(PartitionBegin);
+  DECLARE_METHOD(PartitionEnd);
   DECLARE_METHOD(Destroy);
 };
 
@@ -0,0 +1,35 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// like_matcher_proxy.h
+//
+// Identification: src/include/codegen/proxy/like_matcher_proxy.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "codegen/proxy/proxy.h"
+#include "codegen/util/like_matcher.h"
+
+namespace peloton {
+namespace codegen {
+
+PROXY(LikeMatcher) {
+  /// We don't need access to internal fields, so use an opaque byte array
+  DECLARE_MEMBER(0, char[sizeof(util::LikeMatcher)], opaque);
+  DECLARE_TYPE;
+
+  /// Proxy Init(), Destroy() and Matches() in codegen::util::LikeMatcher
+  DECLARE_METHOD(Init);
+  DECLARE_METHOD(Destroy);
+  DECLARE_METHOD(Matches);
+};
+
+TYPE_BUILDER(LikeMatcher, util::LikeMatcher);
+
+}  // namespace codegen
+}  // namespace peloton
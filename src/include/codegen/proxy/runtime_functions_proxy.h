@@ -43,6 +43,9 @@ PROXY(RuntimeFunctions) {
   DECLARE_METHOD(HashCrc64);
   DECLARE_METHOD(GetTileGroup);
   DECLARE_METHOD(GetTileGroupLayout);
+  DECLARE_METHOD(InitCompressedPredicate);
+  DECLARE_METHOD(DestroyCompressedPredicates);
+  DECLARE_METHOD(FilterCompressedTileGroup);
   DECLARE_METHOD(FillPredicateArray);
   DECLARE_METHOD(ExecuteTableScan);
   DECLARE_METHOD(ExecutePerState);
@@ -31,7 +31,11 @@ PROXY(Sorter) {
                  opaque1);
   DECLARE_MEMBER(1, char **, tuples_start);
   DECLARE_MEMBER(2, char **, tuples_end);
-  DECLARE_MEMBER(3, char[sizeof(std::vector<std::pair<void *, uint64_t>>)],
+  DECLARE_MEMBER(3,
+                 char[sizeof(std::vector<std::pair<void *, uint64_t>>) +
+                      sizeof(uint64_t) +            // memory budget
+                      sizeof(uint64_t) +            // allocated bytes
+                      sizeof(void *)],              // spill state
                  opaque2);
   DECLARE_TYPE;
   // clang-format on
@@ -44,6 +48,7 @@ PROXY(Sorter) {
   DECLARE_METHOD(Sort);
   DECLARE_METHOD(SortParallel);
   DECLARE_METHOD(SortTopKParallel);
+  DECLARE_METHOD(NextChunk);
   DECLARE_METHOD(Destroy);
 };
 
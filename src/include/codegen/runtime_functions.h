@@ -32,6 +32,9 @@ class AbstractExpression;
 }  // namespace storage
 
 namespace codegen {
+
+class QueryParameters;
+
 //===----------------------------------------------------------------------===//
 // Various common functions that are called from compiled query plans
 //===----------------------------------------------------------------------===//
@@ -77,7 +80,49 @@ class RuntimeFunctions {
    */
   static void GetTileGroupLayout(const storage::TileGroup *tile_group,
                                  ColumnLayoutInfo *infos, uint32_t num_cols);
-  
+
+  /**
+   * Initialize a predicate on a column of a compressed tile group. The value
+   * is taken from the query parameters, so that compiled code shared by
+   * queries with different constants always filters by the current ones.
+   *
+   * @param predicate The (uninitialized) predicate
+   * @param col_id The column the predicate is on
+   * @param comparison_operator The ExpressionType of the comparison
+   * @param parameters The parameters of the query
+   * @param param_idx The index of the parameter the column is compared to
+   */
+  static void InitCompressedPredicate(storage::PredicateInfo *predicate,
+                                      int32_t col_id,
+                                      int32_t comparison_operator,
+                                      const QueryParameters *parameters,
+                                      uint32_t param_idx);
+
+  /**
+   * Destroy the predicates initialized with InitCompressedPredicate()
+   */
+  static void DestroyCompressedPredicates(storage::PredicateInfo *predicates,
+                                          uint32_t num_predicates);
+
+  /**
+   * Filter the TIDs in the selection vector by evaluating the predicates
+   * directly on the compressed form of a frozen tile group.
+   *
+   * @param tile_group The tile group we're scanning
+   * @param predicates The conjunction of comparisons between a column and a
+   * value that make up the scan predicate
+   * @param num_predicates The number of predicates
+   * @param[in,out] sel_vec The TIDs to filter, compacted in place
+   * @param num_sel The number of TIDs in the selection vector
+   * @return The number of TIDs that qualified, or -1 if the tile group isn't
+   * compressed or the predicate couldn't be evaluated on the compressed data.
+   * In the latter case, the selection vector is left untouched.
+   */
+  static int32_t FilterCompressedTileGroup(
+      const storage::TileGroup *tile_group,
+      const storage::PredicateInfo *predicates, uint32_t num_predicates,
+      uint32_t *sel_vec, uint32_t num_sel);
+
   /**
    * Execute a parallel scan over the given table in the given database.
    *
@@ -13,6 +13,8 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
+#include <vector>
 
 #include "executor/executor_context.h"
 
@@ -45,9 +47,43 @@ namespace util {
  * thread-local hash tables to. Finally, calls to MergeLazyUnfinished() are
  * made concurrently from multiple threads to merge lazily-built thread-local
  * hash tables.
+ *
+ * Lazily inserted entries can also be radix-partitioned on the high bits of
+ * their hashes instead of being built into one directory. PartitionLazy() and
+ * PartitionLazyParallel() copy the entries into 2^b contiguous partitions,
+ * where b is chosen so that a partition and its directory fit in the cache.
+ * BuildPartition() then builds the directory over a single partition, after
+ * which the table can be probed for the keys that fall into that partition.
+ *
+ * A table that is going to be partitioned can be given a memory budget,
+ * which it may share with other tables. Its lazily inserted entries reserve
+ * memory from the budget, and once there is none left, they are partitioned on
+ * kMaxPartitionBits bits and streamed to a spill file as a run, and their
+ * memory is given back. Partitioning such a table only computes the sizes of
+ * the partitions, and each partition is read back from all runs when it is
+ * built or iterated over (a grace hash join). Since partitions are formed from
+ * the high bits of the hashes, a partition on fewer bits is a range of the
+ * partitions that the runs were written in. A partition is loaded whole, so
+ * if the largest one would not fit in the budget, the runs are repartitioned
+ * on up to kMaxSpillPartitionBits bits, and the table is partitioned on as
+ * many bits as it takes. Only duplicates of a key that alone exceed the budget
+ * still make a partition that does not fit.
+ *
+ * Unlike HashTable, OAHashTable, which aggregations use, does not spill.
  */
 class HashTable {
  public:
+  // Passed as the number of partition bits to let the table choose it
+  static const uint32_t kAutoPartitionBits = 0xFFFFFFFF;
+
+  // The most partition bits that the table chooses. More partitions than
+  // there are TLB entries make the partitioning pass thrash the TLB.
+  static const uint32_t kMaxPartitionBits = 10;
+
+  // The most partition bits a spilled table is partitioned on, to make its
+  // partitions fit in the memory budget
+  static const uint32_t kMaxSpillPartitionBits = 14;
+
   /** Constructor */
   HashTable(::peloton::type::AbstractPool &memory, uint32_t key_size,
             uint32_t value_size);
@@ -135,6 +171,85 @@ class HashTable {
    */
   void MergeLazyUnfinished(HashTable &other);
 
+  /**
+   * Radix-partition all lazily inserted entries on the high bits of their
+   * hashes. After this call, the table only supports BuildPartition() and
+   * probes into the partition that was built last.
+   *
+   * @param num_partition_bits The number of hash bits to partition on, or
+   * kAutoPartitionBits to choose them from the size of the table
+   */
+  void PartitionLazy(uint32_t num_partition_bits);
+
+  /**
+   * Radix-partition the lazily inserted entries of all the thread-local hash
+   * tables stored in the thread states into this table. Threads from the
+   * execution pool each partition a thread-local table. The thread-local
+   * tables are left untouched, unless some of them spilled. In that case this
+   * table takes over the runs of all of them.
+   *
+   * @param thread_states Where thread-local hash tables are located
+   * @param hash_table_offset The offset into each state where the thread-local
+   * hash table can be found.
+   * @param num_partition_bits The number of hash bits to partition on, or
+   * kAutoPartitionBits to choose them from the size of the input
+   */
+  void PartitionLazyParallel(
+      const executor::ExecutorContext::ThreadStates &thread_states,
+      uint32_t hash_table_offset, uint32_t num_partition_bits);
+
+  /**
+   * Build the directory over the entries of the given partition only,
+   * replacing the directory of the previously built partition.
+   *
+   * @param partition The partition to build
+   */
+  void BuildPartition(uint32_t partition);
+
+  /**
+   * Read the entries of the given partition back into memory, if the table
+   * was spilled to disk, replacing the previously loaded partition.
+   *
+   * @param partition The partition to load
+   */
+  void LoadPartition(uint32_t partition);
+
+  /**
+   * The entries of a partition are stored contiguously, EntrySize() bytes
+   * apart, from PartitionBegin() up to PartitionEnd(). If the table was
+   * spilled, this only holds for the partition that was loaded last.
+   */
+  char *PartitionBegin(uint32_t partition) const;
+  char *PartitionEnd(uint32_t partition) const;
+
+  /**
+   * The number of partition bits that gives partitions whose entries and
+   * directory fit in the cache
+   *
+   * @param num_elems The number of entries to partition
+   * @param entry_size The size of an entry in bytes
+   */
+  static uint32_t ChoosePartitionBits(uint64_t num_elems, uint32_t entry_size);
+
+  /**
+   * Set the budget that the memory of lazily inserted entries is reserved
+   * from. They are spilled to disk when it's used up, and may use any amount
+   * of memory if it's null or unbounded. Only tables that are partitioned may
+   * spill. The budget must outlive the table.
+   */
+  void SetMemoryBudget(MemoryBudget *memory_budget) {
+    PELOTON_ASSERT(memory_reserved_ == 0);
+    memory_budget_ = (memory_budget != nullptr && memory_budget->IsBounded())
+                         ? memory_budget
+                         : nullptr;
+  }
+
+  /**
+   * Let the table spill once it exceeds the memory budget of the query. This
+   * method is used from codegen.
+   */
+  void EnableSpilling(executor::ExecutorContext &exec_ctx);
+
   //////////////////////////////////////////////////////////////////////////////
   ///
   /// Accessors
@@ -144,6 +259,10 @@ class HashTable {
   uint64_t NumElements() const { return num_elems_; }
   uint64_t Capacity() const { return capacity_; }
   double LoadFactor() const { return num_elems_ / 1.0 / directory_size_; }
+  uint32_t EntrySize() const { return entry_buffer_.EntrySize(); }
+  uint32_t NumPartitionBits() const { return num_partition_bits_; }
+  uint32_t NumPartitions() const { return 1u << num_partition_bits_; }
+  uint64_t NumSpilledRuns() const;
 
   //////////////////////////////////////////////////////////////////////////////
   ///
@@ -245,6 +364,16 @@ class HashTable {
      */
     void TransferMemoryBlocks(EntryBuffer &target);
 
+    /**
+     * Free all entries, making the buffer as it was after construction
+     */
+    void Reset();
+
+    /**
+     * Return the size of the entries in this buffer
+     */
+    uint32_t EntrySize() const { return entry_size_; }
+
    private:
     // This struct represents a chunk of heap memory. We chain together these
     // chunks to avoid the need for a std::vector.
@@ -276,6 +405,69 @@ class HashTable {
   // Resize the hash table
   void Resize();
 
+  // The partition of an entry with the given hash
+  static uint64_t PartitionOf(uint64_t hash, uint32_t num_partition_bits) {
+    return num_partition_bits == 0 ? 0 : hash >> (64 - num_partition_bits);
+  }
+
+  // Partition the lazily inserted entries of all the given tables into this
+  // one, partitioning the tables in parallel if requested
+  void PartitionTables(const std::vector<HashTable *> &tables,
+                       uint32_t num_partition_bits, bool parallel);
+
+  // Count the lazily inserted entries in each partition
+  void CountPartitions(uint32_t num_partition_bits, uint64_t *counts) const;
+
+  // Copy the lazily inserted entries into the entries array, writing the next
+  // entry of each partition at its position in write_pos
+  void ScatterPartitions(uint32_t num_partition_bits, char *entries,
+                         uint64_t *write_pos) const;
+
+  // Gather the lazily inserted entries in a write-combining buffer of the
+  // given number of entries per partition, and hand each full buffer, and
+  // what is left in each at the end, to flush(partition, buffer, num_entries)
+  template <typename FlushFunc>
+  void WriteCombinePartitions(uint32_t num_partition_bits,
+                              uint32_t buffer_entries, FlushFunc flush) const;
+
+  // Partition the tables when some of them spilled, leaving the partitions on
+  // disk
+  void PartitionSpilledTables(const std::vector<HashTable *> &tables,
+                              uint32_t num_partition_bits, bool parallel);
+
+  // The number of entries in the largest partition on the given number of
+  // bits, which must be at most the number of bits the runs are partitioned on
+  uint64_t MaxSpilledPartitionSize(uint32_t num_partition_bits) const;
+
+  // Rewrite the spilled runs into a single run that is partitioned on the
+  // given number of bits, more than the runs are partitioned on
+  void RepartitionSpilledRuns(uint32_t num_partition_bits);
+
+  // Allocate the directory for the largest partition, and finish setting up
+  // the partitioned table
+  void FinishPartitioning(uint64_t num_elems, uint64_t max_partition_size,
+                          uint32_t num_partition_bits);
+
+  // Does lazily inserting another entry need more memory from the budget?
+  bool NeedsReservation() const {
+    return memory_budget_ != nullptr &&
+           (NumElementsInMemory() + 1) * EntrySize() > memory_reserved_;
+  }
+
+  // Reserve memory for more lazily inserted entries, spilling the ones in
+  // memory if the budget is used up
+  void ReserveMemory();
+
+  // The number of lazily inserted entries that were not spilled
+  uint64_t NumElementsInMemory() const;
+
+  // Partition the lazily inserted entries, write them to the spill file as a
+  // new run, and free their memory
+  void SpillLazy();
+
+  // Give the memory reserved for lazily inserted entries back to the budget
+  void ReleaseMemory();
+
  private:
   // The memory allocator used for all allocations in this hash table
   ::peloton::type::AbstractPool &memory_;
@@ -293,8 +485,25 @@ class HashTable {
   uint64_t num_elems_;
   uint64_t capacity_;
 
-  // Info about partitions
-  // ...
+  // The partitioned entries, and the position of the first entry of each
+  // partition in them, followed by the total number of entries
+  char *partitioned_entries_;
+  uint64_t *partition_offsets_;
+
+  // The number of hash bits that the entries are partitioned on
+  uint32_t num_partition_bits_;
+
+  // The budget that the memory of lazily inserted entries is reserved from,
+  // null if unbounded, and the bytes reserved from it
+  MemoryBudget *memory_budget_;
+  uint64_t memory_reserved_;
+
+  // The position in the partitions of the first entry of partitioned_entries_
+  uint64_t partition_base_;
+
+  // The spilled runs. Only allocated once the first run is spilled.
+  struct SpillState;
+  std::unique_ptr<SpillState> spill_;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
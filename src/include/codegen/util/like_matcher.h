@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// like_matcher.h
+//
+// Identification: src/include/codegen/util/like_matcher.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace peloton {
+
+namespace executor {
+class ExecutorContext;
+}  // namespace executor
+
+namespace codegen {
+namespace util {
+
+//===----------------------------------------------------------------------===//
+// A LIKE pattern that is analyzed once per query. Patterns made of a literal
+// with at most a leading and a trailing '%' are matched with a single
+// comparison or substring search instead of the backtracking matcher in
+// StringFunctions::Like(). Like that one, matching ignores case.
+//===----------------------------------------------------------------------===//
+class LikeMatcher {
+ public:
+  enum class PatternType : uint32_t {
+    // A NULL pattern, which matches nothing
+    None,
+    // Only '%'s
+    All,
+    // 'literal'
+    Exact,
+    // 'literal%'
+    Prefix,
+    // '%literal'
+    Suffix,
+    // '%literal%'
+    Contains,
+    // Anything else
+    General
+  };
+
+  // Analyze the given pattern. A null pattern matches no string. Here and in
+  // Matches(), the length may count a terminating NUL.
+  void Init(const char *pattern, uint32_t pattern_len);
+
+  // Free the copies of the pattern
+  void Destroy();
+
+  // Does the given string match the pattern?
+  bool Matches(executor::ExecutorContext &ctx, const char *str,
+               uint32_t str_len) const;
+
+  PatternType GetPatternType() const { return type_; }
+
+  // Determine the type of the given pattern. If it is not a General pattern,
+  // the unescaped literal in it is written into literal, in lower case.
+  static PatternType Analyze(const char *pattern, uint32_t pattern_len,
+                             std::string &literal);
+
+  // Does the string contain the lower case literal, ignoring case?
+  static bool ContainsIgnoreCase(const char *str, uint32_t str_len,
+                                 const char *literal, uint32_t literal_len);
+
+ private:
+  // The type of the pattern
+  PatternType type_;
+
+  // The lower case literal of non-General patterns
+  char *literal_;
+  uint32_t literal_len_;
+
+  // The pattern itself, for General patterns
+  char *pattern_;
+  uint32_t pattern_len_;
+};
+
+}  // namespace util
+}  // namespace codegen
+}  // namespace peloton
@@ -30,6 +30,10 @@ namespace util {
 // key-value pair is stored inside the HashEntry itself to make common case
 // fast; all other values are stored sequentially in an external KeyValueList
 // structure, also in the form of key-value pair.
+//
+// The table is always kept in memory. Aggregations are not held to the memory
+// budget of the query, unlike the hash tables of radix-partitioned joins,
+// which spill to disk.
 //===----------------------------------------------------------------------===//
 class OAHashTable {
  public:
@@ -143,6 +147,30 @@ class OAHashTable {
    */
   char *StoreTuple(HashEntry *entry, uint64_t hash);
 
+  /**
+   * Find the entry holding the given key, or the free entry where the key
+   * would be stored. Keys are compared byte-wise, which is how the table is
+   * used when keys are serialized into fixed-width byte strings rather than
+   * typed structs.
+   *
+   * @param hash The hash value of the key
+   * @param key The key_size bytes of the key
+   *
+   * @return The entry, which can be passed to StoreTuple()
+   */
+  HashEntry *FindEntry(uint64_t hash, const char *key) const;
+
+  /// The number of values stored in an occupied entry
+  uint32_t NumValues(const HashEntry *entry) const {
+    return entry->HasKeyValueList() ? entry->kv_list->size : 1;
+  }
+
+  /// The idx-th value stored in an occupied entry
+  char *GetValue(HashEntry *entry, uint32_t idx) const {
+    return entry->HasKeyValueList() ? entry->kv_list->data + idx * value_size_
+                                    : entry->data + key_size_;
+  }
+
   //////////////////////////////////////////////////////////////////////////////
   ///
   /// Accessors
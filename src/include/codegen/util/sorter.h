@@ -13,6 +13,7 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <type_traits>
 #include <vector>
 
@@ -34,6 +35,13 @@ namespace util {
  * Additionally, Sorter does not serialize elements into its memory space.
  * Instead, it allocates space for incoming tuples on demand and returns a
  * pointer to the call, relying on her to serialize into the space.
+ *
+ * A sorter with a memory budget performs an external merge sort once its
+ * tuples no longer fit in the budget: it sorts the tuples it has buffered and
+ * writes them out to a spill file as a sorted run, and then frees their
+ * memory. Sort() merges all the runs, producing the sorted tuples a chunk at a
+ * time. NextChunk() produces the chunk that follows the one being iterated
+ * over. Top-K sorters only keep K tuples, and never spill.
  */
 class Sorter {
  private:
@@ -147,15 +155,43 @@ class Sorter {
       const executor::ExecutorContext::ThreadStates &thread_states,
       uint32_t sorter_offset, uint64_t top_k);
 
+  /**
+   * Replace the sorted tuples with the next chunk of them, if the sorter had
+   * to spill its tuples to disk. Sorters that sorted their tuples in memory
+   * produce all of them in a single chunk.
+   *
+   * @return True if there was another chunk of tuples. False otherwise.
+   */
+  bool NextChunk();
+
+  /**
+   * Set the budget that the memory of the buffered tuples is reserved from,
+   * which other sorters and hash tables may share. The tuples are spilled to
+   * disk when it's used up, and may use any amount of memory if it's null or
+   * unbounded. The budget must outlive the sorter.
+   */
+  void SetMemoryBudget(MemoryBudget *memory_budget) {
+    PELOTON_ASSERT(memory_reserved_ == 0);
+    memory_budget_ = (memory_budget != nullptr && memory_budget->IsBounded())
+                         ? memory_budget
+                         : nullptr;
+  }
+
   //////////////////////////////////////////////////////////////////////////////
   ///
   /// Accessors
   ///
   //////////////////////////////////////////////////////////////////////////////
 
-  /** Return the number tuples stored in this sorter instance */
+  /**
+   * Return the number tuples stored in this sorter instance. Once spilled
+   * tuples are sorted, this is the number of tuples in the current chunk.
+   */
   uint64_t NumTuples() const { return tuples_.size(); }
 
+  /** Return the number of sorted runs that were spilled to disk */
+  uint64_t NumSpilledRuns() const;
+
   /** Iterators */
   TupleList::iterator begin() { return tuples_.begin(); }
   TupleList::iterator end() { return tuples_.end(); }
@@ -211,6 +247,45 @@ class Sorter {
    */
   void MakeRoomForNewTuple();
 
+  /**
+   * Allocate space for a new tuple without considering the memory budget
+   */
+  char *AllocateTuple();
+
+  /**
+   * Does allocating space for another tuple need a new block, and thus more
+   * memory from the budget?
+   */
+  bool NeedsReservation() const;
+
+  /**
+   * Reserve memory for the next block, spilling the buffered tuples if the
+   * budget is used up
+   */
+  void ReserveMemory();
+
+  /**
+   * Give the memory reserved for the buffered tuples back to the budget
+   */
+  void ReleaseMemory();
+
+  /**
+   * Sort the tuples buffered in memory, write them to the spill file as a new
+   * run, and free their memory.
+   */
+  void SpillRun();
+
+  /**
+   * Merge the runs spilled by all the given sorters, in addition to the ones
+   * spilled by this one, after they write out their remaining tuples.
+   */
+  void SortSpilledParallel(const std::vector<Sorter *> &sorters);
+
+  /**
+   * Begin merging the spilled runs, producing the first chunk of tuples.
+   */
+  void StartMerge();
+
   /**
    * Transfer ownership of all allocated memory to the provided sorter instance.
    *
@@ -259,6 +334,16 @@ class Sorter {
 
   // The memory blocks we've allocated (to store tuples) and their sizes
   std::vector<std::pair<void *, uint64_t>> blocks_;
+
+  // The budget that the memory of the buffered tuples is reserved from, null
+  // if unbounded, and the bytes reserved from it
+  MemoryBudget *memory_budget_;
+  uint64_t memory_reserved_;
+
+  // The spilled runs and the state of merging them. Only allocated once the
+  // first run is spilled.
+  struct SpillState;
+  std::unique_ptr<SpillState> spill_;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
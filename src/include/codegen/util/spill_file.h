@@ -0,0 +1,88 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// spill_file.h
+//
+// Identification: src/include/codegen/util/spill_file.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+#include "common/macros.h"
+
+namespace peloton {
+namespace codegen {
+namespace util {
+
+/**
+ * A temporary file that hash tables and sorters write their data to when they
+ * exceed the memory budget of the query. The file is created in the spill
+ * directory and unlinked right away, so that it disappears once it is closed,
+ * even if the process crashes.
+ *
+ * Data is only ever appended, in large sequential writes or by filling in
+ * room made at the end of the file, and read back at the offsets that the
+ * writes returned. Readers can ask the kernel to read
+ * ahead the data they will need next with Prefetch(), so that the I/O overlaps
+ * with processing the data already read.
+ */
+class SpillFile {
+ public:
+  /** Constructor. Creates the file. */
+  SpillFile();
+
+  /** Destructor. Closes, and thus deletes, the file. */
+  ~SpillFile();
+
+  DISALLOW_COPY_AND_MOVE(SpillFile);
+
+  /**
+   * Append the given bytes to the end of the file.
+   *
+   * @return The offset in the file where the bytes were written
+   */
+  uint64_t Write(const char *data, uint64_t len);
+
+  /**
+   * Make room for len bytes at the end of the file, which are then filled in
+   * with WriteAt(), in any order.
+   *
+   * @return The offset in the file of the room
+   */
+  uint64_t Allocate(uint64_t len);
+
+  /**
+   * Write the given bytes at the given offset, into room made by Allocate()
+   */
+  void WriteAt(uint64_t offset, const char *data, uint64_t len);
+
+  /**
+   * Read len bytes starting at the given offset of the file
+   */
+  void Read(uint64_t offset, char *data, uint64_t len) const;
+
+  /**
+   * Let the kernel start reading the given range of the file in the background
+   */
+  void Prefetch(uint64_t offset, uint64_t len) const;
+
+  /** The number of bytes written to, or allocated in, the file */
+  uint64_t Size() const { return size_; }
+
+ private:
+  // The file descriptor
+  int fd_;
+
+  // The size of the file
+  uint64_t size_;
+};
+
+}  // namespace util
+}  // namespace codegen
+}  // namespace peloton
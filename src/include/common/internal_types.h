@@ -995,6 +995,16 @@ enum class LayoutType {
 std::string LayoutTypeToString(LayoutType type);
 std::ostream &operator<<(std::ostream &os, const LayoutType &type);
 
+/* Encodings used for the columns of a compressed (frozen) tile group */
+enum class CompressionType {
+  INVALID = INVALID_TYPE_ID,
+  DICTIONARY = 1,          /* Sorted dictionary of distinct values */
+  FRAME_OF_REFERENCE = 2,  /* Bit-packed deltas from the column minimum */
+  RUN_LENGTH = 3           /* Runs of identical codes */
+};
+std::string CompressionTypeToString(CompressionType type);
+std::ostream &operator<<(std::ostream &os, const CompressionType &type);
+
 //===--------------------------------------------------------------------===//
 // Trigger Types
 //===--------------------------------------------------------------------===//
@@ -1251,6 +1261,8 @@ enum class GCVersionType {
   ABORT_DELETE,    // a version that is deleted during txn abort.
   ABORT_INSERT,    // a version that is inserted during txn abort.
   ABORT_INS_DEL,   // a version that is inserted and deleted during txn commit.
+  COMMIT_DELTA,    // a version that is updated in place during txn commit.
+  ABORT_DELTA,     // a version that is updated in place during txn abort.
 };
 std::string GCVersionTypeToString(GCVersionType type);
 GCVersionType StringToGCVersionType(const std::string &str);
@@ -1434,6 +1446,17 @@ typedef std::map<oid_t, std::pair<oid_t, oid_t>> column_map_type;
 //===--------------------------------------------------------------------===//
 #define SOCKET_BUFFER_SIZE 8192
 
+/* number of writes a connection handler submits to io_uring at once */
+#define IO_URING_ENTRIES 256
+
+/* number and size of the buffers the connections of a connection handler
+ * receive into through io_uring */
+#define IO_URING_RECEIVE_BUFFERS 1024
+#define IO_URING_RECEIVE_BUFFER_SIZE 4096
+
+/* number of connections a connection handler accepts at once */
+#define ACCEPT_BATCH_SIZE 64
+
 /* byte type */
 typedef unsigned char uchar;
 
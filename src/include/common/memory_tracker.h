@@ -0,0 +1,111 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// memory_tracker.h
+//
+// Identification: src/include/common/memory_tracker.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "common/macros.h"
+
+namespace peloton {
+
+/**
+ * Accounts for the memory used by some part of the system, e.g. a query or a
+ * connection. Trackers form a tree: the memory reserved by a tracker is also
+ * reserved by all its ancestors, so that the memory of a query counts towards
+ * its connection and the whole server as well.
+ *
+ * Reserving memory only records it, it never fails. Whoever owns a tracker
+ * decides what to do when it grows too large.
+ */
+class MemoryTracker {
+ public:
+  explicit MemoryTracker(MemoryTracker *parent = nullptr)
+      : parent_(parent), current_(0), peak_(0) {}
+
+  /** Destructor. Gives back whatever the tracker still holds to its parent. */
+  ~MemoryTracker();
+
+  DISALLOW_COPY_AND_MOVE(MemoryTracker);
+
+  /** Record that the given number of bytes were allocated */
+  void Reserve(uint64_t bytes);
+
+  /** Record that the given number of bytes were freed */
+  void Release(uint64_t bytes);
+
+  /** The number of bytes currently allocated */
+  uint64_t GetCurrent() const { return current_.load(); }
+
+  /** The largest number of bytes that were allocated at any one time */
+  uint64_t GetPeak() const { return peak_.load(); }
+
+  MemoryTracker *GetParent() const { return parent_; }
+
+ private:
+  // The tracker the memory of this one counts towards, or null
+  MemoryTracker *parent_;
+
+  // The bytes currently allocated
+  std::atomic<uint64_t> current_;
+
+  // The high-water mark of current_
+  std::atomic<uint64_t> peak_;
+};
+
+/**
+ * A fixed amount of memory that several consumers draw from, e.g. the hash
+ * tables and sorters of a query and all the threads that build them. Unlike a
+ * tracker, a budget turns down reservations that don't fit, and the consumers
+ * spill to disk instead.
+ */
+class MemoryBudget {
+ public:
+  /** Constructor. A limit of 0 makes the budget unbounded. */
+  explicit MemoryBudget(uint64_t limit = 0) : limit_(limit), reserved_(0) {}
+
+  DISALLOW_COPY_AND_MOVE(MemoryBudget);
+
+  /**
+   * Reserve the given number of bytes if they fit in the budget.
+   *
+   * @return false if they don't, in which case nothing is reserved
+   */
+  bool TryReserve(uint64_t bytes);
+
+  /**
+   * Reserve the given number of bytes even if they don't fit in the budget.
+   * This is for consumers that spilled all they could and must go on.
+   */
+  void Reserve(uint64_t bytes) { reserved_.fetch_add(bytes); }
+
+  /** Give back bytes reserved earlier */
+  void Release(uint64_t bytes);
+
+  /** Whether the budget is limited at all */
+  bool IsBounded() const { return limit_ != 0; }
+
+  /** The number of bytes the consumers may reserve, 0 if unbounded */
+  uint64_t GetLimit() const { return limit_; }
+
+  /** The number of bytes currently reserved */
+  uint64_t GetReserved() const { return reserved_.load(); }
+
+ private:
+  const uint64_t limit_;
+
+  // The bytes currently reserved
+  std::atomic<uint64_t> reserved_;
+};
+
+}  // namespace peloton
@@ -0,0 +1,105 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// parameterized_plan_cache.h
+//
+// Identification: src/include/common/parameterized_plan_cache.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/statement.h"
+#include "common/statement_cache.h"
+
+#define DEFAULT_PARAMETERIZED_PLAN_CACHE_SIZE 100
+
+namespace peloton {
+
+namespace expression {
+class AbstractExpression;
+}
+
+namespace parser {
+class SQLStatement;
+}
+
+/**
+ * @brief Cache of the optimized plans of simple (i.e., not prepared) queries.
+ *
+ * Before a simple query is planned, its literals are replaced by parameters so
+ * that queries that only differ in their literal values share the same
+ * statement. The statement is keyed by the normalized query string, where
+ * every literal is replaced by a placeholder, together with the types of the
+ * extracted literals.
+ *
+ * The statements are kept in a StatementCache that is registered with the
+ * StatementCacheManager, so that a DDL on a table marks the statements that
+ * reference it for replanning. Such a statement is dropped on lookup.
+ */
+class ParameterizedPlanCache {
+ public:
+  ParameterizedPlanCache(const ParameterizedPlanCache &) = delete;
+  ParameterizedPlanCache &operator=(const ParameterizedPlanCache &) = delete;
+
+  explicit ParameterizedPlanCache(
+      size_t capacity = DEFAULT_PARAMETERIZED_PLAN_CACHE_SIZE);
+
+  ~ParameterizedPlanCache();
+
+  /**
+   * @brief Replace the literals of the parse tree with parameters.
+   *
+   * Only SELECT, INSERT, UPDATE and DELETE statements whose literals all
+   * appear as an operand of a comparison in the WHERE clause, as an INSERT
+   * value or as an UPDATE value are parameterized. Otherwise (e.g., literals
+   * in the select list or in a LIMIT clause) the parse tree is left untouched.
+   *
+   * @param query_string The original query string
+   * @param sql_stmt The parse tree of the query
+   * @param[out] parameters The extracted literals, in parameter order
+   * @return The fingerprint of the query, or an empty string if the query
+   * cannot be parameterized
+   */
+  static std::string Parameterize(
+      const std::string &query_string, parser::SQLStatement *sql_stmt,
+      std::vector<std::unique_ptr<expression::AbstractExpression>>
+          &parameters);
+
+  // Get the statement by its fingerprint, nullptr if there is none or if it
+  // needs to be replanned
+  std::shared_ptr<Statement> GetStatement(const std::string &fingerprint);
+
+  // Add a statement to the cache
+  void AddStatement(const std::string &fingerprint,
+                    std::shared_ptr<Statement> statement);
+
+  // Delete the statement
+  void DeleteStatement(const std::string &fingerprint);
+
+  // Clear the cache
+  void Clear();
+
+  size_t GetSize() const { return lru_list_.size(); }
+
+ private:
+  // Fingerprint -> Statement
+  StatementCache statement_cache_;
+
+  // The fingerprints of the cached statements, most recently used first
+  std::list<std::string> lru_list_;
+  std::unordered_map<std::string, std::list<std::string>::iterator> lru_map_;
+
+  size_t capacity_;
+};
+
+}  // namespace peloton
@@ -50,7 +50,10 @@ class StatementCache {
   // Add a statement to the cache
   void AddStatement(std::shared_ptr<Statement> stmt);
 
-  // Get the statement by its name;
+  // Add a statement to the cache under the given name
+  void AddStatement(const std::string &name, std::shared_ptr<Statement> stmt);
+
+  // Get the statement by its name, nullptr if there is none
   std::shared_ptr<Statement> GetStatement(std::string name);
 
   // Delete the statement
@@ -19,8 +19,9 @@ namespace peloton {
 
 // TODO(Tianyi) remove this singleton
 class StatementCacheManager;
-// Singleton statement_cache_manager
-static std::shared_ptr<StatementCacheManager> statement_cache_manager;
+// Singleton statement_cache_manager. It is defined in one translation unit, so
+// that the instance created by Init() is the one every caller sees.
+extern std::shared_ptr<StatementCacheManager> statement_cache_manager;
 
 /**
  * The manager that stores all the registered statement caches.
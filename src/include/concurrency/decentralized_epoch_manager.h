@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <thread>
 #include <vector>
 
@@ -28,22 +30,39 @@
 namespace peloton {
 namespace concurrency {
 
+// Number of local epochs. Threads whose ids are this far apart share one.
+#define MAX_LOCAL_EPOCH_COUNT 256
+
 /**
  * @brief      Class for decentralized epoch manager.
+ *
+ * The local epochs live in a fixed-size array indexed by the thread id, so
+ * that transactions find theirs without taking local_epoch_lock_. The lock
+ * only serializes registering threads. Deregistering a thread leaves its local
+ * epoch in place, so that its transactions keep their epochs from expiring
+ * until they exit, and the local epochs are only deleted on reset.
  */
 class DecentralizedEpochManager : public EpochManager {
   DecentralizedEpochManager(const DecentralizedEpochManager&) = delete;
 
 public:
-  DecentralizedEpochManager() : 
-    current_global_epoch_id_(1), 
+  DecentralizedEpochManager() :
+    local_epoch_count_(0),
+    current_global_epoch_id_(1),
     next_txn_id_(0),
     snapshot_global_epoch_id_(1),
     is_running_(false) {
+      for (auto &local_epoch : local_epochs_) {
+        local_epoch.store(nullptr);
+      }
       // register a default thread for handling catalog stuffs.
       RegisterThread(0);
   }
 
+  ~DecentralizedEpochManager() {
+    ClearThreads();
+  }
+
   /**
    * @brief      Gets the instance.
    *
@@ -70,8 +89,8 @@ public:
     current_global_epoch_id_ = current_epoch_id;
     next_txn_id_ = 0;
     snapshot_global_epoch_id_ = 1;
-    local_epochs_.clear();
-    
+    ClearThreads();
+
     RegisterThread(0);
   }
 
@@ -113,21 +132,9 @@ public:
     this->is_running_ = false;
   }
 
-  virtual void RegisterThread(const size_t thread_id) override {
-    local_epoch_lock_.Lock();
-
-    local_epochs_[thread_id].reset(new LocalEpoch(thread_id));
+  virtual void RegisterThread(const size_t thread_id) override;
 
-    local_epoch_lock_.Unlock();
-  }
-
-  virtual void DeregisterThread(const size_t thread_id) override {
-    local_epoch_lock_.Lock();
-
-    local_epochs_.erase(thread_id);
-
-    local_epoch_lock_.Unlock();
-  }
+  virtual void DeregisterThread(const size_t thread_id) override;
 
   /**
    * @brief      A transaction enters epoch with thread id
@@ -185,6 +192,29 @@ public:
 
 private:
 
+  /**
+   * @brief      Gets the local epoch of the thread, registering the thread
+   *             if it's not yet.
+   *
+   * @param[in]  thread_id  The thread identifier
+   *
+   * @return     The local epoch.
+   */
+  inline LocalEpoch *GetLocalEpoch(const size_t thread_id) {
+    LocalEpoch *local_epoch =
+        local_epochs_[thread_id % MAX_LOCAL_EPOCH_COUNT].load();
+    if (local_epoch == nullptr) {
+      RegisterThread(thread_id);
+      local_epoch = local_epochs_[thread_id % MAX_LOCAL_EPOCH_COUNT].load();
+    }
+    return local_epoch;
+  }
+
+  /**
+   * @brief      Deletes the local epochs of all threads. Must only be called
+   *             while no transaction is running.
+   */
+  void ClearThreads();
 
   /**
    * @brief      Gets the next transaction identifier.
@@ -214,7 +244,11 @@ private:
    * It updates the local epoch to report their local time.
    */
   common::synchronization::SpinLatch local_epoch_lock_;
-  std::unordered_map<int, std::unique_ptr<LocalEpoch>> local_epochs_;
+  std::atomic<LocalEpoch *> local_epochs_[MAX_LOCAL_EPOCH_COUNT];
+
+  /** One past the highest index of local_epochs_ that was ever used */
+  std::atomic<size_t> local_epoch_count_;
+
   
   /** The global epoch reflects the true time of the system. */
   std::atomic<eid_t> current_global_epoch_id_;
@@ -224,7 +258,7 @@ private:
    * Snapshot epoch is an epoch where the corresponding tuples may be still
    * visible to on-the-fly transactions
    */
-  eid_t snapshot_global_epoch_id_;
+  std::atomic<eid_t> snapshot_global_epoch_id_;
 
   bool is_running_;
 
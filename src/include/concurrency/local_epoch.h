@@ -13,60 +13,46 @@
 
 #pragma once
 
-#include <thread>
-#include <queue>
-#include <vector>
-#include <unordered_map>
-#include <functional>
+#include <atomic>
 #include <cstdint>
 
 #include "common/internal_types.h"
-#include "common/synchronization/spin_latch.h"
+#include "common/platform.h"
 
 namespace peloton {
 namespace concurrency {
 
-/**
- * @brief      Epoch struct
- *
- * @param[in]  epoch_id  The epoch identifier
- * @param[in]  txn_count  Number of transactions currently in this epoch
- * 
- */
-struct Epoch {
-  Epoch(const uint64_t epoch_id, const size_t txn_count):
-    epoch_id_(epoch_id),
-    txn_count_(txn_count) {}
-
-  Epoch(const Epoch& epoch) {
-    this->epoch_id_ = epoch.epoch_id_;
-    this->txn_count_ = epoch.txn_count_;
-  }
-
-  uint64_t epoch_id_;
-  size_t txn_count_;  /* number of transactions currently in this epoch*/
-};
-
-struct EpochCompare {
-  bool operator()(const std::shared_ptr<Epoch> &lhs, const std::shared_ptr<Epoch> &rhs) {
-    return lhs->epoch_id_ > rhs->epoch_id_;
-  }
-};
+// Number of epochs tracked by a local epoch. Must be a power of two.
+#define EPOCH_RING_SIZE 1024
 
 /**
  * @brief      Class for local epoch.
+ *
+ * Counts the transactions of a thread that are currently in each epoch, in a
+ * fixed-size ring of atomic counters indexed by the epoch id. Entering and
+ * exiting an epoch only update a counter, so they neither lock nor allocate,
+ * and may happen on different threads (transactions exit their epoch when
+ * GC recycles them).
+ *
+ * Epochs that are EPOCH_RING_SIZE apart share a counter. GC then takes the
+ * transactions of the younger epoch for ones of the older epoch, which only
+ * makes the expired epoch id more conservative.
  */
 class LocalEpoch {
 
 public:
-  LocalEpoch(const size_t thread_id) : 
-    epoch_id_lower_bound_(UINT64_MAX), 
-    thread_id_(thread_id) {}
+  LocalEpoch(const size_t thread_id) :
+    epoch_id_lower_bound_(0),
+    thread_id_(thread_id) {
+    for (auto &txn_count : txn_counts_) {
+      txn_count.store(0, std::memory_order_relaxed);
+    }
+  }
 
   bool EnterEpoch(const eid_t epoch_id, const TimestampType ts_type);
 
   void ExitEpoch(const eid_t epoch_id);
-  
+
   /**
    * @brief      Gets the expired epoch identifier.
    *
@@ -76,15 +62,31 @@ public:
    */
   uint64_t GetExpiredEpochId(const uint64_t current_epoch_id);
 
+  size_t GetThreadId() const { return thread_id_; }
+
 private:
-  common::synchronization::SpinLatch epoch_lock_;
-  
-  uint64_t epoch_id_lower_bound_;
+  inline std::atomic<uint32_t> &GetTxnCount(const eid_t epoch_id) {
+    return txn_counts_[epoch_id & (EPOCH_RING_SIZE - 1)];
+  }
+
+  /**
+   * @brief      Gets the oldest epoch in [from, to) that has transactions.
+   *
+   * @return     The epoch identifier, or to if there is none.
+   */
+  eid_t GetOldestActiveEpochId(const eid_t from, const eid_t to);
+
+  // Every epoch up to the lower bound has expired. Written by GC and read by
+  // every transaction that enters an epoch.
+  std::atomic<eid_t> epoch_id_lower_bound_;
 
   size_t thread_id_;
-  
-  std::priority_queue<std::shared_ptr<Epoch>, std::vector<std::shared_ptr<Epoch>>, EpochCompare> epoch_queue_;
-  std::unordered_map<uint64_t, std::shared_ptr<Epoch>> epoch_map_;
+
+  // Keep the lower bound and the counters on different cache lines
+  char padding_[CACHELINE_SIZE];
+
+  // Number of transactions currently in each epoch
+  std::atomic<uint32_t> txn_counts_[EPOCH_RING_SIZE];
 };
 
 }
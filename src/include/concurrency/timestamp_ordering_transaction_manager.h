@@ -220,6 +220,20 @@ class TimestampOrderingTransactionManager : public TransactionManager {
   virtual void PerformDelete(TransactionContext *const current_txn,
                              const ItemPointer &location);
 
+  /**
+   * @brief      Perform an update operation in place, in a table with delta
+   *             storage. Used when the transaction is the owner of the tuple.
+   *
+   * @param      current_txn  The current transaction
+   * @param[in]  location     The location of the tuple
+   * @param[in]  new_tuple    The new values, in the table schema
+   * @param[in]  column_ids   The columns to update
+   */
+  virtual void PerformUpdate(TransactionContext *const current_txn,
+                             const ItemPointer &location,
+                             const storage::Tuple *new_tuple,
+                             const std::vector<oid_t> &column_ids);
+
   /**
    * @brief      Commits a transaction.
    *
@@ -252,6 +266,33 @@ class TimestampOrderingTransactionManager : public TransactionManager {
   bool SetLastReaderCommitId(
       const storage::TileGroupHeader *const tile_group_header,
       const oid_t &tuple_id, const cid_t &current_cid, const bool is_owner);
+
+  /**
+   * @brief      Restore the values that the current transaction changed in
+   *             place in a tuple, and unlink its undo records from the slot.
+   *
+   * @param      current_txn  The current transaction
+   * @param[in]  location     The location of the tuple
+   */
+  void UndoInPlaceUpdates(TransactionContext *const current_txn,
+                          const ItemPointer &location);
+
+  /**
+   * @brief      Whether the tuple of an updated or deleted entry of the read
+   *             write set was updated in place, rather than by installing a
+   *             newer version.
+   *
+   * @param[in]  tile_group_header  The tile group header
+   * @param[in]  tuple_id           The tuple identifier
+   *
+   * @return     True if updated in place, False otherwise
+   */
+  static bool IsUpdatedInPlace(
+      const storage::TileGroupHeader *const tile_group_header,
+      const oid_t &tuple_id) {
+    return tile_group_header->HasUndoChains() &&
+           tile_group_header->GetPrevItemPointer(tuple_id).IsNull();
+  }
 };
 }
 }
@@ -26,6 +26,10 @@
 
 namespace peloton {
 
+namespace storage {
+class UndoRecord;
+}  // namespace storage
+
 namespace trigger {
 class TriggerSet;
 class TriggerData;
@@ -51,9 +55,9 @@ class TransactionContext : public Printable {
               const cid_t &read_id, const cid_t &commit_id);
 
   /**
-   * @brief      Destroys the object.
+   * @brief      Destroys the object, and frees its undo garbage.
    */
-  ~TransactionContext() = default;
+  ~TransactionContext();
 
  private:
   void Init(const size_t thread_id, const IsolationLevelType isolation,
@@ -226,6 +230,17 @@ class TransactionContext : public Printable {
    */
   inline bool IsGCSetEmpty() { return gc_set_->size() == 0; }
 
+  /**
+   * @brief      Hand over an undo record that no transaction links to
+   *             anymore. It is freed with the context, once the transactions
+   *             that might still read it have finished.
+   *
+   * @param      undo_record  The undo record
+   */
+  inline void AddUndoGarbage(storage::UndoRecord *undo_record) {
+    undo_garbage_.push_back(undo_record);
+  }
+
   /**
    * @brief      Determines if gc object set empty.
    *
@@ -331,6 +346,9 @@ class TransactionContext : public Printable {
   std::shared_ptr<GCSet> gc_set_;
   std::shared_ptr<GCObjectSet> gc_object_set_;
 
+  /** undo records unlinked by or on behalf of the transaction */
+  std::vector<storage::UndoRecord *> undo_garbage_;
+
   /** result of the transaction */
   ResultType result_ = ResultType::SUCCESS;
 
@@ -32,7 +32,9 @@ class ItemPointer;
 
 namespace storage {
 class DataTable;
+class TileGroup;
 class TileGroupHeader;
+class Tuple;
 }
 
 namespace catalog {
@@ -94,6 +96,26 @@ class TransactionManager {
       const oid_t &tuple_id,
       const VisibilityIdType type = VisibilityIdType::READ_ID);
 
+  /**
+   * @brief      Read the version of a tuple that is visible to the current
+   *             transaction. Unlike IsVisible(), this also finds the older
+   *             versions of tuples that were updated in place, by applying
+   *             the undo records of the slot to a copy of the newest one.
+   *
+   * @param      current_txn  The current transaction
+   * @param      tile_group   The tile group
+   * @param[in]  tuple_id     The tuple identifier
+   * @param      version      A tuple of the table schema that receives the
+   *                          version
+   * @param[out] is_newest    Whether the version is the one in the slot
+   *
+   * @return     The visibility of the version read
+   */
+  VisibilityType ReadVersion(TransactionContext *const current_txn,
+                             storage::TileGroup *tile_group,
+                             const oid_t &tuple_id, storage::Tuple *version,
+                             bool &is_newest);
+
   /**
    * Test whether the current transaction is the owner of this tuple.
    *
@@ -209,6 +231,21 @@ class TransactionManager {
   virtual void PerformDelete(TransactionContext *const current_txn,
                              const ItemPointer &location) = 0;
 
+  /**
+   * Update the columns of an owned tuple in place, in a table with delta
+   * storage. The old values that readers may still need are saved in an undo
+   * record first.
+   *
+   * @param      current_txn  The current transaction
+   * @param[in]  location     The location of the tuple
+   * @param[in]  new_tuple    The new values, in the table schema
+   * @param[in]  column_ids   The columns to update
+   */
+  virtual void PerformUpdate(TransactionContext *const current_txn,
+                             const ItemPointer &location,
+                             const storage::Tuple *new_tuple,
+                             const std::vector<oid_t> &column_ids) = 0;
+
   /**
    * @brief      Sets the transaction result.
    *
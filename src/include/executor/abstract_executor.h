@@ -62,6 +62,13 @@ class AbstractExecutor {
 
   const planner::AbstractPlan *GetRawNode() const { return node_; }
 
+  // The number of tuples this executor has handed to its parent, summed over
+  // rescans
+  size_t GetNumOutputTuples() const { return num_output_tuples_; }
+
+  // Has DExecute() reported that there is no more output?
+  bool IsExhausted() const { return exhausted_; }
+
   // Update the predicate in runtime. This is used in Nested Loop Join. Since
   // some executor do not need this function, we set it to empty function.
   virtual void UpdatePredicate(const std::vector<oid_t> &column_ids
@@ -108,6 +115,10 @@ class AbstractExecutor {
   // This is where we will write the results of the plan node's execution
   std::unique_ptr<LogicalTile> output;
 
+  size_t num_output_tuples_ = 0;
+
+  bool exhausted_ = false;
+
   /** @brief Plan node corresponding to this executor. */
   const planner::AbstractPlan *node_ = nullptr;
 
@@ -15,8 +15,15 @@
 #include "executor/abstract_executor.h"
 #include "planner/abstract_scan_plan.h"
 #include "common/internal_types.h"
+#include "storage/tuple.h"
+#include "type/value.h"
 
 namespace peloton {
+
+namespace storage {
+class TileGroup;
+}  // namespace storage
+
 namespace executor {
 
 /**
@@ -45,11 +52,46 @@ class AbstractScanExecutor : public AbstractExecutor {
 
   virtual void ResetState() {}
 
+  /**
+   * @brief Mark the scan as the one that feeds an update or a delete, which
+   * needs the tuple slots themselves rather than copies of old versions.
+   */
+  void SetForWrite(bool for_write) { for_write_ = for_write; }
+
  protected:
   bool DInit();
 
   virtual bool DExecute() = 0;
 
+  //===--------------------------------------------------------------------===//
+  // Delta Storage
+  //===--------------------------------------------------------------------===//
+
+  /**
+   * @brief Rebuild the version of a tuple slot with an undo chain that the
+   * transaction sees into version_.
+   * @param is_newest Set to whether the version is the one in the slot.
+   */
+  VisibilityType ReadVersion(storage::TileGroup *tile_group, oid_t tuple_id,
+                             bool &is_newest);
+
+  /**
+   * @brief Evaluate the predicate on version_, and perform the read of the
+   * tuple slot if it passes.
+   * @param selected Set to whether the version passed the predicate.
+   * @return false if the transaction has to abort.
+   */
+  bool SelectVersion(storage::TileGroup *tile_group, oid_t tuple_id,
+                     bool is_newest, bool acquire_owner, bool &selected);
+
+  /** @brief Copy the given columns of version_ into a new row. */
+  void AddVersion(const std::vector<oid_t> &column_ids);
+
+  /** @brief Build a logical tile out of the given rows, in order. */
+  LogicalTile *BuildVersionTile(const storage::DataTable *table,
+                                const std::vector<oid_t> &column_ids,
+                                const std::vector<size_t> &rows);
+
  protected:
   //===--------------------------------------------------------------------===//
   // Plan Info
@@ -60,6 +102,15 @@ class AbstractScanExecutor : public AbstractExecutor {
 
   /** @brief Columns from tile group to be added to logical tile output. */
   std::vector<oid_t> column_ids_;
+
+  /** @brief Whether the scan feeds an update or a delete. */
+  bool for_write_ = false;
+
+  /** @brief The version last rebuilt by ReadVersion(). */
+  std::unique_ptr<storage::Tuple> version_;
+
+  /** @brief The rows added by AddVersion(), one after the other. */
+  std::vector<type::Value> version_values_;
 };
 
 }  // namespace executor
@@ -17,6 +17,7 @@
 
 #include "common/container_tuple.h"
 #include "executor/abstract_executor.h"
+#include "executor/flat_hash_table.h"
 #include "planner/aggregate_plan.h"
 #include "type/value_factory.h"
 #include "type/value_peeker.h"
@@ -317,11 +318,31 @@ class HashAggregator : public AbstractAggregator {
                              ValueVectorHasher, ValueVectorCmp>
       HashAggregateMapType;
 
+  /** @brief Pick the hash table based on the group-by key types */
+  void InitHashTable(const AbstractTuple *first_tuple);
+
+  /** @brief Allocate the aggregates of a new group */
+  AggregateList *CreateAggregateList(const AbstractTuple *first_tuple);
+
+  void DeleteAggregateList(AggregateList *aggregate_list);
+
   /** @brief Group by key values used */
   std::vector<type::Value> group_by_key_values;
 
   /** @brief Hash table */
   HashAggregateMapType aggregates_map;
+
+  /** @brief Whether the hash table to use has been picked */
+  bool hash_table_initialized = false;
+
+  /**
+   * @brief Hash table over the serialized group-by keys, used instead of
+   * aggregates_map when all of them have fixed-size types
+   */
+  std::unique_ptr<FlatHashTable> flat_aggregates_map;
+
+  /** @brief Serialized group-by key */
+  std::vector<char> group_by_key;
 };
 
 /**
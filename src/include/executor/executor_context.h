@@ -13,6 +13,7 @@
 #pragma once
 
 #include "codegen/query_parameters.h"
+#include "common/memory_tracker.h"
 #include "type/ephemeral_pool.h"
 #include "type/value.h"
 
@@ -33,9 +34,11 @@ namespace executor {
  */
 class ExecutorContext {
  public:
-  /// Constructor
+  /// Constructor. The memory of the execution counts towards the given
+  /// tracker, or towards the memory governor's if there is none.
   ExecutorContext(concurrency::TransactionContext *transaction,
-                  codegen::QueryParameters parameters = {});
+                  codegen::QueryParameters parameters = {},
+                  MemoryTracker *parent_tracker = nullptr);
 
   /// This class cannot be copy or move-constructed
   DISALLOW_COPY_AND_MOVE(ExecutorContext);
@@ -61,6 +64,15 @@ class ExecutorContext {
   /// Return the memory pool for this particular query execution
   type::EphemeralPool *GetPool();
 
+  /// Return the memory that the hash tables and sorters of this execution,
+  /// built by any of its threads, share before they spill to disk
+  MemoryBudget &GetMemoryBudget();
+
+  /// Return the tracker of the memory used by this particular query execution.
+  /// Whatever holds on to memory that may outlive the execution, such as
+  /// materialized tiles, keeps a reference to the tracker.
+  const std::shared_ptr<MemoryTracker> &GetMemoryTracker() const;
+
   class ThreadStates {
    public:
     explicit ThreadStates(type::EphemeralPool &pool);
@@ -101,6 +113,10 @@ class ExecutorContext {
   codegen::QueryParameters parameters_;
   // The storage manager instance
   storage::StorageManager *storage_manager_;
+  // The memory that the query may use before spilling
+  MemoryBudget memory_budget_;
+  // The memory used by this execution
+  std::shared_ptr<MemoryTracker> memory_tracker_;
   // Temporary memory pool for allocations done during execution
   type::EphemeralPool pool_;
   // Container for all states of all thread participating in this execution
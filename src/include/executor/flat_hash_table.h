@@ -0,0 +1,128 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// flat_hash_table.h
+//
+// Identification: src/include/executor/flat_hash_table.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "codegen/util/oa_hash_table.h"
+#include "common/internal_types.h"
+#include "common/macros.h"
+#include "type/type_id.h"
+
+namespace peloton {
+
+class AbstractTuple;
+
+namespace executor {
+
+/**
+ * @brief Open-addressing hash table over fixed-size keys for the interpreted
+ * executors.
+ *
+ * Hashing std::vector<type::Value> or ContainerTuple keys in std::unordered_map
+ * costs several heap allocations and virtual calls per row. When all key
+ * columns have fixed-size types, the keys are instead serialized into
+ * fixed-width byte strings and stored inline in a codegen::util::OAHashTable,
+ * together with fixed-size values. Keys are compared byte-wise.
+ *
+ * Integers of every width are widened to 64 bits, so that keys of different
+ * integer types can be matched against each other. Like in the value-based
+ * tables, NULL keys are equal to each other.
+ */
+class FlatHashTable {
+ public:
+  typedef codegen::util::OAHashTable::HashEntry HashEntry;
+  typedef codegen::util::OAHashTable::Iterator Iterator;
+
+  DISALLOW_COPY_AND_MOVE(FlatHashTable);
+
+  /**
+   * @param key_types The types of the key columns
+   * @param value_size The size of the values stored for each key
+   */
+  FlatHashTable(const std::vector<type::TypeId> &key_types,
+                uint64_t value_size);
+
+  /** @brief Whether keys of the given types can be stored in the table */
+  static bool IsSupported(const std::vector<type::TypeId> &key_types);
+
+  /**
+   * @brief Whether keys of one set of types can be matched against keys of
+   * another by comparing their serialized bytes.
+   */
+  static bool IsCompatible(const std::vector<type::TypeId> &key_types,
+                           const std::vector<type::TypeId> &other_key_types);
+
+  /** @brief The size of a serialized key in bytes */
+  uint64_t GetKeySize() const { return key_size_; }
+
+  /**
+   * @brief Serialize the key columns of a tuple.
+   *
+   * @param tuple The tuple
+   * @param column_ids The ids of the key columns in the tuple
+   * @param[out] key GetKeySize() bytes to serialize the key into
+   * @return The hash of the key
+   */
+  uint64_t MakeKey(const AbstractTuple &tuple,
+                   const std::vector<oid_t> &column_ids, char *key) const;
+
+  /** @brief The entry holding the values of the key, or nullptr */
+  HashEntry *Find(uint64_t hash, const char *key) const;
+
+  /**
+   * @brief Add a value for the key.
+   *
+   * @param[out] new_key Whether the key wasn't in the table yet
+   * @return Where to store the value
+   */
+  char *Insert(uint64_t hash, const char *key, bool &new_key);
+
+  /**
+   * @brief Get the value of the key, adding one if the key isn't in the table.
+   *
+   * @param[out] new_key Whether the value was added
+   * @return The value
+   */
+  char *FindOrInsert(uint64_t hash, const char *key, bool &new_key);
+
+  /** @brief The number of values stored for the key of an entry */
+  uint32_t NumValues(const HashEntry *entry) const {
+    return table_.NumValues(entry);
+  }
+
+  /** @brief The idx-th value stored for the key of an entry */
+  char *GetValue(HashEntry *entry, uint32_t idx) const {
+    return table_.GetValue(entry, idx);
+  }
+
+  /** @brief The total number of values in the table */
+  uint64_t NumEntries() const { return table_.NumEntries(); }
+
+  /** @brief Iterate over all keys and values in the table */
+  Iterator begin() { return table_.begin(); }
+  Iterator end() { return table_.end(); }
+
+ private:
+  // The number of key columns
+  size_t num_key_columns_;
+
+  // Each key column takes 8 bytes, followed by a NULL flag byte per column.
+  // The flags are padded to 8 bytes to keep the values aligned.
+  uint64_t key_size_;
+
+  codegen::util::OAHashTable table_;
+};
+
+}  // namespace executor
+}  // namespace peloton
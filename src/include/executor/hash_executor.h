@@ -16,6 +16,7 @@
 
 #include "common/internal_types.h"
 #include "executor/abstract_executor.h"
+#include "executor/flat_hash_table.h"
 #include "executor/logical_tile.h"
 #include "common/container_tuple.h"
 
@@ -49,8 +50,27 @@ class HashExecutor : public AbstractExecutor {
       ContainerTupleHasher<LogicalTile>,
       ContainerTupleComparator<LogicalTile>> HashMapType;
 
+  /** @brief Location of a tuple: < child_tile offset, tuple offset > */
+  typedef std::pair<size_t, oid_t> HashLocation;
+
   inline HashMapType &GetHashTable() { return this->hash_table_; }
 
+  /**
+   * @brief The flat hash table of HashLocations, or nullptr if the tuples are
+   * in GetHashTable()
+   */
+  inline FlatHashTable *GetFlatHashTable() {
+    return this->flat_hash_table_.get();
+  }
+
+  /**
+   * @brief Set the types of the keys the hash table will be probed with. The
+   * flat hash table is only used if they're serialized like the hash keys.
+   */
+  inline void SetProbeKeyTypes(const std::vector<type::TypeId> &key_types) {
+    this->probe_key_types_ = key_types;
+  }
+
   inline const std::vector<oid_t> &GetHashKeyIds() const {
     return this->column_ids_;
   }
@@ -64,6 +84,11 @@ class HashExecutor : public AbstractExecutor {
   /** @brief Hash table */
   HashMapType hash_table_;
 
+  /** @brief Hash table over serialized keys, used when they're fixed-size */
+  std::unique_ptr<FlatHashTable> flat_hash_table_;
+
+  std::vector<type::TypeId> probe_key_types_;
+
   /** @brief Input tiles from child node */
   std::vector<std::unique_ptr<LogicalTile>> child_tiles_;
 
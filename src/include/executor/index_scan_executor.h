@@ -12,15 +12,20 @@
 
 #pragma once
 
+#include <unordered_map>
 #include <vector>
 
 #include "executor/abstract_scan_executor.h"
 #include "index/scan_optimizer.h"
 
+// Number of index entries pulled at a time when the scan has no limit
+#define INDEX_SCAN_BATCH_SIZE 1024
+
 namespace peloton {
 
 namespace index {
 class Index;
+class IndexIterator;
 }
 
 namespace storage {
@@ -61,6 +66,24 @@ class IndexScanExecutor : public AbstractScanExecutor {
   bool ExecPrimaryIndexLookup();
   bool ExecSecondaryIndexLookup();
 
+  // Start the index scan in the direction of the plan
+  std::unique_ptr<index::IndexIterator> GetIndexIterator();
+
+  // Are enough tuples visible to produce the limit of the plan (if any)?
+  bool IsLimitReached(const std::vector<ItemPointer> &tuple_locations) const;
+
+  // The number of index entries to pull next, which is at most the number of
+  // tuples still missing from the limit
+  size_t GetIndexBatchSize(
+      const std::vector<ItemPointer> &tuple_locations) const;
+
+  // Move to the given entry of the current batch, pulling the next batch from
+  // the iterator once the current one is exhausted. Returns false at the end
+  // of the scan, or once the visible tuples fill the limit.
+  bool NextIndexEntry(index::IndexIterator &index_itr,
+                      std::vector<ItemPointer *> &tuple_location_ptrs,
+                      size_t &entry, std::vector<ItemPointer> &tuple_locations);
+
   // When the required scan range has open boundaries, the tuples found by the
   // index might not be exact since the index can only give back tuples in a
   // close range. This function prune the head and the tail of the returned
@@ -68,10 +91,30 @@ class IndexScanExecutor : public AbstractScanExecutor {
   void CheckOpenRangeWithReturnedTuples(
       std::vector<ItemPointer> &tuple_locations);
 
+  // Prune the head of the tuples returned so far, as soon as they are found,
+  // so that they do not count towards the limit
+  void PruneLeadingOpenRange(std::vector<ItemPointer> &tuple_locations);
+
   // Check whether the tuple at a given location satisfies the required
   // conditions on key columns
   bool CheckKeyConditions(const ItemPointer &tuple_location);
 
+  // Select the version of a delta storage tuple that ReadVersion() rebuilt,
+  // and keep a copy of it unless the scan feeds an update or a delete
+  bool SelectVisibleVersion(storage::TileGroup *tile_group,
+                            const ItemPointer &tuple_location, bool is_newest,
+                            bool acquire_owner,
+                            std::vector<ItemPointer> &tuple_locations);
+
+  // Build the result out of the copied versions of the tuples, in the order
+  // they are found in
+  void BuildVersionResult(const std::vector<ItemPointer> &tuple_locations);
+
+  // The columns that the scan returns
+  const std::vector<oid_t> &GetOutputColumnIds() const {
+    return column_ids_.empty() ? full_column_ids_ : column_ids_;
+  }
+
   //===--------------------------------------------------------------------===//
   // Executor State
   //===--------------------------------------------------------------------===//
@@ -114,10 +157,10 @@ class IndexScanExecutor : public AbstractScanExecutor {
 
   bool key_ready_ = false;
 
-  // whether the index scan range is left open
+  // whether the index scan range is left open (in the scan direction)
   bool left_open_ = false;
 
-  // whether the index scan range is right open
+  // whether the index scan range is right open (in the scan direction)
   bool right_open_ = false;
 
   // copy from underlying plan
@@ -134,6 +177,10 @@ class IndexScanExecutor : public AbstractScanExecutor {
 
   // whether order by is descending
   bool descend_ = false;
+
+  // the row of each copied delta storage version, by tuple location
+  std::unordered_map<ItemPointer, size_t, ItemPointerHasher,
+                     ItemPointerComparator> version_rows_;
 };
 
 }  // namespace executor
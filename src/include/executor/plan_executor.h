@@ -12,22 +12,37 @@
 
 #pragma once
 
+#include <unordered_map>
+
 #include "common/internal_types.h"
 #include "common/statement.h"
 #include "executor/logical_tile.h"
 
 namespace peloton {
 
+class MemoryTracker;
+
 namespace concurrency {
 class TransactionContext;
 }  // namespace concurrency
 
+namespace planner {
+class AbstractPlan;
+}  // namespace planner
+
 namespace type {
 class Value;
 }  // namespace type
 
 namespace executor {
 
+/**
+ * The number of rows each node of an executed plan produced, for
+ * EXPLAIN ANALYZE. Nodes that were never executed have no entry.
+ */
+typedef std::unordered_map<const planner::AbstractPlan *, size_t>
+    PlanActualRows;
+
 /**
  * The result of the execution of a query/
  */
@@ -59,6 +74,11 @@ class PlanExecutor {
    * @param params All parameters the query references
    * @param result_format No idea ...
    * @param on_complete The callback function to invoke when the query finishes.
+   * @param actual_rows If not null, the plan is interpreted, so that the rows
+   * produced by each plan node can be counted, and the counts are filled in
+   * before on_complete is invoked
+   * @param memory_tracker If not null, the memory used by the execution counts
+   * towards this tracker
    */
   static void ExecutePlan(
       std::shared_ptr<planner::AbstractPlan> plan,
@@ -66,7 +86,9 @@ class PlanExecutor {
       const std::vector<type::Value> &params,
       const std::vector<int> &result_format,
       std::function<void(executor::ExecutionResult,
-                         std::vector<ResultValue> &&)> on_complete);
+                         std::vector<ResultValue> &&)> on_complete,
+      PlanActualRows *actual_rows = nullptr,
+      MemoryTracker *memory_tracker = nullptr);
 
   /**
    * @brief When a peloton node recvs a query plan, this function is invoked
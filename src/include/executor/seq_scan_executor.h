@@ -14,6 +14,7 @@
 
 #include "planner/seq_scan_plan.h"
 #include "executor/abstract_scan_executor.h"
+#include "expression/batch_expression_evaluator.h"
 
 namespace peloton {
 namespace executor {
@@ -55,6 +56,10 @@ class SeqScanExecutor : public AbstractScanExecutor {
   expression::AbstractExpression *ColumnValueToCmpExpr(
       const oid_t column_id, const type::Value &value);
 
+  void RemoveUnselected(LogicalTile *tile,
+                        const std::vector<oid_t> &visible_tuples,
+                        const std::vector<oid_t> &selected_tuples);
+
   //===--------------------------------------------------------------------===//
   // Executor State
   //===--------------------------------------------------------------------===//
@@ -81,6 +86,10 @@ class SeqScanExecutor : public AbstractScanExecutor {
   // The original predicate, if it's not nullptr
   // we need to combine it with the undated predicate 
   const expression::AbstractExpression *old_predicate_;
+
+  // The predicate prepared for batch evaluation, or nullptr if it can only be
+  // evaluated one tuple at a time
+  std::unique_ptr<expression::BatchExpressionEvaluator> batch_predicate_;
 };
 
 }  // namespace executor
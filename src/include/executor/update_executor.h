@@ -45,6 +45,12 @@ class UpdateExecutor : public AbstractExecutor {
                                oid_t physical_tuple_id,
                                ItemPointer &old_location);
 
+  bool PerformUpdateInPlace(bool is_owner,
+                            storage::TileGroup *tile_group,
+                            storage::TileGroupHeader *tile_group_header,
+                            oid_t physical_tuple_id,
+                            ItemPointer &old_location);
+
   bool DInit();
 
   bool DExecute();
@@ -57,6 +63,13 @@ class UpdateExecutor : public AbstractExecutor {
   storage::DataTable *target_table_ = nullptr;
   const planner::ProjectInfo *project_info_ = nullptr;
 
+  // The columns that the update may change
+  std::vector<oid_t> update_columns_;
+
+  // Whether committed tuples are updated in place rather than by installing
+  // a new version. See DataTable::CanUpdateInPlace().
+  bool update_in_place_ = false;
+
   // Write set for tracking newly created tuples inserted by the same statement
   // This statement-level write set is essential for avoiding the Halloween Problem,
   // which refers to the phenomenon that an update operation causes a change to
@@ -0,0 +1,100 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// batch_expression_evaluator.h
+//
+// Identification: src/include/expression/batch_expression_evaluator.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "common/internal_types.h"
+#include "common/macros.h"
+
+namespace peloton {
+
+namespace executor {
+class ExecutorContext;
+class LogicalTile;
+}  // namespace executor
+
+namespace storage {
+class TileGroup;
+}  // namespace storage
+
+namespace expression {
+
+class AbstractExpression;
+
+/**
+ * @brief Evaluates a predicate on a batch of tuples at a time.
+ *
+ * AbstractExpression::Evaluate() evaluates a predicate one tuple at a time and
+ * boxes every intermediate result in a type::Value. The batch evaluator
+ * instead reads the columns the predicate uses for all tuples of the batch
+ * into typed vectors, and applies each comparison, arithmetic operator and
+ * conjunction to whole vectors in tight loops. The tuples of the batch are
+ * given by a selection vector; a conjunction only evaluates its right side on
+ * the tuples that its left side does not decide.
+ *
+ * Only predicates made of comparisons, arithmetic (+, -, *, /), NOT, AND and
+ * OR over numeric columns, constants and parameters can be evaluated in
+ * batches. Everything else is left to the tuple-at-a-time path.
+ */
+class BatchExpressionEvaluator {
+ public:
+  class Node;
+
+  DISALLOW_COPY_AND_MOVE(BatchExpressionEvaluator);
+
+  ~BatchExpressionEvaluator();
+
+  /**
+   * @brief Prepare a predicate for batch evaluation.
+   *
+   * @param predicate The predicate
+   * @param context The executor context, whose parameter values are bound
+   * into the evaluator
+   * @return The evaluator, or nullptr if the predicate can't be evaluated in
+   * batches
+   */
+  static std::unique_ptr<BatchExpressionEvaluator> Create(
+      const AbstractExpression *predicate, executor::ExecutorContext *context);
+
+  /**
+   * @brief Evaluate the predicate on tuples of a logical tile.
+   *
+   * @param tile The logical tile
+   * @param[in,out] selection The ids of the tuples to evaluate the predicate
+   * on. Only the ones that satisfy the predicate are left in it.
+   * @param keep_null Whether to keep the tuples the predicate is NULL for
+   * @return false if the columns of the tile can't be evaluated in batches,
+   * in which case the selection is untouched
+   */
+  bool Filter(executor::LogicalTile *tile, std::vector<oid_t> &selection,
+              bool keep_null) const;
+
+  /**
+   * @brief Evaluate the predicate on tuples of a tile group.
+   *
+   * @see Filter() on a logical tile. The predicate's columns are the columns
+   * of the table.
+   */
+  bool Filter(storage::TileGroup *tile_group, std::vector<oid_t> &selection,
+              bool keep_null) const;
+
+ private:
+  explicit BatchExpressionEvaluator(std::unique_ptr<Node> root);
+
+  std::unique_ptr<Node> root_;
+};
+
+}  // namespace expression
+}  // namespace peloton
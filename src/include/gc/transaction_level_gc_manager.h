@@ -16,6 +16,7 @@
 #include <map>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "common/init.h"
@@ -148,6 +149,11 @@ class TransactionLevelGCManager : public GCManager {
 
   bool ResetTuple(const ItemPointer &);
 
+  // this function marks the tile groups that hold the versions a committed
+  // transaction wrote all visible, so that scans can skip their visibility
+  // checks once nobody else writes to them.
+  void MarkAllVisible(concurrency::TransactionContext *txn_ctx);
+
   // this function iterates the gc context and unlinks every version
   // from the indexes.
   // this function will call the UnlinkVersion() function.
@@ -156,6 +162,12 @@ class TransactionLevelGCManager : public GCManager {
   // this function unlinks a specified version from the index.
   void UnlinkVersion(const ItemPointer location, const GCVersionType type);
 
+  // this function unlinks the undo records that no transaction can read
+  // anymore from the undo chain of a tuple updated in place, and hands them
+  // to the transaction context, which frees them when it is reclaimed.
+  void UnlinkUndoRecords(concurrency::TransactionContext *txn_ctx,
+                         const ItemPointer location, const GCVersionType type);
+
  private:
   //===--------------------------------------------------------------------===//
   // Data members
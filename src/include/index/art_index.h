@@ -86,6 +86,14 @@ class ArtIndex : public Index {
   void ScanKey(const storage::Tuple *key,
                std::vector<ItemPointer *> &result) override;
 
+  /**
+   * Forward range scans read the tree in batches as values are pulled. Point
+   * queries and backward scans use the materializing default.
+   */
+  std::unique_ptr<IndexIterator> GetIterator(
+      ScanDirectionType scan_direction,
+      const ConjunctionScanPredicate *csp_p) override;
+
   /// Return the index type
   std::string GetTypeName() const override {
     return IndexTypeToString(GetIndexMethodType());
@@ -154,19 +162,36 @@ class ArtIndex : public Index {
     void ConstructMinMaxKey(art::Key &min_key, art::Key &max_key) const;
 
    private:
-    template <typename NativeType>
-    static NativeType FlipSign(NativeType val);
+    // The index's key schema
+    const catalog::Schema &key_schema_;
+  };
 
-    // Write the provided integral data type into the buffer
-    template <typename NativeType>
-    static void WriteValue(uint8_t *data, NativeType val);
+  //===--------------------------------------------------------------------===//
+  //
+  // Iterator over the values of a forward range scan, which reads the tree
+  // only as far as the values pulled from it.
+  //
+  //===--------------------------------------------------------------------===//
+  class ScanIterator : public IndexIterator {
+   public:
+    ScanIterator(ArtIndex &index, const art::Key &start, const art::Key &end);
 
-    // Write a specified number of ASCII characters into the output buffer
-    static void WriteAsciiString(uint8_t *data, const char *val, uint32_t len);
+    size_t Next(std::vector<ItemPointer *> &result, size_t max_count) override;
 
    private:
-    // The index's key schema
-    const catalog::Schema &key_schema_;
+    // The index being scanned
+    ArtIndex &index_;
+
+    // The remaining range of the scan, where the start key is inclusive
+    art::Key start_key_;
+    art::Key end_key_;
+
+    // Are there values in the range past the buffered ones?
+    bool has_more_;
+
+    // The values read from the tree that were not returned yet
+    std::vector<TID> buffer_;
+    size_t buffer_pos_;
   };
 
  private:
@@ -2194,9 +2194,11 @@ class BwTree : public BwTreeBase {
     InnerNode &operator=(InnerNode &&) = delete;
 
     /*
-     * Destructor - Calls destructor of ElasticNode
+     * Destructor - The destructor of ElasticNode destroys the elements; it
+     *              must not be called explicitly here, since it would then run
+     *              twice, which frees keys that own memory twice
      */
-    ~InnerNode() { this->~ElasticNode<KeyNodeIDPair>(); }
+    ~InnerNode() {}
 
     /*
      * GetSplitSibling() - Split InnerNode into two halves.
@@ -2260,9 +2262,9 @@ class BwTree : public BwTreeBase {
     LeafNode &operator=(LeafNode &&) = delete;
 
     /*
-     * Destructor - Calls underlying ElasticNode d'tor
+     * Destructor - The underlying ElasticNode d'tor destroys the elements
      */
-    ~LeafNode() { this->~ElasticNode<KeyValuePair>(); }
+    ~LeafNode() {}
 
     /*
      * FindSplitPoint() - Find the split point that could divide the node
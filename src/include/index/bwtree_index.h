@@ -96,6 +96,10 @@ class BWTreeIndex : public Index {
   void ScanKey(const storage::Tuple *key,
                std::vector<ValueType> &result) override;
 
+  std::unique_ptr<IndexIterator> GetIterator(
+      ScanDirectionType scan_direction,
+      const ConjunctionScanPredicate *csp_p) override;
+
   std::string GetTypeName() const override;
 
   // TODO: Implement this
@@ -113,6 +117,30 @@ class BWTreeIndex : public Index {
   }
 
  protected:
+  /*
+   * class ScanIterator - Walks the keys of a scan as its values are pulled
+   *
+   * The range is [low key, high key], where a missing bound extends the
+   * range to that end of the index.
+   */
+  class ScanIterator : public IndexIterator {
+   public:
+    ScanIterator(BWTreeIndex *index, ScanDirectionType scan_direction,
+                 const KeyType *low_key_p, const KeyType *high_key_p);
+
+    size_t Next(std::vector<ValueType> &result, size_t max_count) override;
+
+   private:
+    BWTreeIndex *index_;
+    ScanDirectionType scan_direction_;
+    bool has_low_key_;
+    bool has_high_key_;
+    KeyType low_key_;
+    KeyType high_key_;
+    typename MapType::ForwardIterator itr_;
+    bool done_;
+  };
+
   // equality checker and comparator
   KeyComparator comparator;
   KeyEqualityChecker equals;
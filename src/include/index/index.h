@@ -170,6 +170,31 @@ class IndexMetadata : public Printable {
   static bool index_default_visibility;
 };
 
+/////////////////////////////////////////////////////////////////////
+// IndexIterator class definition
+/////////////////////////////////////////////////////////////////////
+
+/*
+ * class IndexIterator - Cursor over the values found by an index scan
+ *
+ * The values are returned in the order of their keys, in the direction of
+ * the scan, and in batches so that a caller that only needs some of them
+ * (e.g., to fill a LIMIT) can stop before the whole range is read.
+ */
+class IndexIterator {
+ public:
+  virtual ~IndexIterator() {}
+
+  /**
+   * Append at most max_count more values of the scan to the result
+   *
+   * @return The number of values appended, which is 0 once the scan is
+   * exhausted
+   */
+  virtual size_t Next(std::vector<ItemPointer *> &result,
+                      size_t max_count) = 0;
+};
+
 /////////////////////////////////////////////////////////////////////
 // Index class definition
 /////////////////////////////////////////////////////////////////////
@@ -334,6 +359,22 @@ class Index : public Printable {
   virtual void ScanKey(const storage::Tuple *key,
                        std::vector<ItemPointer *> &result) = 0;
 
+  /**
+   * Start a scan of the range specified by the scan predicate, whose values
+   * are pulled from the returned iterator. A null scan predicate scans the
+   * whole index.
+   *
+   * The default implementation performs the whole scan upfront; indexes that
+   * can walk their keys in order override it to find values as they are
+   * pulled.
+   *
+   * @param scan_direction The direction to perform the scan, either forward or
+   * backward
+   * @param csp_p The scan predicate, which must outlive the iterator
+   */
+  virtual std::unique_ptr<IndexIterator> GetIterator(
+      ScanDirectionType scan_direction, const ConjunctionScanPredicate *csp_p);
+
   //////////////////////////////////////////////////////////////////////////////
   /// Garbage Collection
   //////////////////////////////////////////////////////////////////////////////
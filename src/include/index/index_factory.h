@@ -35,6 +35,7 @@ class IndexFactory {
 
   /// BwTree factory methods
   static Index *GetBwTreeIntsKeyIndex(IndexMetadata *metadata);
+  static Index *GetBwTreeNormalizedKeyIndex(IndexMetadata *metadata);
   static Index *GetBwTreeGenericKeyIndex(IndexMetadata *metadata);
 
   /// SkipList factory methods
@@ -25,4 +25,5 @@
 
 #include "compact_ints_key.h"
 #include "generic_key.h"
+#include "normalized_key.h"
 #include "tuple_key.h"
@@ -0,0 +1,201 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// normalized_key.h
+//
+// Identification: src/include/index/normalized_key.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+#include <string>
+
+#include "common/macros.h"
+#include "storage/tuple.h"
+#include "util/hash_util.h"
+
+namespace peloton {
+
+class AbstractTuple;
+
+namespace catalog {
+class Schema;
+}  // namespace catalog
+
+namespace index {
+
+/*
+ * class KeyNormalizer - Encodes index keys into memcmp-comparable bytes
+ *
+ * A normalized key is the concatenation of its columns, each encoded so that
+ * comparing two keys of the same schema with memcmp() gives the same order as
+ * comparing their columns one by one:
+ *
+ *   - Integers, dates and booleans are stored big-endian with the sign bit
+ *     flipped, like CompactIntsKey does. Timestamps are unsigned and are only
+ *     converted to big-endian.
+ *   - Decimals have the sign bit flipped if positive, and all bits flipped if
+ *     negative, so that the IEEE 754 representation orders like the value.
+ *   - Strings are a 0x01 marker followed by the bytes, with every 0x00 byte
+ *     escaped as 0x00 0xFF, and a 0x00 0x00 terminator. This keeps the
+ *     encoding prefix-free, so a string orders before its extensions.
+ *
+ * NULLs of fixed-width types are stored as their sentinel values, which sort
+ * below the minimum value of the type (above the maximum for timestamps), the
+ * same as the other key types order them. A NULL string is the single byte
+ * 0x02, which sorts after every string, since scans use a NULL string as the
+ * upper bound of string columns.
+ */
+class KeyNormalizer {
+ public:
+  // Can every column of the key schema be normalized?
+  static bool IsSupported(const catalog::Schema &key_schema);
+
+  // The length of every normalized key of the schema, or 0 if the schema has
+  // variable-length columns
+  static size_t GetFixedLength(const catalog::Schema &key_schema);
+
+  // Write the normalized form of a key whose schema only has fixed-width
+  // columns, returning its length
+  static size_t Normalize(const AbstractTuple &key,
+                          const catalog::Schema &key_schema, uint8_t *data);
+
+  // Append the normalized form of the key to the string
+  static void Normalize(const AbstractTuple &key,
+                        const catalog::Schema &key_schema, std::string &data);
+
+  // Hex dump of a normalized key
+  static std::string GetInfo(const uint8_t *data, size_t len);
+};
+
+/*
+ * class NormalizedKey - Normalized key of a fixed-width schema
+ *
+ * The key is padded with zeros to KeySize bytes. All keys of an index have
+ * the same normalized length, so the padding does not change their order.
+ */
+template <std::size_t KeySize>
+class NormalizedKey {
+ public:
+  inline void SetFromKey(const storage::Tuple *tuple) {
+    PELOTON_ASSERT(tuple);
+    size_t len = KeyNormalizer::Normalize(*tuple, *tuple->GetSchema(), data);
+    PELOTON_ASSERT(len <= KeySize);
+    memset(data + len, 0, KeySize - len);
+  }
+
+  static inline int Compare(const NormalizedKey<KeySize> &lhs,
+                            const NormalizedKey<KeySize> &rhs) {
+    return memcmp(lhs.data, rhs.data, KeySize);
+  }
+
+  const std::string GetInfo() const {
+    return KeyNormalizer::GetInfo(data, KeySize);
+  }
+
+  uint8_t data[KeySize];
+};
+
+/**
+ * Function object returns true if lhs < rhs, used for trees
+ */
+template <std::size_t KeySize>
+class NormalizedKeyComparator {
+ public:
+  inline bool operator()(const NormalizedKey<KeySize> &lhs,
+                         const NormalizedKey<KeySize> &rhs) const {
+    return NormalizedKey<KeySize>::Compare(lhs, rhs) < 0;
+  }
+};
+
+/**
+ * Equality-checking function object
+ */
+template <std::size_t KeySize>
+class NormalizedKeyEqualityChecker {
+ public:
+  inline bool operator()(const NormalizedKey<KeySize> &lhs,
+                         const NormalizedKey<KeySize> &rhs) const {
+    return NormalizedKey<KeySize>::Compare(lhs, rhs) == 0;
+  }
+};
+
+/**
+ * Hash function object
+ */
+template <std::size_t KeySize>
+class NormalizedKeyHasher {
+ public:
+  inline size_t operator()(const NormalizedKey<KeySize> &p) const {
+    return HashUtil::HashBytes(reinterpret_cast<const char *>(p.data),
+                               KeySize);
+  }
+};
+
+/*
+ * class VarlenNormalizedKey - Normalized key of any supported schema
+ *
+ * The key only takes as many bytes as its normalized form, instead of being
+ * padded to the largest size that the schema allows.
+ */
+class VarlenNormalizedKey {
+ public:
+  inline void SetFromKey(const storage::Tuple *tuple) {
+    PELOTON_ASSERT(tuple);
+    data.clear();
+    KeyNormalizer::Normalize(*tuple, *tuple->GetSchema(), data);
+  }
+
+  // std::string compares its bytes as unsigned chars, like memcmp()
+  static inline int Compare(const VarlenNormalizedKey &lhs,
+                            const VarlenNormalizedKey &rhs) {
+    return lhs.data.compare(rhs.data);
+  }
+
+  const std::string GetInfo() const {
+    return KeyNormalizer::GetInfo(
+        reinterpret_cast<const uint8_t *>(data.data()), data.size());
+  }
+
+  std::string data;
+};
+
+/**
+ * Function object returns true if lhs < rhs, used for trees
+ */
+class VarlenNormalizedKeyComparator {
+ public:
+  inline bool operator()(const VarlenNormalizedKey &lhs,
+                         const VarlenNormalizedKey &rhs) const {
+    return VarlenNormalizedKey::Compare(lhs, rhs) < 0;
+  }
+};
+
+/**
+ * Equality-checking function object
+ */
+class VarlenNormalizedKeyEqualityChecker {
+ public:
+  inline bool operator()(const VarlenNormalizedKey &lhs,
+                         const VarlenNormalizedKey &rhs) const {
+    return lhs.data == rhs.data;
+  }
+};
+
+/**
+ * Hash function object
+ */
+class VarlenNormalizedKeyHasher {
+ public:
+  inline size_t operator()(const VarlenNormalizedKey &p) const {
+    return HashUtil::HashBytes(p.data.data(), p.data.size());
+  }
+};
+
+}  // namespace index
+}  // namespace peloton
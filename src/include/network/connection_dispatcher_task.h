@@ -40,6 +40,16 @@ class ConnectionDispatcherTask : public NotifiableTask {
    */
   ConnectionDispatcherTask(int num_handlers, int listen_fd);
 
+  /**
+   * Creates a new ConnectionDispatcherTask, spawning a handler for each of the
+   * given listening sockets. Each handler accepts connections on its own
+   * socket, so the dispatcher does not listen on any.
+   *
+   * @param handler_listen_fds The server socket fds for the handlers to listen
+   * on, usually all bound to the same port with SO_REUSEPORT.
+   */
+  explicit ConnectionDispatcherTask(const std::vector<int> &handler_listen_fds);
+
   /**
    * @brief Dispatches the client connection at fd to a handler.
    * Currently, the dispatch uses round-robin, and thread communication is
@@ -54,12 +64,28 @@ class ConnectionDispatcherTask : public NotifiableTask {
    */
   void DispatchConnection(int fd, short flags);
 
+  /**
+   * @brief Picks the handler for a new connection that was going to go to the
+   * given one. When rebalancing is enabled and the handler has noticeably more
+   * connections than the least loaded one, that one is picked instead.
+   *
+   * May be called from any handler thread.
+   *
+   * @param handler the handler the connection was going to go to
+   * @return the handler the connection should go to
+   */
+  ConnectionHandlerTask *RebalanceConnection(ConnectionHandlerTask *handler);
+
   /**
    * Breaks the dispatcher and managed handlers from their event loops.
    */
   void ExitLoop() override;
 
  private:
+  // Spawn the handlers, with the listening socket of each if they have one
+  void StartHandlers(int num_handlers,
+                     const std::vector<int> &handler_listen_fds);
+
   std::vector<std::shared_ptr<ConnectionHandlerTask>> handlers_;
   // TODO: have a smarter dispatch scheduler, we currently use round-robin
   std::atomic<int> next_handler_;
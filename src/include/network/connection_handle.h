@@ -82,6 +82,7 @@ class ConnectionHandle {
     network_event_ = conn_handler_->RegisterEvent(
         io_wrapper_->GetSocketFd(), EV_READ | EV_PERSIST,
         METHOD_AS_CALLBACK(ConnectionHandle, HandleEvent), this);
+    io_wrapper_->SetReadEvent(network_event_);
   }
 
   /**
@@ -19,14 +19,23 @@
 
 #include <unistd.h>
 
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
 #include "common/container/lock_free_queue.h"
 #include "common/exception.h"
 #include "common/logger.h"
 #include "common/notifiable_task.h"
+#include "network/io_uring.h"
 
 namespace peloton {
 namespace network {
 
+class ConnectionDispatcherTask;
+class IoUringSocketIoWrapper;
+
 /**
  * A ConnectionHandlerTask is responsible for interacting with a client
  * connection.
@@ -42,8 +51,10 @@ class ConnectionHandlerTask : public NotifiableTask {
   /**
    * Constructs a new ConnectionHandlerTask instance.
    * @param task_id task_id a unique id assigned to this task.
+   * @param dispatcher the dispatcher that spawned this handler, if any.
    */
-  explicit ConnectionHandlerTask(int task_id);
+  explicit ConnectionHandlerTask(int task_id,
+                                 ConnectionDispatcherTask *dispatcher = nullptr);
 
   /**
    * @brief Notifies this ConnectionHandlerTask that a new client connection
@@ -69,9 +80,123 @@ class ConnectionHandlerTask : public NotifiableTask {
    */
   void HandleDispatch(int new_conn_recv_fd, short flags);
 
+  /**
+   * @brief Accept client connections on a listening socket of this handler's
+   * own, instead of being handed them by the dispatcher. Must be called before
+   * the event loop is started.
+   *
+   * @param listen_fd the listening socket fd, usually one of several bound to
+   * the same port with SO_REUSEPORT.
+   */
+  void Listen(int listen_fd);
+
+  /**
+   * @brief Accepts the pending client connections on the listening socket of
+   * this handler.
+   *
+   * @param listen_fd the listening socket fd
+   * @param flags unused. For compliance with libevent callback interface.
+   */
+  void HandleAccept(int listen_fd, short flags);
+
+  /**
+   * @return The number of client connections this handler has been given and
+   * has not closed yet
+   */
+  int GetNumConnections() const { return num_connections_.load(); }
+
+  /**
+   * @brief Notifies this handler that one of its connections is closed.
+   */
+  void ConnectionClosed() { num_connections_--; }
+
+  /**
+   * @return The io_uring the writes of this handler's connections are batched
+   * through, or nullptr if they are written out directly
+   */
+  IoUring *GetIoUring() const { return io_uring_.get(); }
+
+  /**
+   * @brief Flush the write buffer of a connection, together with those of all
+   * other connections scheduled in the same round of the event loop.
+   */
+  void ScheduleFlush(IoUringSocketIoWrapper *io_wrapper);
+
+  /**
+   * @brief Forget about a scheduled flush, e.g. because the connection is
+   * being closed.
+   */
+  void CancelFlush(IoUringSocketIoWrapper *io_wrapper);
+
+  /**
+   * @brief Send the write buffers of all connections with a scheduled flush
+   * in as few io_uring submissions as possible.
+   *
+   * @param fd unused. For compliance with libevent callback interface.
+   * @param flags unused. For compliance with libevent callback interface.
+   */
+  void FlushWrites(int fd, short flags);
+
+  /**
+   * @brief Consume the completions of the io_uring of this handler.
+   */
+  void ReapCompletions();
+
+  /**
+   * @return Whether the connections of this handler receive through multishot
+   * receives on its io_uring
+   */
+  bool ReceivesThroughIoUring() const { return receive_through_io_uring_; }
+
+  /**
+   * @brief Arm a multishot receive for a connection, which keeps what arrives
+   * on its socket until the connection reads it.
+   *
+   * @return Whether the receive was submitted
+   */
+  bool StartReceiving(IoUringSocketIoWrapper *io_wrapper);
+
+  /**
+   * @brief Cancel the multishot receive of a connection, and wait until the
+   * kernel has let go of it.
+   */
+  void StopReceiving(IoUringSocketIoWrapper *io_wrapper);
+
+  /**
+   * @brief Consume the completions of the io_uring once it has some.
+   *
+   * @param fd unused. For compliance with libevent callback interface.
+   * @param flags unused. For compliance with libevent callback interface.
+   */
+  void HandleCompletions(int fd, short flags);
+
  private:
+  // Handle a completion of the multishot receive of a connection
+  void HandleReceive(const IoUring::Completion &completion);
+
+  // Start handling a client connection accepted or received by this handler
+  void HandleConnection(int conn_fd);
+
   // Notify new connection pipe(send end)
   int new_conn_send_fd_;
+
+  ConnectionDispatcherTask *dispatcher_;
+  std::atomic<int> num_connections_;
+
+  std::unique_ptr<IoUring> io_uring_;
+  // Fired once per round of the event loop if any flush is scheduled
+  struct event *flush_event_ = nullptr;
+  std::vector<IoUringSocketIoWrapper *> pending_flushes_;
+  // The connections of the sends of the current round, by their index in the
+  // round. Sends that completed are set to nullptr.
+  std::vector<IoUringSocketIoWrapper *> sending_;
+  size_t num_sending_ = 0;
+  uint32_t send_round_ = 0;
+
+  bool receive_through_io_uring_ = false;
+  // The connections with an armed multishot receive, by its id
+  std::unordered_map<uint64_t, IoUringSocketIoWrapper *> receivers_;
+  uint64_t next_receive_id_ = 1;
 };
 
 }  // namespace network
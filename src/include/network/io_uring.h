@@ -0,0 +1,227 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// io_uring.h
+//
+// Identification: src/include/network/io_uring.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "common/macros.h"
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define PELOTON_HAS_IO_URING
+#include <linux/io_uring.h>
+// <linux/fs.h> defines BLOCK_SIZE, which the concurrent queue uses as a name
+#undef BLOCK_SIZE
+// Multishot receives came with Linux 6.0, after rings of provided buffers
+#ifdef IORING_RECV_MULTISHOT
+#define PELOTON_HAS_IO_URING_RECV_MULTISHOT
+#endif
+#endif
+#endif
+
+namespace peloton {
+namespace network {
+
+/**
+ * @brief A minimal io_uring submission and completion queue pair.
+ *
+ * The ring is set up with the raw io_uring system calls, so there is no
+ * dependency on liburing. It is not thread-safe; each connection handler
+ * thread owns its own ring.
+ */
+class IoUring {
+ public:
+  DISALLOW_COPY_AND_MOVE(IoUring);
+
+  ~IoUring();
+
+  /**
+   * @brief Set up a ring.
+   *
+   * @param num_entries The number of submission queue entries
+   * @return The ring, or nullptr if the kernel does not support io_uring
+   */
+  static std::unique_ptr<IoUring> Create(uint32_t num_entries);
+
+  /** @brief The number of requests that can be submitted at once */
+  uint32_t GetNumEntries() const { return num_entries_; }
+
+  /**
+   * @brief The file descriptor of the ring, which polls readable when there
+   * are completions
+   */
+  int GetFd() const { return ring_fd_; }
+
+  /**
+   * @brief Queue a send of a buffer to a socket. Nothing is submitted to the
+   * kernel until Submit(). The send never waits for the socket; if it
+   * is full, the request completes with a short count or -EAGAIN.
+   *
+   * @return false if the submission queue is full
+   */
+  bool PrepareSend(int fd, const void *buf, size_t len, uint64_t user_data);
+
+  /**
+   * @brief Register a ring of buffers with the kernel for receives to pick
+   * from, so that memory is only tied up by data that has arrived, not by
+   * every connection waiting for some.
+   *
+   * @param num_buffers The number of buffers, a power of two up to 32768
+   * @param buffer_size The size of each buffer
+   * @return false if the kernel does not support provided buffer rings
+   */
+  bool SetUpReceiveBuffers(uint32_t num_buffers, uint32_t buffer_size);
+
+  /**
+   * @brief Queue a multishot receive from a socket. It stays armed and
+   * completes every time data arrives, into one of the receive buffers, until
+   * it fails, the connection ends or it is cancelled.
+   *
+   * @return false if the submission queue is full
+   */
+  bool PrepareMultishotRecv(int fd, uint64_t user_data);
+
+  /**
+   * @brief Queue the cancellation of a request, e.g. of a multishot receive.
+   *
+   * @param target The user data of the request to cancel
+   * @param user_data The user data of the cancellation itself
+   * @return false if the submission queue is full
+   */
+  bool PrepareCancel(uint64_t target, uint64_t user_data);
+
+  /** @brief The receive buffer with the given id */
+  const char *GetReceiveBuffer(int32_t buffer_id) const {
+    return &receive_buffers_[buffer_id * receive_buffer_size_];
+  }
+
+  /**
+   * @brief Give a receive buffer back to the kernel, once the data received
+   * into it is consumed.
+   */
+  void RecycleReceiveBuffer(int32_t buffer_id);
+
+  /**
+   * @brief Submit all queued requests, in one system call unless the kernel
+   * stops early. Requests the kernel does not take are taken back off the
+   * submission queue. They never run and never complete.
+   *
+   * @return The number of requests submitted, in the order they were queued
+   */
+  uint32_t Submit();
+
+  /**
+   * @brief Wait until there are at least the given number of completions to
+   * consume.
+   *
+   * @return 0, or -errno if the wait failed
+   */
+  int WaitForCompletions(uint32_t min_complete);
+
+  /** @brief A completed request */
+  struct Completion {
+    uint64_t user_data;
+    int32_t result;
+    // Whether the request is multishot and stays armed
+    bool more;
+    // The receive buffer the data was received into, or -1
+    int32_t buffer_id;
+  };
+
+  /**
+   * @brief Consume all completions. The consumer must not consume completions
+   * itself.
+   *
+   * @param consumer Called with each completion
+   */
+  template <typename Consumer>
+  void ForEachCompletion(Consumer consumer);
+
+ private:
+  IoUring() = default;
+
+#ifdef PELOTON_HAS_IO_URING
+  // The next free submission queue entry, or nullptr if the queue is full
+  struct io_uring_sqe *NextEntry();
+
+  // Publish the entry returned by NextEntry() to the kernel
+  void PushEntry();
+#endif
+
+  int ring_fd_ = -1;
+  uint32_t num_entries_ = 0;
+  // Requests queued since the last submission
+  uint32_t num_queued_ = 0;
+
+  // The mmap-ed rings
+  void *sq_ring_ = nullptr;
+  size_t sq_ring_size_ = 0;
+  void *cq_ring_ = nullptr;
+  size_t cq_ring_size_ = 0;
+  void *sqes_ = nullptr;
+  size_t sqes_size_ = 0;
+
+  // Pointers into the rings. Heads and tails are shared with the kernel.
+  std::atomic<uint32_t> *sq_head_ = nullptr;
+  std::atomic<uint32_t> *sq_tail_ = nullptr;
+  uint32_t sq_mask_ = 0;
+  uint32_t *sq_array_ = nullptr;
+  std::atomic<uint32_t> *cq_head_ = nullptr;
+  std::atomic<uint32_t> *cq_tail_ = nullptr;
+  uint32_t cq_mask_ = 0;
+#ifdef PELOTON_HAS_IO_URING
+  struct io_uring_cqe *cqes_ = nullptr;
+#endif
+
+  // The ring of receive buffers shared with the kernel, and the buffers
+  void *receive_buffer_ring_ = nullptr;
+  size_t receive_buffer_ring_size_ = 0;
+  std::atomic<uint16_t> *receive_buffer_tail_ = nullptr;
+  uint16_t receive_buffer_mask_ = 0;
+  std::vector<char> receive_buffers_;
+  uint32_t receive_buffer_size_ = 0;
+};
+
+template <typename Consumer>
+void IoUring::ForEachCompletion(Consumer consumer) {
+#ifdef PELOTON_HAS_IO_URING
+  uint32_t head = cq_head_->load(std::memory_order_relaxed);
+  uint32_t tail = cq_tail_->load(std::memory_order_acquire);
+  for (; head != tail; head++) {
+    auto &cqe = cqes_[head & cq_mask_];
+    Completion completion;
+    completion.user_data = cqe.user_data;
+    completion.result = cqe.res;
+    completion.more = false;
+    completion.buffer_id = -1;
+#ifdef PELOTON_HAS_IO_URING_RECV_MULTISHOT
+    completion.more = (cqe.flags & IORING_CQE_F_MORE) != 0;
+    if ((cqe.flags & IORING_CQE_F_BUFFER) != 0) {
+      completion.buffer_id =
+          static_cast<int32_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+    }
+#endif
+    consumer(completion);
+  }
+  cq_head_->store(head, std::memory_order_release);
+#else
+  (void)consumer;
+#endif
+}
+
+}  // namespace network
+}  // namespace peloton
@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <arpa/inet.h>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -118,6 +120,19 @@ class ReadBuffer : public Buffer {
     return (int)bytes_read;
   }
 
+  /**
+   * Read as many bytes as possible from memory
+   * @param src the bytes to read from
+   * @param len the number of bytes at src
+   * @return the number of bytes read
+   */
+  inline size_t FillBufferFrom(const char *src, size_t len) {
+    size_t bytes_read = std::min(len, Capacity() - size_);
+    PELOTON_MEMCPY(&buf_[size_], src, bytes_read);
+    size_ += bytes_read;
+    return bytes_read;
+  }
+
   /**
    * The number of bytes available to be consumed (i.e. meaningful bytes after
    * current read cursor)
@@ -218,6 +233,64 @@ class WriteBuffer : public Buffer {
   }
 };
 
+/**
+ * Serializes packets in place into a WriteBuffer, without staging them in an
+ * OutputPacket first.
+ *
+ * The header is reserved when the packet is begun and its length is filled in
+ * when it's ended. It's up to the caller to make sure the buffer has space for
+ * the whole packet.
+ */
+class PacketWriter {
+ public:
+  explicit PacketWriter(WriteBuffer &wbuf) : wbuf_(wbuf) {}
+
+  /**
+   * Begin a packet. Reserves space for its length, which is only known once
+   * the packet is ended.
+   * @param msg_type type of the packet
+   */
+  inline void BeginPacket(NetworkMessageType msg_type) {
+    wbuf_.Append(static_cast<uchar>(msg_type));
+    length_offset_ = wbuf_.size_;
+    wbuf_.Append(static_cast<int32_t>(0));
+  }
+
+  /**
+   * Append a 2 byte integer, in network byte order.
+   */
+  inline void AppendInt16(int16_t val) {
+    wbuf_.Append(static_cast<int16_t>(htons(val)));
+  }
+
+  /**
+   * Append a 4 byte integer, in network byte order.
+   */
+  inline void AppendInt32(int32_t val) {
+    wbuf_.Append(static_cast<int32_t>(htonl(val)));
+  }
+
+  /**
+   * Append the bytes of a string, without a terminator.
+   */
+  inline void AppendString(const std::string &str) {
+    wbuf_.Append(str.begin(), str.size());
+  }
+
+  /**
+   * End the packet begun last, writing its length into its header.
+   */
+  inline void EndPacket() {
+    auto len = static_cast<int32_t>(htonl(wbuf_.size_ - length_offset_));
+    PELOTON_MEMCPY(&wbuf_.buf_[length_offset_], &len, sizeof(len));
+  }
+
+ private:
+  WriteBuffer &wbuf_;
+  // Where the length of the current packet goes
+  size_t length_offset_ = 0;
+};
+
 class InputPacket {
  public:
   NetworkMessageType msg_type;         // header
@@ -297,6 +370,14 @@ struct OutputPacket {
   bool skip_header_write;  // whether we should write header to soc ket wbuf
   size_t write_ptr;        // cursor used to write packet content to socket wbuf
 
+  // A DATA_ROW packet can instead carry a whole result set, one DataRow
+  // message per row of num_columns values. The rows are serialized straight
+  // into the socket wbuf, and write_ptr is the next row to write.
+  std::vector<std::string> rows;
+  size_t num_columns;
+  // A row that does not fit in the socket wbuf, staged in a packet of its own
+  std::unique_ptr<OutputPacket> oversized_row;
+
   // TODO could packet be reused?
   inline void Reset() {
     buf.resize(BUFFER_INIT_SIZE);
@@ -306,6 +387,9 @@ struct OutputPacket {
     len = ptr = write_ptr = 0;
     msg_type = NetworkMessageType::NULL_COMMAND;
     skip_header_write = true;
+    rows.clear();
+    num_columns = 0;
+    oversized_row.reset();
   }
 };
 
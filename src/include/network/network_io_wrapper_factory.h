@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include "network/connection_handler_task.h"
 #include "network/network_io_wrappers.h"
 #include "network/peloton_server.h"
 
@@ -42,12 +43,15 @@ class NetworkIoWrapperFactory {
   /**
    * @brief Creates or re-purpose a NetworkIoWrapper object for new use.
    * The returned value always uses Posix I/O methods unles explicitly
-   * converted.
+   * converted. Its writes are batched through the io_uring of the handler, if
+   * the handler has one.
    * @see NetworkIoWrapper for details
    * @param conn_fd Client connection fd
+   * @param handler The handler thread of the connection
    * @return A new NetworkIoWrapper object
    */
-  std::shared_ptr<NetworkIoWrapper> NewNetworkIoWrapper(int conn_fd);
+  std::shared_ptr<NetworkIoWrapper> NewNetworkIoWrapper(
+      int conn_fd, ConnectionHandlerTask *handler = nullptr);
 
   /**
    * @brief: process SSL handshake to generate valid SSL
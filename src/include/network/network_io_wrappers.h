@@ -12,9 +12,11 @@
 
 #pragma once
 
+#include <event2/event.h>
 #include <openssl/ssl.h>
 #include <memory>
 #include <utility>
+#include <vector>
 #include "common/exception.h"
 #include "common/utility.h"
 #include "network/marshal.h"
@@ -22,6 +24,8 @@
 namespace peloton {
 namespace network {
 
+class ConnectionHandlerTask;
+
 /**
  * A network io wrapper provides an interface for interacting with a client
  * connection.
@@ -42,8 +46,26 @@ class NetworkIoWrapper {
   // TODO(Tianyu): Change and document after we refactor protocol handler
   virtual Transition FillReadBuffer() = 0;
   virtual Transition FlushWriteBuffer() = 0;
+  /**
+   * Flush the write buffer before the handler thread waits for more events.
+   * Wrappers that batch the writes of many connections only schedule the
+   * flush, the others flush right away.
+   */
+  virtual Transition ScheduleFlushWriteBuffer() { return FlushWriteBuffer(); }
   virtual Transition Close() = 0;
 
+  /**
+   * Tell the wrapper about the event the connection waits for data on.
+   * Wrappers that receive in the background activate it when data arrives.
+   */
+  virtual void SetReadEvent(struct event *) {}
+
+  /**
+   * Stop receiving in the background, e.g. before the socket is handed over
+   * to SSL.
+   */
+  virtual void StopReceiving() {}
+
   inline int GetSocketFd() { return sock_fd_; }
   Transition WritePacket(OutputPacket *pkt);
   // TODO(Tianyu): Make these protected when protocol handler refactor is
@@ -64,6 +86,10 @@ class NetworkIoWrapper {
   int sock_fd_;
   std::shared_ptr<ReadBuffer> rbuf_;
   std::shared_ptr<WriteBuffer> wbuf_;
+
+ private:
+  // Serialize the rows carried by a DATA_ROW packet into the write buffer
+  Transition WriteDataRows(OutputPacket *pkt);
 };
 
 /**
@@ -84,6 +110,71 @@ class PosixSocketIoWrapper : public NetworkIoWrapper {
   }
 };
 
+/**
+ * A posix socket wrapper whose scheduled flushes are sent together with those
+ * of the other connections of its handler thread, in one io_uring submission.
+ * @see ConnectionHandlerTask::FlushWrites()
+ */
+class IoUringSocketIoWrapper : public PosixSocketIoWrapper {
+ public:
+  IoUringSocketIoWrapper(int sock_fd, std::shared_ptr<ReadBuffer> rbuf,
+                         std::shared_ptr<WriteBuffer> wbuf,
+                         ConnectionHandlerTask *handler)
+      : PosixSocketIoWrapper(sock_fd, std::move(rbuf), std::move(wbuf)),
+        handler_(handler) {}
+
+  ~IoUringSocketIoWrapper();
+
+  Transition FillReadBuffer() override;
+  Transition ScheduleFlushWriteBuffer() override;
+  Transition Close() override;
+
+  void SetReadEvent(struct event *read_event) override {
+    read_event_ = read_event;
+  }
+
+  void StopReceiving() override;
+
+  /**
+   * Account for the result of the batched send of the write buffer. If the
+   * socket could not take all of it, the rest is sent when it's writable.
+   */
+  void CompleteScheduledFlush(int result);
+
+ private:
+  friend class ConnectionHandlerTask;
+
+  // Stop waiting for a scheduled flush or for the socket to be writable
+  void CancelScheduledFlush();
+
+  void HandleWritable(int, short);
+
+  // Read straight from the socket, if the connection does not receive
+  // through the io_uring of its handler
+  Transition ReadFromSocket();
+
+  // Keep what the multishot receive got until the connection reads it
+  void Received(const char *data, size_t len);
+
+  // Wake the connection up if it waits for data
+  void WakeUp();
+
+  ConnectionHandlerTask *handler_;
+  bool flush_scheduled_ = false;
+  struct event *writable_event_ = nullptr;
+
+  // The id of the armed multishot receive, or 0 if there is none
+  uint64_t receive_id_ = 0;
+  // Data received for the connection that it has not read yet
+  std::vector<char> received_;
+  size_t received_offset_ = 0;
+  bool receive_eof_ = false;
+  int receive_error_ = 0;
+  // Whether the connection is reading, and need not be woken up
+  bool reading_ = false;
+  struct event *read_event_ = nullptr;
+};
+
 /**
  * NetworkIoWrapper specialized for dealing with ssl sockets.
  */
@@ -129,6 +129,8 @@ class PelotonServer : public DedicatedThreadOwner {
 
   uint64_t port_;       // port number
   int listen_fd_ = -1;  // server socket fd that PelotonServer is listening on
+  // server socket fds of the connection handlers, if they listen themselves
+  std::vector<int> handler_listen_fds_;
   size_t max_connections_;  // maximum number of connections
 
   std::shared_ptr<ConnectionDispatcherTask> dispatcher_task;
@@ -136,6 +138,9 @@ class PelotonServer : public DedicatedThreadOwner {
   template <typename... Ts>
   void TrySslOperation(int (*func)(Ts...), Ts... arg);
 
+  // Create a socket listening on the server port
+  int CreateListenSocket(bool reuse_port);
+
   // For testing purposes
   std::shared_ptr<ConnectionDispatcherTask> dispatcher_task_;
 };
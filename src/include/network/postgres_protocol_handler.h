@@ -20,6 +20,7 @@
 
 #include "common/cache.h"
 #include "common/internal_types.h"
+#include "common/parameterized_plan_cache.h"
 #include "common/portal.h"
 #include "common/statement.h"
 #include "common/statement_cache.h"
@@ -29,6 +30,9 @@
 // Packet content macros
 #define NULL_CONTENT_SIZE (-1)
 
+// Maximum number of pipelined executions that are executed as one batch
+#define MAX_PIPELINED_BATCH_SIZE 1024
+
 namespace peloton {
 
 namespace parser {
@@ -105,6 +109,14 @@ class PostgresProtocolHandler : public ProtocolHandler {
   static bool ReadPacketHeader(ReadBuffer &rbuf, InputPacket &rpkt,
                                bool startup_format);
 
+  /**
+   * @brief Parse the next packet from rbuf if it is of the given type and
+   * completely in the buffer. Otherwise rbuf is left untouched.
+   * @return true if the packet was parsed
+   */
+  static bool PeekPacket(ReadBuffer &rbuf, NetworkMessageType msg_type,
+                         InputPacket &rpkt);
+
   //===--------------------------------------------------------------------===//
   // PROTOCOL HANDLING FUNCTIONS
   //===--------------------------------------------------------------------===//
@@ -117,7 +129,8 @@ class PostgresProtocolHandler : public ProtocolHandler {
   /**
    * @brief Main Switch function to process general packets
    */
-  ProcessResult ProcessNormalPacket(InputPacket *pkt, const size_t thread_id);
+  ProcessResult ProcessNormalPacket(InputPacket *pkt, ReadBuffer &rbuf,
+                                    const size_t thread_id);
 
   /**
    * @brief Helper function to process startup packet
@@ -165,9 +178,17 @@ class PostgresProtocolHandler : public ProtocolHandler {
   /* Execute a Simple query protocol message */
   ProcessResult ExecQueryMessage(InputPacket *pkt, const size_t thread_id);
 
-  /* Execute a EXPLAIN query message */
+  /* Execute a EXPLAIN query message. EXPLAIN ANALYZE also executes the query
+   * and shows the estimated and actual rows of each plan node. */
   ResultType ExecQueryExplain(const std::string &query,
-                              parser::ExplainStatement &explain_stmt);
+                              parser::ExplainStatement &explain_stmt,
+                              const size_t thread_id);
+
+  /* Show the profile of an EXPLAIN ANALYZE once its execution is done */
+  ResultType ExecQueryExplainGetResult(ResultType status);
+
+  /* Make the lines of the plan the result of the EXPLAIN statement */
+  void SetExplainResult(const std::string &plan_str);
 
   /* Process the PARSE message of the extended query protocol */
   void ExecParseMessage(InputPacket *pkt);
@@ -179,13 +200,21 @@ class PostgresProtocolHandler : public ProtocolHandler {
   ProcessResult ExecDescribeMessage(InputPacket *pkt);
 
   /* Process the EXECUTE message of the extended query protocol */
-  ProcessResult ExecExecuteMessage(InputPacket *pkt, const size_t thread_id);
+  ProcessResult ExecExecuteMessage(InputPacket *pkt, ReadBuffer &rbuf,
+                                   const size_t thread_id);
+
+  /* Consume the BIND/EXECUTE pairs of the same statement that follow an
+   * EXECUTE message in rbuf, and add their parameters to the batch */
+  void CollectPipelinedExecutions(ReadBuffer &rbuf,
+                                  const std::shared_ptr<Statement> &statement);
 
   /* Process the optional CLOSE message of the extended query protocol */
   void ExecCloseMessage(InputPacket *pkt);
 
   void ExecExecuteMessageGetResult(ResultType status);
 
+  void ExecBatchGetResult(ResultType status);
+
   void ExecQueryMessageGetResult(ResultType status);
 
   //===--------------------------------------------------------------------===//
@@ -210,9 +239,32 @@ class PostgresProtocolHandler : public ProtocolHandler {
   // Statement cache
   StatementCache statement_cache_;
 
+  // Plans of auto-parameterized simple queries
+  ParameterizedPlanCache plan_cache_;
+
+  // Fingerprint of the simple query being executed with a cached plan
+  std::string plan_cache_fingerprint_;
+
+  // Rows counted for each plan node of the EXPLAIN ANALYZE being executed,
+  // and the rows it produced, which are not sent
+  executor::PlanActualRows explain_actual_rows_;
+  std::vector<ResultValue> explain_rows_;
+  bool explaining_ = false;
+
   //  Portals
   std::unordered_map<std::string, std::shared_ptr<Portal>> portals_;
 
+  // Parameters of the pipelined executions that are executed as one batch
+  std::vector<std::vector<type::Value>> batch_params_;
+
+  // Results of the executions of the batch
+  std::vector<executor::ExecutionResult> batch_results_;
+
+  // Responses to the BIND messages consumed with the batch. The responses at
+  // index i precede the result of execution i; an extra entry holds the
+  // responses that follow the batch.
+  std::vector<ResponseBuffer> batch_responses_;
+
   // packets ready for read
   size_t pkt_cntr_;
 
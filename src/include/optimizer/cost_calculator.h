@@ -12,12 +12,22 @@
 
 #pragma once
 
+#include <memory>
+
 #include "optimizer/operator_visitor.h"
+#include "optimizer/stats/cost_model.h"
 
 namespace peloton {
+
+namespace catalog {
+class TableCatalogEntry;
+}
+
 namespace optimizer {
 
 class Memo;
+class TableStats;
+using GroupID = int32_t;
 // Derive cost for a physical group expressionh
 class CostCalculator : public OperatorVisitor {
  public:
@@ -52,10 +62,28 @@ class CostCalculator : public OperatorVisitor {
   double HashCost();
   double SortCost();
   double GroupByCost();
+  double NestedLoopJoinCost();
+  /**
+   * @brief The cost of a hash join that builds its hash table on the left or
+   * the right input and probes it with the other one
+   */
+  double HashJoinCost(bool build_left);
+
+  /** @brief The cost of inserting a tuple and its index entries */
+  double InsertTupleCost(
+      const std::shared_ptr<catalog::TableCatalogEntry> &table);
+
+  /** @brief The fraction of the index entries matching the scan keys */
+  double IndexScanSelectivity(const PhysicalIndexScan *op,
+                              const std::shared_ptr<TableStats> &table_stats);
+
+  double GetNumRows(GroupID group_id);
+  double GetTableRows(const std::shared_ptr<catalog::TableCatalogEntry> &table);
 
   GroupExpression *gexpr_;
   Memo *memo_;
   concurrency::TransactionContext *txn_;
+  CostModelParameters params_;
   double output_cost_ = 0;
 };
 
@@ -0,0 +1,123 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// join_order_enumerator.h
+//
+// Identification: src/include/optimizer/join_order_enumerator.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/internal_types.h"
+
+namespace peloton {
+namespace optimizer {
+
+class GroupExpression;
+class Memo;
+class RuleSet;
+using GroupID = int32_t;
+
+/**
+ * @brief Enumerate the orders of trees of inner joins before the memo is
+ * explored.
+ *
+ * Exploring join orders with the commutativity and associativity rules
+ * generates every bushy tree of a join, which does not finish for joins of
+ * many tables. The enumerator instead orders each tree of inner joins (a join
+ * block) up front: with dynamic programming over the connected subsets of its
+ * tables for small blocks, and greedily by smallest intermediate result for
+ * large ones. The cost of a join order is the sum of the estimated sizes of
+ * its intermediate results, computed from the stats derived for the tables.
+ *
+ * The best tree is inserted into the memo as one group per intermediate
+ * result, holding the join of the two inputs in both orders, so the
+ * implementation rules still pick the build side of hash joins. Blocks of more
+ * than join_exploration_limit tables are not explored with the transformation
+ * rules afterwards.
+ */
+class JoinOrderEnumerator {
+ public:
+  JoinOrderEnumerator(Memo &memo, RuleSet &rule_set)
+      : memo_(memo), rule_set_(rule_set) {}
+
+  /**
+   * @brief Enumerate the join orders of all the join blocks under a group
+   *
+   * @param group_id The root group of the query
+   * @return The logical expressions added to the memo, whose stats still need
+   *  to be derived
+   */
+  std::vector<GroupExpression *> Enumerate(GroupID group_id);
+
+ private:
+  // A tree of inner joins, whose leaves are the groups of the first
+  // expression that is not an inner join
+  struct JoinBlock {
+    GroupID root_group;
+    std::vector<GroupID> leaves;
+    std::vector<AnnotatedExpression> predicates;
+    std::vector<GroupExpression *> join_exprs;
+  };
+
+  // A node of the join tree chosen for a block. Leaves have no inputs.
+  struct JoinNode {
+    uint64_t tables;
+    int left;
+    int right;
+  };
+
+  void CollectJoinBlock(GroupID group_id, JoinBlock &block);
+
+  void EnumerateJoinBlock(JoinBlock &block);
+
+  /**
+   * @brief Find the cheapest join tree of the block by dynamic programming
+   * over the subsets of its tables
+   *
+   * @return The index of the root of the tree in nodes
+   */
+  int OrderByDynamicProgramming(std::vector<JoinNode> &nodes);
+
+  /**
+   * @brief Repeatedly join the two connected inputs with the smallest result
+   *
+   * @return The index of the root of the tree in nodes
+   */
+  int OrderGreedily(std::vector<JoinNode> &nodes);
+
+  /** @brief Insert the join tree into the memo, bottom-up */
+  GroupID InsertJoinTree(const JoinBlock &block,
+                         const std::vector<JoinNode> &nodes, int node_idx,
+                         bool is_root);
+
+  /** @brief The estimated number of rows joining the tables produces */
+  double EstimateRows(uint64_t tables) const;
+
+  /** @brief Is there a predicate between the two sets of tables? */
+  bool IsConnected(uint64_t left, uint64_t right) const;
+
+  /** @brief Stop the transformation rules from exploring the expression */
+  void DisableExploration(GroupExpression *gexpr);
+
+  Memo &memo_;
+  RuleSet &rule_set_;
+
+  // The state of the join block being enumerated
+  std::vector<double> leaf_rows_;
+  // The tables each predicate references, and its selectivity
+  std::vector<uint64_t> predicate_tables_;
+  std::vector<double> predicate_selectivities_;
+  std::vector<GroupExpression *> new_exprs_;
+  bool disable_exploration_ = false;
+};
+
+}  // namespace optimizer
+}  // namespace peloton
@@ -13,9 +13,11 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <unordered_set>
 #include <vector>
 
+#include "common/synchronization/readwrite_latch.h"
 #include "operator_expression.h"
 #include "optimizer/group.h"
 
@@ -35,6 +37,10 @@ struct GExprPtrEq {
 
 //===--------------------------------------------------------------------===//
 // Memo
+//
+// Expressions may be inserted and groups looked up by several optimizer tasks
+// at once. Each group is only modified by one task at a time, since tasks that
+// run in parallel optimize disjoint sub-trees.
 //===--------------------------------------------------------------------===//
 class Memo {
  public:
@@ -91,6 +97,9 @@ class Memo {
       group_expressions_;
   std::vector<std::unique_ptr<Group>> groups_;
   size_t rule_set_size_;
+  // Guards group_expressions_ and groups_. Held through a pointer so that the
+  // memo stays movable.
+  std::unique_ptr<common::synchronization::ReadWriteLatch> latch_;
 };
 
 }  // namespace optimizer
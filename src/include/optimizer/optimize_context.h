@@ -28,14 +28,20 @@ class OptimizeContext {
  public:
   OptimizeContext(OptimizerMetadata *metadata,
                   std::shared_ptr<PropertySet> required_prop,
-                  double cost_upper_bound = std::numeric_limits<double>::max())
+                  double cost_upper_bound = std::numeric_limits<double>::max(),
+                  OptimizerTaskPool *task_pool = nullptr)
       : metadata(metadata),
         required_prop(required_prop),
-        cost_upper_bound(cost_upper_bound) {}
+        cost_upper_bound(cost_upper_bound),
+        task_pool(task_pool) {}
 
   OptimizerMetadata *metadata;
   std::shared_ptr<PropertySet> required_prop;
   double cost_upper_bound;
+  // The pool the tasks of this context push to, if not the one of the
+  // metadata. Tasks that run on other threads have a pool of their own, which
+  // the contexts of the child groups they optimize must inherit.
+  OptimizerTaskPool *task_pool;
 };
 
 }  // namespace optimizer
@@ -12,6 +12,9 @@
 
 #pragma once
 
+#include <mutex>
+
+#include "common/exception.h"
 #include "common/timer.h"
 #include "optimizer/memo.h"
 #include "optimizer/group_expression.h"
@@ -42,11 +45,31 @@ class OptimizerMetadata {
   unsigned int timeout_limit;
   Timer<std::milli> timer;
   concurrency::TransactionContext* txn;
+  // The group the optimizer searches a plan for, with the properties it must
+  // have. The timeout only applies once that group has a plan.
+  GroupID root_group_id = UNDEFINED_GROUP;
+  std::shared_ptr<PropertySet> root_required_props;
+  // Serializes the catalog lookups of tasks optimizing in parallel, which all
+  // go through txn
+  std::unique_ptr<std::mutex> txn_latch{new std::mutex()};
 
   void SetTaskPool(OptimizerTaskPool *task_pool) {
     this->task_pool = task_pool;
   }
 
+  // Throw once the optimizer has run for longer than the timeout, if it
+  // already has a plan to fall back to
+  void CheckTimeout(double duration) {
+    if (duration >= timeout_limit && root_group_id != UNDEFINED_GROUP &&
+        memo.GetGroupByID(root_group_id)
+            ->HasExpressions(root_required_props)) {
+      throw OptimizerException("Optimizer task execution duration " +
+                               std::to_string(duration) +
+                               " exceeds timeout limit " +
+                               std::to_string(timeout_limit));
+    }
+  }
+
   std::shared_ptr<GroupExpression> MakeGroupExpression(
       std::shared_ptr<OperatorExpression> expr) {
     std::vector<GroupID> child_groups;
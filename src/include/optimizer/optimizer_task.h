@@ -47,7 +47,8 @@ enum class OptimizerTaskType {
   REWRITE_EXPR,
   APPLY_REWIRE_RULE,
   TOP_DOWN_REWRITE,
-  BOTTOM_UP_REWRITE
+  BOTTOM_UP_REWRITE,
+  ENUMERATE_JOIN_ORDERS
 };
 
 /**
@@ -205,6 +206,17 @@ class OptimizeInputs : public OptimizerTask {
   virtual void execute() override;
 
  private:
+  /**
+   * @brief Optimize the child groups that have no best expression for their
+   * required properties yet at the same time, each on its own task stack, if
+   * they cover disjoint sets of tables. The calling thread takes part and
+   * returns once all of them are done.
+   *
+   * @param input_props The properties required from each child
+   */
+  void OptimizeChildrenInParallel(
+      const std::vector<std::shared_ptr<PropertySet>> &input_props);
+
   std::vector<std::pair<std::shared_ptr<PropertySet>,
                         std::vector<std::shared_ptr<PropertySet>>>>
       output_input_properties_;
@@ -241,6 +253,23 @@ class DeriveStats : public OptimizerTask {
   ExprSet required_cols_;
 };
 
+/**
+ * @brief Seed the memo with the join orders picked by the JoinOrderEnumerator
+ * for all the join blocks under a group, and derive the stats of the join
+ * expressions it added. The stats of the tables must have been derived.
+ */
+class EnumerateJoinOrders : public OptimizerTask {
+ public:
+  EnumerateJoinOrders(GroupID group_id,
+                      std::shared_ptr<OptimizeContext> context)
+      : OptimizerTask(context, OptimizerTaskType::ENUMERATE_JOIN_ORDERS),
+        group_id_(group_id) {}
+  virtual void execute() override;
+
+ private:
+  GroupID group_id_;
+};
+
 /**
  * @brief Apply top-down rewrite pass, take in a rule set which must fulfill
  * that the lower level rewrite in the operator tree will not enable upper
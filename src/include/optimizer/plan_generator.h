@@ -19,6 +19,7 @@ namespace peloton {
 namespace planner {
 class AbstractPlan;
 class HashJoinPlan;
+class IndexScanPlan;
 class NestedLoopJoinPlan;
 class ProjectionPlan;
 class SeqScanPlan;
@@ -143,6 +144,31 @@ class PlanGenerator : public OperatorVisitor {
       std::unique_ptr<const planner::ProjectInfo> &proj_info,
       std::shared_ptr<const catalog::Schema> &proj_schema);
 
+  /**
+   * @brief Decide whether a hash join should radix-partition both of its
+   *  sides, i.e. whether its estimated build side is too large for the cache
+   *
+   * @param build_plan The plan that produces the build side
+   * @param build_cols The columns of the build side
+   *
+   * @return true if the estimated build side exceeds the threshold setting,
+   * or if queries have a memory budget
+   */
+  bool UseRadixPartitionedHashJoin(const planner::AbstractPlan &build_plan,
+                                   const ExprMap &build_cols) const;
+
+  /**
+   * @brief Let an index scan below a limit stop once it has found enough
+   *  tuples. This is only done if the scan produces the tuples in the order of
+   *  the limit, i.e. the limit has no sort order, or sorts on a prefix of the
+   *  index key in a single direction
+   *
+   * @param op The limit operator
+   * @param index_scan_plan The index scan plan that is the child of the limit
+   */
+  void PushLimitIntoIndexScan(const PhysicalLimit *op,
+                              planner::IndexScanPlan *index_scan_plan);
+
   /**
    * @brief Check required columns and output_cols, see if we need to add
    *  projection on top of the current output plan, this should be done after
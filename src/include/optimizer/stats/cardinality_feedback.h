@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// cardinality_feedback.h
+//
+// Identification: src/include/optimizer/stats/cardinality_feedback.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/internal_types.h"
+#include "common/macros.h"
+
+namespace peloton {
+
+namespace expression {
+class AbstractExpression;
+}
+
+namespace optimizer {
+
+/**
+ * @brief The selectivities of scan predicates observed while executing plans.
+ *
+ * The executors report the number of rows a scan actually produced under the
+ * signature of its predicate, and the StatsCalculator uses the observed
+ * selectivity instead of its estimate from the column stats the next time it
+ * plans a scan of the same table with the same predicate shape.
+ */
+class CardinalityFeedback {
+ public:
+  DISALLOW_COPY_AND_MOVE(CardinalityFeedback);
+
+  // Global Singleton
+  static CardinalityFeedback *GetInstance();
+
+  /**
+   * @brief Get the signature of the predicates of a scan. The signature
+   * includes the constants, since the selectivity depends on them, but not
+   * the parameters an equality is compared to, so that the executions of a
+   * prepared point query share it. The order of the conjuncts does not matter.
+   *
+   * @return The signature, or an empty string if there are no predicates or
+   * a parameter is compared in any other way, whose selectivity can't be
+   * shared between the executions
+   */
+  static std::string GetPredicateSignature(
+      oid_t database_oid, oid_t table_oid,
+      const std::vector<AnnotatedExpression> &predicates);
+
+  /**
+   * @brief Record the number of rows a scan with the signature produced
+   *
+   * @param signature The signature of the scan predicates
+   * @param actual_rows The number of rows the scan produced
+   * @param table_rows The number of rows in the scanned table
+   */
+  void RecordCardinality(const std::string &signature, size_t actual_rows,
+                         size_t table_rows);
+
+  /**
+   * @brief Get the observed selectivity of the predicates with the signature
+   *
+   * @return false if no scan with the signature was recorded
+   */
+  bool GetSelectivity(const std::string &signature, double &selectivity);
+
+  /** @brief Forget all recorded selectivities */
+  void Clear();
+
+ private:
+  CardinalityFeedback() = default;
+
+  // Returns false if the expression compares a parameter other than with an
+  // equality. in_equality tells if the expression is compared for equality.
+  static bool AppendExpressionSignature(
+      const expression::AbstractExpression *expr, bool in_equality,
+      std::string &signature);
+
+  std::mutex feedback_lock_;
+  // The moving average of the selectivity observed for each signature
+  std::unordered_map<std::string, double> selectivities_;
+};
+
+}  // namespace optimizer
+}  // namespace peloton
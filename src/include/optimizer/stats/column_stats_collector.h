@@ -46,11 +46,12 @@ class ColumnStatsCollector {
 
   void AddValue(const type::Value& value);
 
+  // Merge the stats collected by another collector of the same column
+  void Merge(const ColumnStatsCollector& other);
+
   double GetFracNull();
 
-  inline std::vector<ValueFrequencyPair> GetCommonValueAndFrequency() {
-    return topk_.GetAllOrderedMaxFirst();
-  }
+  std::vector<ValueFrequencyPair> GetCommonValueAndFrequency();
 
   inline uint64_t GetCardinality() { return hll_.EstimateCardinality(); }
 
@@ -64,6 +65,12 @@ class ColumnStatsCollector {
 
   inline bool HasIndex() { return has_index_; }
 
+  // When the stats were collected from a sample, the frequencies of the most
+  // common values are scaled up by the inverse of the sampled fraction.
+  inline void SetFrequencyScale(double frequency_scale) {
+    frequency_scale_ = frequency_scale;
+  }
+
  private:
   const oid_t database_id_;
   const oid_t table_id_;
@@ -80,6 +87,8 @@ class ColumnStatsCollector {
   size_t null_count_ = 0;
   size_t total_count_ = 0;
 
+  double frequency_scale_ = 1.0;
+
   ColumnStatsCollector(const ColumnStatsCollector&);
   void operator=(const ColumnStatsCollector&);
 };
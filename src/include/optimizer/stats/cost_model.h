@@ -0,0 +1,88 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// cost_model.h
+//
+// Identification: src/include/optimizer/stats/cost_model.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>
+
+#include "common/internal_types.h"
+#include "common/macros.h"
+
+namespace peloton {
+namespace optimizer {
+
+/**
+ * @brief The unit costs of the CostCalculator. All of them are relative to
+ * tuple_cpu_cost, which stays at DEFAULT_TUPLE_COST.
+ */
+struct CostModelParameters {
+  // Processing one tuple in an operator
+  double tuple_cpu_cost;
+  // Copying one tuple into memory, e.g. to sort it
+  double tuple_copy_cost;
+  // Inserting one tuple into a hash table
+  double hash_build_cost;
+  // Probing a hash table with one tuple
+  double hash_probe_cost;
+  // Following a pointer that misses the cache, e.g. to the next index node
+  double random_access_cost;
+  // Comparing one key while searching an index node
+  double key_compare_cost;
+  // Writing one new tuple version
+  double tuple_write_cost;
+};
+
+/**
+ * @brief The unit costs of the optimizer, and a set of microbenchmarks that
+ * fit them to the machine.
+ *
+ * The defaults are ratios typical of current servers. Calibrate() times a
+ * sequential scan, tuple copies, hash table builds and probes, pointer chasing
+ * and node searches over in-memory data, and replaces them with the measured
+ * ratios. It runs at startup when cost_model_calibration is set, and can be
+ * called at any time after that.
+ */
+class CostModel {
+ public:
+  DISALLOW_COPY_AND_MOVE(CostModel);
+
+  // Global Singleton
+  static CostModel *GetInstance();
+
+  static CostModelParameters GetDefaultParameters();
+
+  CostModelParameters GetParameters();
+
+  void SetParameters(const CostModelParameters &parameters);
+
+  /** @brief Fit the parameters to this machine */
+  void Calibrate();
+
+  /**
+   * @brief The cost of searching an index of the type for one key
+   *
+   * @param parameters The unit costs
+   * @param index_type The type of the index
+   * @param num_entries The number of entries in the index
+   */
+  static double IndexSearchCost(const CostModelParameters &parameters,
+                                IndexType index_type, double num_entries);
+
+ private:
+  CostModel() : parameters_(GetDefaultParameters()) {}
+
+  std::mutex parameters_lock_;
+  CostModelParameters parameters_;
+};
+
+}  // namespace optimizer
+}  // namespace peloton
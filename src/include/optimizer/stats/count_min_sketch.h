@@ -20,6 +20,7 @@
 #include <vector>
 
 #include "common/logger.h"
+#include "common/macros.h"
 #include "murmur3/MurmurHash3.h"
 
 namespace peloton {
@@ -140,6 +141,19 @@ class CountMinSketch {
     return count;
   }
 
+  // Merge another sketch with the same dimensions and seed into this one.
+  // The number of distinct items becomes an upper bound afterwards since both
+  // sketches may have seen the same items.
+  void Merge(const CountMinSketch& other) {
+    PELOTON_ASSERT(depth == other.depth && width == other.width);
+    for (int i = 0; i < depth; i++) {
+      for (int j = 0; j < width; j++) {
+        table[i][j] += other.table[i][j];
+      }
+    }
+    size += other.size;
+  }
+
  private:
   void InitTable(int depth, int width, unsigned int seed) {
     table = std::vector<std::vector<SketchElemType>>(
@@ -39,7 +39,7 @@ namespace optimizer {
 /*
  * Online histogram implementation based on A Streaming Parallel Decision Tree
  * Algorithm (http://www.jmlr.org/papers/volume11/ben-haim10a/ben-haim10a.pdf)
- * Specifically Algorithm 1, 3, and 4.
+ * Specifically Algorithm 1, 2, 3, and 4.
  */
 class Histogram {
  public:
@@ -89,6 +89,23 @@ class Histogram {
     }
   }
 
+  /*
+   * Input: another histogram h'
+   *
+   * Update the histogram to represent the union of the sets represented by
+   * h and h' (Algorithm 2). Keep bin number unchanged.
+   */
+  void Merge(const Histogram &other) {
+    for (const Bin &bin : other.bins) {
+      InsertBin(bin);
+    }
+    while (bins.size() > max_bins_) {
+      MergeTwoBinsWithMinGap();
+    }
+    minimum_ = std::min(minimum_, other.minimum_);
+    maximum_ = std::max(maximum_, other.maximum_);
+  }
+
   /*
    * Input: a point b such that p1 < b < pB
    *
@@ -47,6 +47,13 @@ class HyperLogLog {
     return cardinality;
   }
 
+  // Merge another HLL with the same precision into this one.
+  void Merge(const HyperLogLog& other) {
+    PELOTON_ASSERT(precision_ == other.precision_);
+    UNUSED_ATTRIBUTE int error = hll_->Merge(other.hll_);
+    PELOTON_ASSERT(error == 0);
+  }
+
   // Estimate relative error for HLL.
   inline double RelativeError() {
     PELOTON_ASSERT(register_count_ > 0);
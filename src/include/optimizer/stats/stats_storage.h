@@ -15,7 +15,9 @@
 #include "optimizer/stats/table_stats_collector.h"
 #include "optimizer/stats/column_stats_collector.h"
 
+#include <mutex>
 #include <sstream>
+#include <unordered_map>
 
 #include "common/macros.h"
 #include "common/internal_types.h"
@@ -81,9 +83,23 @@ class StatsStorage {
   ResultType AnalayzeStatsForColumns(storage::DataTable *table,
                                      std::vector<std::string> column_names);
 
+  // Forget the stats collected from the tile groups of a dropped table
+  void DropTableStatsCollector(oid_t table_oid);
+
  private:
   std::unique_ptr<type::AbstractPool> pool_;
 
+  // The stats collectors of all analyzed tables. They keep the stats of every
+  // chunk of tile groups so that re-analyzing a table only rescans the chunks
+  // that were modified since.
+  std::unordered_map<oid_t, std::unique_ptr<TableStatsCollector>>
+      table_stats_collectors_;
+  std::mutex analyze_mutex_;
+
+  // Collect the stats of the table and store them in the catalog
+  void AnalyzeTable(storage::DataTable *table,
+                    concurrency::TransactionContext *txn);
+
   std::shared_ptr<ColumnStats> ConvertVectorToColumnStats(
       oid_t database_id, oid_t table_id, oid_t column_id,
       std::unique_ptr<std::vector<type::Value>> &column_stats_vector);
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "optimizer/stats/column_stats_collector.h"
@@ -26,29 +27,93 @@ namespace optimizer {
 //===--------------------------------------------------------------------===//
 class TableStatsCollector {
  public:
+  // The number of consecutive tile groups whose stats are collected, and kept
+  // for incremental collection, together. Chunks of large tables get wider.
+  static constexpr size_t kTileGroupsPerChunk = 8;
+
+  // The most chunks whose stats are kept for a table. Each keeps a collector
+  // per column, so beyond this neighboring chunks are merged into chunks
+  // twice as wide.
+  static constexpr size_t kMaxChunks = 32;
+
   TableStatsCollector(storage::DataTable* table);
 
   ~TableStatsCollector();
 
+  /*
+   * Collect the stats of all columns. The tile groups are split into chunks
+   * that are scanned in parallel on the execution pool, each into its own
+   * column stats collectors, which are merged at the end.
+   *
+   * The stats of every chunk are kept, so calling this again only rescans the
+   * chunks with tile groups that were modified since the last call.
+   */
   void CollectColumnStats();
 
+  // Only scan a random sample of the tile groups (blocks) of the table. A
+  // ratio of 1 (the default) scans the whole table. Sampled stats are not
+  // kept for incremental collection.
+  inline void SetSampleRatio(double sample_ratio) {
+    PELOTON_ASSERT(sample_ratio > 0 && sample_ratio <= 1);
+    sample_ratio_ = sample_ratio;
+  }
+
+  inline storage::DataTable* GetTable() { return table_; }
+
   inline size_t GetActiveTupleCount() { return active_tuple_count_; }
 
   inline size_t GetColumnCount() { return column_count_; }
 
+  // The number of tile groups scanned by the last collection
+  inline size_t GetScannedTileGroupCount() { return scanned_tile_group_count_; }
+
+  // The number of chunks whose stats are kept for incremental collection
+  inline size_t GetChunkCount() { return chunk_stats_.size(); }
+
   ColumnStatsCollector* GetColumnStats(oid_t column_id);
 
  private:
+  // The stats collected from a chunk of tile groups
+  struct ChunkStats {
+    std::vector<oid_t> tile_group_offsets;
+    // The versions of the tile groups when the chunk was last scanned
+    std::vector<uint64_t> tile_group_versions;
+    std::vector<std::unique_ptr<ColumnStatsCollector>> column_stats_collectors;
+    size_t active_tuple_count = 0;
+  };
+
   storage::DataTable* table_;
   catalog::Schema* schema_;
   std::vector<std::unique_ptr<ColumnStatsCollector>> column_stats_collectors_;
+  std::vector<std::unique_ptr<ChunkStats>> chunk_stats_;
+  // The number of tile groups per kept chunk
+  size_t chunk_width_;
   size_t active_tuple_count_;
   size_t column_count_;
+  double sample_ratio_;
+  size_t scanned_tile_group_count_;
 
   TableStatsCollector(const TableStatsCollector&);
   void operator=(const TableStatsCollector&);
 
+  std::vector<std::unique_ptr<ColumnStatsCollector>>
+  CreateColumnStatsCollectors();
+
   void InitColumnStatsCollectors();
+
+  // Scan the tile groups of the chunk, unless none of them was modified since
+  // the chunk was last scanned. Returns true if the chunk was scanned.
+  bool CollectChunkStats(ChunkStats& chunk);
+
+  // Run CollectChunkStats() on all chunks, in parallel if possible
+  void CollectChunkStatsInParallel(std::vector<ChunkStats*>& chunks);
+
+  // Merge every pair of neighboring kept chunks into one twice as wide
+  void MergeNeighboringChunks();
+
+  // A version of the tile group, which changes whenever a tuple is inserted,
+  // updated or deleted
+  static uint64_t GetTileGroupVersion(storage::TileGroup* tile_group);
 };
 
 }  // namespace optimizer
@@ -611,6 +611,29 @@ class TopKElements {
     }
   }
 
+  /*
+   * Merge another TopKElements (built with a sketch of the same dimensions and
+   * seed) into this one. The candidates of both queues are re-ranked by their
+   * counts in the merged sketch.
+   */
+  void Merge(const TopKElements& other) {
+    cmsketch.Merge(other.cmsketch);
+
+    std::vector<ApproxTopEntry> candidates = tkq.retrieve_all();
+    std::vector<ApproxTopEntry> other_candidates = other.tkq.retrieve_all();
+    candidates.insert(candidates.end(), other_candidates.begin(),
+                      other_candidates.end());
+
+    tkq = TopKQueue{tkq.get_k()};
+    for (auto& entry : candidates) {
+      if (tkq.is_exist(entry)) {
+        continue;
+      }
+      entry.approx_count = EstimateItemCount(entry.approx_top_elem);
+      tkq.push(entry);
+    }
+  }
+
   // TODO:
   // Need to retrieve new elements after eviction of current element(s)
 
@@ -800,6 +823,16 @@ class TopKElements {
     return ApproxTopEntry(elem, freq);
   }
 
+  /*
+   * Estimate the count of an element using the sketch
+   */
+  uint64_t EstimateItemCount(const ApproxTopEntryElem& elem) {
+    if (elem.item_type == ApproxTopEntryElem::ElemType::INT_TYPE) {
+      return cmsketch.EstimateItemCount(elem.int_item);
+    }
+    return cmsketch.EstimateItemCount(elem.str_item.c_str());
+  }
+
   /*
    * Add the frequency (approx count) and item (Element) pair (ApproxTopEntry)
    * to the queue / update tkq structure
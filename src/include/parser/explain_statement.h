@@ -19,7 +19,7 @@ namespace parser {
 
 /**
  * @class ExplainStatement
- * @brief Represents "EXPLAIN <query>"
+ * @brief Represents "EXPLAIN [ANALYZE] <query>"
  */
 class ExplainStatement : public SQLStatement {
  public:
@@ -29,6 +29,9 @@ class ExplainStatement : public SQLStatement {
   void Accept(SqlNodeVisitor *v) override { v->Visit(this); }
 
   std::unique_ptr<parser::SQLStatement> real_sql_stmt;
+
+  // Execute the query and show the actual rows of each plan node
+  bool analyze = false;
 };
 
 }  // namespace parser
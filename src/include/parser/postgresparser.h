@@ -47,6 +47,10 @@ class PostgresParser {
   static parser::SQLStatementList *ParseSQLString(const char *sql);
   static parser::SQLStatementList *ParseSQLString(const std::string &sql);
 
+  // Replace all the constants of the query with placeholders ('?'),
+  // i.e., get a fingerprint of the query that ignores its literal values
+  static std::string NormalizeSQLString(const std::string &sql);
+
   static PostgresParser &GetInstance();
 
   std::unique_ptr<parser::SQLStatementList> BuildParseTree(
@@ -14,6 +14,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "catalog/schema.h"
@@ -89,6 +90,22 @@ class AbstractPlan : public Printable {
   // delete this function and pass this information to constructor
   void SetCardinality(int cardinality) { estimated_cardinality_ = cardinality; }
 
+  // Get the number of rows the optimizer expects this plan to produce, or -1
+  // if the plan was not built by the optimizer
+  int GetEstimatedRows() const { return estimated_rows_; }
+
+  void SetEstimatedRows(int estimated_rows) { estimated_rows_ = estimated_rows; }
+
+  // Get the predicate signature the actual output cardinality of this plan is
+  // fed back to the optimizer under, or an empty string if it is not
+  const std::string &GetCardinalityFeedbackKey() const {
+    return cardinality_feedback_key_;
+  }
+
+  void SetCardinalityFeedbackKey(const std::string &key) {
+    cardinality_feedback_key_ = key;
+  }
+
   //===--------------------------------------------------------------------===//
   // Utilities
   //===--------------------------------------------------------------------===//
@@ -157,6 +174,11 @@ class AbstractPlan : public Printable {
   // optimizer has the cost model and cardinality estimation
   int estimated_cardinality_ = 500000;
 
+  // The optimizer's row estimate, shown by EXPLAIN ANALYZE
+  int estimated_rows_ = -1;
+
+  std::string cardinality_feedback_key_;
+
  private:
   DISALLOW_COPY_AND_MOVE(AbstractPlan);
 };
@@ -167,6 +167,10 @@ class IndexScanPlan : public AbstractScan {
                        new_runtime_keys);
     IndexScanPlan *new_plan = new IndexScanPlan(
         GetTable(), GetPredicate()->Copy(), GetColumnIds(), desc, false);
+    new_plan->SetLimit(limit_);
+    new_plan->SetLimitNumber(limit_number_);
+    new_plan->SetLimitOffset(limit_offset_);
+    new_plan->SetDescend(descend_);
     return std::unique_ptr<AbstractPlan>(new_plan);
   }
 
@@ -15,6 +15,7 @@
 #include <set>
 #include <string>
 #include <tuple>
+#include <unordered_map>
 
 #include "planner/abstract_plan.h"
 #include "planner/abstract_scan_plan.h"
@@ -47,6 +48,18 @@ class PlanUtil {
    */
   static std::string GetInfo(const planner::AbstractPlan *plan);
 
+  /**
+   * @brief Pretty print the plan tree with the optimizer's row estimate and
+   * the number of rows each plan node actually produced, for EXPLAIN ANALYZE.
+   * @param The plan tree
+   * @param The number of rows produced by each plan node that was executed
+   * @return The string with the pretty-print plan
+   */
+  static std::string GetAnalyzeInfo(
+      const planner::AbstractPlan *plan,
+      const std::unordered_map<const planner::AbstractPlan *, size_t>
+          &actual_rows);
+
   /**
    * @brief Get the tables referenced in the plan
    * @param The plan tree
@@ -77,16 +90,35 @@ class PlanUtil {
       std::unique_ptr<parser::SQLStatementList> sql_stmt_list,
       const std::string &db_name);
 
+  /**
+   * @brief Is the plan expected to finish within microseconds, i.e., is it a
+   * lookup of a single key in a unique index, or an insert of a single tuple?
+   * Such plans are cheaper to execute on the calling thread than to hand off
+   * to the execution pool.
+   * @param The plan tree
+   * @return true if the plan is short
+   */
+  static bool IsShortQuery(const planner::AbstractPlan *plan);
+
  private:
   ///
   /// Helpers for GetInfo() and GetTablesReferenced()
   ///
 
-  static void GetInfo(const planner::AbstractPlan *plan, std::ostringstream &os,
-                      int num_indent);
+  static void GetInfo(
+      const planner::AbstractPlan *plan, std::ostringstream &os,
+      int num_indent,
+      const std::unordered_map<const planner::AbstractPlan *, size_t>
+          *actual_rows = nullptr);
 
   static void GetTablesReferenced(const planner::AbstractPlan *plan,
                                   std::set<oid_t> &table_ids);
+
+  ///
+  /// Helper for IsShortQuery()
+  ///
+
+  static bool IsPointLookup(const planner::AbstractPlan *plan);
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -111,19 +143,56 @@ inline std::string PlanUtil::GetInfo(const planner::AbstractPlan *plan) {
   return info;
 }
 
-inline void PlanUtil::GetInfo(const planner::AbstractPlan *plan,
-                              std::ostringstream &os, int num_indent) {
+inline std::string PlanUtil::GetAnalyzeInfo(
+    const planner::AbstractPlan *plan,
+    const std::unordered_map<const planner::AbstractPlan *, size_t>
+        &actual_rows) {
+  std::ostringstream os;
+  int num_indent = 0;
+
+  if (plan == nullptr) {
+    os << "<NULL>";
+  } else {
+    os << peloton::GETINFO_SINGLE_LINE << std::endl;
+    PlanUtil::GetInfo(plan, os, num_indent, &actual_rows);
+    os << peloton::GETINFO_SINGLE_LINE;
+  }
+  std::string info = os.str();
+  StringUtil::RTrim(info);
+  return info;
+}
+
+inline void PlanUtil::GetInfo(
+    const planner::AbstractPlan *plan, std::ostringstream &os,
+    int num_indent,
+    const std::unordered_map<const planner::AbstractPlan *, size_t>
+        *actual_rows) {
   os << StringUtil::Indent(num_indent)
      << "-> Plan Type: " << PlanNodeTypeToString(plan->GetPlanNodeType())
      << std::endl;
   os << StringUtil::Indent(num_indent + peloton::ARROW_INDENT)
      << "Info: " << plan->GetInfo() << std::endl;
+  if (actual_rows != nullptr) {
+    os << StringUtil::Indent(num_indent + peloton::ARROW_INDENT) << "Rows: ";
+    if (plan->GetEstimatedRows() >= 0) {
+      os << "estimated " << plan->GetEstimatedRows();
+    } else {
+      os << "estimated ?";
+    }
+    auto entry = actual_rows->find(plan);
+    if (entry != actual_rows->end()) {
+      os << ", actual " << entry->second;
+    } else {
+      os << ", never executed";
+    }
+    os << std::endl;
+  }
 
   auto &children = plan->GetChildren();
   os << StringUtil::Indent(num_indent + peloton::ARROW_INDENT)
      << "NumChildren: " << children.size() << std::endl;
   for (auto &child : children) {
-    GetInfo(child.get(), os, num_indent + peloton::ARROW_INDENT);
+    GetInfo(child.get(), os, num_indent + peloton::ARROW_INDENT, actual_rows);
   }
 }
 
@@ -89,6 +89,26 @@ SETTING_double(bnlj_buffer_size,
              1.0 * 1024.0 * 1024.0 * 1024,
              true, true)
 
+// Memory a query may use for hash joins and sorts before spilling to disk
+SETTING_int(query_memory_budget,
+            "Memory in MB that the hash joins and sorts of a query may use before they spill to temporary files, 0 means unlimited (default: 0)",
+            0,
+            0, std::numeric_limits<int32_t>::max(),
+            true, true)
+
+// Directory of the temporary files that queries spill to
+SETTING_string(spill_directory,
+               "Directory of the temporary files that queries spill to when they exceed their memory budget (default: /tmp)",
+               "/tmp",
+               false, false)
+
+// Memory that the running queries may use together before new ones wait
+SETTING_int(server_memory_budget,
+            "Memory in MB that all running queries may use together before new analytic queries are queued until others finish, 0 means unlimited (default: 0)",
+            0,
+            0, std::numeric_limits<int32_t>::max(),
+            true, true)
+
 // Size of the MonoQueue task queue
 SETTING_int(monoqueue_task_queue_size,
             "MonoQueue Task Queue Size (default: 32)",
@@ -110,6 +130,36 @@ SETTING_int(connection_thread_count,
             1, 64,
             false, false)
 
+// Execute short queries on the connection thread
+SETTING_bool(inline_short_queries,
+             "Execute short queries (e.g., point lookups) on the connection thread instead of the execution pool (default: false)",
+             false,
+             true, true)
+
+// Batch the socket I/O of each connection thread through io_uring
+SETTING_bool(io_uring,
+             "Send the responses of all connections of a connection handler thread in one io_uring submission per round of its event loop, and receive their queries through multishot io_uring receives (default: false)",
+             false,
+             false, false)
+
+// Give each connection thread its own listening socket
+SETTING_bool(reuse_port,
+             "Accept connections on a SO_REUSEPORT listening socket per connection thread instead of dispatching them from the master thread (default: false)",
+             false,
+             false, false)
+
+// Hand new connections to the least loaded connection thread
+SETTING_bool(rebalance_connections,
+             "Hand new connections to the connection thread with the fewest open connections when the accepting thread has noticeably more (default: false)",
+             false,
+             false, false)
+
+// Execute pipelined executions of the same prepared statement as one batch
+SETTING_bool(batch_pipelined_executions,
+             "Execute consecutive pipelined executions of the same prepared INSERT, UPDATE or DELETE in one task of the execution pool (default: false)",
+             false,
+             true, true)
+
 SETTING_int(gc_num_threads,
             "The number of Garbage collection threads to run",
             1,
@@ -127,6 +177,18 @@ SETTING_int(min_parallel_table_scan_size,
             1, std::numeric_limits<int32_t>::max(),
             true, true)
 
+// Layout of the MVCC headers of the tuples of new tables
+SETTING_bool(columnar_tuple_headers,
+             "Store the MVCC headers of the tuples of new tables in one array per field rather than one struct per tuple (default: false)",
+             false,
+             true, true)
+
+// Version storage of new tables
+SETTING_bool(delta_version_storage,
+             "Update the tuples of new tables in place, keeping the old values of the changed columns in undo records rather than copying the tuple into a new version (default: false)",
+             false,
+             true, true)
+
 //===----------------------------------------------------------------------===//
 // WRITE AHEAD LOG
 //===----------------------------------------------------------------------===//
@@ -146,6 +208,14 @@ SETTING_int(stats_mode,
            0, 16,
            true, true)
 
+// Fraction of the tile groups of a table that ANALYZE samples
+SETTING_double(analyze_sample_ratio,
+               "Fraction of the tile groups of a table that ANALYZE scans, 1 scans the whole table and keeps its stats for incremental analysis (default: 1)",
+               1.0,
+               0.0001,
+               1.0,
+               true, true)
+
 //===----------------------------------------------------------------------===//
 // AI
 //===----------------------------------------------------------------------===//
@@ -162,6 +232,12 @@ SETTING_bool(layout_tuner,
             false,
             true, true)
 
+// Enable or disable freezing (compressing) cold tile groups
+SETTING_bool(tile_group_freezer,
+            "Enable tile group freezer (default: false)",
+            false,
+            true, true)
+
 //===----------------------------------------------------------------------===//
 // BRAIN
 //===----------------------------------------------------------------------===//
@@ -227,6 +303,59 @@ SETTING_bool(hash_join_bloom_filter,
              false,
              true, true)
 
+SETTING_int(hash_join_radix_threshold,
+            "Estimated size in KB of the build side of a hash join above "
+                "which both sides are radix-partitioned before joining them, "
+                "0 disables partitioning (default: 4096)",
+            4096,
+            0, 1048576,
+            true, true)
+
+SETTING_bool(auto_parameterization,
+             "Cache the plans of simple queries with their literals "
+                 "replaced by parameters (default: false)",
+             false,
+             true, true)
+
+SETTING_bool(cardinality_feedback,
+             "Correct the selectivity estimates of scan predicates with the "
+                 "row counts of earlier executions (default: false)",
+             false,
+             true, true)
+
+SETTING_bool(parallel_optimization,
+             "Optimize the inputs of joins over disjoint tables in parallel "
+                 "on the execution worker pool (default: false)",
+             false,
+             true, true)
+
+SETTING_bool(cost_model_calibration,
+             "Fit the unit costs of the optimizer to this machine with "
+                 "microbenchmarks at startup (default: false)",
+             false,
+             true, true)
+
+SETTING_bool(join_order_enumeration,
+             "Enumerate the join orders of queries before exploring them "
+                 "with transformation rules (default: true)",
+             true,
+             true, true)
+
+SETTING_int(join_enumeration_dp_limit,
+            "Maximum number of tables in a join whose join orders are "
+                "enumerated exhaustively, larger joins are ordered greedily "
+                "(default: 12)",
+            12,
+            3, 16,
+            true, true)
+
+SETTING_int(join_exploration_limit,
+            "Maximum number of tables in a join whose join orders are also "
+                "explored with transformation rules (default: 6)",
+            6,
+            2, 64,
+            true, true)
+
 SETTING_int(task_execution_timeout,
             "Maximum allowed length of time (in ms) for task "
                 "execution step of optimizer, "
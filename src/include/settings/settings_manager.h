@@ -34,6 +34,7 @@ class SettingsManager : public Printable {
   static std::string GetString(SettingId id);
 
   static void SetInt(SettingId id, int32_t value);
+  static void SetDouble(SettingId id, double value);
   static void SetBool(SettingId id, bool value);
   static void SetString(SettingId id, const std::string &value);
   static SettingsManager &GetInstance();
@@ -21,6 +21,7 @@
 #include "common/container/lock_free_queue.h"
 #include "common/platform.h"
 #include "common/synchronization/spin_latch.h"
+#include "statistics/counter_metric.h"
 #include "statistics/database_metric.h"
 #include "statistics/index_metric.h"
 #include "statistics/latency_metric.h"
@@ -39,8 +40,6 @@ class IndexMetadata;
 
 namespace stats {
 
-class CounterMetric;
-
 /**
  * Context of backend stats as a singleton per thread
  */
@@ -79,6 +78,20 @@ class BackendStatsContext {
   // Returns the latency metric
   LatencyMetric &GetTxnLatencyMetric();
 
+  // Returns the execution latency metric of queries that ran on the
+  // connection thread
+  LatencyMetric &GetInlineQueryLatencyMetric();
+
+  // Returns the execution latency metric of queries that ran in the
+  // execution pool
+  LatencyMetric &GetQueuedQueryLatencyMetric();
+
+  // Returns the number of queries that ran on the connection thread
+  int64_t GetInlineQueryCount() { return inline_queries_.GetCounter(); }
+
+  // Returns the number of queries that ran in the execution pool
+  int64_t GetQueuedQueryCount() { return queued_queries_.GetCounter(); }
+
   // Increment the read stat for given tile group
   void IncrementTableReads(oid_t tile_group_id);
 
@@ -104,6 +117,12 @@ class BackendStatsContext {
   void IncrementIndexDeletes(size_t delete_count,
                              index::IndexMetadata *metadata);
 
+  // Increment the stat of queries executed on the connection thread
+  void IncrementInlineQueries(double latency);
+
+  // Increment the stat of queries executed in the execution pool
+  void IncrementQueuedQueries(double latency);
+
   // Increment the commit stat for given database
   void IncrementTxnCommitted(oid_t database_id);
 
@@ -170,6 +189,18 @@ class BackendStatsContext {
   // Latencies recorded by this worker
   LatencyMetric txn_latencies_;
 
+  // Execution latencies of queries that ran on the connection thread
+  LatencyMetric inline_query_latencies_;
+
+  // Execution latencies of queries that ran in the execution pool
+  LatencyMetric queued_query_latencies_;
+
+  // Number of queries that ran on the connection thread
+  CounterMetric inline_queries_{MetricType::COUNTER};
+
+  // Number of queries that ran in the execution pool
+  CounterMetric queued_queries_{MetricType::COUNTER};
+
   // Whether this context is registered to the global aggregator
   bool is_registered_to_aggregator_;
 
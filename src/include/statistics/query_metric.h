@@ -12,10 +12,12 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <sstream>
 #include <vector>
 #include "common/internal_types.h"
+#include "common/memory_tracker.h"
 #include "statistics/abstract_metric.h"
 #include "statistics/access_metric.h"
 #include "statistics/latency_metric.h"
@@ -85,6 +87,21 @@ class QueryMetric : public AbstractMetric {
     return query_params_;
   }
 
+  // Set the tracker of the memory the query uses while it executes
+  inline void SetMemoryTracker(std::shared_ptr<MemoryTracker> memory_tracker) {
+    memory_tracker_ = std::move(memory_tracker);
+  }
+
+  // The bytes of memory the query uses right now
+  inline uint64_t GetCurrentMemory() const {
+    return memory_tracker_ != nullptr ? memory_tracker_->GetCurrent() : 0;
+  }
+
+  // The most bytes of memory the query used at any one time
+  inline uint64_t GetPeakMemory() const {
+    return memory_tracker_ != nullptr ? memory_tracker_->GetPeak() : 0;
+  }
+
   //===--------------------------------------------------------------------===//
   // HELPER FUNCTIONS
   //===--------------------------------------------------------------------===//
@@ -99,6 +116,8 @@ class QueryMetric : public AbstractMetric {
     ss << "  QUERY " << query_name_ << std::endl;
     ss << peloton::GETINFO_SINGLE_LINE << std::endl;
     ss << query_access_.GetInfo();
+    ss << "  Memory: current " << GetCurrentMemory() << " bytes, peak "
+       << GetPeakMemory() << " bytes" << std::endl;
     return ss.str();
   }
 
@@ -124,6 +143,9 @@ class QueryMetric : public AbstractMetric {
 
   // Processor metric
   ProcessorMetric processor_metric_{MetricType::PROCESSOR};
+
+  // The memory used by the query, null if it was not executed
+  std::shared_ptr<MemoryTracker> memory_tracker_;
 };
 
 }  // namespace stats
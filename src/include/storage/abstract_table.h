@@ -81,6 +81,14 @@ class AbstractTable : public Printable {
   }
 
   std::shared_ptr<const Layout> GetDefaultLayout() { return default_layout_; }
+
+  // Whether the MVCC headers of the tile groups are stored by row or column
+  LayoutType GetTupleHeaderLayout() const { return tuple_header_layout_; }
+
+  // Whether updates change the tuples in place and keep the old values in
+  // undo records, rather than appending new versions
+  bool UsesDeltaStorage() const { return delta_storage_; }
+
   //===--------------------------------------------------------------------===//
   // TILE GROUP
   //===--------------------------------------------------------------------===//
@@ -151,6 +159,13 @@ class AbstractTable : public Printable {
 
   // Default layout of the table
   std::shared_ptr<const Layout> default_layout_;
+
+  // Layout of the tuple headers of the table's tile groups, picked when the
+  // table is created
+  LayoutType tuple_header_layout_;
+
+  // Whether the table uses delta storage, picked when the table is created
+  bool delta_storage_;
 };
 
 }  // namespace storage
@@ -0,0 +1,210 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// compressed_tile_group.h
+//
+// Identification: src/include/storage/compressed_tile_group.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "common/internal_types.h"
+#include "common/macros.h"
+#include "common/printable.h"
+#include "type/value.h"
+
+namespace peloton {
+namespace storage {
+
+class TileGroup;
+struct PredicateInfo;
+
+//===--------------------------------------------------------------------===//
+// Compressed Column
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief An immutable, encoded copy of one column of a frozen tile group.
+ *
+ * Every value is first mapped to an integer code that preserves the order of
+ * the original values: integer-like columns (TINYINT through BIGINT, DATE and
+ * TIMESTAMP) use frame-of-reference, i.e., the distance from the column
+ * minimum, while VARCHAR columns use the position in a sorted dictionary of
+ * the distinct values. If the column contains NULLs, code 0 is reserved for
+ * NULL and all other codes are shifted by one.
+ *
+ * The codes are then stored either bit-packed using the minimum number of
+ * bits, or run-length encoded when that is smaller (i.e., low-cardinality or
+ * clustered columns).
+ *
+ * Because codes preserve order, every comparison against a constant maps to a
+ * contiguous range of codes, which lets us evaluate predicates without ever
+ * decoding a value.
+ */
+class CompressedColumn {
+ public:
+  /**
+   * @brief Encode the given values of a column.
+   *
+   * @param type_id The SQL type of the column
+   * @param values The values of the column, one per tuple slot
+   * @return The encoded column, or nullptr if the type cannot be encoded, or
+   * if the values span too much of the BIGINT range
+   */
+  static std::unique_ptr<CompressedColumn> Encode(
+      type::TypeId type_id, const std::vector<type::Value> &values);
+
+  /** @brief Is a column of the given type encodable? */
+  static bool IsEncodable(type::TypeId type_id);
+
+  /** @brief The encoding that was chosen for the column */
+  CompressionType GetCompressionType() const;
+
+  type::TypeId GetTypeId() const { return type_id_; }
+
+  oid_t GetTupleCount() const { return num_tuples_; }
+
+  /** @brief Decode the value at the given tuple slot */
+  type::Value GetValue(oid_t tuple_offset) const;
+
+  /**
+   * @brief Can "value <cmp_type> constant" be evaluated on the encoded data?
+   */
+  bool CanEvaluate(ExpressionType cmp_type, const type::Value &constant) const;
+
+  /**
+   * @brief Filter the TIDs in the selection vector, keeping only those whose
+   * value satisfies "value <cmp_type> constant". NULLs never qualify.
+   *
+   * @param cmp_type The comparison to apply
+   * @param constant The constant on the right-hand side of the comparison
+   * @param[in,out] sel The (ascending) TIDs to filter, compacted in place
+   * @param num_sel The number of TIDs in the selection vector
+   * @param[out] num_out The number of TIDs that qualified
+   * @return false if the comparison cannot be evaluated on the encoded data,
+   * in which case the selection vector is untouched
+   */
+  bool Filter(ExpressionType cmp_type, const type::Value &constant,
+              uint32_t *sel, uint32_t num_sel, uint32_t &num_out) const;
+
+  /** @brief The number of bytes used by the encoded column */
+  size_t GetCompressedSize() const;
+
+ private:
+  // A run of identical codes ending (exclusively) at the given tuple slot
+  struct Run {
+    uint64_t code;
+    oid_t end;
+  };
+
+  CompressedColumn(type::TypeId type_id, oid_t num_tuples)
+      : type_id_(type_id),
+        num_tuples_(num_tuples),
+        has_nulls_(false),
+        base_(0),
+        num_values_(0),
+        bit_width_(0),
+        is_run_length_(false) {}
+
+  // Store the codes either bit-packed or run-length encoded
+  void PackCodes(const std::vector<uint64_t> &codes);
+
+  // Get the code of the value at the given tuple slot
+  uint64_t GetCode(oid_t tuple_offset) const;
+
+  // Find the positions in the (ordered) value domain of the first value that
+  // is not less than, and of the first value that is greater than, the
+  // constant. Returns false if the constant isn't comparable with the column.
+  bool LocateConstant(const type::Value &constant, uint64_t &lower,
+                      uint64_t &upper) const;
+
+ private:
+  // The SQL type of the column
+  type::TypeId type_id_;
+
+  // The number of encoded tuple slots
+  oid_t num_tuples_;
+
+  // Whether code 0 is reserved for NULL
+  bool has_nulls_;
+
+  // The minimum value (frame-of-reference encoding)
+  int64_t base_;
+
+  // The sorted distinct values (dictionary encoding)
+  std::vector<type::Value> dictionary_;
+
+  // The number of distinct codes for non-NULL values
+  uint64_t num_values_;
+
+  // The bit-packed codes, with one extra word of padding
+  uint32_t bit_width_;
+  std::vector<uint64_t> packed_codes_;
+
+  // The runs of codes, if the column is run-length encoded
+  bool is_run_length_;
+  std::vector<Run> runs_;
+};
+
+//===--------------------------------------------------------------------===//
+// Compressed Tile Group
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief The compressed, columnar form of a frozen (immutable) tile group.
+ *
+ * The compressed columns are used by compiled scans to evaluate simple
+ * predicates directly on the encoded data. Columns whose type cannot be
+ * encoded are left out. The tiles whose columns are all encoded may drop
+ * their tuple slots, and decode them from here when they are next accessed.
+ */
+class CompressedTileGroup : public Printable {
+ public:
+  /**
+   * @brief Compress all encodable columns of the tile group. The caller must
+   * guarantee that the tile group is full and immutable.
+   */
+  static std::unique_ptr<CompressedTileGroup> Compress(TileGroup *tile_group);
+
+  oid_t GetTupleCount() const { return num_tuples_; }
+
+  /** @brief Get the encoded column, or nullptr if it was not compressed */
+  const CompressedColumn *GetColumn(oid_t column_id) const {
+    return column_id < columns_.size() ? columns_[column_id].get() : nullptr;
+  }
+
+  /**
+   * @brief Filter the TIDs in the selection vector by the conjunction of the
+   * given predicates.
+   *
+   * @return false if any of the predicates cannot be evaluated on the encoded
+   * data, in which case the selection vector is untouched
+   */
+  bool Filter(const PredicateInfo *predicates, uint32_t num_predicates,
+              uint32_t *sel, uint32_t num_sel, uint32_t &num_out) const;
+
+  /** @brief The number of bytes used by all encoded columns */
+  size_t GetCompressedSize() const;
+
+  const std::string GetInfo() const override;
+
+ private:
+  explicit CompressedTileGroup(oid_t num_tuples) : num_tuples_(num_tuples) {}
+
+ private:
+  // The number of compressed tuple slots
+  oid_t num_tuples_;
+
+  // The encoded columns, indexed by column id (nullptr if not encoded)
+  std::vector<std::unique_ptr<CompressedColumn>> columns_;
+};
+
+}  // namespace storage
+}  // namespace peloton
@@ -122,6 +122,16 @@ class DataTable : public AbstractTable {
                       concurrency::TransactionContext *transaction,
                       ItemPointer *index_entry_ptr);
 
+  // whether an update of the given columns can change the tuples in place
+  // rather than installing a new version. this needs delta storage, and none
+  // of the columns may be indexed, so that the index entries stay valid.
+  bool CanUpdateInPlace(const std::vector<oid_t> &column_ids);
+
+  // check the constraints of a tuple before it is written in place
+  bool CheckInPlaceVersion(const AbstractTuple *tuple) const {
+    return CheckConstraints(tuple);
+  }
+
   // insert tuple in table. the pointer to the index entry is returned as
   // index_entry_ptr.
   ItemPointer InsertTuple(const Tuple *tuple,
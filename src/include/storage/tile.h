@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <mutex>
 
 #include "catalog/manager.h"
@@ -177,6 +178,28 @@ class Tile : public Printable {
   // Sync the contents
   void Sync();
 
+  //===--------------------------------------------------------------------===//
+  // Frozen tiles
+  //===--------------------------------------------------------------------===//
+
+  /**
+   * @brief Drop the tuple slots of the tile, if the compressed form of its
+   * (frozen) tile group holds all of its columns. They are decoded from the
+   * compressed tile group again when the tile is next accessed.
+   *
+   * @return The dropped slots, or nullptr if they are dropped already or
+   * can't be dropped. Readers that got hold of them before may use them until
+   * the current epoch expires, so the caller frees them (with delete[]) only
+   * after that.
+   */
+  char *DropTupleSlots();
+
+  /** @brief Does the tile hold its tuple slots, i.e., are they not dropped? */
+  bool HasTupleSlots() const { return data.load() != nullptr; }
+
+  /** @brief Were the slots decoded since the last call? Clears the flag. */
+  bool TestAndClearThawed() { return thawed_.exchange(false); }
+
  protected:
   //===--------------------------------------------------------------------===//
   // Data members
@@ -194,8 +217,17 @@ class Tile : public Printable {
   // tile schema
   catalog::Schema schema;
 
-  // set of fixed-length tuple slots
-  char *data;
+  // set of fixed-length tuple slots, nullptr while dropped. See
+  // DropTupleSlots().
+  mutable std::atomic<char *> data;
+
+  // Whether the slots were decoded since the freezer last looked
+  mutable std::atomic<bool> thawed_;
+
+  // Whether the compressed tile group holds all columns of the tile, once
+  // known. Only used by the freezer.
+  enum class Droppability { UNKNOWN, DROPPABLE, NOT_DROPPABLE };
+  Droppability droppability_;
 
   // relevant tile group
   TileGroup *tile_group;
@@ -228,12 +260,25 @@ class Tile : public Printable {
    * This is maintained by shared Tile Header.
    */
   TileGroupHeader *tile_group_header;
+
+ private:
+  // The columns of the tile group stored in the tile, by their offset in the
+  // tile
+  std::vector<oid_t> GetTileGroupColumns() const;
+
+  // Decode the dropped tuple slots from the compressed tile group, and
+  // install them
+  char *ThawTupleSlots() const;
 };
 
 // Returns a pointer to the tuple requested. No checks are done that the index
 // is valid.
 inline char *Tile::GetTupleLocation(const oid_t tuple_offset) const {
-  char *tuple_location = data + (tuple_offset * tuple_length);
+  char *tuple_slots = data.load(std::memory_order_acquire);
+  if (tuple_slots == nullptr) {
+    tuple_slots = ThawTupleSlots();
+  }
+  char *tuple_location = tuple_slots + (tuple_offset * tuple_length);
 
   return tuple_location;
 }
@@ -241,17 +286,19 @@ inline char *Tile::GetTupleLocation(const oid_t tuple_offset) const {
 // Finds index of tuple for a given tuple address.
 // Returns -1 if no matching tuple was found
 inline int Tile::GetTupleOffset(const char *tuple_address) const {
+  const char *tuple_slots = data.load(std::memory_order_acquire);
   // check if address within tile bounds
-  if ((tuple_address < data) || (tuple_address >= (data + tile_size)))
+  if ((tuple_address < tuple_slots) ||
+      (tuple_address >= (tuple_slots + tile_size)))
     return -1;
 
   int tuple_id = 0;
 
   // check if address is at an offset that is an integral multiple of tuple
   // length
-  tuple_id = (tuple_address - data) / tuple_length;
+  tuple_id = (tuple_address - tuple_slots) / tuple_length;
 
-  if (tuple_id * tuple_length + data == tuple_address) return tuple_id;
+  if (tuple_id * tuple_length + tuple_slots == tuple_address) return tuple_id;
 
   return -1;
 }
@@ -53,6 +53,7 @@ class TileGroupHeader;
 class AbstractTable;
 class TileGroupIterator;
 class RollbackSegment;
+class CompressedTileGroup;
 
 /**
  * Represents a group of tiles logically horizontally contiguous.
@@ -158,12 +159,30 @@ class TileGroup : public Printable {
 
   void SetValue(type::Value &value, oid_t tuple_id, oid_t column_id);
 
+  // Get the location of the inline bytes of a column of a tuple
+  char *GetValueLocation(oid_t tuple_id, oid_t column_id) const;
+
+  // Copy the inline bytes of all the columns of a tuple into a tuple of the
+  // table schema. Variable length values stay owned by the tile group.
+  void ReadTuple(const oid_t &tuple_slot_id, Tuple *tuple) const;
+
   // Sync the contents
   void Sync();
 
   // Get the layout of the TileGroup. Used to locate columns.
   const storage::Layout &GetLayout() const { return *tile_group_layout_; }
 
+  // Get the compressed form of this tile group, or nullptr if it's not frozen
+  std::shared_ptr<const CompressedTileGroup> GetCompressedTileGroup() const {
+    return std::atomic_load(&compressed_tile_group_);
+  }
+
+  // Install the compressed form of this (full and immutable) tile group
+  void SetCompressedTileGroup(
+      std::shared_ptr<const CompressedTileGroup> compressed_tile_group) {
+    std::atomic_store(&compressed_tile_group_, compressed_tile_group);
+  }
+
  protected:
   //===--------------------------------------------------------------------===//
   // Data members
@@ -196,6 +215,9 @@ class TileGroup : public Printable {
 
   // Refernce to the layout of the TileGroup
   std::shared_ptr<const Layout> tile_group_layout_;
+
+  // The compressed columnar copy of the tile group, once it has been frozen
+  std::shared_ptr<const CompressedTileGroup> compressed_tile_group_;
 };
 
 }  // namespace storage
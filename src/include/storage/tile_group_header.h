@@ -14,6 +14,7 @@
 
 #include <atomic>
 #include <cstring>
+#include <memory>
 
 #include "common/item_pointer.h"
 #include "common/macros.h"
@@ -27,6 +28,7 @@ namespace peloton {
 namespace storage {
 
 class TileGroup;
+class UndoRecord;
 
 //===--------------------------------------------------------------------===//
 // Tuple Header
@@ -56,6 +58,31 @@ struct TupleHeader {
  *  indirection: the pointer pointing to the index entry that holds the address of the version chain header.
 */
 
+/**
+ * The same fields as in TupleHeader, stored as one array per field, for
+ * tile groups whose headers are laid out by column.
+ */
+struct TupleHeaderColumns {
+  explicit TupleHeaderColumns(oid_t tuple_count)
+      : latch(new common::synchronization::SpinLatch[tuple_count]),
+        txn_id(new std::atomic<txn_id_t>[tuple_count]),
+        read_ts(new cid_t[tuple_count]),
+        begin_ts(new cid_t[tuple_count]),
+        end_ts(new cid_t[tuple_count]),
+        next(new ItemPointer[tuple_count]),
+        prev(new ItemPointer[tuple_count]),
+        indirection(new ItemPointer *[tuple_count]) {}
+
+  std::unique_ptr<common::synchronization::SpinLatch[]> latch;
+  std::unique_ptr<std::atomic<txn_id_t>[]> txn_id;
+  std::unique_ptr<cid_t[]> read_ts;
+  std::unique_ptr<cid_t[]> begin_ts;
+  std::unique_ptr<cid_t[]> end_ts;
+  std::unique_ptr<ItemPointer[]> next;
+  std::unique_ptr<ItemPointer[]> prev;
+  std::unique_ptr<ItemPointer *[]> indirection;
+};
+
 //===--------------------------------------------------------------------===//
 // Tile Group Header
 //===--------------------------------------------------------------------===//
@@ -71,13 +98,29 @@ struct TupleHeader {
  *  TxnID != INITIAL_TXN_ID, BeginTS != MAX_CID --> to-be-updated old version
  *  TxnID != INITIAL_TXN_ID, BeginTS == MAX_CID, EndTS == MAX_CID --> to-be-installed new version
  *  TxnID != INITIAL_TXN_ID, BeginTS == MAX_CID, EndTS == INVALID_CID --> to-be-installed deleted version
+ *
+ *  With delta storage, a slot keeps the newest version of a tuple, which its
+ *  owner changes in place. The older versions are rebuilt from the slot's
+ *  undo chain, see UndoRecord.
+ *
+ *  LAYOUT:
+ *  ===================
+ *  With the ROW layout, the fields of each slot are stored together in a
+ *  TupleHeader, so that updating a version touches one cache line. With the
+ *  COLUMN layout, every field is stored in an array of its own, so that
+ *  scans, which mostly read the begin and end commit ids, do not drag the
+ *  other fields into the cache. Either way, the value of a slot's field is at
+ *  a fixed stride from the previous slot's, so accessors do not branch on the
+ *  layout.
  */
 
 class TileGroupHeader : public Printable {
   TileGroupHeader() = delete;
 
  public:
-  TileGroupHeader(const BackendType &backend_type, const int &tuple_count);
+  TileGroupHeader(const BackendType &backend_type, const int &tuple_count,
+                  LayoutType layout_type = LayoutType::ROW,
+                  bool has_undo_chains = false);
 
   TileGroupHeader &operator=(const peloton::storage::TileGroupHeader &other) {
     // check for self-assignment
@@ -88,6 +131,7 @@ class TileGroupHeader : public Printable {
     num_tuple_slots = other.num_tuple_slots;
     next_tuple_slot.store(other.next_tuple_slot);
     immutable = other.immutable;
+    all_visible_cid.store(other.all_visible_cid);
 
     // copy tuple header values
     for (oid_t tuple_slot_id = START_OID; tuple_slot_id < num_tuple_slots;
@@ -107,7 +151,7 @@ class TileGroupHeader : public Printable {
     return *this;
   }
 
-  ~TileGroupHeader() = default;
+  ~TileGroupHeader();
 
   oid_t GetNextEmptyTupleSlot() {
     if (next_tuple_slot >= num_tuple_slots) {
@@ -166,35 +210,46 @@ class TileGroupHeader : public Printable {
 
   inline common::synchronization::SpinLatch &GetSpinLatch(
       const oid_t &tuple_slot_id) const {
-    return tuple_headers_[tuple_slot_id].latch;
+    return latches_[tuple_slot_id];
   }
 
   inline txn_id_t GetTransactionId(const oid_t &tuple_slot_id) const {
-    return tuple_headers_[tuple_slot_id].txn_id;
+    return txn_ids_[tuple_slot_id];
   }
 
   inline cid_t GetLastReaderCommitId(const oid_t &tuple_slot_id) const {
-    return tuple_headers_[tuple_slot_id].read_ts;
+    return read_ts_[tuple_slot_id];
   }
 
   inline cid_t GetBeginCommitId(const oid_t &tuple_slot_id) const {
-    return tuple_headers_[tuple_slot_id].begin_ts;
+    return begin_ts_[tuple_slot_id];
   }
 
   inline cid_t GetEndCommitId(const oid_t &tuple_slot_id) const {
-    return tuple_headers_[tuple_slot_id].end_ts;
+    return end_ts_[tuple_slot_id];
   }
 
   inline ItemPointer GetNextItemPointer(const oid_t &tuple_slot_id) const {
-    return tuple_headers_[tuple_slot_id].next;
+    return next_[tuple_slot_id];
   }
 
   inline ItemPointer GetPrevItemPointer(const oid_t &tuple_slot_id) const {
-    return tuple_headers_[tuple_slot_id].prev;
+    return prev_[tuple_slot_id];
   }
 
   inline ItemPointer *GetIndirection(const oid_t &tuple_slot_id) const {
-    return tuple_headers_[tuple_slot_id].indirection;
+    return indirections_[tuple_slot_id];
+  }
+
+  /**
+   * Whether the slots have undo chains, which is the case in the tile groups
+   * of tables with delta storage
+   */
+  inline bool HasUndoChains() const { return undo_chains_ != nullptr; }
+
+  /** The newest undo record of the slot, nullptr if there is none */
+  inline UndoRecord *GetUndoRecord(const oid_t &tuple_slot_id) const {
+    return undo_chains_[tuple_slot_id].load();
   }
 
   // Setters
@@ -205,46 +260,87 @@ class TileGroupHeader : public Printable {
 
   inline void SetTransactionId(const oid_t &tuple_slot_id,
                                const txn_id_t &transaction_id) const {
-    tuple_headers_[tuple_slot_id].txn_id = transaction_id;
+    txn_ids_[tuple_slot_id] = transaction_id;
   }
 
   inline void SetLastReaderCommitId(const oid_t &tuple_slot_id,
                                     const cid_t &read_cid) const {
-    tuple_headers_[tuple_slot_id].read_ts = read_cid;
+    read_ts_[tuple_slot_id] = read_cid;
   }
 
   inline void SetBeginCommitId(const oid_t &tuple_slot_id,
                                const cid_t &begin_cid) {
-    tuple_headers_[tuple_slot_id].begin_ts = begin_cid;
+    begin_ts_[tuple_slot_id] = begin_cid;
+    // Every version that is installed, committed, rolled back or reclaimed
+    // gets a new begin commit id
+    modification_count_.fetch_add(1, std::memory_order_relaxed);
   }
 
   inline void SetEndCommitId(const oid_t &tuple_slot_id,
                              const cid_t &end_cid) const {
-    tuple_headers_[tuple_slot_id].end_ts = end_cid;
+    end_ts_[tuple_slot_id] = end_cid;
   }
 
   inline void SetNextItemPointer(const oid_t &tuple_slot_id,
                                  const ItemPointer &item) const {
-    tuple_headers_[tuple_slot_id].next = item;
+    next_[tuple_slot_id] = item;
   }
 
   inline void SetPrevItemPointer(const oid_t &tuple_slot_id,
                                  const ItemPointer &item) const {
-    tuple_headers_[tuple_slot_id].prev = item;
+    prev_[tuple_slot_id] = item;
   }
 
   inline void SetIndirection(const oid_t &tuple_slot_id,
                              ItemPointer *indirection) const {
-    tuple_headers_[tuple_slot_id].indirection = indirection;
+    indirections_[tuple_slot_id] = indirection;
+  }
+
+  inline void SetUndoRecord(const oid_t &tuple_slot_id,
+                            UndoRecord *undo_record) const {
+    undo_chains_[tuple_slot_id].store(undo_record);
   }
 
   inline bool SetAtomicTransactionId(const oid_t &tuple_slot_id,
                                      const txn_id_t &transaction_id) const {
     auto old_val = INITIAL_TXN_ID;
-    return tuple_headers_[tuple_slot_id].txn_id.compare_exchange_strong(
-        old_val, transaction_id);
+    if (!txn_ids_[tuple_slot_id].compare_exchange_strong(old_val,
+                                                        transaction_id)) {
+      return false;
+    }
+    // Every change to a committed version starts by taking ownership of it
+    if (all_visible_cid.load() != MAX_CID) {
+      all_visible_cid.store(MAX_CID);
+    }
+    return true;
   }
 
+  /**
+   * @brief Get the commit id as of which all versions in the tile group are
+   * visible. A transaction whose read id is no smaller than it may skip the
+   * visibility checks of the tile group. MAX_CID if there is none.
+   */
+  inline cid_t GetAllVisibleCommitId() const { return all_visible_cid; }
+
+  /**
+   * @brief Get the number of changes to the versions in the tile group. If it
+   * is the same at two points in time, no version changed in between.
+   */
+  inline uint64_t GetModificationCount() const {
+    return modification_count_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Mark the tile group all visible if it is full and every slot holds
+   * the latest committed version of a tuple that no transaction owns. The mark
+   * is dropped as soon as any transaction takes ownership of one of them.
+   * Tile groups with undo chains are never marked, since their slots change
+   * in place.
+   *
+   * @return true if the tile group is marked all visible
+   */
+  bool MarkAllVisible();
+
   /*
   * @brief The following method use Compare and Swap to set the tilegroup's
   immutable flag to be true. 
@@ -263,6 +359,9 @@ class TileGroupHeader : public Printable {
 
   inline bool GetImmutability() const { return immutable; }
 
+  /** Whether the tuple headers are stored by row or by column */
+  inline LayoutType GetLayoutType() const { return layout_type_; }
+
   void PrintVisibility(txn_id_t txn_id, cid_t at_cid);
 
   // Getter for spin lock
@@ -276,6 +375,29 @@ class TileGroupHeader : public Printable {
   const std::string GetInfo() const;
 
  private:
+  /**
+   * The values of one field of all the tuple headers. The value of a slot is
+   * a fixed stride after the value of the previous slot: the size of a
+   * TupleHeader in the ROW layout, and the size of the field in the COLUMN
+   * layout.
+   */
+  template <typename T>
+  class FieldArray {
+   public:
+    FieldArray() : base_(nullptr), stride_(0) {}
+
+    FieldArray(T *base, size_t stride)
+        : base_(reinterpret_cast<char *>(base)), stride_(stride) {}
+
+    T &operator[](oid_t tuple_slot_id) const {
+      return *reinterpret_cast<T *>(base_ + tuple_slot_id * stride_);
+    }
+
+   private:
+    char *base_;
+    size_t stride_;
+  };
+
   //===--------------------------------------------------------------------===//
   // Data members
   //===--------------------------------------------------------------------===//
@@ -286,8 +408,29 @@ class TileGroupHeader : public Printable {
   // Associated tile_group
   TileGroup *tile_group;
 
+  // Whether the tuple headers are stored by row or by column
+  LayoutType layout_type_;
+
+  // The tuple headers in the ROW layout, null otherwise
   std::unique_ptr<TupleHeader[]> tuple_headers_;
 
+  // The tuple headers in the COLUMN layout, null otherwise
+  std::unique_ptr<TupleHeaderColumns> tuple_header_columns_;
+
+  // The fields of the tuple headers, in either layout
+  FieldArray<common::synchronization::SpinLatch> latches_;
+  FieldArray<std::atomic<txn_id_t>> txn_ids_;
+  FieldArray<cid_t> read_ts_;
+  FieldArray<cid_t> begin_ts_;
+  FieldArray<cid_t> end_ts_;
+  FieldArray<ItemPointer> next_;
+  FieldArray<ItemPointer> prev_;
+  FieldArray<ItemPointer *> indirections_;
+
+  // The undo chains of the slots, newest record first. Only allocated in the
+  // tile groups of tables with delta storage.
+  std::unique_ptr<std::atomic<UndoRecord *>[]> undo_chains_;
+
   // number of tuple slots allocated
   oid_t num_tuple_slots;
 
@@ -301,6 +444,13 @@ class TileGroupHeader : public Printable {
   // Immmutable Flag. Should be set by the indextuner to be true.
   // By default it will be set to false.
   bool immutable;
+
+  // All versions are visible to transactions reading as of this commit id, or
+  // MAX_CID if unknown. See MarkAllVisible().
+  mutable std::atomic<cid_t> all_visible_cid;
+
+  // See GetModificationCount()
+  std::atomic<uint64_t> modification_count_;
 };
 
 }  // namespace storage
@@ -34,7 +34,7 @@ class TupleIterator : public Iterator<Tuple> {
 
  public:
   TupleIterator(const Tile *tile)
-      : data(tile->data),
+      : data(tile->GetTupleLocation(0)),
         tile(tile),
         tuple_itr(0),
         tuple_length(tile->tuple_length) {
@@ -0,0 +1,122 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// undo_record.h
+//
+// Identification: src/include/storage/undo_record.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "common/internal_types.h"
+#include "common/macros.h"
+
+namespace peloton {
+namespace storage {
+
+class TileGroup;
+class Tuple;
+class UndoSegment;
+
+//===--------------------------------------------------------------------===//
+// Undo Record
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief The before-image of the columns that a transaction changed in place.
+ *
+ * Tables with delta storage keep only the newest version of a tuple in its
+ * slot. Every in-place update pushes a record holding the old values of the
+ * columns it changes onto the slot's undo chain, which the tile group header
+ * keeps newest to oldest. Applying the records of a chain in order to the
+ * newest version rebuilds the older versions. The version restored by a
+ * record became visible at the record's begin commit id, and stopped being
+ * visible when the version restored by the previous record, or the one in the
+ * slot, became visible.
+ *
+ * Only the inline bytes of the columns are saved. Variable length values are
+ * never freed when a tile overwrites them, so the saved pointers stay valid.
+ *
+ * Records are carved out of per-thread undo buffers, and are freed one by one
+ * once no transaction can read the versions they restore. See
+ * TransactionLevelGCManager::UnlinkVersions().
+ */
+class UndoRecord {
+ public:
+  /**
+   * @brief Save the values that the columns of a tuple slot hold now
+   *
+   * @param txn_id The transaction about to change the columns
+   * @param begin_cid The commit id as of which the old values are visible,
+   * MAX_CID if they were written by the same transaction
+   */
+  static UndoRecord *Create(txn_id_t txn_id, cid_t begin_cid,
+                            TileGroup *tile_group, oid_t tuple_id,
+                            const std::vector<oid_t> &column_ids);
+
+  /** Free a record. The records it links to are left alone. */
+  static void Free(UndoRecord *record);
+
+  /** Free a record and all the older records it links to */
+  static void FreeChain(UndoRecord *record);
+
+  inline txn_id_t GetTransactionId() const { return txn_id_; }
+
+  /** The commit id as of which the restored version is visible */
+  inline cid_t GetBeginCommitId() const { return begin_cid_; }
+
+  /** The next older record of the chain */
+  inline UndoRecord *GetNext() const { return next_.load(); }
+
+  inline void SetNext(UndoRecord *next) { next_.store(next); }
+
+  /** Whether the record saves the old value of the column */
+  bool Covers(oid_t column_id) const;
+
+  /** Write the old values into a tuple of the table schema */
+  void ApplyTo(Tuple *tuple) const;
+
+  /** Write the old values back into the tuple slot */
+  void ApplyTo(TileGroup *tile_group, oid_t tuple_id) const;
+
+ private:
+  UndoRecord(txn_id_t txn_id, cid_t begin_cid, UndoSegment *segment,
+             oid_t column_count)
+      : txn_id_(txn_id),
+        begin_cid_(begin_cid),
+        next_(nullptr),
+        segment_(segment),
+        column_count_(column_count) {}
+
+  DISALLOW_COPY_AND_MOVE(UndoRecord);
+
+  // The column ids, followed by the inline bytes of their old values
+  const oid_t *GetColumnIds() const {
+    return reinterpret_cast<const oid_t *>(this + 1);
+  }
+
+  const char *GetValues() const {
+    return reinterpret_cast<const char *>(GetColumnIds() + column_count_);
+  }
+
+  txn_id_t txn_id_;
+
+  cid_t begin_cid_;
+
+  std::atomic<UndoRecord *> next_;
+
+  // The segment of the undo buffer the record lives in
+  UndoSegment *segment_;
+
+  oid_t column_count_;
+};
+
+}  // namespace storage
+}  // namespace peloton
@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// memory_governor.h
+//
+// Identification: src/include/threadpool/memory_governor.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <mutex>
+
+#include "common/memory_tracker.h"
+
+namespace peloton {
+namespace threadpool {
+
+/**
+ * @brief Admission control for queries based on the memory they use.
+ *
+ * The governor owns the root of the memory trackers, which sees the memory of
+ * every running query. Queries are submitted to the execution pool through the
+ * governor. While the running queries use more than the server memory budget,
+ * new ones wait in a queue and are only handed to the pool as running queries
+ * finish and give their memory back. A query is always admitted if no other
+ * query runs, so that a single query larger than the budget still runs, and
+ * short queries are never held back.
+ */
+class MemoryGovernor {
+ public:
+  static MemoryGovernor &GetInstance();
+
+  /** The tracker that the memory of all queries counts towards */
+  MemoryTracker &GetTracker() { return tracker_; }
+
+  /**
+   * @brief Run the task in the main pool, once memory is available for it.
+   * The task is never run on the calling thread.
+   *
+   * @param is_short Whether the task is a short query, e.g., a point lookup.
+   * Short queries hardly use memory and finish quickly, so they are admitted
+   * right away, ahead of the waiting ones.
+   */
+  void SubmitTask(std::function<void()> task, bool is_short = false);
+
+  /** The number of submitted tasks that are running or about to run */
+  uint32_t NumRunning();
+
+  /** The number of submitted tasks waiting for memory */
+  uint32_t NumWaiting();
+
+ private:
+  MemoryGovernor() : num_running_(0) {}
+
+  // Whether another task may start, given the current memory usage. Must be
+  // called with the lock held.
+  bool CanAdmit() const;
+
+  // Hand the task to the pool. Must be called with the lock held.
+  void Admit(std::function<void()> task);
+
+  // Called after an admitted task ran, to admit the waiting ones
+  void TaskFinished();
+
+  // The root of all query memory trackers
+  MemoryTracker tracker_;
+
+  // Protects the members below
+  std::mutex lock_;
+
+  // The number of admitted tasks that did not finish yet
+  uint32_t num_running_;
+
+  // The tasks waiting for memory, in submission order
+  std::deque<std::function<void()>> waiting_;
+};
+
+}  // namespace threadpool
+}  // namespace peloton
@@ -21,8 +21,10 @@
 
 #include "catalog/column.h"
 #include "common/internal_types.h"
+#include "common/memory_tracker.h"
 #include "common/portal.h"
 #include "common/statement.h"
+#include "common/timer.h"
 #include "executor/plan_executor.h"
 #include "optimizer/abstract_optimizer.h"
 #include "parser/sql_statement.h"
@@ -72,10 +74,23 @@ class TrafficCop {
       const std::vector<int> &result_format, std::vector<ResultValue> &result,
       size_t thread_id = 0);
 
-  // Helper to handle txn-specifics for the plan-tree of a statement.
+  // Helper to handle txn-specifics for the plan-tree of a statement. If
+  // actual_rows is not null, the rows produced by each plan node are counted
+  // into it; like params and result, it must outlive a queued execution.
   executor::ExecutionResult ExecuteHelper(
       std::shared_ptr<planner::AbstractPlan> plan,
       const std::vector<type::Value> &params, std::vector<ResultValue> &result,
+      const std::vector<int> &result_format, size_t thread_id = 0,
+      executor::PlanActualRows *actual_rows = nullptr);
+
+  // Execute the plan of a statement once per parameter set, all in one
+  // transaction and one task of the execution pool. Stops at the first
+  // execution that fails. The results of the executions are stored in
+  // batch_results, their aggregate in p_status_.
+  ResultType ExecuteStatementBatch(
+      const std::shared_ptr<Statement> &statement,
+      std::vector<std::vector<type::Value>> &batch_params,
+      std::vector<executor::ExecutionResult> &batch_results,
       const std::vector<int> &result_format, size_t thread_id = 0);
 
   // Prepare a statement using the parse tree
@@ -139,6 +154,9 @@ class TrafficCop {
 
   bool GetQueuing() { return is_queuing_; }
 
+  // The memory used by the queries of this connection
+  MemoryTracker &GetMemoryTracker() { return connection_memory_; }
+
   executor::ExecutionResult p_status_;
 
   void SetDefaultDatabaseName(std::string default_database_name) {
@@ -178,6 +196,13 @@ class TrafficCop {
   void (*task_callback_)(void *);
   void *task_callback_arg_;
 
+  // Measures the execution latency of the current query (in ms)
+  Timer<std::ratio<1, 1000>> execution_timer_;
+
+  // Tracks the memory of the queries of this connection. Its parent is the
+  // memory governor's tracker.
+  MemoryTracker connection_memory_;
+
   // pair of txn ptr and the result so-far for that txn
   // use a stack to support nested-txns
   using TcopTxnState = std::pair<concurrency::TransactionContext *, ResultType>;
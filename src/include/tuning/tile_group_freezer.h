@@ -0,0 +1,165 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_freezer.h
+//
+// Identification: src/include/tuning/tile_group_freezer.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "common/internal_types.h"
+
+namespace peloton {
+
+namespace storage {
+class DataTable;
+class TileGroup;
+}
+
+namespace tuning {
+
+//===--------------------------------------------------------------------===//
+// Tile Group Freezer
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief      Background task that freezes cold tile groups.
+ *
+ * A tile group is cold once all of its slots are taken and every slot holds a
+ * committed version that no transaction currently owns. Freezing marks the
+ * tile group immutable (so GC never recycles its slots) and attaches a
+ * compressed, columnar copy that compiled scans evaluate predicates on.
+ *
+ * The tuple slots of the tiles whose columns are all in the compressed copy
+ * are then dropped, and decoded again when the tile is next accessed. A tile
+ * that was decoded since the last pass is left alone for one more pass.
+ *
+ * User tables are added when they are added to their database and removed
+ * before they are dropped. The freezer only visits them while it is running,
+ * i.e., with the tile_group_freezer setting on.
+ */
+class TileGroupFreezer {
+ public:
+  TileGroupFreezer(const TileGroupFreezer &) = delete;
+  TileGroupFreezer &operator=(const TileGroupFreezer &) = delete;
+  TileGroupFreezer(TileGroupFreezer &&) = delete;
+  TileGroupFreezer &operator=(TileGroupFreezer &&) = delete;
+
+  TileGroupFreezer();
+
+  ~TileGroupFreezer();
+
+  /**
+   * Singleton
+   *
+   * @return     The instance.
+   */
+  static TileGroupFreezer &GetInstance();
+
+  /**
+   * Start freezing
+   */
+  void Start();
+
+  /**
+   * Freeze loop run by the freezer thread
+   */
+  void Freeze();
+
+  /**
+   * Stop freezing
+   */
+  void Stop();
+
+  /**
+   * Freeze all cold tile groups of the table, and mark the tile groups whose
+   * versions are all visible
+   *
+   * @param      table  The table
+   * @return     The number of tile groups frozen
+   */
+  oid_t FreezeTable(storage::DataTable *table);
+
+  /**
+   * Freeze the tile group if it is cold
+   *
+   * @param      tile_group  The tile group
+   * @return     true if the tile group was frozen, false otherwise
+   */
+  bool FreezeTileGroup(storage::TileGroup *tile_group);
+
+  /**
+   * Drop the tuple slots of the tiles of a frozen tile group that are held by
+   * its compressed form, and were not accessed since the last pass
+   *
+   * @param      tile_group  The tile group
+   * @return     The number of tiles whose slots were dropped
+   */
+  oid_t DropTupleSlots(storage::TileGroup *tile_group);
+
+  /**
+   * Free the dropped tuple slots that no transaction can be reading anymore
+   */
+  void FreeDroppedTupleSlots();
+
+  /**
+   * Add table to list of tables whose tile groups must be frozen
+   *
+   * @param      table  The table
+   */
+  void AddTable(storage::DataTable *table);
+
+  /**
+   * Remove table from list of tables whose tile groups must be frozen. Waits
+   * for a freezing pass over the table to finish.
+   *
+   * @param      table  The table
+   */
+  void RemoveTable(storage::DataTable *table);
+
+  /**
+   * Clear list
+   */
+  void ClearTables();
+
+ private:
+  /**
+   * Tables whose tile groups must be frozen
+   */
+  std::vector<storage::DataTable *> tables;
+
+  std::mutex freezer_mutex;
+
+  /**
+   * Stop signal
+   */
+  std::atomic<bool> freezer_stop;
+
+  /**
+   * Freezer thread
+   */
+  std::thread freezer_thread;
+
+  /** Sleeping period (in ms) between passes over all tables */
+  oid_t sleep_duration = 1000;
+
+  /**
+   * Dropped tuple slots, with the epoch they were dropped in. Only used by
+   * the freezer thread.
+   */
+  std::vector<std::pair<eid_t, char *>> dropped_tuple_slots;
+};
+
+}  // namespace tuning
+}  // namespace peloton
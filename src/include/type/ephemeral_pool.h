@@ -14,9 +14,10 @@
 
 #include <cstdint>
 #include <cstdlib>
-#include <unordered_set>
+#include <unordered_map>
 
 #include "common/macros.h"
+#include "common/memory_tracker.h"
 #include "common/synchronization/spin_latch.h"
 #include "type/abstract_pool.h"
 
@@ -25,12 +26,14 @@ namespace type {
 
 //===----------------------------------------------------------------------===//
 //
-// A memory pool that can quickly allocate chunks of memory to clients.
+// A memory pool that can quickly allocate chunks of memory to clients. If it
+// is given a memory tracker, the pool reports every allocation and free to it.
 //
 //===----------------------------------------------------------------------===//
 class EphemeralPool : public AbstractPool {
  public:
-  EphemeralPool() = default;
+  explicit EphemeralPool(MemoryTracker *tracker = nullptr)
+      : tracker_(tracker) {}
 
   ~EphemeralPool();
 
@@ -39,8 +42,11 @@ class EphemeralPool : public AbstractPool {
   void Free(void *ptr) override;
 
  public:
-  // Location list
-  std::unordered_set<char *> locations_;
+  // The tracker the allocations are reported to, or null
+  MemoryTracker *tracker_;
+
+  // Location list, with the size of each location
+  std::unordered_map<char *, size_t> locations_;
 
   // Spin lock protecting location list
   common::synchronization::SpinLatch pool_lock_;
@@ -54,28 +60,46 @@ class EphemeralPool : public AbstractPool {
 
 inline EphemeralPool::~EphemeralPool() {
   pool_lock_.Lock();
+  size_t total_size = 0;
   for (auto location : locations_) {
-    delete[] location;
+    total_size += location.second;
+    delete[] location.first;
   }
   pool_lock_.Unlock();
+
+  if (tracker_ != nullptr) {
+    tracker_->Release(total_size);
+  }
 }
 
 inline void *EphemeralPool::Allocate(size_t size) {
   auto location = new char[size];
 
   pool_lock_.Lock();
-  locations_.insert(location);
+  locations_.emplace(location, size);
   pool_lock_.Unlock();
 
+  if (tracker_ != nullptr) {
+    tracker_->Reserve(size);
+  }
   return location;
 }
 
 inline void EphemeralPool::Free(void *ptr) {
   auto *cptr = (char *)ptr;
+  size_t size = 0;
   pool_lock_.Lock();
-  locations_.erase(cptr);
+  auto iter = locations_.find(cptr);
+  if (iter != locations_.end()) {
+    size = iter->second;
+    locations_.erase(iter);
+  }
   pool_lock_.Unlock();
   delete[] cptr;
+
+  if (tracker_ != nullptr) {
+    tracker_->Release(size);
+  }
 }
 
 }  // namespace type
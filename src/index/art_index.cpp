@@ -13,12 +13,12 @@
 #include "index/art_index.h"
 
 #include "common/container_tuple.h"
+#include "index/normalized_key.h"
 #include "index/scan_optimizer.h"
 #include "settings/settings_manager.h"
 #include "statistics/backend_stats_context.h"
 #include "storage/data_table.h"
 #include "storage/storage_manager.h"
-#include "util/portable_endian.h"
 
 namespace peloton {
 namespace index {
@@ -232,139 +232,95 @@ void ArtIndex::ScanRange(const art::Key &start, const art::Key &end,
   }
 }
 
+std::unique_ptr<IndexIterator> ArtIndex::GetIterator(
+    ScanDirectionType scan_direction, const ConjunctionScanPredicate *csp_p) {
+  // The tree can only be walked forward, and point queries are read at once
+  if (scan_direction != ScanDirectionType::FORWARD ||
+      (csp_p != nullptr && csp_p->IsPointQuery())) {
+    return Index::GetIterator(scan_direction, csp_p);
+  }
+
+  // Build boundary keys
+  art::Key start_key, end_key;
+  if (csp_p == nullptr || csp_p->IsFullIndexScan()) {
+    key_constructor_.ConstructMinMaxKey(start_key, end_key);
+  } else {
+    ConstructArtKey(*csp_p->GetLowKey(), start_key);
+    ConstructArtKey(*csp_p->GetHighKey(), end_key);
+  }
+  return std::unique_ptr<IndexIterator>(
+      new ScanIterator(*this, start_key, end_key));
+}
+
 void ArtIndex::SetLoadKeyFunc(art::Tree::LoadKeyFunction load_func, void *ctx) {
   container_.setLoadKeyFunc(load_func, ctx);
 }
 
 //===----------------------------------------------------------------------===//
 //
-// KeyConstructor
+// ScanIterator
 //
 //===----------------------------------------------------------------------===//
 
-/// Here we define a four utility functions to help with conversion of native
-/// integral types (i.e., 1-, 2-, 4-, and 8-byte integers) to their big-endian
-/// versions.
-namespace {
-
-uint8_t ToBigEndian(int8_t data) { return static_cast<uint8_t>(data); }
-
-uint16_t ToBigEndian(int16_t data) {
-  return htobe16(static_cast<uint16_t>(data));
-}
-
-uint32_t ToBigEndian(int32_t data) {
-  return htobe32(static_cast<uint32_t>(data));
+ArtIndex::ScanIterator::ScanIterator(ArtIndex &index, const art::Key &start,
+                                     const art::Key &end)
+    : index_(index), has_more_(true), buffer_pos_(0) {
+  start_key_.setFrom(start);
+  end_key_.setFrom(end);
 }
 
-uint64_t ToBigEndian(int64_t data) {
-  return htobe64(static_cast<uint64_t>(data));
-}
+size_t ArtIndex::ScanIterator::Next(std::vector<ItemPointer *> &result,
+                                    size_t max_count) {
+  size_t count = 0;
+  while (count < max_count) {
+    if (buffer_pos_ == buffer_.size()) {
+      if (!has_more_) break;
+
+      // Read about as many values as still requested. A leaf may hold more
+      // values than that, so some may be left in the buffer for later.
+      // lookupRange() does not clear the results when the range is empty.
+      buffer_.clear();
+      buffer_pos_ = 0;
+      art::Key next_start_key;
+      auto thread_info = index_.container_.getThreadInfo();
+      has_more_ = index_.container_.lookupRange(
+          start_key_, end_key_, next_start_key, buffer_,
+          static_cast<uint32_t>(max_count - count), thread_info);
+      start_key_.setFrom(next_start_key);
+      continue;
+    }
 
-}  // namespace
+    result.push_back(reinterpret_cast<ItemPointer *>(buffer_[buffer_pos_++]));
+    count++;
+  }
 
-template <typename NativeType>
-NativeType ArtIndex::KeyConstructor::FlipSign(NativeType val) {
-  // This sets 1 on the MSB of the corresponding type
-  auto mask = static_cast<NativeType>(1) << (sizeof(NativeType) * 8ul - 1);
-  return val ^ mask;
-}
+  // Update stats
+  if (static_cast<StatsType>(settings::SettingsManager::GetInt(
+          settings::SettingId::stats_mode)) != StatsType::INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
+        count, index_.GetMetadata());
+  }
 
-template <typename NativeType>
-void ArtIndex::KeyConstructor::WriteValue(uint8_t *data, NativeType val) {
-  auto *casted_data = reinterpret_cast<NativeType *>(data);
-  *casted_data = ToBigEndian(FlipSign(val));
+  return count;
 }
 
-// This is specialized for ASCII strings ...
-void ArtIndex::KeyConstructor::WriteAsciiString(uint8_t *data, const char *val,
-                                                uint32_t len) {
-  // Write out the main payload, then tack on the NULL byte terminator
-  PELOTON_MEMCPY(data, val, len);
-  data[len] = '\0';
-}
+//===----------------------------------------------------------------------===//
+//
+// KeyConstructor
+//
+//===----------------------------------------------------------------------===//
 
 // Constructing an ART tree key from a Peloton input key involves converting it
-// to a binary-comparable format. This method handles the conversion process.
-//   1. For fixed-width integral types, we need to flip the sign and convert to
-//      big-endian format. If the host system is big-endian, the conversion is
-//      elided entirely.
-//   2. For variable length strings, we write out the string and append a NULL
-//      byte indicating the end of the string. The assumption is that NULL
-//      cannot appear in normal strings. True for ASCII, not so for UTF-8.
-//      TODO(pmenon): For UTF-8 strings, we need a third-party library to
-//      generate sort-able text from UTF-8 string.
-//   3. Floats/doubles are more complicated, not done here.
-//   4. NULL is handled using special values.
+// to a binary-comparable format, which KeyNormalizer does for every index.
+// Column types that cannot be normalized (e.g., arrays) are rejected.
 void ArtIndex::KeyConstructor::ConstructKey(const AbstractTuple &input_key,
                                             art::Key &tree_key) const {
-  // First calculate length of this key
-  uint32_t key_len = 0;
-  for (uint32_t i = 0; i < key_schema_.GetColumnCount(); i++) {
-    auto col_info = key_schema_.GetColumn(i);
-    if (col_info.IsInlined()) {
-      key_len += col_info.GetFixedLength();
-    } else {
-      key_len += input_key.GetValue(i).GetLength();
-      if (col_info.GetType() == type::TypeId::VARCHAR) {
-        // Need to append NULL character
-        key_len++;
-      }
-    }
-  }
+  std::string normalized_key;
+  KeyNormalizer::Normalize(input_key, key_schema_, normalized_key);
 
-  // Set the tree key's length and grab a pointer the data area
-  tree_key.setKeyLen(key_len);
-  uint8_t *data = &tree_key[0];
-
-  uint32_t offset = 0;
-  for (uint32_t i = 0; i < key_schema_.GetColumnCount(); i++) {
-    auto column = key_schema_.GetColumn(i);
-    switch (column.GetType()) {
-      case type::TypeId::BOOLEAN:
-      case type::TypeId::TINYINT: {
-        auto raw = type::ValuePeeker::PeekTinyInt(input_key.GetValue(i));
-        WriteValue<int8_t>(data + offset, raw);
-        offset += sizeof(int8_t);
-        break;
-      }
-      case type::TypeId::SMALLINT: {
-        auto raw = type::ValuePeeker::PeekSmallInt(input_key.GetValue(i));
-        WriteValue<int16_t>(data + offset, raw);
-        offset += sizeof(int16_t);
-        break;
-      }
-      case type::TypeId::DATE:
-      case type::TypeId::INTEGER: {
-        auto raw = type::ValuePeeker::PeekInteger(input_key.GetValue(i));
-        WriteValue<int32_t>(data + offset, raw);
-        offset += sizeof(int32_t);
-        break;
-      }
-      case type::TypeId::TIMESTAMP:
-      case type::TypeId::BIGINT: {
-        auto raw = type::ValuePeeker::PeekBigInt(input_key.GetValue(i));
-        WriteValue<int64_t>(data + offset, raw);
-        offset += sizeof(int64_t);
-        break;
-      }
-      case type::TypeId::VARCHAR: {
-        auto varchar_val = input_key.GetValue(i);
-        auto raw = type::ValuePeeker::PeekVarchar(varchar_val);
-        auto raw_len = varchar_val.GetLength();
-        WriteAsciiString(data + offset, raw, raw_len);
-        offset += raw_len;
-        break;
-      }
-      default: {
-        auto error =
-            StringUtil::Format("Column type '%s' not supported in ART index",
-                               TypeIdToString(column.GetType()).c_str());
-        LOG_ERROR("%s", error.c_str());
-        throw IndexException{error};
-      }
-    }
-  }
+  // Set the tree key's length and copy the normalized key into it
+  tree_key.setKeyLen(normalized_key.size());
+  PELOTON_MEMCPY(&tree_key[0], normalized_key.data(), normalized_key.size());
 }
 
 void ArtIndex::KeyConstructor::ConstructMinMaxKey(art::Key &min_key,
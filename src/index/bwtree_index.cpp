@@ -291,6 +291,114 @@ void BWTREE_INDEX_TYPE::ScanKey(const storage::Tuple *key,
   return;
 }
 
+/*
+ * GetIterator() - Starts a scan whose values are found as they are pulled
+ *
+ * Point queries are scanned as the range [key, key], and full index scans
+ * (including a null scan predicate) have no bounds
+ */
+BWTREE_TEMPLATE_ARGUMENTS
+std::unique_ptr<IndexIterator> BWTREE_INDEX_TYPE::GetIterator(
+    ScanDirectionType scan_direction, const ConjunctionScanPredicate *csp_p) {
+  if (scan_direction == ScanDirectionType::INVALID) {
+    throw Exception("Invalid scan direction \n");
+  }
+
+  if (csp_p == nullptr || csp_p->IsFullIndexScan() == true) {
+    return std::unique_ptr<IndexIterator>(
+        new ScanIterator(this, scan_direction, nullptr, nullptr));
+  }
+
+  KeyType index_low_key;
+  KeyType index_high_key;
+  if (csp_p->IsPointQuery() == true) {
+    index_low_key.SetFromKey(csp_p->GetPointQueryKey());
+    index_high_key = index_low_key;
+  } else {
+    index_low_key.SetFromKey(csp_p->GetLowKey());
+    index_high_key.SetFromKey(csp_p->GetHighKey());
+  }
+  return std::unique_ptr<IndexIterator>(new ScanIterator(
+      this, scan_direction, &index_low_key, &index_high_key));
+}
+
+BWTREE_TEMPLATE_ARGUMENTS
+BWTREE_INDEX_TYPE::ScanIterator::ScanIterator(BWTreeIndex *index,
+                                              ScanDirectionType scan_direction,
+                                              const KeyType *low_key_p,
+                                              const KeyType *high_key_p)
+    : index_{index},
+      scan_direction_{scan_direction},
+      has_low_key_{low_key_p != nullptr},
+      has_high_key_{high_key_p != nullptr},
+      done_{false} {
+  if (has_low_key_) low_key_ = *low_key_p;
+  if (has_high_key_) high_key_ = *high_key_p;
+
+  MapType &container = index_->container;
+  if (scan_direction_ == ScanDirectionType::FORWARD) {
+    itr_ = has_low_key_ ? container.Begin(low_key_) : container.Begin();
+    return;
+  }
+
+  // The tree only locates the first key >= a given key, so a backward scan
+  // starts after the last key <= the high key and steps back once. Without a
+  // high key this walks to the end of the index, but does not keep the
+  // values along the way
+  itr_ = has_high_key_ ? container.Begin(high_key_) : container.Begin();
+  while (itr_.IsEnd() == false &&
+         (has_high_key_ == false ||
+          container.KeyCmpLessEqual(itr_->first, high_key_))) {
+    ++itr_;
+  }
+  --itr_;
+}
+
+/*
+ * Next() - Appends the values of the next keys in the range
+ *
+ * The range is checked one key at a time, so no key past the last value
+ * returned is read, except for the one that ends the scan
+ */
+BWTREE_TEMPLATE_ARGUMENTS
+size_t BWTREE_INDEX_TYPE::ScanIterator::Next(std::vector<ValueType> &result,
+                                             size_t max_count) {
+  MapType &container = index_->container;
+  size_t count = 0;
+  if (scan_direction_ == ScanDirectionType::FORWARD) {
+    while (done_ == false && count < max_count) {
+      if (itr_.IsEnd() == true ||
+          (has_high_key_ &&
+           container.KeyCmpLess(high_key_, itr_->first) == true)) {
+        done_ = true;
+        break;
+      }
+      result.push_back(itr_->second);
+      count++;
+      ++itr_;
+    }
+  } else {
+    while (done_ == false && count < max_count) {
+      if (itr_.IsREnd() == true ||
+          (has_low_key_ &&
+           container.KeyCmpLess(itr_->first, low_key_) == true)) {
+        done_ = true;
+        break;
+      }
+      result.push_back(itr_->second);
+      count++;
+      --itr_;
+    }
+  }
+
+  if (static_cast<StatsType>(settings::SettingsManager::GetInt(settings::SettingId::stats_mode)) != StatsType::INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
+        count, index_->GetMetadata());
+  }
+
+  return count;
+}
+
 BWTREE_TEMPLATE_ARGUMENTS
 std::string BWTREE_INDEX_TYPE::GetTypeName() const { return "BWTree"; }
 
@@ -335,6 +443,33 @@ template class BWTreeIndex<GenericKey<256>, ItemPointer *,
                            GenericEqualityChecker<256>, GenericHasher<256>,
                            ItemPointerComparator, ItemPointerHashFunc>;
 
+// Normalized key
+template class BWTreeIndex<NormalizedKey<8>, ItemPointer *,
+                           NormalizedKeyComparator<8>,
+                           NormalizedKeyEqualityChecker<8>,
+                           NormalizedKeyHasher<8>, ItemPointerComparator,
+                           ItemPointerHashFunc>;
+template class BWTreeIndex<NormalizedKey<16>, ItemPointer *,
+                           NormalizedKeyComparator<16>,
+                           NormalizedKeyEqualityChecker<16>,
+                           NormalizedKeyHasher<16>, ItemPointerComparator,
+                           ItemPointerHashFunc>;
+template class BWTreeIndex<NormalizedKey<32>, ItemPointer *,
+                           NormalizedKeyComparator<32>,
+                           NormalizedKeyEqualityChecker<32>,
+                           NormalizedKeyHasher<32>, ItemPointerComparator,
+                           ItemPointerHashFunc>;
+template class BWTreeIndex<NormalizedKey<64>, ItemPointer *,
+                           NormalizedKeyComparator<64>,
+                           NormalizedKeyEqualityChecker<64>,
+                           NormalizedKeyHasher<64>, ItemPointerComparator,
+                           ItemPointerHashFunc>;
+template class BWTreeIndex<VarlenNormalizedKey, ItemPointer *,
+                           VarlenNormalizedKeyComparator,
+                           VarlenNormalizedKeyEqualityChecker,
+                           VarlenNormalizedKeyHasher, ItemPointerComparator,
+                           ItemPointerHashFunc>;
+
 // Tuple key
 template class BWTreeIndex<TupleKey, ItemPointer *, TupleKeyComparator,
                            TupleKeyEqualityChecker, TupleKeyHasher,
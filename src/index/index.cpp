@@ -11,6 +11,7 @@
 
 #include "index/index.h"
 
+#include <algorithm>
 #include <sstream>
 
 #include "catalog/manager.h"
@@ -187,6 +188,45 @@ void Index::ScanTest(const std::vector<type::Value> &value_list,
   return;
 }
 
+namespace {
+
+// Iterates over the values of a scan that was already performed
+class MaterializedIndexIterator : public IndexIterator {
+ public:
+  explicit MaterializedIndexIterator(std::vector<ItemPointer *> &&values)
+      : values_(std::move(values)), pos_(0) {}
+
+  size_t Next(std::vector<ItemPointer *> &result, size_t max_count) override {
+    size_t count = std::min(max_count, values_.size() - pos_);
+    result.insert(result.end(), values_.begin() + pos_,
+                  values_.begin() + pos_ + count);
+    pos_ += count;
+    return count;
+  }
+
+ private:
+  std::vector<ItemPointer *> values_;
+  size_t pos_;
+};
+
+}  // namespace
+
+std::unique_ptr<IndexIterator> Index::GetIterator(
+    ScanDirectionType scan_direction, const ConjunctionScanPredicate *csp_p) {
+  std::vector<ItemPointer *> values;
+  if (csp_p == nullptr) {
+    ScanAllKeys(values);
+  } else {
+    Scan({}, {}, {}, scan_direction, values, csp_p);
+  }
+  // Scan() returns the values in key order whatever the direction
+  if (scan_direction == ScanDirectionType::BACKWARD) {
+    std::reverse(values.begin(), values.end());
+  }
+  return std::unique_ptr<IndexIterator>(
+      new MaterializedIndexIterator(std::move(values)));
+}
+
 // Check whether a given index key satisfies a predicate. The predicate has the
 // same specification as those in Scan()
 bool Index::Compare(const AbstractTuple &index_key,
@@ -63,6 +63,8 @@ Index *IndexFactory::GetIndex(IndexMetadata *metadata) {
   if (index_type == IndexType::BWTREE) {
     if (ints_only) {
       index = IndexFactory::GetBwTreeIntsKeyIndex(metadata);
+    } else if (KeyNormalizer::IsSupported(*metadata->key_schema)) {
+      index = IndexFactory::GetBwTreeNormalizedKeyIndex(metadata);
     } else {
       index = IndexFactory::GetBwTreeGenericKeyIndex(metadata);
     }
@@ -153,6 +155,74 @@ Index *IndexFactory::GetBwTreeIntsKeyIndex(IndexMetadata *metadata) {
   return index;
 }
 
+Index *IndexFactory::GetBwTreeNormalizedKeyIndex(IndexMetadata *metadata) {
+  // Our new Index!
+  Index *index = nullptr;
+
+  // The size of the normalized key in bytes, if all keys have the same size
+  const auto key_size = KeyNormalizer::GetFixedLength(*metadata->key_schema);
+
+// Debug Output
+#ifdef LOG_TRACE_ENABLED
+  std::string comparatorType;
+#endif
+
+  if (key_size != 0 && key_size <= 8) {
+#ifdef LOG_TRACE_ENABLED
+    comparatorType = "NormalizedKey<8>";
+#endif
+    index = new BWTreeIndex<NormalizedKey<8>, ItemPointer *,
+                            NormalizedKeyComparator<8>,
+                            NormalizedKeyEqualityChecker<8>,
+                            NormalizedKeyHasher<8>, ItemPointerComparator,
+                            ItemPointerHashFunc>(metadata);
+  } else if (key_size != 0 && key_size <= 16) {
+#ifdef LOG_TRACE_ENABLED
+    comparatorType = "NormalizedKey<16>";
+#endif
+    index = new BWTreeIndex<NormalizedKey<16>, ItemPointer *,
+                            NormalizedKeyComparator<16>,
+                            NormalizedKeyEqualityChecker<16>,
+                            NormalizedKeyHasher<16>, ItemPointerComparator,
+                            ItemPointerHashFunc>(metadata);
+  } else if (key_size != 0 && key_size <= 32) {
+#ifdef LOG_TRACE_ENABLED
+    comparatorType = "NormalizedKey<32>";
+#endif
+    index = new BWTreeIndex<NormalizedKey<32>, ItemPointer *,
+                            NormalizedKeyComparator<32>,
+                            NormalizedKeyEqualityChecker<32>,
+                            NormalizedKeyHasher<32>, ItemPointerComparator,
+                            ItemPointerHashFunc>(metadata);
+  } else if (key_size != 0 && key_size <= 64) {
+#ifdef LOG_TRACE_ENABLED
+    comparatorType = "NormalizedKey<64>";
+#endif
+    index = new BWTreeIndex<NormalizedKey<64>, ItemPointer *,
+                            NormalizedKeyComparator<64>,
+                            NormalizedKeyEqualityChecker<64>,
+                            NormalizedKeyHasher<64>, ItemPointerComparator,
+                            ItemPointerHashFunc>(metadata);
+  } else {
+    // Keys with strings, or too large to pad, only take as many bytes as
+    // their normalized form
+#ifdef LOG_TRACE_ENABLED
+    comparatorType = "VarlenNormalizedKey";
+#endif
+    index = new BWTreeIndex<VarlenNormalizedKey, ItemPointer *,
+                            VarlenNormalizedKeyComparator,
+                            VarlenNormalizedKeyEqualityChecker,
+                            VarlenNormalizedKeyHasher, ItemPointerComparator,
+                            ItemPointerHashFunc>(metadata);
+  }
+
+#ifdef LOG_TRACE_ENABLED
+  LOG_TRACE("%s", IndexFactory::GetInfo(metadata, comparatorType).c_str());
+#endif
+
+  return index;
+}
+
 Index *IndexFactory::GetBwTreeGenericKeyIndex(IndexMetadata *metadata) {
   // Our new Index!
   Index *index = nullptr;
@@ -0,0 +1,207 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// normalized_key.cpp
+//
+// Identification: src/index/normalized_key.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "index/normalized_key.h"
+
+#include <iomanip>
+#include <sstream>
+
+#include "catalog/schema.h"
+#include "common/abstract_tuple.h"
+#include "common/exception.h"
+#include "common/logger.h"
+#include "type/value_peeker.h"
+#include "util/portable_endian.h"
+#include "util/string_util.h"
+
+namespace peloton {
+namespace index {
+
+namespace {
+
+// Markers of the encoding of a string column
+const uint8_t kStringMarker = 0x01;
+const uint8_t kNullStringMarker = 0x02;
+
+// Escape of a 0x00 byte within a string, and the string terminator
+const uint8_t kEscapedZero[2] = {0x00, 0xFF};
+const uint8_t kStringTerminator[2] = {0x00, 0x00};
+
+// The largest fixed-width column
+const size_t kMaxFixedWidth = sizeof(uint64_t);
+
+uint8_t ToBigEndian(uint8_t data) { return data; }
+uint16_t ToBigEndian(uint16_t data) { return htobe16(data); }
+uint32_t ToBigEndian(uint32_t data) { return htobe32(data); }
+uint64_t ToBigEndian(uint64_t data) { return htobe64(data); }
+
+// Write the unsigned integer big-endian, so that memcmp() orders it
+template <typename UIntType>
+size_t WriteUnsigned(uint8_t *data, UIntType val) {
+  auto big_endian = ToBigEndian(val);
+  PELOTON_MEMCPY(data, &big_endian, sizeof(UIntType));
+  return sizeof(UIntType);
+}
+
+// Flipping the sign bit orders signed integers like unsigned ones
+template <typename UIntType, typename IntType>
+size_t WriteSigned(uint8_t *data, IntType val) {
+  auto mask = static_cast<UIntType>(1) << (sizeof(UIntType) * 8ul - 1);
+  return WriteUnsigned<UIntType>(data, static_cast<UIntType>(val) ^ mask);
+}
+
+// Positive doubles order like their bits once the sign bit is set, and
+// negative ones in reverse, so all of their bits are flipped
+size_t WriteDouble(uint8_t *data, double val) {
+  // -0.0 is equal to 0.0
+  if (val == 0) val = 0;
+  uint64_t bits;
+  PELOTON_MEMCPY(&bits, &val, sizeof(bits));
+  const uint64_t sign = static_cast<uint64_t>(1) << 63;
+  bits = (bits & sign) ? ~bits : (bits | sign);
+  return WriteUnsigned<uint64_t>(data, bits);
+}
+
+bool IsFixedWidth(type::TypeId type_id) {
+  switch (type_id) {
+    case type::TypeId::BOOLEAN:
+    case type::TypeId::TINYINT:
+    case type::TypeId::SMALLINT:
+    case type::TypeId::INTEGER:
+    case type::TypeId::DATE:
+    case type::TypeId::BIGINT:
+    case type::TypeId::TIMESTAMP:
+    case type::TypeId::DECIMAL:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool IsString(type::TypeId type_id) {
+  return type_id == type::TypeId::VARCHAR ||
+         type_id == type::TypeId::VARBINARY;
+}
+
+void ThrowUnsupported(type::TypeId type_id) {
+  auto error =
+      StringUtil::Format("Column type '%s' not supported in normalized keys",
+                         TypeIdToString(type_id).c_str());
+  LOG_ERROR("%s", error.c_str());
+  throw IndexException{error};
+}
+
+// Write the normalized form of a fixed-width value, returning its length
+size_t WriteFixedWidth(uint8_t *data, type::TypeId type_id,
+                       const type::Value &val) {
+  switch (type_id) {
+    case type::TypeId::BOOLEAN:
+    case type::TypeId::TINYINT:
+      // Booleans are stored as a byte, with the same NULL as TINYINT
+      return WriteSigned<uint8_t>(data, type::ValuePeeker::PeekTinyInt(val));
+    case type::TypeId::SMALLINT:
+      return WriteSigned<uint16_t>(data, type::ValuePeeker::PeekSmallInt(val));
+    case type::TypeId::INTEGER:
+      return WriteSigned<uint32_t>(data, type::ValuePeeker::PeekInteger(val));
+    case type::TypeId::DATE:
+      return WriteSigned<uint32_t>(data, type::ValuePeeker::PeekDate(val));
+    case type::TypeId::BIGINT:
+      return WriteSigned<uint64_t>(data, type::ValuePeeker::PeekBigInt(val));
+    case type::TypeId::TIMESTAMP:
+      return WriteUnsigned<uint64_t>(data,
+                                     type::ValuePeeker::PeekTimestamp(val));
+    case type::TypeId::DECIMAL:
+      return WriteDouble(data, type::ValuePeeker::PeekDouble(val));
+    default:
+      ThrowUnsupported(type_id);
+  }
+  return 0;
+}
+
+}  // namespace
+
+bool KeyNormalizer::IsSupported(const catalog::Schema &key_schema) {
+  for (const auto &column : key_schema.GetColumns()) {
+    auto type_id = column.GetType();
+    if (!IsFixedWidth(type_id) && !IsString(type_id)) return false;
+  }
+  return true;
+}
+
+size_t KeyNormalizer::GetFixedLength(const catalog::Schema &key_schema) {
+  size_t len = 0;
+  for (const auto &column : key_schema.GetColumns()) {
+    auto type_id = column.GetType();
+    if (!IsFixedWidth(type_id)) return 0;
+    len += type::Type::GetTypeSize(type_id);
+  }
+  return len;
+}
+
+size_t KeyNormalizer::Normalize(const AbstractTuple &key,
+                                const catalog::Schema &key_schema,
+                                uint8_t *data) {
+  size_t offset = 0;
+  for (oid_t i = 0; i < key_schema.GetColumnCount(); i++) {
+    auto type_id = key_schema.GetType(i);
+    offset += WriteFixedWidth(data + offset, type_id, key.GetValue(i));
+  }
+  return offset;
+}
+
+void KeyNormalizer::Normalize(const AbstractTuple &key,
+                              const catalog::Schema &key_schema,
+                              std::string &data) {
+  for (oid_t i = 0; i < key_schema.GetColumnCount(); i++) {
+    auto type_id = key_schema.GetType(i);
+    auto val = key.GetValue(i);
+    if (!IsString(type_id)) {
+      uint8_t buf[kMaxFixedWidth];
+      size_t len = WriteFixedWidth(buf, type_id, val);
+      data.append(reinterpret_cast<const char *>(buf), len);
+      continue;
+    }
+
+    if (val.IsNull()) {
+      data.push_back(static_cast<char>(kNullStringMarker));
+      continue;
+    }
+    data.push_back(static_cast<char>(kStringMarker));
+    const char *str = val.GetData();
+    const char *end = str + val.GetLength();
+    while (str < end) {
+      auto *zero = static_cast<const char *>(memchr(str, 0, end - str));
+      if (zero == nullptr) {
+        data.append(str, end - str);
+        break;
+      }
+      data.append(str, zero - str);
+      data.append(reinterpret_cast<const char *>(kEscapedZero),
+                  sizeof(kEscapedZero));
+      str = zero + 1;
+    }
+    data.append(reinterpret_cast<const char *>(kStringTerminator),
+                sizeof(kStringTerminator));
+  }
+}
+
+std::string KeyNormalizer::GetInfo(const uint8_t *data, size_t len) {
+  std::ostringstream os;
+  os << std::hex << std::setfill('0');
+  for (size_t i = 0; i < len; i++) {
+    os << std::setw(2) << static_cast<uint32_t>(data[i]);
+  }
+  return os.str();
+}
+
+}  // namespace index
+}  // namespace peloton
@@ -11,9 +11,14 @@
 //===----------------------------------------------------------------------===//
 
 #include "network/connection_dispatcher_task.h"
+#include "settings/settings_manager.h"
 
 #define MASTER_THREAD_ID (-1)
 
+// How many more connections a handler may have than the least loaded one
+// before new connections are moved away from it
+#define CONNECTION_REBALANCE_THRESHOLD 4
+
 namespace peloton {
 namespace network {
 
@@ -23,6 +28,17 @@ ConnectionDispatcherTask::ConnectionDispatcherTask(int num_handlers,
   RegisterEvent(
       listen_fd, EV_READ | EV_PERSIST,
       METHOD_AS_CALLBACK(ConnectionDispatcherTask, DispatchConnection), this);
+  StartHandlers(num_handlers, std::vector<int>());
+}
+
+ConnectionDispatcherTask::ConnectionDispatcherTask(
+    const std::vector<int> &handler_listen_fds)
+    : NotifiableTask(MASTER_THREAD_ID), next_handler_(0) {
+  StartHandlers(handler_listen_fds.size(), handler_listen_fds);
+}
+
+void ConnectionDispatcherTask::StartHandlers(
+    int num_handlers, const std::vector<int> &handler_listen_fds) {
   RegisterSignalEvent(SIGHUP, METHOD_AS_CALLBACK(NotifiableTask, ExitLoop),
                       this);
 
@@ -36,11 +52,17 @@ ConnectionDispatcherTask::ConnectionDispatcherTask(int num_handlers,
     }
   }
 
-  // create worker threads.
+  // create worker threads. They only start once all of them exist, since
+  // they may look at each other to rebalance connections.
   for (int task_id = 0; task_id < num_handlers; task_id++) {
-    auto handler = std::make_shared<ConnectionHandlerTask>(task_id);
+    auto handler = std::make_shared<ConnectionHandlerTask>(task_id, this);
+    if (!handler_listen_fds.empty())
+      handler->Listen(handler_listen_fds[task_id]);
     handlers_.push_back(handler);
-    thread_pool.SubmitDedicatedTask([=] { handler->EventLoop(); });
+  }
+  for (auto &handler : handlers_) {
+    std::shared_ptr<ConnectionHandlerTask> task = handler;
+    thread_pool.SubmitDedicatedTask([=] { task->EventLoop(); });
   }
 }
 
@@ -59,12 +81,35 @@ void ConnectionDispatcherTask::DispatchConnection(int fd, short) {
   // update next threadID
   next_handler_ = (next_handler_ + 1) % handlers_.size();
 
-  std::shared_ptr<ConnectionHandlerTask> handler = handlers_[handler_id];
-  LOG_DEBUG("Dispatching connection to worker %d", handler_id);
+  auto handler = RebalanceConnection(handlers_[handler_id].get());
+  LOG_DEBUG("Dispatching connection to worker %d", handler->Id());
 
   handler->Notify(new_conn_fd);
 }
 
+ConnectionHandlerTask *ConnectionDispatcherTask::RebalanceConnection(
+    ConnectionHandlerTask *handler) {
+  if (!settings::SettingsManager::GetBool(
+          settings::SettingId::rebalance_connections))
+    return handler;
+
+  ConnectionHandlerTask *least_loaded = handler;
+  int least_connections = handler->GetNumConnections();
+  for (auto &other : handlers_) {
+    int num_connections = other->GetNumConnections();
+    if (num_connections < least_connections) {
+      least_loaded = other.get();
+      least_connections = num_connections;
+    }
+  }
+  // Moving a connection costs a trip through the notify pipe, so tolerate
+  // small differences
+  if (handler->GetNumConnections() - least_connections <=
+      CONNECTION_REBALANCE_THRESHOLD)
+    return handler;
+  return least_loaded;
+}
+
 void ConnectionDispatcherTask::ExitLoop() {
   NotifiableTask::ExitLoop();
   for (auto &handler : handlers_) handler->ExitLoop();
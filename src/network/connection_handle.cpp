@@ -169,7 +169,8 @@ void ConnectionHandle::StateMachine::Accept(Transition action,
 
 ConnectionHandle::ConnectionHandle(int sock_fd, ConnectionHandlerTask *handler)
     : conn_handler_(handler),
-      io_wrapper_(NetworkIoWrapperFactory::GetInstance().NewNetworkIoWrapper(sock_fd)) {}
+      io_wrapper_(NetworkIoWrapperFactory::GetInstance().NewNetworkIoWrapper(
+          sock_fd, handler)) {}
 
 Transition ConnectionHandle::TryWrite() {
   for (; next_response_ < protocol_handler_->responses_.size();
@@ -180,7 +181,12 @@ Transition ConnectionHandle::TryWrite() {
   }
   protocol_handler_->responses_.clear();
   next_response_ = 0;
-  if (protocol_handler_->GetFlushFlag()) return io_wrapper_->FlushWriteBuffer();
+  // Responses of the extended protocol are buffered until the SYNC, so only
+  // flush when asked to and reset the flag for the next batch of messages
+  if (protocol_handler_->GetFlushFlag()) {
+    auto result = io_wrapper_->ScheduleFlushWriteBuffer();
+    if (result != Transition::PROCEED) return result;
+  }
   protocol_handler_->SetFlushFlag(false);
   return Transition::PROCEED;
 }
@@ -222,11 +228,19 @@ Transition ConnectionHandle::GetResult() {
 }
 
 Transition ConnectionHandle::TrySslHandshake() {
+  // The client sends nothing until it has the reply to its SSL request, so
+  // nothing is lost by stopping here. What it sends afterwards is for SSL.
+  io_wrapper_->StopReceiving();
   // Flush out all the response first
   if (HasResponse()) {
     auto write_ret = TryWrite();
     if (write_ret != Transition::PROCEED) return write_ret;
   }
+  // The handshake replaces the wrapper, so a scheduled flush can't wait
+  if (io_wrapper_->wbuf_->HasMore()) {
+    auto write_ret = io_wrapper_->FlushWriteBuffer();
+    if (write_ret != Transition::PROCEED) return write_ret;
+  }
   return NetworkIoWrapperFactory::GetInstance().PerformSslHandshake(
       io_wrapper_);
 }
@@ -242,6 +256,7 @@ Transition ConnectionHandle::TryCloseConnection() {
   // connection handle and we will need to destruct and exit.
   conn_handler_->UnregisterEvent(network_event_);
   conn_handler_->UnregisterEvent(workpool_event_);
+  conn_handler_->ConnectionClosed();
   // This object is essentially managed by libevent (which unfortunately does
   // not accept shared_ptrs.) and thus as we shut down we need to manually
   // deallocate this object.
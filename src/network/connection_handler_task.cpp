@@ -11,14 +11,32 @@
 //===----------------------------------------------------------------------===//
 
 #include "network/connection_handler_task.h"
+#include <algorithm>
+#include "network/connection_dispatcher_task.h"
 #include "network/connection_handle.h"
 #include "network/network_io_wrapper_factory.h"
+#include "settings/settings_manager.h"
 
 namespace peloton {
 namespace network {
 
-ConnectionHandlerTask::ConnectionHandlerTask(const int task_id)
-    : NotifiableTask(task_id) {
+namespace {
+
+// The kind of request an io_uring completion belongs to is kept in the top
+// bits of its user data
+const uint64_t kRequestKindMask = 3ULL << 62;
+const uint64_t kSendRequest = 1ULL << 62;
+const uint64_t kReceiveRequest = 2ULL << 62;
+const uint64_t kCancelRequest = 3ULL << 62;
+
+// The bits of the user data of a send left for its round
+const uint32_t kSendRoundMask = (1U << 30) - 1;
+
+}  // namespace
+
+ConnectionHandlerTask::ConnectionHandlerTask(
+    const int task_id, ConnectionDispatcherTask *dispatcher)
+    : NotifiableTask(task_id), dispatcher_(dispatcher), num_connections_(0) {
   int fds[2];
   if (pipe(fds)) {
     LOG_ERROR("Can't create notify pipe to accept connections");
@@ -28,9 +46,32 @@ ConnectionHandlerTask::ConnectionHandlerTask(const int task_id)
   RegisterEvent(fds[0], EV_READ | EV_PERSIST,
                 METHOD_AS_CALLBACK(ConnectionHandlerTask, HandleDispatch),
                 this);
+
+  if (settings::SettingsManager::GetBool(settings::SettingId::io_uring)) {
+    io_uring_ = IoUring::Create(IO_URING_ENTRIES);
+    if (io_uring_ == nullptr) {
+      LOG_WARN("Falling back to writing to the sockets directly");
+    } else {
+      flush_event_ = RegisterManualEvent(
+          METHOD_AS_CALLBACK(ConnectionHandlerTask, FlushWrites), this);
+      if (io_uring_->SetUpReceiveBuffers(IO_URING_RECEIVE_BUFFERS,
+                                         IO_URING_RECEIVE_BUFFER_SIZE)) {
+        // The ring is readable once it has completions
+        receive_through_io_uring_ = true;
+        RegisterEvent(
+            io_uring_->GetFd(), EV_READ | EV_PERSIST,
+            METHOD_AS_CALLBACK(ConnectionHandlerTask, HandleCompletions), this);
+      } else {
+        LOG_WARN("Falling back to reading from the sockets directly");
+      }
+    }
+  }
 }
 
 void ConnectionHandlerTask::Notify(int conn_fd) {
+  // Counted right away, so that a storm of connections is balanced before the
+  // handler gets to them
+  num_connections_++;
   int buf[1];
   buf[0] = conn_fd;
   if (write(new_conn_send_fd_, buf, sizeof(int)) != sizeof(int)) {
@@ -53,13 +94,205 @@ void ConnectionHandlerTask::HandleDispatch(int new_conn_recv_fd, short) {
     bytes_read += (size_t)result;
   }
 
+  HandleConnection(*reinterpret_cast<int *>(client_fd));
+}
+
+void ConnectionHandlerTask::Listen(int listen_fd) {
+  RegisterEvent(listen_fd, EV_READ | EV_PERSIST,
+                METHOD_AS_CALLBACK(ConnectionHandlerTask, HandleAccept), this);
+}
+
+void ConnectionHandlerTask::HandleAccept(int listen_fd, short) {
+  // The listening socket is non-blocking and level-triggered, so take what is
+  // there and leave the rest for the next round of the event loop
+  for (int i = 0; i < ACCEPT_BATCH_SIZE; i++) {
+    struct sockaddr_storage addr;
+    socklen_t addrlen = sizeof(addr);
+    int conn_fd = accept(listen_fd, (struct sockaddr *)&addr, &addrlen);
+    if (conn_fd == -1) {
+      if (errno == EINTR) continue;
+      if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        LOG_ERROR("Failed to accept: %s", strerror(errno));
+      }
+      return;
+    }
+
+    auto handler =
+        dispatcher_ == nullptr ? this : dispatcher_->RebalanceConnection(this);
+    if (handler != this) {
+      LOG_DEBUG("Handing connection over to worker %d", handler->Id());
+      handler->Notify(conn_fd);
+      continue;
+    }
+    num_connections_++;
+    HandleConnection(conn_fd);
+  }
+}
+
+void ConnectionHandlerTask::HandleConnection(int conn_fd) {
   // Smart pointers are not used here because libevent does not take smart
   // pointers. During the life time of this object, the pointer to it will be
   // maintained by libevent rather than by our own code. The object will have to
   // be cleaned up by one of its methods (i.e. we call a method with "delete
   // this" and have the object commit suicide from libevent. )
-  (new ConnectionHandle(*reinterpret_cast<int *>(client_fd), this))
-      ->RegisterToReceiveEvents();
+  (new ConnectionHandle(conn_fd, this))->RegisterToReceiveEvents();
+}
+
+void ConnectionHandlerTask::ScheduleFlush(IoUringSocketIoWrapper *io_wrapper) {
+  if (pending_flushes_.empty()) event_active(flush_event_, EV_WRITE, 0);
+  pending_flushes_.push_back(io_wrapper);
+}
+
+void ConnectionHandlerTask::CancelFlush(IoUringSocketIoWrapper *io_wrapper) {
+  pending_flushes_.erase(std::remove(pending_flushes_.begin(),
+                                     pending_flushes_.end(), io_wrapper),
+                         pending_flushes_.end());
+}
+
+void ConnectionHandlerTask::FlushWrites(int, short) {
+  // Completions may schedule more flushes, which go to the next round
+  std::vector<IoUringSocketIoWrapper *> flushes;
+  flushes.swap(pending_flushes_);
+
+  size_t batch_size = io_uring_->GetNumEntries();
+  for (size_t begin = 0; begin < flushes.size(); begin += batch_size) {
+    size_t end = std::min(flushes.size(), begin + batch_size);
+    // A send is identified by the round and its index in the round. Should a
+    // completion ever outlive its round, it's recognized as stale.
+    send_round_ = (send_round_ + 1) & kSendRoundMask;
+    sending_.clear();
+    for (size_t i = begin; i < end; i++) {
+      auto &wbuf = *flushes[i]->wbuf_;
+      if (!wbuf.HasMore()) {
+        // Written out synchronously since the flush was scheduled
+        flushes[i]->CompleteScheduledFlush(0);
+        continue;
+      }
+      uint64_t user_data = kSendRequest |
+                           (static_cast<uint64_t>(send_round_) << 32) |
+                           sending_.size();
+      bool queued = io_uring_->PrepareSend(flushes[i]->GetSocketFd(),
+                                           &wbuf.buf_[wbuf.offset_],
+                                           wbuf.size_ - wbuf.offset_,
+                                           user_data);
+      PELOTON_ASSERT(queued);
+      (void)queued;
+      sending_.push_back(flushes[i]);
+    }
+    if (sending_.empty()) continue;
+
+    // The sends the kernel did not take were taken back, so nothing of them
+    // was sent. Their sockets say when they are writable.
+    size_t num_submitted = io_uring_->Submit();
+    for (size_t i = num_submitted; i < sending_.size(); i++) {
+      sending_[i]->CompleteScheduledFlush(-EAGAIN);
+    }
+    sending_.resize(num_submitted);
+    num_sending_ = num_submitted;
+
+    // The sends are MSG_DONTWAIT, so they complete right away, with -EAGAIN
+    // or a short count if a socket is full
+    ReapCompletions();
+    while (num_sending_ > 0 && io_uring_->WaitForCompletions(1) == 0) {
+      ReapCompletions();
+    }
+    if (num_sending_ > 0) {
+      // There is no telling what was sent, so the connections can't go on
+      for (auto io_wrapper : sending_) {
+        if (io_wrapper != nullptr) io_wrapper->CompleteScheduledFlush(-EIO);
+      }
+      num_sending_ = 0;
+    }
+    sending_.clear();
+  }
+}
+
+void ConnectionHandlerTask::ReapCompletions() {
+  io_uring_->ForEachCompletion([this](const IoUring::Completion &completion) {
+    if ((completion.user_data & kRequestKindMask) == kSendRequest) {
+      uint32_t round = (completion.user_data >> 32) & kSendRoundMask;
+      size_t index = completion.user_data & 0xFFFFFFFF;
+      if (round != send_round_ || index >= sending_.size() ||
+          sending_[index] == nullptr) {
+        LOG_ERROR("Ignoring the completion of a stale send");
+        return;
+      }
+      sending_[index]->CompleteScheduledFlush(completion.result);
+      sending_[index] = nullptr;
+      num_sending_--;
+    } else if ((completion.user_data & kRequestKindMask) == kReceiveRequest) {
+      HandleReceive(completion);
+    }
+    // Nothing waits for the completions of cancellations. Their receives end
+    // with a completion of their own.
+  });
+}
+
+void ConnectionHandlerTask::HandleCompletions(int, short) { ReapCompletions(); }
+
+bool ConnectionHandlerTask::StartReceiving(IoUringSocketIoWrapper *io_wrapper) {
+  uint64_t receive_id = next_receive_id_++;
+  if (!io_uring_->PrepareMultishotRecv(io_wrapper->GetSocketFd(),
+                                       kReceiveRequest | receive_id) ||
+      io_uring_->Submit() != 1) {
+    return false;
+  }
+  receivers_[receive_id] = io_wrapper;
+  io_wrapper->receive_id_ = receive_id;
+  return true;
+}
+
+void ConnectionHandlerTask::StopReceiving(IoUringSocketIoWrapper *io_wrapper) {
+  uint64_t receive_id = io_wrapper->receive_id_;
+  if (io_uring_->PrepareCancel(kReceiveRequest | receive_id, kCancelRequest) &&
+      io_uring_->Submit() == 1) {
+    // The buffers the receive still fills must not end up with a connection
+    // that is gone, or with SSL in place of the socket
+    ReapCompletions();
+    while (io_wrapper->receive_id_ != 0 &&
+           io_uring_->WaitForCompletions(1) == 0) {
+      ReapCompletions();
+    }
+  }
+  if (io_wrapper->receive_id_ != 0) {
+    LOG_ERROR("Failed to cancel the receive of a connection");
+    receivers_.erase(receive_id);
+    io_wrapper->receive_id_ = 0;
+  }
+}
+
+void ConnectionHandlerTask::HandleReceive(
+    const IoUring::Completion &completion) {
+  uint64_t receive_id = completion.user_data & ~kRequestKindMask;
+  auto it = receivers_.find(receive_id);
+  IoUringSocketIoWrapper *io_wrapper =
+      it == receivers_.end() ? nullptr : it->second;
+  if (completion.buffer_id >= 0) {
+    if (io_wrapper != nullptr && completion.result > 0) {
+      io_wrapper->Received(io_uring_->GetReceiveBuffer(completion.buffer_id),
+                           completion.result);
+    }
+    io_uring_->RecycleReceiveBuffer(completion.buffer_id);
+  }
+  if (io_wrapper == nullptr) return;
+
+  if (!completion.more) {
+    receivers_.erase(it);
+    io_wrapper->receive_id_ = 0;
+    if (completion.result == 0) {
+      io_wrapper->receive_eof_ = true;
+    } else if (completion.result == -EINVAL) {
+      // The kernel can't receive from this kind of socket
+      LOG_WARN("Falling back to reading from the sockets directly");
+      receive_through_io_uring_ = false;
+    } else if (completion.result < 0 && completion.result != -ENOBUFS &&
+               completion.result != -ECANCELED) {
+      io_wrapper->receive_error_ = -completion.result;
+    }
+    // Out of buffers, the receive is armed again once the connection has
+    // read what it got
+  }
+  io_wrapper->WakeUp();
 }
 
 }  // namespace network
@@ -0,0 +1,324 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// io_uring.cpp
+//
+// Identification: src/network/io_uring.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "network/io_uring.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifdef PELOTON_HAS_IO_URING
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "common/logger.h"
+
+namespace peloton {
+namespace network {
+
+#ifdef PELOTON_HAS_IO_URING
+
+namespace {
+
+template <typename T>
+T *RingPointer(void *ring, uint32_t offset) {
+  return reinterpret_cast<T *>(static_cast<char *>(ring) + offset);
+}
+
+}  // namespace
+
+std::unique_ptr<IoUring> IoUring::Create(uint32_t num_entries) {
+  struct io_uring_params params;
+  PELOTON_MEMSET(&params, 0, sizeof(params));
+  int ring_fd = static_cast<int>(
+      syscall(__NR_io_uring_setup, num_entries, &params));
+  if (ring_fd < 0) {
+    LOG_WARN("io_uring is not available: %s", strerror(errno));
+    return nullptr;
+  }
+
+  std::unique_ptr<IoUring> ring(new IoUring());
+  ring->ring_fd_ = ring_fd;
+  ring->num_entries_ = params.sq_entries;
+
+  ring->sq_ring_size_ =
+      params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+  ring->cq_ring_size_ =
+      params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    ring->sq_ring_size_ = ring->cq_ring_size_ =
+        std::max(ring->sq_ring_size_, ring->cq_ring_size_);
+  }
+
+  ring->sq_ring_ = mmap(nullptr, ring->sq_ring_size_, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+  if (ring->sq_ring_ == MAP_FAILED) {
+    ring->sq_ring_ = nullptr;
+    LOG_WARN("Failed to map io_uring submission queue: %s", strerror(errno));
+    return nullptr;
+  }
+  if (single_mmap) {
+    ring->cq_ring_ = ring->sq_ring_;
+  } else {
+    ring->cq_ring_ =
+        mmap(nullptr, ring->cq_ring_size_, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+    if (ring->cq_ring_ == MAP_FAILED) {
+      ring->cq_ring_ = nullptr;
+      LOG_WARN("Failed to map io_uring completion queue: %s", strerror(errno));
+      return nullptr;
+    }
+  }
+  ring->sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+  ring->sqes_ = mmap(nullptr, ring->sqes_size_, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+  if (ring->sqes_ == MAP_FAILED) {
+    ring->sqes_ = nullptr;
+    LOG_WARN("Failed to map io_uring entries: %s", strerror(errno));
+    return nullptr;
+  }
+
+  ring->sq_head_ =
+      RingPointer<std::atomic<uint32_t>>(ring->sq_ring_, params.sq_off.head);
+  ring->sq_tail_ =
+      RingPointer<std::atomic<uint32_t>>(ring->sq_ring_, params.sq_off.tail);
+  ring->sq_mask_ = *RingPointer<uint32_t>(ring->sq_ring_,
+                                          params.sq_off.ring_mask);
+  ring->sq_array_ = RingPointer<uint32_t>(ring->sq_ring_, params.sq_off.array);
+  ring->cq_head_ =
+      RingPointer<std::atomic<uint32_t>>(ring->cq_ring_, params.cq_off.head);
+  ring->cq_tail_ =
+      RingPointer<std::atomic<uint32_t>>(ring->cq_ring_, params.cq_off.tail);
+  ring->cq_mask_ = *RingPointer<uint32_t>(ring->cq_ring_,
+                                          params.cq_off.ring_mask);
+  ring->cqes_ =
+      RingPointer<struct io_uring_cqe>(ring->cq_ring_, params.cq_off.cqes);
+  return ring;
+}
+
+IoUring::~IoUring() {
+  if (sqes_ != nullptr) munmap(sqes_, sqes_size_);
+  if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  if (sq_ring_ != nullptr) munmap(sq_ring_, sq_ring_size_);
+  if (ring_fd_ >= 0) close(ring_fd_);
+  if (receive_buffer_ring_ != nullptr) {
+    munmap(receive_buffer_ring_, receive_buffer_ring_size_);
+  }
+}
+
+struct io_uring_sqe *IoUring::NextEntry() {
+  uint32_t tail = sq_tail_->load(std::memory_order_relaxed);
+  if (tail - sq_head_->load(std::memory_order_acquire) >= num_entries_) {
+    return nullptr;
+  }
+  uint32_t index = tail & sq_mask_;
+  auto *sqe = static_cast<struct io_uring_sqe *>(sqes_) + index;
+  PELOTON_MEMSET(sqe, 0, sizeof(*sqe));
+  sq_array_[index] = index;
+  return sqe;
+}
+
+void IoUring::PushEntry() {
+  // Publish the entry to the kernel
+  sq_tail_->store(sq_tail_->load(std::memory_order_relaxed) + 1,
+                  std::memory_order_release);
+  num_queued_++;
+}
+
+bool IoUring::PrepareSend(int fd, const void *buf, size_t len,
+                          uint64_t user_data) {
+  auto *sqe = NextEntry();
+  if (sqe == nullptr) return false;
+  sqe->opcode = IORING_OP_SEND;
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<uint64_t>(buf);
+  sqe->len = static_cast<uint32_t>(len);
+  // io_uring waits for the socket to become writable regardless of
+  // O_NONBLOCK, so ask for -EAGAIN explicitly
+  sqe->msg_flags = MSG_NOSIGNAL | MSG_DONTWAIT;
+  sqe->user_data = user_data;
+  PushEntry();
+  return true;
+}
+
+#ifdef PELOTON_HAS_IO_URING_RECV_MULTISHOT
+
+namespace {
+
+// The id of the group of the receive buffers, the only one of a ring
+const uint16_t kReceiveBufferGroup = 0;
+
+}  // namespace
+
+bool IoUring::SetUpReceiveBuffers(uint32_t num_buffers,
+                                  uint32_t buffer_size) {
+  PELOTON_ASSERT(num_buffers > 0 && num_buffers <= (1U << 15) &&
+                 (num_buffers & (num_buffers - 1)) == 0);
+  // The ring must be page-aligned
+  size_t ring_size = num_buffers * sizeof(struct io_uring_buf);
+  void *ring = mmap(nullptr, ring_size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (ring == MAP_FAILED) {
+    LOG_WARN("Failed to map io_uring receive buffers: %s", strerror(errno));
+    return false;
+  }
+
+  struct io_uring_buf_reg reg;
+  PELOTON_MEMSET(&reg, 0, sizeof(reg));
+  reg.ring_addr = reinterpret_cast<uint64_t>(ring);
+  reg.ring_entries = num_buffers;
+  reg.bgid = kReceiveBufferGroup;
+  if (syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_PBUF_RING,
+              &reg, 1) < 0) {
+    LOG_WARN("io_uring receive buffers are not available: %s",
+             strerror(errno));
+    munmap(ring, ring_size);
+    return false;
+  }
+
+  receive_buffer_ring_ = ring;
+  receive_buffer_ring_size_ = ring_size;
+  receive_buffer_tail_ = reinterpret_cast<std::atomic<uint16_t> *>(
+      &static_cast<struct io_uring_buf_ring *>(ring)->tail);
+  receive_buffer_mask_ = static_cast<uint16_t>(num_buffers - 1);
+  receive_buffer_size_ = buffer_size;
+  receive_buffers_.resize(static_cast<size_t>(num_buffers) * buffer_size);
+  for (uint32_t i = 0; i < num_buffers; i++) {
+    RecycleReceiveBuffer(static_cast<int32_t>(i));
+  }
+  return true;
+}
+
+bool IoUring::PrepareMultishotRecv(int fd, uint64_t user_data) {
+  PELOTON_ASSERT(receive_buffer_ring_ != nullptr);
+  auto *sqe = NextEntry();
+  if (sqe == nullptr) return false;
+  sqe->opcode = IORING_OP_RECV;
+  sqe->fd = fd;
+  sqe->ioprio = IORING_RECV_MULTISHOT;
+  sqe->flags = IOSQE_BUFFER_SELECT;
+  sqe->buf_group = kReceiveBufferGroup;
+  sqe->user_data = user_data;
+  PushEntry();
+  return true;
+}
+
+void IoUring::RecycleReceiveBuffer(int32_t buffer_id) {
+  // Only this thread adds buffers, the kernel only takes them
+  uint16_t tail = receive_buffer_tail_->load(std::memory_order_relaxed);
+  auto *buf = static_cast<struct io_uring_buf *>(receive_buffer_ring_) +
+              (tail & receive_buffer_mask_);
+  buf->addr = reinterpret_cast<uint64_t>(
+      &receive_buffers_[buffer_id * receive_buffer_size_]);
+  buf->len = receive_buffer_size_;
+  buf->bid = static_cast<uint16_t>(buffer_id);
+  receive_buffer_tail_->store(tail + 1, std::memory_order_release);
+}
+
+#else
+
+bool IoUring::SetUpReceiveBuffers(uint32_t, uint32_t) {
+  LOG_WARN("io_uring multishot receives are not supported by this build");
+  return false;
+}
+
+bool IoUring::PrepareMultishotRecv(int, uint64_t) { return false; }
+
+void IoUring::RecycleReceiveBuffer(int32_t) {}
+
+#endif
+
+bool IoUring::PrepareCancel(uint64_t target, uint64_t user_data) {
+  auto *sqe = NextEntry();
+  if (sqe == nullptr) return false;
+  sqe->opcode = IORING_OP_ASYNC_CANCEL;
+  sqe->fd = -1;
+  sqe->addr = target;
+  sqe->user_data = user_data;
+  PushEntry();
+  return true;
+}
+
+uint32_t IoUring::Submit() {
+  uint32_t submitted = 0;
+  while (submitted < num_queued_) {
+    int ret = static_cast<int>(syscall(__NR_io_uring_enter, ring_fd_,
+                                       num_queued_ - submitted, 0, 0, nullptr,
+                                       0));
+    if (ret < 0 && errno == EINTR) continue;
+    if (ret <= 0) {
+      LOG_ERROR("Failed to submit io_uring requests: %s",
+                ret < 0 ? strerror(errno) : "nothing was taken");
+      break;
+    }
+    // The kernel stops early if it fails to set up a request, which completes
+    // with the error. The rest are retried.
+    submitted += static_cast<uint32_t>(ret);
+  }
+  if (submitted < num_queued_) {
+    // The kernel consumed the submission queue up to its head. Take back what
+    // is past it, so that it is not submitted with the next requests.
+    sq_tail_->store(sq_head_->load(std::memory_order_acquire),
+                    std::memory_order_release);
+  }
+  num_queued_ = 0;
+  return submitted;
+}
+
+int IoUring::WaitForCompletions(uint32_t min_complete) {
+  while (true) {
+    int ret = static_cast<int>(syscall(__NR_io_uring_enter, ring_fd_, 0,
+                                       min_complete, IORING_ENTER_GETEVENTS,
+                                       nullptr, 0));
+    if (ret >= 0) return 0;
+    int error = errno;
+    if (error == EINTR) continue;
+    LOG_ERROR("Failed to wait for io_uring completions: %s", strerror(error));
+    return -error;
+  }
+}
+
+#else
+
+std::unique_ptr<IoUring> IoUring::Create(uint32_t) {
+  LOG_WARN("io_uring is not supported on this platform");
+  return nullptr;
+}
+
+IoUring::~IoUring() {}
+
+bool IoUring::PrepareSend(int, const void *, size_t, uint64_t) {
+  return false;
+}
+
+bool IoUring::SetUpReceiveBuffers(uint32_t, uint32_t) { return false; }
+
+bool IoUring::PrepareMultishotRecv(int, uint64_t) { return false; }
+
+bool IoUring::PrepareCancel(uint64_t, uint64_t) { return false; }
+
+void IoUring::RecycleReceiveBuffer(int32_t) {}
+
+uint32_t IoUring::Submit() { return 0; }
+
+int IoUring::WaitForCompletions(uint32_t) { return -ENOSYS; }
+
+#endif
+
+}  // namespace network
+}  // namespace peloton
@@ -16,27 +16,31 @@
 namespace peloton {
 namespace network {
 std::shared_ptr<NetworkIoWrapper> NetworkIoWrapperFactory::NewNetworkIoWrapper(
-    int conn_fd) {
+    int conn_fd, ConnectionHandlerTask *handler) {
+  std::shared_ptr<ReadBuffer> rbuf;
+  std::shared_ptr<WriteBuffer> wbuf;
   auto it = reusable_wrappers_.find(conn_fd);
   if (it == reusable_wrappers_.end()) {
     // No reusable wrappers
-    auto wrapper = std::make_shared<PosixSocketIoWrapper>(
-        conn_fd, std::make_shared<ReadBuffer>(),
-        std::make_shared<WriteBuffer>());
-    reusable_wrappers_[conn_fd] =
-        std::static_pointer_cast<NetworkIoWrapper, PosixSocketIoWrapper>(wrapper);
-    return wrapper;
+    rbuf = std::make_shared<ReadBuffer>();
+    wbuf = std::make_shared<WriteBuffer>();
+  } else {
+    // Construct new wrapper by reusing buffers from the old one.
+    // The old one will be deallocated as we replace the last reference to it
+    // in the reusable_wrappers_ map. We still need to explicitly call the
+    // constructor so the flags are set properly on the new file descriptor.
+    rbuf = it->second->rbuf_;
+    wbuf = it->second->wbuf_;
   }
 
-  // Construct new wrapper by reusing buffers from the old one.
-  // The old one will be deallocated as we replace the last reference to it
-  // in the reusable_wrappers_ map. We still need to explicitly call the
-  // constructor so the flags are set properly on the new file descriptor.
-  auto &reused_wrapper = it->second;
-  reused_wrapper = std::make_shared<PosixSocketIoWrapper>(conn_fd,
-                                                          reused_wrapper->rbuf_,
-                                                          reused_wrapper->wbuf_);
-  return reused_wrapper;
+  std::shared_ptr<NetworkIoWrapper> wrapper;
+  if (handler != nullptr && handler->GetIoUring() != nullptr)
+    wrapper = std::make_shared<IoUringSocketIoWrapper>(conn_fd, rbuf, wbuf,
+                                                       handler);
+  else
+    wrapper = std::make_shared<PosixSocketIoWrapper>(conn_fd, rbuf, wbuf);
+  reusable_wrappers_[conn_fd] = wrapper;
+  return wrapper;
 }
 
 Transition NetworkIoWrapperFactory::PerformSslHandshake(
@@ -15,11 +15,16 @@
 #include <netinet/tcp.h>
 #include <openssl/err.h>
 #include <sys/file.h>
+#include <sys/socket.h>
+#include "network/connection_handler_task.h"
 #include "network/peloton_server.h"
+#include "network/postgres_protocol_handler.h"
 
 namespace peloton {
 namespace network {
 Transition NetworkIoWrapper::WritePacket(OutputPacket *pkt) {
+  if (!pkt->rows.empty()) return WriteDataRows(pkt);
+
   // Write Packet Header
   if (!pkt->skip_header_write) {
     if (!wbuf_->HasSpaceFor(1 + sizeof(int32_t))) {
@@ -55,6 +60,62 @@ Transition NetworkIoWrapper::WritePacket(OutputPacket *pkt) {
   return Transition::PROCEED;
 }
 
+Transition NetworkIoWrapper::WriteDataRows(OutputPacket *pkt) {
+  PacketWriter writer(*wbuf_);
+  size_t num_rows = pkt->rows.size() / pkt->num_columns;
+  for (; pkt->write_ptr < num_rows; pkt->write_ptr++) {
+    auto row = pkt->rows.begin() + pkt->write_ptr * pkt->num_columns;
+    if (pkt->oversized_row == nullptr) {
+      // Type, length, number of columns and the length of each value
+      size_t row_size = 1 + sizeof(int32_t) + sizeof(int16_t) +
+                        pkt->num_columns * sizeof(int32_t);
+      for (size_t i = 0; i < pkt->num_columns; i++) row_size += row[i].size();
+
+      if (row_size > wbuf_->Capacity()) {
+        // The row can only be written out in pieces, so stage it
+        pkt->oversized_row.reset(new OutputPacket());
+        auto &row_pkt = *pkt->oversized_row;
+        row_pkt.msg_type = NetworkMessageType::DATA_ROW;
+        PacketPutInt(&row_pkt, pkt->num_columns, 2);
+        for (size_t i = 0; i < pkt->num_columns; i++) {
+          if (row[i].empty()) {
+            PacketPutInt(&row_pkt, NULL_CONTENT_SIZE, 4);
+          } else {
+            PacketPutInt(&row_pkt, row[i].size(), 4);
+            PacketPutString(&row_pkt, row[i]);
+          }
+        }
+      } else if (!wbuf_->HasSpaceFor(row_size)) {
+        auto result = FlushWriteBuffer();
+        if (result != Transition::PROCEED)
+          // Unable to flush buffer, socket presumably not ready for write
+          return result;
+      }
+    }
+
+    if (pkt->oversized_row != nullptr) {
+      auto result = WritePacket(pkt->oversized_row.get());
+      if (result != Transition::PROCEED) return result;
+      pkt->oversized_row.reset();
+      continue;
+    }
+
+    writer.BeginPacket(NetworkMessageType::DATA_ROW);
+    writer.AppendInt16(pkt->num_columns);
+    for (size_t i = 0; i < pkt->num_columns; i++) {
+      if (row[i].empty()) {
+        // content is NULL, no value bytes follow
+        writer.AppendInt32(NULL_CONTENT_SIZE);
+      } else {
+        writer.AppendInt32(row[i].size());
+        writer.AppendString(row[i]);
+      }
+    }
+    writer.EndPacket();
+  }
+  return Transition::PROCEED;
+}
+
 PosixSocketIoWrapper::PosixSocketIoWrapper(int sock_fd,
                                            std::shared_ptr<ReadBuffer> rbuf,
                                            std::shared_ptr<WriteBuffer> wbuf)
@@ -114,6 +175,172 @@ Transition PosixSocketIoWrapper::FlushWriteBuffer() {
   return Transition::PROCEED;
 }
 
+IoUringSocketIoWrapper::~IoUringSocketIoWrapper() {
+  StopReceiving();
+  CancelScheduledFlush();
+}
+
+Transition IoUringSocketIoWrapper::FillReadBuffer() {
+  if (!rbuf_->HasMore()) rbuf_->Reset();
+  if (rbuf_->HasMore() && rbuf_->Full()) rbuf_->MoveContentToHead();
+
+  if (handler_->ReceivesThroughIoUring()) {
+    // Whatever the ring holds for this connection is handed over here, not
+    // through a wakeup
+    reading_ = true;
+    handler_->ReapCompletions();
+    if (receive_id_ == 0 && received_.empty() && !receive_eof_ &&
+        receive_error_ == 0 && handler_->StartReceiving(this)) {
+      handler_->ReapCompletions();
+    }
+    reading_ = false;
+  }
+
+  if (received_offset_ < received_.size()) {
+    size_t bytes_read = rbuf_->FillBufferFrom(
+        &received_[received_offset_], received_.size() - received_offset_);
+    received_offset_ += bytes_read;
+    if (received_offset_ == received_.size()) {
+      received_.clear();
+      received_offset_ = 0;
+    }
+    return bytes_read > 0 ? Transition::PROCEED : Transition::NEED_READ;
+  }
+  if (receive_error_ != 0) {
+    LOG_ERROR("Error reading: %s", strerror(receive_error_));
+    throw NetworkProcessException("Error when filling read buffer " +
+                                  std::to_string(receive_error_));
+  }
+  if (receive_eof_) return Transition::TERMINATE;
+  // The multishot receive wakes the connection up when more data arrives
+  if (receive_id_ != 0) return Transition::NEED_READ;
+  return ReadFromSocket();
+}
+
+Transition IoUringSocketIoWrapper::ReadFromSocket() {
+  Transition result = Transition::NEED_READ;
+  while (!rbuf_->Full()) {
+    auto space = static_cast<ssize_t>(rbuf_->Capacity() - rbuf_->size_);
+    auto bytes_read = rbuf_->FillBufferFrom(sock_fd_);
+    if (bytes_read > 0) {
+      result = Transition::PROCEED;
+      // The socket is drained if the read came up short. The read event is
+      // level-triggered, so stop here instead of spending a system call on
+      // the EAGAIN.
+      if (bytes_read < space) return result;
+    } else if (bytes_read == 0) {
+      return Transition::TERMINATE;
+    } else {
+      switch (errno) {
+        case EAGAIN:
+          // Equal to EWOULDBLOCK
+          return result;
+        case EINTR:
+          continue;
+        default:
+          LOG_ERROR("Error reading: %s", strerror(errno));
+          throw NetworkProcessException("Error when filling read buffer " +
+                                        std::to_string(errno));
+      }
+    }
+  }
+  return result;
+}
+
+void IoUringSocketIoWrapper::Received(const char *data, size_t len) {
+  received_.insert(received_.end(), data, data + len);
+}
+
+void IoUringSocketIoWrapper::WakeUp() {
+  // The read event is only pending while the connection waits for data. It
+  // is taken off while the connection waits on the traffic cop, which wakes
+  // it up on its own.
+  if (!reading_ && read_event_ != nullptr &&
+      event_pending(read_event_, EV_READ, nullptr)) {
+    event_active(read_event_, EV_READ, 0);
+  }
+}
+
+void IoUringSocketIoWrapper::StopReceiving() {
+  if (receive_id_ != 0) handler_->StopReceiving(this);
+}
+
+Transition IoUringSocketIoWrapper::ScheduleFlushWriteBuffer() {
+  if (!wbuf_->HasMore()) {
+    wbuf_->Reset();
+    return Transition::PROCEED;
+  }
+  // Already waiting for the handler thread or for the socket, either of which
+  // sends everything in the buffer
+  if (flush_scheduled_ || writable_event_ != nullptr) return Transition::PROCEED;
+  flush_scheduled_ = true;
+  handler_->ScheduleFlush(this);
+  return Transition::PROCEED;
+}
+
+void IoUringSocketIoWrapper::CompleteScheduledFlush(int result) {
+  flush_scheduled_ = false;
+  if (result > 0) {
+    wbuf_->offset_ += result;
+  } else if (result < 0 && result != -EAGAIN && result != -EINTR) {
+    // The connection is broken. Shutting it down makes the next read on it
+    // terminate it.
+    LOG_ERROR("Error writing: %s", strerror(-result));
+    shutdown(sock_fd_, SHUT_RDWR);
+    wbuf_->Reset();
+    return;
+  }
+  if (!wbuf_->HasMore()) {
+    wbuf_->Reset();
+    return;
+  }
+  writable_event_ = handler_->RegisterEvent(
+      sock_fd_, EV_WRITE | EV_PERSIST,
+      METHOD_AS_CALLBACK(IoUringSocketIoWrapper, HandleWritable), this);
+}
+
+void IoUringSocketIoWrapper::HandleWritable(int, short) {
+  Transition result;
+  try {
+    result = FlushWriteBuffer();
+  } catch (NetworkProcessException &e) {
+    LOG_ERROR("%s", e.what());
+    wbuf_->Reset();
+    result = Transition::PROCEED;
+  }
+  if (result == Transition::PROCEED) {
+    handler_->UnregisterEvent(writable_event_);
+    writable_event_ = nullptr;
+  }
+}
+
+void IoUringSocketIoWrapper::CancelScheduledFlush() {
+  if (flush_scheduled_) {
+    handler_->CancelFlush(this);
+    flush_scheduled_ = false;
+  }
+  if (writable_event_ != nullptr) {
+    handler_->UnregisterEvent(writable_event_);
+    writable_event_ = nullptr;
+  }
+}
+
+Transition IoUringSocketIoWrapper::Close() {
+  // Try to get out what is left of the responses before closing, like the
+  // synchronous wrapper would have
+  if (flush_scheduled_ || writable_event_ != nullptr) {
+    try {
+      FlushWriteBuffer();
+    } catch (NetworkProcessException &e) {
+      LOG_ERROR("%s", e.what());
+    }
+  }
+  CancelScheduledFlush();
+  StopReceiving();
+  wbuf_->Reset();
+  return PosixSocketIoWrapper::Close();
+}
+
 Transition SslSocketIoWrapper::FillReadBuffer() {
   if (!rbuf_->HasMore()) rbuf_->Reset();
   if (rbuf_->HasMore() && rbuf_->Full()) rbuf_->MoveContentToHead();
@@ -234,35 +234,59 @@ void PelotonServer::TrySslOperation(int (*func)(Ts...), Ts... arg) {
   }
 }
 
-PelotonServer &PelotonServer::SetupServer() {
-  // This line is critical to performance for some reason
-  evthread_use_pthreads();
-  if (settings::SettingsManager::GetString(
-          settings::SettingId::socket_family) != "AF_INET")
-    throw ConnectionException("Unsupported socket family");
-
+int PelotonServer::CreateListenSocket(bool reuse_port) {
   struct sockaddr_in sin;
   PELOTON_MEMSET(&sin, 0, sizeof(sin));
   sin.sin_family = AF_INET;
   sin.sin_addr.s_addr = INADDR_ANY;
   sin.sin_port = htons(port_);
 
-  listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+  int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
 
-  if (listen_fd_ < 0) {
+  if (listen_fd < 0) {
     throw ConnectionException("Failed to create listen socket");
   }
 
   int conn_backlog = 12;
   int reuse = 1;
-  setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+  setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+  if (reuse_port) {
+    // The kernel spreads the connections over all sockets bound to the port.
+    // They are accepted on handler threads that also serve connections, so
+    // the sockets must not block.
+    TrySslOperation<int, int, int, const void *, socklen_t>(
+        setsockopt, listen_fd, SOL_SOCKET, SO_REUSEPORT, &reuse,
+        sizeof(reuse));
+    auto flags = fcntl(listen_fd, F_GETFL);
+    fcntl(listen_fd, F_SETFL, flags | O_NONBLOCK);
+    conn_backlog = 128;
+  }
 
   TrySslOperation<int, const struct sockaddr *, socklen_t>(
-      bind, listen_fd_, (struct sockaddr *)&sin, sizeof(sin));
-  TrySslOperation<int, int>(listen, listen_fd_, conn_backlog);
+      bind, listen_fd, (struct sockaddr *)&sin, sizeof(sin));
+  TrySslOperation<int, int>(listen, listen_fd, conn_backlog);
+  return listen_fd;
+}
 
-  dispatcher_task_ = std::make_shared<ConnectionDispatcherTask>(
-      CONNECTION_THREAD_COUNT, listen_fd_);
+PelotonServer &PelotonServer::SetupServer() {
+  // This line is critical to performance for some reason
+  evthread_use_pthreads();
+  if (settings::SettingsManager::GetString(
+          settings::SettingId::socket_family) != "AF_INET")
+    throw ConnectionException("Unsupported socket family");
+
+  if (settings::SettingsManager::GetBool(settings::SettingId::reuse_port)) {
+    // Every handler accepts its own share of the connections
+    for (size_t i = 0; i < CONNECTION_THREAD_COUNT; i++) {
+      handler_listen_fds_.push_back(CreateListenSocket(true));
+    }
+    dispatcher_task_ =
+        std::make_shared<ConnectionDispatcherTask>(handler_listen_fds_);
+  } else {
+    listen_fd_ = CreateListenSocket(false);
+    dispatcher_task_ = std::make_shared<ConnectionDispatcherTask>(
+        CONNECTION_THREAD_COUNT, listen_fd_);
+  }
 
   LOG_INFO("Listening on port %llu", (unsigned long long)port_);
   return *this;
@@ -279,7 +303,9 @@ void PelotonServer::ServerLoop() {
   }
   dispatcher_task_->EventLoop();
 
-  peloton_close(listen_fd_);
+  if (listen_fd_ >= 0) peloton_close(listen_fd_);
+  for (int listen_fd : handler_listen_fds_) peloton_close(listen_fd);
+  handler_listen_fds_.clear();
 
   LOG_INFO("Server Closed");
 }
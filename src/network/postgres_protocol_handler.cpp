@@ -17,6 +17,7 @@
 #include "common/cache.h"
 #include "common/internal_types.h"
 #include "common/macros.h"
+#include "common/parameterized_plan_cache.h"
 #include "common/portal.h"
 #include "expression/expression_util.h"
 #include "network/marshal.h"
@@ -146,6 +147,7 @@ ProcessResult PostgresProtocolHandler::ExecQueryMessage(
   // one packet contains only one query. But when using the pipeline mode in
   // Libpqxx, it sends multiple query in one packet. In this case, it's
   // incorrect.
+  size_t num_statements = sql_stmt_list->GetNumStatements();
   auto sql_stmt = sql_stmt_list->PassOutStatement(0);
 
   QueryType query_type =
@@ -220,24 +222,80 @@ ProcessResult PostgresProtocolHandler::ExecQueryMessage(
     };
     case QueryType::QUERY_EXPLAIN: {
       auto status = ExecQueryExplain(
-          query, static_cast<parser::ExplainStatement &>(*sql_stmt));
+          query, static_cast<parser::ExplainStatement &>(*sql_stmt),
+          thread_id);
+      if (traffic_cop_->GetQueuing()) {
+        return ProcessResult::PROCESSING;
+      }
       ExecQueryMessageGetResult(status);
       return ProcessResult::COMPLETE;
     }
     default: {
-      std::string stmt_name = "unamed";
-      std::unique_ptr<parser::SQLStatementList> unnamed_sql_stmt_list(
-          new parser::SQLStatementList());
-      unnamed_sql_stmt_list->PassInStatement(std::move(sql_stmt));
-      traffic_cop_->SetStatement(traffic_cop_->PrepareStatement(
-          stmt_name, query, std::move(unnamed_sql_stmt_list)));
-      if (traffic_cop_->GetStatement().get() == nullptr) {
-        SendErrorResponse({{NetworkMessageType::HUMAN_READABLE_ERROR,
-                            traffic_cop_->GetErrorMessage()}});
-        SendReadyForQuery(NetworkTransactionStateType::IDLE);
-        return ProcessResult::COMPLETE;
+      // Schema changes and new statistics may invalidate the cached plans
+      if (query_type == QueryType::QUERY_CREATE_TABLE ||
+          query_type == QueryType::QUERY_CREATE_INDEX ||
+          query_type == QueryType::QUERY_CREATE_TRIGGER ||
+          query_type == QueryType::QUERY_DROP ||
+          query_type == QueryType::QUERY_RENAME ||
+          query_type == QueryType::QUERY_ALTER ||
+          query_type == QueryType::QUERY_ANALYZE) {
+        plan_cache_.Clear();
+      }
+
+      // Replace the literals of the query with parameters, and reuse the
+      // plan of an earlier query that only differed in its literals
+      std::vector<std::unique_ptr<expression::AbstractExpression>> parameters;
+      plan_cache_fingerprint_.clear();
+      if (settings::SettingsManager::GetBool(
+              settings::SettingId::auto_parameterization) &&
+          num_statements == 1) {
+        plan_cache_fingerprint_ = ParameterizedPlanCache::Parameterize(
+            query, sql_stmt.get(), parameters);
+      }
+
+      std::shared_ptr<Statement> cached_statement;
+      if (!plan_cache_fingerprint_.empty()) {
+        cached_statement = plan_cache_.GetStatement(plan_cache_fingerprint_);
+      }
+
+      if (cached_statement.get() != nullptr) {
+        traffic_cop_->SetStatement(cached_statement);
+      } else {
+        std::string stmt_name = "unamed";
+        std::unique_ptr<parser::SQLStatementList> unnamed_sql_stmt_list(
+            new parser::SQLStatementList());
+        unnamed_sql_stmt_list->PassInStatement(std::move(sql_stmt));
+        traffic_cop_->SetStatement(traffic_cop_->PrepareStatement(
+            stmt_name, query, std::move(unnamed_sql_stmt_list)));
+        if (traffic_cop_->GetStatement().get() == nullptr) {
+          plan_cache_fingerprint_.clear();
+          SendErrorResponse({{NetworkMessageType::HUMAN_READABLE_ERROR,
+                              traffic_cop_->GetErrorMessage()}});
+          SendReadyForQuery(NetworkTransactionStateType::IDLE);
+          return ProcessResult::COMPLETE;
+        }
+        // No plan is generated if the current txn has already aborted
+        if (traffic_cop_->GetStatement()->GetPlanTree().get() == nullptr) {
+          plan_cache_fingerprint_.clear();
+        } else if (!plan_cache_fingerprint_.empty()) {
+          plan_cache_.AddStatement(plan_cache_fingerprint_,
+                                   traffic_cop_->GetStatement());
+        }
+      }
+
+      if (!plan_cache_fingerprint_.empty()) {
+        if (!traffic_cop_->BindParamsForCachePlan(parameters, thread_id)) {
+          plan_cache_.DeleteStatement(plan_cache_fingerprint_);
+          plan_cache_fingerprint_.clear();
+          traffic_cop_->ProcessInvalidStatement();
+          SendErrorResponse({{NetworkMessageType::HUMAN_READABLE_ERROR,
+                              traffic_cop_->GetErrorMessage()}});
+          SendReadyForQuery(NetworkTransactionStateType::IDLE);
+          return ProcessResult::COMPLETE;
+        }
+      } else {
+        traffic_cop_->SetParamVal(std::vector<type::Value>());
       }
-      traffic_cop_->SetParamVal(std::vector<type::Value>());
       bool unnamed = false;
       result_format_ = std::vector<int>(
           traffic_cop_->GetStatement()->GetTupleDescriptor().size(), 0);
@@ -254,27 +312,57 @@ ProcessResult PostgresProtocolHandler::ExecQueryMessage(
 }
 
 ResultType PostgresProtocolHandler::ExecQueryExplain(
-    const std::string &query, parser::ExplainStatement &explain_stmt) {
+    const std::string &query, parser::ExplainStatement &explain_stmt,
+    const size_t thread_id) {
   std::unique_ptr<parser::SQLStatementList> unnamed_sql_stmt_list(
       new parser::SQLStatementList());
   unnamed_sql_stmt_list->PassInStatement(std::move(explain_stmt.real_sql_stmt));
-  auto stmt = traffic_cop_->PrepareStatement("explain", query,
-                                             std::move(unnamed_sql_stmt_list));
-  ResultType status = ResultType::UNKNOWN;
-  if (stmt != nullptr) {
-    traffic_cop_->SetStatement(stmt);
-    std::vector<std::string> plan_info = StringUtil::Split(
-        planner::PlanUtil::GetInfo(stmt->GetPlanTree().get()), '\n');
-    const std::vector<FieldInfo> tuple_descriptor = {
-        traffic_cop_->GetColumnFieldForValueType("Query plan",
-                                                 type::TypeId::VARCHAR)};
-    stmt->SetTupleDescriptor(tuple_descriptor);
-    traffic_cop_->SetResult(plan_info);
-    status = ResultType::SUCCESS;
-  } else {
-    status = ResultType::FAILURE;
+  auto stmt = traffic_cop_->PrepareStatement(
+      "explain", query, std::move(unnamed_sql_stmt_list), thread_id);
+  if (stmt == nullptr) {
+    return ResultType::FAILURE;
+  }
+  traffic_cop_->SetStatement(stmt);
+  if (explain_stmt.analyze && stmt->GetPlanTree() != nullptr) {
+    // Run the query to completion on the execution pool like any other, and
+    // throw its rows away. The profile is shown once the execution is done.
+    explain_actual_rows_.clear();
+    explain_rows_.clear();
+    result_format_ = std::vector<int>(stmt->GetTupleDescriptor().size(), 0);
+    traffic_cop_->SetParamVal(std::vector<type::Value>());
+    auto exec_status = traffic_cop_->ExecuteHelper(
+        stmt->GetPlanTree(), traffic_cop_->GetParamVal(), explain_rows_,
+        result_format_, thread_id, &explain_actual_rows_);
+    if (traffic_cop_->GetQueuing()) {
+      explaining_ = true;
+      return ResultType::QUEUING;
+    }
+    return ExecQueryExplainGetResult(exec_status.m_result);
   }
-  return status;
+  SetExplainResult(planner::PlanUtil::GetInfo(stmt->GetPlanTree().get()));
+  return ResultType::SUCCESS;
+}
+
+ResultType PostgresProtocolHandler::ExecQueryExplainGetResult(
+    ResultType status) {
+  explain_rows_.clear();
+  if (status != ResultType::SUCCESS) {
+    explain_actual_rows_.clear();
+    return ResultType::FAILURE;
+  }
+  SetExplainResult(planner::PlanUtil::GetAnalyzeInfo(
+      traffic_cop_->GetStatement()->GetPlanTree().get(), explain_actual_rows_));
+  explain_actual_rows_.clear();
+  return ResultType::SUCCESS;
+}
+
+void PostgresProtocolHandler::SetExplainResult(const std::string &plan_str) {
+  std::vector<std::string> plan_info = StringUtil::Split(plan_str, '\n');
+  const std::vector<FieldInfo> tuple_descriptor = {
+      traffic_cop_->GetColumnFieldForValueType("Query plan",
+                                               type::TypeId::VARCHAR)};
+  traffic_cop_->GetStatement()->SetTupleDescriptor(tuple_descriptor);
+  traffic_cop_->SetResult(plan_info);
 }
 
 void PostgresProtocolHandler::ExecQueryMessageGetResult(ResultType status) {
@@ -282,6 +370,12 @@ void PostgresProtocolHandler::ExecQueryMessageGetResult(ResultType status) {
   if (status == ResultType::SUCCESS) {
     tuple_descriptor = traffic_cop_->GetStatement()->GetTupleDescriptor();
   } else if (status == ResultType::FAILURE) {  // check status
+    // Don't keep reusing a cached plan that failed, e.g., because a table it
+    // reads was dropped by another connection
+    if (!plan_cache_fingerprint_.empty()) {
+      plan_cache_.DeleteStatement(plan_cache_fingerprint_);
+      plan_cache_fingerprint_.clear();
+    }
     SendErrorResponse({{NetworkMessageType::HUMAN_READABLE_ERROR,
                         traffic_cop_->GetErrorMessage()}});
     SendReadyForQuery(NetworkTransactionStateType::IDLE);
@@ -766,7 +860,7 @@ ProcessResult PostgresProtocolHandler::ExecDescribeMessage(InputPacket *pkt) {
 }
 
 ProcessResult PostgresProtocolHandler::ExecExecuteMessage(
-    InputPacket *pkt, const size_t thread_id) {
+    InputPacket *pkt, ReadBuffer &rbuf, const size_t thread_id) {
   // EXECUTE message
   protocol_type_ = NetworkProtocolType::POSTGRES_JDBC;
   std::string error_message, portal_name;
@@ -808,6 +902,35 @@ ProcessResult PostgresProtocolHandler::ExecExecuteMessage(
   bool unnamed = statement_name.empty();
   traffic_cop_->SetParamVal(portal->GetParameters());
 
+  // Drivers pipeline the executions of a batch (e.g., batched inserts) as
+  // BIND/EXECUTE pairs before a single SYNC. Execute the ones that are
+  // already buffered together instead of queuing each of them separately.
+  auto statement = traffic_cop_->GetStatement();
+  auto query_type = statement->GetQueryType();
+  if (settings::SettingsManager::GetBool(
+          settings::SettingId::batch_pipelined_executions) &&
+      (query_type == QueryType::QUERY_INSERT ||
+       query_type == QueryType::QUERY_UPDATE ||
+       query_type == QueryType::QUERY_DELETE) &&
+      statement->GetPlanTree() != nullptr && !statement->GetNeedsReplan()) {
+    batch_params_.push_back(portal->GetParameters());
+    batch_responses_.emplace_back();
+    CollectPipelinedExecutions(rbuf, statement);
+
+    if (batch_responses_.size() > 1) {
+      auto status = traffic_cop_->ExecuteStatementBatch(
+          statement, batch_params_, batch_results_, result_format_, thread_id);
+      if (traffic_cop_->GetQueuing()) {
+        return ProcessResult::PROCESSING;
+      }
+      ExecBatchGetResult(status);
+      return ProcessResult::COMPLETE;
+    }
+    // Nothing to batch the execution with
+    batch_params_.clear();
+    batch_responses_.clear();
+  }
+
   auto status = traffic_cop_->ExecuteStatement(
       traffic_cop_->GetStatement(), traffic_cop_->GetParamVal(), unnamed,
       param_stat, result_format_, traffic_cop_->GetResult(), thread_id);
@@ -859,16 +982,100 @@ void PostgresProtocolHandler::ExecExecuteMessageGetResult(ResultType status) {
   }
 }
 
+void PostgresProtocolHandler::CollectPipelinedExecutions(
+    ReadBuffer &rbuf, const std::shared_ptr<Statement> &statement) {
+  while (batch_params_.size() < MAX_PIPELINED_BATCH_SIZE) {
+    // Only take a BIND of the same statement whose EXECUTE is buffered too
+    size_t offset = rbuf.offset_;
+    InputPacket bind_pkt, execute_pkt;
+    std::string portal_name, statement_name, execute_portal_name;
+    if (!PeekPacket(rbuf, NetworkMessageType::BIND_COMMAND, bind_pkt)) break;
+    GetStringToken(&bind_pkt, portal_name);
+    GetStringToken(&bind_pkt, statement_name);
+    bind_pkt.ptr = 0;
+    if (statement_name != statement->GetStatementName() ||
+        !PeekPacket(rbuf, NetworkMessageType::EXECUTE_COMMAND, execute_pkt)) {
+      rbuf.offset_ = offset;
+      break;
+    }
+    GetStringToken(&execute_pkt, execute_portal_name);
+    if (execute_portal_name != portal_name) {
+      rbuf.offset_ = offset;
+      break;
+    }
+
+    // Hold back the responses to the BIND until the batch has executed
+    size_t num_responses = responses_.size();
+    ExecBindMessage(&bind_pkt);
+    ResponseBuffer bind_responses;
+    for (size_t i = num_responses; i < responses_.size(); i++) {
+      bind_responses.push_back(std::move(responses_[i]));
+    }
+    responses_.resize(num_responses);
+
+    auto portal = portals_[portal_name];
+    bool bound = bind_responses.size() == 1 &&
+                 bind_responses[0]->msg_type ==
+                     NetworkMessageType::BIND_COMPLETE &&
+                 portal != nullptr && portal->GetStatement() == statement;
+    batch_responses_.push_back(std::move(bind_responses));
+    if (!bound) {
+      // The BIND failed. Its EXECUTE is skipped, as every message up to the
+      // SYNC would be after an error.
+      break;
+    }
+    batch_params_.push_back(portal->GetParameters());
+  }
+}
+
+void PostgresProtocolHandler::ExecBatchGetResult(ResultType status) {
+  const auto &query_type = traffic_cop_->GetStatement()->GetQueryType();
+  // If the batch failed, the execution that failed is the last one that ran
+  size_t num_succeeded = batch_results_.size();
+  if (status != ResultType::SUCCESS && num_succeeded > 0) num_succeeded--;
+
+  for (size_t i = 0; i < num_succeeded; i++) {
+    for (auto &response : batch_responses_[i]) {
+      responses_.push_back(std::move(response));
+    }
+    CompleteCommand(query_type, batch_results_[i].m_processed);
+  }
+
+  // The rest of the batch is skipped after an error
+  if (status != ResultType::SUCCESS) {
+    for (auto &response : batch_responses_[num_succeeded]) {
+      responses_.push_back(std::move(response));
+    }
+    ExecExecuteMessageGetResult(status);
+  } else if (batch_responses_.size() > batch_params_.size()) {
+    for (auto &response : batch_responses_.back()) {
+      responses_.push_back(std::move(response));
+    }
+  }
+
+  batch_params_.clear();
+  batch_results_.clear();
+  batch_responses_.clear();
+}
+
 void PostgresProtocolHandler::GetResult() {
   traffic_cop_->ExecuteStatementPlanGetResult();
   auto status = traffic_cop_->ExecuteStatementGetResult();
   switch (protocol_type_) {
     case NetworkProtocolType::POSTGRES_JDBC:
       LOG_TRACE("JDBC result");
-      ExecExecuteMessageGetResult(status);
+      if (!batch_responses_.empty()) {
+        ExecBatchGetResult(status);
+      } else {
+        ExecExecuteMessageGetResult(status);
+      }
       break;
     case NetworkProtocolType::POSTGRES_PSQL:
       LOG_TRACE("PSQL result");
+      if (explaining_) {
+        explaining_ = false;
+        status = ExecQueryExplainGetResult(status);
+      }
       ExecQueryMessageGetResult(status);
   }
 }
@@ -949,6 +1156,19 @@ bool PostgresProtocolHandler::ReadPacketHeader(ReadBuffer &rbuf,
   return true;
 }
 
+bool PostgresProtocolHandler::PeekPacket(ReadBuffer &rbuf,
+                                         NetworkMessageType msg_type,
+                                         InputPacket &rpkt) {
+  size_t offset = rbuf.offset_;
+  if (ReadPacketHeader(rbuf, rpkt, false) && rpkt.msg_type == msg_type &&
+      !rpkt.is_extended && ReadPacket(rbuf, rpkt)) {
+    return true;
+  }
+  rbuf.offset_ = offset;
+  rpkt.Reset();
+  return false;
+}
+
 // Tries to read the contents of a single packet, returns true on success, false
 // on failure.
 bool PostgresProtocolHandler::ReadPacket(ReadBuffer &rbuf, InputPacket &rpkt) {
@@ -1051,7 +1271,7 @@ ProcessResult PostgresProtocolHandler::Process(ReadBuffer &rbuf,
 
   ProcessResult process_status =
       init_stage_ ? ProcessInitialPacket(&request_)
-                  : ProcessNormalPacket(&request_, thread_id);
+                  : ProcessNormalPacket(&request_, rbuf, thread_id);
 
   request_.Reset();
 
@@ -1059,7 +1279,7 @@ ProcessResult PostgresProtocolHandler::Process(ReadBuffer &rbuf,
 }
 
 ProcessResult PostgresProtocolHandler::ProcessNormalPacket(
-    InputPacket *pkt, const size_t thread_id) {
+    InputPacket *pkt, ReadBuffer &rbuf, const size_t thread_id) {
   LOG_TRACE("Message type: %c", static_cast<unsigned char>(pkt->msg_type));
   // We don't set force_flush to true for `PBDE` messages because they're
   // part of the extended protocol. Buffer responses and don't flush until
@@ -1084,7 +1304,7 @@ ProcessResult PostgresProtocolHandler::ProcessNormalPacket(
     }
     case NetworkMessageType::EXECUTE_COMMAND: {
       LOG_TRACE("EXECUTE_COMMAND");
-      return ExecExecuteMessage(pkt, thread_id);
+      return ExecExecuteMessage(pkt, rbuf, thread_id);
     }
     case NetworkMessageType::SYNC_COMMAND: {
       LOG_TRACE("SYNC_COMMAND");
@@ -1154,26 +1374,14 @@ void PostgresProtocolHandler::SendDataRows(std::vector<ResultValue> &results,
 
   size_t numrows = results.size() / colcount;
 
-  // 1 packet per row
-  for (size_t i = 0; i < numrows; i++) {
-    std::unique_ptr<OutputPacket> pkt(new OutputPacket());
-    pkt->msg_type = NetworkMessageType::DATA_ROW;
-    PacketPutInt(pkt.get(), colcount, 2);
-    for (int j = 0; j < colcount; j++) {
-      auto content = results[i * colcount + j];
-      if (content.size() == 0) {
-        // content is NULL
-        PacketPutInt(pkt.get(), NULL_CONTENT_SIZE, 4);
-        // no value bytes follow
-      } else {
-        // length of the row attribute
-        PacketPutInt(pkt.get(), content.size(), 4);
-        // contents of the row attribute
-        PacketPutString(pkt.get(), content);
-      }
-    }
-    responses_.push_back(std::move(pkt));
-  }
+  // The rows are serialized into the write buffer of the socket when the
+  // response is written out, without being staged in a packet per row
+  std::unique_ptr<OutputPacket> pkt(new OutputPacket());
+  pkt->msg_type = NetworkMessageType::DATA_ROW;
+  pkt->num_columns = colcount;
+  pkt->rows = std::move(results);
+  results.clear();
+  responses_.push_back(std::move(pkt));
   traffic_cop_->setRowsAffected(numrows);
 }
 
@@ -1252,12 +1460,17 @@ void PostgresProtocolHandler::SendReadyForQuery(
 void PostgresProtocolHandler::Reset() {
   ProtocolHandler::Reset();
   statement_cache_.Clear();
+  plan_cache_.Clear();
+  plan_cache_fingerprint_.clear();
   result_format_.clear();
   traffic_cop_->Reset();
   txn_state_ = NetworkTransactionStateType::IDLE;
   skipped_stmt_ = false;
   skipped_query_string_.clear();
   portals_.clear();
+  batch_params_.clear();
+  batch_results_.clear();
+  batch_responses_.clear();
 }
 
 }  // namespace network
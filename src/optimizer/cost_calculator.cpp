@@ -14,12 +14,18 @@
 
 #include <cmath>
 
+#include "catalog/column_catalog.h"
+#include "catalog/index_catalog.h"
 #include "catalog/table_catalog.h"
 #include "optimizer/memo.h"
 #include "optimizer/operators.h"
+#include "optimizer/stats/column_stats.h"
 #include "optimizer/stats/cost.h"
+#include "optimizer/stats/selectivity.h"
 #include "optimizer/stats/stats_storage.h"
 #include "optimizer/stats/table_stats.h"
+#include "parser/update_statement.h"
+#include "settings/settings_manager.h"
 
 namespace peloton {
 namespace optimizer {
@@ -29,6 +35,7 @@ double CostCalculator::CalculateCost(GroupExpression *gexpr, Memo *memo,
   gexpr_ = gexpr;
   memo_ = memo;
   txn_ = txn;
+  params_ = CostModel::GetInstance()->GetParameters();
   gexpr_->Op().Accept(this);
   return output_cost_;
 }
@@ -44,9 +51,9 @@ void CostCalculator::Visit(const PhysicalSeqScan *op) {
     output_cost_ = 1.f;
     return;
   }
-  output_cost_ = table_stats->num_rows * DEFAULT_TUPLE_COST;
+  output_cost_ = table_stats->num_rows * params_.tuple_cpu_cost;
 }
-void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalIndexScan *op) {
+void CostCalculator::Visit(const PhysicalIndexScan *op) {
   auto table_stats = std::dynamic_pointer_cast<TableStats>(
       StatsStorage::GetInstance()->GetTableStats(
           op->table_->GetDatabaseOid(), op->table_->GetTableOid(), txn_));
@@ -54,10 +61,18 @@ void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalIndexScan *op) {
     output_cost_ = 0.f;
     return;
   }
-  // Index search cost + scan cost
-  output_cost_ = std::log2(table_stats->num_rows) * DEFAULT_INDEX_TUPLE_COST +
-                 memo_->GetGroupByID(gexpr_->GetGroupID())->GetNumRows() *
-                     DEFAULT_TUPLE_COST;
+  auto index = op->table_->GetIndexCatalogEntries(op->index_id);
+  IndexType index_type =
+      index == nullptr ? IndexType::BWTREE : index->GetIndexType();
+
+  // The index returns the entries matching the key predicates, and each of
+  // them is fetched from the table before the other predicates are evaluated
+  double num_entries = std::max<double>(
+      table_stats->num_rows * IndexScanSelectivity(op, table_stats),
+      GetNumRows(gexpr_->GetGroupID()));
+  output_cost_ =
+      CostModel::IndexSearchCost(params_, index_type, table_stats->num_rows) +
+      num_entries * (params_.random_access_cost + params_.tuple_cpu_cost);
 }
 
 void CostCalculator::Visit(UNUSED_ATTRIBUTE const ExternalFileScan *) {
@@ -74,35 +89,87 @@ void CostCalculator::Visit(const PhysicalLimit *op) {
   auto child_num_rows =
       memo_->GetGroupByID(gexpr_->GetChildGroupId(0))->GetNumRows();
 
-  output_cost_ =
-      std::min((size_t)child_num_rows, (size_t)op->limit) * DEFAULT_TUPLE_COST;
+  output_cost_ = std::min((size_t)child_num_rows, (size_t)op->limit) *
+                 params_.tuple_cpu_cost;
 }
 void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalInnerNLJoin *op) {
-  auto left_child_rows =
-      memo_->GetGroupByID(gexpr_->GetChildGroupId(0))->GetNumRows();
-  auto right_child_rows =
-      memo_->GetGroupByID(gexpr_->GetChildGroupId(1))->GetNumRows();
-
-  output_cost_ = left_child_rows * right_child_rows * DEFAULT_TUPLE_COST;
+  output_cost_ = NestedLoopJoinCost();
+}
+void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalLeftNLJoin *op) {
+  // Left tuples without a match are emitted after their inner loop
+  output_cost_ = NestedLoopJoinCost() +
+                 GetNumRows(gexpr_->GetChildGroupId(0)) * params_.tuple_cpu_cost;
+}
+void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalRightNLJoin *op) {
+  // Right tuples are marked when they match and the unmatched ones are
+  // emitted at the end
+  output_cost_ = NestedLoopJoinCost() +
+                 GetNumRows(gexpr_->GetChildGroupId(1)) * params_.tuple_cpu_cost;
+}
+void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalOuterNLJoin *op) {
+  output_cost_ = NestedLoopJoinCost() +
+                 (GetNumRows(gexpr_->GetChildGroupId(0)) +
+                  GetNumRows(gexpr_->GetChildGroupId(1))) *
+                     params_.tuple_cpu_cost;
 }
-void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalLeftNLJoin *op) {}
-void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalRightNLJoin *op) {}
-void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalOuterNLJoin *op) {}
 void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalInnerHashJoin *op) {
-  auto left_child_rows =
-      memo_->GetGroupByID(gexpr_->GetChildGroupId(0))->GetNumRows();
-  auto right_child_rows =
-      memo_->GetGroupByID(gexpr_->GetChildGroupId(1))->GetNumRows();
-  // TODO(boweic): Build (left) table should have different cost to probe table
-  output_cost_ = (left_child_rows + right_child_rows) * DEFAULT_TUPLE_COST;
-}
-void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalLeftHashJoin *op) {}
-void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalRightHashJoin *op) {}
-void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalOuterHashJoin *op) {}
-void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalInsert *op) {}
-void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalInsertSelect *op) {}
-void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalDelete *op) {}
-void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalUpdate *op) {}
+  // Compiled hash joins build on the left input, the interpreted ones on the
+  // right input
+  output_cost_ = HashJoinCost(
+      settings::SettingsManager::GetBool(settings::SettingId::codegen));
+}
+void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalLeftHashJoin *op) {
+  // Only inner joins are compiled. Probe tuples without a match are emitted
+  // right away.
+  output_cost_ = HashJoinCost(false);
+}
+void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalRightHashJoin *op) {
+  // The build side is scanned for unmatched tuples after the probe
+  output_cost_ = HashJoinCost(false) +
+                 GetNumRows(gexpr_->GetChildGroupId(1)) * params_.tuple_cpu_cost;
+}
+void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalOuterHashJoin *op) {
+  output_cost_ = HashJoinCost(false) +
+                 GetNumRows(gexpr_->GetChildGroupId(1)) * params_.tuple_cpu_cost;
+}
+void CostCalculator::Visit(const PhysicalInsert *op) {
+  double num_rows = op->values == nullptr ? 1 : op->values->size();
+  output_cost_ = num_rows * InsertTupleCost(op->target_table);
+}
+void CostCalculator::Visit(const PhysicalInsertSelect *op) {
+  output_cost_ = GetNumRows(gexpr_->GetChildGroupId(0)) *
+                 InsertTupleCost(op->target_table);
+}
+void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalDelete *op) {
+  // Deletes only install an empty version, the garbage collector cleans up
+  // the indexes later
+  output_cost_ =
+      GetNumRows(gexpr_->GetChildGroupId(0)) * params_.tuple_write_cost;
+}
+void CostCalculator::Visit(const PhysicalUpdate *op) {
+  // A new version of each tuple, and new entries in the indexes whose keys
+  // change
+  double tuple_cost = params_.tuple_write_cost;
+  if (op->updates != nullptr) {
+    std::unordered_set<oid_t> updated_columns;
+    for (auto &update : *op->updates) {
+      auto column = op->target_table->GetColumnCatalogEntry(update->column);
+      if (column != nullptr) updated_columns.insert(column->GetColumnId());
+    }
+    double num_rows = GetTableRows(op->target_table);
+    for (auto &index_entry : op->target_table->GetIndexCatalogEntries()) {
+      auto &index = index_entry.second;
+      for (auto column_id : index->GetKeyAttrs()) {
+        if (updated_columns.count(column_id) != 0) {
+          tuple_cost += CostModel::IndexSearchCost(
+              params_, index->GetIndexType(), num_rows);
+          break;
+        }
+      }
+    }
+  }
+  output_cost_ = GetNumRows(gexpr_->GetChildGroupId(0)) * tuple_cost;
+}
 void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalHashGroupBy *op) {
   // TODO(boweic): Integrate hash in groupby may cause us to miss the
   // opportunity to further optimize some query where the child output is
@@ -127,7 +194,7 @@ double CostCalculator::HashCost() {
   auto child_num_rows =
       memo_->GetGroupByID(gexpr_->GetChildGroupId(0))->GetNumRows();
   // O(tuple)
-  return child_num_rows * DEFAULT_TUPLE_COST;
+  return child_num_rows * params_.hash_build_cost;
 }
 
 double CostCalculator::SortCost() {
@@ -137,15 +204,83 @@ double CostCalculator::SortCost() {
   if (child_num_rows == 0) {
     return 1.0f;
   }
-  // O(tuple * log(tuple))
-  return child_num_rows * std::log2(child_num_rows) * DEFAULT_TUPLE_COST;
+  // Copy the tuples, then O(tuple * log(tuple)) comparisons
+  return child_num_rows * params_.tuple_copy_cost +
+         child_num_rows * std::log2(child_num_rows) * params_.key_compare_cost;
 }
 
 double CostCalculator::GroupByCost() {
   auto child_num_rows =
       memo_->GetGroupByID(gexpr_->GetChildGroupId(0))->GetNumRows();
   // O(tuple)
-  return child_num_rows * DEFAULT_TUPLE_COST;
+  return child_num_rows * params_.tuple_cpu_cost;
+}
+
+double CostCalculator::NestedLoopJoinCost() {
+  double left_child_rows = GetNumRows(gexpr_->GetChildGroupId(0));
+  double right_child_rows = GetNumRows(gexpr_->GetChildGroupId(1));
+  // The inner input is materialized once and evaluated for every outer tuple
+  return right_child_rows * params_.tuple_copy_cost +
+         left_child_rows * right_child_rows * params_.tuple_cpu_cost;
+}
+
+double CostCalculator::HashJoinCost(bool build_left) {
+  double left_child_rows = GetNumRows(gexpr_->GetChildGroupId(0));
+  double right_child_rows = GetNumRows(gexpr_->GetChildGroupId(1));
+  double output_rows = GetNumRows(gexpr_->GetGroupID());
+  double build_rows = build_left ? left_child_rows : right_child_rows;
+  double probe_rows = build_left ? right_child_rows : left_child_rows;
+  return build_rows * params_.hash_build_cost +
+         probe_rows * params_.hash_probe_cost +
+         output_rows * params_.tuple_cpu_cost;
+}
+
+double CostCalculator::InsertTupleCost(
+    const std::shared_ptr<catalog::TableCatalogEntry> &table) {
+  double tuple_cost = params_.tuple_write_cost;
+  double num_rows = GetTableRows(table);
+  for (auto &index_entry : table->GetIndexCatalogEntries()) {
+    tuple_cost += CostModel::IndexSearchCost(
+        params_, index_entry.second->GetIndexType(), num_rows);
+  }
+  return tuple_cost;
+}
+
+double CostCalculator::IndexScanSelectivity(
+    const PhysicalIndexScan *op,
+    const std::shared_ptr<TableStats> &table_stats) {
+  double selectivity = 1;
+  for (size_t i = 0; i < op->key_column_id_list.size(); i++) {
+    auto column_stats =
+        table_stats->GetColumnStats(op->key_column_id_list[i]);
+    auto &value = op->value_list[i];
+    if (column_stats == nullptr) {
+      selectivity *= DEFAULT_SELECTIVITY;
+    } else if (value.GetTypeId() == type::TypeId::PARAMETER_OFFSET) {
+      // The value is only known at execution, so assume an average one
+      selectivity *= op->expr_type_list[i] == ExpressionType::COMPARE_EQUAL &&
+                             column_stats->cardinality > 0
+                         ? 1 / column_stats->cardinality
+                         : DEFAULT_SELECTIVITY;
+    } else {
+      ValueCondition condition(column_stats->column_name,
+                               op->expr_type_list[i], value);
+      selectivity *= Selectivity::ComputeSelectivity(table_stats, condition);
+    }
+  }
+  return selectivity;
+}
+
+double CostCalculator::GetNumRows(GroupID group_id) {
+  return std::max(memo_->GetGroupByID(group_id)->GetNumRows(), 0);
+}
+
+double CostCalculator::GetTableRows(
+    const std::shared_ptr<catalog::TableCatalogEntry> &table) {
+  auto table_stats = std::dynamic_pointer_cast<TableStats>(
+      StatsStorage::GetInstance()->GetTableStats(
+          table->GetDatabaseOid(), table->GetTableOid(), txn_));
+  return table_stats->num_rows;
 }
 }  // namespace optimizer
 }  // namespace peloton
@@ -0,0 +1,328 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// join_order_enumerator.cpp
+//
+// Identification: src/optimizer/join_order_enumerator.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "optimizer/join_order_enumerator.h"
+
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "expression/tuple_value_expression.h"
+#include "optimizer/group_expression.h"
+#include "optimizer/memo.h"
+#include "optimizer/operators.h"
+#include "optimizer/rule.h"
+#include "settings/settings_manager.h"
+
+namespace peloton {
+namespace optimizer {
+
+std::vector<GroupExpression *> JoinOrderEnumerator::Enumerate(
+    GroupID group_id) {
+  new_exprs_.clear();
+  std::vector<GroupID> to_visit = {group_id};
+  std::unordered_set<GroupID> visited;
+  while (!to_visit.empty()) {
+    GroupID curr_group_id = to_visit.back();
+    to_visit.pop_back();
+    if (!visited.insert(curr_group_id).second) continue;
+
+    auto logical_exprs =
+        memo_.GetGroupByID(curr_group_id)->GetLogicalExpressions();
+    if (logical_exprs.empty()) continue;
+    auto gexpr = logical_exprs[0].get();
+    if (gexpr->Op().GetType() != OpType::InnerJoin) {
+      for (auto child_group_id : gexpr->GetChildGroupIDs()) {
+        to_visit.push_back(child_group_id);
+      }
+      continue;
+    }
+
+    JoinBlock block;
+    block.root_group = curr_group_id;
+    CollectJoinBlock(curr_group_id, block);
+    EnumerateJoinBlock(block);
+    // There may be more join blocks below the leaves, e.g., in subqueries
+    for (auto leaf_group_id : block.leaves) {
+      to_visit.push_back(leaf_group_id);
+    }
+  }
+  return new_exprs_;
+}
+
+void JoinOrderEnumerator::CollectJoinBlock(GroupID group_id,
+                                           JoinBlock &block) {
+  auto logical_exprs = memo_.GetGroupByID(group_id)->GetLogicalExpressions();
+  auto gexpr = logical_exprs.empty() ? nullptr : logical_exprs[0].get();
+  if (gexpr == nullptr || gexpr->Op().GetType() != OpType::InnerJoin) {
+    block.leaves.push_back(group_id);
+    return;
+  }
+  auto join = gexpr->Op().As<LogicalInnerJoin>();
+  block.predicates.insert(block.predicates.end(),
+                          join->join_predicates.begin(),
+                          join->join_predicates.end());
+  block.join_exprs.push_back(gexpr);
+  for (auto child_group_id : gexpr->GetChildGroupIDs()) {
+    CollectJoinBlock(child_group_id, block);
+  }
+}
+
+void JoinOrderEnumerator::EnumerateJoinBlock(JoinBlock &block) {
+  // Two tables are ordered by the commutativity rule alone, and the tables
+  // are tracked in a 64-bit set
+  size_t num_leaves = block.leaves.size();
+  if (num_leaves < 3 || num_leaves > 64) return;
+
+  leaf_rows_.clear();
+  std::unordered_map<std::string, size_t> alias_leaves;
+  for (size_t i = 0; i < num_leaves; i++) {
+    auto leaf_group = memo_.GetGroupByID(block.leaves[i]);
+    leaf_rows_.push_back(std::max(leaf_group->GetNumRows(), 1));
+    for (auto &alias : leaf_group->GetTableAliases()) {
+      alias_leaves[alias] = i;
+    }
+  }
+  uint64_t all_tables =
+      num_leaves == 64 ? ~uint64_t(0) : (uint64_t(1) << num_leaves) - 1;
+
+  predicate_tables_.clear();
+  predicate_selectivities_.clear();
+  for (auto &predicate : block.predicates) {
+    uint64_t tables = 0;
+    bool covered = true;
+    for (auto &alias : predicate.table_alias_set) {
+      auto entry = alias_leaves.find(alias);
+      if (entry == alias_leaves.end()) {
+        covered = false;
+      } else {
+        tables |= uint64_t(1) << entry->second;
+      }
+    }
+    // Predicates on no table, or on tables outside of the block, are left to
+    // the root join
+    if (!covered || tables == 0) tables = all_tables;
+    predicate_tables_.push_back(tables);
+
+    // Like the StatsCalculator, only equi-joins of columns are selective
+    double selectivity = 1;
+    auto expr = predicate.expr.get();
+    if (expr->GetExpressionType() == ExpressionType::COMPARE_EQUAL &&
+        expr->GetChild(0)->GetExpressionType() == ExpressionType::VALUE_TUPLE &&
+        expr->GetChild(1)->GetExpressionType() == ExpressionType::VALUE_TUPLE) {
+      auto left = alias_leaves.find(
+          static_cast<const expression::TupleValueExpression *>(
+              expr->GetChild(0))->GetTableName());
+      auto right = alias_leaves.find(
+          static_cast<const expression::TupleValueExpression *>(
+              expr->GetChild(1))->GetTableName());
+      if (left != alias_leaves.end() && right != alias_leaves.end() &&
+          left->second != right->second) {
+        selectivity = 1 / std::max(leaf_rows_[left->second],
+                                   leaf_rows_[right->second]);
+      }
+    }
+    predicate_selectivities_.push_back(selectivity);
+  }
+
+  disable_exploration_ =
+      num_leaves > static_cast<size_t>(settings::SettingsManager::GetInt(
+                       settings::SettingId::join_exploration_limit));
+
+  std::vector<JoinNode> nodes;
+  for (size_t i = 0; i < num_leaves; i++) {
+    nodes.push_back(JoinNode{uint64_t(1) << i, -1, -1});
+  }
+  int root_idx;
+  if (num_leaves <= static_cast<size_t>(settings::SettingsManager::GetInt(
+                        settings::SettingId::join_enumeration_dp_limit))) {
+    root_idx = OrderByDynamicProgramming(nodes);
+  } else {
+    root_idx = OrderGreedily(nodes);
+  }
+  InsertJoinTree(block, nodes, root_idx, true);
+
+  if (disable_exploration_) {
+    for (auto gexpr : block.join_exprs) DisableExploration(gexpr);
+  }
+}
+
+int JoinOrderEnumerator::OrderByDynamicProgramming(
+    std::vector<JoinNode> &nodes) {
+  size_t num_leaves = leaf_rows_.size();
+  uint64_t all_tables = (uint64_t(1) << num_leaves) - 1;
+
+  // The cost of the best join tree of each set of tables, or -1 if the
+  // tables cannot be joined without a cross product, and the tables of the
+  // left input of the tree
+  std::vector<double> costs(all_tables + 1, -1);
+  std::vector<uint64_t> best_left(all_tables + 1, 0);
+  for (size_t i = 0; i < num_leaves; i++) {
+    costs[uint64_t(1) << i] = 0;
+  }
+
+  // Avoid cross products, unless the join graph is not connected
+  bool allow_cross_products = false;
+  while (true) {
+    for (uint64_t tables = 1; tables <= all_tables; tables++) {
+      // Skip the leaves
+      if ((tables & (tables - 1)) == 0) continue;
+      costs[tables] = -1;
+      double rows = EstimateRows(tables);
+
+      // Consider each split once, with the lowest table on the left, since
+      // the memo gets both orders of the inputs
+      uint64_t lowest_table = tables & (~tables + 1);
+      for (uint64_t left = (tables - 1) & tables; left > 0;
+           left = (left - 1) & tables) {
+        if ((left & lowest_table) == 0) continue;
+        uint64_t right = tables ^ left;
+        if (costs[left] < 0 || costs[right] < 0) continue;
+        if (!allow_cross_products && !IsConnected(left, right)) continue;
+        double cost = costs[left] + costs[right] + rows;
+        if (costs[tables] < 0 || cost < costs[tables]) {
+          costs[tables] = cost;
+          best_left[tables] = left;
+        }
+      }
+    }
+    if (costs[all_tables] >= 0 || allow_cross_products) break;
+    allow_cross_products = true;
+  }
+
+  // Build the tree from the best splits
+  std::function<int(uint64_t)> build_tree = [&](uint64_t tables) -> int {
+    if ((tables & (tables - 1)) == 0) {
+      int leaf_idx = 0;
+      while ((tables >>= 1) != 0) leaf_idx++;
+      return leaf_idx;
+    }
+    int left_idx = build_tree(best_left[tables]);
+    int right_idx = build_tree(tables ^ best_left[tables]);
+    nodes.push_back(JoinNode{tables, left_idx, right_idx});
+    return static_cast<int>(nodes.size()) - 1;
+  };
+  return build_tree(all_tables);
+}
+
+int JoinOrderEnumerator::OrderGreedily(std::vector<JoinNode> &nodes) {
+  std::vector<int> inputs;
+  for (size_t i = 0; i < nodes.size(); i++) {
+    inputs.push_back(static_cast<int>(i));
+  }
+
+  while (inputs.size() > 1) {
+    // Join the pair of inputs with the smallest result, preferring pairs
+    // that do not need a cross product
+    size_t best_i = 0, best_j = 1;
+    double best_rows = -1;
+    bool best_connected = false;
+    for (size_t i = 0; i < inputs.size(); i++) {
+      for (size_t j = i + 1; j < inputs.size(); j++) {
+        uint64_t left = nodes[inputs[i]].tables;
+        uint64_t right = nodes[inputs[j]].tables;
+        bool connected = IsConnected(left, right);
+        if (best_connected && !connected) continue;
+        double rows = EstimateRows(left | right);
+        if (best_rows < 0 || (connected && !best_connected) ||
+            rows < best_rows) {
+          best_i = i;
+          best_j = j;
+          best_rows = rows;
+          best_connected = connected;
+        }
+      }
+    }
+
+    nodes.push_back(JoinNode{
+        nodes[inputs[best_i]].tables | nodes[inputs[best_j]].tables,
+        inputs[best_i], inputs[best_j]});
+    inputs[best_i] = static_cast<int>(nodes.size()) - 1;
+    inputs.erase(inputs.begin() + best_j);
+  }
+  return inputs[0];
+}
+
+GroupID JoinOrderEnumerator::InsertJoinTree(const JoinBlock &block,
+                                            const std::vector<JoinNode> &nodes,
+                                            int node_idx, bool is_root) {
+  auto &node = nodes[node_idx];
+  if (node.left < 0) {
+    size_t leaf_idx = 0;
+    for (uint64_t tables = node.tables; (tables >>= 1) != 0;) leaf_idx++;
+    return block.leaves[leaf_idx];
+  }
+  GroupID left_group_id = InsertJoinTree(block, nodes, node.left, false);
+  GroupID right_group_id = InsertJoinTree(block, nodes, node.right, false);
+
+  // A predicate is evaluated by the lowest join that has all its tables.
+  // Predicates on a single table evaluated by the joins in the block stay
+  // right above that table.
+  auto &left = nodes[node.left];
+  auto &right = nodes[node.right];
+  std::vector<AnnotatedExpression> predicates;
+  for (size_t i = 0; i < block.predicates.size(); i++) {
+    uint64_t tables = predicate_tables_[i];
+    if ((tables & ~node.tables) != 0) continue;
+    if (left.left >= 0 && (tables & ~left.tables) == 0) continue;
+    if (right.left >= 0 && (tables & ~right.tables) == 0) continue;
+    predicates.push_back(block.predicates[i]);
+  }
+
+  // Add both orders of the inputs to the same group
+  GroupID group_id = is_root ? block.root_group : UNDEFINED_GROUP;
+  std::vector<std::vector<GroupID>> child_orders = {
+      {left_group_id, right_group_id}, {right_group_id, left_group_id}};
+  for (auto &child_groups : child_orders) {
+    std::vector<AnnotatedExpression> join_predicates(predicates);
+    auto gexpr = std::make_shared<GroupExpression>(
+        LogicalInnerJoin::make(join_predicates), child_groups);
+    auto inserted = memo_.InsertExpression(gexpr, group_id, false);
+    if (inserted == gexpr.get()) new_exprs_.push_back(inserted);
+    if (disable_exploration_) DisableExploration(inserted);
+    if (group_id == UNDEFINED_GROUP) group_id = gexpr->GetGroupID();
+  }
+  return group_id;
+}
+
+double JoinOrderEnumerator::EstimateRows(uint64_t tables) const {
+  double rows = 1;
+  for (size_t i = 0; i < leaf_rows_.size(); i++) {
+    if ((tables & (uint64_t(1) << i)) != 0) rows *= leaf_rows_[i];
+  }
+  for (size_t i = 0; i < predicate_tables_.size(); i++) {
+    if ((predicate_tables_[i] & ~tables) == 0) {
+      rows *= predicate_selectivities_[i];
+    }
+  }
+  return std::max(rows, 1.0);
+}
+
+bool JoinOrderEnumerator::IsConnected(uint64_t left, uint64_t right) const {
+  for (auto tables : predicate_tables_) {
+    if ((tables & ~(left | right)) == 0 && (tables & left) != 0 &&
+        (tables & right) != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void JoinOrderEnumerator::DisableExploration(GroupExpression *gexpr) {
+  for (auto &rule : rule_set_.GetTransformationRules()) {
+    if (rule->IsLogical()) gexpr->SetRuleExplored(rule.get());
+  }
+}
+
+}  // namespace optimizer
+}  // namespace peloton
@@ -21,7 +21,7 @@ namespace optimizer {
 //===--------------------------------------------------------------------===//
 // Memo
 //===--------------------------------------------------------------------===//
-Memo::Memo() {}
+Memo::Memo() : latch_(new common::synchronization::ReadWriteLatch()) {}
 
 GroupExpression *Memo::InsertExpression(std::shared_ptr<GroupExpression> gexpr,
                                         bool enforced) {
@@ -40,10 +40,12 @@ GroupExpression *Memo::InsertExpression(std::shared_ptr<GroupExpression> gexpr,
   }
 
   // Lookup in hash table
+  latch_->WriteLock();
   auto it = group_expressions_.find(gexpr.get());
 
   if (it != group_expressions_.end()) {
     gexpr->SetGroupID((*it)->GetGroupID());
+    latch_->Unlock();
     return *it;
   } else {
     group_expressions_.insert(gexpr.get());
@@ -55,8 +57,9 @@ GroupExpression *Memo::InsertExpression(std::shared_ptr<GroupExpression> gexpr,
     } else {
       group_id = target_group;
     }
-    Group *group = GetGroupByID(group_id);
+    Group *group = groups_[group_id].get();
     group->AddExpression(gexpr, enforced);
+    latch_->Unlock();
     return gexpr.get();
   }
 }
@@ -65,7 +68,12 @@ std::vector<std::unique_ptr<Group>> &Memo::Groups() {
   return groups_;
 }
 
-Group *Memo::GetGroupByID(GroupID id) { return groups_[id].get(); }
+Group *Memo::GetGroupByID(GroupID id) {
+  latch_->ReadLock();
+  Group *group = groups_[id].get();
+  latch_->Unlock();
+  return group;
+}
 
 const std::string Memo::GetInfo(int num_indent) const {
     std::ostringstream os;
@@ -103,7 +111,7 @@ GroupID Memo::AddNewGroup(std::shared_ptr<GroupExpression> gexpr) {
   } else {
     // For other groups, need to aggregate the table alias from children
     for (auto child_group_id : gexpr->GetChildGroupIDs()) {
-      Group *child_group = GetGroupByID(child_group_id);
+      Group *child_group = groups_[child_group_id].get();
       for (auto &table_alias : child_group->GetTableAliases()) {
         table_aliases.insert(table_alias);
       }
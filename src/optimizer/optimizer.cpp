@@ -41,6 +41,7 @@
 #include "planner/populate_index_plan.h"
 #include "planner/projection_plan.h"
 #include "planner/seq_scan_plan.h"
+#include "settings/settings_manager.h"
 
 #include "storage/data_table.h"
 
@@ -77,10 +78,32 @@ void Optimizer::OptimizeLoop(int root_group_id,
 
   ExecuteTaskStack(*task_stack, root_group_id, root_context);
 
+  // Tasks optimizing in parallel read the catalog entries of the tables, so
+  // load them all up front
+  if (settings::SettingsManager::GetBool(
+          settings::SettingId::parallel_optimization)) {
+    for (auto &group : metadata_.memo.Groups()) {
+      for (auto &gexpr : group->GetLogicalExpressions()) {
+        if (gexpr->Op().GetType() != OpType::Get) continue;
+        auto &table = gexpr->Op().As<LogicalGet>()->table;
+        if (table == nullptr) continue;
+        table->GetColumnCatalogEntries();
+        table->GetIndexCatalogEntries();
+      }
+    }
+  }
+
   // Perform optimization after the rewrite
   task_stack->Push(new OptimizeGroup(metadata_.memo.GetGroupByID(root_group_id),
                                      root_context));
 
+  // Seed the memo with good join orders once the stats of the tables are
+  // known, so that large joins need not be explored rule by rule
+  if (settings::SettingsManager::GetBool(
+          settings::SettingId::join_order_enumeration)) {
+    task_stack->Push(new EnumerateJoinOrders(root_group_id, root_context));
+  }
+
   // Derive stats for the only one logical expression before optimizing
   task_stack->Push(new DeriveStats(
       metadata_.memo.GetGroupByID(root_group_id)->GetLogicalExpression(),
@@ -367,6 +390,9 @@ unique_ptr<planner::AbstractPlan> Optimizer::ChooseBestPlan(
   auto plan = generator.ConvertOpExpression(op, required_props, required_cols,
                                             output_cols, children_plans,
                                             children_expr_map);
+  if (plan != nullptr && group->GetNumRows() >= 0) {
+    plan->SetEstimatedRows(group->GetNumRows());
+  }
 
   LOG_TRACE("Finish Choosing best plan for group %d", id);
   return plan;
@@ -375,10 +401,9 @@ unique_ptr<planner::AbstractPlan> Optimizer::ChooseBestPlan(
 void Optimizer::ExecuteTaskStack(
     OptimizerTaskStack &task_stack, int root_group_id,
     std::shared_ptr<OptimizeContext> root_context) {
-  auto root_group = metadata_.memo.GetGroupByID(root_group_id);
   auto &timer = metadata_.timer;
-  const auto timeout_limit = metadata_.timeout_limit;
-  const auto &required_props = root_context->required_prop;
+  metadata_.root_group_id = root_group_id;
+  metadata_.root_required_props = root_context->required_prop;
 
   if (timer.GetInvocations() == 0) {
     timer.Start();
@@ -387,13 +412,7 @@ void Optimizer::ExecuteTaskStack(
   while (!task_stack.Empty()) {
     // Check to see if we have at least one plan, and if we have exceeded our
     // timeout limit
-    if (timer.GetDuration() >= timeout_limit &&
-        root_group->HasExpressions(required_props)) {
-      throw OptimizerException("Optimizer task execution duration " +
-                               std::to_string(timer.GetDuration()) +
-                               " exceeds timeout limit " +
-                               std::to_string(timeout_limit));
-    }
+    metadata_.CheckTimeout(timer.GetDuration());
     timer.Reset();
     auto task = task_stack.Pop();
     task->execute();
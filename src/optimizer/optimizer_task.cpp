@@ -12,6 +12,10 @@
 
 #include "optimizer/optimizer_task.h"
 
+#include <atomic>
+#include <exception>
+
+#include "common/synchronization/count_down_latch.h"
 #include "optimizer/property_enforcer.h"
 #include "optimizer/optimizer_metadata.h"
 #include "optimizer/binding.h"
@@ -19,6 +23,10 @@
 #include "optimizer/cost_calculator.h"
 #include "optimizer/stats_calculator.h"
 #include "optimizer/child_stats_deriver.h"
+#include "optimizer/join_order_enumerator.h"
+#include "optimizer/optimize_context.h"
+#include "settings/settings_manager.h"
+#include "threadpool/mono_queue_pool.h"
 
 namespace peloton {
 namespace optimizer {
@@ -48,7 +56,11 @@ void OptimizerTask::ConstructValidRules(
 }
 
 void OptimizerTask::PushTask(OptimizerTask *task) {
-  context_->metadata->task_pool->Push(task);
+  if (context_->task_pool != nullptr) {
+    context_->task_pool->Push(task);
+  } else {
+    context_->metadata->task_pool->Push(task);
+  }
 }
 
 Memo &OptimizerTask::GetMemo() const { return context_->metadata->memo; }
@@ -252,11 +264,25 @@ void DeriveStats::execute() {
     return;
   }
 
-  StatsCalculator calculator;
-  calculator.CalculateStats(gexpr_, required_cols_, &context_->metadata->memo,
-                            context_->metadata->txn);
+  {
+    std::lock_guard<std::mutex> lock(*context_->metadata->txn_latch);
+    StatsCalculator calculator;
+    calculator.CalculateStats(gexpr_, required_cols_,
+                              &context_->metadata->memo,
+                              context_->metadata->txn);
+  }
   gexpr_->SetDerivedStats();
 }
+
+//===--------------------------------------------------------------------===//
+// EnumerateJoinOrders
+//===--------------------------------------------------------------------===//
+void EnumerateJoinOrders::execute() {
+  JoinOrderEnumerator enumerator(GetMemo(), GetRuleSet());
+  for (auto gexpr : enumerator.Enumerate(group_id_)) {
+    PushTask(new DeriveStats(gexpr, ExprSet{}, context_));
+  }
+}
 //===--------------------------------------------------------------------===//
 // OptimizeInputs
 //===--------------------------------------------------------------------===//
@@ -295,9 +321,18 @@ void OptimizeInputs::execute() {
       // Compute the cost of the root operator
       // 1. Collect stats needed and cache them in the group
       // 2. Calculate cost based on children's stats
-      CostCalculator cost_calculator;
-      cur_total_cost_ += cost_calculator.CalculateCost(
-          group_expr_, &context_->metadata->memo, context_->metadata->txn);
+      {
+        std::lock_guard<std::mutex> lock(*context_->metadata->txn_latch);
+        CostCalculator cost_calculator;
+        cur_total_cost_ += cost_calculator.CalculateCost(
+            group_expr_, &context_->metadata->memo, context_->metadata->txn);
+      }
+
+      if (pre_child_idx_ == -1 &&
+          settings::SettingsManager::GetBool(
+              settings::SettingId::parallel_optimization)) {
+        OptimizeChildrenInParallel(input_props);
+      }
     }
 
     for (; cur_child_idx_ < (int)group_expr_->GetChildrenGroupsSize();
@@ -320,7 +355,8 @@ void OptimizeInputs::execute() {
         PushTask(new OptimizeGroup(
             child_group, std::make_shared<OptimizeContext>(
                              context_->metadata, i_prop,
-                             context_->cost_upper_bound - cur_total_cost_)));
+                             context_->cost_upper_bound - cur_total_cost_,
+                             context_->task_pool)));
         return;
       } else {  // If we return from OptimizeGroup, then there is no expr for
                 // the context
@@ -370,6 +406,7 @@ void OptimizeInputs::execute() {
           // Cost the enforced expression
           auto extended_prop_set =
               std::make_shared<PropertySet>(extended_output_properties);
+          std::lock_guard<std::mutex> lock(*context_->metadata->txn_latch);
           CostCalculator cost_calculator;
           cur_total_cost_ += cost_calculator.CalculateCost(
               memo_enforced_expr, &context_->metadata->memo,
@@ -407,6 +444,87 @@ void OptimizeInputs::execute() {
   }
 }
 
+void OptimizeInputs::OptimizeChildrenInParallel(
+    const std::vector<std::shared_ptr<PropertySet>> &input_props) {
+  // Children over disjoint tables share no groups below them, so no group is
+  // modified by two threads and each is optimized as it is sequentially
+  struct ChildJob {
+    Group *group;
+    std::shared_ptr<OptimizeContext> context;
+  };
+  std::vector<ChildJob> jobs;
+  std::unordered_set<std::string> table_aliases;
+  for (size_t idx = 0; idx < group_expr_->GetChildrenGroupsSize(); idx++) {
+    auto child_group = GetMemo().GetGroupByID(group_expr_->GetChildGroupId(idx));
+    auto &child_aliases = child_group->GetTableAliases();
+    if (child_aliases.empty()) return;
+    for (auto &alias : child_aliases) {
+      if (!table_aliases.insert(alias).second) return;
+    }
+    auto i_prop = input_props[idx];
+    if (child_group->GetBestExpression(i_prop) == nullptr) {
+      jobs.push_back({child_group, std::make_shared<OptimizeContext>(
+                                       context_->metadata, i_prop,
+                                       context_->cost_upper_bound -
+                                           cur_total_cost_,
+                                       context_->task_pool)});
+    }
+  }
+  auto &worker_pool = threadpool::MonoQueuePool::GetExecutionInstance();
+  if (jobs.size() < 2 || worker_pool.NumWorkers() == 0) return;
+
+  // Shared with the worker tasks, which may outlive this call when they find
+  // all jobs taken
+  struct ForkJoin {
+    explicit ForkJoin(std::vector<ChildJob> jobs)
+        : jobs(std::move(jobs)), latch(this->jobs.size()) {}
+    std::vector<ChildJob> jobs;
+    std::atomic<size_t> next_job{0};
+    common::synchronization::CountDownLatch latch;
+    std::atomic<bool> failed{false};
+    std::mutex error_lock;
+    std::exception_ptr error;
+  };
+  auto fork_join = std::make_shared<ForkJoin>(std::move(jobs));
+  auto metadata = context_->metadata;
+  auto work = [metadata](std::shared_ptr<ForkJoin> state) {
+    size_t job_id;
+    while ((job_id = state->next_job++) < state->jobs.size()) {
+      auto &job = state->jobs[job_id];
+      try {
+        OptimizerTaskStack task_stack;
+        job.context->task_pool = &task_stack;
+        task_stack.Push(new OptimizeGroup(job.group, job.context));
+        while (!task_stack.Empty() && !state->failed) {
+          // The timer of the metadata is stopped by the task that forked,
+          // once all jobs are done, so the time is read from a copy
+          auto timer = metadata->timer;
+          timer.Reset();
+          timer.Stop();
+          metadata->CheckTimeout(timer.GetDuration());
+          task_stack.Pop()->execute();
+        }
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(state->error_lock);
+        if (state->error == nullptr) state->error = std::current_exception();
+        state->failed = true;
+      }
+      state->latch.CountDown();
+    }
+  };
+
+  // The calling thread works on the jobs too, so nested forks always make
+  // progress even when all workers are busy
+  size_t num_helpers = std::min<size_t>(worker_pool.NumWorkers(),
+                                        fork_join->jobs.size() - 1);
+  for (size_t i = 0; i < num_helpers; i++) {
+    worker_pool.SubmitTask([work, fork_join]() { work(fork_join); });
+  }
+  work(fork_join);
+  fork_join->latch.Await(0);
+  if (fork_join->error != nullptr) std::rethrow_exception(fork_join->error);
+}
+
 void TopDownRewrite::execute() {
   std::vector<RuleWithPromise> valid_rules;
 
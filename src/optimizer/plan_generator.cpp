@@ -20,6 +20,7 @@
 #include "expression/expression_util.h"
 #include "optimizer/operator_expression.h"
 #include "optimizer/properties.h"
+#include "optimizer/stats/cardinality_feedback.h"
 #include "planner/aggregate_plan.h"
 #include "planner/csv_scan_plan.h"
 #include "planner/delete_plan.h"
@@ -37,6 +38,7 @@
 #include "settings/settings_manager.h"
 #include "storage/data_table.h"
 #include "storage/storage_manager.h"
+#include "type/type.h"
 
 using std::vector;
 using std::make_pair;
@@ -110,6 +112,10 @@ void PlanGenerator::Visit(const PhysicalSeqScan *op) {
   output_plan_.reset(new planner::SeqScanPlan(data_table, predicate.release(),
                                               column_ids, op->is_for_update,
                                               parallel_scan));
+  output_plan_->SetCardinalityFeedbackKey(
+      CardinalityFeedback::GetPredicateSignature(
+          op->table_->GetDatabaseOid(), op->table_->GetTableOid(),
+          op->predicates));
 }
 
 void PlanGenerator::Visit(const PhysicalIndexScan *op) {
@@ -128,6 +134,10 @@ void PlanGenerator::Visit(const PhysicalIndexScan *op) {
       storage::StorageManager::GetInstance()->GetTableWithOid(
           op->table_->GetDatabaseOid(), op->table_->GetTableOid()),
       predicate.release(), column_ids, index_scan_desc, false));
+  output_plan_->SetCardinalityFeedbackKey(
+      CardinalityFeedback::GetPredicateSignature(
+          op->table_->GetDatabaseOid(), op->table_->GetTableOid(),
+          op->predicates));
 }
 
 void PlanGenerator::Visit(const ExternalFileScan *op) {
@@ -158,6 +168,10 @@ void PlanGenerator::Visit(const QueryDerivedScan *) {
 void PlanGenerator::Visit(const PhysicalLimit *op) {
   // Generate order by + limit plan when there's internal sort order
   output_plan_ = std::move(children_plans_[0]);
+  if (output_plan_->GetPlanNodeType() == PlanNodeType::INDEXSCAN) {
+    PushLimitIntoIndexScan(
+        op, static_cast<planner::IndexScanPlan *>(output_plan_.get()));
+  }
   if (!op->sort_exprs.empty()) {
     vector<oid_t> column_ids;
     PELOTON_ASSERT(children_expr_map_.size() == 1);
@@ -187,6 +201,45 @@ void PlanGenerator::Visit(const PhysicalLimit *op) {
   output_plan_ = std::move(limit_plan);
 }
 
+void PlanGenerator::PushLimitIntoIndexScan(
+    const PhysicalLimit *op, planner::IndexScanPlan *index_scan_plan) {
+  if (op->limit < 0 || op->offset < 0) return;
+
+  bool descend = false;
+  if (!op->sort_exprs.empty()) {
+    auto table = index_scan_plan->GetTable();
+    auto index = table->GetIndexWithOid(index_scan_plan->GetIndexId());
+    auto &key_attrs = index->GetMetadata()->GetKeyAttrs();
+    // Hash indexes do not keep their keys in order
+    if (index->GetIndexMethodType() == IndexType::HASH ||
+        op->sort_exprs.size() > key_attrs.size()) {
+      return;
+    }
+
+    descend = !op->sort_acsending[0];
+    for (size_t idx = 0; idx < op->sort_exprs.size(); ++idx) {
+      auto sort_expr = op->sort_exprs[idx];
+      if (sort_expr->GetExpressionType() != ExpressionType::VALUE_TUPLE ||
+          op->sort_acsending[idx] == descend) {
+        return;
+      }
+      auto &bound_oid =
+          static_cast<const expression::TupleValueExpression *>(sort_expr)
+              ->GetBoundOid();
+      if (std::get<1>(bound_oid) != table->GetOid() ||
+          std::get<2>(bound_oid) != key_attrs[idx]) {
+        return;
+      }
+    }
+  }
+
+  // The limit and order by plans above still apply the offset and limit
+  index_scan_plan->SetLimit(true);
+  index_scan_plan->SetLimitNumber(op->limit);
+  index_scan_plan->SetLimitOffset(op->offset);
+  index_scan_plan->SetDescend(descend);
+}
+
 void PlanGenerator::Visit(const PhysicalOrderBy *) {
   vector<oid_t> column_ids;
   PELOTON_ASSERT(children_expr_map_.size() == 1);
@@ -324,10 +377,12 @@ void PlanGenerator::Visit(const PhysicalInnerHashJoin *op) {
   unique_ptr<planner::HashPlan> hash_plan(new planner::HashPlan(hash_keys));
   hash_plan->AddChild(move(children_plans_[1]));
 
-  auto join_plan = unique_ptr<planner::AbstractPlan>(new planner::HashJoinPlan(
+  unique_ptr<planner::HashJoinPlan> join_plan(new planner::HashJoinPlan(
       JoinType::INNER, move(join_predicate), move(proj_info), proj_schema,
       left_keys, right_keys, settings::SettingsManager::GetBool(
                                  settings::SettingId::hash_join_bloom_filter)));
+  join_plan->SetRadixPartitionedFlag(
+      UseRadixPartitionedHashJoin(*children_plans_[0], l_child_map[0]));
 
   join_plan->AddChild(move(children_plans_[0]));
   join_plan->AddChild(move(hash_plan));
@@ -336,6 +391,31 @@ void PlanGenerator::Visit(const PhysicalInnerHashJoin *op) {
 
 void PlanGenerator::Visit(const PhysicalLeftHashJoin *) {}
 
+bool PlanGenerator::UseRadixPartitionedHashJoin(
+    const planner::AbstractPlan &build_plan, const ExprMap &build_cols) const {
+  // Only partitioned joins can spill to disk, which a memory budget needs
+  // whatever the estimates are
+  if (settings::SettingsManager::GetInt(
+          settings::SettingId::query_memory_budget) != 0) {
+    return true;
+  }
+
+  auto threshold_kb = settings::SettingsManager::GetInt(
+      settings::SettingId::hash_join_radix_threshold);
+  if (threshold_kb == 0 || build_plan.GetEstimatedRows() <= 0) {
+    return false;
+  }
+
+  // A hash table entry has a hash and a next pointer before the columns.
+  // Strings are stored as a pointer and a length.
+  double entry_size = sizeof(uint64_t) + sizeof(void *);
+  for (const auto &col : build_cols) {
+    auto type_size = type::Type::GetTypeSize(col.first->GetValueType());
+    entry_size += type_size > 0 ? type_size : sizeof(char *) + sizeof(uint32_t);
+  }
+  return build_plan.GetEstimatedRows() * entry_size > threshold_kb * 1024.0;
+}
+
 void PlanGenerator::Visit(const PhysicalRightHashJoin *) {}
 
 void PlanGenerator::Visit(const PhysicalOuterHashJoin *) {}
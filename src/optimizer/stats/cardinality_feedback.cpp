@@ -0,0 +1,148 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// cardinality_feedback.cpp
+//
+// Identification: src/optimizer/stats/cardinality_feedback.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "optimizer/stats/cardinality_feedback.h"
+
+#include <algorithm>
+
+#include "expression/abstract_expression.h"
+#include "expression/constant_value_expression.h"
+#include "expression/expression_util.h"
+#include "expression/tuple_value_expression.h"
+
+namespace peloton {
+namespace optimizer {
+
+namespace {
+
+// The weight of the latest execution in the moving average, so that the
+// feedback follows changes in the data without flapping on outliers
+const double kFeedbackWeight = 0.5;
+
+// The number of signatures kept before the feedback is reset, which bounds
+// the memory used by workloads with many ad-hoc query shapes
+const size_t kMaxSignatures = 10000;
+
+}  // namespace
+
+CardinalityFeedback *CardinalityFeedback::GetInstance() {
+  static CardinalityFeedback cardinality_feedback;
+  return &cardinality_feedback;
+}
+
+std::string CardinalityFeedback::GetPredicateSignature(
+    oid_t database_oid, oid_t table_oid,
+    const std::vector<AnnotatedExpression> &predicates) {
+  if (predicates.empty()) return "";
+
+  std::vector<std::string> conjuncts;
+  for (auto &annotated_expr : predicates) {
+    std::string conjunct;
+    if (!AppendExpressionSignature(annotated_expr.expr.get(), false,
+                                   conjunct)) {
+      return "";
+    }
+    conjuncts.push_back(std::move(conjunct));
+  }
+  std::sort(conjuncts.begin(), conjuncts.end());
+
+  std::string signature =
+      std::to_string(database_oid) + "." + std::to_string(table_oid) + ":";
+  for (size_t i = 0; i < conjuncts.size(); i++) {
+    if (i > 0) signature += "&";
+    signature += conjuncts[i];
+  }
+  return signature;
+}
+
+bool CardinalityFeedback::AppendExpressionSignature(
+    const expression::AbstractExpression *expr, bool in_equality,
+    std::string &signature) {
+  switch (expr->GetExpressionType()) {
+    case ExpressionType::VALUE_TUPLE: {
+      auto tuple_value =
+          static_cast<const expression::TupleValueExpression *>(expr);
+      signature += "$" + std::to_string(std::get<2>(tuple_value->GetBoundOid()));
+      return true;
+    }
+    case ExpressionType::VALUE_CONSTANT: {
+      // Prefix the value with its length, so that no value can be mistaken
+      // for the rest of the signature
+      auto value =
+          static_cast<const expression::ConstantValueExpression *>(expr)
+              ->GetValue()
+              .ToString();
+      signature += "'" + std::to_string(value.size()) + ":" + value;
+      return true;
+    }
+    case ExpressionType::VALUE_PARAMETER:
+      // The selectivity of an equality hardly depends on the value compared
+      // to, but that of a range does, so only equalities share the feedback
+      // of all their parameter values
+      signature += "?";
+      return in_equality;
+    default:
+      break;
+  }
+  // Arithmetic on a parameter keeps it part of the equality above
+  in_equality =
+      expr->GetExpressionType() == ExpressionType::COMPARE_EQUAL ||
+      (in_equality &&
+       expression::ExpressionUtil::IsOperatorExpression(
+           expr->GetExpressionType()));
+  signature += ExpressionTypeToString(expr->GetExpressionType(), true);
+  signature += "(";
+  for (size_t i = 0; i < expr->GetChildrenSize(); i++) {
+    if (i > 0) signature += ",";
+    if (!AppendExpressionSignature(expr->GetChild(i), in_equality,
+                                   signature)) {
+      return false;
+    }
+  }
+  signature += ")";
+  return true;
+}
+
+void CardinalityFeedback::RecordCardinality(const std::string &signature,
+                                            size_t actual_rows,
+                                            size_t table_rows) {
+  if (signature.empty() || table_rows == 0) return;
+  double selectivity =
+      std::min(1.0, static_cast<double>(actual_rows) / table_rows);
+
+  std::lock_guard<std::mutex> lock(feedback_lock_);
+  auto entry = selectivities_.find(signature);
+  if (entry != selectivities_.end()) {
+    entry->second = kFeedbackWeight * selectivity +
+                    (1 - kFeedbackWeight) * entry->second;
+    return;
+  }
+  if (selectivities_.size() >= kMaxSignatures) selectivities_.clear();
+  selectivities_.emplace(signature, selectivity);
+}
+
+bool CardinalityFeedback::GetSelectivity(const std::string &signature,
+                                         double &selectivity) {
+  std::lock_guard<std::mutex> lock(feedback_lock_);
+  auto entry = selectivities_.find(signature);
+  if (entry == selectivities_.end()) return false;
+  selectivity = entry->second;
+  return true;
+}
+
+void CardinalityFeedback::Clear() {
+  std::lock_guard<std::mutex> lock(feedback_lock_);
+  selectivities_.clear();
+}
+
+}  // namespace optimizer
+}  // namespace peloton
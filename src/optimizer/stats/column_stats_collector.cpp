@@ -52,6 +52,26 @@ void ColumnStatsCollector::AddValue(const type::Value &value) {
   }
 }
 
+void ColumnStatsCollector::Merge(const ColumnStatsCollector &other) {
+  PELOTON_ASSERT(column_type_ == other.column_type_);
+  total_count_ += other.total_count_;
+  null_count_ += other.null_count_;
+  hll_.Merge(other.hll_);
+  hist_.Merge(other.hist_);
+  topk_.Merge(other.topk_);
+}
+
+std::vector<ColumnStatsCollector::ValueFrequencyPair>
+ColumnStatsCollector::GetCommonValueAndFrequency() {
+  std::vector<ValueFrequencyPair> common_values = topk_.GetAllOrderedMaxFirst();
+  if (frequency_scale_ != 1.0) {
+    for (auto &common_value : common_values) {
+      common_value.second *= frequency_scale_;
+    }
+  }
+  return common_values;
+}
+
 double ColumnStatsCollector::GetFracNull() {
   if (total_count_ == 0) {
     LOG_TRACE("Cannot calculate stats for table size 0.");
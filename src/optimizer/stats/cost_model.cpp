@@ -0,0 +1,229 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// cost_model.cpp
+//
+// Identification: src/optimizer/stats/cost_model.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "optimizer/stats/cost_model.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "common/logger.h"
+#include "common/timer.h"
+#include "optimizer/stats/cost.h"
+
+namespace peloton {
+namespace optimizer {
+
+namespace {
+
+const size_t kNumTuples = 1 << 18;
+// Larger than the caches, so following pointers through it misses
+const size_t kNumPointers = 1 << 22;
+const size_t kTupleWidth = 8;
+const size_t kNodeSize = 128;
+const int kNumRuns = 3;
+
+// Results of the microbenchmarks are written here so they are not optimized
+// away
+volatile uint64_t benchmark_sink;
+
+inline uint64_t HashKey(uint64_t key) {
+  key ^= key >> 33;
+  key *= 0xff51afd7ed558ccdULL;
+  key ^= key >> 33;
+  return key;
+}
+
+/** Run the benchmark a few times and return the fastest run in ns per op */
+template <typename Benchmark>
+double TimeBenchmark(size_t num_ops, Benchmark benchmark) {
+  double best = std::numeric_limits<double>::max();
+  for (int run = 0; run < kNumRuns; run++) {
+    Timer<std::nano> timer;
+    timer.Start();
+    benchmark_sink = benchmark();
+    timer.Stop();
+    best = std::min(best, timer.GetDuration() / num_ops);
+  }
+  return std::max(best, 0.01);
+}
+
+}  // namespace
+
+CostModel *CostModel::GetInstance() {
+  static CostModel cost_model;
+  return &cost_model;
+}
+
+CostModelParameters CostModel::GetDefaultParameters() {
+  CostModelParameters parameters;
+  parameters.tuple_cpu_cost = DEFAULT_TUPLE_COST;
+  parameters.tuple_copy_cost = 0.005;
+  parameters.hash_build_cost = 0.02;
+  parameters.hash_probe_cost = 0.015;
+  parameters.random_access_cost = 0.02;
+  parameters.key_compare_cost = 0.002;
+  parameters.tuple_write_cost = 0.05;
+  return parameters;
+}
+
+CostModelParameters CostModel::GetParameters() {
+  std::lock_guard<std::mutex> lock(parameters_lock_);
+  return parameters_;
+}
+
+void CostModel::SetParameters(const CostModelParameters &parameters) {
+  std::lock_guard<std::mutex> lock(parameters_lock_);
+  parameters_ = parameters;
+}
+
+void CostModel::Calibrate() {
+  std::mt19937_64 rng(15721);
+  std::vector<uint64_t> tuples(kNumTuples * kTupleWidth);
+  for (auto &value : tuples) value = rng();
+  std::vector<uint64_t> copies(tuples.size());
+
+  // Scan the tuples and evaluate a predicate on each
+  double scan_ns = TimeBenchmark(kNumTuples, [&tuples] {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < kNumTuples; i++) {
+      const uint64_t *tuple = &tuples[i * kTupleWidth];
+      if (tuple[1] > tuple[2]) sum += tuple[0];
+    }
+    return sum;
+  });
+
+  // Copy the tuples, as sorts and materializing operators do
+  double copy_ns = TimeBenchmark(kNumTuples, [&tuples, &copies] {
+    for (size_t i = 0; i < kNumTuples; i++) {
+      std::memcpy(&copies[i * kTupleWidth], &tuples[i * kTupleWidth],
+                  kTupleWidth * sizeof(uint64_t));
+    }
+    return copies[kNumTuples / 2 * kTupleWidth];
+  });
+
+  // Write the tuples as new versions, which also installs a header atomically
+  std::vector<std::atomic<uint64_t>> headers(kNumTuples);
+  double write_ns = TimeBenchmark(kNumTuples, [&tuples, &copies, &headers] {
+    for (size_t i = 0; i < kNumTuples; i++) {
+      std::memcpy(&copies[i * kTupleWidth], &tuples[i * kTupleWidth],
+                  kTupleWidth * sizeof(uint64_t));
+      uint64_t expected = headers[i].load();
+      headers[i].compare_exchange_strong(expected, expected + 1);
+    }
+    return headers[kNumTuples / 2].load();
+  });
+
+  // Build and probe an open addressing hash table on the first column
+  size_t num_slots = kNumTuples * 2;
+  std::vector<uint64_t> slots(num_slots);
+  double build_ns = TimeBenchmark(kNumTuples, [&tuples, &slots, num_slots] {
+    std::fill(slots.begin(), slots.end(), 0);
+    for (size_t i = 0; i < kNumTuples; i++) {
+      uint64_t key = tuples[i * kTupleWidth] | 1;
+      size_t slot = HashKey(key) & (num_slots - 1);
+      while (slots[slot] != 0) slot = (slot + 1) & (num_slots - 1);
+      slots[slot] = key;
+    }
+    return slots[0];
+  });
+  double probe_ns = TimeBenchmark(kNumTuples, [&tuples, &slots, num_slots] {
+    uint64_t matches = 0;
+    for (size_t i = 0; i < kNumTuples; i++) {
+      uint64_t key = tuples[i * kTupleWidth] | 1;
+      size_t slot = HashKey(key) & (num_slots - 1);
+      while (slots[slot] != 0 && slots[slot] != key) {
+        slot = (slot + 1) & (num_slots - 1);
+      }
+      matches += slots[slot] == key;
+    }
+    return matches;
+  });
+
+  // Chase pointers through a random cycle, as index traversals do
+  std::vector<uint32_t> next(kNumPointers);
+  for (size_t i = 0; i < kNumPointers; i++) next[i] = i;
+  for (size_t i = kNumPointers - 1; i > 0; i--) {
+    std::swap(next[i], next[rng() % i]);
+  }
+  double random_ns = TimeBenchmark(kNumTuples, [&next] {
+    uint32_t position = 0;
+    for (size_t i = 0; i < kNumTuples; i++) position = next[position];
+    return position;
+  });
+
+  // Binary search a node of an index for random keys
+  std::vector<uint64_t> node(tuples.begin(), tuples.begin() + kNodeSize);
+  std::sort(node.begin(), node.end());
+  double search_ns = TimeBenchmark(kNumTuples, [&tuples, &node] {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < kNumTuples; i++) {
+      sum += std::lower_bound(node.begin(), node.end(),
+                              tuples[i * kTupleWidth + 1]) -
+             node.begin();
+    }
+    return sum;
+  });
+  double compare_ns = search_ns / std::log2(kNodeSize);
+
+  CostModelParameters parameters;
+  double unit = DEFAULT_TUPLE_COST / scan_ns;
+  parameters.tuple_cpu_cost = DEFAULT_TUPLE_COST;
+  parameters.tuple_copy_cost = copy_ns * unit;
+  parameters.hash_build_cost = build_ns * unit;
+  parameters.hash_probe_cost = probe_ns * unit;
+  parameters.random_access_cost = random_ns * unit;
+  parameters.key_compare_cost = compare_ns * unit;
+  parameters.tuple_write_cost = write_ns * unit;
+  SetParameters(parameters);
+
+  LOG_INFO(
+      "Calibrated cost model (ns per op): scan %.2f, copy %.2f, hash build "
+      "%.2f, hash probe %.2f, random access %.2f, key compare %.2f, write "
+      "%.2f",
+      scan_ns, copy_ns, build_ns, probe_ns, random_ns, compare_ns, write_ns);
+}
+
+double CostModel::IndexSearchCost(const CostModelParameters &parameters,
+                                  IndexType index_type, double num_entries) {
+  double log_entries = std::log2(std::max(num_entries, 2.0));
+  switch (index_type) {
+    case IndexType::HASH:
+      // One bucket
+      return parameters.random_access_cost + parameters.key_compare_cost;
+    case IndexType::SKIPLIST:
+      // Two nodes per level on average, and a level per bit of the size
+      return log_entries * 2 *
+             (parameters.random_access_cost + parameters.key_compare_cost);
+    case IndexType::ART: {
+      // A level per byte of the key that tells the entries apart
+      double levels = std::ceil(log_entries / 8);
+      return levels *
+             (parameters.random_access_cost + parameters.key_compare_cost);
+    }
+    case IndexType::BWTREE:
+    default: {
+      // A binary search of a node per level
+      double node_bits = std::log2(kNodeSize);
+      double levels = std::ceil(log_entries / node_bits);
+      return levels * (parameters.random_access_cost +
+                       node_bits * parameters.key_compare_cost);
+    }
+  }
+}
+
+}  // namespace optimizer
+}  // namespace peloton
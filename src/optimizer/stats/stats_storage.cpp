@@ -17,6 +17,7 @@
 #include "concurrency/transaction_manager_factory.h"
 #include "optimizer/stats/column_stats.h"
 #include "optimizer/stats/table_stats.h"
+#include "settings/settings_manager.h"
 #include "storage/storage_manager.h"
 #include "type/ephemeral_pool.h"
 
@@ -297,10 +298,7 @@ ResultType StatsStorage::AnalyzeStatsForAllTables(
     for (oid_t table_offset = 0; table_offset < table_count; table_offset++) {
       auto table = database->GetTable(table_offset);
       LOG_DEBUG("Analyzing table: %s", table->GetName().c_str());
-      std::unique_ptr<TableStatsCollector> table_stats_collector(
-          new TableStatsCollector(table));
-      table_stats_collector->CollectColumnStats();
-      InsertOrUpdateTableStats(table, table_stats_collector.get(), txn);
+      AnalyzeTable(table, txn);
     }
   }
   return ResultType::SUCCESS;
@@ -317,11 +315,38 @@ ResultType StatsStorage::AnalyzeStatsForTable(
               table->GetName().c_str());
     return ResultType::FAILURE;
   }
-  std::unique_ptr<TableStatsCollector> table_stats_collector(
-      new TableStatsCollector(table));
+  AnalyzeTable(table, txn);
+  return ResultType::SUCCESS;
+}
+
+/**
+ * AnalyzeTable - Collect the stats of one table, reusing the stats of the
+ * tile groups that were not modified since the table was last analyzed.
+ */
+void StatsStorage::AnalyzeTable(storage::DataTable *table,
+                                concurrency::TransactionContext *txn) {
+  std::lock_guard<std::mutex> lock(analyze_mutex_);
+  auto &table_stats_collector = table_stats_collectors_[table->GetOid()];
+  if (table_stats_collector == nullptr ||
+      table_stats_collector->GetTable() != table) {
+    table_stats_collector.reset(new TableStatsCollector(table));
+  }
+  table_stats_collector->SetSampleRatio(settings::SettingsManager::GetDouble(
+      settings::SettingId::analyze_sample_ratio));
   table_stats_collector->CollectColumnStats();
+  LOG_TRACE("Scanned %lu tile groups of table %s",
+            table_stats_collector->GetScannedTileGroupCount(),
+            table->GetName().c_str());
   InsertOrUpdateTableStats(table, table_stats_collector.get(), txn);
-  return ResultType::SUCCESS;
+}
+
+/**
+ * DropTableStatsCollector - Release the collector of a dropped table, which
+ * points to its storage.
+ */
+void StatsStorage::DropTableStatsCollector(oid_t table_oid) {
+  std::lock_guard<std::mutex> lock(analyze_mutex_);
+  table_stats_collectors_.erase(table_oid);
 }
 
 // TODO: Implement it.
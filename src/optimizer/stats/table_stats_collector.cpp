@@ -12,67 +12,278 @@
 
 #include "optimizer/stats/table_stats_collector.h"
 
+#include <atomic>
+#include <cmath>
 #include <memory>
 
+#include "common/internal_types.h"
 #include "common/macros.h"
+#include "common/synchronization/count_down_latch.h"
+#include "optimizer/stats/tuple_sampler.h"
+#include "settings/settings_manager.h"
 #include "storage/tile_group.h"
 #include "storage/tile_group_header.h"
-#include "common/internal_types.h"
+#include "threadpool/mono_queue_pool.h"
 #include "type/value.h"
+#include "util/hash_util.h"
 
 namespace peloton {
 namespace optimizer {
 
+constexpr size_t TableStatsCollector::kTileGroupsPerChunk;
+constexpr size_t TableStatsCollector::kMaxChunks;
+
 TableStatsCollector::TableStatsCollector(storage::DataTable *table)
     : table_(table),
       column_stats_collectors_{},
+      chunk_stats_{},
+      chunk_width_{kTileGroupsPerChunk},
       active_tuple_count_{0},
-      column_count_{0} {}
+      column_count_{0},
+      sample_ratio_{1.0},
+      scanned_tile_group_count_{0} {}
 
 TableStatsCollector::~TableStatsCollector() {}
 
 void TableStatsCollector::CollectColumnStats() {
   schema_ = table_->GetSchema();
   column_count_ = schema_->GetColumnCount();
+  active_tuple_count_ = 0;
+  scanned_tile_group_count_ = 0;
 
   // Ignore empty table
   if (column_count_ == 0) {
     return;
   }
 
+  size_t tile_group_count = table_->GetTileGroupCount();
+  bool sampling = sample_ratio_ < 1.0;
+
+  // Split the tile groups to scan into chunks. When scanning the whole table,
+  // chunks cover fixed ranges of tile groups and are kept across calls.
+  std::vector<ChunkStats *> chunks;
+  if (sampling) {
+    chunk_stats_.clear();
+    TupleSampler sampler{table_};
+    size_t sample_count = std::max<size_t>(
+        1, static_cast<size_t>(std::ceil(tile_group_count * sample_ratio_)));
+    std::vector<oid_t> sampled_offsets =
+        sampler.AcquireSampleTileGroups(sample_count);
+    for (size_t begin = 0; begin < sampled_offsets.size();
+         begin += kTileGroupsPerChunk) {
+      size_t end =
+          std::min(begin + kTileGroupsPerChunk, sampled_offsets.size());
+      std::unique_ptr<ChunkStats> chunk{new ChunkStats()};
+      chunk->tile_group_offsets.assign(sampled_offsets.begin() + begin,
+                                       sampled_offsets.begin() + end);
+      chunk_stats_.push_back(std::move(chunk));
+    }
+  } else {
+    size_t chunk_count = (tile_group_count + chunk_width_ - 1) / chunk_width_;
+    while (chunk_count > kMaxChunks) {
+      MergeNeighboringChunks();
+      chunk_count = (tile_group_count + chunk_width_ - 1) / chunk_width_;
+    }
+    chunk_stats_.resize(chunk_count);
+    for (size_t chunk_id = 0; chunk_id < chunk_count; chunk_id++) {
+      auto &chunk = chunk_stats_[chunk_id];
+      oid_t begin = chunk_id * chunk_width_;
+      oid_t end = std::min(begin + chunk_width_, tile_group_count);
+      // The stats of a chunk are only reusable if they were collected for the
+      // same tile groups and columns
+      if (chunk == nullptr || chunk->tile_group_offsets.size() != end - begin ||
+          chunk->column_stats_collectors.size() != column_count_) {
+        chunk.reset(new ChunkStats());
+        for (oid_t offset = begin; offset < end; offset++) {
+          chunk->tile_group_offsets.push_back(offset);
+        }
+      }
+    }
+  }
+  for (auto &chunk : chunk_stats_) {
+    chunks.push_back(chunk.get());
+  }
+
+  CollectChunkStatsInParallel(chunks);
+
+  // Merge the stats of all chunks
   InitColumnStatsCollectors();
+  for (auto &chunk : chunk_stats_) {
+    active_tuple_count_ += chunk->active_tuple_count;
+    for (oid_t column_id = 0; column_id < column_count_; column_id++) {
+      column_stats_collectors_[column_id]->Merge(
+          *chunk->column_stats_collectors[column_id]);
+    }
+  }
 
-  size_t tile_group_count = table_->GetTileGroupCount();
-  // Collect stats for all tile groups.
-  for (size_t offset = 0; offset < tile_group_count; offset++) {
+  if (sampling) {
+    // Extrapolate the frequencies of the most common values to the whole
+    // table. Counting the active tuples only requires the headers.
+    size_t sampled_tuple_count = active_tuple_count_;
+    active_tuple_count_ = 0;
+    for (size_t offset = 0; offset < tile_group_count; offset++) {
+      auto tile_group = table_->GetTileGroup(offset);
+      if (tile_group != nullptr) {
+        active_tuple_count_ += tile_group->GetHeader()->GetActiveTupleCount();
+      }
+    }
+    if (sampled_tuple_count > 0) {
+      double frequency_scale =
+          static_cast<double>(active_tuple_count_) / sampled_tuple_count;
+      for (auto &column_stats_collector : column_stats_collectors_) {
+        column_stats_collector->SetFrequencyScale(frequency_scale);
+      }
+    }
+    chunk_stats_.clear();
+  }
+}
+
+void TableStatsCollector::CollectChunkStatsInParallel(
+    std::vector<ChunkStats *> &chunks) {
+  if (chunks.empty()) {
+    return;
+  }
+
+  // Tasks pull the next chunk to scan from a shared cursor
+  std::atomic<size_t> next_chunk{0};
+  std::atomic<size_t> scanned_tile_group_count{0};
+  auto work = [this, &chunks, &next_chunk, &scanned_tile_group_count]() {
+    size_t chunk_id;
+    while ((chunk_id = next_chunk++) < chunks.size()) {
+      if (CollectChunkStats(*chunks[chunk_id])) {
+        scanned_tile_group_count += chunks[chunk_id]->tile_group_offsets.size();
+      }
+    }
+  };
+
+  auto &worker_pool = threadpool::MonoQueuePool::GetExecutionInstance();
+  bool parallel = settings::SettingsManager::GetBool(
+      settings::SettingId::parallel_execution);
+  size_t num_tasks =
+      parallel ? std::min<size_t>(worker_pool.NumWorkers(), chunks.size()) : 1;
+
+  if (num_tasks <= 1) {
+    work();
+  } else {
+    common::synchronization::CountDownLatch latch{num_tasks};
+    for (size_t task_id = 0; task_id < num_tasks; task_id++) {
+      worker_pool.SubmitTask([&work, &latch]() {
+        work();
+        latch.CountDown();
+      });
+    }
+    latch.Await(0);
+  }
+
+  scanned_tile_group_count_ = scanned_tile_group_count;
+  LOG_TRACE("Scanned %lu tile groups of table %s with %lu tasks",
+            scanned_tile_group_count_, table_->GetName().c_str(), num_tasks);
+}
+
+bool TableStatsCollector::CollectChunkStats(ChunkStats &chunk) {
+  // Take the versions before scanning, so that concurrent modifications are
+  // picked up by the next collection
+  std::vector<uint64_t> tile_group_versions;
+  std::vector<std::shared_ptr<storage::TileGroup>> tile_groups;
+  for (oid_t offset : chunk.tile_group_offsets) {
     std::shared_ptr<storage::TileGroup> tile_group =
         table_->GetTileGroup(offset);
+    tile_group_versions.push_back(
+        tile_group == nullptr ? 0 : GetTileGroupVersion(tile_group.get()));
+    tile_groups.push_back(std::move(tile_group));
+  }
+
+  if (!chunk.column_stats_collectors.empty() &&
+      chunk.tile_group_versions == tile_group_versions) {
+    return false;
+  }
+
+  chunk.tile_group_versions = std::move(tile_group_versions);
+  chunk.column_stats_collectors = CreateColumnStatsCollectors();
+  chunk.active_tuple_count = 0;
+
+  for (auto &tile_group : tile_groups) {
+    if (tile_group == nullptr) {
+      continue;
+    }
     storage::TileGroupHeader *tile_group_header = tile_group->GetHeader();
     oid_t tuple_count = tile_group->GetAllocatedTupleCount();
-    active_tuple_count_ += tile_group_header->GetActiveTupleCount();
     // Collect stats for all tuples in the tile group.
     for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
       txn_id_t tuple_txn_id = tile_group_header->GetTransactionId(tuple_id);
       if (tuple_txn_id != INVALID_TXN_ID) {
+        chunk.active_tuple_count++;
         // Collect stats for all columns.
         for (oid_t column_id = 0; column_id < column_count_; column_id++) {
           type::Value value = tile_group->GetValue(tuple_id, column_id);
-          column_stats_collectors_[column_id]->AddValue(value);
+          chunk.column_stats_collectors[column_id]->AddValue(value);
         } /* column */
       }
     } /* tuple */
   }   /* tile group */
+  return true;
 }
 
-void TableStatsCollector::InitColumnStatsCollectors() {
+void TableStatsCollector::MergeNeighboringChunks() {
+  std::vector<std::unique_ptr<ChunkStats>> merged_chunks;
+  for (size_t chunk_id = 0; chunk_id < chunk_stats_.size(); chunk_id += 2) {
+    std::unique_ptr<ChunkStats> chunk = std::move(chunk_stats_[chunk_id]);
+    if (chunk_id + 1 < chunk_stats_.size()) {
+      std::unique_ptr<ChunkStats> next = std::move(chunk_stats_[chunk_id + 1]);
+      // Only stats collected for all tile groups and columns of both chunks
+      // can be merged. Otherwise the merged chunk is scanned again.
+      if (chunk == nullptr || next == nullptr ||
+          chunk->tile_group_offsets.size() != chunk_width_ ||
+          chunk->column_stats_collectors.size() != column_count_ ||
+          next->column_stats_collectors.size() != column_count_) {
+        chunk.reset();
+      } else {
+        chunk->tile_group_offsets.insert(chunk->tile_group_offsets.end(),
+                                         next->tile_group_offsets.begin(),
+                                         next->tile_group_offsets.end());
+        chunk->tile_group_versions.insert(chunk->tile_group_versions.end(),
+                                          next->tile_group_versions.begin(),
+                                          next->tile_group_versions.end());
+        for (oid_t column_id = 0; column_id < column_count_; column_id++) {
+          chunk->column_stats_collectors[column_id]->Merge(
+              *next->column_stats_collectors[column_id]);
+        }
+        chunk->active_tuple_count += next->active_tuple_count;
+      }
+    }
+    merged_chunks.push_back(std::move(chunk));
+  }
+  chunk_stats_.swap(merged_chunks);
+  chunk_width_ *= 2;
+}
+
+uint64_t TableStatsCollector::GetTileGroupVersion(
+    storage::TileGroup *tile_group) {
+  storage::TileGroupHeader *tile_group_header = tile_group->GetHeader();
+  oid_t tile_group_id = tile_group->GetTileGroupId();
+  oid_t tuple_count = tile_group_header->GetCurrentNextTupleSlot();
+  uint64_t modification_count = tile_group_header->GetModificationCount();
+  hash_t version = HashUtil::CombineHashes(HashUtil::Hash(&tile_group_id),
+                                           HashUtil::Hash(&tuple_count));
+  return HashUtil::CombineHashes(version, HashUtil::Hash(&modification_count));
+}
+
+std::vector<std::unique_ptr<ColumnStatsCollector>>
+TableStatsCollector::CreateColumnStatsCollectors() {
+  std::vector<std::unique_ptr<ColumnStatsCollector>> column_stats_collectors;
   oid_t database_id = table_->GetDatabaseOid();
   oid_t table_id = table_->GetOid();
   for (oid_t column_id = 0; column_id < column_count_; column_id++) {
     std::unique_ptr<ColumnStatsCollector> colstats(new ColumnStatsCollector(
         database_id, table_id, column_id, schema_->GetType(column_id),
         table_->GetName()+"."+schema_->GetColumn(column_id).GetName()));
-    column_stats_collectors_.push_back(std::move(colstats));
+    column_stats_collectors.push_back(std::move(colstats));
   }
+  return column_stats_collectors;
+}
+
+void TableStatsCollector::InitColumnStatsCollectors() {
+  column_stats_collectors_ = CreateColumnStatsCollectors();
 
   // Set indexes in the column stats collectors.
   for (auto &column_set : table_->GetIndexColumns()) {
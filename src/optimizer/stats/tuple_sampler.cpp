@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "optimizer/stats/tuple_sampler.h"
+#include <algorithm>
 #include <cinttypes>
 
 #include "storage/data_table.h"
@@ -71,6 +72,36 @@ size_t TupleSampler::AcquireSampleTuples(size_t target_sample_count) {
   return sampled_tuples.size();
 }
 
+/**
+ * AcquireSampleTileGroups - Sample a certain number of tile groups (blocks)
+ * from a given table without replacement. Returns the sampled tile group
+ * offsets in ascending order.
+ */
+std::vector<oid_t> TupleSampler::AcquireSampleTileGroups(
+    size_t target_sample_count) {
+  size_t tile_group_count = table->GetTileGroupCount();
+  std::vector<oid_t> tile_group_offsets(tile_group_count);
+  for (size_t offset = 0; offset < tile_group_count; offset++) {
+    tile_group_offsets[offset] = offset;
+  }
+
+  if (tile_group_count <= target_sample_count) {
+    return tile_group_offsets;
+  }
+
+  // Partial Fisher-Yates shuffle
+  srand(time(NULL));
+  for (size_t i = 0; i < target_sample_count; i++) {
+    size_t j = i + rand() % (tile_group_count - i);
+    std::swap(tile_group_offsets[i], tile_group_offsets[j]);
+  }
+  tile_group_offsets.resize(target_sample_count);
+  std::sort(tile_group_offsets.begin(), tile_group_offsets.end());
+  LOG_TRACE("%lu tile groups sampled out of %lu", target_sample_count,
+            tile_group_count);
+  return tile_group_offsets;
+}
+
 /**
  * GetTupleInTileGroup - This function is a helper function to get a tuple in
  * a tile group.
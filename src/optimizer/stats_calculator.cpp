@@ -18,10 +18,12 @@
 #include "expression/expression_util.h"
 #include "expression/tuple_value_expression.h"
 #include "optimizer/memo.h"
+#include "optimizer/stats/cardinality_feedback.h"
 #include "optimizer/stats/column_stats.h"
 #include "optimizer/stats/table_stats.h"
 #include "optimizer/stats/selectivity.h"
 #include "optimizer/stats/stats_storage.h"
+#include "settings/settings_manager.h"
 
 namespace peloton {
 namespace optimizer {
@@ -65,9 +67,22 @@ void StatsCalculator::Visit(const LogicalGet *op) {
       }
     }
     // Use predicates to update the stats accordingly
-    UpdateStatsForFilter(
-        table_stats->GetColumnCount() == 0 ? 0 : table_stats->num_rows,
-        predicate_stats, op->predicates);
+    size_t num_rows =
+        table_stats->GetColumnCount() == 0 ? 0 : table_stats->num_rows;
+    UpdateStatsForFilter(num_rows, predicate_stats, op->predicates);
+
+    // Prefer the selectivity observed in earlier executions of the same
+    // predicates to the estimate from the column stats
+    double selectivity;
+    if (settings::SettingsManager::GetBool(
+            settings::SettingId::cardinality_feedback) &&
+        CardinalityFeedback::GetInstance()->GetSelectivity(
+            CardinalityFeedback::GetPredicateSignature(
+                op->table->GetDatabaseOid(), op->table->GetTableOid(),
+                op->predicates),
+            selectivity)) {
+      root_group->SetNumRows(num_rows * selectivity);
+    }
   }
   // Add the stats to the group
   for (auto &column_name_stats_pair : required_stats) {
@@ -1776,8 +1776,30 @@ parser::SelectStatement *PostgresParser::SelectTransform(SelectStmt *root) {
 }
 
 parser::SQLStatement *PostgresParser::ExplainTransform(ExplainStmt *root) {
+  static constexpr char kAnalyzeTok[] = "analyze";
   parser::ExplainStatement *result = new parser::ExplainStatement();
   result->real_sql_stmt.reset(NodeTransform(root->query));
+
+  // Handle options
+  if (root->options != nullptr) {
+    ListCell *cell = nullptr;
+    for_each_cell(cell, root->options->head) {
+      auto *def_elem = reinterpret_cast<DefElem *>(cell->data.ptr_value);
+
+      // Check analyze, which is true when given without a value
+      if (strncmp(def_elem->defname, kAnalyzeTok, sizeof(kAnalyzeTok)) == 0) {
+        auto *analyze_val = reinterpret_cast<value *>(def_elem->arg);
+        if (analyze_val == nullptr) {
+          result->analyze = true;
+        } else if (analyze_val->type == T_Integer) {
+          result->analyze = analyze_val->val.ival != 0;
+        } else {
+          std::string analyze_str = analyze_val->val.str;
+          result->analyze = analyze_str != "false" && analyze_str != "off";
+        }
+      }
+    }
+  }
   return result;
 }
 
@@ -1999,6 +2021,19 @@ parser::SQLStatementList *PostgresParser::ParseSQLString(
   return ParseSQLString(sql.c_str());
 }
 
+std::string PostgresParser::NormalizeSQLString(const std::string &sql) {
+  auto result = pg_query_normalize(sql.c_str());
+  if (result.error) {
+    std::string exception_msg = StringUtil::Format(
+        "%s at %d", result.error->message, result.error->cursorpos);
+    pg_query_free_normalize_result(result);
+    throw ParserException(exception_msg);
+  }
+  std::string normalized_sql{result.normalized_query};
+  pg_query_free_normalize_result(result);
+  return normalized_sql;
+}
+
 PostgresParser &PostgresParser::GetInstance() {
   static PostgresParser parser;
   return parser;
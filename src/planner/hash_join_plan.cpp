@@ -33,7 +33,8 @@ HashJoinPlan::HashJoinPlan(JoinType join_type, ExpressionPtr &&predicate,
                        proj_schema),
       left_hash_keys_(std::move(left_hash_keys)),
       right_hash_keys_(std::move(right_hash_keys)),
-      build_bloomfilter_(build_bloomfilter) {}
+      build_bloomfilter_(build_bloomfilter),
+      radix_partitioned_(false) {}
 
 void HashJoinPlan::GetLeftHashKeys(
     std::vector<const expression::AbstractExpression *> &keys) const {
@@ -81,6 +82,7 @@ std::unique_ptr<AbstractPlan> HashJoinPlan::Copy() const {
       new HashJoinPlan(GetJoinType(), std::move(predicate_copy),
                        GetProjInfo()->Copy(), schema_copy, left_hash_keys_copy,
                        right_hash_keys_copy, build_bloomfilter_);
+  new_plan->SetRadixPartitionedFlag(radix_partitioned_);
   return std::unique_ptr<AbstractPlan>(new_plan);
 }
 
@@ -99,6 +101,9 @@ hash_t HashJoinPlan::Hash() const {
     hash = HashUtil::CombineHashes(hash, keys[i]->Hash());
   }
 
+  // The flag changes the code generated for the join
+  hash = HashUtil::CombineHashes(hash, HashUtil::Hash(&radix_partitioned_));
+
   return HashUtil::CombineHashes(hash, AbstractPlan::Hash());
 }
 
@@ -108,6 +113,9 @@ bool HashJoinPlan::operator==(const AbstractPlan &rhs) const {
   }
 
   const auto &other = static_cast<const HashJoinPlan &>(rhs);
+  if (IsRadixPartitioned() != other.IsRadixPartitioned()) {
+    return false;
+  }
 
   std::vector<const expression::AbstractExpression *> keys, other_keys;
 
@@ -22,12 +22,14 @@
 #include "concurrency/transaction_manager_factory.h"
 #include "expression/abstract_expression.h"
 #include "expression/expression_util.h"
+#include "index/index.h"
 #include "optimizer/abstract_optimizer.h"
 #include "optimizer/optimizer.h"
 #include "parser/delete_statement.h"
 #include "parser/insert_statement.h"
 #include "parser/sql_statement.h"
 #include "parser/update_statement.h"
+#include "planner/index_scan_plan.h"
 #include "util/set_util.h"
 
 namespace peloton {
@@ -194,5 +196,50 @@ const std::vector<col_triplet> PlanUtil::GetIndexableColumns(
   return (column_oids);
 }
 
+bool PlanUtil::IsShortQuery(const planner::AbstractPlan *plan) {
+  if (plan == nullptr) return false;
+  switch (plan->GetPlanNodeType()) {
+    case PlanNodeType::INSERT: {
+      // INSERT ... VALUES of one tuple, not INSERT ... SELECT
+      const auto *insert_node =
+          static_cast<const planner::InsertPlan *>(plan);
+      return plan->GetChildrenSize() == 0 &&
+             insert_node->GetBulkInsertCount() <= 1;
+    }
+    case PlanNodeType::UPDATE:
+    case PlanNodeType::DELETE:
+    case PlanNodeType::PROJECTION:
+      return plan->GetChildrenSize() == 1 &&
+             IsPointLookup(plan->GetChild(0));
+    case PlanNodeType::INDEXSCAN:
+      return IsPointLookup(plan);
+    default:
+      return false;
+  }
+}
+
+bool PlanUtil::IsPointLookup(const planner::AbstractPlan *plan) {
+  if (plan->GetPlanNodeType() != PlanNodeType::INDEXSCAN) return false;
+  const auto *scan_node = static_cast<const planner::IndexScanPlan *>(plan);
+  auto index = scan_node->GetTable()->GetIndexWithOid(scan_node->GetIndexId());
+  if (index == nullptr || index->GetOid() != scan_node->GetIndexId() ||
+      !index->HasUniqueKeys()) {
+    return false;
+  }
+
+  // Every key attribute must be bound by an equality predicate
+  auto &key_column_ids = scan_node->GetKeyColumnIds();
+  auto &expr_types = scan_node->GetExprTypes();
+  for (auto key_attr : index->GetMetadata()->GetKeyAttrs()) {
+    bool is_bound = false;
+    for (size_t i = 0; i < key_column_ids.size() && !is_bound; i++) {
+      is_bound = key_column_ids[i] == key_attr &&
+                 expr_types[i] == ExpressionType::COMPARE_EQUAL;
+    }
+    if (!is_bound) return false;
+  }
+  return true;
+}
+
 }  // namespace planner
 }  // namespace peloton
@@ -48,7 +48,9 @@ BackendStatsContext *BackendStatsContext::GetInstance() {
 
 BackendStatsContext::BackendStatsContext(size_t max_latency_history,
                                          bool regiser_to_aggregator)
-    : txn_latencies_(MetricType::LATENCY, max_latency_history) {
+    : txn_latencies_(MetricType::LATENCY, max_latency_history),
+      inline_query_latencies_(MetricType::LATENCY, max_latency_history),
+      queued_query_latencies_(MetricType::LATENCY, max_latency_history) {
   std::thread::id this_id = std::this_thread::get_id();
   thread_id_ = this_id;
 
@@ -111,6 +113,24 @@ LatencyMetric &BackendStatsContext::GetTxnLatencyMetric() {
   return txn_latencies_;
 }
 
+LatencyMetric &BackendStatsContext::GetInlineQueryLatencyMetric() {
+  return inline_query_latencies_;
+}
+
+LatencyMetric &BackendStatsContext::GetQueuedQueryLatencyMetric() {
+  return queued_query_latencies_;
+}
+
+void BackendStatsContext::IncrementInlineQueries(double latency) {
+  inline_queries_.Increment();
+  inline_query_latencies_.RecordLatency(latency);
+}
+
+void BackendStatsContext::IncrementQueuedQueries(double latency) {
+  queued_queries_.Increment();
+  queued_query_latencies_.RecordLatency(latency);
+}
+
 void BackendStatsContext::IncrementTableReads(oid_t tile_group_id) {
   oid_t table_id =
       storage::StorageManager::GetInstance()->GetTileGroup(tile_group_id)->GetTableId();
@@ -239,6 +259,12 @@ void BackendStatsContext::Aggregate(BackendStatsContext &source) {
   // Aggregate all global metrics
   txn_latencies_.Aggregate(source.txn_latencies_);
   txn_latencies_.ComputeLatencies();
+  inline_query_latencies_.Aggregate(source.inline_query_latencies_);
+  inline_query_latencies_.ComputeLatencies();
+  queued_query_latencies_.Aggregate(source.queued_query_latencies_);
+  queued_query_latencies_.ComputeLatencies();
+  inline_queries_.Aggregate(source.inline_queries_);
+  queued_queries_.Aggregate(source.queued_queries_);
 
   // Aggregate all per-database metrics
   for (auto &database_item : source.database_metrics_) {
@@ -273,6 +299,10 @@ void BackendStatsContext::Aggregate(BackendStatsContext &source) {
 
 void BackendStatsContext::Reset() {
   txn_latencies_.Reset();
+  inline_query_latencies_.Reset();
+  queued_query_latencies_.Reset();
+  inline_queries_.Reset();
+  queued_queries_.Reset();
 
   for (auto &database_item : database_metrics_) {
     database_item.second->Reset();
@@ -334,6 +364,10 @@ std::string BackendStatsContext::ToString() const {
   std::stringstream ss;
 
   ss << txn_latencies_.GetInfo() << std::endl;
+  ss << "Inline queries: " << inline_queries_.GetInfo() << std::endl;
+  ss << inline_query_latencies_.GetInfo() << std::endl;
+  ss << "Queued queries: " << queued_queries_.GetInfo() << std::endl;
+  ss << queued_query_latencies_.GetInfo() << std::endl;
 
   for (auto &database_item : database_metrics_) {
     oid_t database_id = database_item.second->GetDatabaseId();
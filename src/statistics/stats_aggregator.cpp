@@ -144,6 +144,7 @@ void StatsAggregator::UpdateQueryMetrics(int64_t time_stamp,
     auto latency = query_metric->GetQueryLatency().GetFirstLatencyValue();
     auto cpu_system = query_metric->GetProcessorMetric().GetSystemDuration();
     auto cpu_user = query_metric->GetProcessorMetric().GetUserDuration();
+    auto peak_memory = query_metric->GetPeakMemory();
 
     // Get query params
     auto query_params = query_metric->GetQueryParams();
@@ -178,6 +179,7 @@ void StatsAggregator::UpdateQueryMetrics(int64_t time_stamp,
                              (int64_t) latency,
                              (int64_t) (cpu_system + cpu_user),
                              time_stamp,
+                             (int64_t) (peak_memory / 1024),
                              pool_.get());
 
     LOG_TRACE("Query Metric Tuple inserted");
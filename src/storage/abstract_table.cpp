@@ -17,6 +17,7 @@
 #include "common/exception.h"
 #include "common/logger.h"
 #include "index/index.h"
+#include "settings/settings_manager.h"
 #include "storage/tile_group.h"
 #include "storage/tile_group_factory.h"
 #include "util/stringbox_util.h"
@@ -26,7 +27,14 @@ namespace storage {
 
 AbstractTable::AbstractTable(oid_t table_oid, catalog::Schema *schema,
                              bool own_schema, peloton::LayoutType layout_type)
-    : table_oid(table_oid), schema(schema), own_schema_(own_schema) {
+    : table_oid(table_oid),
+      schema(schema),
+      own_schema_(own_schema),
+      tuple_header_layout_(settings::SettingsManager::GetBool(
+                               settings::SettingId::columnar_tuple_headers)
+                               ? LayoutType::COLUMN
+                               : LayoutType::ROW),
+      delta_storage_(false) {
   // The default Layout should always be ROW or COLUMN
   PELOTON_ASSERT((layout_type == LayoutType::ROW) ||
                  (layout_type == LayoutType::COLUMN));
@@ -0,0 +1,492 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// compressed_tile_group.cpp
+//
+// Identification: src/storage/compressed_tile_group.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/compressed_tile_group.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include "catalog/schema.h"
+#include "common/logger.h"
+#include "storage/abstract_table.h"
+#include "storage/tile_group.h"
+#include "storage/zone_map_manager.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace storage {
+
+namespace {
+
+// Integer-like types are encoded with frame-of-reference
+bool IsFrameOfReferenceType(type::TypeId type_id) {
+  switch (type_id) {
+    case type::TypeId::TINYINT:
+    case type::TypeId::SMALLINT:
+    case type::TypeId::INTEGER:
+    case type::TypeId::BIGINT:
+    case type::TypeId::DATE:
+    case type::TypeId::TIMESTAMP:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool IsIntegralType(type::TypeId type_id) {
+  return type_id == type::TypeId::TINYINT ||
+         type_id == type::TypeId::SMALLINT ||
+         type_id == type::TypeId::INTEGER || type_id == type::TypeId::BIGINT;
+}
+
+int64_t ValueToInt64(const type::Value &value) {
+  switch (value.GetTypeId()) {
+    case type::TypeId::TINYINT:
+      return value.GetAs<int8_t>();
+    case type::TypeId::SMALLINT:
+      return value.GetAs<int16_t>();
+    case type::TypeId::INTEGER:
+      return value.GetAs<int32_t>();
+    case type::TypeId::BIGINT:
+      return value.GetAs<int64_t>();
+    case type::TypeId::DATE:
+      return value.GetAs<uint32_t>();
+    case type::TypeId::TIMESTAMP:
+      return static_cast<int64_t>(value.GetAs<uint64_t>());
+    default:
+      throw Exception{"Invalid type for frame-of-reference encoding"};
+  }
+}
+
+type::Value Int64ToValue(type::TypeId type_id, int64_t value) {
+  switch (type_id) {
+    case type::TypeId::TINYINT:
+      return type::ValueFactory::GetTinyIntValue(static_cast<int8_t>(value));
+    case type::TypeId::SMALLINT:
+      return type::ValueFactory::GetSmallIntValue(static_cast<int16_t>(value));
+    case type::TypeId::INTEGER:
+      return type::ValueFactory::GetIntegerValue(static_cast<int32_t>(value));
+    case type::TypeId::BIGINT:
+      return type::ValueFactory::GetBigIntValue(value);
+    case type::TypeId::DATE:
+      return type::ValueFactory::GetDateValue(static_cast<uint32_t>(value));
+    case type::TypeId::TIMESTAMP:
+      return type::ValueFactory::GetTimestampValue(value);
+    default:
+      throw Exception{"Invalid type for frame-of-reference encoding"};
+  }
+}
+
+bool ValueLess(const type::Value &left, const type::Value &right) {
+  return left.CompareLessThan(right) == CmpBool::CmpTrue;
+}
+
+}  // namespace
+
+//===--------------------------------------------------------------------===//
+// Compressed Column
+//===--------------------------------------------------------------------===//
+
+bool CompressedColumn::IsEncodable(type::TypeId type_id) {
+  return IsFrameOfReferenceType(type_id) || type_id == type::TypeId::VARCHAR;
+}
+
+std::unique_ptr<CompressedColumn> CompressedColumn::Encode(
+    type::TypeId type_id, const std::vector<type::Value> &values) {
+  if (!IsEncodable(type_id)) {
+    return nullptr;
+  }
+
+  oid_t num_tuples = static_cast<oid_t>(values.size());
+  std::unique_ptr<CompressedColumn> column{
+      new CompressedColumn(type_id, num_tuples)};
+
+  for (const auto &value : values) {
+    if (value.IsNull()) {
+      column->has_nulls_ = true;
+      break;
+    }
+  }
+  const uint64_t null_offset = column->has_nulls_ ? 1 : 0;
+
+  std::vector<uint64_t> codes(num_tuples, 0);
+
+  if (IsFrameOfReferenceType(type_id)) {
+    // Find the frame (i.e., the min and max) of the column
+    bool found = false;
+    int64_t min = 0, max = 0;
+    for (const auto &value : values) {
+      if (value.IsNull()) continue;
+      int64_t v = ValueToInt64(value);
+      min = (found ? std::min(min, v) : v);
+      max = (found ? std::max(max, v) : v);
+      found = true;
+    }
+    // A frame spanning (almost) the whole BIGINT range leaves no room for the
+    // number of codes, so such a column stays uncompressed
+    uint64_t range = static_cast<uint64_t>(max) - static_cast<uint64_t>(min);
+    if (found && range >= UINT64_MAX - null_offset) {
+      return nullptr;
+    }
+    column->base_ = min;
+    column->num_values_ = found ? range + 1 : 0;
+
+    for (oid_t tuple_itr = 0; tuple_itr < num_tuples; tuple_itr++) {
+      const auto &value = values[tuple_itr];
+      if (value.IsNull()) continue;
+      codes[tuple_itr] = static_cast<uint64_t>(ValueToInt64(value)) -
+                         static_cast<uint64_t>(min) + null_offset;
+    }
+  } else {
+    // Build a sorted dictionary of the distinct values
+    auto &dictionary = column->dictionary_;
+    for (const auto &value : values) {
+      if (!value.IsNull()) dictionary.push_back(value.Copy());
+    }
+    std::sort(dictionary.begin(), dictionary.end(), ValueLess);
+    dictionary.erase(
+        std::unique(dictionary.begin(), dictionary.end(),
+                    [](const type::Value &left, const type::Value &right) {
+                      return left.CompareEquals(right) == CmpBool::CmpTrue;
+                    }),
+        dictionary.end());
+    column->num_values_ = dictionary.size();
+
+    for (oid_t tuple_itr = 0; tuple_itr < num_tuples; tuple_itr++) {
+      const auto &value = values[tuple_itr];
+      if (value.IsNull()) continue;
+      auto pos = std::lower_bound(dictionary.begin(), dictionary.end(), value,
+                                  ValueLess);
+      codes[tuple_itr] = (pos - dictionary.begin()) + null_offset;
+    }
+  }
+
+  column->PackCodes(codes);
+  return column;
+}
+
+void CompressedColumn::PackCodes(const std::vector<uint64_t> &codes) {
+  // The largest code determines the width of the bit-packed representation
+  uint64_t max_code =
+      (num_values_ == 0 ? 0 : num_values_ - 1) + (has_nulls_ ? 1 : 0);
+  bit_width_ = 0;
+  while (bit_width_ < 64 && (max_code >> bit_width_) != 0) {
+    bit_width_++;
+  }
+  size_t num_words = ((static_cast<uint64_t>(num_tuples_) * bit_width_) + 63) /
+                         64 + 1;
+
+  // Count the runs to decide whether run-length encoding is smaller
+  std::vector<Run> runs;
+  for (oid_t tuple_itr = 0; tuple_itr < num_tuples_; tuple_itr++) {
+    if (runs.empty() || runs.back().code != codes[tuple_itr]) {
+      runs.push_back(Run{codes[tuple_itr], tuple_itr + 1});
+    } else {
+      runs.back().end = tuple_itr + 1;
+    }
+  }
+
+  if (runs.size() * sizeof(Run) < num_words * sizeof(uint64_t)) {
+    is_run_length_ = true;
+    runs_ = std::move(runs);
+    return;
+  }
+
+  packed_codes_.assign(num_words, 0);
+  if (bit_width_ == 0) {
+    return;
+  }
+  for (oid_t tuple_itr = 0; tuple_itr < num_tuples_; tuple_itr++) {
+    uint64_t bit_pos = static_cast<uint64_t>(tuple_itr) * bit_width_;
+    uint64_t word = bit_pos / 64;
+    uint32_t shift = bit_pos % 64;
+    packed_codes_[word] |= codes[tuple_itr] << shift;
+    if (shift + bit_width_ > 64) {
+      packed_codes_[word + 1] |= codes[tuple_itr] >> (64 - shift);
+    }
+  }
+}
+
+uint64_t CompressedColumn::GetCode(oid_t tuple_offset) const {
+  PELOTON_ASSERT(tuple_offset < num_tuples_);
+  if (is_run_length_) {
+    auto run = std::upper_bound(
+        runs_.begin(), runs_.end(), tuple_offset,
+        [](oid_t tid, const Run &r) { return tid < r.end; });
+    PELOTON_ASSERT(run != runs_.end());
+    return run->code;
+  }
+
+  if (bit_width_ == 0) {
+    return 0;
+  }
+  uint64_t bit_pos = static_cast<uint64_t>(tuple_offset) * bit_width_;
+  uint64_t word = bit_pos / 64;
+  uint32_t shift = bit_pos % 64;
+  uint64_t code = packed_codes_[word] >> shift;
+  if (shift + bit_width_ > 64) {
+    code |= packed_codes_[word + 1] << (64 - shift);
+  }
+  uint64_t mask =
+      (bit_width_ == 64 ? ~uint64_t{0} : (uint64_t{1} << bit_width_) - 1);
+  return code & mask;
+}
+
+CompressionType CompressedColumn::GetCompressionType() const {
+  if (is_run_length_) {
+    return CompressionType::RUN_LENGTH;
+  }
+  return IsFrameOfReferenceType(type_id_) ? CompressionType::FRAME_OF_REFERENCE
+                                          : CompressionType::DICTIONARY;
+}
+
+type::Value CompressedColumn::GetValue(oid_t tuple_offset) const {
+  uint64_t code = GetCode(tuple_offset);
+  if (has_nulls_) {
+    if (code == 0) {
+      return type::ValueFactory::GetNullValueByType(type_id_);
+    }
+    code--;
+  }
+  if (IsFrameOfReferenceType(type_id_)) {
+    return Int64ToValue(type_id_, static_cast<int64_t>(
+                                      static_cast<uint64_t>(base_) + code));
+  }
+  PELOTON_ASSERT(code < dictionary_.size());
+  return dictionary_[code];
+}
+
+bool CompressedColumn::LocateConstant(const type::Value &constant,
+                                      uint64_t &lower, uint64_t &upper) const {
+  if (IsFrameOfReferenceType(type_id_)) {
+    // Integers can be compared with any integer, everything else only with
+    // constants of the very same type
+    bool comparable = IsIntegralType(type_id_)
+                          ? IsIntegralType(constant.GetTypeId())
+                          : constant.GetTypeId() == type_id_;
+    if (!comparable) {
+      return false;
+    }
+    int64_t c = ValueToInt64(constant);
+    int64_t max = static_cast<int64_t>(static_cast<uint64_t>(base_) +
+                                       (num_values_ - 1));
+    if (num_values_ == 0 || c < base_) {
+      lower = upper = 0;
+    } else if (c > max) {
+      lower = upper = num_values_;
+    } else {
+      lower = static_cast<uint64_t>(c) - static_cast<uint64_t>(base_);
+      upper = lower + 1;
+    }
+    return true;
+  }
+
+  if (constant.GetTypeId() != type::TypeId::VARCHAR) {
+    return false;
+  }
+  lower = std::lower_bound(dictionary_.begin(), dictionary_.end(), constant,
+                           ValueLess) -
+          dictionary_.begin();
+  upper = std::upper_bound(dictionary_.begin(), dictionary_.end(), constant,
+                           ValueLess) -
+          dictionary_.begin();
+  return true;
+}
+
+bool CompressedColumn::CanEvaluate(ExpressionType cmp_type,
+                                   const type::Value &constant) const {
+  switch (cmp_type) {
+    case ExpressionType::COMPARE_EQUAL:
+    case ExpressionType::COMPARE_LESSTHAN:
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+    case ExpressionType::COMPARE_GREATERTHAN:
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      break;
+    default:
+      return false;
+  }
+  if (constant.IsNull()) {
+    return true;
+  }
+  uint64_t lower, upper;
+  return LocateConstant(constant, lower, upper);
+}
+
+bool CompressedColumn::Filter(ExpressionType cmp_type,
+                              const type::Value &constant, uint32_t *sel,
+                              uint32_t num_sel, uint32_t &num_out) const {
+  if (!CanEvaluate(cmp_type, constant)) {
+    return false;
+  }
+
+  // Comparisons with NULL are never true
+  if (constant.IsNull()) {
+    num_out = 0;
+    return true;
+  }
+
+  // Translate the comparison into the range [lo, hi) of qualifying codes
+  uint64_t lower, upper;
+  LocateConstant(constant, lower, upper);
+  uint64_t lo = 0, hi = 0;
+  switch (cmp_type) {
+    case ExpressionType::COMPARE_EQUAL:
+      lo = lower, hi = upper;
+      break;
+    case ExpressionType::COMPARE_LESSTHAN:
+      lo = 0, hi = lower;
+      break;
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      lo = 0, hi = upper;
+      break;
+    case ExpressionType::COMPARE_GREATERTHAN:
+      lo = upper, hi = num_values_;
+      break;
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      lo = lower, hi = num_values_;
+      break;
+    default:
+      PELOTON_ASSERT(false);
+  }
+  if (hi <= lo) {
+    num_out = 0;
+    return true;
+  }
+
+  // Shift past the NULL code; a single unsigned comparison then checks both
+  // bounds of the range
+  uint64_t range = hi - lo;
+  lo += (has_nulls_ ? 1 : 0);
+
+  uint32_t out = 0;
+  if (is_run_length_) {
+    // The TIDs are ascending, so we only ever move forward through the runs
+    auto run = runs_.begin();
+    for (uint32_t i = 0; i < num_sel; i++) {
+      uint32_t tid = sel[i];
+      PELOTON_ASSERT(tid < num_tuples_);
+      while (run->end <= tid) ++run;
+      sel[out] = tid;
+      out += ((run->code - lo) < range);
+    }
+  } else {
+    for (uint32_t i = 0; i < num_sel; i++) {
+      uint32_t tid = sel[i];
+      sel[out] = tid;
+      out += ((GetCode(tid) - lo) < range);
+    }
+  }
+  num_out = out;
+  return true;
+}
+
+size_t CompressedColumn::GetCompressedSize() const {
+  size_t size = sizeof(CompressedColumn) + runs_.size() * sizeof(Run) +
+                packed_codes_.size() * sizeof(uint64_t);
+  for (const auto &value : dictionary_) {
+    size += sizeof(type::Value) + value.GetLength();
+  }
+  return size;
+}
+
+//===--------------------------------------------------------------------===//
+// Compressed Tile Group
+//===--------------------------------------------------------------------===//
+
+std::unique_ptr<CompressedTileGroup> CompressedTileGroup::Compress(
+    TileGroup *tile_group) {
+  PELOTON_ASSERT(tile_group != nullptr);
+  const catalog::Schema *schema = tile_group->GetAbstractTable()->GetSchema();
+  oid_t num_columns = schema->GetColumnCount();
+  oid_t num_tuples = tile_group->GetNextTupleSlot();
+
+  std::unique_ptr<CompressedTileGroup> compressed{
+      new CompressedTileGroup(num_tuples)};
+  compressed->columns_.resize(num_columns);
+
+  std::vector<type::Value> values;
+  for (oid_t col_itr = 0; col_itr < num_columns; col_itr++) {
+    type::TypeId type_id = schema->GetType(col_itr);
+    if (!CompressedColumn::IsEncodable(type_id)) {
+      continue;
+    }
+    values.clear();
+    values.reserve(num_tuples);
+    for (oid_t tuple_itr = 0; tuple_itr < num_tuples; tuple_itr++) {
+      values.push_back(tile_group->GetValue(tuple_itr, col_itr));
+    }
+    compressed->columns_[col_itr] = CompressedColumn::Encode(type_id, values);
+  }
+
+  LOG_TRACE("Compressed tile group %u: %s", tile_group->GetTileGroupId(),
+            compressed->GetInfo().c_str());
+  return compressed;
+}
+
+bool CompressedTileGroup::Filter(const PredicateInfo *predicates,
+                                 uint32_t num_predicates, uint32_t *sel,
+                                 uint32_t num_sel, uint32_t &num_out) const {
+  // The selection vector may only contain TIDs we've compressed
+  if (num_sel > 0 && sel[num_sel - 1] >= num_tuples_) {
+    return false;
+  }
+
+  // Check that every predicate can be evaluated before touching the vector
+  for (uint32_t i = 0; i < num_predicates; i++) {
+    const auto &predicate = predicates[i];
+    const auto *column = GetColumn(predicate.col_id);
+    if (column == nullptr ||
+        !column->CanEvaluate(
+            static_cast<ExpressionType>(predicate.comparison_operator),
+            predicate.predicate_value)) {
+      return false;
+    }
+  }
+
+  for (uint32_t i = 0; i < num_predicates; i++) {
+    const auto &predicate = predicates[i];
+    const auto *column = GetColumn(predicate.col_id);
+    UNUSED_ATTRIBUTE bool filtered = column->Filter(
+        static_cast<ExpressionType>(predicate.comparison_operator),
+        predicate.predicate_value, sel, num_sel, num_sel);
+    PELOTON_ASSERT(filtered);
+  }
+  num_out = num_sel;
+  return true;
+}
+
+size_t CompressedTileGroup::GetCompressedSize() const {
+  size_t size = 0;
+  for (const auto &column : columns_) {
+    if (column != nullptr) size += column->GetCompressedSize();
+  }
+  return size;
+}
+
+const std::string CompressedTileGroup::GetInfo() const {
+  std::ostringstream os;
+  os << "CompressedTileGroup[tuples=" << num_tuples_
+     << ", bytes=" << GetCompressedSize() << "] (";
+  for (oid_t col_itr = 0; col_itr < columns_.size(); col_itr++) {
+    if (col_itr > 0) os << ", ";
+    if (columns_[col_itr] == nullptr) {
+      os << "UNCOMPRESSED";
+    } else {
+      os << columns_[col_itr]->GetCompressionType();
+    }
+  }
+  os << ")";
+  return os.str();
+}
+
+}  // namespace storage
+}  // namespace peloton
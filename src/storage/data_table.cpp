@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <mutex>
 #include <utility>
 
@@ -27,6 +28,7 @@
 #include "gc/gc_manager_factory.h"
 #include "index/index.h"
 #include "logging/log_manager.h"
+#include "settings/settings_manager.h"
 #include "storage/abstract_table.h"
 #include "storage/data_table.h"
 #include "storage/database.h"
@@ -77,6 +79,11 @@ DataTable::DataTable(catalog::Schema *schema, const std::string &table_name,
     active_indirection_array_count_ = default_active_indirection_array_count_;
   }
 
+  // Catalog tables always append new versions
+  delta_storage_ =
+      !is_catalog && settings::SettingsManager::GetBool(
+                         settings::SettingId::delta_version_storage);
+
   active_tile_groups_.resize(active_tilegroup_count_);
 
   active_indirection_arrays_.resize(active_indirection_array_count_);
@@ -288,6 +295,22 @@ ItemPointer DataTable::AcquireVersion() {
   return location;
 }
 
+bool DataTable::CanUpdateInPlace(const std::vector<oid_t> &column_ids) {
+  if (!UsesDeltaStorage()) return false;
+
+  for (oid_t index_itr = 0; index_itr < GetIndexCount(); index_itr++) {
+    auto index = GetIndex(index_itr);
+    if (index == nullptr) continue;
+    for (auto key_attr : index->GetMetadata()->GetKeyAttrs()) {
+      if (std::find(column_ids.begin(), column_ids.end(), key_attr) !=
+          column_ids.end()) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 bool DataTable::InstallVersion(const AbstractTuple *tuple,
                                const TargetList *targets_ptr,
                                concurrency::TransactionContext *transaction,
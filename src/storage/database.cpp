@@ -19,6 +19,7 @@
 #include "index/index.h"
 #include "storage/database.h"
 #include "storage/table_factory.h"
+#include "tuning/tile_group_freezer.h"
 
 namespace peloton {
 namespace storage {
@@ -29,6 +30,7 @@ Database::~Database() {
   // Clean up all the tables
   LOG_TRACE("Deleting tables from database");
   for (auto table : tables) {
+    tuning::TileGroupFreezer::GetInstance().RemoveTable(table);
     delete table;
   }
 
@@ -49,6 +51,9 @@ void Database::AddTable(storage::DataTable *table, bool is_catalog) {
       auto *gc_manager = &gc::GCManagerFactory::GetInstance();
       assert(gc_manager != nullptr);
       gc_manager->RegisterTable(table->GetOid());
+
+      // Let the freezer compress its cold tile groups (if it is running)
+      tuning::TileGroupFreezer::GetInstance().AddTable(table);
     }
   }
 }
@@ -81,6 +86,8 @@ void Database::DropTableWithOid(const oid_t table_oid) {
     oid_t table_offset = 0;
     for (auto table : tables) {
       if (table->GetOid() == table_oid) {
+        // Waits for the freezer to finish with the table
+        tuning::TileGroupFreezer::GetInstance().RemoveTable(table);
         delete table;
         break;
       }
@@ -21,7 +21,9 @@
 #include "type/ephemeral_pool.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "storage/backend_manager.h"
+#include "storage/compressed_tile_group.h"
 #include "storage/tile.h"
+#include "storage/tile_group.h"
 #include "storage/tile_group_header.h"
 #include "storage/tuple.h"
 #include "storage/tuple_iterator.h"
@@ -39,6 +41,8 @@ Tile::Tile(BackendType backend_type, TileGroupHeader *tile_header,
       backend_type(backend_type),
       schema(tuple_schema),
       data(NULL),
+      thawed_(false),
+      droppability_(Droppability::UNKNOWN),
       tile_group(tile_group),
       pool(NULL),
       num_tuple_slots(tuple_count),
@@ -57,11 +61,12 @@ Tile::Tile(BackendType backend_type, TileGroupHeader *tile_header,
   // data = reinterpret_cast<char *>(
   // storage_manager.Allocate(backend_type, tile_size));
 
-  data = new char[tile_size];
-  PELOTON_ASSERT(data != NULL);
+  char *tuple_slots = new char[tile_size];
+  PELOTON_ASSERT(tuple_slots != NULL);
 
   // zero out the data
-  PELOTON_MEMSET(data, 0, tile_size);
+  PELOTON_MEMSET(tuple_slots, 0, tile_size);
+  data.store(tuple_slots);
 
   // allocate pool for blob storage if schema not inlined
   // if (schema.IsInlined() == false) {
@@ -74,8 +79,8 @@ Tile::~Tile() {
   // auto &storage_manager = storage::StorageManager::GetInstance();
   // storage_manager.Release(backend_type, data);
 
-  delete[] data;
-  data = NULL;
+  delete[] data.load();
+  data.store(NULL);
 
   // reclaim the tile memory (UNINLINED data)
   // if (schema.IsInlined() == false) {
@@ -100,7 +105,7 @@ void Tile::InsertTuple(const oid_t tuple_offset, Tuple *tuple) {
   PELOTON_ASSERT(tuple_offset < GetAllocatedTupleCount());
 
   // Find slot location
-  char *location = tuple_offset * tuple_length + data;
+  char *location = GetTupleLocation(tuple_offset);
 
   // Copy over the tuple data into the tuple slot in the tile
   PELOTON_MEMCPY(location, tuple->tuple_data_, tuple_length);
@@ -197,8 +202,8 @@ Tile *Tile::CopyTile(BackendType backend_type) {
       backend_type, INVALID_OID, INVALID_OID, INVALID_OID, INVALID_OID,
       new_header, *schema, tile_group, allocated_tuple_count);
 
-  PELOTON_MEMCPY(static_cast<void *>(new_tile->data), static_cast<void *>(data),
-            tile_size);
+  PELOTON_MEMCPY(static_cast<void *>(new_tile->GetTupleLocation(0)),
+                 static_cast<void *>(GetTupleLocation(0)), tile_size);
 
   // Do a deep copy if some column is uninlined, so that
   // the values in that column point to the new pool
@@ -484,6 +489,79 @@ void Tile::Sync() {
   // storage_manager.Sync(backend_type, data, tile_size);
 }
 
+//===--------------------------------------------------------------------===//
+// Frozen tiles
+//===--------------------------------------------------------------------===//
+
+std::vector<oid_t> Tile::GetTileGroupColumns() const {
+  std::vector<oid_t> tile_group_columns(column_count, INVALID_OID);
+  for (const auto &tile_entry : tile_group->GetLayout().GetTileMap()) {
+    if (tile_group->GetTile(tile_entry.first) != this) continue;
+    for (const auto &column_entry : tile_entry.second) {
+      tile_group_columns[column_entry.second] = column_entry.first;
+    }
+  }
+  return tile_group_columns;
+}
+
+char *Tile::DropTupleSlots() {
+  if (data.load() == nullptr || tile_group == nullptr) {
+    return nullptr;
+  }
+  auto compressed_tile_group = tile_group->GetCompressedTileGroup();
+  if (compressed_tile_group == nullptr) {
+    return nullptr;
+  }
+
+  if (droppability_ == Droppability::UNKNOWN) {
+    // The slots of uninlined columns point into the pool, so only inlined
+    // columns can be decoded into them
+    droppability_ = Droppability::DROPPABLE;
+    std::vector<oid_t> tile_group_columns = GetTileGroupColumns();
+    for (oid_t tile_column = 0; tile_column < column_count; tile_column++) {
+      oid_t column_id = tile_group_columns[tile_column];
+      if (!schema.IsInlined(tile_column) || column_id == INVALID_OID ||
+          compressed_tile_group->GetColumn(column_id) == nullptr) {
+        droppability_ = Droppability::NOT_DROPPABLE;
+        break;
+      }
+    }
+  }
+  if (droppability_ != Droppability::DROPPABLE) {
+    return nullptr;
+  }
+  return data.exchange(nullptr);
+}
+
+char *Tile::ThawTupleSlots() const {
+  auto compressed_tile_group = tile_group->GetCompressedTileGroup();
+  PELOTON_ASSERT(compressed_tile_group != nullptr);
+
+  char *tuple_slots = new char[tile_size];
+  PELOTON_MEMSET(tuple_slots, 0, tile_size);
+  std::vector<oid_t> tile_group_columns = GetTileGroupColumns();
+  for (oid_t tile_column = 0; tile_column < column_count; tile_column++) {
+    auto *column =
+        compressed_tile_group->GetColumn(tile_group_columns[tile_column]);
+    PELOTON_ASSERT(column != nullptr);
+    char *field = tuple_slots + schema.GetOffset(tile_column);
+    for (oid_t tuple_offset = 0; tuple_offset < column->GetTupleCount();
+         tuple_offset++, field += tuple_length) {
+      column->GetValue(tuple_offset).SerializeTo(field, true, nullptr);
+    }
+  }
+
+  // Readers that find the slots dropped at the same time all decode them.
+  // The first one installs its copy, which the others use.
+  char *installed = nullptr;
+  if (!data.compare_exchange_strong(installed, tuple_slots)) {
+    delete[] tuple_slots;
+    return installed;
+  }
+  thawed_.store(true);
+  return tuple_slots;
+}
+
 //===--------------------------------------------------------------------===//
 // Utilities
 //===--------------------------------------------------------------------===//
@@ -12,6 +12,7 @@
 
 #include "storage/tile_group.h"
 
+#include <cstring>
 #include <numeric>
 
 #include "storage/storage_manager.h"
@@ -332,6 +333,25 @@ void TileGroup::SetValue(type::Value &value, oid_t tuple_id,
   GetTile(tile_offset)->SetValue(value, tuple_id, tile_column_id);
 }
 
+char *TileGroup::GetValueLocation(oid_t tuple_id, oid_t column_id) const {
+  PELOTON_ASSERT(tuple_id < GetNextTupleSlot());
+  oid_t tile_column_id, tile_offset;
+  tile_group_layout_->LocateTileAndColumn(column_id, tile_offset,
+                                          tile_column_id);
+  auto tile = GetTile(tile_offset);
+  return tile->GetTupleLocation(tuple_id) +
+         tile->GetSchema()->GetOffset(tile_column_id);
+}
+
+void TileGroup::ReadTuple(const oid_t &tuple_slot_id, Tuple *tuple) const {
+  auto schema = tuple->GetSchema();
+  oid_t column_count = schema->GetColumnCount();
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    std::memcpy(tuple->GetDataPtr(column_itr),
+                GetValueLocation(tuple_slot_id, column_itr),
+                schema->GetColumn(column_itr).GetFixedLength());
+  }
+}
 
 std::shared_ptr<Tile> TileGroup::GetTileReference(
     const oid_t tile_offset) const {
@@ -12,6 +12,7 @@
 
 #include "storage/tile_group_factory.h"
 // #include "logging/logging_util.h"
+#include "storage/abstract_table.h"
 #include "storage/tile_group_header.h"
 
 //===--------------------------------------------------------------------===//
@@ -36,7 +37,11 @@ TileGroup *TileGroupFactory::GetTileGroup(
     throw NullPointerException("Layout of the TileGroup must be non-null.");
   }
 
-  TileGroupHeader *tile_header = new TileGroupHeader(backend_type, tuple_count);
+  LayoutType header_layout =
+      table != nullptr ? table->GetTupleHeaderLayout() : LayoutType::ROW;
+  bool has_undo_chains = table != nullptr && table->UsesDeltaStorage();
+  TileGroupHeader *tile_header = new TileGroupHeader(
+      backend_type, tuple_count, header_layout, has_undo_chains);
   TileGroup *tile_group = new TileGroup(backend_type, tile_header, table,
                                         schemas, layout, tuple_count);
 
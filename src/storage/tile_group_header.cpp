@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 #include "storage/tile_group_header.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
@@ -26,18 +27,47 @@
 #include "storage/backend_manager.h"
 #include "type/value.h"
 #include "storage/tuple.h"
+#include "storage/undo_record.h"
 
 namespace peloton {
 namespace storage {
 
 TileGroupHeader::TileGroupHeader(const BackendType &backend_type,
-                                 const int &tuple_count)
+                                 const int &tuple_count,
+                                 LayoutType layout_type,
+                                 bool has_undo_chains)
     : backend_type(backend_type),
       tile_group(nullptr),
+      layout_type_(layout_type),
       num_tuple_slots(tuple_count),
       next_tuple_slot(0),
-      tile_header_lock() {
-  tuple_headers_.reset(new TupleHeader[tuple_count]);
+      tile_header_lock(),
+      all_visible_cid(MAX_CID),
+      modification_count_(0) {
+  if (layout_type_ == LayoutType::COLUMN) {
+    tuple_header_columns_.reset(new TupleHeaderColumns(tuple_count));
+    auto &columns = *tuple_header_columns_;
+    latches_ = {columns.latch.get(), sizeof(columns.latch[0])};
+    txn_ids_ = {columns.txn_id.get(), sizeof(columns.txn_id[0])};
+    read_ts_ = {columns.read_ts.get(), sizeof(cid_t)};
+    begin_ts_ = {columns.begin_ts.get(), sizeof(cid_t)};
+    end_ts_ = {columns.end_ts.get(), sizeof(cid_t)};
+    next_ = {columns.next.get(), sizeof(ItemPointer)};
+    prev_ = {columns.prev.get(), sizeof(ItemPointer)};
+    indirections_ = {columns.indirection.get(), sizeof(ItemPointer *)};
+  } else {
+    PELOTON_ASSERT(layout_type_ == LayoutType::ROW);
+    tuple_headers_.reset(new TupleHeader[tuple_count]);
+    auto *headers = tuple_headers_.get();
+    latches_ = {&headers->latch, sizeof(TupleHeader)};
+    txn_ids_ = {&headers->txn_id, sizeof(TupleHeader)};
+    read_ts_ = {&headers->read_ts, sizeof(TupleHeader)};
+    begin_ts_ = {&headers->begin_ts, sizeof(TupleHeader)};
+    end_ts_ = {&headers->end_ts, sizeof(TupleHeader)};
+    next_ = {&headers->next, sizeof(TupleHeader)};
+    prev_ = {&headers->prev, sizeof(TupleHeader)};
+    indirections_ = {&headers->indirection, sizeof(TupleHeader)};
+  }
 
   // Set MVCC Initial Value
   for (oid_t tuple_slot_id = START_OID; tuple_slot_id < num_tuple_slots;
@@ -51,10 +81,27 @@ TileGroupHeader::TileGroupHeader(const BackendType &backend_type,
     SetIndirection(tuple_slot_id, nullptr);
   }
 
+  if (has_undo_chains) {
+    undo_chains_.reset(new std::atomic<UndoRecord *>[tuple_count]);
+    for (oid_t tuple_slot_id = START_OID; tuple_slot_id < num_tuple_slots;
+         tuple_slot_id++) {
+      SetUndoRecord(tuple_slot_id, nullptr);
+    }
+  }
+
   // Initially immutabile flag to false initially.
   immutable = false;
 }
 
+TileGroupHeader::~TileGroupHeader() {
+  if (HasUndoChains()) {
+    for (oid_t tuple_slot_id = START_OID; tuple_slot_id < num_tuple_slots;
+         tuple_slot_id++) {
+      UndoRecord::FreeChain(GetUndoRecord(tuple_slot_id));
+    }
+  }
+}
+
 //===--------------------------------------------------------------------===//
 // Tile Group Header
 //===--------------------------------------------------------------------===//
@@ -224,5 +271,34 @@ oid_t TileGroupHeader::GetActiveTupleCount() const {
   return active_tuple_slots;
 }
 
+bool TileGroupHeader::MarkAllVisible() {
+  if (HasUndoChains() || GetCurrentNextTupleSlot() < num_tuple_slots) {
+    return false;
+  }
+
+  // Claim the mark first, so that a transaction taking ownership of a version
+  // we have already checked drops it and the final swap below fails
+  cid_t marking_cid = MAX_CID - 1;
+  cid_t expected = MAX_CID;
+  if (!all_visible_cid.compare_exchange_strong(expected, marking_cid)) {
+    return expected != marking_cid;
+  }
+
+  cid_t max_begin_cid = INVALID_CID;
+  for (oid_t tuple_slot_id = START_OID; tuple_slot_id < num_tuple_slots;
+       tuple_slot_id++) {
+    if (GetTransactionId(tuple_slot_id) != INITIAL_TXN_ID ||
+        GetEndCommitId(tuple_slot_id) != MAX_CID) {
+      expected = marking_cid;
+      all_visible_cid.compare_exchange_strong(expected, MAX_CID);
+      return false;
+    }
+    max_begin_cid = std::max(max_begin_cid, GetBeginCommitId(tuple_slot_id));
+  }
+
+  expected = marking_cid;
+  return all_visible_cid.compare_exchange_strong(expected, max_begin_cid);
+}
+
 }  // namespace storage
 }  // namespace peloton
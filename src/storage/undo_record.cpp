@@ -0,0 +1,177 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// undo_record.cpp
+//
+// Identification: src/storage/undo_record.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/undo_record.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <new>
+
+#include "catalog/schema.h"
+#include "storage/abstract_table.h"
+#include "storage/tile_group.h"
+#include "storage/tuple.h"
+
+namespace peloton {
+namespace storage {
+
+//===--------------------------------------------------------------------===//
+// Undo Buffer
+//===--------------------------------------------------------------------===//
+
+/**
+ * A block of memory that undo records are carved out of. It is freed when
+ * both the undo buffer that fills it and all of its records are done with it.
+ */
+class UndoSegment {
+ public:
+  explicit UndoSegment(size_t size)
+      : data_(new char[size]), size_(size), used_(0), ref_count_(1) {}
+
+  // Carve out a block of the segment, nullptr if it is full
+  void *Allocate(size_t size) {
+    size_t offset = (used_ + alignof(UndoRecord) - 1) &
+                    ~(alignof(UndoRecord) - 1);
+    if (offset + size > size_) return nullptr;
+    used_ = offset + size;
+    ref_count_.fetch_add(1);
+    return data_.get() + offset;
+  }
+
+  // Drop one reference, and free the segment with the last one
+  void Release() {
+    if (ref_count_.fetch_sub(1) == 1) delete this;
+  }
+
+ private:
+  std::unique_ptr<char[]> data_;
+  size_t size_;
+  size_t used_;
+
+  // One reference for the undo buffer while it fills the segment, plus one
+  // per record that was not freed yet
+  std::atomic<uint32_t> ref_count_;
+};
+
+namespace {
+
+// The size of the segments that hold regular records
+const size_t kUndoSegmentSize = 64 * 1024;
+
+/**
+ * The undo buffer of a thread. Records are bump allocated from the current
+ * segment, so that the records of a transaction sit next to each other and
+ * no allocator lock is taken per update.
+ */
+class UndoBuffer {
+ public:
+  UndoBuffer() : segment_(nullptr) {}
+
+  ~UndoBuffer() {
+    if (segment_ != nullptr) segment_->Release();
+  }
+
+  void *Allocate(size_t size, UndoSegment *&segment) {
+    void *block = segment_ == nullptr ? nullptr : segment_->Allocate(size);
+    if (block == nullptr) {
+      if (segment_ != nullptr) segment_->Release();
+      segment_ = new UndoSegment(std::max(size, kUndoSegmentSize));
+      block = segment_->Allocate(size);
+    }
+    segment = segment_;
+    return block;
+  }
+
+ private:
+  UndoSegment *segment_;
+};
+
+thread_local UndoBuffer undo_buffer;
+
+}  // namespace
+
+//===--------------------------------------------------------------------===//
+// Undo Record
+//===--------------------------------------------------------------------===//
+
+UndoRecord *UndoRecord::Create(txn_id_t txn_id, cid_t begin_cid,
+                               TileGroup *tile_group, oid_t tuple_id,
+                               const std::vector<oid_t> &column_ids) {
+  auto schema = tile_group->GetAbstractTable()->GetSchema();
+  size_t size = sizeof(UndoRecord) + column_ids.size() * sizeof(oid_t);
+  for (auto column_id : column_ids) {
+    size += schema->GetColumn(column_id).GetFixedLength();
+  }
+
+  UndoSegment *segment;
+  void *block = undo_buffer.Allocate(size, segment);
+  auto record = new (block) UndoRecord(txn_id, begin_cid, segment,
+                                       static_cast<oid_t>(column_ids.size()));
+
+  auto record_column_ids = reinterpret_cast<oid_t *>(record + 1);
+  std::copy(column_ids.begin(), column_ids.end(), record_column_ids);
+  auto values = const_cast<char *>(record->GetValues());
+  for (auto column_id : column_ids) {
+    size_t length = schema->GetColumn(column_id).GetFixedLength();
+    std::memcpy(values, tile_group->GetValueLocation(tuple_id, column_id),
+                length);
+    values += length;
+  }
+  return record;
+}
+
+void UndoRecord::Free(UndoRecord *record) {
+  auto segment = record->segment_;
+  record->~UndoRecord();
+  segment->Release();
+}
+
+void UndoRecord::FreeChain(UndoRecord *record) {
+  while (record != nullptr) {
+    auto next = record->GetNext();
+    Free(record);
+    record = next;
+  }
+}
+
+bool UndoRecord::Covers(oid_t column_id) const {
+  auto column_ids = GetColumnIds();
+  return std::find(column_ids, column_ids + column_count_, column_id) !=
+         column_ids + column_count_;
+}
+
+void UndoRecord::ApplyTo(Tuple *tuple) const {
+  auto schema = tuple->GetSchema();
+  auto column_ids = GetColumnIds();
+  auto values = GetValues();
+  for (oid_t column_itr = 0; column_itr < column_count_; column_itr++) {
+    size_t length = schema->GetColumn(column_ids[column_itr]).GetFixedLength();
+    std::memcpy(tuple->GetDataPtr(column_ids[column_itr]), values, length);
+    values += length;
+  }
+}
+
+void UndoRecord::ApplyTo(TileGroup *tile_group, oid_t tuple_id) const {
+  auto schema = tile_group->GetAbstractTable()->GetSchema();
+  auto column_ids = GetColumnIds();
+  auto values = GetValues();
+  for (oid_t column_itr = 0; column_itr < column_count_; column_itr++) {
+    size_t length = schema->GetColumn(column_ids[column_itr]).GetFixedLength();
+    std::memcpy(tile_group->GetValueLocation(tuple_id, column_ids[column_itr]),
+                values, length);
+    values += length;
+  }
+}
+
+}  // namespace storage
+}  // namespace peloton
@@ -0,0 +1,74 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// memory_governor.cpp
+//
+// Identification: src/threadpool/memory_governor.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "threadpool/memory_governor.h"
+
+#include "common/logger.h"
+#include "settings/settings_manager.h"
+#include "threadpool/mono_queue_pool.h"
+
+namespace peloton {
+namespace threadpool {
+
+MemoryGovernor &MemoryGovernor::GetInstance() {
+  static MemoryGovernor governor;
+  return governor;
+}
+
+void MemoryGovernor::SubmitTask(std::function<void()> task, bool is_short) {
+  std::lock_guard<std::mutex> guard(lock_);
+  if (is_short || (waiting_.empty() && CanAdmit())) {
+    Admit(std::move(task));
+  } else {
+    LOG_DEBUG("Queuing task, %lu bytes of query memory in use",
+              (unsigned long)tracker_.GetCurrent());
+    waiting_.push_back(std::move(task));
+  }
+}
+
+uint32_t MemoryGovernor::NumRunning() {
+  std::lock_guard<std::mutex> guard(lock_);
+  return num_running_;
+}
+
+uint32_t MemoryGovernor::NumWaiting() {
+  std::lock_guard<std::mutex> guard(lock_);
+  return static_cast<uint32_t>(waiting_.size());
+}
+
+bool MemoryGovernor::CanAdmit() const {
+  uint64_t budget = static_cast<uint64_t>(settings::SettingsManager::GetInt(
+                        settings::SettingId::server_memory_budget)) *
+                    1024 * 1024;
+  return budget == 0 || num_running_ == 0 || tracker_.GetCurrent() < budget;
+}
+
+void MemoryGovernor::Admit(std::function<void()> task) {
+  num_running_++;
+  MonoQueuePool::GetInstance().SubmitTask([this, task] {
+    task();
+    TaskFinished();
+  });
+}
+
+void MemoryGovernor::TaskFinished() {
+  std::lock_guard<std::mutex> guard(lock_);
+  PELOTON_ASSERT(num_running_ > 0);
+  num_running_--;
+  while (!waiting_.empty() && CanAdmit()) {
+    Admit(std::move(waiting_.front()));
+    waiting_.pop_front();
+  }
+}
+
+}  // namespace threadpool
+}  // namespace peloton
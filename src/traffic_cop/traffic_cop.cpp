@@ -22,6 +22,8 @@
 #include "optimizer/optimizer.h"
 #include "planner/plan_util.h"
 #include "settings/settings_manager.h"
+#include "statistics/backend_stats_context.h"
+#include "threadpool/memory_governor.h"
 #include "threadpool/mono_queue_pool.h"
 
 namespace peloton {
@@ -31,13 +33,17 @@ TrafficCop::TrafficCop()
     : is_queuing_(false),
       rows_affected_(0),
       optimizer_(new optimizer::Optimizer()),
-      single_statement_txn_(true) {}
+      single_statement_txn_(true),
+      connection_memory_(
+          &threadpool::MemoryGovernor::GetInstance().GetTracker()) {}
 
 TrafficCop::TrafficCop(void (*task_callback)(void *), void *task_callback_arg)
     : optimizer_(new optimizer::Optimizer()),
       single_statement_txn_(true),
       task_callback_(task_callback),
-      task_callback_arg_(task_callback_arg) {}
+      task_callback_arg_(task_callback_arg),
+      connection_memory_(
+          &threadpool::MemoryGovernor::GetInstance().GetTracker()) {}
 
 void TrafficCop::Reset() {
   std::stack<TcopTxnState> new_tcop_txn_state;
@@ -152,7 +158,8 @@ ResultType TrafficCop::ExecuteStatementGetResult() {
 executor::ExecutionResult TrafficCop::ExecuteHelper(
     std::shared_ptr<planner::AbstractPlan> plan,
     const std::vector<type::Value> &params, std::vector<ResultValue> &result,
-    const std::vector<int> &result_format, size_t thread_id) {
+    const std::vector<int> &result_format, size_t thread_id,
+    executor::PlanActualRows *actual_rows) {
   auto &curr_state = GetCurrentTxnState();
 
   concurrency::TransactionContext *txn;
@@ -180,21 +187,77 @@ executor::ExecutionResult TrafficCop::ExecuteHelper(
     return p_status_;
   }
 
-  auto on_complete = [&result, this](executor::ExecutionResult p_status,
-                                     std::vector<ResultValue> &&values) {
+  bool stats_enabled =
+      static_cast<StatsType>(settings::SettingsManager::GetInt(
+          settings::SettingId::stats_mode)) != StatsType::INVALID;
+  if (stats_enabled) {
+    execution_timer_.Reset();
+    execution_timer_.Start();
+  }
+
+  // The memory of the query counts towards the connection's, and is reported
+  // with the statistics of the query
+  std::shared_ptr<MemoryTracker> query_memory(
+      new MemoryTracker(&connection_memory_));
+  if (stats_enabled) {
+    auto *query_metric =
+        stats::BackendStatsContext::GetInstance()->GetOnGoingQueryMetric();
+    if (query_metric != nullptr) {
+      query_metric->SetMemoryTracker(query_memory);
+    }
+  }
+
+  // Short queries finish faster than we could hand them off to the execution
+  // pool and get notified back, so run them to completion on this thread.
+  if (settings::SettingsManager::GetBool(
+          settings::SettingId::inline_short_queries) &&
+      planner::PlanUtil::IsShortQuery(plan.get())) {
+    auto on_complete_inline = [&result, this](
+        executor::ExecutionResult p_status, std::vector<ResultValue> &&values) {
+      this->p_status_ = p_status;
+      this->error_message_ = std::move(p_status.m_error_message);
+      result = std::move(values);
+    };
+    executor::PlanExecutor::ExecutePlan(plan, txn, params, result_format,
+                                        on_complete_inline, actual_rows,
+                                        query_memory.get());
+    if (stats_enabled) {
+      execution_timer_.Stop();
+      stats::BackendStatsContext::GetInstance()->IncrementInlineQueries(
+          execution_timer_.GetDuration());
+    }
+
+    is_queuing_ = false;
+    ExecuteStatementPlanGetResult();
+    return p_status_;
+  }
+
+  auto on_complete = [&result, stats_enabled, this](
+      executor::ExecutionResult p_status, std::vector<ResultValue> &&values) {
     this->p_status_ = p_status;
     // TODO (Tianyi) I would make a decision on keeping one of p_status or
     // error_message in my next PR
     this->error_message_ = std::move(p_status.m_error_message);
     result = std::move(values);
+    if (stats_enabled) {
+      this->execution_timer_.Stop();
+      stats::BackendStatsContext::GetInstance()->IncrementQueuedQueries(
+          this->execution_timer_.GetDuration());
+    }
     task_callback_(task_callback_arg_);
   };
 
-  auto &pool = threadpool::MonoQueuePool::GetInstance();
-  pool.SubmitTask([plan, txn, &params, &result_format, on_complete] {
-    executor::PlanExecutor::ExecutePlan(plan, txn, params, result_format,
-                                        on_complete);
-  });
+  // Queries that may run long wait for memory if the server is short of it,
+  // short ones are run right away whether or not they are inlined
+  auto &governor = threadpool::MemoryGovernor::GetInstance();
+  governor.SubmitTask(
+      [plan, txn, &params, &result_format, on_complete, actual_rows,
+       query_memory] {
+        executor::PlanExecutor::ExecutePlan(plan, txn, params, result_format,
+                                            on_complete, actual_rows,
+                                            query_memory.get());
+      },
+      planner::PlanUtil::IsShortQuery(plan.get()));
 
   is_queuing_ = true;
 
@@ -203,6 +266,86 @@ executor::ExecutionResult TrafficCop::ExecuteHelper(
   return p_status_;
 }
 
+ResultType TrafficCop::ExecuteStatementBatch(
+    const std::shared_ptr<Statement> &statement,
+    std::vector<std::vector<type::Value>> &batch_params,
+    std::vector<executor::ExecutionResult> &batch_results,
+    const std::vector<int> &result_format, size_t thread_id) {
+  PELOTON_ASSERT(!statement->GetNeedsReplan());
+  auto &curr_state = GetCurrentTxnState();
+
+  concurrency::TransactionContext *txn;
+  if (!tcop_txn_state_.empty()) {
+    txn = curr_state.first;
+  } else {
+    // No active txn, the whole batch runs in a single-statement txn
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    curr_state.second = ResultType::SUCCESS;
+    single_statement_txn_ = true;
+    txn = txn_manager.BeginTransaction(thread_id);
+    tcop_txn_state_.emplace(txn, ResultType::SUCCESS);
+  }
+
+  batch_results.clear();
+  // skip if already aborted
+  if (curr_state.second == ResultType::ABORTED) {
+    p_status_.m_result = ResultType::TO_ABORT;
+    return ExecuteStatementGetResult();
+  }
+
+  auto on_complete = [this](executor::ExecutionResult p_status) {
+    this->p_status_ = p_status;
+    this->error_message_ = std::move(p_status.m_error_message);
+    task_callback_(task_callback_arg_);
+  };
+
+  // The memory of the batch counts towards the connection's, like that of a
+  // single query
+  std::shared_ptr<MemoryTracker> query_memory(
+      new MemoryTracker(&connection_memory_));
+  if (static_cast<StatsType>(settings::SettingsManager::GetInt(
+          settings::SettingId::stats_mode)) != StatsType::INVALID) {
+    auto *query_metric =
+        stats::BackendStatsContext::GetInstance()->GetOnGoingQueryMetric();
+    if (query_metric != nullptr) {
+      query_metric->SetMemoryTracker(query_memory);
+    }
+  }
+
+  // Batches may run long, so they wait for memory like any other query
+  auto plan = statement->GetPlanTree();
+  auto &governor = threadpool::MemoryGovernor::GetInstance();
+  governor.SubmitTask([plan, txn, &batch_params, &batch_results,
+                       &result_format, on_complete, query_memory] {
+    // The binds of the batch all set their parameters on the plan already
+    plan->ClearParameterValues();
+
+    executor::ExecutionResult batch_status;
+    for (auto &params : batch_params) {
+      executor::ExecutionResult status;
+      plan->SetParameterValues(&params);
+      executor::PlanExecutor::ExecutePlan(
+          plan, txn, params, result_format,
+          [&status](executor::ExecutionResult p_status,
+                    std::vector<ResultValue> &&) { status = p_status; },
+          nullptr, query_memory.get());
+      batch_results.push_back(status);
+
+      batch_status.m_processed += status.m_processed;
+      if (status.m_result != ResultType::SUCCESS ||
+          txn->GetResult() == ResultType::FAILURE) {
+        batch_status.m_result = status.m_result;
+        batch_status.m_error_message = std::move(status.m_error_message);
+        break;
+      }
+    }
+    on_complete(batch_status);
+  });
+
+  is_queuing_ = true;
+  return ResultType::QUEUING;
+}
+
 void TrafficCop::ExecuteStatementPlanGetResult() {
   if (p_status_.m_result == ResultType::FAILURE) return;
 
@@ -0,0 +1,218 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_freezer.cpp
+//
+// Identification: src/tuning/tile_group_freezer.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "tuning/tile_group_freezer.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "common/logger.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "storage/compressed_tile_group.h"
+#include "storage/data_table.h"
+#include "storage/tile.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+
+namespace peloton {
+namespace tuning {
+
+TileGroupFreezer &TileGroupFreezer::GetInstance() {
+  static TileGroupFreezer tile_group_freezer;
+  return tile_group_freezer;
+}
+
+TileGroupFreezer::TileGroupFreezer() {}
+
+TileGroupFreezer::~TileGroupFreezer() {
+  for (auto &dropped : dropped_tuple_slots) {
+    delete[] dropped.second;
+  }
+}
+
+void TileGroupFreezer::Start() {
+  // Set signal
+  freezer_stop = false;
+
+  // Launch thread
+  freezer_thread = std::thread(&tuning::TileGroupFreezer::Freeze, this);
+
+  LOG_INFO("Started tile group freezer");
+}
+
+void TileGroupFreezer::Freeze() {
+  // Continue till signal is not false
+  while (freezer_stop == false) {
+    {
+      std::lock_guard<std::mutex> lock(freezer_mutex);
+      for (auto table : tables) {
+        UNUSED_ATTRIBUTE oid_t frozen_count = FreezeTable(table);
+        LOG_TRACE("Froze %u tile groups of table %u", frozen_count,
+                  table->GetOid());
+      }
+    }
+    FreeDroppedTupleSlots();
+
+    // Sleep a bit
+    std::this_thread::sleep_for(std::chrono::milliseconds(sleep_duration));
+  }
+}
+
+void TileGroupFreezer::Stop() {
+  // Stop freezing
+  freezer_stop = true;
+
+  // Stop thread
+  freezer_thread.join();
+
+  LOG_INFO("Stopped tile group freezer");
+}
+
+oid_t TileGroupFreezer::FreezeTable(storage::DataTable *table) {
+  oid_t frozen_count = 0;
+  size_t tile_group_count = table->GetTileGroupCount();
+  for (oid_t offset = 0; offset < tile_group_count; offset++) {
+    auto tile_group = table->GetTileGroup(offset);
+    if (tile_group == nullptr) {
+      continue;
+    }
+    if (FreezeTileGroup(tile_group.get())) {
+      frozen_count++;
+    }
+    if (tile_group->GetCompressedTileGroup() != nullptr) {
+      DropTupleSlots(tile_group.get());
+    }
+
+    // Let scans skip the visibility checks of tile groups that hold no old
+    // or uncommitted versions, frozen or not
+    if (tile_group->GetHeader()->GetAllVisibleCommitId() == MAX_CID) {
+      tile_group->GetHeader()->MarkAllVisible();
+    }
+  }
+  return frozen_count;
+}
+
+bool TileGroupFreezer::FreezeTileGroup(storage::TileGroup *tile_group) {
+  if (tile_group->GetCompressedTileGroup() != nullptr) {
+    return false;
+  }
+
+  // Only full tile groups are candidates. Tile groups with undo chains are
+  // updated in place, which would leave the compressed columns behind.
+  auto *header = tile_group->GetHeader();
+  if (header->HasUndoChains()) {
+    return false;
+  }
+  oid_t num_tuple_slots = tile_group->GetAllocatedTupleCount();
+  if (header->GetCurrentNextTupleSlot() < num_tuple_slots) {
+    return false;
+  }
+
+  // Every slot must hold a committed version that no transaction owns. This
+  // excludes in-flight inserts, whose data may still be being written, and
+  // slots that GC reset for reuse. GC resets and recycles slots under the
+  // header latch, so holding it while we check and mark the tile group
+  // immutable means that GC either recycled a slot before (and we don't
+  // freeze) or never recycles slots of the tile group again.
+  bool is_cold = true;
+  header->GetHeaderLock().Lock();
+  for (oid_t tuple_itr = 0; tuple_itr < num_tuple_slots; tuple_itr++) {
+    if (header->GetTransactionId(tuple_itr) != INITIAL_TXN_ID) {
+      is_cold = false;
+      break;
+    }
+  }
+  if (is_cold) {
+    header->SetImmutability();
+  }
+  header->GetHeaderLock().Unlock();
+  if (!is_cold) {
+    return false;
+  }
+
+  std::shared_ptr<const storage::CompressedTileGroup> compressed{
+      storage::CompressedTileGroup::Compress(tile_group)};
+  tile_group->SetCompressedTileGroup(compressed);
+
+  LOG_DEBUG("Froze tile group %u: %s", tile_group->GetTileGroupId(),
+            compressed->GetInfo().c_str());
+  return true;
+}
+
+oid_t TileGroupFreezer::DropTupleSlots(storage::TileGroup *tile_group) {
+  oid_t dropped_count = 0;
+  eid_t epoch_id =
+      concurrency::EpochManagerFactory::GetInstance().GetCurrentEpochId();
+  for (oid_t tile_offset = 0; tile_offset < tile_group->GetTileCount();
+       tile_offset++) {
+    auto *tile = tile_group->GetTile(tile_offset);
+    // A tile that was decoded since the last pass is likely still in use
+    if (tile->TestAndClearThawed()) {
+      continue;
+    }
+    char *tuple_slots = tile->DropTupleSlots();
+    if (tuple_slots != nullptr) {
+      dropped_tuple_slots.emplace_back(epoch_id, tuple_slots);
+      dropped_count++;
+    }
+  }
+  return dropped_count;
+}
+
+void TileGroupFreezer::FreeDroppedTupleSlots() {
+  // Like GC, wait until all transactions that were active when the slots
+  // were dropped are done
+  eid_t expired_eid =
+      concurrency::EpochManagerFactory::GetInstance().GetExpiredEpochId();
+  if (expired_eid == MAX_EID) {
+    return;
+  }
+  auto freed = std::remove_if(
+      dropped_tuple_slots.begin(), dropped_tuple_slots.end(),
+      [expired_eid](const std::pair<eid_t, char *> &dropped) {
+        if (dropped.first > expired_eid) {
+          return false;
+        }
+        delete[] dropped.second;
+        return true;
+      });
+  dropped_tuple_slots.erase(freed, dropped_tuple_slots.end());
+}
+
+void TileGroupFreezer::AddTable(storage::DataTable *table) {
+  {
+    std::lock_guard<std::mutex> lock(freezer_mutex);
+    LOG_TRACE("Tile group freezer adding table : %p", table);
+
+    tables.push_back(table);
+  }
+}
+
+void TileGroupFreezer::RemoveTable(storage::DataTable *table) {
+  {
+    std::lock_guard<std::mutex> lock(freezer_mutex);
+    LOG_TRACE("Tile group freezer removing table : %p", table);
+
+    tables.erase(std::remove(tables.begin(), tables.end(), table),
+                 tables.end());
+  }
+}
+
+void TileGroupFreezer::ClearTables() {
+  {
+    std::lock_guard<std::mutex> lock(freezer_mutex);
+    tables.clear();
+  }
+}
+
+}  // namespace tuning
+}  // namespace peloton
@@ -161,6 +161,7 @@ TEST_F(CatalogTests, CreatingTable) {
                            1,
                            1,
                            1,
+                           1,
                            pool.get());
   auto param1 = catalog->GetSystemCatalogs(database_object->GetDatabaseOid())
                     ->GetQueryMetricsCatalog()
@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include <cstdlib>
+#include <random>
 #include <unordered_set>
 #include <vector>
 
@@ -188,6 +189,45 @@ TEST_F(BloomFilterCodegenTest, FalsePositiveRateTest) {
   bloom_filter.Destroy();
 }
 
+TEST_F(BloomFilterCodegenTest, BatchedProbeTest) {
+  // Insert every other hash, and probe with all of them in a single batch
+  // whose size isn't a multiple of the SIMD width
+  const uint32_t size = 10001;
+  std::mt19937_64 rng(15721);
+  std::vector<uint64_t> hashes;
+  for (uint32_t i = 0; i < size; i++) {
+    hashes.push_back(rng());
+  }
+
+  codegen::util::BloomFilter bloom_filter;
+  bloom_filter.Init(size / 2);
+  for (uint32_t i = 0; i < size; i += 2) {
+    bloom_filter.Add(hashes[i]);
+  }
+
+  std::vector<uint32_t> selection_vector(size);
+  for (uint32_t i = 0; i < size; i++) {
+    selection_vector[i] = i;
+  }
+  uint32_t num_found =
+      bloom_filter.Filter(hashes.data(), selection_vector.data(), size);
+
+  // The batched probe keeps exactly the positions that a single probe finds,
+  // in order, which includes every inserted number
+  std::vector<uint32_t> expected;
+  for (uint32_t i = 0; i < size; i++) {
+    if (bloom_filter.Contains(hashes[i])) {
+      expected.push_back(i);
+    } else {
+      EXPECT_NE(0u, i % 2);
+    }
+  }
+  selection_vector.resize(num_found);
+  EXPECT_EQ(expected, selection_vector);
+
+  bloom_filter.Destroy();
+}
+
 // Testing whether bloom filter can improve the performance of hash join
 // when the hash table is bigger than L3 cache and selectivity is low
 TEST_F(BloomFilterCodegenTest, PerformanceTest) {
@@ -0,0 +1,232 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// compressed_scan_test.cpp
+//
+// Identification: test/codegen/compressed_scan_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/query_cache.h"
+#include "codegen/query_compiler.h"
+#include "common/harness.h"
+#include "expression/conjunction_expression.h"
+#include "expression/constant_value_expression.h"
+#include "planner/seq_scan_plan.h"
+#include "storage/compressed_tile_group.h"
+#include "storage/tile.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "tuning/tile_group_freezer.h"
+
+#include "codegen/testing_codegen_util.h"
+
+namespace peloton {
+namespace test {
+
+class CompressedScanTest : public PelotonCodeGenTest {
+ public:
+  CompressedScanTest(LayoutType layout_type = LayoutType::ROW)
+      : PelotonCodeGenTest(TEST_TUPLES_PER_TILEGROUP, layout_type),
+        num_rows_to_insert(64) {
+    // Load test table
+    LoadTestTable(TestTableId(), num_rows_to_insert);
+
+    // Freeze all the full tile groups
+    auto &freezer = tuning::TileGroupFreezer::GetInstance();
+    num_frozen = freezer.FreezeTable(&GetTestTable(TestTableId()));
+  }
+
+  uint32_t NumRowsInTestTable() const { return num_rows_to_insert; }
+
+  oid_t TestTableId() { return test_table_oids[0]; }
+
+  size_t ScanCount(expression::AbstractExpression *predicate) {
+    planner::SeqScanPlan scan{&GetTestTable(TestTableId()), predicate,
+                              {0, 1, 2}};
+    planner::BindingContext context;
+    scan.PerformBinding(context);
+    codegen::BufferingConsumer buffer{{0, 1, 2}, context};
+    CompileAndExecute(scan, buffer);
+    return buffer.GetOutputTuples().size();
+  }
+
+ protected:
+  uint32_t num_rows_to_insert;
+  oid_t num_frozen;
+};
+
+TEST_F(CompressedScanTest, FreezeFullTileGroups) {
+  auto &table = GetTestTable(TestTableId());
+  EXPECT_GT(num_frozen, 0);
+
+  oid_t num_compressed = 0;
+  for (oid_t offset = 0; offset < table.GetTileGroupCount(); offset++) {
+    auto tile_group = table.GetTileGroup(offset);
+    auto compressed = tile_group->GetCompressedTileGroup();
+
+    // Exactly the full tile groups are frozen
+    bool is_full = tile_group->GetNextTupleSlot() ==
+                   tile_group->GetAllocatedTupleCount();
+    EXPECT_EQ(is_full, compressed != nullptr);
+    // and all their versions are visible to later transactions
+    EXPECT_EQ(is_full,
+              tile_group->GetHeader()->GetAllVisibleCommitId() != MAX_CID);
+    if (compressed == nullptr) {
+      continue;
+    }
+    num_compressed++;
+    EXPECT_TRUE(tile_group->GetHeader()->GetImmutability());
+
+    // The integer and varchar columns are compressed, the decimal one isn't
+    EXPECT_NE(nullptr, compressed->GetColumn(0));
+    EXPECT_NE(nullptr, compressed->GetColumn(1));
+    EXPECT_EQ(nullptr, compressed->GetColumn(2));
+    EXPECT_NE(nullptr, compressed->GetColumn(3));
+
+    // The compressed values must match the original ones
+    for (oid_t tuple_id = 0; tuple_id < compressed->GetTupleCount();
+         tuple_id++) {
+      for (oid_t col_id : {0, 1, 3}) {
+        EXPECT_EQ(CmpBool::CmpTrue,
+                  compressed->GetColumn(col_id)->GetValue(tuple_id).CompareEquals(
+                      tile_group->GetValue(tuple_id, col_id)));
+      }
+    }
+  }
+
+  EXPECT_EQ(num_frozen, num_compressed);
+
+  // Freezing again is a no-op
+  EXPECT_EQ(0, tuning::TileGroupFreezer::GetInstance().FreezeTable(&table));
+}
+
+TEST_F(CompressedScanTest, SimplePredicate) {
+  // SELECT a, b, c FROM table where a >= 20;
+  ExpressionPtr a_gte_20 =
+      CmpGteExpr(ColRefExpr(type::TypeId::INTEGER, 0), ConstIntExpr(20));
+  EXPECT_EQ(NumRowsInTestTable() - 2, ScanCount(a_gte_20.release()));
+
+  // SELECT a, b, c FROM table where a < 20;
+  ExpressionPtr a_lt_20 =
+      CmpLtExpr(ColRefExpr(type::TypeId::INTEGER, 0), ConstIntExpr(20));
+  EXPECT_EQ(2, ScanCount(a_lt_20.release()));
+
+  // SELECT a, b, c FROM table where a > 100000;
+  ExpressionPtr a_gt_big =
+      CmpGtExpr(ColRefExpr(type::TypeId::INTEGER, 0), ConstIntExpr(100000));
+  EXPECT_EQ(0, ScanCount(a_gt_big.release()));
+}
+
+TEST_F(CompressedScanTest, ConjunctionPredicate) {
+  // SELECT a, b, c FROM table where a >= 20 and b = 21;
+  ExpressionPtr a_gte_20 =
+      CmpGteExpr(ColRefExpr(type::TypeId::INTEGER, 0), ConstIntExpr(20));
+  ExpressionPtr b_eq_21 =
+      CmpEqExpr(ColRefExpr(type::TypeId::INTEGER, 1), ConstIntExpr(21));
+  auto *conj_eq = new expression::ConjunctionExpression(
+      ExpressionType::CONJUNCTION_AND, b_eq_21.release(), a_gte_20.release());
+  EXPECT_EQ(1, ScanCount(conj_eq));
+}
+
+TEST_F(CompressedScanTest, VarcharPredicate) {
+  // SELECT a, b, c FROM table where d = '33';
+  ExpressionPtr d_eq_33 = CmpEqExpr(
+      ColRefExpr(type::TypeId::VARCHAR, 3),
+      ExpressionPtr{new expression::ConstantValueExpression(
+          type::ValueFactory::GetVarcharValue("33"))});
+  EXPECT_EQ(1, ScanCount(d_eq_33.release()));
+}
+
+TEST_F(CompressedScanTest, UncompressedColumnPredicate) {
+  // SELECT a, b, c FROM table where a >= 20 and c >= 22.0;
+  // The decimal column isn't compressed, so the regular filter is used
+  ExpressionPtr a_gte_20 =
+      CmpGteExpr(ColRefExpr(type::TypeId::INTEGER, 0), ConstIntExpr(20));
+  ExpressionPtr c_gte_22 =
+      CmpGteExpr(ColRefExpr(type::TypeId::DECIMAL, 2), ConstDecimalExpr(22.0));
+  auto *conj = new expression::ConjunctionExpression(
+      ExpressionType::CONJUNCTION_AND, a_gte_20.release(), c_gte_22.release());
+  EXPECT_EQ(NumRowsInTestTable() - 2, ScanCount(conj));
+}
+
+TEST_F(CompressedScanTest, CachedPredicate) {
+  // SELECT a, b, c FROM table where a >= 20; and then a >= 40;
+  // Both queries share the compiled code, which must filter the compressed
+  // tile groups by the constant of each execution
+  codegen::QueryCache::Instance().Clear();
+  for (int32_t bound : {20, 40}) {
+    std::shared_ptr<planner::SeqScanPlan> scan{new planner::SeqScanPlan(
+        &GetTestTable(TestTableId()),
+        CmpGteExpr(ColRefExpr(type::TypeId::INTEGER, 0), ConstIntExpr(bound))
+            .release(),
+        {0, 1, 2})};
+    planner::BindingContext context;
+    scan->PerformBinding(context);
+    codegen::BufferingConsumer buffer{{0, 1, 2}, context};
+    bool cached;
+    CompileAndExecuteCache(scan, buffer, cached);
+    EXPECT_EQ(bound == 40, cached);
+    EXPECT_EQ(NumRowsInTestTable() - bound / 10,
+              buffer.GetOutputTuples().size());
+  }
+  codegen::QueryCache::Instance().Clear();
+}
+
+// The same table with a tile per column, so that the tiles of the integer
+// columns are held by the compressed tile groups in full
+class CompressedColumnScanTest : public CompressedScanTest {
+ public:
+  CompressedColumnScanTest() : CompressedScanTest(LayoutType::COLUMN) {}
+};
+
+TEST_F(CompressedColumnScanTest, DropAndThawTupleSlots) {
+  auto &table = GetTestTable(TestTableId());
+  EXPECT_GT(num_frozen, 0);
+
+  for (oid_t offset = 0; offset < table.GetTileGroupCount(); offset++) {
+    auto tile_group = table.GetTileGroup(offset);
+    auto compressed = tile_group->GetCompressedTileGroup();
+    if (compressed == nullptr) {
+      continue;
+    }
+
+    // Only the integer columns are dropped. The slots of the varchar column
+    // point into its pool, and the decimal one isn't compressed.
+    EXPECT_FALSE(tile_group->GetTile(0)->HasTupleSlots());
+    EXPECT_FALSE(tile_group->GetTile(1)->HasTupleSlots());
+    EXPECT_TRUE(tile_group->GetTile(2)->HasTupleSlots());
+    EXPECT_TRUE(tile_group->GetTile(3)->HasTupleSlots());
+
+    // Accessing a dropped tile decodes it
+    for (oid_t tuple_id = 0; tuple_id < compressed->GetTupleCount();
+         tuple_id++) {
+      EXPECT_EQ(CmpBool::CmpTrue,
+                compressed->GetColumn(0)->GetValue(tuple_id).CompareEquals(
+                    tile_group->GetValue(tuple_id, 0)));
+    }
+    EXPECT_TRUE(tile_group->GetTile(0)->HasTupleSlots());
+    EXPECT_FALSE(tile_group->GetTile(1)->HasTupleSlots());
+  }
+
+  // Compiled scans read the dropped tiles as well
+  ExpressionPtr a_gte_20 =
+      CmpGteExpr(ColRefExpr(type::TypeId::INTEGER, 0), ConstIntExpr(20));
+  EXPECT_EQ(NumRowsInTestTable() - 2, ScanCount(a_gte_20.release()));
+
+  // Tiles that were just decoded are left alone for one more pass
+  auto &freezer = tuning::TileGroupFreezer::GetInstance();
+  auto tile_group = table.GetTileGroup(0);
+  ASSERT_NE(nullptr, tile_group->GetCompressedTileGroup());
+  EXPECT_EQ(0, freezer.DropTupleSlots(tile_group.get()));
+  EXPECT_TRUE(tile_group->GetTile(0)->HasTupleSlots());
+  EXPECT_LE(1, freezer.DropTupleSlots(tile_group.get()));
+  EXPECT_FALSE(tile_group->GetTile(0)->HasTupleSlots());
+  EXPECT_FALSE(tile_group->GetTile(1)->HasTupleSlots());
+}
+
+}  // namespace test
+}  // namespace peloton
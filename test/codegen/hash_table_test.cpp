@@ -42,6 +42,10 @@ struct Key {
     return h1 ^ (h2 + 0x9e3779b9 + (h1 << 6) + (h1 >> 2));
   }
 
+  // Partitions are chosen by the high bits of the hash, which Hash() leaves
+  // mostly zero
+  uint64_t PartitionHash() const { return Hash() * 0x9E3779B97F4A7C15ull; }
+
   friend std::ostream &operator<<(std::ostream &os, const Key &k) {
     os << "Key[" << k.k1 << "," << k.k2 << "]";
     return os;
@@ -314,5 +318,285 @@ TEST_F(HashTableTest, ParallelMerge) {
   }
 }
 
+TEST_F(HashTableTest, CanPartitionLazily) {
+  codegen::util::HashTable table{GetMemPool(), sizeof(Key), sizeof(Value)};
+
+  constexpr uint32_t to_insert = 20000;
+  constexpr uint32_t max_dups = 4;
+  constexpr uint32_t num_partition_bits = 4;
+
+  // Insert keys, storing the number of duplicates in k1
+  std::vector<Key> keys;
+  for (uint32_t i = 0; i < to_insert; i++) {
+    Key k{1 + (rand() % max_dups), i};
+    for (uint32_t dup = 0; dup < k.k1; dup++) {
+      Value v = {.v1 = k.k2, .v2 = 2, .v3 = 3, .v4 = 4};
+      table.TypedInsertLazy(k.PartitionHash(), k, v);
+    }
+    keys.emplace_back(k);
+  }
+  uint64_t num_inserts = table.NumElements();
+
+  table.PartitionLazy(num_partition_bits);
+  EXPECT_EQ(1u << num_partition_bits, table.NumPartitions());
+  EXPECT_EQ(num_inserts, table.NumElements());
+
+  uint64_t num_partitioned = 0;
+  for (uint32_t part = 0; part < table.NumPartitions(); part++) {
+    // Every entry of the partition has the partition's hash bits
+    for (char *pos = table.PartitionBegin(part),
+              *end = table.PartitionEnd(part);
+         pos != end; pos += table.EntrySize()) {
+      auto *entry = reinterpret_cast<codegen::util::HashTable::Entry *>(pos);
+      EXPECT_EQ(part, entry->hash >> (64 - num_partition_bits));
+      num_partitioned++;
+    }
+
+    // Once built, the partition finds all the duplicates of its keys
+    table.BuildPartition(part);
+    for (const auto &key : keys) {
+      if (key.PartitionHash() >> (64 - num_partition_bits) != part) {
+        continue;
+      }
+      uint32_t count = 0;
+      std::function<void(const Value &v)> f = [&key, &count](const Value &v) {
+        EXPECT_EQ(key.k2, v.v1)
+            << "Value's [v1] found in table doesn't match insert key";
+        count++;
+      };
+      table.TypedProbe(key.PartitionHash(), key, f);
+      EXPECT_EQ(key.k1, count) << key << " found " << count << " dups ...";
+    }
+  }
+  EXPECT_EQ(num_inserts, num_partitioned);
+}
+
+TEST_F(HashTableTest, CanSpillAndPartition) {
+  MemoryBudget budget(64 * 1024);
+  codegen::util::HashTable table{GetMemPool(), sizeof(Key), sizeof(Value)};
+  table.SetMemoryBudget(&budget);
+
+  constexpr uint32_t to_insert = 20000;
+  constexpr uint32_t max_dups = 4;
+  constexpr uint32_t num_partition_bits = 4;
+
+  // Insert keys, storing the number of duplicates in k1
+  std::vector<Key> keys;
+  for (uint32_t i = 0; i < to_insert; i++) {
+    Key k{1 + (rand() % max_dups), i};
+    for (uint32_t dup = 0; dup < k.k1; dup++) {
+      Value v = {.v1 = k.k2, .v2 = 2, .v3 = 3, .v4 = 4};
+      table.TypedInsertLazy(k.PartitionHash(), k, v);
+    }
+    keys.emplace_back(k);
+  }
+  uint64_t num_inserts = table.NumElements();
+
+  // The entries did not fit in the budget
+  EXPECT_LT(1, table.NumSpilledRuns());
+
+  table.PartitionLazy(num_partition_bits);
+  EXPECT_EQ(1u << num_partition_bits, table.NumPartitions());
+  EXPECT_EQ(num_inserts, table.NumElements());
+
+  uint64_t num_partitioned = 0;
+  for (uint32_t part = 0; part < table.NumPartitions(); part++) {
+    // Every entry read back for the partition has the partition's hash bits
+    table.LoadPartition(part);
+    for (char *pos = table.PartitionBegin(part),
+              *end = table.PartitionEnd(part);
+         pos != end; pos += table.EntrySize()) {
+      auto *entry = reinterpret_cast<codegen::util::HashTable::Entry *>(pos);
+      EXPECT_EQ(part, entry->hash >> (64 - num_partition_bits));
+      num_partitioned++;
+    }
+
+    // Once built, the partition finds all the duplicates of its keys
+    table.BuildPartition(part);
+    for (const auto &key : keys) {
+      if (key.PartitionHash() >> (64 - num_partition_bits) != part) {
+        continue;
+      }
+      uint32_t count = 0;
+      std::function<void(const Value &v)> f = [&key, &count](const Value &v) {
+        EXPECT_EQ(key.k2, v.v1)
+            << "Value's [v1] found in table doesn't match insert key";
+        count++;
+      };
+      table.TypedProbe(key.PartitionHash(), key, f);
+      EXPECT_EQ(key.k1, count) << key << " found " << count << " dups ...";
+    }
+  }
+  EXPECT_EQ(num_inserts, num_partitioned);
+}
+
+TEST_F(HashTableTest, CanRepartitionSpilledRuns) {
+  // The budget is too small for the partitions on the bits the runs were
+  // spilled on
+  MemoryBudget budget(8 * 1024);
+  codegen::util::HashTable table{GetMemPool(), sizeof(Key), sizeof(Value)};
+  table.SetMemoryBudget(&budget);
+
+  constexpr uint32_t to_insert = 200000;
+  std::vector<Key> keys;
+  for (uint32_t i = 0; i < to_insert; i++) {
+    Key k{1, i};
+    Value v = {.v1 = k.k2, .v2 = 2, .v3 = 3, .v4 = 4};
+    table.TypedInsertLazy(k.PartitionHash(), k, v);
+    keys.emplace_back(k);
+  }
+  EXPECT_LT(1, table.NumSpilledRuns());
+
+  // So the table is partitioned on more bits, until every partition fits
+  table.PartitionLazy(codegen::util::HashTable::kAutoPartitionBits);
+  uint32_t num_partition_bits = table.NumPartitionBits();
+  EXPECT_LT(codegen::util::HashTable::kMaxPartitionBits, num_partition_bits);
+  EXPECT_GE(codegen::util::HashTable::kMaxSpillPartitionBits,
+            num_partition_bits);
+  EXPECT_EQ(to_insert, table.NumElements());
+
+  std::vector<std::vector<Key>> partition_keys(table.NumPartitions());
+  for (const auto &key : keys) {
+    partition_keys[key.PartitionHash() >> (64 - num_partition_bits)]
+        .push_back(key);
+  }
+
+  uint64_t num_partitioned = 0;
+  for (uint32_t part = 0; part < table.NumPartitions(); part++) {
+    table.LoadPartition(part);
+    uint64_t partition_size =
+        table.PartitionEnd(part) - table.PartitionBegin(part);
+    EXPECT_GE(budget.GetLimit(), partition_size);
+    for (char *pos = table.PartitionBegin(part),
+              *end = table.PartitionEnd(part);
+         pos != end; pos += table.EntrySize()) {
+      auto *entry = reinterpret_cast<codegen::util::HashTable::Entry *>(pos);
+      EXPECT_EQ(part, entry->hash >> (64 - num_partition_bits));
+      num_partitioned++;
+    }
+
+    table.BuildPartition(part);
+    for (const auto &key : partition_keys[part]) {
+      uint32_t count = 0;
+      std::function<void(const Value &v)> f = [&key, &count](const Value &v) {
+        EXPECT_EQ(key.k2, v.v1);
+        count++;
+      };
+      table.TypedProbe(key.PartitionHash(), key, f);
+      EXPECT_EQ(1, count) << key;
+    }
+  }
+  EXPECT_EQ(to_insert, num_partitioned);
+}
+
+TEST_F(HashTableTest, ParallelPartition) {
+  constexpr uint32_t num_threads = 4;
+  constexpr uint32_t to_insert = 20000;
+
+  executor::ExecutorContext exec_ctx{nullptr};
+
+  auto &thread_states = exec_ctx.GetThreadStates();
+  thread_states.Reset(sizeof(codegen::util::HashTable));
+  thread_states.Allocate(num_threads);
+
+  // Insert keys disjoint from other threads into thread-local tables
+  auto insert_fn = [&exec_ctx](uint64_t tid) {
+    auto *table = reinterpret_cast<codegen::util::HashTable *>(
+        exec_ctx.GetThreadStates().AccessThreadState(tid));
+    codegen::util::HashTable::Init(*table, exec_ctx, sizeof(Key),
+                                   sizeof(Value));
+    for (uint32_t i = tid * to_insert, end = i + to_insert; i != end; i++) {
+      Key k{static_cast<uint32_t>(tid), i};
+      Value v = {.v1 = k.k2, .v2 = k.k1, .v3 = 3, .v4 = 4444};
+      table->TypedInsertLazy(k.PartitionHash(), k, v);
+    }
+  };
+  LaunchParallelTest(num_threads, insert_fn);
+
+  // Partition all thread-local tables into the global table, letting it
+  // choose the number of partitions
+  codegen::util::HashTable global_table{*exec_ctx.GetPool(), sizeof(Key),
+                                        sizeof(Value)};
+  global_table.PartitionLazyParallel(
+      thread_states, 0, codegen::util::HashTable::kAutoPartitionBits);
+
+  // The thread-local tables are left untouched
+  for (uint32_t tid = 0; tid < num_threads; tid++) {
+    auto *table = reinterpret_cast<codegen::util::HashTable *>(
+        thread_states.AccessThreadState(tid));
+    EXPECT_EQ(to_insert, table->NumElements());
+  }
+
+  EXPECT_EQ(to_insert * num_threads, global_table.NumElements());
+  uint32_t num_partition_bits = global_table.NumPartitionBits();
+  EXPECT_EQ(codegen::util::HashTable::ChoosePartitionBits(
+                global_table.NumElements(), global_table.EntrySize()),
+            num_partition_bits);
+  EXPECT_LT(0, num_partition_bits);
+
+  // Each key is found exactly once, in its partition
+  for (uint32_t part = 0; part < global_table.NumPartitions(); part++) {
+    global_table.BuildPartition(part);
+    for (uint32_t tid = 0; tid < num_threads; tid++) {
+      for (uint32_t i = tid * to_insert, end = i + to_insert; i != end; i++) {
+        Key key{tid, i};
+        if (key.PartitionHash() >> (64 - num_partition_bits) != part) {
+          continue;
+        }
+        uint32_t count = 0;
+        std::function<void(const Value &v)> f = [&key, &count](
+            const Value &v) {
+          EXPECT_EQ(key.k1, v.v2) << "Key " << key << " inserted by thread "
+                                  << key.k1
+                                  << " but value was inserted by thread "
+                                  << v.v2;
+          count++;
+        };
+        global_table.TypedProbe(key.PartitionHash(), key, f);
+        EXPECT_EQ(1, count) << "Found duplicate keys in unique key test";
+      }
+    }
+  }
+
+  // Clean up local tables
+  for (uint32_t tid = 0; tid < num_threads; tid++) {
+    auto *table = reinterpret_cast<codegen::util::HashTable *>(
+        thread_states.AccessThreadState(tid));
+    codegen::util::HashTable::Destroy(*table);
+  }
+}
+
+TEST_F(HashTableTest, SpillingTablesShareBudget) {
+  // The build and probe sides of a join reserve memory from the same budget
+  MemoryBudget budget(256 * 1024);
+  {
+    codegen::util::HashTable build{GetMemPool(), sizeof(Key), sizeof(Value)};
+    codegen::util::HashTable probe{GetMemPool(), sizeof(Key), sizeof(Value)};
+    build.SetMemoryBudget(&budget);
+    probe.SetMemoryBudget(&budget);
+
+    // Each table alone would fit in the budget, but not both
+    uint64_t num_inserts = budget.GetLimit() * 3 / 4 / build.EntrySize();
+    for (uint32_t i = 0; i < num_inserts; i++) {
+      Key k{1, i};
+      Value v = {.v1 = k.k2, .v2 = 2, .v3 = 3, .v4 = 4};
+      build.TypedInsertLazy(k.PartitionHash(), k, v);
+      probe.TypedInsertLazy(k.PartitionHash(), k, v);
+    }
+    EXPECT_LT(0, build.NumSpilledRuns() + probe.NumSpilledRuns());
+
+    // Only the chunks reserved after spilling everything may exceed the budget
+    EXPECT_GE(budget.GetLimit() + 2 * 32 * 1024, budget.GetReserved());
+
+    build.PartitionLazy(4);
+    probe.PartitionLazy(4);
+    EXPECT_EQ(num_inserts, build.NumElements());
+    EXPECT_EQ(num_inserts, probe.NumElements());
+  }
+
+  // The tables gave back all they reserved
+  EXPECT_EQ(0, budget.GetReserved());
+}
+
 }  // namespace test
 }  // namespace peloton
\ No newline at end of file
@@ -0,0 +1,152 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// like_matcher_test.cpp
+//
+// Identification: test/codegen/like_matcher_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/harness.h"
+
+#include "codegen/util/like_matcher.h"
+#include "executor/executor_context.h"
+#include "function/string_functions.h"
+
+namespace peloton {
+namespace test {
+
+using LikeMatcher = codegen::util::LikeMatcher;
+
+class LikeMatcherTest : public PelotonTest {
+ public:
+  LikeMatcherTest() : ctx_(nullptr) {}
+
+  bool Matches(const std::string &pattern, const std::string &str) {
+    LikeMatcher matcher;
+    matcher.Init(pattern.data(), pattern.size());
+    bool matches = matcher.Matches(ctx_, str.data(), str.size());
+    matcher.Destroy();
+    return matches;
+  }
+
+  // Match with lengths that count the terminating NUL, as compiled code does
+  bool MatchesTerminated(const std::string &pattern, const std::string &str) {
+    LikeMatcher matcher;
+    matcher.Init(pattern.c_str(), pattern.size() + 1);
+    bool matches = matcher.Matches(ctx_, str.c_str(), str.size() + 1);
+    matcher.Destroy();
+    return matches;
+  }
+
+  bool Like(const std::string &pattern, const std::string &str) {
+    return function::StringFunctions::Like(ctx_, str.data(), str.size(),
+                                           pattern.data(), pattern.size());
+  }
+
+ private:
+  executor::ExecutorContext ctx_;
+};
+
+TEST_F(LikeMatcherTest, AnalyzeTest) {
+  struct {
+    std::string pattern;
+    LikeMatcher::PatternType type;
+    std::string literal;
+  } cases[] = {
+      {"%", LikeMatcher::PatternType::All, ""},
+      {"%%", LikeMatcher::PatternType::All, ""},
+      {"", LikeMatcher::PatternType::Exact, ""},
+      {"Token", LikeMatcher::PatternType::Exact, "token"},
+      {"token%", LikeMatcher::PatternType::Prefix, "token"},
+      {"%token", LikeMatcher::PatternType::Suffix, "token"},
+      {"%%token%%", LikeMatcher::PatternType::Contains, "token"},
+      {"%50\\%%", LikeMatcher::PatternType::Contains, "50%"},
+      {"a\\_b", LikeMatcher::PatternType::Exact, "a_b"},
+      {"to_en", LikeMatcher::PatternType::General, ""},
+      {"to%en", LikeMatcher::PatternType::General, ""},
+      {"%to%en%", LikeMatcher::PatternType::General, ""},
+      {"token\\", LikeMatcher::PatternType::General, ""}};
+
+  for (const auto &test_case : cases) {
+    std::string literal;
+    auto type = LikeMatcher::Analyze(test_case.pattern.data(),
+                                     test_case.pattern.size(), literal);
+    EXPECT_EQ(test_case.type, type) << test_case.pattern;
+    if (type != LikeMatcher::PatternType::General) {
+      EXPECT_EQ(test_case.literal, literal) << test_case.pattern;
+    }
+  }
+
+  // The terminating NUL of a VARCHAR isn't part of the pattern
+  LikeMatcher matcher;
+  std::string prefix = "Token%";
+  matcher.Init(prefix.c_str(), prefix.size() + 1);
+  EXPECT_EQ(LikeMatcher::PatternType::Prefix, matcher.GetPatternType());
+  matcher.Destroy();
+
+  // A NULL pattern matches nothing
+  matcher.Init(nullptr, 0);
+  EXPECT_EQ(LikeMatcher::PatternType::None, matcher.GetPatternType());
+  matcher.Destroy();
+}
+
+TEST_F(LikeMatcherTest, ContainsTest) {
+  // Long enough to go through the vectorized search, with the match at every
+  // position and in any case
+  std::string literal = "needle";
+  for (uint32_t pos = 0; pos < 100; pos++) {
+    std::string str(pos, 'n');
+    str += "NeEdLe";
+    str += std::string(100 - pos, 'e');
+    EXPECT_TRUE(LikeMatcher::ContainsIgnoreCase(str.data(), str.size(),
+                                                literal.data(),
+                                                literal.size()));
+    // Only the first and last characters of the literal match here
+    str[pos + 2] = 'x';
+    EXPECT_FALSE(LikeMatcher::ContainsIgnoreCase(str.data(), str.size(),
+                                                 literal.data(),
+                                                 literal.size()));
+  }
+
+  std::string one = "x";
+  std::string str(64, 'a');
+  EXPECT_FALSE(LikeMatcher::ContainsIgnoreCase(str.data(), str.size(),
+                                               one.data(), one.size()));
+  str.back() = 'X';
+  EXPECT_TRUE(LikeMatcher::ContainsIgnoreCase(str.data(), str.size(),
+                                              one.data(), one.size()));
+}
+
+TEST_F(LikeMatcherTest, SameAsLikeTest) {
+  // Every pattern matches the same strings as StringFunctions::Like()
+  std::vector<std::string> patterns = {
+      "%",      "",       "ab",     "aB%",     "%ab",    "%ab%",    "%b\\%%",
+      "a%",     "%a",     "%a%",    "%abab%",  "a_b",    "a%b",     "%a%b%",
+      "\\%a",   "ba%ab",  "%%b%%",  "abba",    "%bab",   "ab\\",    "%\\\\%"};
+  std::mt19937 rng(15721);
+  const char alphabet[] = {'a', 'b', 'A', 'B', '%', '\\'};
+  for (int i = 0; i < 2000; i++) {
+    std::string str;
+    uint32_t len = rng() % 40;
+    for (uint32_t j = 0; j < len; j++) {
+      str.push_back(alphabet[rng() % sizeof(alphabet)]);
+    }
+    for (const auto &pattern : patterns) {
+      EXPECT_EQ(Like(pattern, str), Matches(pattern, str))
+          << "'" << str << "' LIKE '" << pattern << "'";
+      EXPECT_EQ(Like(pattern, str), MatchesTerminated(pattern, str))
+          << "'" << str << "' LIKE '" << pattern << "'";
+    }
+  }
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -70,19 +70,25 @@ class SorterTest : public PelotonTest {
     sorter.TypedInsertAll(test_data);
   }
 
-  static void CheckSorted(codegen::util::Sorter &sorter, bool ascending) {
+  // Check the tuples of every chunk, returning how many there were
+  static uint64_t CheckSorted(codegen::util::Sorter &sorter, bool ascending) {
+    uint64_t num_tuples = 0;
     uint32_t last_col_b = std::numeric_limits<uint32_t>::max();
-    for (auto iter : sorter) {
-      const auto *tt = reinterpret_cast<const TestTuple *>(iter);
-      if (last_col_b != std::numeric_limits<uint32_t>::max()) {
-        if (ascending) {
-          EXPECT_LE(last_col_b, tt->col_b);
-        } else {
-          EXPECT_GE(last_col_b, tt->col_b);
+    do {
+      for (auto iter : sorter) {
+        const auto *tt = reinterpret_cast<const TestTuple *>(iter);
+        if (last_col_b != std::numeric_limits<uint32_t>::max()) {
+          if (ascending) {
+            EXPECT_LE(last_col_b, tt->col_b);
+          } else {
+            EXPECT_GE(last_col_b, tt->col_b);
+          }
         }
+        last_col_b = tt->col_b;
+        num_tuples++;
       }
-      last_col_b = tt->col_b;
-    }
+    } while (sorter.NextChunk());
+    return num_tuples;
   }
 
   void TestSort(uint64_t num_tuples_to_insert = 100) {
@@ -174,6 +180,65 @@ TEST_F(SorterTest, ParallelSortTest) {
   }
 }
 
+TEST_F(SorterTest, ExternalSortTest) {
+  MemoryBudget budget(256 * 1024);
+  codegen::util::Sorter sorter{Pool(), CompareTuplesForAscending,
+                               sizeof(TestTuple)};
+  sorter.SetMemoryBudget(&budget);
+
+  // 16 MB of tuples must be spilled in runs of at most the budget
+  uint64_t num_tuples = 1000000;
+  LoadSorter(sorter, num_tuples);
+  EXPECT_LE(16 * num_tuples / (256 * 1024), sorter.NumSpilledRuns());
+
+  // All of them come back sorted, a chunk at a time
+  sorter.Sort();
+  EXPECT_GT(num_tuples, sorter.NumTuples());
+  EXPECT_EQ(num_tuples, CheckSorted(sorter, true));
+  EXPECT_EQ(0, budget.GetReserved());
+}
+
+TEST_F(SorterTest, ParallelExternalSortTest) {
+  uint32_t num_threads = 4;
+
+  auto &thread_states = ExecCtx().GetThreadStates();
+  thread_states.Reset(sizeof(codegen::util::Sorter));
+  thread_states.Allocate(num_threads);
+
+  // Only some of the sorters spill, once they used up the budget they share
+  MemoryBudget budget(512 * 1024);
+  MemoryBudget merge_budget(1024 * 1024);
+  uint32_t ntuples_per_sorter = 200000;
+  for (uint32_t i = 0; i < num_threads; i++) {
+    auto *sorter = reinterpret_cast<codegen::util::Sorter *>(
+        thread_states.AccessThreadState(i));
+    codegen::util::Sorter::Init(*sorter, ExecCtx(), CompareTuplesForAscending,
+                                sizeof(TestTuple));
+    if (i % 2 == 0) {
+      sorter->SetMemoryBudget(&budget);
+    }
+    LoadSorter(*sorter, ntuples_per_sorter);
+  }
+
+  {
+    codegen::util::Sorter main_sorter{Pool(), CompareTuplesForAscending,
+                                      sizeof(TestTuple)};
+    main_sorter.SetMemoryBudget(&merge_budget);
+    main_sorter.SortParallel(thread_states, 0);
+
+    // The main sorter merges the runs of all sorters
+    EXPECT_LT(num_threads, main_sorter.NumSpilledRuns());
+    EXPECT_EQ(num_threads * ntuples_per_sorter, CheckSorted(main_sorter, true));
+
+    for (uint32_t i = 0; i < num_threads; i++) {
+      auto *sorter = reinterpret_cast<codegen::util::Sorter *>(
+          thread_states.AccessThreadState(i));
+      EXPECT_EQ(0, sorter->NumSpilledRuns());
+      codegen::util::Sorter::Destroy(*sorter);
+    }
+  }
+}
+
 TEST_F(SorterTest, SortForTopK) {
   auto test = [this](uint64_t num_inserts, uint64_t top_k) {
     // The sorter
@@ -1073,6 +1073,7 @@ TEST_F(InternalTypesTests, GCVersionTypeTest) {
       GCVersionType::COMMIT_DELETE, GCVersionType::COMMIT_INS_DEL,
       GCVersionType::ABORT_UPDATE,  GCVersionType::ABORT_DELETE,
       GCVersionType::ABORT_INSERT,  GCVersionType::ABORT_INS_DEL,
+      GCVersionType::COMMIT_DELTA,  GCVersionType::ABORT_DELTA,
   };
 
   // Make sure that ToString and FromString work
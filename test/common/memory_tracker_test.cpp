@@ -0,0 +1,161 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// memory_tracker_test.cpp
+//
+// Identification: test/common/memory_tracker_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/memory_tracker.h"
+
+#include "common/harness.h"
+#include "common/synchronization/count_down_latch.h"
+#include "executor/executor_context.h"
+#include "settings/settings_manager.h"
+#include "threadpool/memory_governor.h"
+#include "type/ephemeral_pool.h"
+
+namespace peloton {
+namespace test {
+
+class MemoryTrackerTests : public PelotonTest {};
+
+TEST_F(MemoryTrackerTests, HierarchyTest) {
+  MemoryTracker connection;
+  {
+    MemoryTracker query1(&connection);
+    MemoryTracker query2(&connection);
+
+    query1.Reserve(100);
+    query2.Reserve(50);
+    EXPECT_EQ(100, query1.GetCurrent());
+    EXPECT_EQ(150, connection.GetCurrent());
+
+    query1.Release(80);
+    query2.Reserve(10);
+    EXPECT_EQ(20, query1.GetCurrent());
+    EXPECT_EQ(100, query1.GetPeak());
+    EXPECT_EQ(60, query2.GetPeak());
+    EXPECT_EQ(80, connection.GetCurrent());
+    EXPECT_EQ(150, connection.GetPeak());
+  }
+
+  // Whatever the queries still held was given back when they were destroyed
+  EXPECT_EQ(0, connection.GetCurrent());
+  EXPECT_EQ(150, connection.GetPeak());
+}
+
+TEST_F(MemoryTrackerTests, ParallelReserveTest) {
+  MemoryTracker connection;
+  MemoryTracker query(&connection);
+  LaunchParallelTest(4, [&query](uint64_t) {
+    for (uint32_t i = 0; i < 1000; i++) {
+      query.Reserve(8);
+    }
+  });
+  EXPECT_EQ(4 * 1000 * 8, query.GetCurrent());
+  EXPECT_EQ(4 * 1000 * 8, connection.GetPeak());
+}
+
+TEST_F(MemoryTrackerTests, EphemeralPoolTest) {
+  MemoryTracker tracker;
+  {
+    type::EphemeralPool pool(&tracker);
+    void *a = pool.Allocate(1000);
+    pool.Allocate(24);
+    EXPECT_EQ(1024, tracker.GetCurrent());
+
+    pool.Free(a);
+    EXPECT_EQ(24, tracker.GetCurrent());
+  }
+  EXPECT_EQ(0, tracker.GetCurrent());
+  EXPECT_EQ(1024, tracker.GetPeak());
+}
+
+TEST_F(MemoryTrackerTests, ExecutorContextTest) {
+  MemoryTracker query;
+  {
+    executor::ExecutorContext context(nullptr, {}, &query);
+    context.GetPool()->Allocate(4096);
+    EXPECT_EQ(4096, context.GetMemoryTracker()->GetCurrent());
+    EXPECT_EQ(4096, query.GetCurrent());
+  }
+  EXPECT_EQ(0, query.GetCurrent());
+  EXPECT_EQ(4096, query.GetPeak());
+}
+
+TEST_F(MemoryTrackerTests, BudgetTest) {
+  MemoryBudget budget(100);
+  EXPECT_TRUE(budget.IsBounded());
+  EXPECT_TRUE(budget.TryReserve(60));
+  EXPECT_FALSE(budget.TryReserve(50));
+  EXPECT_EQ(60, budget.GetReserved());
+
+  // Only forced reservations go past the limit
+  budget.Reserve(50);
+  EXPECT_EQ(110, budget.GetReserved());
+  EXPECT_FALSE(budget.TryReserve(1));
+  budget.Release(110);
+  EXPECT_TRUE(budget.TryReserve(100));
+
+  MemoryBudget unbounded;
+  EXPECT_FALSE(unbounded.IsBounded());
+  EXPECT_TRUE(unbounded.TryReserve(1ull << 40));
+}
+
+TEST_F(MemoryTrackerTests, ParallelBudgetTest) {
+  // The threads of a query share its budget, and never reserve more than it
+  MemoryBudget budget(4 * 100 * 8);
+  std::atomic<uint32_t> num_reserved(0);
+  LaunchParallelTest(4, [&budget, &num_reserved](uint64_t) {
+    for (uint32_t i = 0; i < 1000; i++) {
+      if (budget.TryReserve(8)) num_reserved++;
+    }
+  });
+  EXPECT_EQ(4 * 100, num_reserved.load());
+  EXPECT_EQ(budget.GetLimit(), budget.GetReserved());
+}
+
+TEST_F(MemoryTrackerTests, GovernorQueuesQueriesTest) {
+  static const uint64_t kQueryMemory = 2 * 1024 * 1024;
+  settings::SettingsManager::SetInt(settings::SettingId::server_memory_budget,
+                                    1);
+  auto &governor = threadpool::MemoryGovernor::GetInstance();
+
+  // The first query is always admitted, and uses more than the budget
+  common::synchronization::CountDownLatch started(1), finish(1);
+  governor.SubmitTask([&governor, &started, &finish] {
+    MemoryTracker query(&governor.GetTracker());
+    query.Reserve(kQueryMemory);
+    started.CountDown();
+    finish.Await(0);
+  });
+  started.Await(0);
+
+  // So the second one waits until the first one finishes
+  common::synchronization::CountDownLatch second_done(1);
+  governor.SubmitTask([&second_done] { second_done.CountDown(); });
+  EXPECT_EQ(1, governor.NumWaiting());
+  EXPECT_FALSE(second_done.Await(10 * 1000 * 1000));
+
+  // Short queries are not held back, neither by the memory nor by the queue
+  common::synchronization::CountDownLatch short_done(1);
+  governor.SubmitTask([&short_done] { short_done.CountDown(); }, true);
+  EXPECT_TRUE(short_done.Await(10ull * 1000 * 1000 * 1000));
+  EXPECT_EQ(1, governor.NumWaiting());
+
+  finish.CountDown();
+  EXPECT_TRUE(second_done.Await(10ull * 1000 * 1000 * 1000));
+  EXPECT_EQ(0, governor.NumWaiting());
+  EXPECT_LE(kQueryMemory, governor.GetTracker().GetPeak());
+
+  settings::SettingsManager::SetInt(settings::SettingId::server_memory_budget,
+                                    0);
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,179 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// parameterized_plan_cache_test.cpp
+//
+// Identification: test/common/parameterized_plan_cache_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/parameterized_plan_cache.h"
+
+#include "common/harness.h"
+#include "common/statement_cache_manager.h"
+#include "expression/abstract_expression.h"
+#include "parser/postgresparser.h"
+#include "parser/statements.h"
+
+namespace peloton {
+namespace test {
+
+class ParameterizedPlanCacheTests : public PelotonTest {};
+
+namespace {
+
+// Parse the query and parameterize its only statement
+std::string Parameterize(
+    const std::string &query,
+    std::unique_ptr<parser::SQLStatementList> &stmt_list,
+    std::vector<std::unique_ptr<expression::AbstractExpression>> &parameters) {
+  auto &peloton_parser = parser::PostgresParser::GetInstance();
+  stmt_list = peloton_parser.BuildParseTree(query);
+  EXPECT_EQ(1, stmt_list->GetNumStatements());
+  return ParameterizedPlanCache::Parameterize(
+      query, stmt_list->GetStatement(0), parameters);
+}
+
+}  // namespace
+
+TEST_F(ParameterizedPlanCacheTests, SelectTest) {
+  std::unique_ptr<parser::SQLStatementList> stmt_list;
+  std::vector<std::unique_ptr<expression::AbstractExpression>> parameters;
+  auto fingerprint = Parameterize(
+      "SELECT * FROM foo WHERE id = 1 AND name = 'bar';", stmt_list,
+      parameters);
+  EXPECT_FALSE(fingerprint.empty());
+  ASSERT_EQ(2, parameters.size());
+  EXPECT_EQ(ExpressionType::VALUE_CONSTANT,
+            parameters[0]->GetExpressionType());
+  EXPECT_EQ(ExpressionType::VALUE_CONSTANT,
+            parameters[1]->GetExpressionType());
+
+  // The literals in the parse tree are replaced by parameters
+  auto select_stmt =
+      static_cast<parser::SelectStatement *>(stmt_list->GetStatement(0));
+  auto where = select_stmt->where_clause.get();
+  ASSERT_EQ(ExpressionType::CONJUNCTION_AND, where->GetExpressionType());
+  EXPECT_EQ(ExpressionType::VALUE_PARAMETER,
+            where->GetChild(0)->GetChild(1)->GetExpressionType());
+  EXPECT_EQ(ExpressionType::VALUE_PARAMETER,
+            where->GetChild(1)->GetChild(1)->GetExpressionType());
+
+  // A query that only differs in its literals has the same fingerprint
+  std::unique_ptr<parser::SQLStatementList> other_stmt_list;
+  std::vector<std::unique_ptr<expression::AbstractExpression>>
+      other_parameters;
+  EXPECT_EQ(fingerprint,
+            Parameterize("SELECT * FROM foo WHERE id = 42 AND name = 'baz';",
+                         other_stmt_list, other_parameters));
+
+  // ... unless the types of the literals differ
+  other_parameters.clear();
+  EXPECT_NE(fingerprint,
+            Parameterize("SELECT * FROM foo WHERE id = 'x' AND name = 'baz';",
+                         other_stmt_list, other_parameters));
+}
+
+TEST_F(ParameterizedPlanCacheTests, ModifyTest) {
+  std::unique_ptr<parser::SQLStatementList> stmt_list;
+  std::vector<std::unique_ptr<expression::AbstractExpression>> parameters;
+  EXPECT_FALSE(Parameterize("INSERT INTO foo VALUES (1, 'bar');", stmt_list,
+                            parameters).empty());
+  EXPECT_EQ(2, parameters.size());
+
+  parameters.clear();
+  EXPECT_FALSE(Parameterize("UPDATE foo SET name = 'bar' WHERE id = 1;",
+                            stmt_list, parameters).empty());
+  EXPECT_EQ(2, parameters.size());
+
+  parameters.clear();
+  EXPECT_FALSE(Parameterize("DELETE FROM foo WHERE id < 1 OR id > 10;",
+                            stmt_list, parameters).empty());
+  EXPECT_EQ(2, parameters.size());
+}
+
+TEST_F(ParameterizedPlanCacheTests, NotParameterizedTest) {
+  std::vector<std::string> queries = {
+      // No literals
+      "SELECT * FROM foo;",
+      // Literals outside of the comparisons of the WHERE clause
+      "SELECT id + 1 FROM foo WHERE id = 1;",
+      "SELECT * FROM foo WHERE id = 1 LIMIT 10;",
+      "SELECT * FROM foo WHERE id > 1 + 2;",
+      // NULLs have no type
+      "INSERT INTO foo VALUES (1, NULL);",
+      // Literals that look like placeholders
+      "SELECT * FROM foo WHERE name = '?';",
+      // Not a DML statement
+      "CREATE TABLE foo (id INT);"};
+
+  for (auto &query : queries) {
+    std::unique_ptr<parser::SQLStatementList> stmt_list;
+    std::vector<std::unique_ptr<expression::AbstractExpression>> parameters;
+    auto &peloton_parser = parser::PostgresParser::GetInstance();
+    stmt_list = peloton_parser.BuildParseTree(query);
+    auto original_info = stmt_list->GetInfo();
+
+    EXPECT_TRUE(ParameterizedPlanCache::Parameterize(
+                    query, stmt_list->GetStatement(0), parameters).empty())
+        << query;
+    EXPECT_TRUE(parameters.empty());
+    // The parse tree is untouched
+    EXPECT_EQ(original_info, stmt_list->GetInfo());
+  }
+}
+
+TEST_F(ParameterizedPlanCacheTests, CacheTest) {
+  ParameterizedPlanCache plan_cache(2);
+  auto statement_a = std::make_shared<Statement>("unamed", "SELECT 1");
+  auto statement_b = std::make_shared<Statement>("unamed", "SELECT 2");
+  auto statement_c = std::make_shared<Statement>("unamed", "SELECT 3");
+  EXPECT_EQ(nullptr, plan_cache.GetStatement("a"));
+
+  plan_cache.AddStatement("a", statement_a);
+  EXPECT_EQ(statement_a, plan_cache.GetStatement("a"));
+
+  // The least recently used statement is evicted
+  plan_cache.AddStatement("b", statement_b);
+  EXPECT_EQ(statement_a, plan_cache.GetStatement("a"));
+  plan_cache.AddStatement("c", statement_c);
+  EXPECT_EQ(2, plan_cache.GetSize());
+  EXPECT_EQ(nullptr, plan_cache.GetStatement("b"));
+  EXPECT_EQ(statement_a, plan_cache.GetStatement("a"));
+  EXPECT_EQ(statement_c, plan_cache.GetStatement("c"));
+
+  plan_cache.DeleteStatement("a");
+  EXPECT_EQ(nullptr, plan_cache.GetStatement("a"));
+  EXPECT_EQ(1, plan_cache.GetSize());
+
+  plan_cache.Clear();
+  EXPECT_EQ(0, plan_cache.GetSize());
+}
+
+TEST_F(ParameterizedPlanCacheTests, InvalidateTest) {
+  StatementCacheManager::Init();
+  ParameterizedPlanCache plan_cache;
+  auto statement_foo = std::make_shared<Statement>("unamed", "SELECT 1");
+  statement_foo->SetReferencedTables({1});
+  auto statement_bar = std::make_shared<Statement>("unamed", "SELECT 2");
+  statement_bar->SetReferencedTables({2});
+  plan_cache.AddStatement("foo", statement_foo);
+  plan_cache.AddStatement("bar", statement_bar);
+
+  // A DDL on a table drops the statements that reference it
+  StatementCacheManager::GetStmtCacheManager()->InvalidateTableOid(1);
+  EXPECT_EQ(nullptr, plan_cache.GetStatement("foo"));
+  EXPECT_EQ(statement_bar, plan_cache.GetStatement("bar"));
+  EXPECT_EQ(1, plan_cache.GetSize());
+
+  // So does a statement that was marked for replanning in some other way
+  statement_bar->SetNeedsReplan(true);
+  EXPECT_EQ(nullptr, plan_cache.GetStatement("bar"));
+  EXPECT_EQ(0, plan_cache.GetSize());
+}
+
+}  // namespace test
+}  // namespace peloton
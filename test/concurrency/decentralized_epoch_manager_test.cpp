@@ -137,6 +137,72 @@ TEST_F(DecentralizedEpochManagerTests, MultipleThreadsTest) {
 }
 
 
+TEST_F(DecentralizedEpochManagerTests, DeregisterThreadTest) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset();
+
+  epoch_manager.SetCurrentEpochId(2);
+
+  cid_t txn_id = epoch_manager.EnterEpoch(1, TimestampType::READ);
+  eid_t epoch_id = txn_id >> 32;
+
+  // the thread goes away before GC recycles its transaction.
+  epoch_manager.DeregisterThread(1);
+
+  epoch_manager.SetCurrentEpochId(4);
+
+  // the transaction still keeps its epoch from expiring.
+  uint64_t tail_epoch_id = epoch_manager.GetExpiredEpochId();
+
+  EXPECT_EQ(1, tail_epoch_id);
+
+  epoch_manager.ExitEpoch(1, epoch_id);
+
+  tail_epoch_id = epoch_manager.GetExpiredEpochId();
+
+  EXPECT_EQ(3, tail_epoch_id);
+}
+
+
+TEST_F(DecentralizedEpochManagerTests, ConcurrentThreadsTest) {
+
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset();
+
+  epoch_manager.SetCurrentEpochId(2);
+
+  // the threads are not registered up front, they register on their first
+  // transaction.
+  const size_t thread_count = 8;
+  std::vector<std::thread> threads;
+  for (size_t thread_id = 1; thread_id <= thread_count; thread_id++) {
+    threads.emplace_back([&epoch_manager, thread_id] {
+      for (size_t i = 0; i < 1000; i++) {
+        cid_t txn_id = epoch_manager.EnterEpoch(thread_id, TimestampType::READ);
+        eid_t epoch_id = txn_id >> 32;
+        // the epoch of a running transaction never expires.
+        EXPECT_LT(epoch_manager.GetExpiredEpochId(), epoch_id);
+        epoch_manager.ExitEpoch(thread_id, epoch_id);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // all transactions have left.
+  epoch_manager.SetCurrentEpochId(3);
+
+  uint64_t tail_epoch_id = epoch_manager.GetExpiredEpochId();
+
+  EXPECT_EQ(2, tail_epoch_id);
+
+  for (size_t thread_id = 1; thread_id <= thread_count; thread_id++) {
+    epoch_manager.DeregisterThread(thread_id);
+  }
+}
+
+
 }  // namespace test
 }  // namespace peloton
 
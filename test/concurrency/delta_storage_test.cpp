@@ -0,0 +1,180 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// delta_storage_test.cpp
+//
+// Identification: test/concurrency/delta_storage_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+
+#include "common/harness.h"
+#include "concurrency/testing_transaction_util.h"
+#include "settings/settings_manager.h"
+#include "storage/tile_group.h"
+
+namespace peloton {
+
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Delta Storage Tests
+//===--------------------------------------------------------------------===//
+
+class DeltaStorageTests : public PelotonTest {
+ public:
+  // Tables created from now on update their tuples in place
+  static storage::DataTable *CreateTable() {
+    settings::SettingsManager::SetBool(
+        settings::SettingId::delta_version_storage, true);
+    auto table = TestingTransactionUtil::CreateTable();
+    settings::SettingsManager::SetBool(
+        settings::SettingId::delta_version_storage, false);
+    EXPECT_TRUE(table->UsesDeltaStorage());
+    return table;
+  }
+
+  // The number of tuple slots in use, which updates in place leave alone
+  static oid_t CountTupleSlots(storage::DataTable *table) {
+    oid_t count = 0;
+    for (oid_t offset = 0; offset < table->GetTileGroupCount(); offset++) {
+      count += table->GetTileGroup(offset)->GetNextTupleSlot();
+    }
+    return count;
+  }
+};
+
+TEST_F(DeltaStorageTests, OldReaderTest) {
+  concurrency::TransactionManagerFactory::Configure(
+      ProtocolType::TIMESTAMP_ORDERING, IsolationLevelType::SERIALIZABLE,
+      ConflictAvoidanceType::ABORT);
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  storage::DataTable *table = CreateTable();
+  oid_t num_slots = CountTupleSlots(table);
+
+  TransactionScheduler scheduler(3, table, &txn_manager);
+  scheduler.Txn(0).Read(0);
+  scheduler.Txn(1).Update(0, 1);
+  scheduler.Txn(1).Update(0, 2);
+  scheduler.Txn(1).Commit();
+  scheduler.Txn(0).Read(0);
+  scheduler.Txn(0).Scan(0);
+  scheduler.Txn(0).Commit();
+  scheduler.Txn(2).Read(0);
+  scheduler.Txn(2).Scan(0);
+  scheduler.Txn(2).Commit();
+  scheduler.Run();
+
+  EXPECT_EQ(ResultType::SUCCESS, scheduler.schedules[0].txn_result);
+  EXPECT_EQ(ResultType::SUCCESS, scheduler.schedules[1].txn_result);
+  EXPECT_EQ(ResultType::SUCCESS, scheduler.schedules[2].txn_result);
+
+  // The old transaction keeps seeing the value it read first, both through
+  // the index and through a sequential scan
+  auto &old_results = scheduler.schedules[0].results;
+  EXPECT_EQ(12, old_results.size());
+  for (auto result : old_results) {
+    EXPECT_EQ(0, result);
+  }
+
+  auto &new_results = scheduler.schedules[2].results;
+  EXPECT_EQ(11, new_results.size());
+  EXPECT_EQ(2, new_results[0]);
+  EXPECT_EQ(2, std::count(new_results.begin(), new_results.end(), 2));
+
+  EXPECT_EQ(num_slots, CountTupleSlots(table));
+}
+
+TEST_F(DeltaStorageTests, AbortTest) {
+  concurrency::TransactionManagerFactory::Configure(
+      ProtocolType::TIMESTAMP_ORDERING, IsolationLevelType::SERIALIZABLE,
+      ConflictAvoidanceType::ABORT);
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  storage::DataTable *table = CreateTable();
+  oid_t num_slots = CountTupleSlots(table);
+
+  {
+    TransactionScheduler scheduler(3, table, &txn_manager);
+    scheduler.Txn(0).Update(1, 1);
+    scheduler.Txn(0).Commit();
+    scheduler.Txn(1).Update(1, 2);
+    scheduler.Txn(1).Update(1, 3);
+    scheduler.Txn(1).Read(1);
+    scheduler.Txn(1).Abort();
+    scheduler.Txn(2).Read(1);
+    scheduler.Txn(2).Commit();
+    scheduler.Run();
+
+    EXPECT_EQ(ResultType::ABORTED, scheduler.schedules[1].txn_result);
+    EXPECT_EQ(3, scheduler.schedules[1].results[0]);
+    EXPECT_EQ(1, scheduler.schedules[2].results[0]);
+  }
+
+  // The aborted updates left the tuple to the next writer
+  {
+    TransactionScheduler scheduler(2, table, &txn_manager);
+    scheduler.Txn(0).Update(1, 4);
+    scheduler.Txn(0).Commit();
+    scheduler.Txn(1).Read(1);
+    scheduler.Txn(1).Commit();
+    scheduler.Run();
+
+    EXPECT_EQ(ResultType::SUCCESS, scheduler.schedules[0].txn_result);
+    EXPECT_EQ(4, scheduler.schedules[1].results[0]);
+  }
+
+  EXPECT_EQ(num_slots, CountTupleSlots(table));
+}
+
+TEST_F(DeltaStorageTests, WriteConflictTest) {
+  concurrency::TransactionManagerFactory::Configure(
+      ProtocolType::TIMESTAMP_ORDERING, IsolationLevelType::SERIALIZABLE,
+      ConflictAvoidanceType::ABORT);
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  storage::DataTable *table = CreateTable();
+
+  // A transaction cannot update a tuple that changed after it started
+  TransactionScheduler scheduler(2, table, &txn_manager);
+  scheduler.Txn(0).Read(2);
+  scheduler.Txn(1).Update(2, 1);
+  scheduler.Txn(1).Commit();
+  scheduler.Txn(0).Update(2, 2);
+  scheduler.Txn(0).Commit();
+  scheduler.Run();
+
+  EXPECT_EQ(ResultType::SUCCESS, scheduler.schedules[1].txn_result);
+  EXPECT_EQ(ResultType::ABORTED, scheduler.schedules[0].txn_result);
+}
+
+TEST_F(DeltaStorageTests, DeleteTest) {
+  concurrency::TransactionManagerFactory::Configure(
+      ProtocolType::TIMESTAMP_ORDERING, IsolationLevelType::SERIALIZABLE,
+      ConflictAvoidanceType::ABORT);
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  storage::DataTable *table = CreateTable();
+
+  TransactionScheduler scheduler(4, table, &txn_manager);
+  scheduler.Txn(0).Update(3, 5);
+  scheduler.Txn(0).Commit();
+  scheduler.Txn(1).Read(3);
+  scheduler.Txn(2).Update(3, 6);
+  scheduler.Txn(2).Delete(3);
+  scheduler.Txn(2).Commit();
+  scheduler.Txn(1).Read(3);
+  scheduler.Txn(1).Commit();
+  scheduler.Txn(3).Read(3);
+  scheduler.Txn(3).Commit();
+  scheduler.Run();
+
+  EXPECT_EQ(ResultType::SUCCESS, scheduler.schedules[2].txn_result);
+  EXPECT_EQ(5, scheduler.schedules[1].results[0]);
+  EXPECT_EQ(5, scheduler.schedules[1].results[1]);
+  EXPECT_EQ(-1, scheduler.schedules[3].results[0]);
+}
+
+}  // namespace test
+}  // namespace peloton
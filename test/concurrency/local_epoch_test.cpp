@@ -24,21 +24,6 @@ namespace test {
 class LocalEpochTests : public PelotonTest {};
 
 
-TEST_F(LocalEpochTests, EpochCompareTest) {
-  concurrency::EpochCompare comp;
-  
-  std::shared_ptr<concurrency::Epoch> epoch0(new concurrency::Epoch(10, 20));
-  std::shared_ptr<concurrency::Epoch> epoch1(new concurrency::Epoch(10, 20));
-  bool rt = comp(epoch0, epoch1);
-  EXPECT_FALSE(rt);
-
-  std::shared_ptr<concurrency::Epoch> epoch2(new concurrency::Epoch(11, 21));
-  std::shared_ptr<concurrency::Epoch> epoch3(new concurrency::Epoch(12, 20));
-  rt = comp(epoch2, epoch3);
-  EXPECT_FALSE(rt);
-}
-
-
 TEST_F(LocalEpochTests, TransactionTest) {
   concurrency::LocalEpoch local_epoch(0);
   
@@ -92,6 +77,29 @@ TEST_F(LocalEpochTests, TransactionTest) {
 }
 
 
+TEST_F(LocalEpochTests, RingWrapAroundTest) {
+  concurrency::LocalEpoch local_epoch(0);
+
+  bool rt = local_epoch.EnterEpoch(10, TimestampType::READ);
+  EXPECT_TRUE(rt);
+
+  // an epoch that shares the counter of epoch 10.
+  rt = local_epoch.EnterEpoch(10 + EPOCH_RING_SIZE, TimestampType::READ);
+  EXPECT_TRUE(rt);
+
+  local_epoch.ExitEpoch(10);
+
+  // the transaction of the younger epoch still holds epoch 10 back.
+  uint64_t max_eid = local_epoch.GetExpiredEpochId(20 + EPOCH_RING_SIZE);
+  EXPECT_EQ(max_eid, 9);
+
+  local_epoch.ExitEpoch(10 + EPOCH_RING_SIZE);
+
+  max_eid = local_epoch.GetExpiredEpochId(20 + EPOCH_RING_SIZE);
+  EXPECT_EQ(max_eid, 19 + EPOCH_RING_SIZE);
+}
+
+
 }  // namespace test
 }  // namespace peloton
 
@@ -0,0 +1,120 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// flat_hash_table_test.cpp
+//
+// Identification: test/executor/flat_hash_table_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "executor/flat_hash_table.h"
+
+#include <algorithm>
+
+#include "common/container_tuple.h"
+#include "common/harness.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+class FlatHashTableTests : public PelotonTest {};
+
+TEST_F(FlatHashTableTests, SupportedTypesTest) {
+  EXPECT_TRUE(executor::FlatHashTable::IsSupported(
+      {type::TypeId::INTEGER, type::TypeId::DECIMAL, type::TypeId::TIMESTAMP}));
+  EXPECT_FALSE(executor::FlatHashTable::IsSupported(
+      {type::TypeId::INTEGER, type::TypeId::VARCHAR}));
+  EXPECT_FALSE(executor::FlatHashTable::IsSupported({}));
+
+  // Integers of different widths are serialized the same way
+  EXPECT_TRUE(executor::FlatHashTable::IsCompatible({type::TypeId::INTEGER},
+                                                    {type::TypeId::BIGINT}));
+  EXPECT_FALSE(executor::FlatHashTable::IsCompatible({type::TypeId::INTEGER},
+                                                     {type::TypeId::DECIMAL}));
+}
+
+TEST_F(FlatHashTableTests, InsertAndFindTest) {
+  executor::FlatHashTable hash_table(
+      {type::TypeId::INTEGER, type::TypeId::DECIMAL}, sizeof(uint32_t));
+  std::vector<char> key(hash_table.GetKeySize());
+  std::vector<oid_t> column_ids = {0, 1};
+
+  // Insert enough keys to resize the table a few times, each with two values
+  const uint32_t num_keys = 100000;
+  for (uint32_t i = 0; i < 2 * num_keys; i++) {
+    std::vector<type::Value> values = {
+        type::ValueFactory::GetIntegerValue(i % num_keys),
+        type::ValueFactory::GetDecimalValue(i % num_keys / 2.0)};
+    ContainerTuple<std::vector<type::Value>> tuple(&values);
+    auto hash = hash_table.MakeKey(tuple, column_ids, key.data());
+
+    bool new_key;
+    *reinterpret_cast<uint32_t *>(
+        hash_table.Insert(hash, key.data(), new_key)) = i;
+    EXPECT_EQ(i < num_keys, new_key);
+  }
+  EXPECT_EQ(2 * num_keys, hash_table.NumEntries());
+
+  // Probe with keys of a wider integer type
+  for (uint32_t i = 0; i < num_keys; i++) {
+    std::vector<type::Value> values = {
+        type::ValueFactory::GetBigIntValue(i),
+        type::ValueFactory::GetDecimalValue(i / 2.0)};
+    ContainerTuple<std::vector<type::Value>> tuple(&values);
+    auto hash = hash_table.MakeKey(tuple, column_ids, key.data());
+
+    auto entry = hash_table.Find(hash, key.data());
+    ASSERT_NE(nullptr, entry);
+    ASSERT_EQ(2, hash_table.NumValues(entry));
+    EXPECT_EQ(i, *reinterpret_cast<uint32_t *>(hash_table.GetValue(entry, 0)));
+    EXPECT_EQ(i + num_keys,
+              *reinterpret_cast<uint32_t *>(hash_table.GetValue(entry, 1)));
+  }
+
+  std::vector<type::Value> values = {
+      type::ValueFactory::GetIntegerValue(num_keys),
+      type::ValueFactory::GetDecimalValue(0)};
+  ContainerTuple<std::vector<type::Value>> tuple(&values);
+  auto hash = hash_table.MakeKey(tuple, column_ids, key.data());
+  EXPECT_EQ(nullptr, hash_table.Find(hash, key.data()));
+}
+
+TEST_F(FlatHashTableTests, FindOrInsertTest) {
+  executor::FlatHashTable hash_table({type::TypeId::BIGINT}, sizeof(uint32_t));
+  std::vector<char> key(hash_table.GetKeySize());
+  std::vector<oid_t> column_ids = {0};
+
+  // NULLs are grouped together, apart from every other value
+  std::vector<type::Value> keys = {
+      type::ValueFactory::GetBigIntValue(1),
+      type::ValueFactory::GetNullValueByType(type::TypeId::BIGINT),
+      type::ValueFactory::GetBigIntValue(0),
+      type::ValueFactory::GetNullValueByType(type::TypeId::BIGINT),
+      type::ValueFactory::GetBigIntValue(1)};
+  for (auto &key_value : keys) {
+    std::vector<type::Value> values = {key_value};
+    ContainerTuple<std::vector<type::Value>> tuple(&values);
+    auto hash = hash_table.MakeKey(tuple, column_ids, key.data());
+
+    bool new_key;
+    auto count = reinterpret_cast<uint32_t *>(
+        hash_table.FindOrInsert(hash, key.data(), new_key));
+    if (new_key) *count = 0;
+    (*count)++;
+  }
+  EXPECT_EQ(3, hash_table.NumEntries());
+
+  std::vector<uint32_t> counts;
+  for (auto iter = hash_table.begin(); iter != hash_table.end(); ++iter) {
+    counts.push_back(*reinterpret_cast<const uint32_t *>(iter.Value()));
+  }
+  std::sort(counts.begin(), counts.end());
+  EXPECT_EQ(std::vector<uint32_t>({1, 2, 2}), counts);
+}
+
+}  // namespace test
+}  // namespace peloton
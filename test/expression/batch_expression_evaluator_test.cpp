@@ -0,0 +1,196 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// batch_expression_evaluator_test.cpp
+//
+// Identification: test/expression/batch_expression_evaluator_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "expression/batch_expression_evaluator.h"
+
+#include "common/container_tuple.h"
+#include "common/exception.h"
+#include "common/harness.h"
+#include "executor/logical_tile.h"
+#include "executor/logical_tile_factory.h"
+#include "executor/testing_executor_util.h"
+#include "expression/expression_util.h"
+#include "storage/tile_group.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+class BatchExpressionEvaluatorTests : public PelotonTest {};
+
+namespace {
+
+const int kTupleCount = 20;
+
+// The tile group has the columns INTEGER, INTEGER, DECIMAL, VARCHAR with the
+// values TestingExecutorUtil::PopulatedValue()
+std::shared_ptr<storage::TileGroup> CreateTileGroup() {
+  std::shared_ptr<storage::TileGroup> tile_group(
+      TestingExecutorUtil::CreateTileGroup(kTupleCount));
+  TestingExecutorUtil::PopulateTiles(tile_group, kTupleCount);
+  return tile_group;
+}
+
+expression::AbstractExpression *Column(type::TypeId type, int column_id) {
+  return expression::ExpressionUtil::TupleValueFactory(type, 0, column_id);
+}
+
+expression::AbstractExpression *Integer(int32_t value) {
+  return expression::ExpressionUtil::ConstantValueFactory(
+      type::ValueFactory::GetIntegerValue(value));
+}
+
+// Filter the tuples of the tile group both in a batch and one at a time
+void CheckFilter(storage::TileGroup *tile_group,
+                 const expression::AbstractExpression *predicate) {
+  auto evaluator =
+      expression::BatchExpressionEvaluator::Create(predicate, nullptr);
+  ASSERT_NE(nullptr, evaluator);
+
+  std::vector<oid_t> expected, selection;
+  for (oid_t tuple_id = 0; tuple_id < kTupleCount; tuple_id++) {
+    ContainerTuple<storage::TileGroup> tuple(tile_group, tuple_id);
+    if (predicate->Evaluate(&tuple, nullptr, nullptr).IsTrue()) {
+      expected.push_back(tuple_id);
+    }
+    selection.push_back(tuple_id);
+  }
+
+  EXPECT_TRUE(evaluator->Filter(tile_group, selection, false));
+  EXPECT_EQ(expected, selection);
+}
+
+}  // namespace
+
+TEST_F(BatchExpressionEvaluatorTests, ComparisonTest) {
+  auto tile_group = CreateTileGroup();
+
+  std::vector<ExpressionType> comparisons = {
+      ExpressionType::COMPARE_EQUAL,
+      ExpressionType::COMPARE_NOTEQUAL,
+      ExpressionType::COMPARE_LESSTHAN,
+      ExpressionType::COMPARE_GREATERTHAN,
+      ExpressionType::COMPARE_LESSTHANOREQUALTO,
+      ExpressionType::COMPARE_GREATERTHANOREQUALTO};
+  for (auto comparison : comparisons) {
+    // Integer column against an integer constant
+    std::unique_ptr<expression::AbstractExpression> predicate(
+        expression::ExpressionUtil::ComparisonFactory(
+            comparison, Column(type::TypeId::INTEGER, 0), Integer(50)));
+    CheckFilter(tile_group.get(), predicate.get());
+
+    // Decimal column against an integer column
+    predicate.reset(expression::ExpressionUtil::ComparisonFactory(
+        comparison, Column(type::TypeId::DECIMAL, 2),
+        Column(type::TypeId::INTEGER, 1)));
+    CheckFilter(tile_group.get(), predicate.get());
+  }
+}
+
+TEST_F(BatchExpressionEvaluatorTests, ArithmeticAndConjunctionTest) {
+  auto tile_group = CreateTileGroup();
+
+  // (a + b) * 2 > 150 AND NOT (c / 2 < 40) OR a = 190
+  auto sum = expression::ExpressionUtil::OperatorFactory(
+      ExpressionType::OPERATOR_PLUS, type::TypeId::INTEGER,
+      Column(type::TypeId::INTEGER, 0), Column(type::TypeId::INTEGER, 1));
+  auto product = expression::ExpressionUtil::OperatorFactory(
+      ExpressionType::OPERATOR_MULTIPLY, type::TypeId::INTEGER, sum,
+      Integer(2));
+  auto quotient = expression::ExpressionUtil::OperatorFactory(
+      ExpressionType::OPERATOR_DIVIDE, type::TypeId::DECIMAL,
+      Column(type::TypeId::DECIMAL, 2), Integer(2));
+  auto negation = expression::ExpressionUtil::OperatorFactory(
+      ExpressionType::OPERATOR_NOT, type::TypeId::BOOLEAN,
+      expression::ExpressionUtil::ComparisonFactory(
+          ExpressionType::COMPARE_LESSTHAN, quotient, Integer(40)),
+      nullptr);
+  std::unique_ptr<expression::AbstractExpression> predicate(
+      expression::ExpressionUtil::ConjunctionFactory(
+          ExpressionType::CONJUNCTION_OR,
+          expression::ExpressionUtil::ConjunctionFactory(
+              ExpressionType::CONJUNCTION_AND,
+              expression::ExpressionUtil::ComparisonFactory(
+                  ExpressionType::COMPARE_GREATERTHAN, product, Integer(150)),
+              negation),
+          expression::ExpressionUtil::ComparisonFactory(
+              ExpressionType::COMPARE_EQUAL, Column(type::TypeId::INTEGER, 0),
+              Integer(190))));
+  CheckFilter(tile_group.get(), predicate.get());
+
+  // Errors are raised like in tuple-at-a-time evaluation
+  std::unique_ptr<expression::AbstractExpression> divide_by_zero(
+      expression::ExpressionUtil::ComparisonFactory(
+          ExpressionType::COMPARE_EQUAL,
+          expression::ExpressionUtil::OperatorFactory(
+              ExpressionType::OPERATOR_DIVIDE, type::TypeId::INTEGER,
+              Column(type::TypeId::INTEGER, 0), Integer(0)),
+          Integer(0)));
+  auto evaluator =
+      expression::BatchExpressionEvaluator::Create(divide_by_zero.get(),
+                                                   nullptr);
+  ASSERT_NE(nullptr, evaluator);
+  std::vector<oid_t> selection = {0, 1, 2};
+  EXPECT_THROW(evaluator->Filter(tile_group.get(), selection, false),
+               Exception);
+}
+
+TEST_F(BatchExpressionEvaluatorTests, LogicalTileTest) {
+  auto tile_group = CreateTileGroup();
+  std::unique_ptr<executor::LogicalTile> tile(
+      executor::LogicalTileFactory::WrapTileGroup(tile_group));
+
+  // a >= 100 AND NULL is NULL for the tuples with a >= 100, so they are only
+  // kept when NULLs are kept
+  std::unique_ptr<expression::AbstractExpression> predicate(
+      expression::ExpressionUtil::ConjunctionFactory(
+          ExpressionType::CONJUNCTION_AND,
+          expression::ExpressionUtil::ComparisonFactory(
+              ExpressionType::COMPARE_GREATERTHANOREQUALTO,
+              Column(type::TypeId::INTEGER, 0), Integer(100)),
+          expression::ExpressionUtil::ConstantValueFactory(
+              type::ValueFactory::GetNullValueByType(type::TypeId::BOOLEAN))));
+  auto evaluator =
+      expression::BatchExpressionEvaluator::Create(predicate.get(), nullptr);
+  ASSERT_NE(nullptr, evaluator);
+
+  std::vector<oid_t> all_tuples(tile->begin(), tile->end());
+  std::vector<oid_t> selection(all_tuples);
+  EXPECT_TRUE(evaluator->Filter(tile.get(), selection, false));
+  EXPECT_TRUE(selection.empty());
+
+  selection = all_tuples;
+  EXPECT_TRUE(evaluator->Filter(tile.get(), selection, true));
+  EXPECT_EQ(kTupleCount - 10, selection.size());
+  EXPECT_EQ(10, selection.front());
+}
+
+TEST_F(BatchExpressionEvaluatorTests, UnsupportedTest) {
+  // Strings are left to tuple-at-a-time evaluation
+  std::unique_ptr<expression::AbstractExpression> predicate(
+      expression::ExpressionUtil::ComparisonFactory(
+          ExpressionType::COMPARE_EQUAL, Column(type::TypeId::VARCHAR, 3),
+          expression::ExpressionUtil::ConstantValueFactory(
+              type::ValueFactory::GetVarcharValue("12"))));
+  EXPECT_EQ(nullptr,
+            expression::BatchExpressionEvaluator::Create(predicate.get(),
+                                                         nullptr));
+
+  // So are predicates that aren't boolean
+  predicate.reset(Column(type::TypeId::INTEGER, 0));
+  EXPECT_EQ(nullptr,
+            expression::BatchExpressionEvaluator::Create(predicate.get(),
+                                                         nullptr));
+}
+
+}  // namespace test
+}  // namespace peloton
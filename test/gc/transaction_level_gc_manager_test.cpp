@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "codegen/transaction_runtime.h"
 #include "concurrency/testing_transaction_util.h"
 #include "executor/testing_executor_util.h"
 #include "common/harness.h"
@@ -19,6 +20,7 @@
 #include "catalog/catalog.h"
 #include "storage/data_table.h"
 #include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
 #include "storage/database.h"
 #include "storage/storage_manager.h"
 
@@ -493,5 +495,66 @@ TEST_F(TransactionLevelGCManagerTests, ImmutabilityTest) {
   txn_manager.CommitTransaction(txn);
 }
 
+// insert -> scan -> update
+TEST_F(TransactionLevelGCManagerTests, AllVisibleTest) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset(1);
+
+  gc::GCManagerFactory::Configure(1);
+  auto &gc_manager = gc::TransactionLevelGCManager::GetInstance();
+  gc_manager.Reset();
+
+  auto database = TestingExecutorUtil::InitializeDatabase("allvisibledb");
+  oid_t db_id = database->GetOid();
+
+  // fill two tile groups in one transaction
+  const int num_key = 10;
+  const size_t tuples_per_tilegroup = 5;
+  std::unique_ptr<storage::DataTable> table(TestingTransactionUtil::CreateTable(
+      num_key, "TABLE2", db_id, 12348, 1235, true, tuples_per_tilegroup));
+
+  auto tile_group = (table.get())->GetTileGroup(0);
+  auto tile_group_header = tile_group->GetHeader();
+  EXPECT_EQ(MAX_CID, tile_group_header->GetAllVisibleCommitId());
+
+  // the GC marks the tile groups once it picks up the committed transaction
+  epoch_manager.SetCurrentEpochId(2);
+  gc_manager.Unlink(0, epoch_manager.GetExpiredEpochId());
+  for (oid_t offset = 0; offset < 2; offset++) {
+    EXPECT_NE(MAX_CID, (table.get())
+                           ->GetTileGroup(offset)
+                           ->GetHeader()
+                           ->GetAllVisibleCommitId());
+  }
+
+  // so a scan skips the visibility checks of the versions
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  EXPECT_GE(txn->GetReadId(), tile_group_header->GetAllVisibleCommitId());
+  uint32_t selection_vector[tuples_per_tilegroup];
+  EXPECT_EQ(tuples_per_tilegroup,
+            codegen::TransactionRuntime::PerformVisibilityCheck(
+                *txn, *tile_group, 0, tuples_per_tilegroup, selection_vector));
+  for (uint32_t i = 0; i < tuples_per_tilegroup; i++) {
+    EXPECT_EQ(i, selection_vector[i]);
+  }
+  txn_manager.CommitTransaction(txn);
+
+  // an update drops the mark, which stays off while the old version is there
+  auto ret = UpdateTuple(table.get(), 0);
+  EXPECT_TRUE(ret == ResultType::SUCCESS);
+  EXPECT_EQ(MAX_CID, tile_group_header->GetAllVisibleCommitId());
+  epoch_manager.SetCurrentEpochId(3);
+  gc_manager.Unlink(0, epoch_manager.GetExpiredEpochId());
+  EXPECT_EQ(MAX_CID, tile_group_header->GetAllVisibleCommitId());
+
+  gc_manager.StopGC();
+  gc::GCManagerFactory::Configure(0);
+
+  table.release();
+  // DROP!
+  TestingExecutorUtil::DeleteDatabase("allvisibledb");
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -13,7 +13,10 @@
 #include "common/harness.h"
 #include "gmock/gtest/gtest.h"
 
+#include <set>
+
 #include "index/art_index.h"
+#include "index/scan_optimizer.h"
 #include "index/testing_index_util.h"
 #include "type/value_factory.h"
 
@@ -325,5 +328,56 @@ TEST_F(ArtIndexTests, NonUniqueKeyMultiThreadedStressTest) {
   }
 }
 
+TEST_F(ArtIndexTests, IteratorTest) {
+  std::vector<ItemPointer *> location_ptrs;
+
+  uint32_t scale_factor = 20;
+  GenerateTestInput(scale_factor);
+
+  // INDEX
+  auto &index = GetTestIndex();
+  auto &test_data = GetTestData();
+
+  LaunchParallelTest(1, ArtIndexTests::InsertHelper, &index, &test_data);
+
+  // The iterator reads the tree in batches of at most as many values as are
+  // requested, in the order of a full scan
+  std::vector<ItemPointer *> expected_ptrs;
+  index.ScanAllKeys(expected_ptrs);
+  EXPECT_EQ(7 * scale_factor, expected_ptrs.size());
+
+  auto itr = index.GetIterator(ScanDirectionType::FORWARD, nullptr);
+  size_t count;
+  while ((count = itr->Next(location_ptrs, 3)) > 0) {
+    EXPECT_GE(3, count);
+  }
+  EXPECT_EQ(expected_ptrs, location_ptrs);
+  location_ptrs.clear();
+
+  // A = 100 covers keys (100, a), (100, b) three times and (100, c)
+  index::ConjunctionScanPredicate range_csp(
+      &index, {type::ValueFactory::GetIntegerValue(100)}, {0},
+      {ExpressionType::COMPARE_EQUAL});
+  ASSERT_FALSE(range_csp.IsPointQuery());
+
+  // Stop in the middle of the values of (100, b), which lookupRange() reads
+  // together, and resume with the ones it left over
+  itr = index.GetIterator(ScanDirectionType::FORWARD, &range_csp);
+  EXPECT_EQ(2, itr->Next(location_ptrs, 2));
+  EXPECT_EQ(1, itr->Next(location_ptrs, 1));
+  EXPECT_EQ(2, itr->Next(location_ptrs, 10));
+  EXPECT_EQ(0, itr->Next(location_ptrs, 10));
+  ASSERT_EQ(5, location_ptrs.size());
+
+  // Values point to the position of their key in the test data
+  EXPECT_EQ(0, location_ptrs[0]->offset);
+  std::set<uint32_t> key_b_offsets;
+  for (size_t i = 1; i <= 3; i++) {
+    key_b_offsets.insert(location_ptrs[i]->offset);
+  }
+  EXPECT_EQ(std::set<uint32_t>({1, 2, 3}), key_b_offsets);
+  EXPECT_EQ(4, location_ptrs[4]->offset);
+}
+
 }  // namespace test
 }  // namespace peloton
\ No newline at end of file
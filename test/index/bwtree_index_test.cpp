@@ -65,5 +65,9 @@ TEST_F(BwTreeIndexTests, NonUniqueKeyMultiThreadedStressTest2) {
   TestingIndexUtil::NonUniqueKeyMultiThreadedStressTest2(IndexType::BWTREE);
 }
 
+TEST_F(BwTreeIndexTests, IteratorTest) {
+  TestingIndexUtil::IteratorTest(IndexType::BWTREE);
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -0,0 +1,169 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// normalized_key_test.cpp
+//
+// Identification: test/index/normalized_key_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <random>
+
+#include "common/harness.h"
+
+#include "catalog/schema.h"
+#include "index/normalized_key.h"
+#include "storage/tuple.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+class NormalizedKeyTests : public PelotonTest {
+ public:
+  // The order of the keys from comparing their columns one by one
+  static int CompareValues(const storage::Tuple &lhs,
+                           const storage::Tuple &rhs) {
+    for (oid_t i = 0; i < lhs.GetSchema()->GetColumnCount(); i++) {
+      auto lhs_value = lhs.GetValue(i);
+      auto rhs_value = rhs.GetValue(i);
+      if (lhs_value.CompareLessThan(rhs_value) == CmpBool::CmpTrue) return -1;
+      if (lhs_value.CompareGreaterThan(rhs_value) == CmpBool::CmpTrue) return 1;
+    }
+    return 0;
+  }
+
+  static int Sign(int val) { return (val > 0) - (val < 0); }
+};
+
+TEST_F(NormalizedKeyTests, VarlenOrderTest) {
+  std::vector<catalog::Column> columns = {
+      catalog::Column(type::TypeId::INTEGER,
+                      type::Type::GetTypeSize(type::TypeId::INTEGER), "a",
+                      true),
+      catalog::Column(type::TypeId::VARCHAR, 16, "b", false),
+      catalog::Column(type::TypeId::DECIMAL,
+                      type::Type::GetTypeSize(type::TypeId::DECIMAL), "c",
+                      true)};
+  catalog::Schema schema(columns);
+  EXPECT_TRUE(index::KeyNormalizer::IsSupported(schema));
+  EXPECT_EQ(0, index::KeyNormalizer::GetFixedLength(schema));
+
+  // Few distinct values per column, so that keys often share prefixes. The
+  // strings contain zero bytes and prefixes of each other.
+  std::vector<int32_t> ints = {-100, -1, 0, 1, 100};
+  std::vector<std::string> strings = {std::string(""), std::string("a"),
+                                      std::string("a\0", 2),
+                                      std::string("a\0b", 3), std::string("ab"),
+                                      std::string("\xff")};
+  std::vector<double> decimals = {-2.5, -0.0, 0.0, 0.5, 1e100};
+
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+  std::mt19937 rng(15721);
+  std::vector<std::unique_ptr<storage::Tuple>> keys;
+  std::vector<index::VarlenNormalizedKey> normalized_keys(200);
+  for (uint32_t i = 0; i < normalized_keys.size(); i++) {
+    keys.emplace_back(new storage::Tuple(&schema, true));
+    keys[i]->SetValue(
+        0, type::ValueFactory::GetIntegerValue(ints[rng() % ints.size()]),
+        pool);
+    const auto &str = strings[rng() % strings.size()];
+    keys[i]->SetValue(1, type::ValueFactory::GetVarcharValue(str), pool);
+    auto decimal = decimals[rng() % decimals.size()];
+    keys[i]->SetValue(2, type::ValueFactory::GetDecimalValue(decimal), pool);
+    normalized_keys[i].SetFromKey(keys[i].get());
+  }
+
+  for (uint32_t i = 0; i < keys.size(); i++) {
+    for (uint32_t j = 0; j < keys.size(); j++) {
+      EXPECT_EQ(CompareValues(*keys[i], *keys[j]),
+                Sign(index::VarlenNormalizedKey::Compare(normalized_keys[i],
+                                                         normalized_keys[j])))
+          << keys[i]->GetInfo() << " vs. " << keys[j]->GetInfo();
+    }
+  }
+}
+
+TEST_F(NormalizedKeyTests, FixedLengthTest) {
+  std::vector<type::TypeId> types = {type::TypeId::SMALLINT,
+                                     type::TypeId::TIMESTAMP,
+                                     type::TypeId::DATE};
+  std::vector<catalog::Column> columns;
+  for (auto type_id : types) {
+    columns.emplace_back(type_id, type::Type::GetTypeSize(type_id), "col",
+                         true);
+  }
+  catalog::Schema schema(columns);
+  EXPECT_EQ(14, index::KeyNormalizer::GetFixedLength(schema));
+
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+  std::vector<std::unique_ptr<storage::Tuple>> keys;
+  std::vector<index::NormalizedKey<16>> normalized_keys;
+  for (int16_t small : {-7, 0, 7}) {
+    for (uint64_t timestamp : {0ul, 1ul, 1ul << 40}) {
+      for (int32_t date : {-1, 3}) {
+        keys.emplace_back(new storage::Tuple(&schema, true));
+        keys.back()->SetValue(0, type::ValueFactory::GetSmallIntValue(small),
+                              pool);
+        keys.back()->SetValue(
+            1, type::ValueFactory::GetTimestampValue(timestamp), pool);
+        keys.back()->SetValue(2, type::ValueFactory::GetDateValue(date), pool);
+        normalized_keys.emplace_back();
+        normalized_keys.back().SetFromKey(keys.back().get());
+      }
+    }
+  }
+
+  for (uint32_t i = 0; i < keys.size(); i++) {
+    for (uint32_t j = 0; j < keys.size(); j++) {
+      EXPECT_EQ(CompareValues(*keys[i], *keys[j]),
+                Sign(index::NormalizedKey<16>::Compare(normalized_keys[i],
+                                                       normalized_keys[j])));
+    }
+  }
+}
+
+TEST_F(NormalizedKeyTests, NullOrderTest) {
+  std::vector<catalog::Column> columns = {
+      catalog::Column(type::TypeId::BIGINT,
+                      type::Type::GetTypeSize(type::TypeId::BIGINT), "a",
+                      true),
+      catalog::Column(type::TypeId::VARCHAR, 16, "b", false)};
+  catalog::Schema schema(columns);
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+
+  auto normalize = [&schema, pool](const type::Value &a, const type::Value &b)
+      -> index::VarlenNormalizedKey {
+    storage::Tuple key(&schema, true);
+    key.SetValue(0, a, pool);
+    key.SetValue(1, b, pool);
+    index::VarlenNormalizedKey normalized_key;
+    normalized_key.SetFromKey(&key);
+    return normalized_key;
+  };
+
+  // NULL integers sort below the smallest value, like in CompactIntsKey
+  auto null_int = normalize(type::ValueFactory::GetNullValueByType(
+                                type::TypeId::BIGINT),
+                            type::ValueFactory::GetVarcharValue("a"));
+  auto min_int = normalize(type::Type::GetMinValue(type::TypeId::BIGINT),
+                           type::ValueFactory::GetVarcharValue("a"));
+  EXPECT_GT(0, index::VarlenNormalizedKey::Compare(null_int, min_int));
+
+  // NULL strings sort above every string, since scans use them as the upper
+  // bound of string columns
+  auto max_string = normalize(type::ValueFactory::GetBigIntValue(1),
+                              type::Type::GetMaxValue(type::TypeId::VARCHAR));
+  auto string = normalize(type::ValueFactory::GetBigIntValue(1),
+                          type::ValueFactory::GetVarcharValue("\xff\xff"));
+  auto next_int = normalize(type::ValueFactory::GetBigIntValue(2),
+                            type::ValueFactory::GetVarcharValue(""));
+  EXPECT_LT(0, index::VarlenNormalizedKey::Compare(max_string, string));
+  EXPECT_GT(0, index::VarlenNormalizedKey::Compare(max_string, next_int));
+}
+
+}  // namespace test
+}  // namespace peloton
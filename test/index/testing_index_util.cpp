@@ -21,6 +21,7 @@
 #include "catalog/catalog.h"
 #include "index/index.h"
 #include "index/index_util.h"
+#include "index/scan_optimizer.h"
 #include "storage/tuple.h"
 #include "type/value_factory.h"
 
@@ -681,6 +682,97 @@ void TestingIndexUtil::NonUniqueKeyMultiThreadedStressTest2(
   location_ptrs.clear();
 }
 
+void TestingIndexUtil::IteratorTest(const IndexType index_type) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+
+  // INDEX
+  std::unique_ptr<index::Index, void (*)(index::Index *)> index(
+      TestingIndexUtil::BuildIndex(index_type, false), DestroyIndex);
+  const catalog::Schema *key_schema = index->GetKeySchema();
+
+  // The value of key i points to block i. Keys are inserted out of order.
+  const int32_t num_keys = 500;
+  std::vector<ItemPointer> items;
+  for (int32_t i = 0; i < num_keys; i++) {
+    items.emplace_back(i, 0);
+  }
+  for (int32_t i = 0; i < num_keys; i++) {
+    int32_t key_val = (i * 7) % num_keys;
+    std::unique_ptr<storage::Tuple> key(new storage::Tuple(key_schema, true));
+    key->SetValue(0, type::ValueFactory::GetIntegerValue(key_val), pool);
+    key->SetValue(1, type::ValueFactory::GetVarcharValue("a"), pool);
+    index->InsertEntry(key.get(), &items[key_val]);
+  }
+
+  // Pull all values of the iterator in small batches, returning their blocks
+  auto pull_all = [](index::IndexIterator &itr) -> std::vector<int32_t> {
+    std::vector<ItemPointer *> location_ptrs;
+    size_t count;
+    while ((count = itr.Next(location_ptrs, 7)) > 0) {
+      EXPECT_GE(7, count);
+    }
+    std::vector<int32_t> blocks;
+    for (auto location_ptr : location_ptrs) {
+      blocks.push_back(location_ptr->block);
+    }
+    return blocks;
+  };
+
+  // Full scans
+  auto itr = index->GetIterator(ScanDirectionType::FORWARD, nullptr);
+  auto blocks = pull_all(*itr);
+  EXPECT_EQ(num_keys, blocks.size());
+  for (int32_t i = 0; i < static_cast<int32_t>(blocks.size()); i++) {
+    EXPECT_EQ(i, blocks[i]);
+  }
+
+  itr = index->GetIterator(ScanDirectionType::BACKWARD, nullptr);
+  blocks = pull_all(*itr);
+  EXPECT_EQ(num_keys, blocks.size());
+  for (int32_t i = 0; i < static_cast<int32_t>(blocks.size()); i++) {
+    EXPECT_EQ(num_keys - 1 - i, blocks[i]);
+  }
+
+  // 100 <= A <= 199
+  index::ConjunctionScanPredicate range_csp(
+      index.get(), {type::ValueFactory::GetIntegerValue(100),
+                    type::ValueFactory::GetIntegerValue(199)},
+      {0, 0}, {ExpressionType::COMPARE_GREATERTHANOREQUALTO,
+               ExpressionType::COMPARE_LESSTHANOREQUALTO});
+
+  itr = index->GetIterator(ScanDirectionType::FORWARD, &range_csp);
+  blocks = pull_all(*itr);
+  EXPECT_EQ(100, blocks.size());
+  for (int32_t i = 0; i < static_cast<int32_t>(blocks.size()); i++) {
+    EXPECT_EQ(100 + i, blocks[i]);
+  }
+
+  itr = index->GetIterator(ScanDirectionType::BACKWARD, &range_csp);
+  blocks = pull_all(*itr);
+  EXPECT_EQ(100, blocks.size());
+  for (int32_t i = 0; i < static_cast<int32_t>(blocks.size()); i++) {
+    EXPECT_EQ(199 - i, blocks[i]);
+  }
+
+  // A scan can be stopped early, and resumed where it stopped
+  std::vector<ItemPointer *> location_ptrs;
+  itr = index->GetIterator(ScanDirectionType::FORWARD, &range_csp);
+  EXPECT_EQ(3, itr->Next(location_ptrs, 3));
+  EXPECT_EQ(1, itr->Next(location_ptrs, 1));
+  EXPECT_EQ(4, location_ptrs.size());
+  EXPECT_EQ(103, location_ptrs[3]->block);
+
+  // Point query
+  index::ConjunctionScanPredicate point_csp(
+      index.get(), {type::ValueFactory::GetIntegerValue(42),
+                    type::ValueFactory::GetVarcharValue("a")},
+      {0, 1}, {ExpressionType::COMPARE_EQUAL, ExpressionType::COMPARE_EQUAL});
+  itr = index->GetIterator(ScanDirectionType::FORWARD, &point_csp);
+  blocks = pull_all(*itr);
+  EXPECT_EQ(1, blocks.size());
+  EXPECT_EQ(42, blocks[0]);
+}
+
 std::unique_ptr<index::IndexMetadata> TestingIndexUtil::BuildTestIndexMetadata(
     const IndexType index_type, const bool unique_keys) {
   LOG_DEBUG("Build index type: %s [unique_keys=%s]",
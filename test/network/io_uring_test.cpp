@@ -0,0 +1,207 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// io_uring_test.cpp
+//
+// Identification: test/network/io_uring_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "network/io_uring.h"
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "common/harness.h"
+#include "common/logger.h"
+#include "network/connection_handler_task.h"
+#include "network/marshal.h"
+#include "network/network_io_wrappers.h"
+#include "settings/settings_manager.h"
+
+namespace peloton {
+namespace test {
+
+class IoUringTests : public PelotonTest {};
+
+TEST_F(IoUringTests, BatchedSendTest) {
+  auto ring = network::IoUring::Create(4);
+  if (ring == nullptr) {
+    LOG_INFO("io_uring is not available, skipping");
+    return;
+  }
+  EXPECT_LE(4, ring->GetNumEntries());
+
+  // Send to a few sockets in one submission
+  const int num_sockets = 3;
+  int fds[num_sockets][2];
+  std::string messages[num_sockets] = {"a", "bb", "ccc"};
+  for (int i = 0; i < num_sockets; i++) {
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds[i]));
+    EXPECT_TRUE(ring->PrepareSend(fds[i][0], messages[i].data(),
+                                  messages[i].size(), i));
+  }
+  EXPECT_EQ(num_sockets, ring->Submit());
+  EXPECT_EQ(0, ring->WaitForCompletions(num_sockets));
+
+  std::map<uint64_t, int32_t> results;
+  auto collect = [&results](const network::IoUring::Completion &completion) {
+    results[completion.user_data] = completion.result;
+  };
+  ring->ForEachCompletion(collect);
+  ASSERT_EQ(num_sockets, results.size());
+  for (int i = 0; i < num_sockets; i++) {
+    EXPECT_EQ(messages[i].size(), results[i]);
+    char buf[8];
+    ASSERT_EQ(messages[i].size(), read(fds[i][1], buf, sizeof(buf)));
+    EXPECT_EQ(messages[i], std::string(buf, messages[i].size()));
+    close(fds[i][0]);
+    close(fds[i][1]);
+  }
+
+  // The ring can be reused, and errors are reported per request
+  EXPECT_TRUE(ring->PrepareSend(fds[0][0], "x", 1, 42));
+  EXPECT_EQ(1, ring->Submit());
+  EXPECT_EQ(0, ring->WaitForCompletions(1));
+  results.clear();
+  ring->ForEachCompletion(collect);
+  ASSERT_EQ(1, results.size());
+  EXPECT_GT(0, results[42]);
+}
+
+TEST_F(IoUringTests, PartialFlushTest) {
+  settings::SettingsManager::SetBool(settings::SettingId::io_uring, true);
+  network::ConnectionHandlerTask handler(0);
+  settings::SettingsManager::SetBool(settings::SettingId::io_uring, false);
+  if (handler.GetIoUring() == nullptr) {
+    LOG_INFO("io_uring is not available, skipping");
+    return;
+  }
+
+  int fds[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+  auto rbuf = std::make_shared<network::ReadBuffer>();
+  auto wbuf = std::make_shared<network::WriteBuffer>();
+  network::IoUringSocketIoWrapper io_wrapper(fds[0], rbuf, wbuf, &handler);
+
+  // Fill up the socket, so that it can't take anything more
+  char filler[1024];
+  PELOTON_MEMSET(filler, 'x', sizeof(filler));
+  size_t num_filled = 0;
+  ssize_t ret;
+  while ((ret = write(fds[0], filler, sizeof(filler))) > 0) {
+    num_filled += ret;
+  }
+  ASSERT_EQ(EAGAIN, errno);
+
+  std::string response(wbuf->Capacity(), 'r');
+  for (size_t i = 0; i < response.size(); i++) {
+    response[i] = static_cast<char>('a' + i % 26);
+  }
+  wbuf->Append(response.begin(), response.size());
+
+  // The batched send must not wait for the socket. Nothing is written, and the
+  // rest of the buffer is left for when the socket is writable.
+  EXPECT_EQ(network::Transition::PROCEED,
+            io_wrapper.ScheduleFlushWriteBuffer());
+  handler.FlushWrites(0, 0);
+  EXPECT_EQ(0, wbuf->offset_);
+  EXPECT_TRUE(wbuf->HasMore());
+
+  // Once the client reads, the rest goes out in order
+  std::vector<char> buf(num_filled);
+  size_t num_read = 0;
+  while (num_read < num_filled) {
+    ret = read(fds[1], buf.data(), num_filled - num_read);
+    ASSERT_LT(0, ret);
+    num_read += ret;
+  }
+  EXPECT_EQ(network::Transition::PROCEED, io_wrapper.FlushWriteBuffer());
+  EXPECT_FALSE(wbuf->HasMore());
+
+  num_read = 0;
+  while (num_read < response.size()) {
+    ret = read(fds[1], buf.data() + num_read, response.size() - num_read);
+    ASSERT_LT(0, ret);
+    num_read += ret;
+  }
+  EXPECT_EQ(response, std::string(buf.data(), response.size()));
+
+  close(fds[0]);
+  close(fds[1]);
+}
+
+TEST_F(IoUringTests, MultishotReceiveTest) {
+  settings::SettingsManager::SetBool(settings::SettingId::io_uring, true);
+  network::ConnectionHandlerTask handler(0);
+  settings::SettingsManager::SetBool(settings::SettingId::io_uring, false);
+  if (!handler.ReceivesThroughIoUring()) {
+    LOG_INFO("Multishot io_uring receives are not available, skipping");
+    return;
+  }
+
+  int fds[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+  auto rbuf = std::make_shared<network::ReadBuffer>();
+  auto wbuf = std::make_shared<network::WriteBuffer>();
+  network::IoUringSocketIoWrapper io_wrapper(fds[0], rbuf, wbuf, &handler);
+
+  // The kernel may take a moment to get what was written to the receive
+  auto read_all = [&io_wrapper, &rbuf]() {
+    std::string data;
+    for (int i = 0; i < 1000 && data.empty(); i++) {
+      auto result = io_wrapper.FillReadBuffer();
+      if (result == network::Transition::PROCEED) {
+        data.assign(rbuf->buf_.begin() + rbuf->offset_,
+                    rbuf->buf_.begin() + rbuf->size_);
+        rbuf->offset_ = rbuf->size_;
+      } else {
+        EXPECT_EQ(network::Transition::NEED_READ, result);
+        usleep(1000);
+      }
+    }
+    return data;
+  };
+
+  // Queries are read from the buffers the multishot receive filled, and it
+  // stays armed for the next ones
+  std::string query = "SELECT 1;";
+  ASSERT_EQ(static_cast<ssize_t>(query.size()),
+            write(fds[1], query.data(), query.size()));
+  EXPECT_EQ(query, read_all());
+  query = "SELECT 2;";
+  ASSERT_EQ(static_cast<ssize_t>(query.size()),
+            write(fds[1], query.data(), query.size()));
+  EXPECT_EQ(query, read_all());
+
+  // Once stopped, the receive leaves what comes next in the socket
+  io_wrapper.StopReceiving();
+  ASSERT_EQ(static_cast<ssize_t>(query.size()),
+            write(fds[1], query.data(), query.size()));
+  char buf[16];
+  EXPECT_EQ(static_cast<ssize_t>(query.size()),
+            recv(fds[0], buf, sizeof(buf), MSG_DONTWAIT));
+
+  // A client that hangs up ends the connection
+  ASSERT_EQ(network::Transition::NEED_READ, io_wrapper.FillReadBuffer());
+  close(fds[1]);
+  network::Transition result = network::Transition::NEED_READ;
+  for (int i = 0; i < 1000 && result == network::Transition::NEED_READ; i++) {
+    usleep(1000);
+    result = io_wrapper.FillReadBuffer();
+  }
+  EXPECT_EQ(network::Transition::TERMINATE, result);
+  close(fds[0]);
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// packet_writer_test.cpp
+//
+// Identification: test/network/packet_writer_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "common/harness.h"
+#include "network/network_io_wrappers.h"
+
+namespace peloton {
+namespace test {
+
+class PacketWriterTests : public PelotonTest {};
+
+namespace {
+
+int32_t ReadInt32(const ByteBuf &buf, size_t offset) {
+  int32_t val;
+  PELOTON_MEMCPY(&val, &buf[offset], sizeof(val));
+  return ntohl(val);
+}
+
+int16_t ReadInt16(const ByteBuf &buf, size_t offset) {
+  int16_t val;
+  PELOTON_MEMCPY(&val, &buf[offset], sizeof(val));
+  return ntohs(val);
+}
+
+}  // namespace
+
+TEST_F(PacketWriterTests, BackpatchLengthTest) {
+  network::WriteBuffer wbuf;
+  network::PacketWriter writer(wbuf);
+  writer.BeginPacket(NetworkMessageType::DATA_ROW);
+  writer.AppendInt16(1);
+  writer.AppendInt32(3);
+  writer.AppendString("abc");
+  writer.EndPacket();
+
+  ByteBuf bytes(wbuf.buf_.data(), wbuf.buf_.data() + wbuf.size_);
+  ASSERT_EQ(1 + 4 + 2 + 4 + 3, bytes.size());
+  EXPECT_EQ(static_cast<uchar>(NetworkMessageType::DATA_ROW), bytes[0]);
+  // The length includes itself but not the type
+  EXPECT_EQ(bytes.size() - 1, ReadInt32(bytes, 1));
+  EXPECT_EQ(1, ReadInt16(bytes, 5));
+  EXPECT_EQ(3, ReadInt32(bytes, 7));
+  EXPECT_EQ("abc", std::string(bytes.begin() + 11, bytes.end()));
+}
+
+TEST_F(PacketWriterTests, WriteDataRowsTest) {
+  int fds[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+  network::PosixSocketIoWrapper io_wrapper(
+      fds[0], std::make_shared<network::ReadBuffer>(),
+      std::make_shared<network::WriteBuffer>());
+
+  // Enough rows to fill the buffer a few times, with an empty (NULL) value
+  // and a row too wide for the buffer in between
+  const size_t num_rows = 1000;
+  std::vector<std::string> rows;
+  for (size_t i = 0; i < num_rows; i++) {
+    rows.push_back(std::to_string(i));
+    rows.push_back(i == 500 ? std::string(3 * SOCKET_BUFFER_SIZE, 'x')
+                            : i == 700 ? "" : "value");
+  }
+  network::OutputPacket pkt;
+  pkt.Reset();
+  pkt.msg_type = NetworkMessageType::DATA_ROW;
+  pkt.num_columns = 2;
+  pkt.rows = rows;
+  ASSERT_EQ(network::Transition::PROCEED, io_wrapper.WritePacket(&pkt));
+  ASSERT_EQ(network::Transition::PROCEED, io_wrapper.FlushWriteBuffer());
+  close(fds[0]);
+
+  ByteBuf bytes;
+  uchar buf[4096];
+  ssize_t bytes_read;
+  while ((bytes_read = read(fds[1], buf, sizeof(buf))) > 0) {
+    bytes.insert(bytes.end(), buf, buf + bytes_read);
+  }
+  close(fds[1]);
+
+  size_t offset = 0;
+  for (size_t i = 0; i < num_rows; i++) {
+    ASSERT_LT(offset, bytes.size());
+    EXPECT_EQ(static_cast<uchar>(NetworkMessageType::DATA_ROW), bytes[offset]);
+    size_t end = offset + 1 + ReadInt32(bytes, offset + 1);
+    EXPECT_EQ(2, ReadInt16(bytes, offset + 5));
+    offset += 7;
+    for (size_t j = 0; j < 2; j++) {
+      int32_t len = ReadInt32(bytes, offset);
+      offset += sizeof(int32_t);
+      auto &expected = rows[i * 2 + j];
+      if (expected.empty()) {
+        EXPECT_EQ(-1, len);
+        continue;
+      }
+      ASSERT_EQ(expected.size(), len);
+      EXPECT_EQ(expected, std::string(bytes.begin() + offset,
+                                      bytes.begin() + offset + len));
+      offset += len;
+    }
+    EXPECT_EQ(end, offset);
+  }
+  EXPECT_EQ(bytes.size(), offset);
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,266 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// postgres_protocol_handler_test.cpp
+//
+// Identification: test/network/postgres_protocol_handler_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "network/postgres_protocol_handler.h"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "common/harness.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "network/connection_handle.h"
+#include "network/connection_handler_task.h"
+#include "settings/settings_manager.h"
+#include "sql/testing_sql_util.h"
+#include "traffic_cop/traffic_cop.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Postgres Protocol Handler Tests
+//===--------------------------------------------------------------------===//
+
+class PostgresProtocolHandlerTests : public PelotonTest {
+ public:
+  // Appends an integer of the given number of bytes in network order
+  static void PutInt(std::string &buf, int32_t value, int len) {
+    for (int i = len - 1; i >= 0; i--) {
+      buf.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+  }
+
+  static void PutString(std::string &buf, const std::string &str) {
+    buf.append(str);
+    buf.push_back('\0');
+  }
+
+  static std::string Packet(char type, const std::string &body) {
+    std::string pkt(1, type);
+    PutInt(pkt, body.size() + 4, 4);
+    return pkt + body;
+  }
+
+  // The startup packet is the only one without a type
+  static std::string StartupPacket() {
+    std::string body;
+    PutInt(body, 3 << 16, 4);
+    PutString(body, "user");
+    PutString(body, "postgres");
+    PutString(body, "database");
+    PutString(body, DEFAULT_DB_NAME);
+    body.push_back('\0');
+    std::string pkt;
+    PutInt(pkt, body.size() + 4, 4);
+    return pkt + body;
+  }
+
+  // BIND of the unnamed portal to a statement taking two INTEGERs in text
+  // format, followed by its EXECUTE
+  static std::string BindExecute(const std::string &statement, int a, int b) {
+    std::string body;
+    PutString(body, "");
+    PutString(body, statement);
+    PutInt(body, 2, 2);
+    PutInt(body, 0, 2);
+    PutInt(body, 0, 2);
+    PutInt(body, 2, 2);
+    for (auto value : {std::to_string(a), std::to_string(b)}) {
+      PutInt(body, value.size(), 4);
+      body.append(value);
+    }
+    PutInt(body, 0, 2);
+
+    std::string execute;
+    PutString(execute, "");
+    PutInt(execute, 0, 4);
+    return Packet('B', body) + Packet('E', execute);
+  }
+
+  // Feeds the messages to the handler through a socket, and returns the types
+  // of the responses to them
+  std::vector<NetworkMessageType> Run(
+      network::PostgresProtocolHandler &handler, tcop::TrafficCop &traffic_cop,
+      const std::string &messages) {
+    int fds[2];
+    EXPECT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+    EXPECT_EQ(static_cast<ssize_t>(messages.size()),
+              write(fds[1], messages.data(), messages.size()));
+    network::ReadBuffer rbuf;
+    EXPECT_EQ(static_cast<int>(messages.size()), rbuf.FillBufferFrom(fds[0]));
+    close(fds[0]);
+    close(fds[1]);
+
+    while (rbuf.BytesAvailable() > 0) {
+      counter_.store(1);
+      auto status = handler.Process(rbuf, 0);
+      if (status == ProcessResult::PROCESSING) {
+        while (counter_.load() == 1) usleep(10);
+        handler.GetResult();
+        traffic_cop.SetQueuing(false);
+      } else {
+        EXPECT_EQ(ProcessResult::COMPLETE, status);
+      }
+    }
+
+    std::vector<NetworkMessageType> types;
+    for (auto &response : handler.responses_) {
+      types.push_back(response->msg_type);
+    }
+    handler.responses_.clear();
+    return types;
+  }
+
+  std::atomic_int counter_;
+};
+
+TEST_F(PostgresProtocolHandlerTests, BatchTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->CreateDatabase(txn, DEFAULT_DB_NAME);
+  txn_manager.CommitTransaction(txn);
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE batch_test(a INT PRIMARY KEY, b INT);");
+
+  settings::SettingsManager::SetBool(
+      settings::SettingId::batch_pipelined_executions, true);
+  tcop::TrafficCop traffic_cop(TestingSQLUtil::UtilTestTaskCallback,
+                               &counter_);
+  network::PostgresProtocolHandler handler(&traffic_cop);
+  Run(handler, traffic_cop, StartupPacket());
+
+  // A driver pipelines the inserts of a batch before a single SYNC
+  std::string parse;
+  PutString(parse, "batch");
+  PutString(parse, "INSERT INTO batch_test VALUES ($1, $2);");
+  PutInt(parse, 2, 2);
+  PutInt(parse, 23, 4);
+  PutInt(parse, 23, 4);
+  std::string messages = Packet('P', parse);
+  const int batch_size = 10;
+  for (int i = 0; i < batch_size; i++) {
+    messages += BindExecute("batch", i, i * 10);
+  }
+  messages += Packet('S', "");
+
+  // Every execution of the batch is still answered on its own
+  std::vector<NetworkMessageType> expected{NetworkMessageType::PARSE_COMPLETE};
+  for (int i = 0; i < batch_size; i++) {
+    expected.push_back(NetworkMessageType::BIND_COMPLETE);
+    expected.push_back(NetworkMessageType::COMMAND_COMPLETE);
+  }
+  expected.push_back(NetworkMessageType::READY_FOR_QUERY);
+  EXPECT_EQ(expected, Run(handler, traffic_cop, messages));
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT COUNT(*) FROM batch_test;", {"10"});
+
+  // An execution that fails ends the batch, and the others roll back with it
+  const int failed = 4;
+  messages.clear();
+  for (int i = 0; i < batch_size; i++) {
+    messages += BindExecute("batch", i == failed ? 0 : batch_size + i, i);
+  }
+  messages += Packet('S', "");
+
+  expected.clear();
+  for (int i = 0; i < failed; i++) {
+    expected.push_back(NetworkMessageType::BIND_COMPLETE);
+    expected.push_back(NetworkMessageType::COMMAND_COMPLETE);
+  }
+  expected.push_back(NetworkMessageType::BIND_COMPLETE);
+  expected.push_back(NetworkMessageType::ERROR_RESPONSE);
+  expected.push_back(NetworkMessageType::READY_FOR_QUERY);
+  EXPECT_EQ(expected, Run(handler, traffic_cop, messages));
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT COUNT(*) FROM batch_test;", {"10"});
+
+  settings::SettingsManager::SetBool(
+      settings::SettingId::batch_pipelined_executions, false);
+  txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(txn, DEFAULT_DB_NAME);
+  txn_manager.CommitTransaction(txn);
+}
+
+TEST_F(PostgresProtocolHandlerTests, PartialFlushTest) {
+  network::ConnectionHandlerTask handler(0);
+  int fds[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+  network::ConnectionHandle conn(fds[0], &handler);
+
+  std::string startup = StartupPacket();
+  ASSERT_EQ(static_cast<ssize_t>(startup.size()),
+            write(fds[1], startup.data(), startup.size()));
+  EXPECT_EQ(network::Transition::PROCEED, conn.TryRead());
+  EXPECT_EQ(network::Transition::PROCEED, conn.Process());
+
+  // Fill up the socket, so that it can't take the responses
+  char filler[1024];
+  PELOTON_MEMSET(filler, 'x', sizeof(filler));
+  size_t num_filled = 0;
+  ssize_t ret;
+  while ((ret = write(fds[0], filler, sizeof(filler))) > 0) {
+    num_filled += ret;
+  }
+  ASSERT_EQ(EAGAIN, errno);
+  EXPECT_EQ(network::Transition::NEED_WRITE, conn.TryWrite());
+
+  // Once the client reads, the next write finishes the flush
+  std::vector<char> buf(num_filled);
+  size_t num_read = 0;
+  while (num_read < num_filled) {
+    ret = read(fds[1], buf.data(), num_filled - num_read);
+    ASSERT_LT(0, ret);
+    num_read += ret;
+  }
+  EXPECT_EQ(network::Transition::PROCEED, conn.TryWrite());
+  char response[1024];
+  ret = read(fds[1], response, sizeof(response));
+  ASSERT_LT(6, ret);
+  EXPECT_EQ('R', response[0]);
+  EXPECT_EQ('Z', response[ret - 6]);
+
+  // With the flush done, the responses of the extended protocol are held
+  // back until the SYNC again
+  std::string close_stmt;
+  close_stmt.push_back('S');
+  PutString(close_stmt, "unknown");
+  std::string close_pkt = Packet('C', close_stmt);
+  ASSERT_EQ(static_cast<ssize_t>(close_pkt.size()),
+            write(fds[1], close_pkt.data(), close_pkt.size()));
+  EXPECT_EQ(network::Transition::PROCEED, conn.TryRead());
+  EXPECT_EQ(network::Transition::PROCEED, conn.Process());
+  EXPECT_EQ(network::Transition::PROCEED, conn.TryWrite());
+  EXPECT_EQ(-1, recv(fds[1], response, sizeof(response), MSG_DONTWAIT));
+  EXPECT_EQ(EAGAIN, errno);
+
+  std::string sync = Packet('S', "");
+  ASSERT_EQ(static_cast<ssize_t>(sync.size()),
+            write(fds[1], sync.data(), sync.size()));
+  EXPECT_EQ(network::Transition::PROCEED, conn.TryRead());
+  EXPECT_EQ(network::Transition::PROCEED, conn.Process());
+  EXPECT_EQ(network::Transition::PROCEED, conn.TryWrite());
+  ret = read(fds[1], response, sizeof(response));
+  ASSERT_EQ(11, ret);
+  EXPECT_EQ('3', response[0]);
+  EXPECT_EQ('Z', response[5]);
+
+  close(fds[0]);
+  close(fds[1]);
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,142 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// cardinality_feedback_test.cpp
+//
+// Identification: test/optimizer/cardinality_feedback_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <vector>
+
+#include "common/harness.h"
+#include "expression/comparison_expression.h"
+#include "expression/constant_value_expression.h"
+#include "expression/parameter_value_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "optimizer/stats/cardinality_feedback.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+using namespace optimizer;
+
+class CardinalityFeedbackTests : public PelotonTest {};
+
+namespace {
+
+// Build the annotated predicate "column <cmp_type> value"
+AnnotatedExpression MakePredicate(ExpressionType cmp_type, oid_t column_oid,
+                                  expression::AbstractExpression *value) {
+  auto *column = new expression::TupleValueExpression("a", "test");
+  column->SetBoundOid(1, 2, column_oid);
+  std::unordered_set<std::string> table_alias_set = {"test"};
+  return AnnotatedExpression(
+      std::shared_ptr<expression::AbstractExpression>(
+          new expression::ComparisonExpression(cmp_type, column, value)),
+      table_alias_set);
+}
+
+AnnotatedExpression MakePredicate(ExpressionType cmp_type, oid_t column_oid,
+                                  int value) {
+  return MakePredicate(cmp_type, column_oid,
+                       new expression::ConstantValueExpression(
+                           type::ValueFactory::GetIntegerValue(value)));
+}
+
+AnnotatedExpression MakeParameterPredicate(ExpressionType cmp_type,
+                                           oid_t column_oid, int value_idx) {
+  return MakePredicate(cmp_type, column_oid,
+                       new expression::ParameterValueExpression(value_idx));
+}
+
+}  // namespace
+
+TEST_F(CardinalityFeedbackTests, PredicateSignatureTest) {
+  std::vector<AnnotatedExpression> predicates = {
+      MakePredicate(ExpressionType::COMPARE_EQUAL, 0, 1),
+      MakePredicate(ExpressionType::COMPARE_LESSTHAN, 1, 2)};
+  auto signature =
+      CardinalityFeedback::GetPredicateSignature(1, 2, predicates);
+  EXPECT_FALSE(signature.empty());
+
+  // The order of the conjuncts does not matter
+  std::vector<AnnotatedExpression> reordered = {
+      MakePredicate(ExpressionType::COMPARE_LESSTHAN, 1, 2),
+      MakePredicate(ExpressionType::COMPARE_EQUAL, 0, 1)};
+  EXPECT_EQ(signature,
+            CardinalityFeedback::GetPredicateSignature(1, 2, reordered));
+
+  // The constants, columns, comparisons and tables do
+  std::vector<AnnotatedExpression> other_constant = {
+      MakePredicate(ExpressionType::COMPARE_EQUAL, 0, 1),
+      MakePredicate(ExpressionType::COMPARE_LESSTHAN, 1, 20)};
+  EXPECT_NE(signature,
+            CardinalityFeedback::GetPredicateSignature(1, 2, other_constant));
+  std::vector<AnnotatedExpression> other_column = {
+      MakePredicate(ExpressionType::COMPARE_EQUAL, 1, 1),
+      MakePredicate(ExpressionType::COMPARE_LESSTHAN, 1, 2)};
+  EXPECT_NE(signature,
+            CardinalityFeedback::GetPredicateSignature(1, 2, other_column));
+  std::vector<AnnotatedExpression> other_comparison = {
+      MakePredicate(ExpressionType::COMPARE_EQUAL, 0, 1),
+      MakePredicate(ExpressionType::COMPARE_GREATERTHAN, 1, 2)};
+  EXPECT_NE(signature, CardinalityFeedback::GetPredicateSignature(
+                           1, 2, other_comparison));
+  EXPECT_NE(signature,
+            CardinalityFeedback::GetPredicateSignature(1, 3, predicates));
+
+  EXPECT_TRUE(CardinalityFeedback::GetPredicateSignature(1, 2, {}).empty());
+}
+
+TEST_F(CardinalityFeedbackTests, ParameterSignatureTest) {
+  // The executions of a prepared equality share the feedback
+  std::vector<AnnotatedExpression> equality = {
+      MakeParameterPredicate(ExpressionType::COMPARE_EQUAL, 0, 0),
+      MakePredicate(ExpressionType::COMPARE_LESSTHAN, 1, 2)};
+  auto signature = CardinalityFeedback::GetPredicateSignature(1, 2, equality);
+  EXPECT_FALSE(signature.empty());
+  std::vector<AnnotatedExpression> other_parameter = {
+      MakeParameterPredicate(ExpressionType::COMPARE_EQUAL, 0, 1),
+      MakePredicate(ExpressionType::COMPARE_LESSTHAN, 1, 2)};
+  EXPECT_EQ(signature,
+            CardinalityFeedback::GetPredicateSignature(1, 2, other_parameter));
+
+  // Those of a prepared range don't, since their selectivities differ
+  std::vector<AnnotatedExpression> range = {
+      MakePredicate(ExpressionType::COMPARE_EQUAL, 0, 1),
+      MakeParameterPredicate(ExpressionType::COMPARE_LESSTHAN, 1, 0)};
+  EXPECT_TRUE(CardinalityFeedback::GetPredicateSignature(1, 2, range).empty());
+}
+
+TEST_F(CardinalityFeedbackTests, RecordCardinalityTest) {
+  auto *feedback = CardinalityFeedback::GetInstance();
+  feedback->Clear();
+
+  double selectivity;
+  EXPECT_FALSE(feedback->GetSelectivity("sig", selectivity));
+
+  feedback->RecordCardinality("sig", 10, 100);
+  ASSERT_TRUE(feedback->GetSelectivity("sig", selectivity));
+  EXPECT_DOUBLE_EQ(0.1, selectivity);
+
+  // Later executions are averaged in
+  feedback->RecordCardinality("sig", 30, 100);
+  ASSERT_TRUE(feedback->GetSelectivity("sig", selectivity));
+  EXPECT_LT(0.1, selectivity);
+  EXPECT_GT(0.3, selectivity);
+
+  // Scans of empty tables say nothing about the selectivity
+  feedback->RecordCardinality("empty", 0, 0);
+  EXPECT_FALSE(feedback->GetSelectivity("empty", selectivity));
+
+  feedback->Clear();
+  EXPECT_FALSE(feedback->GetSelectivity("sig", selectivity));
+}
+
+}  // namespace test
+}  // namespace peloton
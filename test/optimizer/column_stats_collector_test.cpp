@@ -62,6 +62,40 @@ TEST_F(ColumnStatsCollectorTests, DistinctValueTest) {
   EXPECT_EQ(colstats.GetHistogramBound().size(), 0);  // No histogram dist
 }
 
+// Merging collectors of disjoint parts of a column should produce the same
+// stats as collecting the whole column.
+TEST_F(ColumnStatsCollectorTests, MergeTest) {
+  ColumnStatsCollector colstats{TEST_OID, TEST_OID, TEST_OID,
+                                type::TypeId::INTEGER, ""};
+  ColumnStatsCollector colstats1{TEST_OID, TEST_OID, TEST_OID,
+                                 type::TypeId::INTEGER, ""};
+  ColumnStatsCollector colstats2{TEST_OID, TEST_OID, TEST_OID,
+                                 type::TypeId::INTEGER, ""};
+  for (int i = 0; i < 1000; i++) {
+    // Value 0 is the most common value
+    type::Value v = type::ValueFactory::GetIntegerValue(i % 3 == 0 ? 0 : i);
+    colstats.AddValue(v);
+    if (i < 500) {
+      colstats1.AddValue(v);
+    } else {
+      colstats2.AddValue(v);
+    }
+  }
+  colstats1.AddValue(
+      type::ValueFactory::GetNullValueByType(type::TypeId::INTEGER));
+  colstats1.Merge(colstats2);
+
+  EXPECT_EQ(colstats1.GetCardinality(), colstats.GetCardinality());
+  EXPECT_NEAR(colstats1.GetFracNull(), 1.0 / 1001, 1e-9);
+  EXPECT_EQ(colstats1.GetHistogramBound().size(),
+            colstats.GetHistogramBound().size());
+
+  auto common_values = colstats1.GetCommonValueAndFrequency();
+  ASSERT_GT(common_values.size(), 0);
+  EXPECT_EQ(common_values[0].first.GetAs<int>(), 0);
+  EXPECT_GE(common_values[0].second, 334);
+}
+
 // Test dataset with extreme distribution.
 // More specifically distribution with large amount of data at tail
 // with single continuous value to the left of tail.
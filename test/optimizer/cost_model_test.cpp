@@ -0,0 +1,143 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// cost_model_test.cpp
+//
+// Identification: test/optimizer/cost_model_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+#include "optimizer/cost_calculator.h"
+#include "optimizer/operator_expression.h"
+#include "optimizer/operators.h"
+#include "optimizer/optimizer_metadata.h"
+#include "optimizer/stats/cost.h"
+#include "optimizer/stats/cost_model.h"
+#include "settings/settings_manager.h"
+
+namespace peloton {
+namespace test {
+
+using namespace optimizer;
+
+class CostModelTests : public PelotonTest {};
+
+namespace {
+
+std::shared_ptr<OperatorExpression> MakeGet(const std::string &alias) {
+  static oid_t get_id = 0;
+  return std::make_shared<OperatorExpression>(
+      LogicalGet::make(++get_id, {}, nullptr, alias));
+}
+
+/**
+ * Cost the join of two inputs with the given number of rows, producing
+ * output_rows rows
+ */
+double JoinCost(Operator join_op, int left_rows, int right_rows,
+                int output_rows) {
+  auto join = std::make_shared<OperatorExpression>(join_op);
+  join->PushChild(MakeGet("left"));
+  join->PushChild(MakeGet("right"));
+
+  OptimizerMetadata metadata;
+  std::shared_ptr<GroupExpression> gexpr;
+  metadata.RecordTransformedExpression(join, gexpr);
+  auto &memo = metadata.memo;
+  memo.GetGroupByID(gexpr->GetChildGroupId(0))->SetNumRows(left_rows);
+  memo.GetGroupByID(gexpr->GetChildGroupId(1))->SetNumRows(right_rows);
+  memo.GetGroupByID(gexpr->GetGroupID())->SetNumRows(output_rows);
+
+  CostCalculator cost_calculator;
+  return cost_calculator.CalculateCost(gexpr.get(), &memo, nullptr);
+}
+
+Operator MakeHashJoin() {
+  std::vector<std::unique_ptr<expression::AbstractExpression>> left_keys;
+  std::vector<std::unique_ptr<expression::AbstractExpression>> right_keys;
+  return PhysicalInnerHashJoin::make({}, left_keys, right_keys);
+}
+
+Operator MakeNLJoin() {
+  std::vector<std::unique_ptr<expression::AbstractExpression>> left_keys;
+  std::vector<std::unique_ptr<expression::AbstractExpression>> right_keys;
+  return PhysicalInnerNLJoin::make({}, left_keys, right_keys);
+}
+
+}  // namespace
+
+TEST_F(CostModelTests, JoinCostTest) {
+  // Building the hash table on the smaller input is cheaper. Compiled hash
+  // joins build on the left input, interpreted ones on the right input.
+  bool codegen =
+      settings::SettingsManager::GetBool(settings::SettingId::codegen);
+  settings::SettingsManager::SetBool(settings::SettingId::codegen, true);
+  EXPECT_LT(JoinCost(MakeHashJoin(), 100, 10000, 100),
+            JoinCost(MakeHashJoin(), 10000, 100, 100));
+  settings::SettingsManager::SetBool(settings::SettingId::codegen, false);
+  EXPECT_LT(JoinCost(MakeHashJoin(), 10000, 100, 100),
+            JoinCost(MakeHashJoin(), 100, 10000, 100));
+  settings::SettingsManager::SetBool(settings::SettingId::codegen, codegen);
+
+  // Outer joins cost at least as much as inner joins, and none of them is free
+  double inner_hash_cost = JoinCost(MakeHashJoin(), 1000, 1000, 1000);
+  double right_hash_cost =
+      JoinCost(PhysicalRightHashJoin::make(nullptr), 1000, 1000, 1000);
+  double outer_hash_cost =
+      JoinCost(PhysicalOuterHashJoin::make(nullptr), 1000, 1000, 1000);
+  EXPECT_LT(0, inner_hash_cost);
+  EXPECT_LT(inner_hash_cost, right_hash_cost);
+  EXPECT_LE(right_hash_cost, outer_hash_cost);
+
+  double inner_nl_cost = JoinCost(MakeNLJoin(), 1000, 1000, 1000);
+  double left_nl_cost =
+      JoinCost(PhysicalLeftNLJoin::make(nullptr), 1000, 1000, 1000);
+  EXPECT_LT(0, inner_nl_cost);
+  EXPECT_LT(inner_nl_cost, left_nl_cost);
+
+  // Nested loops are worse than hashing for large inputs
+  EXPECT_LT(inner_hash_cost, inner_nl_cost);
+}
+
+TEST_F(CostModelTests, IndexSearchCostTest) {
+  auto parameters = CostModel::GetDefaultParameters();
+  double num_entries = 1000000;
+
+  // Hash indexes look up a bucket, trees and skip lists walk down levels
+  double hash_cost =
+      CostModel::IndexSearchCost(parameters, IndexType::HASH, num_entries);
+  double bwtree_cost =
+      CostModel::IndexSearchCost(parameters, IndexType::BWTREE, num_entries);
+  double skiplist_cost =
+      CostModel::IndexSearchCost(parameters, IndexType::SKIPLIST, num_entries);
+  EXPECT_LT(hash_cost, bwtree_cost);
+  EXPECT_LT(bwtree_cost, skiplist_cost);
+
+  // Larger indexes are deeper
+  EXPECT_LT(CostModel::IndexSearchCost(parameters, IndexType::BWTREE, 100),
+            bwtree_cost);
+}
+
+TEST_F(CostModelTests, CalibrationTest) {
+  auto cost_model = CostModel::GetInstance();
+  auto default_parameters = cost_model->GetParameters();
+
+  cost_model->Calibrate();
+  auto parameters = cost_model->GetParameters();
+  EXPECT_EQ(DEFAULT_TUPLE_COST, parameters.tuple_cpu_cost);
+  EXPECT_LT(0, parameters.tuple_copy_cost);
+  EXPECT_LT(0, parameters.hash_build_cost);
+  EXPECT_LT(0, parameters.hash_probe_cost);
+  EXPECT_LT(0, parameters.random_access_cost);
+  EXPECT_LT(0, parameters.key_compare_cost);
+  EXPECT_LT(0, parameters.tuple_write_cost);
+
+  cost_model->SetParameters(default_parameters);
+}
+
+}  // namespace test
+}  // namespace peloton
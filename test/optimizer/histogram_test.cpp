@@ -141,5 +141,24 @@ TEST_F(HistogramTests, SumTest) {
   EXPECT_EQ(h.Sum(6), 1);
 }
 
+// Merging two histograms should be close to a histogram of all points.
+TEST_F(HistogramTests, MergeTest) {
+  Histogram h{}, h1{}, h2{};
+  for (int i = 0; i < 1000; i++) {
+    h.Update(i);
+    if (i % 2 == 0) {
+      h1.Update(i);
+    } else {
+      h2.Update(i);
+    }
+  }
+  h1.Merge(h2);
+  EXPECT_EQ(h1.GetTotalValueCount(), h.GetTotalValueCount());
+  EXPECT_EQ(h1.GetMinValue(), 0);
+  EXPECT_EQ(h1.GetMaxValue(), 999);
+  EXPECT_NEAR(h1.Sum(500), h.Sum(500), 10);
+  EXPECT_EQ(h1.Uniform().size(), h.Uniform().size());
+}
+
 }  // namespace test
 }  // namespace peloton
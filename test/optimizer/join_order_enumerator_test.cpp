@@ -0,0 +1,170 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// join_order_enumerator_test.cpp
+//
+// Identification: test/optimizer/join_order_enumerator_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+#include "expression/comparison_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "optimizer/join_order_enumerator.h"
+#include "optimizer/operator_expression.h"
+#include "optimizer/operators.h"
+#include "optimizer/optimizer_metadata.h"
+#include "optimizer/rule.h"
+#include "settings/settings_manager.h"
+
+namespace peloton {
+namespace test {
+
+using namespace optimizer;
+
+class JoinOrderEnumeratorTests : public PelotonTest {};
+
+namespace {
+
+// Gets are told apart by their id
+std::shared_ptr<OperatorExpression> MakeGet(const std::string &alias) {
+  static oid_t get_id = 0;
+  return std::make_shared<OperatorExpression>(
+      LogicalGet::make(++get_id, {}, nullptr, alias));
+}
+
+// Build the annotated predicate "left.x = right.x"
+AnnotatedExpression MakeJoinPredicate(const std::string &left,
+                                      const std::string &right) {
+  std::unordered_set<std::string> table_alias_set = {left, right};
+  return AnnotatedExpression(
+      std::shared_ptr<expression::AbstractExpression>(
+          new expression::ComparisonExpression(
+              ExpressionType::COMPARE_EQUAL,
+              new expression::TupleValueExpression("x", std::string(left)),
+              new expression::TupleValueExpression("x", std::string(right)))),
+      table_alias_set);
+}
+
+std::shared_ptr<OperatorExpression> MakeJoin(
+    std::shared_ptr<OperatorExpression> left,
+    std::shared_ptr<OperatorExpression> right,
+    std::vector<AnnotatedExpression> predicates) {
+  auto join = std::make_shared<OperatorExpression>(
+      LogicalInnerJoin::make(predicates));
+  join->PushChild(left);
+  join->PushChild(right);
+  return join;
+}
+
+// Set the number of rows of the group of each table
+void SetTableRows(Memo &memo,
+                  const std::unordered_map<std::string, int> &table_rows) {
+  for (auto &group : memo.Groups()) {
+    auto &aliases = group->GetTableAliases();
+    if (aliases.size() == 1 && table_rows.count(*aliases.begin()) != 0) {
+      group->SetNumRows(table_rows.at(*aliases.begin()));
+    }
+  }
+}
+
+}  // namespace
+
+TEST_F(JoinOrderEnumeratorTests, AvoidCrossProductTest) {
+  // SELECT * FROM a, c, b WHERE a.x = b.x AND b.x = c.x, planned as
+  // (a JOIN c) JOIN b, which starts with a cross product of the large tables
+  OptimizerMetadata metadata;
+  std::shared_ptr<GroupExpression> root_gexpr;
+  metadata.RecordTransformedExpression(
+      MakeJoin(MakeJoin(MakeGet("a"), MakeGet("c"), {}), MakeGet("b"),
+               {MakeJoinPredicate("a", "b"), MakeJoinPredicate("b", "c")}),
+      root_gexpr);
+  auto &memo = metadata.memo;
+  SetTableRows(memo, {{"a", 1000}, {"b", 10}, {"c", 1000}});
+
+  JoinOrderEnumerator enumerator(memo, metadata.rule_set);
+  auto new_exprs = enumerator.Enumerate(root_gexpr->GetGroupID());
+  EXPECT_FALSE(new_exprs.empty());
+
+  // The root group gets the join of b with a or c first
+  auto root_group = memo.GetGroupByID(root_gexpr->GetGroupID());
+  auto logical_exprs = root_group->GetLogicalExpressions();
+  ASSERT_LE(2, logical_exprs.size());
+  for (size_t i = 1; i < logical_exprs.size(); i++) {
+    auto &child_groups = logical_exprs[i]->GetChildGroupIDs();
+    ASSERT_EQ(2, child_groups.size());
+    auto &left_aliases = memo.GetGroupByID(child_groups[0])->GetTableAliases();
+    auto &right_aliases = memo.GetGroupByID(child_groups[1])->GetTableAliases();
+    auto &join_aliases =
+        left_aliases.size() == 2 ? left_aliases : right_aliases;
+    EXPECT_EQ(3, left_aliases.size() + right_aliases.size());
+    ASSERT_EQ(2, join_aliases.size());
+    EXPECT_EQ(1, join_aliases.count("b"));
+
+    // Each join evaluates the predicate between its inputs
+    EXPECT_EQ(1, logical_exprs[i]
+                     ->Op()
+                     .As<LogicalInnerJoin>()
+                     ->join_predicates.size());
+  }
+}
+
+TEST_F(JoinOrderEnumeratorTests, GreedyLargeJoinTest) {
+  settings::SettingsManager::SetInt(
+      settings::SettingId::join_enumeration_dp_limit, 3);
+  settings::SettingsManager::SetInt(settings::SettingId::join_exploration_limit,
+                                    2);
+
+  // A chain of joins a - b - c - d, planned as ((a JOIN c) JOIN d) JOIN b
+  OptimizerMetadata metadata;
+  std::shared_ptr<GroupExpression> root_gexpr;
+  metadata.RecordTransformedExpression(
+      MakeJoin(MakeJoin(MakeJoin(MakeGet("a"), MakeGet("c"), {}),
+                        MakeGet("d"), {MakeJoinPredicate("c", "d")}),
+               MakeGet("b"),
+               {MakeJoinPredicate("a", "b"), MakeJoinPredicate("b", "c")}),
+      root_gexpr);
+  auto &memo = metadata.memo;
+  SetTableRows(memo, {{"a", 100}, {"b", 100}, {"c", 100}, {"d", 100}});
+
+  JoinOrderEnumerator enumerator(memo, metadata.rule_set);
+  enumerator.Enumerate(root_gexpr->GetGroupID());
+
+  // The greedy order joins connected tables only, and the join expressions
+  // are not explored further
+  Rule *commutativity = nullptr;
+  for (auto &rule : metadata.rule_set.GetTransformationRules()) {
+    if (rule->GetType() == RuleType::INNER_JOIN_COMMUTE) {
+      commutativity = rule.get();
+    }
+  }
+  ASSERT_NE(nullptr, commutativity);
+  auto logical_exprs =
+      memo.GetGroupByID(root_gexpr->GetGroupID())->GetLogicalExpressions();
+  ASSERT_LE(2, logical_exprs.size());
+  for (auto &gexpr : logical_exprs) {
+    EXPECT_TRUE(gexpr->HasRuleExplored(commutativity));
+  }
+  for (size_t i = 1; i < logical_exprs.size(); i++) {
+    size_t num_tables = 0;
+    for (auto child_group_id : logical_exprs[i]->GetChildGroupIDs()) {
+      num_tables += memo.GetGroupByID(child_group_id)->GetTableAliases().size();
+    }
+    EXPECT_EQ(4, num_tables);
+    EXPECT_FALSE(logical_exprs[i]
+                     ->Op()
+                     .As<LogicalInnerJoin>()
+                     ->join_predicates.empty());
+  }
+
+  settings::SettingsManager::SetInt(
+      settings::SettingId::join_enumeration_dp_limit, 12);
+  settings::SettingsManager::SetInt(settings::SettingId::join_exploration_limit,
+                                    6);
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// memo_test.cpp
+//
+// Identification: test/optimizer/memo_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <thread>
+
+#include "common/harness.h"
+#include "optimizer/memo.h"
+#include "optimizer/operator_expression.h"
+#include "optimizer/operators.h"
+#include "optimizer/optimizer_metadata.h"
+
+namespace peloton {
+namespace test {
+
+using namespace optimizer;
+
+class MemoTests : public PelotonTest {};
+
+TEST_F(MemoTests, ConcurrentInsertTest) {
+  const int num_threads = 8;
+  const int num_tables = 200;
+  OptimizerMetadata metadata;
+
+  // Every thread inserts the joins of the same pairs of tables, in a different
+  // order
+  std::vector<std::vector<GroupID>> join_groups(
+      num_threads, std::vector<GroupID>(num_tables));
+  std::vector<std::thread> threads;
+  for (int thread_id = 0; thread_id < num_threads; thread_id++) {
+    threads.emplace_back([&metadata, &join_groups, thread_id, num_tables] {
+      for (int i = 0; i < num_tables; i++) {
+        int table = (i + thread_id * 17) % num_tables;
+        auto join = std::make_shared<OperatorExpression>(
+            LogicalInnerJoin::make());
+        join->PushChild(std::make_shared<OperatorExpression>(LogicalGet::make(
+            2 * table, {}, nullptr, "l" + std::to_string(table))));
+        join->PushChild(std::make_shared<OperatorExpression>(LogicalGet::make(
+            2 * table + 1, {}, nullptr, "r" + std::to_string(table))));
+        std::shared_ptr<GroupExpression> gexpr;
+        metadata.RecordTransformedExpression(join, gexpr);
+        join_groups[thread_id][table] = gexpr->GetGroupID();
+      }
+    });
+  }
+  for (auto &thread : threads) thread.join();
+
+  // Each expression is in the memo once, and all threads found the same group
+  EXPECT_EQ(3 * num_tables, metadata.memo.Groups().size());
+  for (int table = 0; table < num_tables; table++) {
+    auto group_id = join_groups[0][table];
+    EXPECT_EQ(1, metadata.memo.GetGroupByID(group_id)
+                     ->GetLogicalExpressions()
+                     .size());
+    EXPECT_EQ(2, metadata.memo.GetGroupByID(group_id)->GetTableAliases().size());
+    for (int thread_id = 1; thread_id < num_threads; thread_id++) {
+      EXPECT_EQ(group_id, join_groups[thread_id][table]);
+    }
+  }
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -24,7 +24,9 @@
 #include "expression/tuple_value_expression.h"
 #include "optimizer/mock_task.h"
 #include "optimizer/operators.h"
+#include "optimizer/optimize_context.h"
 #include "optimizer/optimizer.h"
+#include "optimizer/optimizer_task_pool.h"
 #include "optimizer/rule_impls.h"
 #include "parser/mock_sql_statement.h"
 #include "parser/postgresparser.h"
@@ -35,6 +37,7 @@
 #include "planner/insert_plan.h"
 #include "planner/seq_scan_plan.h"
 #include "planner/update_plan.h"
+#include "settings/settings_manager.h"
 #include "sql/testing_sql_util.h"
 #include "traffic_cop/traffic_cop.h"
 
@@ -47,6 +50,19 @@ namespace test {
 
 using namespace optimizer;
 
+// A task pool that only counts the tasks pushed to it
+class CountingTaskPool : public OptimizerTaskPool {
+ public:
+  std::unique_ptr<OptimizerTask> Pop() override { return nullptr; }
+  void Push(OptimizerTask *task) override {
+    delete task;
+    num_pushed++;
+  }
+  bool Empty() override { return true; }
+
+  std::atomic<int> num_pushed{0};
+};
+
 class OptimizerTests : public PelotonTest {
  protected:
   GroupExpression *GetSingleGroupExpression(Memo &memo, GroupExpression *expr,
@@ -510,5 +526,59 @@ TEST_F(OptimizerTests, ExecuteTaskStackTest) {
   ASSERT_GT(timer.GetDuration(), start_time);
 }
 
+TEST_F(OptimizerTests, ForkedTaskPoolTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->CreateDatabase(txn, DEFAULT_DB_NAME);
+  txn_manager.CommitTransaction(txn);
+
+  for (auto table : {"a", "b", "c", "d"}) {
+    TestingSQLUtil::ExecuteSQLQuery(std::string("CREATE TABLE ") + table +
+                                    "(id INT PRIMARY KEY, v INT);");
+  }
+
+  // Child groups are optimized one at a time, or forked, depending on how
+  // many of them have no plan yet. Either way, the tasks of a forked stack
+  // must stay on it rather than go to the stack of the metadata.
+  for (bool parallel : {false, true}) {
+    settings::SettingsManager::SetBool(
+        settings::SettingId::parallel_optimization, parallel);
+
+    auto &peloton_parser = parser::PostgresParser::GetInstance();
+    auto stmt = peloton_parser.BuildParseTree(
+        "SELECT * FROM a, b, c, d WHERE a.id = b.id AND b.v = c.id AND "
+        "c.v = d.id");
+    txn = txn_manager.BeginTransaction();
+    auto bind_node_visitor = binder::BindNodeVisitor(txn, DEFAULT_DB_NAME);
+    bind_node_visitor.BindNameToNode(stmt->GetStatement(0));
+
+    optimizer::Optimizer optimizer;
+    auto &metadata = optimizer.GetMetadata();
+    metadata.txn = txn;
+    auto root_gexpr =
+        optimizer.TestInsertQueryTree(stmt->GetStatement(0), txn);
+    auto root_group = metadata.memo.GetGroupByID(root_gexpr->GetGroupID());
+
+    CountingTaskPool metadata_pool;
+    metadata.SetTaskPool(&metadata_pool);
+    OptimizerTaskStack forked_stack;
+    auto required_prop = std::make_shared<PropertySet>();
+    auto context = std::make_shared<OptimizeContext>(
+        &metadata, required_prop, std::numeric_limits<double>::max(),
+        &forked_stack);
+    forked_stack.Push(new OptimizeGroup(root_group, context));
+    forked_stack.Push(new DeriveStats(root_group->GetLogicalExpression(),
+                                      ExprSet{}, context));
+    while (!forked_stack.Empty()) forked_stack.Pop()->execute();
+    txn_manager.CommitTransaction(txn);
+
+    EXPECT_EQ(0, metadata_pool.num_pushed);
+    EXPECT_NE(nullptr, root_group->GetBestExpression(required_prop));
+  }
+
+  settings::SettingsManager::SetBool(settings::SettingId::parallel_optimization,
+                                     false);
+}
+
 }  // namespace test
 }  // namespace peloton
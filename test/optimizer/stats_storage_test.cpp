@@ -23,6 +23,7 @@
 #include "catalog/column_stats_catalog.h"
 #include "executor/testing_executor_util.h"
 #include "concurrency/transaction_manager_factory.h"
+#include "settings/settings_manager.h"
 
 namespace peloton {
 namespace test {
@@ -252,5 +253,47 @@ TEST_F(StatsStorageTests, GetTableStatsTest) {
   EXPECT_EQ(table_stats->num_rows, tuple_count);
 }
 
+TEST_F(StatsStorageTests, AnalyzeSampleRatioTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(tuple_per_tilegroup / 10, false));
+  TestingExecutorUtil::PopulateTable(data_table.get(), tuple_count, false,
+                                     false, true, txn);
+  txn_manager.CommitTransaction(txn);
+
+  // ANALYZE only scans half of the tile groups, and extrapolates the row
+  // count to the whole table
+  StatsStorage *stats_storage = StatsStorage::GetInstance();
+  settings::SettingsManager::SetDouble(
+      settings::SettingId::analyze_sample_ratio, 0.5);
+  txn = txn_manager.BeginTransaction();
+  EXPECT_EQ(ResultType::SUCCESS,
+            stats_storage->AnalyzeStatsForTable(data_table.get(), txn));
+  txn_manager.CommitTransaction(txn);
+  settings::SettingsManager::SetDouble(
+      settings::SettingId::analyze_sample_ratio, 1.0);
+
+  txn = txn_manager.BeginTransaction();
+  auto table_stats = stats_storage->GetTableStats(
+      data_table->GetDatabaseOid(), data_table->GetOid(), txn);
+  txn_manager.CommitTransaction(txn);
+  EXPECT_EQ(tuple_count, table_stats->num_rows);
+
+  // Then the whole table
+  txn = txn_manager.BeginTransaction();
+  EXPECT_EQ(ResultType::SUCCESS,
+            stats_storage->AnalyzeStatsForTable(data_table.get(), txn));
+  txn_manager.CommitTransaction(txn);
+
+  txn = txn_manager.BeginTransaction();
+  table_stats = stats_storage->GetTableStats(data_table->GetDatabaseOid(),
+                                             data_table->GetOid(), txn);
+  txn_manager.CommitTransaction(txn);
+  EXPECT_EQ(tuple_count, table_stats->num_rows);
+
+  stats_storage->DropTableStatsCollector(data_table->GetOid());
+}
+
 }  // namespace test
 }  // namespace peloton
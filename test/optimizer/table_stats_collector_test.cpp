@@ -149,5 +149,105 @@ TEST_F(TableStatsCollectorTests, MultiColumnTableTest) {
   txn_manager.CommitTransaction(txn);
 }
 
+// Table with many tile groups, scanned in parallel chunks and re-analyzed
+// incrementally.
+TEST_F(TableStatsCollectorTests, IncrementalCollectionTest) {
+  const int tile_group_count = 40;
+  const int nrow = TESTS_TUPLES_PER_TILEGROUP * tile_group_count;
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable());
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  TestingExecutorUtil::PopulateTable(data_table.get(), nrow, false, false,
+                                     false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  TableStatsCollector stats{data_table.get()};
+  stats.CollectColumnStats();
+  size_t table_tile_group_count = data_table->GetTileGroupCount();
+  EXPECT_EQ(stats.GetActiveTupleCount(), nrow);
+  EXPECT_EQ(stats.GetScannedTileGroupCount(), table_tile_group_count);
+  uint64_t cardinality = stats.GetColumnStats(0)->GetCardinality();
+  double cardinality_error = stats.GetColumnStats(0)->GetCardinalityError();
+  EXPECT_GE(cardinality, nrow * (1 - cardinality_error));
+  EXPECT_LE(cardinality, nrow * (1 + cardinality_error));
+
+  // Nothing changed, so nothing should be scanned again
+  stats.CollectColumnStats();
+  EXPECT_EQ(stats.GetActiveTupleCount(), nrow);
+  EXPECT_EQ(stats.GetScannedTileGroupCount(), 0);
+  EXPECT_EQ(stats.GetColumnStats(0)->GetCardinality(), cardinality);
+
+  // Appending tuples only rescans the chunks of the new tile groups
+  txn = txn_manager.BeginTransaction();
+  TestingExecutorUtil::PopulateTable(data_table.get(),
+                                     TESTS_TUPLES_PER_TILEGROUP, false, false,
+                                     false, txn);
+  txn_manager.CommitTransaction(txn);
+  stats.CollectColumnStats();
+  EXPECT_EQ(stats.GetActiveTupleCount(), nrow + TESTS_TUPLES_PER_TILEGROUP);
+  EXPECT_GT(stats.GetScannedTileGroupCount(), 0);
+  EXPECT_LE(stats.GetScannedTileGroupCount(),
+            2 * TableStatsCollector::kTileGroupsPerChunk);
+}
+
+// A table with more tile groups than the kept chunks can cover keeps the
+// stats of fewer, wider chunks, merged from the narrower ones.
+TEST_F(TableStatsCollectorTests, ChunkMergeTest) {
+  const int tile_group_count = TableStatsCollector::kMaxChunks *
+                               TableStatsCollector::kTileGroupsPerChunk;
+  const int nrow = TESTS_TUPLES_PER_TILEGROUP * tile_group_count;
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable());
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  TestingExecutorUtil::PopulateTable(data_table.get(), nrow, false, false,
+                                     false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  TableStatsCollector stats{data_table.get()};
+  stats.CollectColumnStats();
+  uint64_t cardinality = stats.GetColumnStats(0)->GetCardinality();
+
+  // Growing past the cap merges the kept chunks, and only the new tile groups
+  // are scanned
+  const int nrow_added = TESTS_TUPLES_PER_TILEGROUP * 2;
+  txn = txn_manager.BeginTransaction();
+  TestingExecutorUtil::PopulateTable(data_table.get(), nrow_added, false,
+                                     false, false, txn);
+  txn_manager.CommitTransaction(txn);
+  stats.CollectColumnStats();
+  EXPECT_LE(stats.GetChunkCount(), TableStatsCollector::kMaxChunks);
+  EXPECT_EQ(stats.GetActiveTupleCount(), nrow + nrow_added);
+  EXPECT_GT(stats.GetScannedTileGroupCount(), 0);
+  EXPECT_LE(stats.GetScannedTileGroupCount(),
+            2 * TableStatsCollector::kTileGroupsPerChunk);
+  // The added tuples repeat the values of the first ones
+  EXPECT_EQ(stats.GetColumnStats(0)->GetCardinality(), cardinality);
+}
+
+// Only a sample of the tile groups is scanned, but the tuple count covers the
+// whole table.
+TEST_F(TableStatsCollectorTests, SampledCollectionTest) {
+  const int tile_group_count = 40;
+  const int nrow = TESTS_TUPLES_PER_TILEGROUP * tile_group_count;
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable());
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  TestingExecutorUtil::PopulateTable(data_table.get(), nrow, false, false,
+                                     false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  TableStatsCollector stats{data_table.get()};
+  stats.SetSampleRatio(0.25);
+  stats.CollectColumnStats();
+  EXPECT_EQ(stats.GetActiveTupleCount(), nrow);
+  EXPECT_GT(stats.GetScannedTileGroupCount(), 0);
+  EXPECT_LE(stats.GetScannedTileGroupCount(),
+            (data_table->GetTileGroupCount() + 3) / 4);
+  EXPECT_EQ(stats.GetColumnStats(0)->GetFracNull(), 0);
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -0,0 +1,117 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// connection_storm_performance_test.cpp
+//
+// Identification: test/performance/connection_storm_performance_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <pqxx/pqxx> /* libpqxx is used to instantiate C++ client */
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "common/harness.h"
+#include "common/init.h"
+#include "common/logger.h"
+#include "common/timer.h"
+#include "network/peloton_server.h"
+#include "settings/settings_manager.h"
+#include "util/string_util.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Connection Storm Performance Tests
+//===--------------------------------------------------------------------===//
+
+class ConnectionStormPerformanceTests : public PelotonTest {};
+
+namespace {
+
+const int kNumClients = 8;
+const int kConnectionsPerClient = 100;
+
+/**
+ * Open and close connections from many clients at once, like a connection
+ * pool restarting, and return the number of connections set up per second.
+ */
+double ConnectionStorm(int port) {
+  std::atomic<int> failures(0);
+  Timer<std::ratio<1, 1>> timer;
+  timer.Start();
+  std::vector<std::thread> clients;
+  for (int i = 0; i < kNumClients; i++) {
+    clients.emplace_back([port, &failures] {
+      for (int j = 0; j < kConnectionsPerClient; j++) {
+        try {
+          pqxx::connection C(StringUtil::Format(
+              "host=127.0.0.1 port=%d user=default_database sslmode=disable "
+              "application_name=psql",
+              port));
+        } catch (const std::exception &e) {
+          LOG_INFO("[ConnectionStorm] Exception occurred: %s", e.what());
+          failures++;
+        }
+      }
+    });
+  }
+  for (auto &client : clients) client.join();
+  timer.Stop();
+
+  EXPECT_EQ(0, failures.load());
+  return kNumClients * kConnectionsPerClient / timer.GetDuration();
+}
+
+double RunConnectionStorm(bool reuse_port, bool rebalance_connections) {
+  settings::SettingsManager::SetBool(settings::SettingId::reuse_port,
+                                     reuse_port);
+  settings::SettingsManager::SetBool(
+      settings::SettingId::rebalance_connections, rebalance_connections);
+
+  PelotonInit::Initialize();
+  network::PelotonServer server;
+  int port = 15721;
+  try {
+    server.SetPort(port);
+    server.SetupServer();
+  } catch (ConnectionException &exception) {
+    LOG_INFO("[LaunchServer] exception when launching server");
+  }
+  std::thread serverThread([&]() { server.ServerLoop(); });
+
+  double connections_per_second = ConnectionStorm(port);
+
+  server.Close();
+  serverThread.join();
+  PelotonInit::Shutdown();
+
+  settings::SettingsManager::SetBool(settings::SettingId::reuse_port, false);
+  settings::SettingsManager::SetBool(
+      settings::SettingId::rebalance_connections, false);
+  return connections_per_second;
+}
+
+}  // namespace
+
+TEST_F(ConnectionStormPerformanceTests, DispatcherTest) {
+  LOG_INFO("Dispatcher: %.0f connections/s", RunConnectionStorm(false, false));
+}
+
+TEST_F(ConnectionStormPerformanceTests, ReusePortTest) {
+  LOG_INFO("SO_REUSEPORT: %.0f connections/s",
+           RunConnectionStorm(true, false));
+}
+
+TEST_F(ConnectionStormPerformanceTests, ReusePortRebalanceTest) {
+  LOG_INFO("SO_REUSEPORT with rebalancing: %.0f connections/s",
+           RunConnectionStorm(true, true));
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,130 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// io_uring_performance_test.cpp
+//
+// Identification: test/performance/io_uring_performance_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <pqxx/pqxx> /* libpqxx is used to instantiate C++ client */
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "common/harness.h"
+#include "common/init.h"
+#include "common/logger.h"
+#include "common/timer.h"
+#include "network/peloton_server.h"
+#include "settings/settings_manager.h"
+#include "util/string_util.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// io_uring Performance Tests
+//===--------------------------------------------------------------------===//
+
+class IoUringPerformanceTests : public PelotonTest {};
+
+namespace {
+
+const int kNumClients = 16;
+const int kQueriesPerClient = 2000;
+const int kNumAccounts = 1000;
+
+std::string ConnectionString(int port) {
+  return StringUtil::Format(
+      "host=127.0.0.1 port=%d user=default_database sslmode=disable "
+      "application_name=psql",
+      port);
+}
+
+/**
+ * Run pgbench-style point selects from many clients at once, so that the
+ * handler threads have many small requests and responses per round of their
+ * event loops, and return the number of queries answered per second.
+ */
+double PointSelects(int port) {
+  {
+    pqxx::connection C(ConnectionString(port));
+    pqxx::work txn(C);
+    txn.exec("DROP TABLE IF EXISTS accounts;");
+    txn.exec("CREATE TABLE accounts(aid INT PRIMARY KEY, abalance INT);");
+    for (int i = 0; i < kNumAccounts; i++) {
+      txn.exec(StringUtil::Format("INSERT INTO accounts VALUES (%d, %d);", i,
+                                  i * 10));
+    }
+    txn.commit();
+  }
+
+  std::atomic<int> failures(0);
+  Timer<std::ratio<1, 1>> timer;
+  timer.Start();
+  std::vector<std::thread> clients;
+  for (int i = 0; i < kNumClients; i++) {
+    clients.emplace_back([port, i, &failures] {
+      try {
+        pqxx::connection C(ConnectionString(port));
+        for (int j = 0; j < kQueriesPerClient; j++) {
+          pqxx::work txn(C);
+          int aid = (i * kQueriesPerClient + j) % kNumAccounts;
+          txn.exec(StringUtil::Format(
+              "SELECT abalance FROM accounts WHERE aid = %d;", aid));
+          txn.commit();
+        }
+      } catch (const std::exception &e) {
+        LOG_INFO("[PointSelects] Exception occurred: %s", e.what());
+        failures++;
+      }
+    });
+  }
+  for (auto &client : clients) client.join();
+  timer.Stop();
+
+  EXPECT_EQ(0, failures.load());
+  return kNumClients * kQueriesPerClient / timer.GetDuration();
+}
+
+double RunPointSelects(bool io_uring) {
+  // The handler threads decide on io_uring as they are created
+  settings::SettingsManager::SetBool(settings::SettingId::io_uring, io_uring);
+
+  PelotonInit::Initialize();
+  network::PelotonServer server;
+  int port = 15721;
+  try {
+    server.SetPort(port);
+    server.SetupServer();
+  } catch (ConnectionException &exception) {
+    LOG_INFO("[LaunchServer] exception when launching server");
+  }
+  std::thread serverThread([&]() { server.ServerLoop(); });
+
+  double queries_per_second = PointSelects(port);
+
+  server.Close();
+  serverThread.join();
+  PelotonInit::Shutdown();
+
+  settings::SettingsManager::SetBool(settings::SettingId::io_uring, false);
+  return queries_per_second;
+}
+
+}  // namespace
+
+TEST_F(IoUringPerformanceTests, SocketTest) {
+  LOG_INFO("Sockets: %.0f queries/s", RunPointSelects(false));
+}
+
+TEST_F(IoUringPerformanceTests, IoUringTest) {
+  LOG_INFO("io_uring: %.0f queries/s", RunPointSelects(true));
+}
+
+}  // namespace test
+}  // namespace peloton
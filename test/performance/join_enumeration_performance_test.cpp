@@ -0,0 +1,105 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// join_enumeration_performance_test.cpp
+//
+// Identification: test/performance/join_enumeration_performance_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+
+#include "catalog/catalog.h"
+#include "common/harness.h"
+#include "common/logger.h"
+#include "common/timer.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "optimizer/optimizer.h"
+#include "settings/settings_manager.h"
+#include "sql/testing_sql_util.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Join Enumeration Performance Tests
+//===--------------------------------------------------------------------===//
+
+class JoinEnumerationPerformanceTests : public PelotonTest {
+ protected:
+  virtual void SetUp() override {
+    PelotonTest::SetUp();
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    catalog::Catalog::GetInstance()->CreateDatabase(txn, DEFAULT_DB_NAME);
+    txn_manager.CommitTransaction(txn);
+
+    for (int i = 0; i < kMaxTables; i++) {
+      TestingSQLUtil::ExecuteSQLQuery(
+          "CREATE TABLE t" + std::to_string(i) + "(a INT, b INT);");
+    }
+  }
+
+  virtual void TearDown() override {
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    catalog::Catalog::GetInstance()->DropDatabaseWithName(txn, DEFAULT_DB_NAME);
+    txn_manager.CommitTransaction(txn);
+    PelotonTest::TearDown();
+  }
+
+  /**
+   * Plan a chain join of the first num_tables tables, listed in an order that
+   * makes the initial join tree start with cross products, and return the
+   * time spent in the optimizer in milliseconds
+   */
+  double OptimizeChainJoin(int num_tables) {
+    std::string from, where;
+    for (int i = 0; i < num_tables; i++) {
+      // Even tables first, then odd ones
+      int table = i < (num_tables + 1) / 2 ? 2 * i
+                                           : 2 * (i - (num_tables + 1) / 2) + 1;
+      from += (i == 0 ? "" : ", ") + std::string("t") + std::to_string(table);
+      if (i > 0) {
+        where += (i == 1 ? "" : " AND ") + std::string("t") +
+                 std::to_string(i - 1) + ".b = t" + std::to_string(i) + ".a";
+      }
+    }
+    std::string query = "SELECT * FROM " + from + " WHERE " + where + ";";
+
+    std::unique_ptr<optimizer::AbstractOptimizer> optimizer(
+        new optimizer::Optimizer());
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    Timer<std::milli> timer;
+    timer.Start();
+    auto plan =
+        TestingSQLUtil::GeneratePlanWithOptimizer(optimizer, query, txn);
+    timer.Stop();
+    txn_manager.CommitTransaction(txn);
+    EXPECT_NE(nullptr, plan);
+    return timer.GetDuration();
+  }
+
+  static const int kMaxTables = 12;
+};
+
+TEST_F(JoinEnumerationPerformanceTests, OptimizationTimeTest) {
+  for (int num_tables = 2; num_tables <= kMaxTables; num_tables++) {
+    settings::SettingsManager::SetBool(
+        settings::SettingId::join_order_enumeration, false);
+    double rules_ms = OptimizeChainJoin(num_tables);
+    settings::SettingsManager::SetBool(
+        settings::SettingId::join_order_enumeration, true);
+    double enumeration_ms = OptimizeChainJoin(num_tables);
+    LOG_INFO("%2d tables: %8.2f ms with rules only, %8.2f ms with enumeration",
+             num_tables, rules_ms, enumeration_ms);
+  }
+}
+
+}  // namespace test
+}  // namespace peloton
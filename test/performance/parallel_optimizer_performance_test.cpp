@@ -0,0 +1,143 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// parallel_optimizer_performance_test.cpp
+//
+// Identification: test/performance/parallel_optimizer_performance_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "common/harness.h"
+#include "common/logger.h"
+#include "common/timer.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "optimizer/optimizer.h"
+#include "planner/abstract_plan.h"
+#include "settings/settings_manager.h"
+#include "sql/testing_sql_util.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Parallel Optimizer Performance Tests
+//===--------------------------------------------------------------------===//
+
+class ParallelOptimizerPerformanceTests : public PelotonTest {
+ protected:
+  virtual void SetUp() override {
+    PelotonTest::SetUp();
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    catalog::Catalog::GetInstance()->CreateDatabase(txn, DEFAULT_DB_NAME);
+    txn_manager.CommitTransaction(txn);
+
+    // The join columns of the TPC-H schema
+    TestingSQLUtil::ExecuteSQLQuery(
+        "CREATE TABLE region(r_regionkey INT PRIMARY KEY, r_name INT);");
+    TestingSQLUtil::ExecuteSQLQuery(
+        "CREATE TABLE nation(n_nationkey INT PRIMARY KEY, n_regionkey INT, "
+        "n_name INT);");
+    TestingSQLUtil::ExecuteSQLQuery(
+        "CREATE TABLE supplier(s_suppkey INT PRIMARY KEY, s_nationkey INT, "
+        "s_acctbal INT);");
+    TestingSQLUtil::ExecuteSQLQuery(
+        "CREATE TABLE customer(c_custkey INT PRIMARY KEY, c_nationkey INT, "
+        "c_mktsegment INT);");
+    TestingSQLUtil::ExecuteSQLQuery(
+        "CREATE TABLE part(p_partkey INT PRIMARY KEY, p_type INT, p_size "
+        "INT);");
+    TestingSQLUtil::ExecuteSQLQuery(
+        "CREATE TABLE partsupp(ps_partkey INT, ps_suppkey INT, ps_supplycost "
+        "INT);");
+    TestingSQLUtil::ExecuteSQLQuery(
+        "CREATE TABLE orders(o_orderkey INT PRIMARY KEY, o_custkey INT, "
+        "o_orderdate INT);");
+    TestingSQLUtil::ExecuteSQLQuery(
+        "CREATE TABLE lineitem(l_orderkey INT, l_partkey INT, l_suppkey INT, "
+        "l_extendedprice INT);");
+  }
+
+  virtual void TearDown() override {
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    catalog::Catalog::GetInstance()->DropDatabaseWithName(txn, DEFAULT_DB_NAME);
+    txn_manager.CommitTransaction(txn);
+    PelotonTest::TearDown();
+  }
+
+  /**
+   * Plan the query and return the time spent in the optimizer in
+   * milliseconds, and the plan it chose
+   */
+  double Optimize(const std::string &query, std::string &plan_info) {
+    std::unique_ptr<optimizer::AbstractOptimizer> optimizer(
+        new optimizer::Optimizer());
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    Timer<std::milli> timer;
+    timer.Start();
+    auto plan =
+        TestingSQLUtil::GeneratePlanWithOptimizer(optimizer, query, txn);
+    timer.Stop();
+    txn_manager.CommitTransaction(txn);
+    EXPECT_NE(nullptr, plan);
+    plan_info = plan == nullptr ? "" : plan->GetInfo();
+    return timer.GetDuration();
+  }
+};
+
+TEST_F(ParallelOptimizerPerformanceTests, TPCHJoinTest) {
+  // The join graphs of TPC-H Q3, Q5, Q8 and Q9
+  std::vector<std::pair<std::string, std::string>> queries = {
+      {"Q3",
+       "SELECT l_orderkey, o_orderdate FROM customer, orders, lineitem "
+       "WHERE c_mktsegment = 1 AND c_custkey = o_custkey AND "
+       "l_orderkey = o_orderkey AND o_orderdate < 100;"},
+      {"Q5",
+       "SELECT n_name, l_extendedprice FROM customer, orders, lineitem, "
+       "supplier, nation, region WHERE c_custkey = o_custkey AND "
+       "l_orderkey = o_orderkey AND l_suppkey = s_suppkey AND "
+       "c_nationkey = s_nationkey AND s_nationkey = n_nationkey AND "
+       "n_regionkey = r_regionkey AND r_name = 1;"},
+      {"Q8",
+       "SELECT o_orderdate, l_extendedprice FROM part, supplier, lineitem, "
+       "orders, customer, nation, region WHERE p_partkey = l_partkey AND "
+       "s_suppkey = l_suppkey AND l_orderkey = o_orderkey AND "
+       "o_custkey = c_custkey AND c_nationkey = n_nationkey AND "
+       "n_regionkey = r_regionkey AND r_name = 1 AND p_type = 1;"},
+      {"Q9",
+       "SELECT n_name, o_orderdate, l_extendedprice FROM part, supplier, "
+       "lineitem, partsupp, orders, nation WHERE s_suppkey = l_suppkey AND "
+       "ps_suppkey = l_suppkey AND ps_partkey = l_partkey AND "
+       "p_partkey = l_partkey AND o_orderkey = l_orderkey AND "
+       "s_nationkey = n_nationkey AND p_size = 1;"}};
+
+  for (auto &query : queries) {
+    std::string serial_plan, parallel_plan;
+    settings::SettingsManager::SetBool(
+        settings::SettingId::parallel_optimization, false);
+    double serial_ms = Optimize(query.second, serial_plan);
+    settings::SettingsManager::SetBool(
+        settings::SettingId::parallel_optimization, true);
+    double parallel_ms = Optimize(query.second, parallel_plan);
+
+    // Optimizing in parallel must not change the plan
+    EXPECT_EQ(serial_plan, parallel_plan);
+    LOG_INFO("%s: %8.2f ms serial, %8.2f ms parallel", query.first.c_str(),
+             serial_ms, parallel_ms);
+  }
+  settings::SettingsManager::SetBool(settings::SettingId::parallel_optimization,
+                                     false);
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,127 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tuple_header_performance_test.cpp
+//
+// Identification: test/performance/tuple_header_performance_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "common/harness.h"
+#include "common/logger.h"
+#include "common/timer.h"
+#include "storage/tile_group_header.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Tuple Header Performance Tests
+//===--------------------------------------------------------------------===//
+
+// Compares the ROW and COLUMN layouts of the tuple headers on the part of
+// scans and updates that touches them
+
+static const int kTuplesPerTileGroup = 1000;
+static const int kNumTileGroups = 1000;
+
+class TupleHeaderPerformanceTests : public PelotonTest {
+ public:
+  // Tile group headers full of committed versions, in the given layout
+  static std::vector<std::unique_ptr<storage::TileGroupHeader>> BuildHeaders(
+      LayoutType layout_type) {
+    std::vector<std::unique_ptr<storage::TileGroupHeader>> headers;
+    for (int i = 0; i < kNumTileGroups; i++) {
+      headers.emplace_back(new storage::TileGroupHeader(
+          BackendType::MM, kTuplesPerTileGroup, layout_type));
+      auto &header = *headers.back();
+      for (oid_t tuple_slot_id = 0; tuple_slot_id < kTuplesPerTileGroup;
+           tuple_slot_id++) {
+        header.GetNextEmptyTupleSlot();
+        header.SetTransactionId(tuple_slot_id, INITIAL_TXN_ID);
+        header.SetBeginCommitId(tuple_slot_id, tuple_slot_id % 100);
+      }
+    }
+    return headers;
+  }
+
+  // Check the visibility of every version, like a sequential scan does
+  static double Scan(
+      const std::vector<std::unique_ptr<storage::TileGroupHeader>> &headers,
+      cid_t read_id, uint64_t &num_visible) {
+    Timer<std::milli> timer;
+    timer.Start();
+    for (const auto &header : headers) {
+      for (oid_t tuple_slot_id = 0; tuple_slot_id < kTuplesPerTileGroup;
+           tuple_slot_id++) {
+        bool visible = header->GetTransactionId(tuple_slot_id) ==
+                           INITIAL_TXN_ID &&
+                       header->GetBeginCommitId(tuple_slot_id) <= read_id &&
+                       header->GetEndCommitId(tuple_slot_id) > read_id;
+        num_visible += visible;
+      }
+    }
+    timer.Stop();
+    return timer.GetDuration();
+  }
+
+  // Update random versions, like an update transaction does: take ownership
+  // of the old version, link it to the new one, and commit, which ends the
+  // old version
+  static double Update(
+      const std::vector<std::unique_ptr<storage::TileGroupHeader>> &headers,
+      uint32_t num_updates) {
+    std::mt19937 rng(15721);
+    std::uniform_int_distribution<int> tile_group_dist(0, kNumTileGroups - 1);
+    std::uniform_int_distribution<oid_t> slot_dist(0, kTuplesPerTileGroup - 1);
+
+    Timer<std::milli> timer;
+    timer.Start();
+    for (uint32_t i = 0; i < num_updates; i++) {
+      auto &header = *headers[tile_group_dist(rng)];
+      oid_t tuple_slot_id = slot_dist(rng);
+      txn_id_t txn_id = 1000 + i;
+      if (!header.SetAtomicTransactionId(tuple_slot_id, txn_id)) continue;
+      header.SetLastReaderCommitId(tuple_slot_id, i);
+      header.SetNextItemPointer(tuple_slot_id, ItemPointer(i, tuple_slot_id));
+      header.SetEndCommitId(tuple_slot_id, 100 + i);
+      header.SetTransactionId(tuple_slot_id, INITIAL_TXN_ID);
+    }
+    timer.Stop();
+    return timer.GetDuration();
+  }
+};
+
+TEST_F(TupleHeaderPerformanceTests, ScanTest) {
+  for (auto layout_type : {LayoutType::ROW, LayoutType::COLUMN}) {
+    auto headers = BuildHeaders(layout_type);
+    uint64_t num_visible = 0;
+    double duration = 0;
+    for (cid_t read_id = 0; read_id < 100; read_id += 10) {
+      duration += Scan(headers, read_id, num_visible);
+    }
+    LOG_INFO("%s tuple headers, scan: %.2lf ms",
+             LayoutTypeToString(layout_type).c_str(), duration);
+    EXPECT_LT(0, num_visible);
+  }
+}
+
+TEST_F(TupleHeaderPerformanceTests, UpdateTest) {
+  for (auto layout_type : {LayoutType::ROW, LayoutType::COLUMN}) {
+    auto headers = BuildHeaders(layout_type);
+    double duration = Update(headers, 1000 * 1000);
+    LOG_INFO("%s tuple headers, update: %.2lf ms",
+             LayoutTypeToString(layout_type).c_str(), duration);
+    EXPECT_EQ(INITIAL_TXN_ID, headers[0]->GetTransactionId(0));
+  }
+}
+
+}  // namespace test
+}  // namespace peloton
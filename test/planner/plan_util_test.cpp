@@ -19,7 +19,10 @@
 #include "common/statement.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "executor/testing_executor_util.h"
+#include "optimizer/optimizer.h"
 #include "parser/postgresparser.h"
+#include "settings/settings_manager.h"
+#include "sql/testing_sql_util.h"
 #include "storage/data_table.h"
 
 #include "planner/plan_util.h"
@@ -410,5 +413,55 @@ TEST_F(PlanUtilTests, GetIndexableColumnsTest) {
   txn_manager.CommitTransaction(txn);
 }
 
+TEST_F(PlanUtilTests, IsShortQueryTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->CreateDatabase(txn, DEFAULT_DB_NAME);
+  txn_manager.CommitTransaction(txn);
+
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE test(a INT PRIMARY KEY, b INT, c INT);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (1, 11, 111);");
+
+  std::unique_ptr<optimizer::AbstractOptimizer> optimizer(
+      new optimizer::Optimizer());
+  std::vector<std::pair<std::string, bool>> queries = {
+      {"SELECT * FROM test WHERE a = 1;", true},
+      {"SELECT b FROM test WHERE a = 1;", true},
+      {"SELECT * FROM test WHERE a > 1;", false},
+      {"SELECT * FROM test WHERE b = 1;", false},
+      {"SELECT * FROM test;", false},
+      {"INSERT INTO test VALUES (2, 22, 222);", true},
+      {"INSERT INTO test VALUES (2, 22, 222), (3, 33, 333);", false},
+      {"UPDATE test SET b = 0 WHERE a = 1;", true},
+      {"UPDATE test SET b = 0;", false},
+      {"DELETE FROM test WHERE a = 1;", true},
+      {"DELETE FROM test WHERE b = 1;", false}};
+
+  for (auto &query : queries) {
+    txn = txn_manager.BeginTransaction();
+    auto plan = TestingSQLUtil::GeneratePlanWithOptimizer(optimizer,
+                                                          query.first, txn);
+    txn_manager.CommitTransaction(txn);
+    EXPECT_EQ(query.second, planner::PlanUtil::IsShortQuery(plan.get()))
+        << query.first;
+  }
+
+  // Short queries executed on the calling thread return the same results
+  settings::SettingsManager::SetBool(
+      settings::SettingId::inline_short_queries, true);
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT * FROM test WHERE a = 1;", {"1|11|111"}, false);
+  TestingSQLUtil::ExecuteSQLQuery("UPDATE test SET b = 0 WHERE a = 1;");
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT b FROM test WHERE a = 1;", {"0"}, false);
+  settings::SettingsManager::SetBool(
+      settings::SettingId::inline_short_queries, false);
+
+  txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(txn, DEFAULT_DB_NAME);
+  txn_manager.CommitTransaction(txn);
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -18,7 +18,10 @@
 #include "executor/create_executor.h"
 #include "optimizer/optimizer.h"
 #include "planner/create_plan.h"
+#include "planner/index_scan_plan.h"
 #include "planner/order_by_plan.h"
+#include "planner/seq_scan_plan.h"
+#include "settings/settings_manager.h"
 #include "sql/testing_sql_util.h"
 
 using std::shared_ptr;
@@ -870,5 +873,121 @@ TEST_F(OptimizerSQLTests, NestedQueryInHavingTest) {
       {"7", "11", "8", "22"}, false);
 }
 
+TEST_F(OptimizerSQLTests, HashJoinBuildSideTest) {
+  // A small and a big table
+  TestingSQLUtil::ExecuteSQLQuery("CREATE TABLE small(a INT, b INT);");
+  TestingSQLUtil::ExecuteSQLQuery("CREATE TABLE big(a INT, b INT);");
+  for (int i = 0; i < 200; i++) {
+    std::string values =
+        " VALUES (" + std::to_string(i) + ", " + std::to_string(i) + ");";
+    if (i < 10) {
+      TestingSQLUtil::ExecuteSQLQuery("INSERT INTO small" + values);
+    }
+    TestingSQLUtil::ExecuteSQLQuery("INSERT INTO big" + values);
+  }
+  TestingSQLUtil::ExecuteSQLQuery("ANALYZE small");
+  TestingSQLUtil::ExecuteSQLQuery("ANALYZE big");
+
+  // The table scanned by the input of the hash join the hash table is built
+  // on: the left input of compiled joins, the right input of interpreted ones
+  auto get_build_table = [this](const std::string &query, bool codegen) {
+    settings::SettingsManager::SetBool(settings::SettingId::codegen, codegen);
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    auto plan =
+        TestingSQLUtil::GeneratePlanWithOptimizer(optimizer, query, txn);
+    txn_manager.CommitTransaction(txn);
+
+    const planner::AbstractPlan *plan_ptr = plan.get();
+    while (plan_ptr->GetPlanNodeType() != PlanNodeType::HASHJOIN) {
+      EXPECT_EQ(1, plan_ptr->GetChildren().size());
+      plan_ptr = plan_ptr->GetChild(0);
+    }
+    const planner::AbstractPlan *build_plan =
+        codegen ? plan_ptr->GetChild(0) : plan_ptr->GetChild(1)->GetChild(0);
+    EXPECT_EQ(PlanNodeType::SEQSCAN, build_plan->GetPlanNodeType());
+    return static_cast<const planner::SeqScanPlan *>(build_plan)
+        ->GetTable()
+        ->GetName();
+  };
+
+  // Whatever the order of the tables in the query, the hash table is built on
+  // the small one
+  bool codegen =
+      settings::SettingsManager::GetBool(settings::SettingId::codegen);
+  for (bool use_codegen : {true, false}) {
+    EXPECT_EQ("small", get_build_table("SELECT * FROM big, small WHERE "
+                                       "big.a = small.a",
+                                       use_codegen));
+    EXPECT_EQ("small", get_build_table("SELECT * FROM small, big WHERE "
+                                       "small.a = big.a",
+                                       use_codegen));
+  }
+  settings::SettingsManager::SetBool(settings::SettingId::codegen, codegen);
+
+  // The join produces the right rows
+  TestUtil("SELECT small.b FROM big, small WHERE big.a = small.a",
+           {"0", "1", "2", "3", "4", "5", "6", "7", "8", "9"}, false);
+}
+
+TEST_F(OptimizerSQLTests, LimitIndexScanTest) {
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE scores(a INT PRIMARY KEY, b INT);");
+  for (int i = 1; i <= 20; i++) {
+    TestingSQLUtil::ExecuteSQLQuery("INSERT INTO scores VALUES (" +
+                                    std::to_string(i) + ", " +
+                                    std::to_string(i % 3) + ");");
+  }
+
+  // The index scan of the plan of the query
+  auto get_index_scan = [this](const std::string &query) {
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    auto plan =
+        TestingSQLUtil::GeneratePlanWithOptimizer(optimizer, query, txn);
+    txn_manager.CommitTransaction(txn);
+
+    const planner::AbstractPlan *plan_ptr = plan.get();
+    while (plan_ptr->GetPlanNodeType() != PlanNodeType::INDEXSCAN &&
+           plan_ptr->GetChildren().size() == 1) {
+      plan_ptr = plan_ptr->GetChild(0);
+    }
+    EXPECT_EQ(PlanNodeType::INDEXSCAN, plan_ptr->GetPlanNodeType());
+    auto index_scan = static_cast<const planner::IndexScanPlan *>(plan_ptr);
+    return std::make_tuple(index_scan->GetLimit(),
+                           index_scan->GetLimitNumber(),
+                           index_scan->GetLimitOffset(),
+                           index_scan->GetDescend());
+  };
+
+  // The scan walks the index backward and produces the tuples that the
+  // offset skips as well
+  std::string query =
+      "SELECT a FROM scores WHERE a > 5 ORDER BY a DESC LIMIT 3 OFFSET 2";
+  EXPECT_EQ(std::make_tuple(true, 3, 2, true), get_index_scan(query));
+  TestUtil(query, {"18", "17", "16"}, true);
+
+  // The open bound is where the backward scan starts
+  query = "SELECT a FROM scores WHERE a < 15 ORDER BY a DESC LIMIT 3 OFFSET 1";
+  EXPECT_EQ(std::make_tuple(true, 3, 1, true), get_index_scan(query));
+  TestUtil(query, {"13", "12", "11"}, true);
+
+  query = "SELECT a FROM scores WHERE a > 5 ORDER BY a LIMIT 2 OFFSET 1";
+  EXPECT_EQ(std::make_tuple(true, 2, 1, false), get_index_scan(query));
+  TestUtil(query, {"7", "8"}, true);
+
+  // Tuples that fail the rest of the predicate do not count towards the limit
+  query =
+      "SELECT a FROM scores WHERE a > 2 AND b = 0 ORDER BY a DESC LIMIT 2 "
+      "OFFSET 1";
+  EXPECT_EQ(std::make_tuple(true, 2, 1, true), get_index_scan(query));
+  TestUtil(query, {"15", "12"}, true);
+
+  // The index does not produce the order of other columns
+  query = "SELECT a FROM scores WHERE a > 5 ORDER BY b, a LIMIT 2";
+  EXPECT_FALSE(std::get<0>(get_index_scan(query)));
+  TestUtil(query, {"6", "9"}, true);
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -202,6 +202,31 @@ TEST_F(TypeSQLTests, VarcharTest) {
   TestingSQLUtil::ExecuteSQLQuery(query.c_str(), result, tuple_descriptor,
                                   rows_changed, error_message);
   CheckQueryResult(result, expected, tuple_descriptor.size());
+
+  // Patterns that are matched without the general matcher
+  query = "SELECT * FROM foo WHERE name LIKE 'Ali%'";
+  expected = {"Alice", "Alicia"};
+  TestingSQLUtil::ExecuteSQLQuery(query.c_str(), result, tuple_descriptor,
+                                  rows_changed, error_message);
+  CheckQueryResult(result, expected, tuple_descriptor.size());
+
+  query = "SELECT * FROM foo WHERE name LIKE '%cia'";
+  expected = {"Alicia"};
+  TestingSQLUtil::ExecuteSQLQuery(query.c_str(), result, tuple_descriptor,
+                                  rows_changed, error_message);
+  CheckQueryResult(result, expected, tuple_descriptor.size());
+
+  query = "SELECT * FROM foo WHERE name LIKE 'bob'";
+  expected = {"Bob"};
+  TestingSQLUtil::ExecuteSQLQuery(query.c_str(), result, tuple_descriptor,
+                                  rows_changed, error_message);
+  CheckQueryResult(result, expected, tuple_descriptor.size());
+
+  query = "SELECT * FROM foo WHERE name LIKE '%'";
+  expected = {"Alice", "Peter", "Cathy", "Bob", "Alicia", "David"};
+  TestingSQLUtil::ExecuteSQLQuery(query.c_str(), result, tuple_descriptor,
+                                  rows_changed, error_message);
+  CheckQueryResult(result, expected, tuple_descriptor.size());
 }
 
 }  // namespace test
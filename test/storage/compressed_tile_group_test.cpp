@@ -0,0 +1,181 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// compressed_tile_group_test.cpp
+//
+// Identification: test/storage/compressed_tile_group_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+
+#include "storage/compressed_tile_group.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Compressed Tile Group Tests
+//===--------------------------------------------------------------------===//
+
+class CompressedTileGroupTests : public PelotonTest {};
+
+namespace {
+
+// Filter all TIDs of the column, returning the qualifying ones
+std::vector<uint32_t> FilterAll(const storage::CompressedColumn &column,
+                                ExpressionType cmp_type,
+                                const type::Value &constant) {
+  std::vector<uint32_t> sel(column.GetTupleCount());
+  for (uint32_t i = 0; i < sel.size(); i++) sel[i] = i;
+  uint32_t num_out = 0;
+  EXPECT_TRUE(column.Filter(cmp_type, constant, sel.data(), sel.size(),
+                            num_out));
+  sel.resize(num_out);
+  return sel;
+}
+
+}  // namespace
+
+TEST_F(CompressedTileGroupTests, FrameOfReferenceTest) {
+  // Values 1000 .. 1099 with every 10th value NULL
+  std::vector<type::Value> values;
+  for (int32_t i = 0; i < 100; i++) {
+    values.push_back(i % 10 == 0 ? type::ValueFactory::GetNullValueByType(
+                                       type::TypeId::INTEGER)
+                                 : type::ValueFactory::GetIntegerValue(1000 + i));
+  }
+  auto column =
+      storage::CompressedColumn::Encode(type::TypeId::INTEGER, values);
+  ASSERT_NE(nullptr, column);
+  EXPECT_EQ(CompressionType::FRAME_OF_REFERENCE, column->GetCompressionType());
+  // 100 distinct codes (plus NULL) fit into 7 bits
+  EXPECT_LT(column->GetCompressedSize(), 100 * sizeof(int32_t));
+
+  for (oid_t i = 0; i < values.size(); i++) {
+    auto decoded = column->GetValue(i);
+    EXPECT_EQ(values[i].IsNull(), decoded.IsNull());
+    if (!values[i].IsNull()) {
+      EXPECT_EQ(CmpBool::CmpTrue, decoded.CompareEquals(values[i]));
+    }
+  }
+
+  // NULLs never qualify
+  auto bigint_1050 = type::ValueFactory::GetBigIntValue(1050);
+  EXPECT_EQ(45, FilterAll(*column, ExpressionType::COMPARE_LESSTHAN,
+                          bigint_1050).size());
+  EXPECT_EQ(45, FilterAll(*column, ExpressionType::COMPARE_GREATERTHAN,
+                          bigint_1050).size());
+  EXPECT_EQ(0, FilterAll(*column, ExpressionType::COMPARE_EQUAL,
+                         bigint_1050).size());
+  auto result = FilterAll(*column, ExpressionType::COMPARE_EQUAL,
+                          type::ValueFactory::GetIntegerValue(1051));
+  ASSERT_EQ(1, result.size());
+  EXPECT_EQ(51, result[0]);
+
+  // Constants outside of the frame
+  auto small = type::ValueFactory::GetIntegerValue(-5);
+  EXPECT_EQ(90, FilterAll(*column, ExpressionType::COMPARE_GREATERTHANOREQUALTO,
+                          small).size());
+  EXPECT_EQ(0, FilterAll(*column, ExpressionType::COMPARE_LESSTHANOREQUALTO,
+                         small).size());
+
+  // Decimals can't be evaluated on the encoded data
+  uint32_t sel[] = {0, 1, 2};
+  uint32_t num_out;
+  EXPECT_FALSE(column->Filter(ExpressionType::COMPARE_EQUAL,
+                              type::ValueFactory::GetDecimalValue(1001.0), sel,
+                              3, num_out));
+}
+
+TEST_F(CompressedTileGroupTests, DictionaryTest) {
+  std::vector<std::string> strings = {"delta", "alpha", "charlie", "bravo",
+                                      "echo",  "alpha", "delta",   "foxtrot"};
+  std::vector<type::Value> values;
+  for (const auto &str : strings) {
+    values.push_back(type::ValueFactory::GetVarcharValue(str));
+  }
+  auto column =
+      storage::CompressedColumn::Encode(type::TypeId::VARCHAR, values);
+  ASSERT_NE(nullptr, column);
+  EXPECT_EQ(CompressionType::DICTIONARY, column->GetCompressionType());
+
+  for (oid_t i = 0; i < values.size(); i++) {
+    EXPECT_EQ(CmpBool::CmpTrue, column->GetValue(i).CompareEquals(values[i]));
+  }
+
+  auto result = FilterAll(*column, ExpressionType::COMPARE_EQUAL,
+                          type::ValueFactory::GetVarcharValue("delta"));
+  EXPECT_EQ((std::vector<uint32_t>{0, 6}), result);
+  result = FilterAll(*column, ExpressionType::COMPARE_LESSTHAN,
+                     type::ValueFactory::GetVarcharValue("c"));
+  EXPECT_EQ((std::vector<uint32_t>{1, 3, 5}), result);
+  result = FilterAll(*column, ExpressionType::COMPARE_GREATERTHANOREQUALTO,
+                     type::ValueFactory::GetVarcharValue("echo"));
+  EXPECT_EQ((std::vector<uint32_t>{4, 7}), result);
+  EXPECT_EQ(0, FilterAll(*column, ExpressionType::COMPARE_EQUAL,
+                         type::ValueFactory::GetVarcharValue("golf")).size());
+}
+
+TEST_F(CompressedTileGroupTests, RunLengthTest) {
+  // Long runs of a handful of distinct values
+  std::vector<type::Value> values;
+  for (int32_t i = 0; i < 1000; i++) {
+    values.push_back(type::ValueFactory::GetBigIntValue(i / 250 * 1000000));
+  }
+  auto column = storage::CompressedColumn::Encode(type::TypeId::BIGINT, values);
+  ASSERT_NE(nullptr, column);
+  EXPECT_EQ(CompressionType::RUN_LENGTH, column->GetCompressionType());
+
+  for (oid_t i = 0; i < values.size(); i++) {
+    EXPECT_EQ(CmpBool::CmpTrue, column->GetValue(i).CompareEquals(values[i]));
+  }
+
+  // Filter a sparse selection vector
+  std::vector<uint32_t> sel;
+  for (uint32_t i = 0; i < values.size(); i += 7) sel.push_back(i);
+  uint32_t num_out = 0;
+  EXPECT_TRUE(column->Filter(ExpressionType::COMPARE_EQUAL,
+                             type::ValueFactory::GetIntegerValue(2000000),
+                             sel.data(), sel.size(), num_out));
+  sel.resize(num_out);
+  for (auto tid : sel) {
+    EXPECT_EQ(2, tid / 250);
+  }
+  EXPECT_EQ(36, sel.size());
+}
+
+TEST_F(CompressedTileGroupTests, FullRangeTest) {
+  // The frame of the BIGINTs spans all codes but one
+  std::vector<type::Value> values = {
+      type::ValueFactory::GetBigIntValue(type::PELOTON_INT64_MIN),
+      type::ValueFactory::GetBigIntValue(type::PELOTON_INT64_MAX)};
+  auto column = storage::CompressedColumn::Encode(type::TypeId::BIGINT, values);
+  ASSERT_NE(nullptr, column);
+  for (oid_t i = 0; i < values.size(); i++) {
+    EXPECT_EQ(CmpBool::CmpTrue, column->GetValue(i).CompareEquals(values[i]));
+  }
+  auto result = FilterAll(*column, ExpressionType::COMPARE_GREATERTHAN,
+                          type::ValueFactory::GetBigIntValue(0));
+  EXPECT_EQ((std::vector<uint32_t>{1}), result);
+
+  // With a NULL, the code NULL takes is one too many, so the column stays
+  // uncompressed
+  values.push_back(
+      type::ValueFactory::GetNullValueByType(type::TypeId::BIGINT));
+  EXPECT_EQ(nullptr,
+            storage::CompressedColumn::Encode(type::TypeId::BIGINT, values));
+}
+
+TEST_F(CompressedTileGroupTests, UnsupportedTypeTest) {
+  std::vector<type::Value> values = {type::ValueFactory::GetDecimalValue(1.0)};
+  EXPECT_EQ(nullptr,
+            storage::CompressedColumn::Encode(type::TypeId::DECIMAL, values));
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -540,5 +540,97 @@ TEST_F(TileGroupTests, TileCopyTest) {
   EXPECT_TRUE(intended_behavior);
 }
 
+TEST_F(TileGroupTests, AllVisibleTest) {
+  const int tuple_count = 4;
+  storage::TileGroupHeader header(BackendType::MM, tuple_count);
+
+  // Commit a version in every slot but the last
+  for (oid_t tuple_slot_id = 0; tuple_slot_id < tuple_count - 1;
+       tuple_slot_id++) {
+    EXPECT_EQ(tuple_slot_id, header.GetNextEmptyTupleSlot());
+    header.SetTransactionId(tuple_slot_id, INITIAL_TXN_ID);
+    header.SetBeginCommitId(tuple_slot_id, 10 + tuple_slot_id);
+  }
+
+  // A tile group that is not full can still get new versions
+  EXPECT_FALSE(header.MarkAllVisible());
+  EXPECT_EQ(MAX_CID, header.GetAllVisibleCommitId());
+
+  // Neither can one with an uncommitted version
+  oid_t last_slot_id = header.GetNextEmptyTupleSlot();
+  header.SetTransactionId(last_slot_id, 100);
+  EXPECT_FALSE(header.MarkAllVisible());
+  EXPECT_EQ(MAX_CID, header.GetAllVisibleCommitId());
+
+  // Once it commits, all versions are visible as of its commit id
+  header.SetBeginCommitId(last_slot_id, 20);
+  header.SetTransactionId(last_slot_id, INITIAL_TXN_ID);
+  EXPECT_TRUE(header.MarkAllVisible());
+  EXPECT_EQ(20, header.GetAllVisibleCommitId());
+
+  // Taking ownership of a version to update it drops the mark
+  EXPECT_TRUE(header.SetAtomicTransactionId(0, 101));
+  EXPECT_EQ(MAX_CID, header.GetAllVisibleCommitId());
+  header.SetEndCommitId(0, 30);
+  header.SetTransactionId(0, INITIAL_TXN_ID);
+  EXPECT_FALSE(header.MarkAllVisible());
+  EXPECT_EQ(MAX_CID, header.GetAllVisibleCommitId());
+}
+
+TEST_F(TileGroupTests, TupleHeaderLayoutTest) {
+  const int tuple_count = 64;
+  storage::TileGroupHeader row_header(BackendType::MM, tuple_count,
+                                      LayoutType::ROW);
+  storage::TileGroupHeader column_header(BackendType::MM, tuple_count,
+                                         LayoutType::COLUMN);
+  EXPECT_EQ(LayoutType::ROW, row_header.GetLayoutType());
+  EXPECT_EQ(LayoutType::COLUMN, column_header.GetLayoutType());
+
+  ItemPointer indirection;
+  for (oid_t tuple_slot_id = 0; tuple_slot_id < tuple_count;
+       tuple_slot_id++) {
+    EXPECT_EQ(INVALID_TXN_ID, column_header.GetTransactionId(tuple_slot_id));
+    EXPECT_EQ(MAX_CID, column_header.GetBeginCommitId(tuple_slot_id));
+    EXPECT_EQ(nullptr, column_header.GetIndirection(tuple_slot_id));
+
+    row_header.SetTransactionId(tuple_slot_id, INITIAL_TXN_ID);
+    row_header.SetLastReaderCommitId(tuple_slot_id, tuple_slot_id);
+    row_header.SetBeginCommitId(tuple_slot_id, 10 + tuple_slot_id);
+    row_header.SetEndCommitId(tuple_slot_id, 20 + tuple_slot_id);
+    row_header.SetNextItemPointer(tuple_slot_id, ItemPointer(1, tuple_slot_id));
+    row_header.SetPrevItemPointer(tuple_slot_id, ItemPointer(2, tuple_slot_id));
+    row_header.SetIndirection(tuple_slot_id, &indirection);
+  }
+
+  // Copying between the layouts keeps the values of every slot apart
+  column_header = row_header;
+  for (oid_t tuple_slot_id = 0; tuple_slot_id < tuple_count;
+       tuple_slot_id++) {
+    EXPECT_EQ(INITIAL_TXN_ID, column_header.GetTransactionId(tuple_slot_id));
+    EXPECT_EQ(tuple_slot_id,
+              column_header.GetLastReaderCommitId(tuple_slot_id));
+    EXPECT_EQ(10 + tuple_slot_id,
+              column_header.GetBeginCommitId(tuple_slot_id));
+    EXPECT_EQ(20 + tuple_slot_id, column_header.GetEndCommitId(tuple_slot_id));
+    EXPECT_EQ(ItemPointer(1, tuple_slot_id),
+              column_header.GetNextItemPointer(tuple_slot_id));
+    EXPECT_EQ(ItemPointer(2, tuple_slot_id),
+              column_header.GetPrevItemPointer(tuple_slot_id));
+    EXPECT_EQ(&indirection, column_header.GetIndirection(tuple_slot_id));
+  }
+
+  // Only one of the transactions racing to own a version gets it
+  std::atomic<uint32_t> num_owners(0);
+  LaunchParallelTest(4, [&column_header, &num_owners](uint64_t thread_itr) {
+    if (column_header.SetAtomicTransactionId(7, 100 + thread_itr)) {
+      num_owners++;
+    }
+  });
+  EXPECT_EQ(1, num_owners);
+  EXPECT_NE(INITIAL_TXN_ID, column_header.GetTransactionId(7));
+  EXPECT_EQ(INITIAL_TXN_ID, column_header.GetTransactionId(6));
+  EXPECT_EQ(INITIAL_TXN_ID, column_header.GetTransactionId(8));
+}
+
 }  // namespace test
 }  // namespace peloton